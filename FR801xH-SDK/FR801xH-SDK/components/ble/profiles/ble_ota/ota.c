@@ -1,4 +1,5 @@
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -20,6 +21,8 @@
 #include "sys_utils.h"
 
 #include "ota.h"
+#include "ota_lz.h"
+#include "ota_delta.h"
 #include "ota_service.h"
 #include "flash_usage_config.h"
 #ifdef OTA_CRC_CHECK
@@ -31,6 +34,80 @@ void enable_cache(uint8_t invalid_ram);
 void disable_cache(void);
 
 #endif
+
+/* Ƭ flash ӳַ A  jump table ʱָģ flash */
+#ifndef OTA_IMAGE_BASE_ADDR
+#define OTA_IMAGE_BASE_ADDR 0x01000000
+#endif
+
+/*
+ * app_otas_save_data ÿιж̵ֽ0 = һдꡣ
+ * ڼȡָͣ١жϹһֽҪüҳʱ䣻
+ * С֮жܽ 256鲻ҳ
+ */
+#ifndef OTA_SAVE_CHUNK
+#define OTA_SAVE_CHUNK 64
+#endif
+
+/*
+ * ʽ䣨OTA_CMD_STREAM_START / OTA_CMD_STREAM_DATA
+ * ֻдӦưֻţ豸Ѱս RAM ݴ
+ * ҳ̣ÿ OTA_STREAM_WINDOW/2 ֶյظʱ
+ * һۼȷ + λͼstream_ack_rspֻݴ˻ڡֻطȱİ
+ * ݴΪ OTA_STREAM_STAGE ֽڵĻλ壨256 
+ *  = min(OTA_STREAM_WINDOW, (OTA_STREAM_STAGE-256)/ÿֽ)֤ڵİḲǻû̵ݡ
+ * ¾ OTA_STREAM_PUMP_MS ڵıöʱڰ϶ÿβһſ
+ * ʼĻذﴰΪ 0ʱʱȷϣдصֻọ̃ 4KB 
+ * jump table ڵҳ RAMԭһ REBOOT Уͨд
+ */
+#ifndef OTA_STREAM_STAGE
+#define OTA_STREAM_STAGE 2048
+#endif
+#ifndef OTA_STREAM_WINDOW
+#define OTA_STREAM_WINDOW 32    // 32λͼֻ 31 λ
+#endif
+#ifndef OTA_STREAM_PUMP_MS
+#define OTA_STREAM_PUMP_MS 10
+#endif
+#ifndef OTA_CRC_CHECK
+#error "OTA streaming needs OTA_CRC_CHECK (os_timer, cache control)"
+#endif
+
+/*
+ * ѹʽ䣨OTA_CMD_STREAM_START_LZ ota_lz.h ʽѹݣ
+ * 򵽴ǰ׺⣬ҳѹʽͬı·ѹĳԤ
+ *  2^window_bits ֽڵʷڡλֻܳ
+ * OTA_LZ_WINDOW_BITSREBOOT ԰ѹľ񳤶Ⱥ CRC ضУ顣
+ */
+#ifndef OTA_STREAM_LZ
+#define OTA_STREAM_LZ 1
+#endif
+#ifndef OTA_LZ_WINDOW_BITS
+#define OTA_LZ_WINDOW_BITS 11
+#endif
+
+/*
+ * ʽ䣨OTA_CMD_STREAM_START_DELTA ota_delta.h ʽĲ
+ * ԵǰΪף  /  ؽ¾ҳͬһ·
+ * һҳ256B塣ͷʱȻض˶ CRCɾͱ
+ * ¾񳤶ͷ˶ͨöʱſʼԤǰѹݴ
+ * һƲǼʮ KBδû䣩ÿ OTA_DELTA_BUDGET ֽڣ
+ * ʣµɱöʱûʱѹݴ
+ * ȷĴ֮СֻȻͣһ봰ʱʱȷϡ
+ * ʱƿܻû꣬ʱ REBOOT  OTA_RSP_BUSYύֻԺط
+ */
+#ifndef OTA_STREAM_DELTA
+#define OTA_STREAM_DELTA 1
+#endif
+#ifndef OTA_DELTA_BUDGET
+#define OTA_DELTA_BUDGET 1024
+#endif
+
+/* ÿӡͷã UARTÿ룩 */
+#ifndef OTA_LOG_PKT
+#define OTA_LOG_PKT 0
+#endif
+
 struct app_otas_status_t
 {
     uint8_t read_opcode;
@@ -54,6 +131,51 @@ static os_timer_t os_timer_ota;
 static uint32_t ota_addr_check,ota_addr_check_len = 0;
 #endif
 static uint8_t ota_state = 0;
+static struct ota_stream_t
+{
+    uint8_t *stage;         //RAM staging ring, OTA_STREAM_STAGE bytes
+    uint32_t length;        //image length
+    uint32_t stage_base;    //offset of the first byte not programmed yet
+    uint32_t erased_to;     //sectors below this offset are erased
+    uint32_t erase_end;     //new image length to erase before programming, 0 = not known yet (delta)
+    uint32_t rx_bits;       //bit i: packet next_seq+i received
+    uint16_t seg;           //payload bytes per packet
+    uint16_t next_seq;      //first packet not received yet
+    uint16_t window;
+    uint8_t since_ack;      //packets accepted since the last ack
+    uint8_t gap_acked;      //a hole has been reported since the last ack
+    uint8_t codec;          //OTA_STREAM_CODEC_xxx
+    uint8_t dec_state;      //OTA_STREAM_DEC_xxx, lz / delta mode only
+    uint8_t conidx;         //link the pump timer acks on
+    uint8_t pump;           //pump timer initialised / running
+    uint16_t acked_window;  //window reported in the last ack
+    uint8_t *dec_buf;       //LZ history window / delta output page
+    union
+    {
+        struct ota_lz_t lz;
+        struct ota_delta_t delta;
+    } dec;
+} ota_stream = {0};
+
+enum
+{
+    OTA_STREAM_CODEC_RAW,   //uncompressed stream (or no stream)
+    OTA_STREAM_CODEC_LZ,
+    OTA_STREAM_CODEC_DELTA,
+};
+
+enum
+{
+    OTA_STREAM_DEC_RUNNING,
+    OTA_STREAM_DEC_DONE,    //produced exactly the whole image at the end of the stream
+    OTA_STREAM_DEC_FAILED,  //corrupt data or wrong base image, the image is not committed
+};
+
+enum
+{
+    OTA_STREAM_PUMP_INIT = 0x01,
+    OTA_STREAM_PUMP_RUNNING = 0x02,
+};
 
 extern uint8_t app_boot_get_storage_type(void);
 extern void app_boot_save_data(uint32_t dest, uint8_t *src, uint32_t len);
@@ -62,6 +184,10 @@ extern void system_set_cache_config(uint8_t value, uint8_t count_10us);
 #ifdef OTA_CRC_CHECK
 void os_timer_ota_cb(void *arg);
 #endif
+static os_timer_t ota_stream_pump_timer;
+static void app_otas_stream_pump(void *arg);
+void ota_change_flash_pin(void);
+void ota_recover_flash_pin(void);
 
 __attribute__((section("ram_code"))) uint8_t app_get_ota_state(void)
 {
@@ -78,10 +204,10 @@ __attribute__((section("ram_code"))) void app_set_ota_state(uint8_t state_flag)
 
 static uint32_t app_otas_get_curr_firmwave_version(void)
 {
-    struct jump_table_t *jump_table_a = (struct jump_table_t *)0x01000000;
+    struct jump_table_t *jump_table_a = (struct jump_table_t *)OTA_IMAGE_BASE_ADDR;
     if(system_regs->remap_length != 0)  // part B
     {
-        struct jump_table_t *jump_table_b = (struct jump_table_t *)(0x01000000 + jump_table_a->image_size);
+        struct jump_table_t *jump_table_b = (struct jump_table_t *)(OTA_IMAGE_BASE_ADDR + jump_table_a->image_size);
         return jump_table_b->firmware_version;
     }
     else        // part A
@@ -89,7 +215,7 @@ static uint32_t app_otas_get_curr_firmwave_version(void)
 }
 static uint32_t app_otas_get_curr_code_address(void)
 {
-    struct jump_table_t *jump_table_tmp = (struct jump_table_t *)0x01000000;
+    struct jump_table_t *jump_table_tmp = (struct jump_table_t *)OTA_IMAGE_BASE_ADDR;
     if(system_regs->remap_length != 0)  // part B
         return jump_table_tmp->image_size;
     else    // part A
@@ -97,7 +223,7 @@ static uint32_t app_otas_get_curr_code_address(void)
 }
 static uint32_t app_otas_get_storage_address(void)
 {
-    struct jump_table_t *jump_table_tmp = (struct jump_table_t *)0x01000000;
+    struct jump_table_t *jump_table_tmp = (struct jump_table_t *)OTA_IMAGE_BASE_ADDR;
     if(system_regs->remap_length != 0)      //partB, then return partA flash Addr
         return 0;
     else
@@ -105,7 +231,7 @@ static uint32_t app_otas_get_storage_address(void)
 }
 static uint32_t app_otas_get_image_size(void)
 {
-    struct jump_table_t *jump_table_tmp = (struct jump_table_t *)0x01000000;
+    struct jump_table_t *jump_table_tmp = (struct jump_table_t *)OTA_IMAGE_BASE_ADDR;
     return jump_table_tmp->image_size;
 }
 
@@ -115,27 +241,40 @@ __attribute__((section("ram_code"))) static void app_otas_save_data(uint32_t des
     current_remap_address = system_regs->remap_virtual_addr;
     remap_size = system_regs->remap_length;
 
-    GLOBAL_INT_DISABLE();
-    //*(volatile uint32_t *)0x500a0000 = 0x3c;
-    //while(((*(volatile uint32_t *)0x500a0004) & 0x03) != 0x00);
-    //if(__jump_table.system_option & SYSTEM_OPTION_ENABLE_CACHE)
-    //{
-    //    system_set_cache_config(0x60, 10);
-    //}
-    system_regs->remap_virtual_addr = 0;
-    system_regs->remap_length = 0;
+    while(len > 0)
+    {
+        uint32_t n = len;
+#if OTA_SAVE_CHUNK > 0
+        n = OTA_SAVE_CHUNK - (dest % OTA_SAVE_CHUNK);
+        if(n > len)
+            n = len;
+#endif
+        GLOBAL_INT_DISABLE();
+        //*(volatile uint32_t *)0x500a0000 = 0x3c;
+        //while(((*(volatile uint32_t *)0x500a0004) & 0x03) != 0x00);
+        //if(__jump_table.system_option & SYSTEM_OPTION_ENABLE_CACHE)
+        //{
+        //    system_set_cache_config(0x60, 10);
+        //}
+        system_regs->remap_virtual_addr = 0;
+        system_regs->remap_length = 0;
 
-    flash_write(dest, len, src);
+        flash_write(dest, n, src);
 
-    system_regs->remap_virtual_addr = current_remap_address;
-    system_regs->remap_length = remap_size;
-    //*(volatile uint32_t *)0x500a0000 = 0x3d;
-    //while(((*(volatile uint32_t *)0x500a0004) & 0x03) != 0x02);
-    //if(__jump_table.system_option & SYSTEM_OPTION_ENABLE_CACHE)
-    //{
-    //    system_set_cache_config(0x61, 10);
-    //}
-    GLOBAL_INT_RESTORE();
+        system_regs->remap_virtual_addr = current_remap_address;
+        system_regs->remap_length = remap_size;
+        //*(volatile uint32_t *)0x500a0000 = 0x3d;
+        //while(((*(volatile uint32_t *)0x500a0004) & 0x03) != 0x02);
+        //if(__jump_table.system_option & SYSTEM_OPTION_ENABLE_CACHE)
+        //{
+        //    system_set_cache_config(0x61, 10);
+        //}
+        GLOBAL_INT_RESTORE();
+
+        dest += n;
+        src += n;
+        len -= n;
+    }
     /*
         uint8_t *buffer = (uint8_t *)ke_malloc(len, KE_MEM_NON_RETENTION);
         flash_read(dest, len, buffer);
@@ -151,10 +290,7 @@ __attribute__((section("ram_code"))) static void app_otas_save_data(uint32_t des
     */
 }
 
-#ifdef OTA_FOR_FR8012HAQ_J
-#define REG_BLE_WR(addr, value)      (*(volatile uint32_t *)(addr)) = (value)
-#define REG_BLE_RD(addr)             (*(volatile uint32_t *)(addr))
-
+#if defined(OTA_FOR_FR8012HAQ_J) || OTA_STREAM_DELTA
 __attribute__((section("ram_code"))) static void app_otas_flash_read(uint32_t dest, uint8_t *src, uint32_t len)
 {
     uint32_t current_remap_address, remap_size;
@@ -171,6 +307,11 @@ __attribute__((section("ram_code"))) static void app_otas_flash_read(uint32_t de
     system_regs->remap_length = remap_size;
     GLOBAL_INT_RESTORE();
 }
+#endif
+
+#ifdef OTA_FOR_FR8012HAQ_J
+#define REG_BLE_WR(addr, value)      (*(volatile uint32_t *)(addr)) = (value)
+#define REG_BLE_RD(addr)             (*(volatile uint32_t *)(addr))
 
 __attribute__((section("ram_code"))) static void app_otas_save_first_pkt(uint32_t dest,uint8_t *src,uint32_t len)
 {
@@ -191,6 +332,486 @@ __attribute__((section("ram_code"))) static void app_otas_save_first_pkt(uint32_
 }
 #endif
 
+/* ¾һ׸ jump table ڵҳREBOOT ʱٲд */
+static void app_otas_erase_sector(uint32_t base_address, uint32_t new_bin_base)
+{
+    if(base_address == new_bin_base)
+    {
+#ifdef OTA_FOR_FR8012HAQ_J
+        uint8_t * head_pkt = NULL;
+        head_pkt = os_malloc(256);
+        if(head_pkt)
+        {
+            app_otas_flash_read(base_address,head_pkt,256);
+            flash_erase(base_address, 0x1000);
+            app_otas_save_data(base_address,head_pkt,256);
+            os_free(head_pkt);
+        }
+#else                
+        for(uint16_t offset = 256; offset < 4096; offset += 256)
+        {
+#ifdef FLASH_PROTECT
+            flash_protect_disable(0);
+#endif	
+            flash_page_erase(offset + new_bin_base);
+#ifdef FLASH_PROTECT
+            flash_protect_enable(0);
+#endif
+        }
+#endif                
+    }
+    else
+        flash_erase(base_address, 0x1000);
+}
+
+/* ¾汾Ųڵǰ汾ʱĳɵǰ汾 +1֤ boot ѡ¾ */
+static void app_otas_bump_version(uint8_t *jump_table)
+{
+    uint32_t firmware_offset = offsetof(struct jump_table_t, firmware_version);
+    if( *(uint32_t *)((uintptr_t)jump_table + firmware_offset) <= app_otas_get_curr_firmwave_version() )
+    {
+        uint32_t new_bin_ver = app_otas_get_curr_firmwave_version() + 1;
+        co_printf("old_ver:%08X\r\n",*(uint32_t *)((uintptr_t)jump_table + firmware_offset));
+        co_printf("new_ver:%08X\r\n",new_bin_ver);
+        //checksum_minus = new_bin_ver - *(uint32_t *)((uintptr_t)jump_table + firmware_offset);
+        *(uint32_t *)((uintptr_t)jump_table + firmware_offset) = new_bin_ver;
+    }
+}
+
+static void app_otas_stream_reset(void)
+{
+    if(ota_stream.pump & OTA_STREAM_PUMP_INIT)
+    {
+        os_timer_stop(&ota_stream_pump_timer);
+        os_timer_destroy(&ota_stream_pump_timer);
+    }
+    if(ota_stream.stage != NULL)
+        os_free(ota_stream.stage);
+    if(ota_stream.dec_buf != NULL)
+        os_free(ota_stream.dec_buf);
+    memset(&ota_stream, 0, sizeof(ota_stream));
+}
+
+static bool app_otas_stream_start(uint32_t base_address, uint32_t length, uint16_t seg)
+{
+    app_otas_stream_reset();
+    if(first_pkt.buf != NULL)
+    {
+        os_free(first_pkt.buf);
+        memset(&first_pkt,0x0,sizeof(first_pkt));
+    }
+
+    if(base_address != app_otas_get_storage_address()
+       || length <= 256 || length > app_otas_get_image_size()
+       || seg == 0 || seg > OTA_STREAM_STAGE - 256
+       || (length - 1) / seg > 0xFFFF)
+        return false;
+
+    ota_stream.stage = os_malloc(OTA_STREAM_STAGE);
+    if(ota_stream.stage == NULL)
+        return false;
+    ota_stream.length = length;
+    ota_stream.erase_end = length;
+    ota_stream.seg = seg;
+    ota_stream.window = (OTA_STREAM_STAGE - 256) / seg;
+    if(ota_stream.window > OTA_STREAM_WINDOW)
+        ota_stream.window = OTA_STREAM_WINDOW;
+    return true;
+}
+
+/* ֽ */
+static uint32_t app_otas_stream_prefix(void)
+{
+    uint32_t prefix = (uint32_t)ota_stream.next_seq * ota_stream.seg;
+    return (prefix > ota_stream.length) ? ota_stream.length : prefix;
+}
+
+/* ¾û */
+static bool app_otas_stream_erasing(void)
+{
+    return ota_stream.erased_to < ota_stream.erase_end;
+}
+
+/*
+ * ֻ next_seq ܷİѹ / LZ յʹ꣬ݴѹһҳ
+ * ̶ھ͹ǰΪ 0иû꣨ڲʱѹݴ
+ * ڲܸסûιؽݡ
+ */
+static uint16_t app_otas_stream_window(void)
+{
+    uint32_t end = ota_stream.stage_base + OTA_STREAM_STAGE;
+    uint32_t prefix = app_otas_stream_prefix();
+    uint32_t window;
+
+    if(ota_stream.codec != OTA_STREAM_CODEC_DELTA)
+        return app_otas_stream_erasing() ? 0 : ota_stream.window;
+    window = (end > prefix) ? (end - prefix) / ota_stream.seg : 0;
+    return (window < ota_stream.window) ? window : ota_stream.window;
+}
+
+static void app_otas_stream_ack(uint8_t conidx, uint8_t result)
+{
+    uint8_t buffer[OTA_HDR_OPCODE_LEN+OTA_HDR_LENGTH_LEN+OTA_HDR_RESULT_LEN+sizeof(struct stream_ack_rsp)];
+    struct app_ota_rsp_hdr_t *rsp_hdr = (struct app_ota_rsp_hdr_t *)buffer;
+
+    rsp_hdr->result = result;
+    rsp_hdr->org_opcode = OTA_CMD_STREAM_DATA;
+    rsp_hdr->length = sizeof(struct stream_ack_rsp);
+    rsp_hdr->rsp.stream_ack.next_seq = ota_stream.next_seq;
+    rsp_hdr->rsp.stream_ack.window = app_otas_stream_window();
+    rsp_hdr->rsp.stream_ack.bitmap = ota_stream.rx_bits >> 1;
+    ota_stream.acked_window = rsp_hdr->rsp.stream_ack.window;
+    ota_gatt_report_notify(conidx, buffer, sizeof(buffer));
+    ota_stream.since_ack = 0;
+    ota_stream.gap_acked = 0;
+}
+
+/* ¾ [offset, offset+n) д flashֻдöʱѲõoffset Ϊ 0 ʱ n  256ҳ first_pkt */
+static bool app_otas_stream_write(uint32_t offset, const uint8_t *data, uint32_t n)
+{
+    uint32_t new_bin_base = app_otas_get_storage_address();
+
+    if(offset == 0)
+    {
+        first_pkt.buf = os_malloc(256);
+        if(first_pkt.buf == NULL)
+            return false;
+        memcpy(first_pkt.buf, data, 256);
+        first_pkt.len = 256;
+        first_pkt.malloced_pkt_num = 1;
+        app_otas_bump_version(first_pkt.buf);
+        return true;
+    }
+    if(offset + n > ota_stream.erased_to)
+        return false;
+    app_otas_save_data(new_bin_base + offset, (uint8_t *)data, n);
+    return true;
+}
+
+/* ݴ [stage_base, end) д flashҳһα */
+static void app_otas_stream_program(uint32_t end)
+{
+    while(ota_stream.stage_base < end)
+    {
+        uint32_t offset = ota_stream.stage_base;
+        uint32_t idx = offset % OTA_STREAM_STAGE;
+        uint32_t n = end - offset;
+
+        if(n > OTA_STREAM_STAGE - idx)
+            n = OTA_STREAM_STAGE - idx;
+        if(offset == 0)
+            n = 256;
+        if(app_otas_stream_write(offset, ota_stream.stage + idx, n) == false)
+            return;
+        ota_stream.stage_base += n;
+    }
+}
+
+#if OTA_STREAM_LZ || OTA_STREAM_DELTA
+/*  / ؽÿһҳصһΣpage  dec_buf ֱӱ */
+static void app_otas_stream_dec_page(const uint8_t *page, uint32_t offset, uint32_t len)
+{
+    if(ota_stream.dec_state == OTA_STREAM_DEC_RUNNING
+       && app_otas_stream_write(offset, page, len) == false)
+        ota_stream.dec_state = OTA_STREAM_DEC_FAILED;
+}
+#endif
+
+#if OTA_STREAM_LZ
+static bool app_otas_stream_start_lz(struct stream_start_lz_cmd *cmd)
+{
+    if(app_otas_stream_start(cmd->base_address, cmd->length, cmd->seg) == false)
+        return false;
+    if(cmd->raw_length <= 256 || cmd->raw_length > app_otas_get_image_size()
+       || cmd->window_bits < OTA_LZ_BITS_MIN || cmd->window_bits > OTA_LZ_WINDOW_BITS)
+        return false;
+
+    ota_stream.dec_buf = os_malloc(1u << cmd->window_bits);
+    if(ota_stream.dec_buf == NULL)
+        return false;
+    ota_lz_init(&ota_stream.dec.lz, ota_stream.dec_buf, cmd->window_bits,
+                cmd->raw_length, app_otas_stream_dec_page);
+    ota_stream.codec = OTA_STREAM_CODEC_LZ;
+    ota_stream.erase_end = cmd->raw_length;
+    return true;
+}
+
+/* ݴﰴѹ [stage_base, end) ȫιܿƵ㣩 */
+static void app_otas_stream_decode(uint32_t end)
+{
+    while(ota_stream.stage_base < end && ota_stream.dec_state == OTA_STREAM_DEC_RUNNING)
+    {
+        uint32_t idx = ota_stream.stage_base % OTA_STREAM_STAGE;
+        uint32_t n = end - ota_stream.stage_base;
+        uint8_t rc;
+
+        if(n > OTA_STREAM_STAGE - idx)
+            n = OTA_STREAM_STAGE - idx;
+        rc = ota_lz_decode(&ota_stream.dec.lz, ota_stream.stage + idx, n);
+        ota_stream.stage_base += n;
+        if(rc == OTA_LZ_ERROR)
+            ota_stream.dec_state = OTA_STREAM_DEC_FAILED;
+        else if(rc == OTA_LZ_DONE && ota_stream.dec_state == OTA_STREAM_DEC_RUNNING)
+            ota_stream.dec_state = OTA_STREAM_DEC_DONE;
+    }
+    // ѹ˻û raw_length ֽ
+    if(end == ota_stream.length && ota_stream.dec_state == OTA_STREAM_DEC_RUNNING)
+        ota_stream.dec_state = OTA_STREAM_DEC_FAILED;
+}
+#endif
+
+#if OTA_STREAM_DELTA
+static void app_otas_stream_delta_read(uint8_t *dst, uint32_t old_offset, uint32_t len)
+{
+    app_otas_flash_read(app_otas_get_curr_code_address() + old_offset, dst, len);
+}
+
+/* ͷ룺¾ɾ񶼷ŵýһ [256, old_length)  CRC 벹һ */
+static uint8_t app_otas_stream_delta_check(const struct ota_delta_hdr *hdr)
+{
+    uint32_t base = app_otas_get_curr_code_address();
+    uint32_t crc = 0;
+
+    if(hdr->new_length > app_otas_get_image_size() || hdr->old_length > app_otas_get_image_size())
+        return 0;
+    // صڼҳţ
+    for(uint32_t offset = OTA_DELTA_PAGE; offset < hdr->old_length; offset += OTA_DELTA_PAGE)
+    {
+        uint32_t n = hdr->old_length - offset;
+        if(n > OTA_DELTA_PAGE)
+            n = OTA_DELTA_PAGE;
+        app_otas_flash_read(base + offset, ota_stream.dec_buf, n);
+        crc = ota_delta_crc32(crc, ota_stream.dec_buf, n);
+    }
+    if(crc != hdr->old_crc)
+        return 0;
+    ota_stream.erase_end = hdr->new_length;
+    return 1;
+}
+
+static bool app_otas_stream_start_delta(struct stream_start_cmd *cmd)
+{
+    if(app_otas_stream_start(cmd->base_address, cmd->length, cmd->seg) == false)
+        return false;
+
+    ota_stream.dec_buf = os_malloc(OTA_DELTA_PAGE);
+    if(ota_stream.dec_buf == NULL)
+        return false;
+    ota_delta_init(&ota_stream.dec.delta, ota_stream.dec_buf, app_otas_stream_delta_read,
+                   app_otas_stream_dec_page, app_otas_stream_delta_check);
+    ota_stream.codec = OTA_STREAM_CODEC_DELTA;
+    ota_stream.erase_end = 0;   //ͷ˶֪ͨ
+    return true;
+}
+
+/* ¿û꣬ݴа롢ûιȥĲ */
+static bool app_otas_stream_delta_busy(void)
+{
+    return ota_stream.codec == OTA_STREAM_CODEC_DELTA
+           && ota_stream.dec_state == OTA_STREAM_DEC_RUNNING
+           && (ota_delta_state(&ota_stream.dec.delta) == OTA_DELTA_COPYING
+               || ota_stream.stage_base < app_otas_stream_prefix());
+}
+
+/*
+ * ȽûĸƣٰݴĲ [stage_base, end) ιؽิ budget ֽڡ
+ * ͷι˶ͨҪ¾
+ */
+static void app_otas_stream_delta_run(uint32_t end, uint32_t budget)
+{
+    struct ota_delta_t *d = &ota_stream.dec.delta;
+    uint8_t state = ota_delta_state(d);
+
+    while(ota_stream.dec_state == OTA_STREAM_DEC_RUNNING)
+    {
+        if(ota_stream.stage_base >= OTA_DELTA_HDR_LEN && app_otas_stream_erasing())
+            break;
+        if(state == OTA_DELTA_COPYING)
+        {
+            uint32_t out_pos = d->out_pos;
+            ota_delta_copy(d, budget);
+            budget -= d->out_pos - out_pos;
+        }
+        else if(ota_stream.stage_base < end)
+        {
+            uint32_t idx = ota_stream.stage_base % OTA_STREAM_STAGE;
+            uint32_t n = end - ota_stream.stage_base;
+            if(n > OTA_STREAM_STAGE - idx)
+                n = OTA_STREAM_STAGE - idx;
+            if(ota_stream.stage_base < OTA_DELTA_HDR_LEN && n > OTA_DELTA_HDR_LEN - ota_stream.stage_base)
+                n = OTA_DELTA_HDR_LEN - ota_stream.stage_base;
+            ota_stream.stage_base += ota_delta_feed(d, ota_stream.stage + idx, n);
+        }
+
+        state = ota_delta_state(d);
+        if(state == OTA_DELTA_ERROR)
+            ota_stream.dec_state = OTA_STREAM_DEC_FAILED;
+        else if(state != OTA_DELTA_COPYING && ota_stream.stage_base == ota_stream.length)
+            // ȫι꣺ؽ¾ɹ
+            ota_stream.dec_state = (state == OTA_DELTA_DONE) ? OTA_STREAM_DEC_DONE : OTA_STREAM_DEC_FAILED;
+        else if(state == OTA_DELTA_COPYING ? budget == 0 : ota_stream.stage_base == end)
+            break;
+    }
+}
+
+#endif
+
+/* лڲؽû꣩ñöʱתţûͣ */
+static void app_otas_stream_pump_update(void)
+{
+    if(app_otas_stream_erasing()
+#if OTA_STREAM_DELTA
+       || app_otas_stream_delta_busy()
+#endif
+      )
+    {
+        if((ota_stream.pump & OTA_STREAM_PUMP_INIT) == 0)
+        {
+            os_timer_init(&ota_stream_pump_timer, app_otas_stream_pump, NULL);
+            ota_stream.pump |= OTA_STREAM_PUMP_INIT;
+        }
+        if((ota_stream.pump & OTA_STREAM_PUMP_RUNNING) == 0)
+        {
+            os_timer_start(&ota_stream_pump_timer, OTA_STREAM_PUMP_MS, 1);
+            ota_stream.pump |= OTA_STREAM_PUMP_RUNNING;
+        }
+    }
+    else if(ota_stream.pump & OTA_STREAM_PUMP_RUNNING)
+    {
+        os_timer_stop(&ota_stream_pump_timer);
+        ota_stream.pump &= ~OTA_STREAM_PUMP_RUNNING;
+    }
+}
+
+/*
+ * ϶ÿβһ󣨲֣ؽ
+ * ڱϴȷʱھͲȷϣֻõȳʱ
+ */
+static void app_otas_stream_pump(void *arg)
+{
+    uint32_t new_bin_base = app_otas_get_storage_address();
+
+    wdt_feed();
+    ota_change_flash_pin();
+    if(app_otas_stream_erasing())
+    {
+        app_otas_erase_sector(new_bin_base + ota_stream.erased_to, new_bin_base);
+        ota_stream.erased_to += 0x1000;
+    }
+#if OTA_STREAM_DELTA
+    else if(ota_stream.codec == OTA_STREAM_CODEC_DELTA)
+        app_otas_stream_delta_run(app_otas_stream_prefix(), OTA_DELTA_BUDGET);
+#endif
+    ota_recover_flash_pin();
+
+    if(ota_stream.dec_state == OTA_STREAM_DEC_FAILED)
+        app_otas_stream_ack(ota_stream.conidx, OTA_RSP_ERROR);
+    else if(app_otas_stream_window() >= ota_stream.acked_window + (ota_stream.window + 1) / 2)
+        app_otas_stream_ack(ota_stream.conidx, OTA_RSP_SUCCESS);
+    app_otas_stream_pump_update();
+}
+
+/* ݶд flashҳ first_pktREBOOT ύ */
+static bool app_otas_stream_complete(void)
+{
+    if(ota_stream.stage == NULL)
+        return true;    //ԭ
+    if(ota_stream.stage_base < ota_stream.length)
+        return false;
+    return ota_stream.codec == OTA_STREAM_CODEC_RAW || ota_stream.dec_state == OTA_STREAM_DEC_DONE;
+}
+
+static void app_otas_stream_data(uint8_t conidx, uint8_t *p_data, uint16_t len)
+{
+    struct app_ota_cmd_hdr_t *cmd_hdr = (struct app_ota_cmd_hdr_t *)p_data;
+    uint16_t hdr_len = OTA_HDR_OPCODE_LEN+OTA_HDR_LENGTH_LEN+sizeof(struct stream_data_cmd);
+    uint16_t seq, rel;
+    uint32_t offset, n, prefix;
+    bool ack = false;
+
+    if(ota_stream.stage == NULL || len <= hdr_len)
+        return;
+    if(ota_stream.dec_state == OTA_STREAM_DEC_FAILED)
+    {
+        app_otas_stream_ack(conidx, OTA_RSP_ERROR);
+        return;
+    }
+
+    seq = cmd_hdr->cmd.stream_data.seq;
+    rel = (uint16_t)(seq - ota_stream.next_seq);
+    offset = (uint32_t)seq * ota_stream.seg;
+    n = len - hdr_len;
+
+    if(seq < ota_stream.next_seq || (rel < 32 && (ota_stream.rx_bits & (1u << rel))))
+    {
+        // ظһȷֻûյ
+        app_otas_stream_ack(conidx, OTA_RSP_SUCCESS);
+        return;
+    }
+    if(rel >= ota_stream.window || offset >= ota_stream.length
+       || (ota_stream.codec != OTA_STREAM_CODEC_DELTA && app_otas_stream_erasing())
+       || n != ((ota_stream.length - offset < ota_stream.seg) ? ota_stream.length - offset : ota_stream.seg)
+       || offset + n > ota_stream.stage_base + OTA_STREAM_STAGE)
+    {
+        app_otas_stream_ack(conidx, OTA_RSP_SUCCESS);
+        return;
+    }
+
+    // ݴǻεģܿƵ
+    uint32_t idx = offset % OTA_STREAM_STAGE;
+    uint32_t first = (n > OTA_STREAM_STAGE - idx) ? OTA_STREAM_STAGE - idx : n;
+    memcpy(ota_stream.stage + idx, p_data + hdr_len, first);
+    memcpy(ota_stream.stage, p_data + hdr_len + first, n - first);
+
+    ota_stream.rx_bits |= 1u << rel;
+    if(rel != 0 && ota_stream.gap_acked == 0)
+    {
+        // ǰаûϱһΣֻõȳʱط
+        ack = true;
+        ota_stream.gap_acked = 1;
+    }
+    while(ota_stream.rx_bits & 1)
+    {
+        ota_stream.rx_bits >>= 1;
+        ota_stream.next_seq++;
+    }
+    prefix = app_otas_stream_prefix();
+    if(++ota_stream.since_ack >= (ota_stream.window + 1) / 2 || prefix == ota_stream.length)
+        ack = true;
+
+#if OTA_STREAM_DELTA
+    if(ota_stream.codec == OTA_STREAM_CODEC_DELTA)
+    {
+        // ؽȷϣȷĴҪѵĲ
+        app_otas_stream_delta_run(prefix, OTA_DELTA_BUDGET);
+        if(ota_stream.dec_state == OTA_STREAM_DEC_FAILED)
+            app_otas_stream_ack(conidx, OTA_RSP_ERROR);
+        else if(ack)
+            app_otas_stream_ack(conidx, OTA_RSP_SUCCESS);
+        app_otas_stream_pump_update();
+        return;
+    }
+#endif
+    if(ack)
+        app_otas_stream_ack(conidx, OTA_RSP_SUCCESS);
+
+#if OTA_STREAM_LZ
+    if(ota_stream.codec == OTA_STREAM_CODEC_LZ)
+    {
+        // ѹݲشҳյǰ׺Ͻ⣬ҳص
+        app_otas_stream_decode(prefix);
+        if(ota_stream.dec_state == OTA_STREAM_DEC_FAILED)
+            app_otas_stream_ack(conidx, OTA_RSP_ERROR);
+        return;
+    }
+#endif
+    // ҳʱͬҳ
+    if(prefix != ota_stream.length)
+        prefix &= ~0xFFu;
+    if(prefix > ota_stream.stage_base)
+        app_otas_stream_program(prefix);
+}
+
 void ota_clr_buffed_pkt(uint8_t conidx)
 {
     //current_conidx = 200;
@@ -214,6 +835,7 @@ void ota_init(uint8_t conidx)
 void ota_deinit(uint8_t conidx)
 {
     ota_clr_buffed_pkt(conidx);
+    app_otas_stream_reset();
     app_set_ota_state(0);
     if(ota_recving_buffer != NULL) {
         os_free(ota_recving_buffer);
@@ -283,14 +905,26 @@ void app_otas_recv_data(uint8_t conidx,uint8_t *p_data,uint16_t len)
         ota_start();
 #endif		
     }
+#if OTA_LOG_PKT
     co_printf("app_otas_recv_data[%d]: %d, %d. %d\r\n",at_data_idx, gatt_get_mtu(conidx), len, cmd_hdr->cmd.write_data.length);
     show_reg(p_data,sizeof(struct app_ota_cmd_hdr_t),1);
+#endif
 #ifdef OTA_CRC_CHECK	
     os_timer_stop(&os_timer_ota);
     os_timer_start(&os_timer_ota, OTA_TIMEOUT, 0);
 #endif	
     at_data_idx++;
 
+    // ʽݰдذȷ app_otas_stream_data 
+    if(!ota_recving_data && cmd_hdr->opcode == OTA_CMD_STREAM_DATA)
+    {
+        wdt_feed();
+        ota_change_flash_pin();
+        app_otas_stream_data(conidx, p_data, len);
+        ota_recover_flash_pin();
+        return;
+    }
+
     // ֻ֧˽ӦòвֵĹܣӦò㷢L2CAPȥ֡
     if(ota_recving_data) {
         memcpy(ota_recving_buffer+ota_recving_data_index, p_data, len);
@@ -316,6 +950,7 @@ void app_otas_recv_data(uint8_t conidx,uint8_t *p_data,uint16_t len)
         case OTA_CMD_GET_STR_BASE:
             at_data_idx = 0;
             ota_clr_buffed_pkt(conidx);
+            app_otas_stream_reset();
             rsp_data_len += sizeof(struct storage_baseaddr);
             break;
         case OTA_CMD_READ_FW_VER:
@@ -327,6 +962,11 @@ void app_otas_recv_data(uint8_t conidx,uint8_t *p_data,uint16_t len)
         case OTA_CMD_WRITE_DATA:
             rsp_data_len += sizeof(struct write_data_rsp);
             break;
+        case OTA_CMD_STREAM_START:
+        case OTA_CMD_STREAM_START_LZ:
+        case OTA_CMD_STREAM_START_DELTA:
+            rsp_data_len += sizeof(struct stream_ack_rsp);
+            break;
         case OTA_CMD_READ_DATA:
             rsp_data_len += sizeof(struct read_data_rsp) + cmd_hdr->cmd.read_data.length;
             if(rsp_data_len > OTAS_NOTIFY_DATA_SIZE)
@@ -412,33 +1052,7 @@ void app_otas_recv_data(uint8_t conidx,uint8_t *p_data,uint16_t len)
                 }
             }
 #endif
-            if(rsp_hdr->rsp.page_erase.base_address == new_bin_base)
-            {
-#ifdef OTA_FOR_FR8012HAQ_J
-                uint8_t * head_pkt = NULL;
-                head_pkt = os_malloc(256);
-                if(head_pkt)
-                {
-                    app_otas_flash_read(rsp_hdr->rsp.page_erase.base_address,head_pkt,256);
-                    flash_erase(rsp_hdr->rsp.page_erase.base_address, 0x1000);
-                    app_otas_save_data(rsp_hdr->rsp.page_erase.base_address,head_pkt,256);
-                    os_free(head_pkt);
-                }
-#else                
-                for(uint16_t offset = 256; offset < 4096; offset += 256)
-                {
-#ifdef FLASH_PROTECT
-                    flash_protect_disable(0);
-#endif	
-                    flash_page_erase(offset + new_bin_base);
-#ifdef FLASH_PROTECT
-                    flash_protect_enable(0);
-#endif
-                }
-#endif                
-            }
-            else
-                flash_erase(rsp_hdr->rsp.page_erase.base_address, 0x1000);
+            app_otas_erase_sector(rsp_hdr->rsp.page_erase.base_address, new_bin_base);
         }
         break;
         case OTA_CMD_CHIP_ERASE:
@@ -488,15 +1102,7 @@ void app_otas_recv_data(uint8_t conidx,uint8_t *p_data,uint16_t len)
                     //change firmware version in buffed pkt.
                     if(first_pkt.len >= rsp_hdr->rsp.write_data.length * first_pkt.malloced_pkt_num)
                     {
-                        uint32_t firmware_offset = (uint32_t)&((struct jump_table_t *)0x01000000)->firmware_version- 0x01000000;
-                        if( *(uint32_t *)((uint32_t)first_pkt.buf + firmware_offset) <= app_otas_get_curr_firmwave_version() )
-                        {
-                            uint32_t new_bin_ver = app_otas_get_curr_firmwave_version() + 1;
-                            co_printf("old_ver:%08X\r\n",*(uint32_t *)((uint32_t)first_pkt.buf + firmware_offset));
-                            co_printf("new_ver:%08X\r\n",new_bin_ver);
-                            //checksum_minus = new_bin_ver - *(uint32_t *)((uint32_t)first_pkt.buf + firmware_offset);
-                            *(uint32_t *)((uint32_t)first_pkt.buf + firmware_offset) = new_bin_ver;
-                        }
+                        app_otas_bump_version(first_pkt.buf);
                         //write data from 256 ~ rsp_hdr->rsp.write_data.length * first_pkt.malloced_pkt_num
                         app_otas_save_data(new_bin_base + 256,first_pkt.buf + 256,first_pkt.len - 256);
                     }
@@ -537,8 +1143,59 @@ void app_otas_recv_data(uint8_t conidx,uint8_t *p_data,uint16_t len)
                        rsp_hdr->rsp.read_data.length);
             }
             break;
+        case OTA_CMD_STREAM_START:
+        case OTA_CMD_STREAM_START_LZ:
+        case OTA_CMD_STREAM_START_DELTA:
+#if OTA_STREAM_DELTA
+            if(cmd_hdr->opcode == OTA_CMD_STREAM_START_DELTA)
+            {
+                if(app_otas_stream_start_delta(&cmd_hdr->cmd.stream_start) == false)
+                {
+                    app_otas_stream_reset();
+                    rsp_hdr->result = OTA_RSP_ERROR;
+                }
+            }
+            else
+#endif
+#if OTA_STREAM_LZ
+            if(cmd_hdr->opcode == OTA_CMD_STREAM_START_LZ)
+            {
+                if(app_otas_stream_start_lz(&cmd_hdr->cmd.stream_start_lz) == false)
+                {
+                    app_otas_stream_reset();
+                    rsp_hdr->result = OTA_RSP_ERROR;
+                }
+            }
+            else
+#endif
+            if(cmd_hdr->opcode != OTA_CMD_STREAM_START
+               || app_otas_stream_start(cmd_hdr->cmd.stream_start.base_address,
+                                        cmd_hdr->cmd.stream_start.length,
+                                        cmd_hdr->cmd.stream_start.seg) == false)
+            {
+                app_otas_stream_reset();
+                rsp_hdr->result = OTA_RSP_ERROR;
+            }
+            // ¾ɱöʱԤǰΪ 0֣ͷǼգ겹ȷ
+            ota_stream.conidx = conidx;
+            app_otas_stream_pump_update();
+            rsp_hdr->rsp.stream_ack.next_seq = 0;
+            rsp_hdr->rsp.stream_ack.window = app_otas_stream_window();
+            rsp_hdr->rsp.stream_ack.bitmap = 0;
+            ota_stream.acked_window = rsp_hdr->rsp.stream_ack.window;
+            break;
         case OTA_CMD_REBOOT:
-            if(first_pkt.buf != NULL)
+#if OTA_STREAM_DELTA
+            // ʱƿܻû꣺дصȣܼٺ룩 BUSY
+            // öʱֻһط REBOOT
+            if(app_otas_stream_delta_busy())
+            {
+                rsp_hdr->result = OTA_RSP_BUSY;
+                break;
+            }
+#endif
+            // ʽû꣨ѹ / ؽʱҳдɾճ
+            if(first_pkt.buf != NULL && app_otas_stream_complete())
             {
                 uint32_t new_bin_base = app_otas_get_storage_address();
 #ifdef OTA_CRC_CHECK
@@ -572,6 +1229,7 @@ void app_otas_recv_data(uint8_t conidx,uint8_t *p_data,uint16_t len)
             app_set_ota_state(0);
             uart_finish_transfers(UART1_BASE);
             ota_clr_buffed_pkt(conidx);
+            app_otas_stream_reset();
             //NVIC_SystemReset();
             platform_reset_patch(0);
 #endif            
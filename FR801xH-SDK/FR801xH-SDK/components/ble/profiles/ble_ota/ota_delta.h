@@ -0,0 +1,111 @@
+/*********************************************************************
+ * @file ota_delta.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 差分 OTA：以正在运行的镜像为底，按 复制 / 插入 操作流式重建新镜像
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 多数版本只改 ble_function.c 里几 KB 逻辑，整包 OTA 却要重传一百多 KB；
+ *   新镜像绝大部分字节在旧镜像里原样存在（或整体平移），只传“从旧镜像哪里复制多少”
+ *   和真正新增的字节，传输量降到改动量的量级。
+ * - 旧镜像就是当前运行区（app_otas_get_curr_code_address），直接从 flash 读，
+ *   设备端只需要一页（256B）输出缓冲；复制按预算分批做，单次回调不会长时间占住 CPU。
+ *
+ * 格式（主机差分工具 host/tools/ota_diff 生成），全部小端：
+ * - 20 字节头：magic "ODL1"、新镜像长度、旧镜像长度、旧镜像 CRC、新镜像 CRC，
+ *   CRC 都是 ota_delta_crc32：旧镜像算 [256, 长度)（运行区首页的版本号可能被上次 OTA 改过），
+ *   新镜像算整个镜像；
+ *   头收齐后先回调 check_fn，由调用方核对运行区确实是这个旧镜像，
+ *   输出满新镜像长度时核对新镜像 CRC，不符算损坏；
+ * - 不用 REBOOT 那个 Crc32CalByByte：它每步用 crc/256 取表索引、再左移丢掉高位，
+ *   结果只取决于最后几个字节，旧镜像中间改了字节也核对不出来，差分以错的底重建就是坏镜像；
+ * - 然后是操作序列，每个操作一个 LEB128 变长整数 h：长度 = h >> 1，
+ *   h & 1 = 0 插入：后跟“长度”个字节原样输出；
+ *   h & 1 = 1 复制：后跟一个 zigzag 编码的 LEB128 源偏移修正量，
+ *             源 = 上次复制的结束位置 + 之后插入的字节数 + 修正量
+ *             （旧代码改几个字节时修正量为 0，整体平移时为平移量）；
+ * - 复制源必须落在旧镜像 [256, 旧长度) 内：首页的 jump table 可能被 OTA 改过版本号，
+ *   不参与 CRC 校验，也就不允许被引用；
+ * - 没有结束标记，输出满新镜像长度即结束，之后再有数据算损坏。
+ *********************************************************************/
+
+#ifndef OTA_DELTA_H
+#define OTA_DELTA_H
+
+#include <stdint.h>
+
+#define OTA_DELTA_MAGIC     0x314C444Fu     //"ODL1"
+#define OTA_DELTA_HDR_LEN   20
+#define OTA_DELTA_PAGE      256
+
+enum
+{
+    OTA_DELTA_NEED_INPUT,   //等更多补丁数据
+    OTA_DELTA_COPYING,      //有复制操作没做完，调 ota_delta_copy 继续，期间不接受输入
+    OTA_DELTA_DONE,         //已输出新镜像全部字节（最后半页也已回调），CRC 一致
+    OTA_DELTA_ERROR,        //补丁损坏、旧镜像不符、越界或新镜像 CRC 不符，不再接受输入
+};
+
+struct ota_delta_hdr
+{
+    uint32_t magic;
+    uint32_t new_length;
+    uint32_t old_length;
+    uint32_t old_crc;
+    uint32_t new_crc;
+};
+
+/* 从旧镜像 old_offset 处读 len 字节 */
+typedef void (*ota_delta_read_fn)(uint8_t *dst, uint32_t old_offset, uint32_t len);
+/* 输出一页（最后一次可能不足一页）；page 即 init 时给的缓冲，回调返回后会被覆盖 */
+typedef void (*ota_delta_page_fn)(const uint8_t *page, uint32_t offset, uint32_t len);
+/* 头收齐后回调，返回 0 表示拒绝（长度超限、运行区不是这个旧镜像） */
+typedef uint8_t (*ota_delta_check_fn)(const struct ota_delta_hdr *hdr);
+
+struct ota_delta_t
+{
+    uint8_t *page;
+    ota_delta_read_fn read_fn;
+    ota_delta_page_fn page_fn;
+    ota_delta_check_fn check_fn;
+    struct ota_delta_hdr hdr;
+    uint32_t out_pos;       //已输出的字节数
+    uint32_t src;           //复制进行中：下一个源偏移；否则：预测的下一个复制源
+    uint32_t len;           //进行中的插入 / 复制还剩的字节数
+    uint32_t var;           //拼到一半的变长整数（头部阶段是已收的头字节数）
+    uint32_t crc;           //已输出的 [0, out_pos) 的 CRC
+    uint8_t var_shift;
+    uint8_t op;
+    uint8_t state;
+};
+
+/**
+ * @brief 开始一次重建
+ * @param page OTA_DELTA_PAGE 字节，重建期间由解码器独占
+ */
+void ota_delta_init(struct ota_delta_t *d, uint8_t *page, ota_delta_read_fn read_fn,
+                    ota_delta_page_fn page_fn, ota_delta_check_fn check_fn);
+
+/**
+ * @brief 喂入补丁数据（可以在任意字节处切开）；遇到复制操作就停下
+ * @return 实际消费的字节数，没消费完的下次（复制做完后）再喂
+ */
+uint32_t ota_delta_feed(struct ota_delta_t *d, const uint8_t *in, uint32_t len);
+
+/**
+ * @brief 继续进行中的复制，最多输出 budget 字节（控制单次回调占用 CPU / flash 的时间）
+ */
+void ota_delta_copy(struct ota_delta_t *d, uint32_t budget);
+
+/**
+ * @return OTA_DELTA_NEED_INPUT / OTA_DELTA_COPYING / OTA_DELTA_DONE / OTA_DELTA_ERROR
+ */
+uint8_t ota_delta_state(const struct ota_delta_t *d);
+
+/**
+ * @brief 标准 CRC-32（多项式 0xEDB88320，与 zlib 相同），可分段累加，crc 初值 0
+ */
+uint32_t ota_delta_crc32(uint32_t crc, const uint8_t *p, uint32_t len);
+
+#endif // OTA_DELTA_H
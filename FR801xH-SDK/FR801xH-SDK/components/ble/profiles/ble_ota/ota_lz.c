@@ -0,0 +1,124 @@
+/*********************************************************************
+ * @file ota_lz.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief OTA 压缩镜像的流式解码实现
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "ota_lz.h"
+
+enum
+{
+    LZ_ST_FLAG,     //等标志字节
+    LZ_ST_ITEM,     //等字面字节或 token 低字节
+    LZ_ST_TOK1,     //等 token 高字节
+    LZ_ST_EXT,      //等追加长度
+    LZ_ST_DONE,
+    LZ_ST_ERROR,
+};
+
+static void lz_put(struct ota_lz_t *lz, uint8_t b)
+{
+    lz->window[lz->out_pos & lz->mask] = b;
+    lz->out_pos++;
+    if((lz->out_pos & (OTA_LZ_PAGE - 1)) == 0)
+    {
+        uint32_t offset = lz->out_pos - OTA_LZ_PAGE;
+        lz->page_fn(&lz->window[offset & lz->mask], offset, OTA_LZ_PAGE);
+    }
+}
+
+/* 解完一项：到 raw_length 就把最后半页交出去；否则换下一个标志位 */
+static void lz_next(struct ota_lz_t *lz)
+{
+    if(lz->out_pos == lz->raw_length)
+    {
+        uint32_t offset = lz->out_pos & ~(uint32_t)(OTA_LZ_PAGE - 1);
+        if(offset != lz->out_pos)
+            lz->page_fn(&lz->window[offset & lz->mask], offset, lz->out_pos - offset);
+        lz->state = LZ_ST_DONE;
+        return;
+    }
+    lz->flags >>= 1;
+    lz->state = (lz->flags == 1) ? LZ_ST_FLAG : LZ_ST_ITEM;
+}
+
+static void lz_copy(struct ota_lz_t *lz, uint32_t len)
+{
+    if(lz->dist > lz->out_pos || len > lz->raw_length - lz->out_pos)
+    {
+        lz->state = LZ_ST_ERROR;
+        return;
+    }
+    // 距离可能小于长度（重复串），只能逐字节拷
+    while(len--)
+        lz_put(lz, lz->window[(lz->out_pos - lz->dist) & lz->mask]);
+    lz_next(lz);
+}
+
+void ota_lz_init(struct ota_lz_t *lz, uint8_t *window, uint8_t window_bits,
+                 uint32_t raw_length, ota_lz_page_fn page_fn)
+{
+    lz->window = window;
+    lz->page_fn = page_fn;
+    lz->raw_length = raw_length;
+    lz->out_pos = 0;
+    lz->mask = (uint16_t)((1u << window_bits) - 1);
+    lz->flags = 1;
+    lz->tok = 0;
+    lz->dist = 0;
+    lz->window_bits = window_bits;
+    lz->state = (raw_length == 0) ? LZ_ST_DONE : LZ_ST_FLAG;
+}
+
+uint8_t ota_lz_decode(struct ota_lz_t *lz, const uint8_t *in, uint32_t len)
+{
+    uint16_t len_max = (uint16_t)((1u << (16 - lz->window_bits)) - 1);
+
+    while(len-- > 0)
+    {
+        uint8_t b = *in++;
+
+        switch(lz->state)
+        {
+            case LZ_ST_FLAG:
+                lz->flags = b | 0x100;
+                lz->state = LZ_ST_ITEM;
+                break;
+            case LZ_ST_ITEM:
+                if(lz->flags & 1)
+                {
+                    lz->tok = b;
+                    lz->state = LZ_ST_TOK1;
+                }
+                else
+                {
+                    lz_put(lz, b);
+                    lz_next(lz);
+                }
+                break;
+            case LZ_ST_TOK1:
+                lz->tok |= (uint16_t)b << 8;
+                lz->dist = (lz->tok & lz->mask) + 1;
+                lz->tok >>= lz->window_bits;
+                if(lz->tok == len_max)
+                    lz->state = LZ_ST_EXT;
+                else
+                    lz_copy(lz, lz->tok + OTA_LZ_MIN_MATCH);
+                break;
+            case LZ_ST_EXT:
+                lz_copy(lz, lz->tok + OTA_LZ_MIN_MATCH + b);
+                break;
+            default:
+                // 结束后还有输入也算损坏
+                lz->state = LZ_ST_ERROR;
+                return OTA_LZ_ERROR;
+        }
+        if(lz->state == LZ_ST_ERROR)
+            return OTA_LZ_ERROR;
+    }
+    if(lz->state == LZ_ST_DONE)
+        return OTA_LZ_DONE;
+    return (lz->state == LZ_ST_ERROR) ? OTA_LZ_ERROR : OTA_LZ_OK;
+}
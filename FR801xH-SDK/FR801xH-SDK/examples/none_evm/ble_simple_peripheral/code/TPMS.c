@@ -16,6 +16,8 @@
 #include "flash_usage_config.h"
 #include "co_printf.h"
 #include "driver_flash.h"
+#include "driver_system.h"
+#include "kv_store.h"
 #include "os_timer.h"
 #include <string.h>
 #include "usart_cmd.h"
@@ -78,17 +80,23 @@ static void copy_mac(uint8_t dst[6], const uint8_t src[6])
 }
 
 
-static void tpms_dump_hex(const uint8_t *p, uint8_t len)
-{
+static void tpms_dump_hex(const uint8_t *p, uint8_t len)
+{
+#if TPMS_LOG_ENABLE
     if (p == NULL) {
         TPMS_LOG("[TPMS] ADV: null\r\n");
         return;
     }
     TPMS_LOG("[TPMS] ADV len=%u: ", (unsigned)len);
     for (uint8_t i = 0; i < len; i++) {
-        TPMS_LOG("%02X ", p[i]);
-    }
-    TPMS_LOG("\r\n");
+        TPMS_LOG("%02X ", p[i]);
+    }
+    TPMS_LOG("\r\n");
+#else
+    /* 日志关闭时连循环也不走：每条扫描报告都会经过这里 */
+    (void)p;
+    (void)len;
+#endif
 }
 
 static bool tpms_adv_name_is_tpmss(const uint8_t *adv, uint8_t adv_len)
@@ -140,8 +148,8 @@ static uint16_t tpms_crc16_ccitt_false(const uint8_t *data, uint32_t len)
 }
 
 /*********************************************************************
- * @brief Flash 存储体：单扇区保存绑定表（含头/版本/长度/CRC16）。
- * @note  写入需整扇区擦除；读取需校验 magic/version/size 与 CRC16。
+ * @brief Flash 存储体：绑定表（含头/版本/长度/CRC16），作为 kv_store 的一个值保存。
+ * @note  布局与旧的单扇区存储一致，迁移时直接按此结构读旧扇区；读取需校验 magic/version/size 与 CRC16。
  */
 typedef struct {
 	uint32_t magic;   /* 'TPMS' */
@@ -191,30 +199,44 @@ static bool tpms_binding_any_valid(void)
 /*
  * Flash 存储说明：
  * - 存储结构 tpms_bind_store_t 带 magic/version/size 和 CRC16，避免脏数据误读
- * - 读取：直接 flash_read 到结构体，校验 magic/version/size 和 CRC16 后才生效
- * - 写入：先填充结构体并计算 CRC16 -> 如开启 FLASH_PROTECT 则先 disable -> flash_erase 扇区 -> flash_write 全结构
+ * - 存在 kv_store 的 KV_KEY_TPMS_BIND 下：改绑只追加一条记录，不再每次擦 4KB 扇区
+ * - 旧固件写在 TPMS_BINDING_INFO_SAVE_ADDR 扇区的整块存储：kv_store 里没有时读一次，
+ *   校验通过就搬进 kv_store，之后不再读写旧扇区
  */
-static void tpms_bind_store_load(void)
+static bool tpms_bind_store_apply(const tpms_bind_store_t *st)
 {
-	tpms_bind_store_t st;
-	memset(&st, 0, sizeof(st));
-	flash_read(TPMS_BINDING_INFO_SAVE_ADDR, sizeof(st), (uint8_t *)&st);
-
 	/* 基本头校验，避免误把未初始化/损坏的数据当成有效绑定 */
-	if (st.magic != TPMS_BIND_STORE_MAGIC || st.version != 1u || st.size != (uint16_t)sizeof(st)) {
-		return;
+	if (st->magic != TPMS_BIND_STORE_MAGIC || st->version != 1u || st->size != (uint16_t)sizeof(*st)) {
+		return false;
 	}
-	uint16_t calc = tpms_crc16_ccitt_false((const uint8_t *)&st, (uint32_t)(sizeof(st) - sizeof(st.crc16) - sizeof(st.rsv2)));
-	if (calc != st.crc16) {
-		return;
+	uint16_t calc = tpms_crc16_ccitt_false((const uint8_t *)st, (uint32_t)(sizeof(*st) - sizeof(st->crc16) - sizeof(st->rsv2)));
+	if (calc != st->crc16) {
+		return false;
 	}
 
 	/* 校验通过后恢复各轮位绑定 */
 	for (int i = 0; i < TPMS_SENSOR_MAX; i++) {
-		if (st.entry[i].valid) {
-			tpms_binding_set((uint8_t)i, st.entry[i].sensor_id, st.entry[i].mac_le);
+		if (st->entry[i].valid) {
+			tpms_binding_set((uint8_t)i, st->entry[i].sensor_id, st->entry[i].mac_le);
 		}
 	}
+	return true;
+}
+
+static void tpms_bind_store_load(void)
+{
+	tpms_bind_store_t st;
+	memset(&st, 0, sizeof(st));
+	if (KV_Get(KV_KEY_TPMS_BIND, &st, sizeof(st)) == sizeof(st) && tpms_bind_store_apply(&st)) {
+		return;
+	}
+
+	/* 旧存储迁移 */
+	memset(&st, 0, sizeof(st));
+	flash_read(TPMS_BINDING_INFO_SAVE_ADDR, sizeof(st), (uint8_t *)&st);
+	if (tpms_bind_store_apply(&st)) {
+		KV_Put(KV_KEY_TPMS_BIND, &st, sizeof(st));
+	}
 }
 
 static void tpms_bind_store_save(void)
@@ -231,15 +253,10 @@ static void tpms_bind_store_save(void)
 	}
 	st.crc16 = tpms_crc16_ccitt_false((const uint8_t *)&st, (uint32_t)(sizeof(st) - sizeof(st.crc16) - sizeof(st.rsv2)));
 
-	/* 擦除-写入流程：必须先擦除 4KB 扇区，再整体写入结构体 */
-#ifdef FLASH_PROTECT
-	flash_protect_disable(1);
-#endif
-	flash_erase(TPMS_BINDING_INFO_SAVE_ADDR, 0x1000);
-	flash_write(TPMS_BINDING_INFO_SAVE_ADDR, sizeof(st), (uint8_t *)&st);
-#ifdef FLASH_PROTECT
-	flash_protect_enable(1);
-#endif
+	/* 追加写一条记录；内容没变时 kv_store 不写 flash */
+	if (!KV_Put(KV_KEY_TPMS_BIND, &st, sizeof(st))) {
+		co_printf("[TPMS] bind store save failed\r\n");
+	}
 }
 
 /* Replace/Learn 状态机：使用定时器窗口选中候选 */
@@ -309,6 +326,26 @@ static tpms_learn_cand_t *tpms_learn_find_or_alloc(uint32_t sensor_id, const uin
 	return &g_tpms_learn.cand[worst];
 }
 
+static TPMS_ScanModeCb g_tpms_scan_mode_cb;
+
+bool TPMS_Scan_Filter_Allowed(void)
+{
+	return !g_tpms_learn.active && tpms_binding_any_valid();
+}
+
+void TPMS_Set_Scan_Mode_Cb(TPMS_ScanModeCb cb)
+{
+	g_tpms_scan_mode_cb = cb;
+}
+
+/* 绑定/学习状态可能变了：告诉扫描器（模式没变时由扫描器自己忽略） */
+static void tpms_scan_mode_notify(void)
+{
+	if (g_tpms_scan_mode_cb != NULL) {
+		g_tpms_scan_mode_cb(TPMS_Scan_Filter_Allowed());
+	}
+}
+
 static void tpms_learn_timer_cb(void *arg)
 {
 	(void)arg;
@@ -346,6 +383,7 @@ static void tpms_learn_timer_cb(void *arg)
 	}
 
 	g_tpms_learn.active = false;
+	tpms_scan_mode_notify();
 }
 
 /**
@@ -384,6 +422,138 @@ static int pick_slot_by_frame(const TPMS_Frame *f, const uint8_t mac_le[6])
 	return -1;
 }
 
+/* ==================== 透传去重 ==================== */
+/* system_get_curr_time() 到 0x4FFFFFF 后回绕到 0 */
+#define TPMS_TIME_WRAP (0x5000000u)
+
+typedef struct {
+	bool used;
+	uint32_t sensor_id;
+	uint32_t rolling_cnt;
+	uint16_t pressure_kpa_x100;
+	int8_t temperature_c;
+	uint16_t battery_v_x100;
+	uint8_t status_raw;
+	uint32_t last_seen_ms; /* 淘汰用 */
+	uint32_t last_tx_ms;   /* 心跳用 */
+} tpms_relay_entry_t;
+
+static struct {
+	bool enable;
+	uint32_t heartbeat_ms;
+	TPMS_RelayStats stats;
+	tpms_relay_entry_t entry[TPMS_RELAY_CACHE_MAX];
+} g_tpms_relay = {
+	.enable = true,
+	.heartbeat_ms = TPMS_RELAY_HEARTBEAT_MS,
+};
+
+static uint32_t tpms_elapsed(uint32_t now, uint32_t then)
+{
+	return (now >= then) ? (now - then) : (now + TPMS_TIME_WRAP - then);
+}
+
+static void tpms_relay_remember(tpms_relay_entry_t *e, const TPMS_Frame *f, uint32_t now)
+{
+	e->used = true;
+	e->sensor_id = f->sensor_id;
+	e->rolling_cnt = f->rolling_cnt;
+	e->pressure_kpa_x100 = f->pressure_kpa_x100;
+	e->temperature_c = f->temperature_c;
+	e->battery_v_x100 = f->battery_v_x100;
+	e->status_raw = f->status_raw;
+	e->last_seen_ms = now;
+	e->last_tx_ms = now;
+}
+
+/* 找 sensor_id 对应的表项；没有就占空位，满了淘汰最久没收到的 */
+static tpms_relay_entry_t *tpms_relay_lookup(uint32_t sensor_id, uint32_t now, bool *is_new)
+{
+	tpms_relay_entry_t *victim = NULL;
+
+	*is_new = false;
+	for (int i = 0; i < TPMS_RELAY_CACHE_MAX; i++) {
+		tpms_relay_entry_t *e = &g_tpms_relay.entry[i];
+		if (e->used && e->sensor_id == sensor_id) {
+			return e;
+		}
+		if (victim == NULL || (victim->used && (!e->used ||
+		    tpms_elapsed(now, e->last_seen_ms) > tpms_elapsed(now, victim->last_seen_ms)))) {
+			victim = e;
+		}
+	}
+	if (victim->used) {
+		g_tpms_relay.stats.evicted++;
+	}
+	*is_new = true;
+	return victim;
+}
+
+/**
+ * @brief 这一帧要不要发给 MCU（见 TPMS.h 里 TPMS_RelayStats 前的说明）
+ */
+static bool tpms_relay_should_send(const TPMS_Frame *f)
+{
+	uint32_t now = system_get_curr_time();
+	bool is_new;
+
+	if (!g_tpms_relay.enable) {
+		g_tpms_relay.stats.forwarded++;
+		return true;
+	}
+
+	tpms_relay_entry_t *e = tpms_relay_lookup(f->sensor_id, now, &is_new);
+	if (is_new || e->pressure_kpa_x100 != f->pressure_kpa_x100 || e->temperature_c != f->temperature_c ||
+	    e->battery_v_x100 != f->battery_v_x100 || e->status_raw != f->status_raw) {
+		tpms_relay_remember(e, f, now);
+		g_tpms_relay.stats.forwarded++;
+		return true;
+	}
+
+	e->last_seen_ms = now;
+	if (g_tpms_relay.heartbeat_ms != 0u && tpms_elapsed(now, e->last_tx_ms) >= g_tpms_relay.heartbeat_ms) {
+		tpms_relay_remember(e, f, now);
+		g_tpms_relay.stats.forwarded++;
+		g_tpms_relay.stats.heartbeats++;
+		return true;
+	}
+	if (e->rolling_cnt == f->rolling_cnt) {
+		g_tpms_relay.stats.sup_dup++;
+	} else {
+		e->rolling_cnt = f->rolling_cnt;
+		g_tpms_relay.stats.sup_unchanged++;
+	}
+	return false;
+}
+
+static void tpms_relay_reset(void)
+{
+	memset(g_tpms_relay.entry, 0, sizeof(g_tpms_relay.entry));
+	TPMS_Relay_Reset_Stats();
+}
+
+void TPMS_Relay_Set_Enable(bool enable)
+{
+	g_tpms_relay.enable = enable;
+}
+
+void TPMS_Relay_Set_Heartbeat(uint32_t heartbeat_ms)
+{
+	g_tpms_relay.heartbeat_ms = heartbeat_ms;
+}
+
+void TPMS_Relay_Get_Stats(TPMS_RelayStats *out)
+{
+	if (out != NULL) {
+		*out = g_tpms_relay.stats;
+	}
+}
+
+void TPMS_Relay_Reset_Stats(void)
+{
+	memset(&g_tpms_relay.stats, 0, sizeof(g_tpms_relay.stats));
+}
+
 /**
  * @brief 设置指定槽位绑定的目标 MAC
  */
@@ -416,6 +586,11 @@ static void tpms_feed_adv(const uint8_t mac_le[6], int8_t rssi, const uint8_t *d
 		return; /* 非 TPMS 广播直接忽略，避免误学习 */
 	}
 
+	/* 同一测量的重复包（连发/ADV+SCAN_RSP）和没变化的数值不再逐条发给 MCU */
+	if (!tpms_relay_should_send(&frame)) {
+		return;
+	}
+
 #if 1 /* Pass-through Mode: Directly Send to UART */
     /* Resp payload: Wheel(1)+ID(4)+Press(2)+Temp(1)+Volt(2)+Status(1)+MAC(6) = 17 Bytes */
     uint8_t report_buf[18];
@@ -514,6 +689,102 @@ static uint32_t u32_le(const uint8_t *p)
 	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
 }
 
+/* ==================== 扫描前置过滤 ==================== */
+static bool g_tpms_pf_enable = true;
+static TPMS_PrefilterStats g_tpms_pf;
+
+/*
+ * 签名检查：与 TPMS_Parse_Adv 认得的格式一一对应，只是不做字段换算。
+ * 只许比 Parse 宽、不许比它严（宁可放进来由 Parse 拒绝，也不能漏掉真传感器），
+ * 所以和 Parse 一样每个 0xFF 段都看。命中时顺带取出 sensor_id（绑定检查用）。
+ */
+static bool tpms_prefilter_sig(const uint8_t *adv, uint8_t adv_len, uint32_t *sensor_id)
+{
+	const uint8_t *named_ff = NULL; /* 0xFF 头的 0xFF 段，要等看完名字才能定 */
+	bool named = false;
+	uint8_t idx = 0u;
+
+	while (idx < adv_len) {
+		uint8_t l = adv[idx];
+		if (l == 0u || (uint8_t)(idx + 1u + l) > adv_len) {
+			break;
+		}
+		uint8_t type = adv[idx + 1u];
+		const uint8_t *ff = &adv[idx + 2u];
+		if (type == BLE_AD_TYPE_MANUFACTURER_SPECIFIC) {
+			/* 0x4D 头 / 0x93 0x4D 头：sensor_id 都在 payload[6..9]（小端） */
+			if (l == 0x14u && (ff[0] == TPMS_PAYLOAD_HEADER || (ff[0] == 0x93u && ff[1] == TPMS_PAYLOAD_HEADER))) {
+				*sensor_id = u32_le(&ff[6]);
+				return true;
+			}
+			if (l >= 18u && ff[0] == 0xFFu && named_ff == NULL) {
+				named_ff = ff;
+			}
+		} else if ((type == 0x09u || type == 0x08u) && l == 6u && memcmp(ff, "TPMSS", 5u) == 0) {
+			named = true;
+		}
+		idx = (uint8_t)(idx + 1u + l);
+	}
+
+	/* 0xFF 头 + "TPMSS" 名：sensor_id 在 payload[1..4]（大端） */
+	if (named && named_ff != NULL) {
+		*sensor_id = u32_be(&named_ff[1]);
+		return true;
+	}
+	return false;
+}
+
+bool TPMS_Prefilter(const uint8_t mac_le[6], const uint8_t *data, uint16_t len)
+{
+	uint32_t sensor_id = 0u;
+
+	if (!g_tpms_pf_enable) {
+		g_tpms_pf.accepted++;
+		return true;
+	}
+	if (mac_le == NULL || data == NULL || len < TPMS_PREFILTER_MIN_LEN || len > 31u) {
+		g_tpms_pf.rej_len++;
+		return false;
+	}
+	if (!tpms_prefilter_sig(data, (uint8_t)len, &sensor_id)) {
+		g_tpms_pf.rej_sig++;
+		return false;
+	}
+
+	/* 有绑定且不在学习窗口：只认绑定的传感器（兼容旧绑定按 MAC 认） */
+	if (!g_tpms_learn.active && tpms_binding_any_valid()) {
+		bool hit = false;
+		for (int i = 0; i < TPMS_SENSOR_MAX && !hit; i++) {
+			hit = g_tpms_binding[i].valid &&
+				  (g_tpms_binding[i].sensor_id == sensor_id || mac_equal(g_tpms_binding[i].mac_le, mac_le));
+		}
+		if (!hit) {
+			g_tpms_pf.rej_bind++;
+			return false;
+		}
+	}
+
+	g_tpms_pf.accepted++;
+	return true;
+}
+
+void TPMS_Prefilter_Set_Enable(bool enable)
+{
+	g_tpms_pf_enable = enable;
+}
+
+void TPMS_Prefilter_Get_Stats(TPMS_PrefilterStats *out)
+{
+	if (out != NULL) {
+		*out = g_tpms_pf;
+	}
+}
+
+void TPMS_Prefilter_Reset_Stats(void)
+{
+	memset(&g_tpms_pf, 0, sizeof(g_tpms_pf));
+}
+
 /**
  * @brief status 高 4bit 解码为电池状态
  * @param status_high_nibble status[7:4]
@@ -558,8 +829,6 @@ static TPMS_Mode tpms_decode_mode(uint8_t mode_low_nibble)
  */
 bool TPMS_Parse_Adv(const uint8_t *adv, uint8_t adv_len, TPMS_Frame *out)
 {
-	bool name_tpmss = tpms_adv_name_is_tpmss(adv, adv_len);
-
 	if (out) {
 		memset(out, 0, sizeof(*out));
 	}
@@ -633,7 +902,8 @@ bool TPMS_Parse_Adv(const uint8_t *adv, uint8_t adv_len, TPMS_Frame *out)
 				return true;
 			}
 
-			if (name_tpmss && payload_len >= 17u && payload[0] == 0xFFu) {
+			/* 名字查找要再走一遍 AD，只在格式可能命中时才做 */
+			if (payload_len >= 17u && payload[0] == 0xFFu && tpms_adv_name_is_tpmss(adv, adv_len)) {
 				out->header = payload[0];
 				out->status_raw = payload[10];
 				out->batt_status = tpms_decode_batt((uint8_t)((out->status_raw >> 4) & 0x0F));
@@ -693,6 +963,8 @@ void TPMS_Init(void)
 	memset(&g_tpms, 0, sizeof(g_tpms));
 	memset(&g_tpms_binding, 0, sizeof(g_tpms_binding));
 	memset(&g_tpms_learn, 0, sizeof(g_tpms_learn));
+	TPMS_Prefilter_Reset_Stats();
+	tpms_relay_reset();
 	for (int i = 0; i < TPMS_SENSOR_MAX; i++) {
 		for (int j = 0; j < 6; j++) {
 			g_tpms.target_mac[i][j] = 0xFF;
@@ -726,6 +998,7 @@ void TPMS_Replace_Start(uint8_t wheel_idx, uint32_t window_ms)
 	g_tpms_learn.wheel_idx = wheel_idx;
 	tpms_learn_reset_candidates();
 	os_timer_start(&g_tpms_learn.timer, window_ms, false);
+	tpms_scan_mode_notify();
 
 	co_printf("[TPMS] REPLACE START wheel=%u window=%ums\r\n", (unsigned)wheel_idx, (unsigned)window_ms);
 }
@@ -735,6 +1008,7 @@ void TPMS_Clear_Binding(uint8_t wheel_idx)
 	if (wheel_idx >= TPMS_SENSOR_MAX) return;
 	tpms_binding_clear(wheel_idx);
 	tpms_bind_store_save();
+	tpms_scan_mode_notify();
 	co_printf("[TPMS] CLEAR wheel=%u\r\n", (unsigned)wheel_idx);
 }
 
@@ -744,6 +1018,7 @@ void TPMS_Clear_All_Bindings(void)
 		tpms_binding_clear((uint8_t)i);
 	}
 	tpms_bind_store_save();
+	tpms_scan_mode_notify();
 	co_printf("[TPMS] CLEAR ALL\r\n");
 }
 
@@ -155,5 +155,103 @@ void TPMS_Binding_Print(void);
  */
 bool TPMS_Parse_Adv(const uint8_t *adv, uint8_t adv_len, TPMS_Frame *out);
 
+/**
+ * @brief 扫描前置过滤的最短报告长度：最短的已知格式是单个 0xFF 段（len+type+19 字节）
+ */
+#ifndef TPMS_PREFILTER_MIN_LEN
+#define TPMS_PREFILTER_MIN_LEN 21u
+#endif
+
+/**
+ * @brief 前置过滤计数（只增不减，TPMS_Prefilter_Reset_Stats 清零）
+ */
+typedef struct {
+	uint32_t accepted; /**< 放行给 TPMS_Feed_Adv 的报告数 */
+	uint32_t rej_len;  /**< 长度不可能是 TPMS 的 */
+	uint32_t rej_sig;  /**< 没有 TPMS 签名（0xFF 段长度/0x4D 头）的 */
+	uint32_t rej_bind; /**< 是 TPMS，但 MAC/sensor_id 不在绑定表里的 */
+} TPMS_PrefilterStats;
+
+/**
+ * @brief 扫描报告前置过滤：在缓存拷贝和整段 AD 解析之前快速拒绝非 TPMS 报告
+ *
+ * @details
+ * 停车场里几百个 BLE 设备，每 100 ms 扫描周期都会上报；以前每条报告都要拷进缓存、
+ * 走一遍名字查找、再交给 TPMS_Parse_Adv 做完整 TLV 解析，绝大多数是白做。
+ * 这里按从便宜到贵的顺序拒绝：
+ * 1) 长度：不在 [TPMS_PREFILTER_MIN_LEN, 31] 内；
+ * 2) 签名：只读各 AD 段的 len/type 字节找 0xFF 段，并要求长度与头字节符合
+ *    TPMS_Parse_Adv 认得的格式（0x13 + 0x4D / 0x13 + 0x93 0x4D / >=17 + 0xFF 且带 "TPMSS" 名）；
+ * 3) 绑定：已有绑定且不在更换/学习窗口时，MAC 或 sensor_id 必须命中绑定表
+ *    （没有任何绑定或正在学习时放行所有 TPMS，保持透传行为）。
+ * 过滤关闭（TPMS_Prefilter_Set_Enable(false)）时一律放行，便于对照。
+ *
+ * @param mac_le 广播源 MAC（小端）
+ * @param data   报告数据
+ * @param len    报告长度（未截断的原始长度）
+ * @return true=交给 TPMS_Feed_Adv；false=丢弃
+ */
+bool TPMS_Prefilter(const uint8_t mac_le[6], const uint8_t *data, uint16_t len);
+void TPMS_Prefilter_Set_Enable(bool enable);
+void TPMS_Prefilter_Get_Stats(TPMS_PrefilterStats *out);
+void TPMS_Prefilter_Reset_Stats(void);
+
+/**
+ * @brief 透传去重缓存容量（按 sensor_id，满了淘汰最久没收到的）
+ * @note 不绑定时会透传附近别的车的传感器，所以比 TPMS_SENSOR_MAX 大
+ */
+#ifndef TPMS_RELAY_CACHE_MAX
+#define TPMS_RELAY_CACHE_MAX 8
+#endif
+
+/**
+ * @brief 数值不变时的心跳间隔（ms）：超过该时间没发过就再发一次，让 MCU 知道传感器还在
+ */
+#ifndef TPMS_RELAY_HEARTBEAT_MS
+#define TPMS_RELAY_HEARTBEAT_MS 60000u
+#endif
+
+/**
+ * @brief 透传去重计数（只增不减，TPMS_Relay_Reset_Stats 清零）
+ */
+typedef struct {
+	uint32_t forwarded;     /**< 发给 MCU 的帧数（新传感器/数值变化/心跳） */
+	uint32_t heartbeats;    /**< 其中因心跳而发的 */
+	uint32_t sup_dup;       /**< 抑制：同一包的重复（rolling_cnt 与数值都相同，含 ADV+SCAN_RSP） */
+	uint32_t sup_unchanged; /**< 抑制：新一轮测量但数值没变、心跳未到 */
+	uint32_t evicted;       /**< 缓存满时淘汰的传感器数 */
+} TPMS_RelayStats;
+
+/**
+ * @brief 透传去重：同一传感器只在有新数据时才转发给 MCU
+ *
+ * @details
+ * 传感器每次唤醒连发多包相同内容，ADV 和 SCAN_RSP 又各来一份；以前每条都发一帧
+ * 18 字节的 CMD_Tire_pressure_monitoring_get，MCU 被反复唤醒处理同样的数。
+ * 现在按 sensor_id 记住上次转发的 rolling_cnt 与压力/温度/电压/状态：
+ * - 第一次见到、或任一数值/状态变化：立即转发（漏气报警不受影响）；
+ * - 数值不变：距上次转发超过心跳间隔才再发一次，否则只计数；
+ * - rolling_cnt 只用来区分“同一包重复”和“新测量但数值没变”，便于统计。
+ * 关闭（TPMS_Relay_Set_Enable(false)）时每条都转发，便于对照。
+ */
+void TPMS_Relay_Set_Enable(bool enable);
+/** @param heartbeat_ms 0=数值不变就一直不发 */
+void TPMS_Relay_Set_Heartbeat(uint32_t heartbeat_ms);
+void TPMS_Relay_Get_Stats(TPMS_RelayStats *out);
+void TPMS_Relay_Reset_Stats(void);
+
+/**
+ * @brief 扫描模式：有有效绑定且不在更换/学习窗口时，扫描器可以切到过滤扫描
+ *
+ * @details
+ * 过滤扫描只需要看本车的传感器；学习窗口和未绑定时要看所有 TPMS，必须开放扫描。
+ * 绑定/学习状态变化时（TPMS_Replace_Start 开始、学习窗口结束、清绑定）回调通知，
+ * 扫描器据此重启扫描换参数。
+ */
+typedef void (*TPMS_ScanModeCb)(bool filtered);
+
+bool TPMS_Scan_Filter_Allowed(void);
+void TPMS_Set_Scan_Mode_Cb(TPMS_ScanModeCb cb);
+
 #endif // TPMS_H
 
@@ -0,0 +1,33 @@
+/*********************************************************************
+ * @file bcc.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 协议帧 BCC（逐字节异或）的按字计算：单独求、边拷贝边求
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 手机协议每帧都要算一遍 BCC：发送时组完帧再从头逐字节异或，接收时解析完头尾
+ *   又单独走一遍，还有 phone_reply / ACK 各一份同样的循环。
+ * - 异或满足交换律，一次取 4 字节异或、最后把 32 位折叠成 8 位，结果与逐字节相同，
+ *   Cortex-M3 上循环次数降到约 1/4。
+ * - Bcc_CopyXor 把“拷贝 payload”和“累计 BCC”合成一遍，明文帧组帧时不用再回扫。
+ *********************************************************************/
+
+#ifndef BCC_H
+#define BCC_H
+
+#include <stdint.h>
+
+/**
+ * @brief 在 acc 基础上继续异或 buf[0..len)
+ * @return 新的累计值（acc=0 时即 buf 的 BCC）
+ */
+uint8_t Bcc_Xor(uint8_t acc, const uint8_t* buf, uint16_t len);
+
+/**
+ * @brief 拷贝 src -> dst（不可重叠），同时在 acc 基础上累计 src 的异或
+ * @return 新的累计值
+ */
+uint8_t Bcc_CopyXor(uint8_t acc, uint8_t* dst, const uint8_t* src, uint16_t len);
+
+#endif // BCC_H
@@ -7,12 +7,25 @@
 #include "ble_function.h"
 #include "co_printf.h"
 
+/*
+ * 日志级别：每条手机命令都会走到这里的 BleFunc_*，
+ * payload/UART 帧的逐字节 dump 统一为 DEBUG，默认编译期裁掉。
+ */
+#ifndef BLEFUNC_LOG_LEVEL
+#define BLEFUNC_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#define APP_LOG_LEVEL BLEFUNC_LOG_LEVEL
+#include "app_log.h"
+
 #include "proto_time6_bcd.h"
 #include "protocol.h"
+#include "protocol_cmd_table.h"
 #include "gap_api.h"
 #include "param_sync.h"
 
+#include "conn_ctx.h"
 #include "rssi_check.h"
+#include "rssi_report.h"
 
 #include "usart_cmd.h"
 #include "usart_device.h"
@@ -134,46 +147,86 @@ static const uint8_t TBOX_KEY[24] = {'1', '2', '3', '4', '5', '6', '7', '8',
 #define BLEFUNC_DEV_ACCEPT_ANY_TOKEN 1
 #endif
 
-/* ====== MCU Transaction: 链式指令支持（用�?0x06FD 这类“一�?BLE 命令拆成多条
- * MCU 命令”的场景�?====== */
-#define BLEFUNC_MCU_CHAIN_NONE            (0u)
-#define BLEFUNC_MCU_CHAIN_CHORD_HORN_06FD (1u)
-#define BLEFUNC_MCU_CHAIN_GEAR_SET_FD     (2u)
-#define BLEFUNC_MCU_CHAIN_RADAR_SET_FD    (3u)
+/*
+ * ====== MCU Transaction: 多槽流水线 ======
+ *
+ * @why
+ * - 旧实现只有一个 s_mcu_pending：MCU 回包前（串口往返 + MCU 处理，十几 ms）
+ *   任何新指令都直接回 0x01。多条链路同时操作、或 App 连点几个开关时，大部分
+ *   指令被拒，而串口这段时间其实是空闲的。
+ * - 现在改成“槽位表 + 有序发送队列”：
+ *   1) 槽位按 (mcu_id, conidx) 区分，同一链路同一条指令未回包前再发才算忙；
+ *   2) MCU 侧同时未回包的帧最多 BLEFUNC_MCU_TXN_WINDOW 条，多出来的按受理顺序
+ *      排队，回包/超时腾出窗口后依次发出（MCU 串口按序处理、按序回包）；
+ *   3) 每个槽位独立超时，从受理开始计时，App 一定在 BLEFUNC_MCU_TIMEOUT_MS
+ *      内收到回复（排队时间也算在内）；
+ *   4) MCU 回包不带 conidx，按 id 在整张表里匹配“最早发出”的槽位。
+ * - BLEFUNC_MCU_TXN_SLOTS=1 时与旧实现行为一致（忙即拒）。
+ */
+#ifndef BLEFUNC_MCU_TXN_SLOTS
+#define BLEFUNC_MCU_TXN_SLOTS 8u
+#endif
+
+/* MCU 侧同时未回包的帧数上限（MCU 串口接收缓冲有限，不能无限灌） */
+#ifndef BLEFUNC_MCU_TXN_WINDOW
+#define BLEFUNC_MCU_TXN_WINDOW 4u
+#endif
+
+/* 只有需要排队时才拷贝 payload（已去 Time6）；更长的请求在窗口满时按忙处理 */
+#ifndef BLEFUNC_MCU_TXN_PAYLOAD_MAX
+#define BLEFUNC_MCU_TXN_PAYLOAD_MAX 32u
+#endif
+
+#if (BLEFUNC_MCU_TXN_SLOTS < 1u) || (BLEFUNC_MCU_TXN_SLOTS > 255u)
+#error "BLEFUNC_MCU_TXN_SLOTS must be 1..255"
+#endif
+#if (BLEFUNC_MCU_TXN_WINDOW < 1u) || \
+    (BLEFUNC_MCU_TXN_WINDOW > BLEFUNC_MCU_TXN_SLOTS)
+#error "BLEFUNC_MCU_TXN_WINDOW must be 1..BLEFUNC_MCU_TXN_SLOTS"
+#endif
+
+#define BLEFUNC_MCU_TXN_FREE   (0u)
+#define BLEFUNC_MCU_TXN_QUEUED (1u) /* 已受理，等待发送窗口 */
+#define BLEFUNC_MCU_TXN_SENT   (2u) /* 已发给 MCU，等待回包 */
+
+#define BLEFUNC_MCU_SEQ_NONE (0xFFu)
 
 typedef struct {
-    bool     active;
+    uint8_t  state; /* BLEFUNC_MCU_TXN_* */
     bool     timer_inited;
     uint8_t  conidx;
     uint16_t reply_cmd;
     uint16_t req_feature;
     uint16_t resp_feature;
-    uint16_t id;
-    /*
-     * 链式事务上下文：
-     * - 某些 BLE 指令（如 0x06FD）payload 是复合字段，MCU 协议要求拆成多条 1B
-     * data �?CMD�?
-     * - 这里�?chain_kind/chain_step 在收到第 1 �?MCU 回包后自动触发第 2 �?MCU
-     * 下发�?
-     */
-    uint8_t chain_kind; /* BLEFUNC_MCU_CHAIN_* */
-    uint8_t chain_step; /* 0=等待�?步回包，1=等待�?步回�?*/
-    uint8_t
-        chain_u8_0; /* 预留：当前用于保�?0x06FD �?volume�?B）或档位 speed(1B) */
-    uint16_t
-        chain_u16_0; /* 预留：当前用于保存“第 2 步”的 MCU 命令
-                             ID（例�?speed_set�?*/
+    uint16_t id;       /* 发给 MCU 的 id（已映射），用于匹配回包 */
+    uint32_t ticket;   /* 发出序号：同 id 多个槽位在途时，回包归最早发出的那个 */
+    uint8_t  seq;      /* 所属多步序列（s_mcu_seq 下标），BLEFUNC_MCU_SEQ_NONE=单步 */
+    uint8_t  seq_step; /* 序列中的步骤下标 */
+    uint16_t   payload_len;
+    uint8_t    payload[BLEFUNC_MCU_TXN_PAYLOAD_MAX]; /* 仅 QUEUED 时有效 */
     os_timer_t timer;
-} blefunc_mcu_pending_t;
+} blefunc_mcu_txn_t;
+
+static blefunc_mcu_txn_t s_mcu_txn[BLEFUNC_MCU_TXN_SLOTS];
+
+/* 发送队列：按受理顺序保存 QUEUED 槽位下标（环形，容量 = 槽位数） */
+static uint8_t  s_mcu_txq[BLEFUNC_MCU_TXN_SLOTS];
+static uint8_t  s_mcu_txq_head     = 0u;
+static uint8_t  s_mcu_txq_cnt      = 0u;
+static uint8_t  s_mcu_txn_inflight = 0u; /* SENT 槽位数 */
+static uint32_t s_mcu_txn_ticket   = 0u;
 
-static blefunc_mcu_pending_t s_mcu_pending;
+static BleFunc_McuTxnStats_t s_mcu_txn_stats;
 
 /* RSSI->MCU 触发：每条链路进�?NEAR 只触发一次，离开 NEAR 后允许再次触�?*/
-static uint8_t s_rssi_near_latched[RSSI_MAX_CONN] = {0};
+#if RSSI_MAX_CONN > APP_MAX_CONN
+#error "RSSI_MAX_CONN must not exceed APP_MAX_CONN"
+#endif
+#define BLEFUNC_NEAR_LATCHED(conidx) (Conn_Get(conidx)->rssi_near_latched)
 
 /* 业务约定：RSSI 确认近距离后，下发给 MCU 的命令号（走 FF01 通道�?*/
 #ifndef BLEFUNC_CMD_RSSI_NEAR_CONFIRM
-#define BLEFUNC_CMD_RSSI_NEAR_CONFIRM (0x0118u)
+#define BLEFUNC_CMD_RSSI_NEAR_CONFIRM RSSI_REPORT_CMD
 #endif
 
 void BleFunc_RSSI_RawInd(uint8_t conidx, int8_t raw_rssi) {
@@ -195,23 +248,10 @@ void BleFunc_RSSI_RawInd(uint8_t conidx, int8_t raw_rssi) {
     int8_t flt_rssi = (int8_t)flt16;
 
     /*
-     * payload 约定（你指定）：
-     * - 1B: RSSI 滤波值（int8，EMA 输出；二进制补码形式，直接透传�?
-     * - 6B: 对端 MAC
+     * 是否发、和谁合帧由 rssi_report 的策略决定（死区/间隔/稳定抑制）；
+     * 记录格式不变：1B 滤波值（int8 补码）+ 6B 对端 MAC。
      */
-    uint8_t mcu_payload[7];
-    uint8_t mac6[6] = {0};
-    (void)RSSI_Check_Get_Peer_Addr(conidx, mac6);
-
-    mcu_payload[0] = (uint8_t)flt_rssi;
-    memcpy(&mcu_payload[1], mac6, 6);
-
-    uint8_t ok = SocMcu_Frame_Send(SOC_MCU_SYNC_SOC_TO_MCU,
-                                   SOC_MCU_FEATURE_FF01,
-                                   (uint16_t)BLEFUNC_CMD_RSSI_NEAR_CONFIRM,
-                                   mcu_payload,
-                                   (uint16_t)sizeof(mcu_payload));
-    (void)ok;
+    RSSI_Report_OnSample(conidx, flt_rssi, RSSI_Check_Get_Distance(conidx));
 }
 
 void BleFunc_RSSI_DistanceChangeCb(uint8_t conidx,
@@ -231,10 +271,10 @@ void BleFunc_RSSI_DistanceChangeCb(uint8_t conidx,
      * - 这里仅在“距离状态变化”时触发；并且进�?NEAR 只下发一次，避免重复刷串口�?
      */
     if (new_distance == (uint8_t)RSSI_DIST_NEAR) {
-        if (s_rssi_near_latched[conidx]) {
+        if (BLEFUNC_NEAR_LATCHED(conidx)) {
             return;
         }
-        s_rssi_near_latched[conidx] = 1;
+        BLEFUNC_NEAR_LATCHED(conidx) = 1;
 
         /*
          * payload 约定（你指定）：
@@ -257,7 +297,7 @@ void BleFunc_RSSI_DistanceChangeCb(uint8_t conidx,
     }
 
     /* 离开 NEAR：清门禁，下一次进�?NEAR 允许再次触发 */
-    s_rssi_near_latched[conidx] = 0;
+    BLEFUNC_NEAR_LATCHED(conidx) = 0;
 }
 
 /* 补充缺失的辅助函数定�?*/
@@ -281,9 +321,9 @@ static uint16_t BleFunc_MakeReplyCmd_FD(uint16_t cmd) {
 #define BLEFUNC_MCU_PUSH_CMD 0x13FDu
 #endif
 
-/* 最大连接数：与工程里的 SP_MAX_CONN_NUM/Protocol.c 保持一�?*/
+/* 最大连接数：默认跟随 APP_MAX_CONN（conn_ctx.h） */
 #ifndef BLEFUNC_MAX_CONN
-#define BLEFUNC_MAX_CONN 3u
+#define BLEFUNC_MAX_CONN APP_MAX_CONN
 #endif
 
 /* --------------------------------------------------------------------------
@@ -439,363 +479,319 @@ static void BleFunc_StripTime6_ForMcu(const uint8_t** payload,
     *payload_len = (uint16_t)(*payload_len - 6u);
 }
 
+/*
+ * BLE 下行的 cmd（如 0x0FFE/0x12FE）不等于 MCU UART 的 id，MCU 侧命令号以
+ * usart_cmd.h 里的 CMD_* 为准。映射规则是命令表（protocol_fe.c/protocol_fd.c）
+ * 里的数据，这里只做 O(1) 查表 + 解释，新命令不会拉长这条路径。
+ */
 static uint16_t BleFunc_MapBleCmdToMcuId(uint16_t       ble_cmd,
                                          const uint8_t* payload,
                                          uint16_t       payload_len) {
-    /*
-     * 关键点：BLE 下行�?cmd(�?0x0FFE/0x12FE) 不等�?MCU UART �?id�?
-     * MCU 侧命令号�?usart_cmd.h 里的 CMD_* 为准�?
-     */
-    switch (ble_cmd) {
-    case 0x63FDu:
-        if (payload != NULL && payload_len >= 1u && payload_len < 7u) {
-            uint8_t control = payload[0];
-            if (payload_len >= 2u) {
-                uint8_t controlType = payload[1];
-                if (controlType == 0x04u) {
-                    return (control == 0x01u) ? (uint16_t)CMD_CHARGE_DISPLAY_ON
-                                              : (uint16_t)CMD_CHARGE_DISPLAY_OFF;
-                }
-                if (controlType == 0x0Au) {
-                    if (control == 0x01u)
-                        return (uint16_t)CMD_Three_shooting_lamp_on;
-                    if (control == 0x00u)
-                        return (uint16_t)CMD_Three_shooting_lamp_off;
-                    if (control == 0x02u)
-                        return (uint16_t)CMD_Three_shooting_lamp_default;
-                    return 0u;
-                }
-            }
-            if (control == 0x01u)
-                return (uint16_t)CMD_POWER_RECOVER_ON;
-            if (control == 0x00u)
-                return (uint16_t)CMD_POWER_RECOVER_OFF;
-            return 0u;
-        }
-        /*
-         * 6.9 智能开关设置：BLE payload = Time6 + control(1) +
-         * controlType(1) 优先识别 controlType，处理已知类型：
-         * - controlType==0x01 -> EBS开�?动力回收)
-         * - controlType==0x04 -> 充电显示器（CMD_CHARGE_DISPLAY_ON/OFF�?
-         * - controlType==0x0A -> 三色氛围灯（CMD_Three_shooting_lamp_*�?
-         * - controlType==0x02 ->
-         * 鞍座感应开关（CMD_Saddle_sensing_on/off/default�?
-         * - controlType==0x03 -> ABS（CMD_ABS_on/off/default�?
-         * - controlType==0x05 ->
-         * 位置灯（CMD_Position_light_on/off/default�?
-         * 其它未识别的类型则按“动力回收（Power Recover）”的开/关映射�?
-         */
-        if (payload_len >= 8u && payload != NULL) {
-            uint8_t control     = payload[6];
-            uint8_t controlType = payload[7];
-            if (controlType == 0x04u) {
-                return (control == 0x01u) ? (uint16_t)CMD_CHARGE_DISPLAY_ON
-                                          : (uint16_t)CMD_CHARGE_DISPLAY_OFF;
-            }
-            if (controlType == 0x0Au) {
-                if (control == 0x01u)
-                    return (uint16_t)CMD_Three_shooting_lamp_on;
-                if (control == 0x00u)
-                    return (uint16_t)CMD_Three_shooting_lamp_off;
-                if (control == 0x02u)
-                    return (uint16_t)CMD_Three_shooting_lamp_default;
-                return 0u;
-            }
-        }
-        /* 兜底：按 control 映射为动力回收开�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            uint8_t control = payload[6];
-            if (control == 0x01u)
-                return (uint16_t)CMD_POWER_RECOVER_ON;
-            if (control == 0x00u)
-                return (uint16_t)CMD_POWER_RECOVER_OFF;
-        }
-        return 0u;
-    case 0x09FDu: /* 6.13 车辆防盗告警设置：MCU 侧复用油车设防命�?0x31 */
-        (void)payload;
-        (void)payload_len;
-        return (uint16_t)CMD_OIL_VEHICLE_PREVENTION;
-    case 0x02FDu: /* 助力推车模式 */
-        if (payload_len >= 7u && payload != NULL) {
-            uint8_t control = payload[6];
-            if (control == 0x01u)
-                return (uint16_t)CMD_Assistive_trolley_mode_on;
-            if (control == 0x00u)
-                return (uint16_t)CMD_Assistive_trolley_mode_off;
-            if (control == 0x02u)
-                return (uint16_t)CMD_Assistive_trolley_mode_default;
-        }
-        return 0u;
-    case 0x03FEu: /* 5.3 设防/撤防 (复用油车设防指令) */
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x00u)
-                       ? (uint16_t)CMD_OIL_VEHICLE_UNPREVENTION
-                       : (uint16_t)CMD_OIL_VEHICLE_PREVENTION;
-        }
-        return 0u;
-    case 0x07FEu: /* 5.7 RSSI 范围设置 */
-        return (uint16_t)CMD_BLE_RSSI_RANGE_SET;
-    case 0x03FDu: /* 延时大灯 */
-        if (payload_len >= 7u && payload != NULL) {
-            uint8_t control = payload[6];
-            if (control == 0x01u)
-                return (uint16_t)CMD_Delayed_headlight_on;
-            if (control == 0x00u)
-                return (uint16_t)CMD_Delayed_headlight_off;
-            if (control == 0x02u)
-                return (uint16_t)CMD_Delayed_headlight_default;
-            if (control == 0x03u)
-                return (uint16_t)CMD_Delayed_headlight_time_set;
-        }
+    const protocol_cmd_desc_t* d = Protocol_Cmd_Find(ble_cmd);
+    if (d == NULL) {
         return 0u;
-    case 0x04FDu: /* 充电功率 */ return (uint16_t)CMD_Charging_power_set;
-    case 0x05FDu: /* 自动 P �?*/
-        if (payload_len >= 7u && payload != NULL) {
-            uint8_t control = payload[6];
-            if (control == 0x01u)
-                return (uint16_t)CMD_AUTO_P_GEAR_on;
-            if (control == 0x00u)
-                return (uint16_t)CMD_AUTO_P_GEAR_off;
-            if (control == 0x02u)
-                return (uint16_t)CMD_AUTO_P_GEAR_default;
-            if (control == 0x03u)
-                return (uint16_t)CMD_AUTO_P_GEAR_time_set;
-        }
-        return 0u;
-    case 0x06FDu:
-        /*
-         * 6.6 和弦喇叭：BLE payload=Time6+soundSource+volume�?
-         * MCU
-         * 协议：CMD_Chord_horn_type_set(0x59)/CMD_Chord_horn_volume_set(0x60)
-         * 均为 data 1B�? 因此�?BLE
-         * 命令不能在这里“单条映射”，必须�?BleFunc_FD_SetChordHornMode()
-         * 内拆分处理�?
-         */
-        (void)payload;
-        (void)payload_len;
-        return 0u;
-    case 0x07FDu: /* 三色氛围灯：模式设置 */
-        return (uint16_t)CMD_Three_shooting_lamp_mode_set;
-    case 0x08FDu: /* 辅助倒车�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            uint8_t control = payload[6];
-            if (control == 0x01u)
-                return (uint16_t)CMD_Assistive_reversing_gear_on;
-            if (control == 0x00u)
-                return (uint16_t)CMD_Assistive_reversing_gear_off;
-            if (control == 0x02u)
-                return (uint16_t)CMD_Assistive_reversing_gear_default;
-        }
-        return 0u;
-    case 0x0AFDu: /* 自动转向回位 */
-        if (payload_len >= 7u && payload != NULL) {
-            uint8_t control = payload[6];
-            if (control == 0x01u)
-                return (uint16_t)CMD_Automatic_steering_reset_on;
-            if (control == 0x00u)
-                return (uint16_t)CMD_Automatic_steering_reset_off;
-            if (control == 0x02u)
-                return (uint16_t)CMD_Automatic_steering_reset_default;
-        }
-        return 0u;
-    case 0x0BFEu: /* 添加 NFC 钥匙 */ return (uint16_t)CMD_ADD_NFC_KEY;
-    case 0x0CFEu: /* 删除 NFC 钥匙 */ return (uint16_t)CMD_DELETE_NFC_KEY;
-    case 0x0BFDu: /* EBS：开�?类型（data 段由 payload 透传�?*/
-        return (uint16_t)CMD_EBS_switch_on;
-    case 0x0CFDu: /* 低速档�?*/
-        if (payload_len >= 1u && payload != NULL) {
-            uint8_t control = payload[0];
-            if (control == 0x01u)
-                return (uint16_t)CMD_Low_speed_gear_on;
-            if (control == 0x00u)
-                return (uint16_t)CMD_Low_speed_gear_off;
-            if (control == 0x02u)
-                return (uint16_t)CMD_Low_speed_gear_default;
-        }
-        return 0u;
-    case 0x0DFDu: /* 中速档�?*/
-        if (payload_len >= 1u && payload != NULL) {
-            uint8_t control = payload[0];
-            if (control == 0x01u)
-                return (uint16_t)CMD_Medium_speed_gear_on;
-            if (control == 0x00u)
-                return (uint16_t)CMD_Medium_speed_gear_off;
-            if (control == 0x02u)
-                return (uint16_t)CMD_Medium_speed_gear_default;
-        }
-        return 0u;
-    case 0x0EFDu: /* 高速档�?*/
-        if (payload_len >= 1u && payload != NULL) {
-            uint8_t control = payload[0];
-            if (control == 0x01u)
-                return (uint16_t)CMD_High_speed_gear_on;
-            if (control == 0x00u)
-                return (uint16_t)CMD_High_speed_gear_off;
-            if (control == 0x02u)
-                return (uint16_t)CMD_High_speed_gear_default;
-        }
-        return 0u;
-    case 0x0FFDu: /* 丢失模式 */
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x01u) ? (uint16_t)CMD_Lost_mode_on
-                                         : (uint16_t)CMD_Lost_mode_off;
-        }
-        return 0u;
-    case 0x10FDu: /* TCS */
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x01u) ? (uint16_t)CMD_TCS_switch_on
-                                         : (uint16_t)CMD_TCS_switch_off;
-        }
-        return 0u;
-    case 0x11FDu: /* 侧支�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x01u) ? (uint16_t)CMD_Side_stand_switch_on
-                                         : (uint16_t)CMD_Side_stand_switch_off;
-        }
-        return 0u;
-    case 0x12FDu: /* 电池类型与容量（先按 type_set 下发，data 段由 payload
-                     透传�?*/
-        return (uint16_t)CMD_Battery_type_set;
-    case 0x14FDu: /* HDC 开�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x01u) ? (uint16_t)CMD_HDC_switch_on
-                                         : (uint16_t)CMD_HDC_switch_off;
-        }
-        return 0u;
-    case 0x15FDu: /* HHC 开�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x01u) ? (uint16_t)CMD_HHC_switch_on
-                                         : (uint16_t)CMD_HHC_switch_off;
-        }
-        return 0u;
-    case 0x0FFEu: /* 油车设防/解防 */
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x00u)
-                       ? (uint16_t)CMD_OIL_VEHICLE_UNPREVENTION
-                       : (uint16_t)CMD_OIL_VEHICLE_PREVENTION;
-        }
-        return 0u;
-    case 0x08FEu: /* 5.8 手机蓝牙寻车 */
-        /*
-         * MCU 命令号未单独定义“电车寻车”，目前沿用油车寻车状态查询命令�?
-         * payload(�?Time6) 原样透传�?MCU，由 MCU
-         * 侧决定如何触发鸣�?双闪等动作�?
-         */
-        return (uint16_t)CMD_OIL_VEHICLE_FIND_STATUS;
-    case 0x11FEu: /* 油车寻车声音/音量（沿�?MCU �?0x32，data 带音量） */
-        return (uint16_t)CMD_OIL_VEHICLE_FIND_STATUS;
-    case 0x12FEu: /* 尾箱�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x00u)
-                       ? (uint16_t)CMD_OIL_VEHICLE_UNLOCK_TRUNK
-                       : (uint16_t)CMD_OIL_VEHICLE_LOCK_TRUNK;
-        }
-        return 0u;
-    case 0x13FEu: /* NFC 开�?*/ return (uint16_t)CMD_NFC_SWITCH;
-    case 0x14FEu: /* 座桶�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x00u) ? (uint16_t)CMD_VEHICLE_UNLOCK_SEAT
-                                         : (uint16_t)CMD_VEHICLE_LOCK_SEAT;
-        }
-        return 0u;
-    case 0x15FEu: /* 静音设置 */ return (uint16_t)CMD_VEHICLE_MUTE_SETTING;
-    case 0x16FEu: /* 中箱�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x00u)
-                       ? (uint16_t)CMD_VEHICLE_UNLOCK_MIDDLE_BOX
-                       : (uint16_t)CMD_VEHICLE_LOCK_MIDDLE_BOX;
-        }
-        return 0u;
-    case 0x17FEu: /* 紧急模�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x01u)
-                       ? (uint16_t)CMD_VEHICLE_EMERGENCY_MODE_LOCK
-                       : (uint16_t)CMD_VEHICLE_EMERGENCY_MODE_UNLOCK;
-        }
-        return 0u;
-    case 0x18FEu: /* len==6 获取 MAC；len==7 单控开�?*/
-        if (payload_len == 6u) {
-            return (uint16_t)CMD_BLE_MAC_READ;
+    }
+    return Protocol_Cmd_MapMcuId(d->mcu, payload, payload_len);
+}
+
+/* ====== MCU Transaction: 槽位 / 发送队列 ====== */
+static void BleFunc_McuTxn_Timeout(void* parg);
+static void BleFunc_McuSeq_OnStepDone(uint8_t        seq,
+                                      uint8_t        step,
+                                      uint8_t        result_code,
+                                      const uint8_t* data,
+                                      uint16_t       data_len);
+
+static void BleFunc_McuTxn_Release(blefunc_mcu_txn_t* t) {
+    os_timer_stop(&t->timer);
+    if (t->state == BLEFUNC_MCU_TXN_SENT && s_mcu_txn_inflight > 0u) {
+        s_mcu_txn_inflight--;
+    }
+    t->state = BLEFUNC_MCU_TXN_FREE;
+}
+
+/*
+ * 槽位结束（回包 / 超时 / 发送失败）：先释放槽位，再把结果交给发起方。
+ * - 单步事务：有 MCU payload 就原样透传（ResultCode(1) + 可选数据），否则回
+ *   result_code；
+ * - 序列中的步骤：交给序列引擎决定继续、等待并行步骤还是中止。
+ * 先释放是因为序列可能马上在同一槽位上发下一步。
+ */
+static void BleFunc_McuTxn_Finish(blefunc_mcu_txn_t* t,
+                                  uint8_t            result_code,
+                                  const uint8_t*     data,
+                                  uint16_t           data_len) {
+    uint8_t  conidx    = t->conidx;
+    uint16_t reply_cmd = t->reply_cmd;
+    uint8_t  seq       = t->seq;
+    uint8_t  step      = t->seq_step;
+
+    BleFunc_McuTxn_Release(t);
+    if (seq != BLEFUNC_MCU_SEQ_NONE) {
+        BleFunc_McuSeq_OnStepDone(seq, step, result_code, data, data_len);
+        return;
+    }
+    if (data_len == 0u || data == NULL) {
+        BleFunc_SendResultToConidx(conidx, reply_cmd, result_code);
+        return;
+    }
+    (void)Protocol_Send_Unicast(conidx, reply_cmd, data, data_len);
+}
+
+static void BleFunc_McuTxq_Push(uint8_t slot) {
+    s_mcu_txq[(s_mcu_txq_head + s_mcu_txq_cnt) % BLEFUNC_MCU_TXN_SLOTS] = slot;
+    s_mcu_txq_cnt++;
+    if (s_mcu_txq_cnt > s_mcu_txn_stats.max_queued) {
+        s_mcu_txn_stats.max_queued = s_mcu_txq_cnt;
+    }
+}
+
+/* 超时的排队项从队列中摘掉（队列最多 BLEFUNC_MCU_TXN_SLOTS 项，线性搬移即可） */
+static void BleFunc_McuTxq_Remove(uint8_t slot) {
+    uint8_t kept = 0u;
+    for (uint8_t i = 0u; i < s_mcu_txq_cnt; i++) {
+        uint8_t v =
+            s_mcu_txq[(s_mcu_txq_head + i) % BLEFUNC_MCU_TXN_SLOTS];
+        if (v != slot) {
+            s_mcu_txq[(s_mcu_txq_head + kept) % BLEFUNC_MCU_TXN_SLOTS] = v;
+            kept++;
         }
-        if (payload_len == 7u) {
-            return (uint16_t)CMD_SINGLE_CONTROL_UNLOCK;
+    }
+    s_mcu_txq_cnt = kept;
+}
+
+/* 真正写串口：成功后进入 SENT，占一个发送窗口 */
+static bool BleFunc_McuTxn_Send(blefunc_mcu_txn_t* t,
+                                const uint8_t*     payload,
+                                uint16_t           payload_len) {
+    uint8_t ok = SocMcu_Frame_Send(
+        SOC_MCU_SYNC_SOC_TO_MCU, t->req_feature, t->id, payload, payload_len);
+    if (!ok) {
+        return false;
+    }
+    t->state  = BLEFUNC_MCU_TXN_SENT;
+    t->ticket = s_mcu_txn_ticket++;
+    s_mcu_txn_inflight++;
+    if (s_mcu_txn_inflight > s_mcu_txn_stats.max_inflight) {
+        s_mcu_txn_stats.max_inflight = s_mcu_txn_inflight;
+    }
+    return true;
+}
+
+/* 窗口有空位时按队列顺序发出；发送失败的项按失败结束 */
+static void BleFunc_McuTxn_Pump(void) {
+    while (s_mcu_txq_cnt > 0u && s_mcu_txn_inflight < BLEFUNC_MCU_TXN_WINDOW) {
+        uint8_t            slot = s_mcu_txq[s_mcu_txq_head];
+        blefunc_mcu_txn_t* t    = &s_mcu_txn[slot];
+        s_mcu_txq_head = (uint8_t)((s_mcu_txq_head + 1u) % BLEFUNC_MCU_TXN_SLOTS);
+        s_mcu_txq_cnt--;
+
+        if (!BleFunc_McuTxn_Send(t, t->payload, t->payload_len)) {
+            APP_LOGW("[MCU_TXN] uart send failed (queued) id=0x%04X ",
+                     (unsigned)t->id);
+            s_mcu_txn_stats.rejected_err++;
+            BleFunc_McuTxn_Finish(t, 0x01, NULL, 0u);
         }
-        return 0u;
-    case 0x1AFEu: /* 充电显示器开�?*/
-        if (payload_len >= 7u && payload != NULL) {
-            return (payload[6] == 0x01u) ? (uint16_t)CMD_CHARGE_DISPLAY_ON
-                                         : (uint16_t)CMD_CHARGE_DISPLAY_OFF;
+    }
+}
+
+/*
+ * 把槽位上的请求交给串口：窗口有空位且前面没人排队就直接发（不拷贝 payload），
+ * 否则拷进槽位排队。失败时槽位已按失败结束，返回 false。
+ */
+static bool BleFunc_McuTxn_Issue(blefunc_mcu_txn_t* t,
+                                 const uint8_t*     payload,
+                                 uint16_t           payload_len) {
+    if (s_mcu_txq_cnt == 0u && s_mcu_txn_inflight < BLEFUNC_MCU_TXN_WINDOW) {
+        if (!BleFunc_McuTxn_Send(t, payload, payload_len)) {
+            APP_LOGW("[MCU_TXN] uart send failed ");
+            s_mcu_txn_stats.rejected_err++;
+            BleFunc_McuTxn_Finish(t, 0x01, NULL, 0u);
+            return false;
         }
-        return 0u;
-    case 0x04FEu: { /* 蓝牙感应解锁开关 -> MCU BLE RSSI lock on/off */
-        uint8_t status = 0u;
-        if (payload != NULL) {
-            if (payload_len >= 7u) {
-                status = payload[6]; /* Time6 + status */
-            } else if (payload_len >= 1u) {
-                status = payload[payload_len - 1u]; /* fallback: last byte */
-            }
+        return true;
+    }
+
+    if (payload_len > BLEFUNC_MCU_TXN_PAYLOAD_MAX) {
+        APP_LOGW("[MCU_TXN] busy: payload %u too long to queue ",
+                 (unsigned)payload_len);
+        s_mcu_txn_stats.rejected_busy++;
+        BleFunc_McuTxn_Finish(t, 0x01, NULL, 0u);
+        return false;
+    }
+    if (payload_len > 0u && payload != NULL) {
+        memcpy(t->payload, payload, payload_len);
+    }
+    t->payload_len = payload_len;
+    t->state       = BLEFUNC_MCU_TXN_QUEUED;
+    BleFunc_McuTxq_Push((uint8_t)(t - s_mcu_txn));
+    return true;
+}
+
+/*
+ * BLE 指令 -> MCU id 映射 + 去 Time6（单步事务与序列步骤共用）
+ * @return false 表示映射失败（未定义的指令）
+ */
+static bool BleFunc_McuTxn_MapRequest(uint16_t        id,
+                                      const uint8_t** payload,
+                                      uint16_t*       payload_len,
+                                      uint16_t*       mcu_id) {
+    /* 通常 BLE 侧以 FE/FD 结尾的命令号不是 MCU 实际的指令号，需要翻译 */
+    *mcu_id = id;
+    if (((id & 0x00FFu) == 0x00FEu) || ((id & 0x00FFu) == 0x00FDu)) {
+        *mcu_id = BleFunc_MapBleCmdToMcuId(id, *payload, *payload_len);
+        if (*mcu_id == 0u) {
+            APP_LOGW("[MCU_TXN] unknown BLE cmd to MCU id map: 0x%04X ",
+                     (unsigned)id);
+            return false;
         }
-        return (status == 0x01u) ? (uint16_t)CMD_BLE_RSSI_LOCK_ON
-                                 : (uint16_t)CMD_BLE_RSSI_LOCK_OFF;
     }
-    default: return 0u;
+
+    /* 统一规则：发给 MCU 的 payload 不包含 Time6 */
+    uint16_t payload_len_before_strip = *payload_len;
+    BleFunc_StripTime6_ForMcu(payload, payload_len);
+    /*
+     * 联调辅助：0x63FD(智能开关) 下发给 MCU 后应只剩 2B：control + controlType。
+     * 例如关闭充电显示 -> control=0x00 controlType=0x04 => data 应为 00 04。
+     */
+    if (id == 0x63FDu) {
+        const uint8_t* p  = *payload;
+        uint16_t       n  = *payload_len;
+        uint8_t        b0 = (p != NULL && n > 0u) ? p[0] : 0u;
+        uint8_t        b1 = (p != NULL && n > 1u) ? p[1] : 0u;
+        APP_LOGI("[MCU_TXN] 0x63FD strip %u->%u data=%02X %02X%s ",
+                 (unsigned)payload_len_before_strip,
+                 (unsigned)n,
+                 (unsigned)b0,
+                 (unsigned)b1,
+                 (n == 2u) ? "" : " (warn:expect 2B)");
     }
+    return true;
 }
 
 static void BleFunc_McuTxn_Timeout(void* parg) {
-    (void)parg;
-    if (!s_mcu_pending.active) {
+    blefunc_mcu_txn_t* t = (blefunc_mcu_txn_t*)parg;
+    if (t == NULL || t->state == BLEFUNC_MCU_TXN_FREE) {
         return;
     }
 
-    co_printf("[MCU_TXN] timeout: conidx=%u req_feature=0x%04X "
-              "resp_feature=0x%04X id=0x%04X reply=0x%04X ",
-              (unsigned)s_mcu_pending.conidx,
-              (unsigned)s_mcu_pending.req_feature,
-              (unsigned)s_mcu_pending.resp_feature,
-              (unsigned)s_mcu_pending.id,
-              (unsigned)s_mcu_pending.reply_cmd);
+    APP_LOGW("[MCU_TXN] timeout: conidx=%u req_feature=0x%04X "
+             "resp_feature=0x%04X id=0x%04X reply=0x%04X queued=%u ",
+             (unsigned)t->conidx,
+             (unsigned)t->req_feature,
+             (unsigned)t->resp_feature,
+             (unsigned)t->id,
+             (unsigned)t->reply_cmd,
+             (unsigned)(t->state == BLEFUNC_MCU_TXN_QUEUED));
+
+    s_mcu_txn_stats.timeouts++;
+    if (t->state == BLEFUNC_MCU_TXN_QUEUED) {
+        BleFunc_McuTxq_Remove((uint8_t)(t - s_mcu_txn));
+    }
+    BleFunc_McuTxn_Finish(t, 0x01, NULL, 0u);
+    BleFunc_McuTxn_Pump();
+}
+
+/*
+ * 占槽并发出（或排队）一条 MCU 请求，启动该槽位自己的超时。
+ * @return false：映射失败 / 忙 / 发送失败。忙和映射失败时没有占槽，由调用方
+ *         决定怎么回 App；发送失败时槽位已经按失败结束。
+ */
+static bool BleFunc_McuTxn_Submit(uint8_t        conidx,
+                                  uint16_t       reply_cmd,
+                                  uint16_t       feature,
+                                  uint16_t       id,
+                                  const uint8_t* payload,
+                                  uint16_t       payload_len,
+                                  uint8_t        seq,
+                                  uint8_t        seq_step,
+                                  bool*          slot_used) {
+    uint16_t           mcu_id = 0u;
+    blefunc_mcu_txn_t* t      = NULL;
+
+    *slot_used = false;
+    s_mcu_txn_stats.submitted++;
+
+    /* 1. ID 映射 + 去 Time6 */
+    if (!BleFunc_McuTxn_MapRequest(id, &payload, &payload_len, &mcu_id)) {
+        s_mcu_txn_stats.rejected_err++;
+        return false;
+    }
+
+    /* 2. 占槽：(mcu_id, conidx) 已在途视为重复提交，按忙处理 */
+    for (uint8_t i = 0u; i < BLEFUNC_MCU_TXN_SLOTS; i++) {
+        blefunc_mcu_txn_t* s = &s_mcu_txn[i];
+        if (s->state == BLEFUNC_MCU_TXN_FREE) {
+            if (t == NULL) {
+                t = s;
+            }
+        } else if (s->conidx == conidx && s->id == mcu_id) {
+            t = NULL;
+            break;
+        }
+    }
+    if (t == NULL) {
+        APP_LOGW("[MCU_TXN] busy, reject new cmd conidx=%u id=0x%04X ",
+                 (unsigned)conidx,
+                 (unsigned)mcu_id);
+        s_mcu_txn_stats.rejected_busy++;
+        return false;
+    }
+
+    if (!t->timer_inited) {
+        os_timer_init(&t->timer, BleFunc_McuTxn_Timeout, t);
+        t->timer_inited = true;
+    }
 
-    BleFunc_SendResultToConidx(
-        s_mcu_pending.conidx, s_mcu_pending.reply_cmd, 0x01);
-    s_mcu_pending.active      = false;
-    s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_NONE;
-    s_mcu_pending.chain_step  = 0u;
-    s_mcu_pending.chain_u16_0 = 0u;
+    /*
+     * feature：发送请求时使用的通道（通常 FF01）
+     * resp_feature：匹配回包时使用的通道（通常 FF02）；同时兼容少量 MCU
+     * 固件会回原 feature 的情况。
+     */
+    t->conidx       = conidx;
+    t->reply_cmd    = reply_cmd;
+    t->req_feature  = feature;
+    t->resp_feature = BLEFUNC_MCU_FEATURE_RESP;
+    t->id           = mcu_id;
+    t->seq          = seq;
+    t->seq_step     = seq_step;
+
+    /* 3. 发送或排队；4. 启动该槽位的超时计时 */
+    *slot_used = true;
+    if (!BleFunc_McuTxn_Issue(t, payload, payload_len)) {
+        return false;
+    }
+    os_timer_start(&t->timer, BLEFUNC_MCU_TIMEOUT_MS, false);
+    return true;
 }
 
+#if (!ENABLE_NFC_ADD_SIMULATION)
 /**
- * @brief 开启一个与 MCU 的异步交互事�?(Transaction)
+ * @brief 开启一个与 MCU 的异步交互事务 (Transaction)
  *
  * @details
- * 这是一个核心的"中间�?函数，用来处理【蓝牙请�?-> 转发 MCU -> 等待 MCU 回复 ->
- * 回复蓝牙】的全流程�? 它的主要逻辑如下�?
- * 1. 【防重入检查】：如果当前已经有一个指令在等待 MCU
- * 回复（s_mcu_pending.active 且未超时），则拒绝新指令，直接回失败�?
- *    这是为了防止串口阻塞或逻辑混乱，保证一问一答的顺序性�?
- * 2. 【指令映射】：蓝牙协议中的 CMD ID (�?0x0BFE) 可能�?MCU 串口协议定义�?ID
- * (�?0x20) 不同�? 这里会自动调�?BleFunc_MapBleCmdToMcuId 进行翻译�?
- * 3. 【发送请求】：调用底层驱动 SocMcu_Frame_Send 将数据打包通过 UART 发送给
- * MCU�?
- * 4. 【挂起等待】：
- *    - 将当前事务的状态（连接索引、期待的回复CMD、ID等）保存�?s_mcu_pending
- * 全局结构体中�?
- *    - 启动一个超时定时器 (BLEFUNC_MCU_TIMEOUT_MS)�?
- *    - 函数立即返回（异步）�?
+ * 处理【蓝牙请求 -> 转发 MCU -> 等待 MCU 回复 -> 回复蓝牙】的全流程：
+ * 1. 【指令映射】：蓝牙协议中的 CMD ID (如 0x0BFE) 与 MCU 串口协议的 ID 不同，
+ *    这里调用 BleFunc_MapBleCmdToMcuId 翻译，并去掉 payload 里的 Time6。
+ * 2. 【占槽】：同一链路同一条 MCU 指令还在途，或槽位表已满，则回失败 (0x01)；
+ *    否则占一个空闲槽位。
+ * 3. 【发送】：发送窗口有空位且没有排队项就立即 SocMcu_Frame_Send，
+ *    否则按受理顺序排队（见 BleFunc_McuTxn_Pump）。
+ * 4. 【挂起等待】：启动该槽位自己的超时定时器 (BLEFUNC_MCU_TIMEOUT_MS)，
+ *    函数立即返回（异步）。
  *
- * 后续流程�?
- * - 成功路径：MCU 在超时前回复串口数据 -> 触发 BleFunc_OnMcuUartFrame -> 匹配
- * ID -> 取消定时�?-> 回复 APP 成功数据�?
- * - 超时路径：定时器到期 -> 触发 BleFunc_McuTxn_Timeout -> 清除事务状�?-> 回复
- * APP 失败 (0x01)�?
+ * 后续流程：
+ * - 成功路径：MCU 回包 -> BleFunc_OnMcuUartFrame 按 id 匹配最早发出的槽位 ->
+ *   停表 -> 回复 APP。
+ * - 超时路径：该槽位定时器到期 -> BleFunc_McuTxn_Timeout -> 释放槽位 ->
+ *   回复 APP 失败 (0x01)。
+ * 一条 BLE 指令需要拆成多条 MCU 指令时用 BleFunc_McuSeq_Start。
  *
- * @param conidx      发起请求的蓝牙连接句柄（用于知道是谁发起的，将来回包给谁�?
- * @param reply_cmd   将来回复�?APP 时使用的 BLE CMD
- * ID（例如收�?0x0BFE，它�?0x0B01�?
- * @param feature     通道号（通常�?SOC_MCU_FEATURE_FF01�?
- * @param id          BLE 指令原始 ID (�?0x0BFE，将在此函数内尝试被翻译�?MCU ID)
- * @param payload     透传的数据内�?
+ * @param conidx      发起请求的蓝牙连接句柄（将来回包给谁）
+ * @param reply_cmd   将来回复给 APP 时使用的 BLE CMD ID（例如收到 0x0BFE，回 0x0B01）
+ * @param feature     通道号（通常是 SOC_MCU_FEATURE_FF01）
+ * @param id          BLE 指令原始 ID (如 0x0BFE，将在此函数内尝试翻译为 MCU ID)
+ * @param payload     透传的数据内容
  * @param payload_len 数据长度
  */
 static void BleFunc_McuTxn_Start(uint8_t        conidx,
@@ -804,75 +800,366 @@ static void BleFunc_McuTxn_Start(uint8_t        conidx,
                                  uint16_t       id,
                                  const uint8_t* payload,
                                  uint16_t       payload_len) {
-    /* 1. 忙检测：确保上一个指令已经结束，避免串口并发冲突 */
-    if (s_mcu_pending.active) {
-        co_printf("[MCU_TXN] busy, reject new cmd ");
+    bool slot_used = false;
+    if (!BleFunc_McuTxn_Submit(conidx,
+                               reply_cmd,
+                               feature,
+                               id,
+                               payload,
+                               payload_len,
+                               BLEFUNC_MCU_SEQ_NONE,
+                               0u,
+                               &slot_used) &&
+        !slot_used) {
         BleFunc_SendResultToConidx(conidx, reply_cmd, 0x01);
-        return;
     }
+}
+#endif
+
+/* 在整张表里找回包对应的槽位：id/feature 匹配且最早发出 */
+static blefunc_mcu_txn_t* BleFunc_McuTxn_Match(uint16_t feature, uint16_t id) {
+    blefunc_mcu_txn_t* best = NULL;
+    for (uint8_t i = 0u; i < BLEFUNC_MCU_TXN_SLOTS; i++) {
+        blefunc_mcu_txn_t* s = &s_mcu_txn[i];
+        if (s->state != BLEFUNC_MCU_TXN_SENT || s->id != id) {
+            continue;
+        }
+        if (feature != s->resp_feature && feature != s->req_feature) {
+            continue;
+        }
+        if (best == NULL || (int32_t)(s->ticket - best->ticket) < 0) {
+            best = s;
+        }
+    }
+    return best;
+}
 
-    if (!s_mcu_pending.timer_inited) {
-        os_timer_init(&s_mcu_pending.timer, BleFunc_McuTxn_Timeout, NULL);
-        s_mcu_pending.timer_inited = true;
+void BleFunc_McuTxn_GetStats(BleFunc_McuTxnStats_t* out) {
+    if (out != NULL) {
+        *out = s_mcu_txn_stats;
     }
+}
 
-    /* 2. ID 映射：将 BLE 协议 ID (�?0x..FE) 转换�?MCU 串口协议 ID (usart_cmd.h
-     * 中的 define) */
-    uint16_t mcu_id = id;
-    /* 通常 BLE 侧以 FE/FD 结尾的命令号不是 MCU 实际的指令号，需要翻�?*/
-    if (((id & 0x00FFu) == 0x00FEu) || ((id & 0x00FFu) == 0x00FDu)) {
-        mcu_id = BleFunc_MapBleCmdToMcuId(id, payload, payload_len);
-        if (mcu_id == 0u) {
-            co_printf("[MCU_TXN] unknown BLE cmd to MCU id map: 0x%04X ",
-                      (unsigned)id);
-            /* 映射失败（未定义的指令），直接回失败 */
+/* ====== MCU Sequence: 一条 BLE 指令 -> 多条 MCU 指令 ======
+ *
+ * @why
+ * - 0x06FD(和弦喇叭)、低/中/高速档位、雷达开关+灵敏度，MCU 协议都要求拆成
+ *   多条 1B data 的指令。以前是 OnMcuUartFrame 里三段几乎一样的 chain_kind
+ *   状态机，每加一种组合就再抄一段。
+ * - 现在每种组合是一张只读步骤表（MCU id + payload 构造函数 + 是否可并行），
+ *   由同一个引擎执行：
+ *   1) 步骤默认串行：上一步 MCU 回 0x00 才发下一步；
+ *   2) 标记 BLEFUNC_MCU_STEP_PARALLEL 的步骤与前一步一起发出（各占一个事务
+ *      槽位，MCU 按序处理），整组都回包后再推进，省掉一个串口往返；
+ *   3) BLEFUNC_MCU_SEQ_ABORT_ON_FAIL：任一步失败就不再发后续步骤；不带该
+ *      标志则照常发完。有失败时，等已发出的步骤收尾后把第一个失败的 MCU
+ *      payload（无 payload 则 0x01）回给 App；
+ *   4) 全部成功：透传最后完成那一步的 MCU payload（无 payload 则 0x00）。
+ */
+#ifndef BLEFUNC_MCU_SEQ_SLOTS
+#define BLEFUNC_MCU_SEQ_SLOTS 3u
+#endif
+
+/* 0 时忽略 BLEFUNC_MCU_STEP_PARALLEL，全部串行（MCU 固件不支持流水时用） */
+#ifndef BLEFUNC_MCU_SEQ_PARALLEL_ENABLE
+#define BLEFUNC_MCU_SEQ_PARALLEL_ENABLE 1
+#endif
+
+#define BLEFUNC_MCU_STEP_DATA_MAX 8u /* 单步 data 长度上限（构造函数输出缓冲） */
+#define BLEFUNC_MCU_SEQ_REPLY_MAX 8u /* 缓存的失败回包长度上限 */
+
+#define BLEFUNC_MCU_STEP_PARALLEL (0x01u) /* 与前一步同时发出 */
+
+#define BLEFUNC_MCU_SEQ_ABORT_ON_FAIL (0x01u)
+
+/* 一次序列运行的参数：步骤的 MCU id / data 都从这里取 */
+typedef struct {
+    uint16_t id0;       /* 步骤表里 id 为 0 时使用（如雷达开关 on/off/default） */
+    uint8_t  u8[2];     /* 1B data 参数：音源/音量、档位 speed、雷达灵敏度 */
+    uint8_t  skip_mask; /* bit i=1 跳过第 i 步（可选步骤，如未带灵敏度） */
+} blefunc_mcu_seq_args_t;
+
+/* 构造某一步发给 MCU 的 data，返回长度（<= BLEFUNC_MCU_STEP_DATA_MAX） */
+typedef uint16_t (*blefunc_mcu_step_build_t)(const blefunc_mcu_seq_args_t* a,
+                                             uint8_t*                      out);
+
+typedef struct {
+    uint16_t                 id;    /* MCU 命令 ID；0 表示取 args.id0 */
+    blefunc_mcu_step_build_t build; /* NULL 表示无 data */
+    uint8_t                  flags; /* BLEFUNC_MCU_STEP_* */
+} blefunc_mcu_step_t;
+
+typedef struct {
+    const char*               name; /* 日志用（常量字符串） */
+    const blefunc_mcu_step_t* steps;
+    uint8_t                   step_cnt;
+    uint8_t                   policy; /* BLEFUNC_MCU_SEQ_* */
+} blefunc_mcu_seq_t;
+
+#if (!ENABLE_NFC_ADD_SIMULATION)
+static uint16_t BleFunc_McuStep_U8_0(const blefunc_mcu_seq_args_t* a,
+                                     uint8_t*                      out) {
+    out[0] = a->u8[0];
+    return 1u;
+}
+
+static uint16_t BleFunc_McuStep_U8_1(const blefunc_mcu_seq_args_t* a,
+                                     uint8_t*                      out) {
+    out[0] = a->u8[1];
+    return 1u;
+}
+
+/* 0x06FD 和弦喇叭：音源(u8[0]) + 音量(u8[1])，两个字段互不依赖，可一起发 */
+static const blefunc_mcu_step_t s_seq_chord_horn_steps[] = {
+    {(uint16_t)CMD_Chord_horn_type_set, BleFunc_McuStep_U8_0, 0u},
+    {(uint16_t)CMD_Chord_horn_volume_set,
+     BleFunc_McuStep_U8_1,
+     BLEFUNC_MCU_STEP_PARALLEL},
+};
+/* 档位：先 on，再 speed_set(u8[0])；speed_set 依赖档位已切换，必须串行 */
+static const blefunc_mcu_step_t s_seq_gear_low_steps[] = {
+    {(uint16_t)CMD_Low_speed_gear_on, NULL, 0u},
+    {(uint16_t)CMD_Low_speed_gear_speed_set, BleFunc_McuStep_U8_0, 0u},
+};
+static const blefunc_mcu_step_t s_seq_gear_mid_steps[] = {
+    {(uint16_t)CMD_Medium_speed_gear_on, NULL, 0u},
+    {(uint16_t)CMD_Medium_speed_gear_speed_set, BleFunc_McuStep_U8_0, 0u},
+};
+static const blefunc_mcu_step_t s_seq_gear_high_steps[] = {
+    {(uint16_t)CMD_High_speed_gear_on, NULL, 0u},
+    {(uint16_t)CMD_High_speed_gear_speed_set, BleFunc_McuStep_U8_0, 0u},
+};
+/* 雷达：开关(id0) + 可选灵敏度(u8[0])；关雷达后再设灵敏度无意义，保持串行 */
+static const blefunc_mcu_step_t s_seq_radar_steps[] = {
+    {0u, NULL, 0u},
+    {(uint16_t)CMD_Radar_sensitivity_set, BleFunc_McuStep_U8_0, 0u},
+};
+
+#define BLEFUNC_MCU_SEQ_DEF(name, steps)                                  \
+    {(name), (steps), (uint8_t)(sizeof(steps) / sizeof((steps)[0])), \
+     BLEFUNC_MCU_SEQ_ABORT_ON_FAIL}
+
+static const blefunc_mcu_seq_t s_seq_chord_horn =
+    BLEFUNC_MCU_SEQ_DEF("06FD", s_seq_chord_horn_steps);
+static const blefunc_mcu_seq_t s_seq_gear_low =
+    BLEFUNC_MCU_SEQ_DEF("GEAR_LOW", s_seq_gear_low_steps);
+static const blefunc_mcu_seq_t s_seq_gear_mid =
+    BLEFUNC_MCU_SEQ_DEF("GEAR_MID", s_seq_gear_mid_steps);
+static const blefunc_mcu_seq_t s_seq_gear_high =
+    BLEFUNC_MCU_SEQ_DEF("GEAR_HIGH", s_seq_gear_high_steps);
+static const blefunc_mcu_seq_t s_seq_radar =
+    BLEFUNC_MCU_SEQ_DEF("RADAR", s_seq_radar_steps);
+#endif
+
+typedef struct {
+    const blefunc_mcu_seq_t* def; /* NULL = 空闲 */
+    uint8_t                  conidx;
+    uint16_t                 reply_cmd;
+    uint16_t                 feature;
+    uint8_t                  next;    /* 下一个待发步骤 */
+    uint8_t                  pending; /* 已发出、未结束的步骤数 */
+    bool                     failed;  /* 已有步骤失败（记录第一个） */
+    blefunc_mcu_seq_args_t   args;
+    uint16_t                 fail_len; /* 第一个失败步骤的 MCU payload */
+    uint8_t                  fail_data[BLEFUNC_MCU_SEQ_REPLY_MAX];
+} blefunc_mcu_seq_run_t;
+
+static blefunc_mcu_seq_run_t s_mcu_seq[BLEFUNC_MCU_SEQ_SLOTS];
+
+/* 有步骤失败且策略为中止：不再发新步骤 */
+static bool BleFunc_McuSeq_Stopped(const blefunc_mcu_seq_run_t* r) {
+    return r->failed &&
+           (r->def->policy & BLEFUNC_MCU_SEQ_ABORT_ON_FAIL) != 0u;
+}
+
+static void BleFunc_McuSeq_SkipMasked(blefunc_mcu_seq_run_t* r) {
+    while (r->next < r->def->step_cnt &&
+           (r->args.skip_mask & (1u << r->next)) != 0u) {
+        r->next++;
+    }
+}
+
+static void BleFunc_McuSeq_Fail(blefunc_mcu_seq_run_t* r,
+                                const uint8_t*         data,
+                                uint16_t               data_len) {
+    if (r->failed) {
+        return;
+    }
+    r->failed   = true;
+    r->fail_len = 0u;
+    if (data != NULL && data_len > 0u) {
+        r->fail_len = (data_len > BLEFUNC_MCU_SEQ_REPLY_MAX)
+                          ? (uint16_t)BLEFUNC_MCU_SEQ_REPLY_MAX
+                          : data_len;
+        memcpy(r->fail_data, data, r->fail_len);
+    }
+}
+
+/* 所有已发步骤都结束后回 App 并释放序列 */
+static void BleFunc_McuSeq_Complete(blefunc_mcu_seq_run_t* r,
+                                    const uint8_t*         last_data,
+                                    uint16_t               last_len) {
+    uint8_t  conidx    = r->conidx;
+    uint16_t reply_cmd = r->reply_cmd;
+
+    APP_LOGI("[MCU_SEQ] %s done conidx=%u failed=%u ",
+             r->def->name,
+             (unsigned)conidx,
+             (unsigned)r->failed);
+    r->def = NULL;
+    if (r->failed) {
+        if (r->fail_len == 0u) {
             BleFunc_SendResultToConidx(conidx, reply_cmd, 0x01);
+        } else {
+            (void)Protocol_Send_Unicast(
+                conidx, reply_cmd, r->fail_data, r->fail_len);
+        }
+        return;
+    }
+    if (last_data == NULL || last_len == 0u) {
+        BleFunc_SendResultToConidx(conidx, reply_cmd, 0x00);
+        return;
+    }
+    (void)Protocol_Send_Unicast(conidx, reply_cmd, last_data, last_len);
+}
+
+/*
+ * 发出下一组步骤：当前步骤 + 紧随其后的 PARALLEL 步骤。
+ * 占不到槽位/发送失败的步骤按失败处理。
+ */
+static void BleFunc_McuSeq_Advance(blefunc_mcu_seq_run_t* r) {
+    uint8_t seq = (uint8_t)(r - s_mcu_seq);
+
+    for (;;) {
+        BleFunc_McuSeq_SkipMasked(r);
+        if (BleFunc_McuSeq_Stopped(r) || r->next >= r->def->step_cnt) {
+            break;
+        }
+        uint8_t                   idx  = r->next;
+        const blefunc_mcu_step_t* step = &r->def->steps[idx];
+
+        /* 前面还有步骤没回包，且本步不能并行：等这一组结束 */
+        if (r->pending > 0u &&
+            (!BLEFUNC_MCU_SEQ_PARALLEL_ENABLE ||
+             (step->flags & BLEFUNC_MCU_STEP_PARALLEL) == 0u)) {
+            break;
+        }
+
+        uint8_t  data[BLEFUNC_MCU_STEP_DATA_MAX];
+        uint16_t len = 0u;
+        uint16_t id  = (step->id != 0u) ? step->id : r->args.id0;
+        if (step->build != NULL) {
+            len = step->build(&r->args, data);
+        }
+        r->next++;
+        r->pending++;
+
+        bool slot_used = false;
+        if (!BleFunc_McuTxn_Submit(r->conidx,
+                                   r->reply_cmd,
+                                   r->feature,
+                                   id,
+                                   (len > 0u) ? data : NULL,
+                                   len,
+                                   seq,
+                                   idx,
+                                   &slot_used) &&
+            !slot_used) {
+            /* 没占到槽位：本步直接按失败结束（占到槽位的失败会经 Finish 回调） */
+            r->pending--;
+            BleFunc_McuSeq_Fail(r, NULL, 0u);
+        }
+        /* 串口立即发送失败时 Finish -> OnStepDone 会重入本函数，序列可能已在里面结束 */
+        if (r->def == NULL) {
             return;
         }
     }
 
-    /* 2.1 统一规则：发�?MCU �?payload 不包�?Time6 */
-    uint16_t payload_len_before_strip = payload_len;
-    BleFunc_StripTime6_ForMcu(&payload, &payload_len);
-    /*
-     * 联调辅助�?x63FD(智能开�? 下发�?MCU 后应只剩 2B：control + controlType�?
-     * 例如你举例：关闭充电显示�?-> control=0x00 controlType=0x04 => data 应为
-     * 00 04�?
-     */
-    if (id == 0x63FDu) {
-        uint8_t b0 = (payload != NULL && payload_len > 0u) ? payload[0] : 0u;
-        uint8_t b1 = (payload != NULL && payload_len > 1u) ? payload[1] : 0u;
-        co_printf("[MCU_TXN] 0x63FD strip %u->%u data=%02X %02X%s ",
-                  (unsigned)payload_len_before_strip,
-                  (unsigned)payload_len,
-                  (unsigned)b0,
-                  (unsigned)b1,
-                  (payload_len == 2u) ? "" : " (warn:expect 2B)");
+    if (r->def != NULL && r->pending == 0u &&
+        (BleFunc_McuSeq_Stopped(r) || r->next >= r->def->step_cnt)) {
+        BleFunc_McuSeq_Complete(r, NULL, 0u);
     }
+}
 
-    /* 3. 发送串口数据给 MCU */
-    uint8_t ok = SocMcu_Frame_Send(
-        SOC_MCU_SYNC_SOC_TO_MCU, feature, mcu_id, payload, payload_len);
-    if (!ok) {
-        co_printf("[MCU_TXN] uart send failed ");
+static void BleFunc_McuSeq_OnStepDone(uint8_t        seq,
+                                      uint8_t        step,
+                                      uint8_t        result_code,
+                                      const uint8_t* data,
+                                      uint16_t       data_len) {
+    if (seq >= BLEFUNC_MCU_SEQ_SLOTS || s_mcu_seq[seq].def == NULL) {
+        return;
+    }
+    blefunc_mcu_seq_run_t* r = &s_mcu_seq[seq];
+
+    /* MCU payload 第 1 字节是 ResultCode；没有 payload 时以 result_code 为准 */
+    uint8_t result = (data != NULL && data_len >= 1u) ? data[0] : result_code;
+    APP_LOGI("[MCU_SEQ] %s step%u result=0x%02X pending=%u ",
+             r->def->name,
+             (unsigned)step,
+             (unsigned)result,
+             (unsigned)r->pending);
+
+    if (r->pending > 0u) {
+        r->pending--;
+    }
+    if (result != 0x00u) {
+        BleFunc_McuSeq_Fail(r, data, data_len);
+    }
+
+    /* 最后一步成功完成：直接透传它的 payload，不经缓存 */
+    BleFunc_McuSeq_SkipMasked(r);
+    if (!r->failed && r->pending == 0u && r->next >= r->def->step_cnt) {
+        BleFunc_McuSeq_Complete(r, data, data_len);
+        return;
+    }
+    BleFunc_McuSeq_Advance(r);
+}
+
+#if (!ENABLE_NFC_ADD_SIMULATION)
+/**
+ * @brief 按步骤表执行一条多步 MCU 序列，全部结束后回 reply_cmd
+ * @note 同一链路同一序列还在执行时按忙处理（回 0x01）
+ */
+static void BleFunc_McuSeq_Start(uint8_t                       conidx,
+                                 uint16_t                      reply_cmd,
+                                 uint16_t                      feature,
+                                 const blefunc_mcu_seq_t*      def,
+                                 const blefunc_mcu_seq_args_t* args) {
+    blefunc_mcu_seq_run_t* r = NULL;
+
+    s_mcu_txn_stats.submitted++;
+    for (uint8_t i = 0u; i < BLEFUNC_MCU_SEQ_SLOTS; i++) {
+        if (s_mcu_seq[i].def == NULL) {
+            if (r == NULL) {
+                r = &s_mcu_seq[i];
+            }
+        } else if (s_mcu_seq[i].def == def && s_mcu_seq[i].conidx == conidx) {
+            r = NULL;
+            break;
+        }
+    }
+    if (r == NULL) {
+        APP_LOGW("[MCU_SEQ] busy, reject %s conidx=%u ",
+                 def->name,
+                 (unsigned)conidx);
+        s_mcu_txn_stats.rejected_busy++;
         BleFunc_SendResultToConidx(conidx, reply_cmd, 0x01);
         return;
     }
 
-    /* 4. 记录事务上下文并启动超时计时�?*/
-    s_mcu_pending.active    = true;
-    s_mcu_pending.conidx    = conidx;
-    s_mcu_pending.reply_cmd = reply_cmd;
-    /*
-     * feature：发送请求时使用的通道（通常 FF01�?
-     * resp_feature：匹配回包时使用的通道（通常 FF02）；同时兼容少量 MCU
-     * 固件会回�?feature 的情况�?
-     */
-    s_mcu_pending.req_feature  = feature;
-    s_mcu_pending.resp_feature = BLEFUNC_MCU_FEATURE_RESP;
-    s_mcu_pending.id = mcu_id; /* 注意：这里记录的是发�?MCU �?ID，用于匹配回�?*/
-    os_timer_start(&s_mcu_pending.timer, BLEFUNC_MCU_TIMEOUT_MS, false);
+    memset(r, 0, sizeof(*r));
+    r->def       = def;
+    r->conidx    = conidx;
+    r->reply_cmd = reply_cmd;
+    r->feature   = feature;
+    r->args      = *args;
+    APP_LOGI("[MCU_SEQ] %s start conidx=%u steps=%u ",
+             def->name,
+             (unsigned)conidx,
+             (unsigned)def->step_cnt);
+    BleFunc_McuSeq_Advance(r);
 }
+#endif
 
 /**
  * @brief [DEBUG-SIM 专用] 仅通过串口下发�?MCU，不挂起等待、不影响当前 BLE
@@ -891,8 +1178,8 @@ static void BleFunc_McuUart_SendOnly(uint16_t       feature,
     if (((ble_cmd & 0x00FFu) == 0x00FEu) || ((ble_cmd & 0x00FFu) == 0x00FDu)) {
         mcu_id = BleFunc_MapBleCmdToMcuId(ble_cmd, payload, payload_len);
         if (mcu_id == 0u) {
-            co_printf("[DEBUG_SIM] uart skip: map ble_cmd=0x%04X failed ",
-                      (unsigned)ble_cmd);
+            APP_LOGW("[DEBUG_SIM] uart skip: map ble_cmd=0x%04X failed ",
+                     (unsigned)ble_cmd);
             return;
         }
     }
@@ -903,20 +1190,20 @@ static void BleFunc_McuUart_SendOnly(uint16_t       feature,
     if (ble_cmd == 0x63FDu) {
         uint8_t b0 = (payload != NULL && payload_len > 0u) ? payload[0] : 0u;
         uint8_t b1 = (payload != NULL && payload_len > 1u) ? payload[1] : 0u;
-        co_printf("[DEBUG_SIM] 0x63FD strip %u->%u data=%02X %02X%s ",
-                  (unsigned)payload_len_before_strip,
-                  (unsigned)payload_len,
-                  (unsigned)b0,
-                  (unsigned)b1,
-                  (payload_len == 2u) ? "" : " (warn:expect 2B)");
+        APP_LOGI("[DEBUG_SIM] 0x63FD strip %u->%u data=%02X %02X%s ",
+                 (unsigned)payload_len_before_strip,
+                 (unsigned)payload_len,
+                 (unsigned)b0,
+                 (unsigned)b1,
+                 (payload_len == 2u) ? "" : " (warn:expect 2B)");
     }
 
     uint8_t ok = SocMcu_Frame_Send(
         SOC_MCU_SYNC_SOC_TO_MCU, feature, mcu_id, payload, payload_len);
-    co_printf("[DEBUG_SIM] uart send: ble_cmd=0x%04X -> mcu_id=0x%04X ok=%u ",
-              (unsigned)ble_cmd,
-              (unsigned)mcu_id,
-              (unsigned)ok);
+    APP_LOGI("[DEBUG_SIM] uart send: ble_cmd=0x%04X -> mcu_id=0x%04X ok=%u ",
+             (unsigned)ble_cmd,
+             (unsigned)mcu_id,
+             (unsigned)ok);
 }
 
 /* 6.11 vehicle status sync (0x66FD) */
@@ -984,10 +1271,11 @@ static void BleFunc_ParamSync_Request64FDFromMcu(void) {
 static bool BleFunc_PrintTime6(const uint8_t* time6) {
     char time_str[13];
     if (proto_time6_bcd_to_str12(time6, time_str)) {
-        co_printf("    time_bcd=%s ", time_str);
+        /* BCD 按 HEX 输出与字符串形式逐位一致，且不需要运行期拼串 */
+        APP_LOGI_HEX("    time_bcd:", time6, 6u);
         return true;
     }
-    co_printf("    time_bcd=<invalid bcd> ");
+    APP_LOGW("    time_bcd=<invalid bcd> ");
     return false;
 }
 
@@ -1123,21 +1411,14 @@ static void BleFunc_LogMcuUartFrame(uint16_t       feature,
                                     uint16_t       id,
                                     const uint8_t* data,
                                     uint16_t       data_len) {
+    /* name 指向常量表，二进制日志里按地址由解码器还原 */
     const char* name = BleFunc_McuCmdName(id);
-    co_printf("[MCU_UART] feature=0x%04X id=0x%04X (%s) len=%u ",
-              (unsigned)feature,
-              (unsigned)id,
-              name,
-              (unsigned)data_len);
-    if (data == NULL || data_len == 0u) {
-        co_printf("    data: <empty> ");
-        return;
-    }
-    co_printf("    data:");
-    for (uint16_t i = 0; i < data_len; i++) {
-        co_printf(" %02X", data[i]);
-    }
-    co_printf(" ");
+    APP_LOGI("[MCU_UART] feature=0x%04X id=0x%04X (%s) len=%u ",
+             (unsigned)feature,
+             (unsigned)id,
+             name,
+             (unsigned)data_len);
+    APP_LOGD_HEX("    data:", data, data_len);
 }
 /*********************************************************************
  * @brief 进行回复给蓝牙app
@@ -1181,7 +1462,7 @@ static bool BleFunc_EnsureAuthed(uint16_t reply_cmd) {
     if (Protocol_Auth_IsOk(conidx)) {
         return true;
     }
-    co_printf("    auth not ok, reject cmd ");
+    APP_LOGW("    auth not ok, reject cmd ");
     BleFunc_SendResultToRx_Default(reply_cmd);
     return false;
 }
@@ -1191,15 +1472,7 @@ static bool BleFunc_EnsureAuthed(uint16_t reply_cmd) {
  * @param len {placeholder}
  */
 static void BleFunc_DumpPayload(const uint8_t* payload, uint8_t len) {
-    if (payload == NULL || len == 0) {
-        co_printf("    payload: <empty> ");
-        return;
-    }
-    co_printf("    payload(%d): ", (int)len);
-    for (uint8_t i = 0; i < len; i++) {
-        co_printf(" %02X ", payload[i]);
-    }
-    co_printf(" ");
+    APP_LOGD_HEX("    payload:", payload, len);
 }
 
 /* ====== 5.1 Connect(0x01FE) 辅助函数 ======
@@ -1217,15 +1490,64 @@ static bool BleFunc_IsHexAscii(uint8_t c) {
     return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F');
 }
 
-static void BleFunc_DumpHexInline(const uint8_t* data, uint16_t dump_len) {
-    if (data == NULL || dump_len == 0) {
-        co_printf("<empty> ");
-        return;
+/*
+ * 0x01FE 期望 Token 缓存
+ *
+ * @why
+ * - 以前每次 0x01FE 都重新 Algo_MD5_Calc(TBOX_KEY) + 转 HEX，再在栈上拼三份
+ *   33 字节字符串、逐字节转大写后 memcmp；KEY 不变，这些全是重复劳动，
+ *   却正好压在“靠近车辆 -> 连上 -> 解锁”这条骑手最在意的时延上。
+ * - 现在开机（或 KEY 从 Flash 下发后）算一次，连接时只做两段定长比较。
+ * - 比较是常数时间（不在第一个不同字节处提前返回），避免按应答时间逐字节猜 Token。
+ *
+ * raw：MD5(T-BOX KEY)，对应 16 字节原始 Token；
+ * hex：32 字节大写 HEX，默认为 raw 的 HEX，配置了 TBOX_TOKEN_MD5_ASCII 时以它为准
+ *      （与改造前的覆盖语义一致）。
+ */
+static struct {
+    bool    ready;
+    uint8_t raw[16];
+    uint8_t hex[32];
+} s_auth_token;
+
+void BleFunc_Auth_SetKey(const uint8_t* key, uint16_t key_len) {
+    static const char hex_map[] = "0123456789ABCDEF";
+
+    if (key == NULL || key_len == 0u) {
+        key     = TBOX_KEY;
+        key_len = (uint16_t)sizeof(TBOX_KEY);
     }
-    for (uint16_t i = 0; i < dump_len; i++) {
-        co_printf("%02X ", data[i]);
+    Algo_MD5_Calc(key, key_len, s_auth_token.raw);
+
+    if (sizeof(TBOX_TOKEN_MD5_ASCII) > 32u) {
+        for (uint8_t i = 0; i < 32u; i++) {
+            s_auth_token.hex[i] = BleFunc_ToUpper((uint8_t)TBOX_TOKEN_MD5_ASCII[i]);
+        }
+    } else {
+        for (uint8_t i = 0; i < 16u; i++) {
+            s_auth_token.hex[i * 2u]      = (uint8_t)hex_map[s_auth_token.raw[i] >> 4];
+            s_auth_token.hex[i * 2u + 1u] = (uint8_t)hex_map[s_auth_token.raw[i] & 0x0Fu];
+        }
     }
+    s_auth_token.ready = true;
+}
+
+#if !BLEFUNC_DEV_ACCEPT_ANY_TOKEN
+/* 常数时间比较；fold_case 时 rx 里的小写字母按大写比较（expect 已是大写） */
+static bool BleFunc_TokenEqual(const uint8_t* rx,
+                               const uint8_t* expect,
+                               uint8_t        n,
+                               bool           fold_case) {
+    uint8_t diff = 0u;
+    uint8_t fold = fold_case ? 0x20u : 0x00u;
+    for (uint8_t i = 0; i < n; i++) {
+        uint8_t c     = rx[i];
+        uint8_t lower = (uint8_t)((uint8_t)(c - 'a') <= (uint8_t)('z' - 'a'));
+        diff |= (uint8_t)((c ^ (uint8_t)(lower * fold)) ^ expect[i]);
+    }
+    return diff == 0u;
 }
+#endif
 
 static bool BleFunc_IsAllZero(const uint8_t* data, uint16_t len) {
     if (data == NULL || len == 0u) {
@@ -1239,6 +1561,24 @@ static bool BleFunc_IsAllZero(const uint8_t* data, uint16_t len) {
     return true;
 }
 
+/* 回包命中在途槽位：停表、让出发送窗口，再交给发起方（单步回 App / 序列推进） */
+static void BleFunc_McuTxn_OnReply(blefunc_mcu_txn_t* t,
+                                   uint16_t           feature,
+                                   uint16_t           id,
+                                   const uint8_t*     data,
+                                   uint16_t           data_len) {
+    s_mcu_txn_stats.matched++;
+    APP_LOGI("[MCU_TXN] matched: conidx=%u feature=0x%04X id=0x%04X "
+             "reply=0x%04X data_len=%u seq=%u ",
+             (unsigned)t->conidx,
+             (unsigned)feature,
+             (unsigned)id,
+             (unsigned)t->reply_cmd,
+             (unsigned)data_len,
+             (unsigned)t->seq);
+    BleFunc_McuTxn_Finish(t, 0x00, data, data_len);
+}
+
 void BleFunc_OnMcuUartFrame(uint16_t       sync,
                             uint16_t       feature,
                             uint16_t       id,
@@ -1246,164 +1586,21 @@ void BleFunc_OnMcuUartFrame(uint16_t       sync,
                             uint16_t       data_len,
                             uint8_t        crc_ok) {
     if (!crc_ok) {
-        co_printf("[MCU_TXN] drop frame: crc bad ");
+        APP_LOGW("[MCU_TXN] drop frame: crc bad ");
         return;
     }
     if (sync != SOC_MCU_SYNC_MCU_TO_SOC) {
         return;
     }
 
-    /* 1) 如果是正在等待的 MCU 应答，则按事务回包到 APP（reply_cmd�?*/
-    if (s_mcu_pending.active && id == s_mcu_pending.id &&
-        (feature == s_mcu_pending.resp_feature ||
-         feature == s_mcu_pending.req_feature)) {
-        /* 先停表，后续如果需要链式继续，会重新启�?*/
-        os_timer_stop(&s_mcu_pending.timer);
-        s_mcu_pending.active = false;
-
-        co_printf("[MCU_TXN] matched: conidx=%u feature=0x%04X id=0x%04X "
-                  "reply=0x%04X data_len=%u ",
-                  (unsigned)s_mcu_pending.conidx,
-                  (unsigned)feature,
-                  (unsigned)id,
-                  (unsigned)s_mcu_pending.reply_cmd,
-                  (unsigned)data_len);
-
-        /* ===== 链式事务�?x06FD 和弦喇叭（先音源0x59后音�?x60，均�?data
-         * 1B�?===== */
-        if (s_mcu_pending.chain_kind == BLEFUNC_MCU_CHAIN_CHORD_HORN_06FD &&
-            s_mcu_pending.chain_step == 0u) {
-            uint8_t result = 0x00u;
-            if (data != NULL && data_len >= 1u) {
-                result = data[0];
-            }
-            /* �?1 步失败：直接回复 APP（保持和现有事务一致，优先透传 MCU
-             * payload�?*/
-            if (result != 0x00u) {
-                s_mcu_pending.chain_kind = BLEFUNC_MCU_CHAIN_NONE;
-                s_mcu_pending.chain_step = 0u;
-                if (data_len == 0u || data == NULL) {
-                    BleFunc_SendResultToConidx(
-                        s_mcu_pending.conidx, s_mcu_pending.reply_cmd, 0x01);
-                    return;
-                }
-                (void)Protocol_Send_Unicast(s_mcu_pending.conidx,
-                                            s_mcu_pending.reply_cmd,
-                                            data,
-                                            data_len);
-                return;
-            }
-
-            /* �?1 步成功：触发�?2 步（音量），等待其回包后再回�?BLE */
-            uint8_t volume           = s_mcu_pending.chain_u8_0;
-            s_mcu_pending.chain_step = 1u;
-            co_printf("[MCU_TXN] chain(06FD) step1 ok, send step2 volume=%u ",
-                      (unsigned)volume);
-            BleFunc_McuTxn_Start(s_mcu_pending.conidx,
-                                 s_mcu_pending.reply_cmd,
-                                 s_mcu_pending.req_feature,
-                                 (uint16_t)CMD_Chord_horn_volume_set,
-                                 &volume,
-                                 1u);
-            return;
-        }
-
-        /* ===== 链式事务：低/�?高速档位（�?on，再 speed_set；speed_set
-         * data=1B�?===== */
-        if (s_mcu_pending.chain_kind == BLEFUNC_MCU_CHAIN_GEAR_SET_FD &&
-            s_mcu_pending.chain_step == 0u) {
-            uint8_t result = 0x00u;
-            if (data != NULL && data_len >= 1u) {
-                result = data[0];
-            }
-            /* �?1 步失败：直接回复 APP（优先透传 MCU payload�?*/
-            if (result != 0x00u) {
-                s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_NONE;
-                s_mcu_pending.chain_step  = 0u;
-                s_mcu_pending.chain_u16_0 = 0u;
-                if (data_len == 0u || data == NULL) {
-                    BleFunc_SendResultToConidx(
-                        s_mcu_pending.conidx, s_mcu_pending.reply_cmd, 0x01);
-                    return;
-                }
-                (void)Protocol_Send_Unicast(s_mcu_pending.conidx,
-                                            s_mcu_pending.reply_cmd,
-                                            data,
-                                            data_len);
-                return;
-            }
-
-            /* �?1 步成功：触发�?2 步（speed_set），等待其回包后再回�?BLE */
-            uint8_t  speed           = s_mcu_pending.chain_u8_0;
-            uint16_t step2_id        = s_mcu_pending.chain_u16_0;
-            s_mcu_pending.chain_step = 1u;
-            co_printf("[MCU_TXN] chain(GEAR) step1 ok, send step2 id=0x%04X "
-                      "speed=%u ",
-                      (unsigned)step2_id,
-                      (unsigned)speed);
-            BleFunc_McuTxn_Start(s_mcu_pending.conidx,
-                                 s_mcu_pending.reply_cmd,
-                                 s_mcu_pending.req_feature,
-                                 step2_id,
-                                 &speed,
-                                 1u);
-            return;
-        }
-
-        /* =====
-         * 链式事务：雷达开�?灵敏度（先开关，�?sensitivity_set；data=1B�?=====
-         */
-        if (s_mcu_pending.chain_kind == BLEFUNC_MCU_CHAIN_RADAR_SET_FD &&
-            s_mcu_pending.chain_step == 0u) {
-            uint8_t result = 0x00u;
-            if (data != NULL && data_len >= 1u) {
-                result = data[0];
-            }
-            if (result != 0x00u) {
-                s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_NONE;
-                s_mcu_pending.chain_step  = 0u;
-                s_mcu_pending.chain_u16_0 = 0u;
-                if (data_len == 0u || data == NULL) {
-                    BleFunc_SendResultToConidx(
-                        s_mcu_pending.conidx, s_mcu_pending.reply_cmd, 0x01);
-                    return;
-                }
-                (void)Protocol_Send_Unicast(s_mcu_pending.conidx,
-                                            s_mcu_pending.reply_cmd,
-                                            data,
-                                            data_len);
-                return;
-            }
-
-            uint8_t  sensitivity     = s_mcu_pending.chain_u8_0;
-            uint16_t step2_id        = s_mcu_pending.chain_u16_0;
-            s_mcu_pending.chain_step = 1u;
-            co_printf("[MCU_TXN] chain(RADAR) step1 ok, send step2 id=0x%04X "
-                      "sensitivity=%u ",
-                      (unsigned)step2_id,
-                      (unsigned)sensitivity);
-            BleFunc_McuTxn_Start(s_mcu_pending.conidx,
-                                 s_mcu_pending.reply_cmd,
-                                 s_mcu_pending.req_feature,
-                                 step2_id,
-                                 &sensitivity,
-                                 1u);
-            return;
-        }
-
-        /* 非链式，或链式最后一步：回包�?APP 并清理链式状�?*/
-        s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_NONE;
-        s_mcu_pending.chain_step  = 0u;
-        s_mcu_pending.chain_u16_0 = 0u;
-        if (data_len == 0u || data == NULL) {
-            BleFunc_SendResultToConidx(
-                s_mcu_pending.conidx, s_mcu_pending.reply_cmd, 0x00);
+    /* 1) 如果是在途的 MCU 应答，则按事务回包到 APP（reply_cmd） */
+    {
+        blefunc_mcu_txn_t* t = BleFunc_McuTxn_Match(feature, id);
+        if (t != NULL) {
+            BleFunc_McuTxn_OnReply(t, feature, id, data, data_len);
+            BleFunc_McuTxn_Pump();
             return;
         }
-        /* 约定：MCU payload = ResultCode(1) + 可选数据；BLE 侧原样透传 */
-        (void)Protocol_Send_Unicast(
-            s_mcu_pending.conidx, s_mcu_pending.reply_cmd, data, data_len);
-        return;
     }
 
     /* 2) 非事务类回包：认为是 MCU 主动上报，转发到已鉴�?APP（Notify�?*/
@@ -1446,9 +1643,9 @@ void BleFunc_OnMcuUartFrame(uint16_t       sync,
         id == (uint16_t)CMD_Tire_pressure_monitoring_get &&
         data_len == (uint16_t)sizeof(s_tpms_sim_payload_0117) &&
         BleFunc_IsAllZero(data, data_len)) {
-        co_printf("[TPMS_SIM] replace all-zero payload: id=0x%04X len=%u ",
-                  (unsigned)id,
-                  (unsigned)data_len);
+        APP_LOGI("[TPMS_SIM] replace all-zero payload: id=0x%04X len=%u ",
+                 (unsigned)id,
+                 (unsigned)data_len);
         BleFunc_PushMcuFrameToAuthedApp(
             feature,
             id,
@@ -1468,7 +1665,7 @@ void BleFunc_OnMcuUartFrame(uint16_t       sync,
  */
 void BleFunc_FE_Connect(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     (void)cmd;
-    co_printf("  -> Connect ");
+    APP_LOGI("  -> Connect ");
 
     /*
      * 文档定义：Time(6) + Token(32=MD5(T-BOXKEY)的HEX字符�? + mobileSystem(1)
@@ -1480,7 +1677,7 @@ void BleFunc_FE_Connect(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     // 兼容性修改：如果长度 > 39，可能是因为 AES 加密填充（Padding），只取�?39
     // 字节
     if (payload == NULL || len < 39) {
-        co_printf("    invalid payload len=%d (expect >= 39) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 39) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         // 校验失败，断开
         Protocol_Disconnect(Protocol_Get_Rx_Conidx());
@@ -1511,65 +1708,35 @@ void BleFunc_FE_Connect(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     }
 
     /* mobileSystem: 1=android, 2=ios, 3=other（按文档�?*/
-    co_printf("    mobileSystem=0x%02X ", mobileSystem);
+    APP_LOGI("    mobileSystem=0x%02X ", mobileSystem);
     if (!(mobileSystem == 1 || mobileSystem == 2 || mobileSystem == 3)) {
-        co_printf("    mobileSystem invalid (expect 1/2/3) ");
+        APP_LOGW("    mobileSystem invalid (expect 1/2/3) ");
     }
 
     /* Token 打印：若�?ASCII HEX，则按字符串更直观；否则�?HEX 输出 */
     if (token_len == 32 && token32_is_ascii_hex) {
-        char rx_token_str[33];
-        memcpy(rx_token_str, token_ptr, 32);
-        rx_token_str[32] = '\0';
-        co_printf("    Rx Token(32 str): %s ", rx_token_str);
+        APP_LOGD_HEX("    Rx Token(32 ascii):", token_ptr, 32u);
     } else {
-        co_printf("    Rx Token(%d hex):  ", token_len);
-        BleFunc_DumpHexInline(token_ptr, token_len);
-        co_printf(" ");
+        APP_LOGD("    Rx Token(%u hex): ", (unsigned)token_len);
+        APP_LOGD_HEX("   ", token_ptr, token_len);
     }
 
     char time_str[13];
     if (proto_time6_bcd_to_str12(time6, time_str)) {
-        co_printf("    time_bcd=%s ", time_str);
+        APP_LOGI_HEX("    time_bcd:", time6, 6u);
     } else {
-        co_printf("    time_bcd=invalid ");
+        APP_LOGW("    time_bcd=invalid ");
         /* [Debug] 解析失败时，打印�?16 个字节，检查解密后的数�?*/
-        co_printf("    Decrypted Hex(16):  ");
-        for (int i = 0; i < 16 && i < len; i++)
-            co_printf("%02X  ", payload[i]);
-        co_printf(" ");
-    }
-
-    /* --- MD5 Token Verification --- */
-    uint8_t target_digest[16];
-    Algo_MD5_Calc(TBOX_KEY, sizeof(TBOX_KEY), target_digest);
-
-    // Convert Digest to Hex String (upper case)
-    char       calculated_token[33];
-    const char hex_map[] = "0123456789ABCDEF";
-    for (int i = 0; i < 16; i++) {
-        calculated_token[i * 2]     = hex_map[(target_digest[i] >> 4) & 0x0F];
-        calculated_token[i * 2 + 1] = hex_map[target_digest[i] & 0x0F];
-    }
-    calculated_token[32] = '\0'; // Null terminator
-
-    /* 默认期望 Token：用设备�?TBOX_KEY 计算出来�?MD5 HEX */
-    char expected_token_up[33];
-    memcpy(expected_token_up, calculated_token, 33);
-
-    /* 如果配置了覆盖宏，则以覆盖值为准（忽略大小写） */
-    if (sizeof(TBOX_TOKEN_MD5_ASCII) > 1u) {
-        for (uint8_t i = 0; i < 32; i++) {
-            expected_token_up[i] =
-                (char)BleFunc_ToUpper((uint8_t)TBOX_TOKEN_MD5_ASCII[i]);
-        }
-        expected_token_up[32] = '\0';
-        co_printf("    Local Expected Token(override): %s ", expected_token_up);
-    } else {
-        co_printf("    Local Calc Token: %s ", expected_token_up);
+        APP_LOGW_HEX("    Decrypted Hex(16):", payload, (len < 16) ? len : 16);
+    }
+
+    /* --- MD5 Token Verification（期望值开机已缓存，这里只做常数时间比较） --- */
+    if (!s_auth_token.ready) {
+        BleFunc_Auth_SetKey(NULL, 0u);
     }
+    APP_LOGD_HEX("    Local Expected Token(ascii):", s_auth_token.hex, 32u);
 
-    /* Compare received token with calculated token (兼容两种格式) */
+    /* Compare received token with expected token (兼容两种格式) */
     bool auth_ok = false;
 #if BLEFUNC_DEV_ACCEPT_ANY_TOKEN
     /* 开发阶段：只要 0x01FE 解析成功，就认为鉴权通过（不比较 Token，不断连�?*/
@@ -1577,22 +1744,15 @@ void BleFunc_FE_Connect(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 #else
     if (token_len == 32) {
         /* 32 字节 ASCII HEX：忽略大小写 */
-        uint8_t rx_up[32];
-        for (uint8_t i = 0; i < 32; i++)
-            rx_up[i] = BleFunc_ToUpper(token_ptr[i]);
-        if (memcmp(rx_up, expected_token_up, 32) == 0) {
-            auth_ok = true;
-        }
+        auth_ok = BleFunc_TokenEqual(token_ptr, s_auth_token.hex, 32u, true);
     } else if (token_len == 16) {
         /* 16 字节原始 MD5 */
-        if (memcmp(token_ptr, target_digest, 16) == 0) {
-            auth_ok = true;
-        }
+        auth_ok = BleFunc_TokenEqual(token_ptr, s_auth_token.raw, 16u, false);
     }
 #endif
 
     if (auth_ok) {
-        co_printf("    Auth Success! ");
+        APP_LOGI("    Auth Success! ");
         uint8_t conidx = Protocol_Get_Rx_Conidx();
         Protocol_Auth_Set(conidx, true);
         /*回传鉴权成功*/
@@ -1608,7 +1768,7 @@ void BleFunc_FE_Connect(uint16_t cmd, const uint8_t* payload, uint8_t len) {
         BleFunc_ParamSync_Request64FDFromMcu();
         BleFunc_ParamSync_RequestVehicleStatusFromMcu();
     } else {
-        co_printf("    Auth Failed! ");
+        APP_LOGW("    Auth Failed! ");
 
         uint8_t conidx = Protocol_Get_Rx_Conidx();
         Protocol_Auth_Set(conidx, false);
@@ -1633,7 +1793,7 @@ void BleFunc_FE_Connect(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - 当前实现做协议解析与回包框架；硬件动作未接入时默认回失败，避免误控�?
  */
 void BleFunc_FE_Defences(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Defences (0x%04X) ", cmd);
+    APP_LOGI("  -> Defences (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd); // 0x0301
 
     if (!BleFunc_EnsureAuthed(reply_cmd))
@@ -1641,7 +1801,7 @@ void BleFunc_FE_Defences(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 
     /* 0x03FE: Time(6) + DefendStatus(1) = 7 bytes */
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -1651,13 +1811,13 @@ void BleFunc_FE_Defences(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     uint8_t        defendStatus = payload[6];
 
     BleFunc_PrintTime6(time6);
-    co_printf("    DefendStatus=0x%02X ", defendStatus);
+    APP_LOGI("    DefendStatus=0x%02X ", defendStatus);
     BleFunc_DumpPayload(payload, len);
 
     uint8_t result = 0x01;
     /* 校验 DefendStatus 合法�?*/
     if (defendStatus != 0x00 && defendStatus != 0x01) {
-        co_printf("    invalid DefendStatus ");
+        APP_LOGW("    invalid DefendStatus ");
         result = 0x01;
         BleFunc_SendResultToRx(reply_cmd, result);
     } else {
@@ -1677,8 +1837,8 @@ void BleFunc_FE_Defences(uint16_t cmd, const uint8_t* payload, uint8_t len) {
         /* [DEBUG-ONLY] 模拟 MCU 回复成功 */
         BleFunc_McuUart_SendOnly(
             BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-        co_printf("[DEBUG_SIM] Defences(%s) Success (0x00) ",
-                  defendStatus ? "LOCK" : "UNLOCK");
+        APP_LOGI("[DEBUG_SIM] Defences(%s) Success (0x00) ",
+                 defendStatus ? "LOCK" : "UNLOCK");
         result = 0x00;
         BleFunc_SendResultToRx(reply_cmd, result);
 #endif
@@ -1695,21 +1855,21 @@ void BleFunc_FE_Defences(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - Response Payload: ResultCode(1)�?x00 成功�?x01 失败�?
  */
 void BleFunc_FE_AntiTheft(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Anti-Theft (0x%04X) ", cmd);
+    APP_LOGI("  -> Anti-Theft (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     /* 0x04FE: Time(6) + InductionStatus(1) = 7 bytes */
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
 
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    InductionStatus=0x%02X ", payload[6]);
+    APP_LOGI("    InductionStatus=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 
 /* 下发�?MCU，并等待回包/超时再回 0x0401 */
@@ -1727,7 +1887,7 @@ void BleFunc_FE_AntiTheft(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 #else
     /* [DEBUG-ONLY] 模拟 MCU 回复成功（同时镜像下�?MCU 便于联调对照�?*/
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] Anti-Theft Success (0x00) ");
+    APP_LOGI("[DEBUG_SIM] Anti-Theft Success (0x00) ");
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -1745,21 +1905,21 @@ void BleFunc_FE_AntiTheft(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FE_PhoneMessage(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> Phone Message (0x%04X) ", cmd);
+    APP_LOGI("  -> Phone Message (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     /* 0x05FE: Time(6) + MessageType(1) = 7 bytes */
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
 
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    MessageType=0x%02X ", payload[6]);
+    APP_LOGI("    MessageType=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 
 /* 下发�?MCU，并等待回包/超时再回 0x0501 */
@@ -1777,7 +1937,7 @@ void BleFunc_FE_PhoneMessage(uint16_t       cmd,
 #else
     /* [DEBUG-ONLY] 模拟 MCU 回复成功（同时镜像下�?MCU 便于联调对照�?*/
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] Phone Message Success (0x00) ");
+    APP_LOGI("[DEBUG_SIM] Phone Message Success (0x00) ");
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -1794,14 +1954,14 @@ void BleFunc_FE_PhoneMessage(uint16_t       cmd,
 void BleFunc_FE_RssiStrength(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> RSSI Strength (0x%04X) ", cmd);
+    APP_LOGI("  -> RSSI Strength (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     /* 0x07FE: Time(6) + min(2) + max(2) = 10 bytes */
     if (payload == NULL || len < 10) {
-        co_printf("    invalid payload len=%d (expect >= 10) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 10) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -1813,8 +1973,8 @@ void BleFunc_FE_RssiStrength(uint16_t       cmd,
     uint16_t max_raw = ((uint16_t)payload[8] << 8) | (uint16_t)payload[9];
     int16_t  min_dbm = -(int16_t)min_raw; /* 协议因子 -1，转换为�?dBm */
     int16_t  max_dbm = -(int16_t)max_raw;
-    co_printf("    min_raw=%u -> %d dBm ", (unsigned)min_raw, (int)min_dbm);
-    co_printf("    max_raw=%u -> %d dBm ", (unsigned)max_raw, (int)max_dbm);
+    APP_LOGI("    min_raw=%u -> %d dBm ", (unsigned)min_raw, (int)min_dbm);
+    APP_LOGI("    max_raw=%u -> %d dBm ", (unsigned)max_raw, (int)max_dbm);
 
     BleFunc_DumpPayload(payload, len);
 
@@ -1833,7 +1993,7 @@ void BleFunc_FE_RssiStrength(uint16_t       cmd,
 #else
     /* [DEBUG-ONLY] 自动成功回包（同时镜像下�?MCU 便于联调对照�?*/
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] RSSI Strength Success (0x00) ");
+    APP_LOGI("[DEBUG_SIM] RSSI Strength Success (0x00) ");
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -1848,14 +2008,14 @@ void BleFunc_FE_RssiStrength(uint16_t       cmd,
  * @note 通常会触发鸣�?双闪等动作，未接入硬件前默认回失败�?
  */
 void BleFunc_FE_CarSearch(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Car Search (0x%04X) ", cmd);
+    APP_LOGI("  -> Car Search (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     /* 0x08FE: Time(6) = 6 bytes */
     if (payload == NULL || len < 6) {
-        co_printf("    invalid payload len=%d (expect >= 6) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 6) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -1878,7 +2038,7 @@ void BleFunc_FE_CarSearch(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 #else
     /* [DEBUG-ONLY] 模拟 MCU 回复成功 */
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] Car Search Success (0x00) ");
+    APP_LOGI("[DEBUG_SIM] Car Search Success (0x00) ");
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -1896,14 +2056,14 @@ void BleFunc_FE_CarSearch(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FE_FactorySettings(uint16_t       cmd,
                                 const uint8_t* payload,
                                 uint8_t        len) {
-    co_printf("  -> Factory Settings (0x%04X) ", cmd);
+    APP_LOGI("  -> Factory Settings (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     /* 0x09FE: Time(6) = 6 bytes */
     if (payload == NULL || len < 6) {
-        co_printf("    invalid payload len=%d (expect >= 6) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 6) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -1926,7 +2086,7 @@ void BleFunc_FE_FactorySettings(uint16_t       cmd,
 #else
     /* [DEBUG-ONLY] 模拟 MCU 回复成功 */
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] Factory Settings Success (0x00) ");
+    APP_LOGI("[DEBUG_SIM] Factory Settings Success (0x00) ");
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -1941,14 +2101,14 @@ void BleFunc_FE_FactorySettings(uint16_t       cmd,
  *   - 0x00 成功�?x01 失败�?x02 操作失败：无效卡（协议文档给出的扩展含义�?
  */
 void BleFunc_FE_BleUnpair(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> BLE Unpair (0x%04X) ", cmd);
+    APP_LOGI("  -> BLE Unpair (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     /* 0x0AFE: Time(6) = 6 bytes */
     if (payload == NULL || len < 6) {
-        co_printf("    invalid payload len=%d (expect >= 6) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 6) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -1984,19 +2144,19 @@ void BleFunc_FE_BleUnpair(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - 当前实现仅解析与回包框架；未接入卡池时默认回失败�?
  */
 void BleFunc_FE_AddNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Add NFC (0x%04X) ", cmd);
+    APP_LOGI("  -> Add NFC (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    add_control=0x%02X ", payload[6]);
+    APP_LOGI("    add_control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 
 /* 下发�?MCU，由 MCU 负责 NFC 交互逻辑（Reply 0x00/0x01/0x02/0x03/0x04 + UUID +
@@ -2014,7 +2174,7 @@ void BleFunc_FE_AddNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 #else
     /* [DEBUG-ONLY] 先保留模拟成功逻辑，同时镜像下�?MCU 便于联调对照 */
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] Add NFC Success (0x00) ");
+    APP_LOGI("[DEBUG_SIM] Add NFC Success (0x00) ");
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -2030,13 +2190,13 @@ void BleFunc_FE_AddNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - Response Payload: ResultCode(1)
  */
 void BleFunc_FE_DeleteNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Delete NFC (0x%04X) ", cmd);
+    APP_LOGI("  -> Delete NFC (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (min 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (min 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -2044,35 +2204,35 @@ void BleFunc_FE_DeleteNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 
     BleFunc_PrintTime6(&payload[0]);
     uint8_t control = payload[6];
-    co_printf("    delete_control=%u ", (unsigned)control);
+    APP_LOGI("    delete_control=%u ", (unsigned)control);
     if (control == 1) {
         if (len != 17) {
-            co_printf("    invalid len for control=1 (expect 17) ");
+            APP_LOGW("    invalid len for control=1 (expect 17) ");
             BleFunc_DumpPayload(payload, len);
             BleFunc_SendResultToRx(reply_cmd, 0x01);
             return;
         }
-        co_printf("    uuid=%02X%02X%02X%02X ",
-                  payload[7],
-                  payload[8],
-                  payload[9],
-                  payload[10]);
-        co_printf("    key=%02X %02X %02X %02X %02X %02X ",
-                  payload[11],
-                  payload[12],
-                  payload[13],
-                  payload[14],
-                  payload[15],
-                  payload[16]);
+        APP_LOGI("    uuid=%02X%02X%02X%02X ",
+                 payload[7],
+                 payload[8],
+                 payload[9],
+                 payload[10]);
+        APP_LOGI("    key=%02X %02X %02X %02X %02X %02X ",
+                 payload[11],
+                 payload[12],
+                 payload[13],
+                 payload[14],
+                 payload[15],
+                 payload[16]);
     } else if (control == 2 || control == 3) {
         if (len != 7) {
-            co_printf("    invalid len for control=2/3 (expect 7) ");
+            APP_LOGW("    invalid len for control=2/3 (expect 7) ");
             BleFunc_DumpPayload(payload, len);
             BleFunc_SendResultToRx(reply_cmd, 0x01);
             return;
         }
     } else {
-        co_printf("    invalid delete_control ");
+        APP_LOGW("    invalid delete_control ");
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -2094,7 +2254,7 @@ void BleFunc_FE_DeleteNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 #else
     /* [DEBUG-ONLY] 模拟 MCU 回复成功 */
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] Delete NFC Success (0x00) ");
+    APP_LOGI("[DEBUG_SIM] Delete NFC Success (0x00) ");
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -2109,13 +2269,13 @@ void BleFunc_FE_DeleteNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * @note 未接入卡池时默认�?0x01（暂无卡）�?
  */
 void BleFunc_FE_SearchNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Search NFC (0x%04X) ", cmd);
+    APP_LOGI("  -> Search NFC (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 6) {
-        co_printf("    invalid payload len=%d (expect 6) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 6) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x02);
         return;
@@ -2150,19 +2310,19 @@ void BleFunc_FE_SearchNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - Response Cmd: 0x0F01
  */
 void BleFunc_FE_OilDefence(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Oil Defence (0x%04X) ", cmd);
+    APP_LOGI("  -> Oil Defence (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    DefendStatus=0x%02X ", payload[6]);
+    APP_LOGI("    DefendStatus=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0F01 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2179,7 +2339,7 @@ void BleFunc_FE_OilDefence(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     {
         BleFunc_McuUart_SendOnly(
             BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-        co_printf("[DEBUG_SIM] Oil Defence Success (0x00) ");
+        APP_LOGI("[DEBUG_SIM] Oil Defence Success (0x00) ");
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2196,19 +2356,19 @@ void BleFunc_FE_OilDefence(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FE_OilCarSearch(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> Oil Car Search (0x%04X) ", cmd);
+    APP_LOGI("  -> Oil Car Search (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    sound=0x%02X ", payload[6]);
+    APP_LOGI("    sound=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1101 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2225,7 +2385,7 @@ void BleFunc_FE_OilCarSearch(uint16_t       cmd,
     {
         BleFunc_McuUart_SendOnly(
             BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-        co_printf("[DEBUG_SIM] Oil Car Search Success (0x00) ");
+        APP_LOGI("[DEBUG_SIM] Oil Car Search Success (0x00) ");
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2240,19 +2400,19 @@ void BleFunc_FE_OilCarSearch(uint16_t       cmd,
  * - Response Cmd: 0x1201
  */
 void BleFunc_FE_SetBootLock(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Set Boot Lock (0x%04X) ", cmd);
+    APP_LOGI("  -> Set Boot Lock (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1201 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2269,7 +2429,7 @@ void BleFunc_FE_SetBootLock(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     {
         BleFunc_McuUart_SendOnly(
             BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-        co_printf("[DEBUG_SIM] Set Boot Lock Success (0x00) ");
+        APP_LOGI("[DEBUG_SIM] Set Boot Lock Success (0x00) ");
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2283,19 +2443,19 @@ void BleFunc_FE_SetBootLock(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - Response Cmd: 0x1301
  */
 void BleFunc_FE_SetNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Set NFC (0x%04X)", cmd);
+    APP_LOGI("  -> Set NFC (0x%04X)", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7)", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7)", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X", payload[6]);
+    APP_LOGI("    control=0x%02X", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1301 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2312,7 +2472,7 @@ void BleFunc_FE_SetNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     {
         BleFunc_McuUart_SendOnly(
             BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-        co_printf("[DEBUG_SIM] Set NFC Success (0x00)");
+        APP_LOGI("[DEBUG_SIM] Set NFC Success (0x00)");
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2326,19 +2486,19 @@ void BleFunc_FE_SetNfc(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - Response Cmd: 0x1401
  */
 void BleFunc_FE_SetSeatLock(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Set Seat Lock (0x%04X)", cmd);
+    APP_LOGI("  -> Set Seat Lock (0x%04X)", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7)", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7)", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X", payload[6]);
+    APP_LOGI("    control=0x%02X", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1401 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2358,8 +2518,8 @@ void BleFunc_FE_SetSeatLock(uint16_t cmd, const uint8_t* payload, uint8_t len) {
         uint16_t mcu_cmd = (ctrl == 0x00u) ? (uint16_t)CMD_VEHICLE_UNLOCK_SEAT
                                            : (uint16_t)CMD_VEHICLE_LOCK_SEAT;
         BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, mcu_cmd, &ctrl, 1u);
-        co_printf("[DEBUG_SIM] Set Seat Lock mcu_cmd=0x%04X Success (0x00) ",
-                  (unsigned)mcu_cmd);
+        APP_LOGI("[DEBUG_SIM] Set Seat Lock mcu_cmd=0x%04X Success (0x00) ",
+                 (unsigned)mcu_cmd);
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2375,19 +2535,19 @@ void BleFunc_FE_SetSeatLock(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - Response ResultCode: 0x00 成功�?x01 失败�?x02 acc 状态拒绝（协议文档扩展�?
  */
 void BleFunc_FE_SetCarMute(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> Set Car Mute (0x%04X) ", cmd);
+    APP_LOGI("  -> Set Car Mute (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1501 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2404,7 +2564,7 @@ void BleFunc_FE_SetCarMute(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     {
         BleFunc_McuUart_SendOnly(
             BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-        co_printf("[DEBUG_SIM] Set Car Mute Success (0x00) ");
+        APP_LOGI("[DEBUG_SIM] Set Car Mute Success (0x00) ");
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2420,19 +2580,19 @@ void BleFunc_FE_SetCarMute(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FE_SetMidBoxLock(uint16_t       cmd,
                               const uint8_t* payload,
                               uint8_t        len) {
-    co_printf("  -> Set Mid Box Lock (0x%04X) ", cmd);
+    APP_LOGI("  -> Set Mid Box Lock (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1601 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2453,8 +2613,8 @@ void BleFunc_FE_SetMidBoxLock(uint16_t       cmd,
                                ? (uint16_t)CMD_VEHICLE_UNLOCK_MIDDLE_BOX
                                : (uint16_t)CMD_VEHICLE_LOCK_MIDDLE_BOX;
         BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, mcu_cmd, &ctrl, 1u);
-        co_printf("[DEBUG_SIM] Set Mid Box Lock mcu_cmd=0x%04X Success (0x00) ",
-                  (unsigned)mcu_cmd);
+        APP_LOGI("[DEBUG_SIM] Set Mid Box Lock mcu_cmd=0x%04X Success (0x00) ",
+                 (unsigned)mcu_cmd);
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2470,19 +2630,19 @@ void BleFunc_FE_SetMidBoxLock(uint16_t       cmd,
 void BleFunc_FE_SetEmergencyMode(uint16_t       cmd,
                                  const uint8_t* payload,
                                  uint8_t        len) {
-    co_printf("  -> Set Emergency Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> Set Emergency Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1701 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2502,7 +2662,7 @@ void BleFunc_FE_SetEmergencyMode(uint16_t       cmd,
         uint16_t mcu_cmd =
             (ctrl == 0x00u) ? 0x41u : 0x40u; /* 0x40=打开, 0x41=关闭 */
         BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, mcu_cmd, &ctrl, 1u);
-        co_printf("[DEBUG_SIM] Set Emergency Mode Success (0x00) ");
+        APP_LOGI("[DEBUG_SIM] Set Emergency Mode Success (0x00) ");
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2525,13 +2685,13 @@ void BleFunc_FE_SetEmergencyMode(uint16_t       cmd,
  * 0x1801+ResultCode(1)
  */
 void BleFunc_FE_GetPhoneMac(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> 0x18FE Handler (0x%04X) ", cmd);
+    APP_LOGI("  -> 0x18FE Handler (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || (len != 6 && len != 7)) {
-        co_printf("    invalid payload len=%d (expect 6 or 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 6 or 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         /* 失败回包：ResultCode(1)+MAC(6)=7 */
         uint8_t resp[7] = {0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
@@ -2542,7 +2702,7 @@ void BleFunc_FE_GetPhoneMac(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 
     BleFunc_PrintTime6(&payload[0]);
     if (len == 7) {
-        co_printf("    controlType=0x%02X ", payload[6]);
+        APP_LOGI("    controlType=0x%02X ", payload[6]);
         BleFunc_DumpPayload(payload, len);
 /* len==7: 按“单控开锁”处理，下发�?MCU 并等待回�?超时再回 0x1801 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2558,7 +2718,7 @@ void BleFunc_FE_GetPhoneMac(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 #else
         BleFunc_McuUart_SendOnly(
             BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-        co_printf("[DEBUG_SIM] Single Control Unlock Success (0x00) ");
+        APP_LOGI("[DEBUG_SIM] Single Control Unlock Success (0x00) ");
         BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
         return;
@@ -2591,14 +2751,14 @@ void BleFunc_FE_GetPhoneMac(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FE_SetUnlockMode(uint16_t       cmd,
                               const uint8_t* payload,
                               uint8_t        len) {
-    co_printf("  -> Set Unlock Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> Set Unlock Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd); /* 0x1901 */
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     /* 5.22 单控开锁：Time(6) + controlType(1) */
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -2606,7 +2766,7 @@ void BleFunc_FE_SetUnlockMode(uint16_t       cmd,
 
     BleFunc_PrintTime6(&payload[0]);
     uint8_t controlType = payload[6];
-    co_printf("    controlType=0x%02X ", controlType);
+    APP_LOGI("    controlType=0x%02X ", controlType);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1901 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2621,7 +2781,7 @@ void BleFunc_FE_SetUnlockMode(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] Set Unlock Mode Success (0x00) ");
+    APP_LOGI("[DEBUG_SIM] Set Unlock Mode Success (0x00) ");
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -2639,14 +2799,14 @@ void BleFunc_FE_SetUnlockMode(uint16_t       cmd,
 void BleFunc_FE_ChargeDisplay(uint16_t       cmd,
                               const uint8_t* payload,
                               uint8_t        len) {
-    co_printf("  -> Charge Display (0x%04X) ", cmd);
+    APP_LOGI("  -> Charge Display (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FE(cmd); /* 0x1A01 */
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     /* 0x1AFE: Time(6) + control(1) = 7 bytes */
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -2654,7 +2814,7 @@ void BleFunc_FE_ChargeDisplay(uint16_t       cmd,
 
     BleFunc_PrintTime6(&payload[0]);
     uint8_t control = payload[6];
-    co_printf(
+    APP_LOGI(
         "    control=0x%02X (%s) ", control, (control == 0x01u) ? "ON" : "OFF");
     BleFunc_DumpPayload(payload, len);
 
@@ -2677,8 +2837,8 @@ void BleFunc_FE_ChargeDisplay(uint16_t       cmd,
                                ? (uint16_t)CMD_CHARGE_DISPLAY_ON
                                : (uint16_t)CMD_CHARGE_DISPLAY_OFF;
         BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, mcu_cmd, &control, 1u);
-        co_printf("[DEBUG_SIM] Charge Display mcu_cmd=0x%04X Success (0x00) ",
-                  (unsigned)mcu_cmd);
+        APP_LOGI("[DEBUG_SIM] Charge Display mcu_cmd=0x%04X Success (0x00) ",
+                 (unsigned)mcu_cmd);
         BleFunc_SendResultToRx(reply_cmd, 0x00);
     }
 #endif
@@ -2695,19 +2855,19 @@ void BleFunc_FE_ChargeDisplay(uint16_t       cmd,
 void BleFunc_FD_AssistiveTrolley(uint16_t       cmd,
                                  const uint8_t* payload,
                                  uint8_t        len) {
-    co_printf("  -> FD Assistive Trolley (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Assistive Trolley (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 8) {
-        co_printf("    invalid payload len=%d (expect 8) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 8) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X speed=%u ", payload[6], (unsigned)payload[7]);
+    APP_LOGI("    control=0x%02X speed=%u ", payload[6], (unsigned)payload[7]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0202 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2722,7 +2882,7 @@ void BleFunc_FD_AssistiveTrolley(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -2738,19 +2898,19 @@ void BleFunc_FD_AssistiveTrolley(uint16_t       cmd,
 void BleFunc_FD_DelayedHeadlight(uint16_t       cmd,
                                  const uint8_t* payload,
                                  uint8_t        len) {
-    co_printf("  -> FD Delayed Headlight (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Delayed Headlight (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 8) {
-        co_printf("    invalid payload len=%d (expect 8) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 8) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf(
+    APP_LOGI(
         "    control=0x%02X delayTime=%us ", payload[6], (unsigned)payload[7]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0302 */
@@ -2766,7 +2926,7 @@ void BleFunc_FD_DelayedHeadlight(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -2782,19 +2942,19 @@ void BleFunc_FD_DelayedHeadlight(uint16_t       cmd,
 void BleFunc_FD_SetChargingPower(uint16_t       cmd,
                                  const uint8_t* payload,
                                  uint8_t        len) {
-    co_printf("  -> FD Set Charging Power (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Charging Power (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    chargingPower=%u ", (unsigned)payload[6]);
+    APP_LOGI("    chargingPower=%u ", (unsigned)payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0402 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -2809,7 +2969,7 @@ void BleFunc_FD_SetChargingPower(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -2825,19 +2985,19 @@ void BleFunc_FD_SetChargingPower(uint16_t       cmd,
 void BleFunc_FD_SetPGearMode(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> FD Set P Gear Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set P Gear Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 8) {
-        co_printf("    invalid payload len=%d (expect 8) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 8) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf(
+    APP_LOGI(
         "    control=0x%02X delayTime=%us ", payload[6], (unsigned)payload[7]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0502 */
@@ -2853,7 +3013,7 @@ void BleFunc_FD_SetPGearMode(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -2869,21 +3029,21 @@ void BleFunc_FD_SetPGearMode(uint16_t       cmd,
 void BleFunc_FD_SetChordHornMode(uint16_t       cmd,
                                  const uint8_t* payload,
                                  uint8_t        len) {
-    co_printf("  -> FD Set Chord Horn Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Chord Horn Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 8) {
-        co_printf("    invalid payload len=%d (expect 8) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 8) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    soundSource=%u volume=%u ",
-              (unsigned)payload[6],
-              (unsigned)payload[7]);
+    APP_LOGI("    soundSource=%u volume=%u ",
+             (unsigned)payload[6],
+             (unsigned)payload[7]);
     BleFunc_DumpPayload(payload, len);
 /*
  * 下发�?MCU，并等待回包/超时再回 0x0602
@@ -2895,21 +3055,14 @@ void BleFunc_FD_SetChordHornMode(uint16_t       cmd,
  */
 #if (!ENABLE_NFC_ADD_SIMULATION)
     {
-        uint8_t conidx       = Protocol_Get_Rx_Conidx();
-        uint8_t sound_source = payload[6];
-        uint8_t volume       = payload[7];
-
-        /* 启动链式事务：step0=等待音源设置回包；收到成功后自动发音量设�?*/
-        s_mcu_pending.chain_kind = BLEFUNC_MCU_CHAIN_CHORD_HORN_06FD;
-        s_mcu_pending.chain_step = 0u;
-        s_mcu_pending.chain_u8_0 = volume;
+        uint8_t                conidx = Protocol_Get_Rx_Conidx();
+        blefunc_mcu_seq_args_t args   = {0};
+        args.u8[0]                    = payload[6]; /* soundSource */
+        args.u8[1]                    = payload[7]; /* volume */
 
-        BleFunc_McuTxn_Start(conidx,
-                             reply_cmd,
-                             BLEFUNC_MCU_FEATURE,
-                             (uint16_t)CMD_Chord_horn_type_set,
-                             &sound_source,
-                             1u);
+        /* 音源 + 音量两条 MCU 指令（见 s_seq_chord_horn_steps） */
+        BleFunc_McuSeq_Start(
+            conidx, reply_cmd, BLEFUNC_MCU_FEATURE, &s_seq_chord_horn, &args);
     }
 #else
     {
@@ -2925,7 +3078,7 @@ void BleFunc_FD_SetChordHornMode(uint16_t       cmd,
                                  &volume,
                                  1u);
     }
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -2943,7 +3096,7 @@ void BleFunc_FD_SetChordHornMode(uint16_t       cmd,
 void BleFunc_FD_SetRgbLightMode(uint16_t       cmd,
                                 const uint8_t* payload,
                                 uint8_t        len) {
-    co_printf("  -> FD Set RGB Light Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set RGB Light Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
@@ -2956,20 +3109,20 @@ void BleFunc_FD_SetRgbLightMode(uint16_t       cmd,
      * 字节当作扩展字段打印，不影响 MCU 透传�?
      */
     if (payload == NULL || len < 11) {
-        co_printf("    invalid payload len=%d (expect >= 11) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 11) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    effects=%u gradual=%u rgb=(%u,%u,%u) ",
-              (unsigned)payload[6],
-              (unsigned)payload[7],
-              (unsigned)payload[8],
-              (unsigned)payload[9],
-              (unsigned)payload[10]);
+    APP_LOGI("    effects=%u gradual=%u rgb=(%u,%u,%u) ",
+             (unsigned)payload[6],
+             (unsigned)payload[7],
+             (unsigned)payload[8],
+             (unsigned)payload[9],
+             (unsigned)payload[10]);
     if (len >= 12) {
-        co_printf("    ext=0x%02X ", (unsigned)payload[11]);
+        APP_LOGI("    ext=0x%02X ", (unsigned)payload[11]);
     }
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0702 */
@@ -2985,7 +3138,7 @@ void BleFunc_FD_SetRgbLightMode(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -3001,21 +3154,21 @@ void BleFunc_FD_SetRgbLightMode(uint16_t       cmd,
 void BleFunc_FD_SetAuxiliaryParking(uint16_t       cmd,
                                     const uint8_t* payload,
                                     uint8_t        len) {
-    co_printf("  -> FD Set Auxiliary Parking (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Auxiliary Parking (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 8) {
-        co_printf("    invalid payload len=%d (expect 8) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 8) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X reverseSpeed=%u ",
-              payload[6],
-              (unsigned)payload[7]);
+    APP_LOGI("    control=0x%02X reverseSpeed=%u ",
+             payload[6],
+             (unsigned)payload[7]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0802 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -3030,7 +3183,7 @@ void BleFunc_FD_SetAuxiliaryParking(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -3046,13 +3199,13 @@ void BleFunc_FD_SetAuxiliaryParking(uint16_t       cmd,
 void BleFunc_FD_SetIntelligentSwitch(uint16_t       cmd,
                                      const uint8_t* payload,
                                      uint8_t        len) {
-    co_printf("  -> FD Set Intelligent Switch (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Intelligent Switch (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -3082,12 +3235,12 @@ void BleFunc_FD_SetIntelligentSwitch(uint16_t       cmd,
     case 0x0Au: controlTypeStr = "three_color_ambient"; break;
     default: break;
     }
-    co_printf("    strip %u->%u control=0x%02X controlType=0x%02X(%s) ",
-              (unsigned)payload_len_before_strip,
-              (unsigned)len,
-              control,
-              controlType,
-              controlTypeStr);
+    APP_LOGI("    strip %u->%u control=0x%02X controlType=0x%02X(%s) ",
+             (unsigned)payload_len_before_strip,
+             (unsigned)len,
+             control,
+             controlType,
+             controlTypeStr);
     BleFunc_DumpPayload(payload, len);
 
 /*
@@ -3117,9 +3270,9 @@ void BleFunc_FD_SetIntelligentSwitch(uint16_t       cmd,
             else if (mcu_id == (uint16_t)CMD_Three_shooting_lamp_default)
                 actionStr = "DEFAULT(0x63)";
 
-            co_printf("    three_shooting_lamp action=%s mcu_id=0x%04X ",
-                      actionStr,
-                      (unsigned)mcu_id);
+            APP_LOGI("    three_shooting_lamp action=%s mcu_id=0x%04X ",
+                     actionStr,
+                     (unsigned)mcu_id);
             if (mcu_id == 0u) {
                 BleFunc_SendResultToRx(reply_cmd, 0x01);
                 return;
@@ -3171,9 +3324,9 @@ void BleFunc_FD_SetIntelligentSwitch(uint16_t       cmd,
         // else if (mcu_id == (uint16_t)CMD_Three_shooting_lamp_default)
         // actionStr = "DEFAULT(0x63)";
 
-        co_printf("[DEBUG_SIM] three_shooting_lamp action=%s mcu_id=0x%04X ",
-                  actionStr,
-                  (unsigned)mcu_id);
+        APP_LOGI("[DEBUG_SIM] three_shooting_lamp action=%s mcu_id=0x%04X ",
+                 actionStr,
+                 (unsigned)mcu_id);
         if (mcu_id != 0u) {
             BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, mcu_id, NULL, 0u);
         }
@@ -3198,7 +3351,7 @@ void BleFunc_FD_SetIntelligentSwitch(uint16_t       cmd,
         BleFunc_McuUart_SendOnly(
             BLEFUNC_MCU_FEATURE, (uint16_t)cmd, payload, (uint16_t)len);
     }
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -3214,13 +3367,13 @@ void BleFunc_FD_SetIntelligentSwitch(uint16_t       cmd,
 void BleFunc_FD_ParamSynchronize(uint16_t       cmd,
                                  const uint8_t* payload,
                                  uint8_t        len) {
-    co_printf("  -> FD Param Synchronize (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Param Synchronize (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len < 6) {
-        co_printf("    invalid payload len=%d (min 6) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (min 6) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -3241,13 +3394,13 @@ void BleFunc_FD_ParamSynchronize(uint16_t       cmd,
 void BleFunc_FD_ParamSynchronizeChange(uint16_t       cmd,
                                        const uint8_t* payload,
                                        uint8_t        len) {
-    co_printf("  -> FD Param Sync Change (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Param Sync Change (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len < 6) {
-        co_printf("    invalid payload len=%d (min 6) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (min 6) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -3268,19 +3421,19 @@ void BleFunc_FD_ParamSynchronizeChange(uint16_t       cmd,
 void BleFunc_FD_SetDefaultMode(uint16_t       cmd,
                                const uint8_t* payload,
                                uint8_t        len) {
-    co_printf("  -> FD Set Default Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Default Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 8) {
-        co_printf("    invalid payload len=%d (expect 8) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 8) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    code=0x%02X codeSub=0x%02X ", payload[6], payload[7]);
+    APP_LOGI("    code=0x%02X codeSub=0x%02X ", payload[6], payload[7]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x6502 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -3295,7 +3448,7 @@ void BleFunc_FD_SetDefaultMode(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -3311,22 +3464,22 @@ void BleFunc_FD_SetDefaultMode(uint16_t       cmd,
 void BleFunc_FD_SetVichleGurdMode(uint16_t       cmd,
                                   const uint8_t* payload,
                                   uint8_t        len) {
-    co_printf("  -> FD Set Vehicle Guard Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Vehicle Guard Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 9) {
-        co_printf("    invalid payload len=%d (expect 9) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 9) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    sensitivity=0x%02X volume=0x%02X soundDefence=0x%02X ",
-              payload[6],
-              payload[7],
-              payload[8]);
+    APP_LOGI("    sensitivity=0x%02X volume=0x%02X soundDefence=0x%02X ",
+             payload[6],
+             payload[7],
+             payload[8]);
     BleFunc_DumpPayload(payload, len);
 
 /* Send sensitivity + volume + soundDefence to MCU (Time6 stripped in transport)
@@ -3343,7 +3496,7 @@ void BleFunc_FD_SetVichleGurdMode(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -3359,19 +3512,19 @@ void BleFunc_FD_SetVichleGurdMode(uint16_t       cmd,
 void BleFunc_FD_SetAutoReturnMode(uint16_t       cmd,
                                   const uint8_t* payload,
                                   uint8_t        len) {
-    co_printf("  -> FD Set Auto Return Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Auto Return Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0A02 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -3386,7 +3539,7 @@ void BleFunc_FD_SetAutoReturnMode(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -3402,19 +3555,19 @@ void BleFunc_FD_SetAutoReturnMode(uint16_t       cmd,
 void BleFunc_FD_SetEbsSwitch(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> FD Set EBS Switch (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set EBS Switch (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0B02 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -3429,7 +3582,7 @@ void BleFunc_FD_SetEbsSwitch(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -3447,13 +3600,13 @@ void BleFunc_FD_SetEbsSwitch(uint16_t       cmd,
 void BleFunc_FD_SetESaveMode(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> FD Set E-SAVE Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set E-SAVE Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len < 1) {
-        co_printf("    invalid payload len=%d (expect >= 1) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 1) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -3467,41 +3620,38 @@ void BleFunc_FD_SetESaveMode(uint16_t       cmd,
     }
     len = (uint8_t)temp_len;
     if (len < 1u) {
-        co_printf("    invalid payload len after strip=%u (expect >= 1) ",
-                  (unsigned)len);
+        APP_LOGW("    invalid payload len after strip=%u (expect >= 1) ",
+                 (unsigned)len);
         BleFunc_DumpPayload(mcu_payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     uint8_t control = mcu_payload[0];
     uint8_t speed   = (len >= 2) ? mcu_payload[1] : control;
-    co_printf("    strip %u->%u control=0x%02X speed=%u ",
-              (unsigned)payload_len_before_strip,
-              (unsigned)len,
-              control,
-              (unsigned)speed);
+    APP_LOGI("    strip %u->%u control=0x%02X speed=%u ",
+             (unsigned)payload_len_before_strip,
+             (unsigned)len,
+             control,
+             (unsigned)speed);
     BleFunc_DumpPayload(mcu_payload, len);
 
     /* New spec: 1B control (0..3) as torque level */
     if (len == 1u) {
         if (control > 0x03u) {
-            co_printf("    invalid control(level) ");
+            APP_LOGW("    invalid control(level) ");
             BleFunc_SendResultToRx(reply_cmd, 0x01);
             return;
         }
 #if (!ENABLE_NFC_ADD_SIMULATION)
         {
-            uint8_t conidx            = Protocol_Get_Rx_Conidx();
-            s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_GEAR_SET_FD;
-            s_mcu_pending.chain_step  = 0u;
-            s_mcu_pending.chain_u8_0  = speed;
-            s_mcu_pending.chain_u16_0 = (uint16_t)CMD_Low_speed_gear_speed_set;
-            BleFunc_McuTxn_Start(conidx,
+            uint8_t                conidx = Protocol_Get_Rx_Conidx();
+            blefunc_mcu_seq_args_t args   = {0};
+            args.u8[0]                    = speed;
+            BleFunc_McuSeq_Start(conidx,
                                  reply_cmd,
                                  BLEFUNC_MCU_FEATURE,
-                                 (uint16_t)CMD_Low_speed_gear_on,
-                                 NULL,
-                                 0u);
+                                 &s_seq_gear_low,
+                                 &args);
         }
 #else
         {
@@ -3511,7 +3661,7 @@ void BleFunc_FD_SetESaveMode(uint16_t       cmd,
                                      (uint16_t)CMD_Low_speed_gear_speed_set,
                                      &speed,
                                      1u);
-            co_printf("[DEBUG_SIM] FD E-SAVE split send Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD E-SAVE split send Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3523,17 +3673,14 @@ void BleFunc_FD_SetESaveMode(uint16_t       cmd,
     if (control == 0x01u) {
 #if (!ENABLE_NFC_ADD_SIMULATION)
         {
-            uint8_t conidx            = Protocol_Get_Rx_Conidx();
-            s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_GEAR_SET_FD;
-            s_mcu_pending.chain_step  = 0u;
-            s_mcu_pending.chain_u8_0  = speed;
-            s_mcu_pending.chain_u16_0 = (uint16_t)CMD_Low_speed_gear_speed_set;
-            BleFunc_McuTxn_Start(conidx,
+            uint8_t                conidx = Protocol_Get_Rx_Conidx();
+            blefunc_mcu_seq_args_t args   = {0};
+            args.u8[0]                    = speed;
+            BleFunc_McuSeq_Start(conidx,
                                  reply_cmd,
                                  BLEFUNC_MCU_FEATURE,
-                                 (uint16_t)CMD_Low_speed_gear_on,
-                                 NULL,
-                                 0u);
+                                 &s_seq_gear_low,
+                                 &args);
         }
 #else
         {
@@ -3543,7 +3690,7 @@ void BleFunc_FD_SetESaveMode(uint16_t       cmd,
                                      (uint16_t)CMD_Low_speed_gear_speed_set,
                                      &speed,
                                      1u);
-            co_printf("[DEBUG_SIM] FD E-SAVE split send Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD E-SAVE split send Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3566,7 +3713,7 @@ void BleFunc_FD_SetESaveMode(uint16_t       cmd,
                                      (uint16_t)CMD_Low_speed_gear_off,
                                      NULL,
                                      0u);
-            co_printf("[DEBUG_SIM] FD E-SAVE off Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD E-SAVE off Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3589,14 +3736,14 @@ void BleFunc_FD_SetESaveMode(uint16_t       cmd,
                                      (uint16_t)CMD_Low_speed_gear_default,
                                      NULL,
                                      0u);
-            co_printf("[DEBUG_SIM] FD E-SAVE default Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD E-SAVE default Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
         return;
     }
 
-    co_printf("    invalid control ");
+    APP_LOGW("    invalid control ");
     BleFunc_SendResultToRx(reply_cmd, 0x01);
 }
 
@@ -3609,13 +3756,13 @@ void BleFunc_FD_SetESaveMode(uint16_t       cmd,
  * - Response Payload: ResultCode(1)
  */
 void BleFunc_FD_SetDynMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> FD Set DYN Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set DYN Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len < 1) {
-        co_printf("    invalid payload len=%d (expect >= 1) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 1) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -3629,42 +3776,38 @@ void BleFunc_FD_SetDynMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     }
     len = (uint8_t)temp_len;
     if (len < 1u) {
-        co_printf("    invalid payload len after strip=%u (expect >= 1) ",
-                  (unsigned)len);
+        APP_LOGW("    invalid payload len after strip=%u (expect >= 1) ",
+                 (unsigned)len);
         BleFunc_DumpPayload(mcu_payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     uint8_t control = mcu_payload[0];
     uint8_t speed   = (len >= 2) ? mcu_payload[1] : control;
-    co_printf("    strip %u->%u control=0x%02X speed=%u ",
-              (unsigned)payload_len_before_strip,
-              (unsigned)len,
-              control,
-              (unsigned)speed);
+    APP_LOGI("    strip %u->%u control=0x%02X speed=%u ",
+             (unsigned)payload_len_before_strip,
+             (unsigned)len,
+             control,
+             (unsigned)speed);
     BleFunc_DumpPayload(mcu_payload, len);
 
     /* New spec: 1B control (0..3) as torque level */
     if (len == 1u) {
         if (control > 0x03u) {
-            co_printf("    invalid control(level) ");
+            APP_LOGW("    invalid control(level) ");
             BleFunc_SendResultToRx(reply_cmd, 0x01);
             return;
         }
 #if (!ENABLE_NFC_ADD_SIMULATION)
         {
-            uint8_t conidx           = Protocol_Get_Rx_Conidx();
-            s_mcu_pending.chain_kind = BLEFUNC_MCU_CHAIN_GEAR_SET_FD;
-            s_mcu_pending.chain_step = 0u;
-            s_mcu_pending.chain_u8_0 = speed;
-            s_mcu_pending.chain_u16_0 =
-                (uint16_t)CMD_Medium_speed_gear_speed_set;
-            BleFunc_McuTxn_Start(conidx,
+            uint8_t                conidx = Protocol_Get_Rx_Conidx();
+            blefunc_mcu_seq_args_t args   = {0};
+            args.u8[0]                    = speed;
+            BleFunc_McuSeq_Start(conidx,
                                  reply_cmd,
                                  BLEFUNC_MCU_FEATURE,
-                                 (uint16_t)CMD_Medium_speed_gear_on,
-                                 NULL,
-                                 0u);
+                                 &s_seq_gear_mid,
+                                 &args);
         }
 #else
         {
@@ -3676,7 +3819,7 @@ void BleFunc_FD_SetDynMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
                                      (uint16_t)CMD_Medium_speed_gear_speed_set,
                                      &speed,
                                      1u);
-            co_printf("[DEBUG_SIM] FD DYN split send Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD DYN split send Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3686,18 +3829,14 @@ void BleFunc_FD_SetDynMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     if (control == 0x01u) {
 #if (!ENABLE_NFC_ADD_SIMULATION)
         {
-            uint8_t conidx           = Protocol_Get_Rx_Conidx();
-            s_mcu_pending.chain_kind = BLEFUNC_MCU_CHAIN_GEAR_SET_FD;
-            s_mcu_pending.chain_step = 0u;
-            s_mcu_pending.chain_u8_0 = speed;
-            s_mcu_pending.chain_u16_0 =
-                (uint16_t)CMD_Medium_speed_gear_speed_set;
-            BleFunc_McuTxn_Start(conidx,
+            uint8_t                conidx = Protocol_Get_Rx_Conidx();
+            blefunc_mcu_seq_args_t args   = {0};
+            args.u8[0]                    = speed;
+            BleFunc_McuSeq_Start(conidx,
                                  reply_cmd,
                                  BLEFUNC_MCU_FEATURE,
-                                 (uint16_t)CMD_Medium_speed_gear_on,
-                                 NULL,
-                                 0u);
+                                 &s_seq_gear_mid,
+                                 &args);
         }
 #else
         {
@@ -3709,7 +3848,7 @@ void BleFunc_FD_SetDynMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
                                      (uint16_t)CMD_Medium_speed_gear_speed_set,
                                      &speed,
                                      1u);
-            co_printf("[DEBUG_SIM] FD DYN split send Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD DYN split send Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3732,7 +3871,7 @@ void BleFunc_FD_SetDynMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
                                      (uint16_t)CMD_Medium_speed_gear_off,
                                      NULL,
                                      0u);
-            co_printf("[DEBUG_SIM] FD DYN off Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD DYN off Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3755,14 +3894,14 @@ void BleFunc_FD_SetDynMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
                                      (uint16_t)CMD_Medium_speed_gear_default,
                                      NULL,
                                      0u);
-            co_printf("[DEBUG_SIM] FD DYN default Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD DYN default Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
         return;
     }
 
-    co_printf("    invalid control ");
+    APP_LOGW("    invalid control ");
     BleFunc_SendResultToRx(reply_cmd, 0x01);
 }
 
@@ -3777,13 +3916,13 @@ void BleFunc_FD_SetDynMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FD_SetSportMode(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> FD Set SPORT Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set SPORT Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len < 1) {
-        co_printf("    invalid payload len=%d (expect >= 1) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 1) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -3797,41 +3936,38 @@ void BleFunc_FD_SetSportMode(uint16_t       cmd,
     }
     len = (uint8_t)temp_len;
     if (len < 1u) {
-        co_printf("    invalid payload len after strip=%u (expect >= 1) ",
-                  (unsigned)len);
+        APP_LOGW("    invalid payload len after strip=%u (expect >= 1) ",
+                 (unsigned)len);
         BleFunc_DumpPayload(mcu_payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     uint8_t control = mcu_payload[0];
     uint8_t speed   = (len >= 2) ? mcu_payload[1] : control;
-    co_printf("    strip %u->%u control=0x%02X speed=%u ",
-              (unsigned)payload_len_before_strip,
-              (unsigned)len,
-              control,
-              (unsigned)speed);
+    APP_LOGI("    strip %u->%u control=0x%02X speed=%u ",
+             (unsigned)payload_len_before_strip,
+             (unsigned)len,
+             control,
+             (unsigned)speed);
     BleFunc_DumpPayload(mcu_payload, len);
 
     /* New spec: 1B control (0..3) as torque level */
     if (len == 1u) {
         if (control > 0x03u) {
-            co_printf("    invalid control(level) ");
+            APP_LOGW("    invalid control(level) ");
             BleFunc_SendResultToRx(reply_cmd, 0x01);
             return;
         }
 #if (!ENABLE_NFC_ADD_SIMULATION)
         {
-            uint8_t conidx            = Protocol_Get_Rx_Conidx();
-            s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_GEAR_SET_FD;
-            s_mcu_pending.chain_step  = 0u;
-            s_mcu_pending.chain_u8_0  = speed;
-            s_mcu_pending.chain_u16_0 = (uint16_t)CMD_High_speed_gear_speed_set;
-            BleFunc_McuTxn_Start(conidx,
+            uint8_t                conidx = Protocol_Get_Rx_Conidx();
+            blefunc_mcu_seq_args_t args   = {0};
+            args.u8[0]                    = speed;
+            BleFunc_McuSeq_Start(conidx,
                                  reply_cmd,
                                  BLEFUNC_MCU_FEATURE,
-                                 (uint16_t)CMD_High_speed_gear_on,
-                                 NULL,
-                                 0u);
+                                 &s_seq_gear_high,
+                                 &args);
         }
 #else
         {
@@ -3843,7 +3979,7 @@ void BleFunc_FD_SetSportMode(uint16_t       cmd,
                                      (uint16_t)CMD_High_speed_gear_speed_set,
                                      &speed,
                                      1u);
-            co_printf("[DEBUG_SIM] FD SPORT split send Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD SPORT split send Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3853,17 +3989,14 @@ void BleFunc_FD_SetSportMode(uint16_t       cmd,
     if (control == 0x01u) {
 #if (!ENABLE_NFC_ADD_SIMULATION)
         {
-            uint8_t conidx            = Protocol_Get_Rx_Conidx();
-            s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_GEAR_SET_FD;
-            s_mcu_pending.chain_step  = 0u;
-            s_mcu_pending.chain_u8_0  = speed;
-            s_mcu_pending.chain_u16_0 = (uint16_t)CMD_High_speed_gear_speed_set;
-            BleFunc_McuTxn_Start(conidx,
+            uint8_t                conidx = Protocol_Get_Rx_Conidx();
+            blefunc_mcu_seq_args_t args   = {0};
+            args.u8[0]                    = speed;
+            BleFunc_McuSeq_Start(conidx,
                                  reply_cmd,
                                  BLEFUNC_MCU_FEATURE,
-                                 (uint16_t)CMD_High_speed_gear_on,
-                                 NULL,
-                                 0u);
+                                 &s_seq_gear_high,
+                                 &args);
         }
 #else
         {
@@ -3875,7 +4008,7 @@ void BleFunc_FD_SetSportMode(uint16_t       cmd,
                                      (uint16_t)CMD_High_speed_gear_speed_set,
                                      &speed,
                                      1u);
-            co_printf("[DEBUG_SIM] FD SPORT split send Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD SPORT split send Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3898,7 +4031,7 @@ void BleFunc_FD_SetSportMode(uint16_t       cmd,
                                      (uint16_t)CMD_High_speed_gear_off,
                                      NULL,
                                      0u);
-            co_printf("[DEBUG_SIM] FD SPORT off Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD SPORT off Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
@@ -3921,14 +4054,14 @@ void BleFunc_FD_SetSportMode(uint16_t       cmd,
                                      (uint16_t)CMD_High_speed_gear_default,
                                      NULL,
                                      0u);
-            co_printf("[DEBUG_SIM] FD SPORT default Success (0x00) ");
+            APP_LOGI("[DEBUG_SIM] FD SPORT default Success (0x00) ");
             BleFunc_SendResultToRx(reply_cmd, 0x00);
         }
 #endif
         return;
     }
 
-    co_printf("    invalid control ");
+    APP_LOGW("    invalid control ");
     BleFunc_SendResultToRx(reply_cmd, 0x01);
 }
 
@@ -3941,19 +4074,19 @@ void BleFunc_FD_SetSportMode(uint16_t       cmd,
  * - Response Payload: ResultCode(1)
  */
 void BleFunc_FD_SetLostMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> FD Set Lost Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Lost Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x0F02 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -3968,7 +4101,7 @@ void BleFunc_FD_SetLostMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -3984,19 +4117,19 @@ void BleFunc_FD_SetLostMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FD_SetTcsSwitch(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> FD Set TCS Switch (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set TCS Switch (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1002 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -4011,7 +4144,7 @@ void BleFunc_FD_SetTcsSwitch(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -4027,19 +4160,19 @@ void BleFunc_FD_SetTcsSwitch(uint16_t       cmd,
 void BleFunc_FD_SetSideStand(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> FD Set Side Stand (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Side Stand (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 7) {
-        co_printf("    invalid payload len=%d (expect 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    control=0x%02X ", payload[6]);
+    APP_LOGI("    control=0x%02X ", payload[6]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1102 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -4054,7 +4187,7 @@ void BleFunc_FD_SetSideStand(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -4070,19 +4203,19 @@ void BleFunc_FD_SetSideStand(uint16_t       cmd,
 void BleFunc_FD_SetBatteryParameter(uint16_t       cmd,
                                     const uint8_t* payload,
                                     uint8_t        len) {
-    co_printf("  -> FD Set Battery Param (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Battery Param (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len != 8) {
-        co_printf("    invalid payload len=%d (expect 8) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 8) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     BleFunc_PrintTime6(&payload[0]);
-    co_printf("    type=0x%02X capacity=0x%02X ", payload[6], payload[7]);
+    APP_LOGI("    type=0x%02X capacity=0x%02X ", payload[6], payload[7]);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1202 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -4097,7 +4230,7 @@ void BleFunc_FD_SetBatteryParameter(uint16_t       cmd,
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -4112,13 +4245,13 @@ void BleFunc_FD_SetBatteryParameter(uint16_t       cmd,
 void BleFunc_FD_SetUpdataApp(uint16_t       cmd,
                              const uint8_t* payload,
                              uint8_t        len) {
-    co_printf("  -> FD Update APP / Data Sync (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Update APP / Data Sync (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
 
     if (payload == NULL || len < 6) {
-        co_printf("    invalid payload len=%d (min 6) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (min 6) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -4136,12 +4269,12 @@ void BleFunc_FD_SetUpdataApp(uint16_t       cmd,
  * - Response Cmd: 0x1402
  */
 void BleFunc_FD_SetHdcMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> FD Set HDC Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set HDC Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -4149,12 +4282,12 @@ void BleFunc_FD_SetHdcMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     BleFunc_PrintTime6(&payload[0]);
     uint8_t control = payload[6];
     if (control != 0x00u && control != 0x01u) {
-        co_printf("    invalid control=0x%02X ", control);
+        APP_LOGW("    invalid control=0x%02X ", control);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
-    co_printf("    control=0x%02X ", control);
+    APP_LOGI("    control=0x%02X ", control);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1402 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -4169,7 +4302,7 @@ void BleFunc_FD_SetHdcMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -4182,12 +4315,12 @@ void BleFunc_FD_SetHdcMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
  * - Response Cmd: 0x1502
  */
 void BleFunc_FD_SetHhcMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> FD Set HHC Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set HHC Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -4195,12 +4328,12 @@ void BleFunc_FD_SetHhcMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     BleFunc_PrintTime6(&payload[0]);
     uint8_t control = payload[6];
     if (control != 0x00u && control != 0x01u) {
-        co_printf("    invalid control=0x%02X ", control);
+        APP_LOGW("    invalid control=0x%02X ", control);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
-    co_printf("    control=0x%02X ", control);
+    APP_LOGI("    control=0x%02X ", control);
     BleFunc_DumpPayload(payload, len);
 /* 下发�?MCU，并等待回包/超时再回 0x1502 */
 #if (!ENABLE_NFC_ADD_SIMULATION)
@@ -4215,7 +4348,7 @@ void BleFunc_FD_SetHhcMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, cmd, payload, (uint16_t)len);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -4230,7 +4363,7 @@ void BleFunc_FD_SetHhcMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FD_SetStartAbility(uint16_t       cmd,
                                 const uint8_t* payload,
                                 uint8_t        len) {
-    co_printf("  -> FD Set Start Ability (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Start Ability (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
@@ -4247,7 +4380,7 @@ void BleFunc_FD_SetStartAbility(uint16_t       cmd,
      * 下发�?
      */
     if (payload == NULL || len != 8) {
-        co_printf("    invalid payload len=%d (expect 8) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect 8) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -4255,7 +4388,7 @@ void BleFunc_FD_SetStartAbility(uint16_t       cmd,
     BleFunc_PrintTime6(&payload[0]);
     uint8_t control  = payload[6];
     uint8_t strength = payload[7];
-    co_printf("    control=0x%02X strength=0x%02X ", control, strength);
+    APP_LOGI("    control=0x%02X strength=0x%02X ", control, strength);
     BleFunc_DumpPayload(payload, len);
 
     uint8_t mcu_data[2];
@@ -4277,7 +4410,7 @@ void BleFunc_FD_SetStartAbility(uint16_t       cmd,
                              (uint16_t)CMD_Starting_strength_set,
                              mcu_data,
                              (uint16_t)sizeof(mcu_data));
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -4292,12 +4425,12 @@ void BleFunc_FD_SetStartAbility(uint16_t       cmd,
 void BleFunc_FD_SetSportPowerSpeed(uint16_t       cmd,
                                    const uint8_t* payload,
                                    uint8_t        len) {
-    co_printf("  -> FD Set Sport Power Speed (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Sport Power Speed (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -4308,14 +4441,14 @@ void BleFunc_FD_SetSportPowerSpeed(uint16_t       cmd,
     BleFunc_StripTime6_ForMcu(&mcu_payload, &temp_len);
     len = (uint8_t)temp_len;
     if (len < 1u) {
-        co_printf("    invalid payload len after strip=%u (expect >= 1) ",
-                  (unsigned)len);
+        APP_LOGW("    invalid payload len after strip=%u (expect >= 1) ",
+                 (unsigned)len);
         BleFunc_DumpPayload(mcu_payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     uint8_t speed = mcu_payload[0];
-    co_printf("    speed=%u ", (unsigned)speed);
+    APP_LOGI("    speed=%u ", (unsigned)speed);
     BleFunc_DumpPayload(mcu_payload, len);
 #if (!ENABLE_NFC_ADD_SIMULATION)
     {
@@ -4330,7 +4463,7 @@ void BleFunc_FD_SetSportPowerSpeed(uint16_t       cmd,
 #else
     BleFunc_McuUart_SendOnly(
         BLEFUNC_MCU_FEATURE, (uint16_t)CMD_SPORT_mode_type_set, &speed, 1u);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -4343,12 +4476,12 @@ void BleFunc_FD_SetSportPowerSpeed(uint16_t       cmd,
  * - Response Cmd: 0x1802
  */
 void BleFunc_FD_SetEcoMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
-    co_printf("  -> FD Set ECO Mode (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set ECO Mode (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -4359,14 +4492,14 @@ void BleFunc_FD_SetEcoMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
     BleFunc_StripTime6_ForMcu(&mcu_payload, &temp_len);
     len = (uint8_t)temp_len;
     if (len < 1u) {
-        co_printf("    invalid payload len after strip=%u (expect >= 1) ",
-                  (unsigned)len);
+        APP_LOGW("    invalid payload len after strip=%u (expect >= 1) ",
+                 (unsigned)len);
         BleFunc_DumpPayload(mcu_payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     uint8_t speed = mcu_payload[0];
-    co_printf("    speed=%u ", (unsigned)speed);
+    APP_LOGI("    speed=%u ", (unsigned)speed);
     BleFunc_DumpPayload(mcu_payload, len);
 #if (!ENABLE_NFC_ADD_SIMULATION)
     {
@@ -4381,7 +4514,7 @@ void BleFunc_FD_SetEcoMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 #else
     BleFunc_McuUart_SendOnly(
         BLEFUNC_MCU_FEATURE, (uint16_t)CMD_ECO_mode_type_set, &speed, 1u);
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
@@ -4396,12 +4529,12 @@ void BleFunc_FD_SetEcoMode(uint16_t cmd, const uint8_t* payload, uint8_t len) {
 void BleFunc_FD_SetRadarSwitch(uint16_t       cmd,
                                const uint8_t* payload,
                                uint8_t        len) {
-    co_printf("  -> FD Set Radar Switch (0x%04X) ", cmd);
+    APP_LOGI("  -> FD Set Radar Switch (0x%04X) ", cmd);
     uint16_t reply_cmd = BleFunc_MakeReplyCmd_FD(cmd);
     if (!BleFunc_EnsureAuthed(reply_cmd))
         return;
     if (payload == NULL || len < 7) {
-        co_printf("    invalid payload len=%d (expect >= 7) ", (int)len);
+        APP_LOGW("    invalid payload len=%d (expect >= 7) ", (int)len);
         BleFunc_DumpPayload(payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -4412,8 +4545,8 @@ void BleFunc_FD_SetRadarSwitch(uint16_t       cmd,
     BleFunc_StripTime6_ForMcu(&mcu_payload, &temp_len);
     len = (uint8_t)temp_len;
     if (len < 1u) {
-        co_printf("    invalid payload len after strip=%u (expect >= 1) ",
-                  (unsigned)len);
+        APP_LOGW("    invalid payload len after strip=%u (expect >= 1) ",
+                 (unsigned)len);
         BleFunc_DumpPayload(mcu_payload, len);
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
@@ -4421,10 +4554,10 @@ void BleFunc_FD_SetRadarSwitch(uint16_t       cmd,
     uint8_t control         = mcu_payload[0];
     bool    has_sensitivity = (len >= 2u);
     uint8_t sensitivity     = has_sensitivity ? mcu_payload[1] : 0u;
-    co_printf("    control=0x%02X sensitivity=0x%02X%s ",
-              (unsigned)control,
-              (unsigned)sensitivity,
-              has_sensitivity ? "" : " (n/a)");
+    APP_LOGI("    control=0x%02X sensitivity=0x%02X%s ",
+             (unsigned)control,
+             (unsigned)sensitivity,
+             has_sensitivity ? "" : " (n/a)");
     BleFunc_DumpPayload(mcu_payload, len);
 
     uint16_t switch_cmd = 0u;
@@ -4435,27 +4568,25 @@ void BleFunc_FD_SetRadarSwitch(uint16_t       cmd,
     else if (control == 0x02u)
         switch_cmd = (uint16_t)CMD_Radar_switch_default;
     if (switch_cmd == 0u) {
-        co_printf("    invalid control ");
+        APP_LOGW("    invalid control ");
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
     if (has_sensitivity && sensitivity > 0x02u) {
-        co_printf("    invalid sensitivity ");
+        APP_LOGW("    invalid sensitivity ");
         BleFunc_SendResultToRx(reply_cmd, 0x01);
         return;
     }
 
 #if (!ENABLE_NFC_ADD_SIMULATION)
     {
-        uint8_t conidx = Protocol_Get_Rx_Conidx();
-        if (has_sensitivity) {
-            s_mcu_pending.chain_kind  = BLEFUNC_MCU_CHAIN_RADAR_SET_FD;
-            s_mcu_pending.chain_step  = 0u;
-            s_mcu_pending.chain_u8_0  = sensitivity;
-            s_mcu_pending.chain_u16_0 = (uint16_t)CMD_Radar_sensitivity_set;
-        }
-        BleFunc_McuTxn_Start(
-            conidx, reply_cmd, BLEFUNC_MCU_FEATURE, switch_cmd, NULL, 0u);
+        uint8_t                conidx = Protocol_Get_Rx_Conidx();
+        blefunc_mcu_seq_args_t args   = {0};
+        args.id0                      = switch_cmd;
+        args.u8[0]                    = sensitivity;
+        args.skip_mask                = has_sensitivity ? 0u : (1u << 1);
+        BleFunc_McuSeq_Start(
+            conidx, reply_cmd, BLEFUNC_MCU_FEATURE, &s_seq_radar, &args);
     }
 #else
     BleFunc_McuUart_SendOnly(BLEFUNC_MCU_FEATURE, switch_cmd, NULL, 0u);
@@ -4465,7 +4596,7 @@ void BleFunc_FD_SetRadarSwitch(uint16_t       cmd,
                                  &sensitivity,
                                  1u);
     }
-    co_printf("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
+    APP_LOGI("[DEBUG_SIM] FD cmd=0x%04X Success (0x00) ", (unsigned)cmd);
     BleFunc_SendResultToRx(reply_cmd, 0x00);
 #endif
 }
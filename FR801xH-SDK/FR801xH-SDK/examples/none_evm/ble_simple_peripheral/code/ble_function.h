@@ -78,6 +78,28 @@ void BleFunc_OnMcuUartFrame(uint16_t       sync,
                             uint16_t       data_len,
                             uint8_t        crc_ok);
 
+/**
+ * @brief MCU 事务统计（只增不减，调用方自行做差分；调试/主机仿真观测用）
+ */
+typedef struct {
+    uint32_t submitted;     /**< 受理的 BLE->MCU 请求数（含被拒；序列本身和每一步各算一次） */
+    uint32_t matched;       /**< 命中在途槽位的 MCU 回包数（序列每步各算一次） */
+    uint32_t timeouts;      /**< 槽位超时次数（含排队中超时） */
+    uint32_t rejected_busy; /**< 槽位满 / 同 (id, conidx) 在途 / 无法排队 / 序列槽满 */
+    uint32_t rejected_err;  /**< 指令映射失败 / 串口发送失败 */
+    uint8_t  max_inflight;  /**< MCU 侧同时未回包帧数峰值 */
+    uint8_t  max_queued;    /**< 发送队列长度峰值 */
+} BleFunc_McuTxnStats_t;
+
+void BleFunc_McuTxn_GetStats(BleFunc_McuTxnStats_t* out);
+
+/**
+ * @brief 预计算 0x01FE 鉴权的期望 Token（MD5 及其 HEX），连接时只做常数时间比较
+ * @note 开机调用一次；T-BOX KEY 改为从 Flash 读取/下发后，拿到新 KEY 时再调用一次
+ * @param key T-BOX KEY；NULL 表示使用内置演示 KEY
+ */
+void BleFunc_Auth_SetKey(const uint8_t* key, uint16_t key_len);
+
 /**
  * @brief RSSI 距离状态变化回调（由 rssi_check 模块触发）
  *
@@ -91,11 +113,12 @@ void BleFunc_RSSI_DistanceChangeCb(uint8_t conidx,
                                    int8_t  raw_rssi);
 
 /**
- * @brief RSSI 采集到就下发 MCU（发送滤波值，不做阈值/距离判定）
+ * @brief RSSI 采样上报入口（滤波值交给 rssi_report 的上报策略）
  *
  * @why
- * - 你要求“不做阈值，但要滤波后直接发”。
- * - 该接口在 GAP_EVT_LINK_RSSI 收到 raw RSSI 后，读取 EMA 滤波结果并下发：FF01/0x0118，payload=1B flt_rssi + 6B MAC。
+ * - 该接口在 GAP_EVT_LINK_RSSI 收到 raw RSSI 后，读取 EMA 滤波结果交给 RSSI_Report_OnSample：
+ *   距离状态变化立即发，其余按死区/最小最大间隔/稳定抑制发，多连接合成一帧。
+ * - 帧格式：FF01/0x0118，payload = N x {1B flt_rssi + 6B MAC}（单连接与旧格式一致）。
  */
 void BleFunc_RSSI_RawInd(uint8_t conidx, int8_t raw_rssi);
 
@@ -0,0 +1,101 @@
+/*********************************************************************
+ * @file conn_ctx.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 连接上下文表 + 组帧块池
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "conn_ctx.h"
+#include "app_log.h"
+
+#include <string.h>
+
+static app_conn_t    s_conn[APP_MAX_CONN];
+static conn_tx_blk_t s_tx_pool[APP_TX_POOL_BLOCKS];
+static uint8_t       s_tx_used[APP_TX_POOL_BLOCKS]; /* 零初始化即是合法的空池 */
+
+/* ACK 模式：连接断开/重连时待确认帧作废，块还回池里 */
+static void conn_tx_release(app_conn_t* c)
+{
+#if PROTOCOL_USE_ACK
+    c->proto.in_flight = false;
+    if (c->proto.retx != NULL)
+    {
+        Conn_TxFree(c->proto.retx);
+        c->proto.retx = NULL;
+    }
+#else
+    (void)c;
+#endif
+}
+
+void Conn_Init(void)
+{
+    memset(s_conn, 0, sizeof(s_conn));
+    memset(s_tx_used, 0, sizeof(s_tx_used));
+}
+
+app_conn_t* Conn_Get(uint8_t conidx)
+{
+    return (conidx < APP_MAX_CONN) ? &s_conn[conidx] : NULL;
+}
+
+void Conn_Open(uint8_t conidx)
+{
+    app_conn_t* c = Conn_Get(conidx);
+    if (c == NULL)
+    {
+        return;
+    }
+    conn_tx_release(c);
+    c->in_use            = true;
+    c->encrypted         = 0;
+    c->rssi_near_latched = 0;
+}
+
+void Conn_Close(uint8_t conidx)
+{
+    app_conn_t* c = Conn_Get(conidx);
+    if (c == NULL)
+    {
+        return;
+    }
+    conn_tx_release(c);
+    c->in_use            = false;
+    c->encrypted         = 0;
+    c->rssi_near_latched = 0;
+}
+
+conn_tx_blk_t* Conn_TxAlloc(void)
+{
+    for (uint8_t i = 0; i < APP_TX_POOL_BLOCKS; i++)
+    {
+        if (s_tx_used[i] == 0u)
+        {
+            s_tx_used[i] = 1u;
+            return &s_tx_pool[i];
+        }
+    }
+    APP_LOGW("Conn: TX pool exhausted\r\n");
+    return NULL;
+}
+
+void Conn_TxFree(conn_tx_blk_t* blk)
+{
+    if (blk == NULL || blk < &s_tx_pool[0] || blk >= &s_tx_pool[APP_TX_POOL_BLOCKS])
+    {
+        return;
+    }
+    s_tx_used[blk - s_tx_pool] = 0u;
+}
+
+uint8_t Conn_TxInUse(void)
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < APP_TX_POOL_BLOCKS; i++)
+    {
+        n = (uint8_t)(n + s_tx_used[i]);
+    }
+    return n;
+}
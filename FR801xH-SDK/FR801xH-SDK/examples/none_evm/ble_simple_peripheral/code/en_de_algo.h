@@ -9,6 +9,7 @@
 #ifndef EN_DE_ALGO_H
 #define EN_DE_ALGO_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -51,6 +52,19 @@ typedef enum {
 #define ALGO_MAX_KEY_LEN 32 /**< 最大密钥长度 (256 bits) */
 #define ALGO_MAX_IV_LEN  16 /**< 最大向量长度 (128 bits) */
 
+/*
+ * 预展开轮密钥池大小（按“不同 Key 的个数”计，不是按连接数）。
+ * 为什么默认 1：当前所有连接共用 s_default_aes_key，一份加/解密轮密钥即可；
+ * 后续若引入“每连接独立 Key”，把它调到最大连接数即可。
+ * 池满时会话自动回退为“每次现算”，功能不受影响，只是慢。
+ */
+#ifndef ALGO_KEYSCHED_NUM
+#define ALGO_KEYSCHED_NUM 1
+#endif
+
+/* 预展开轮密钥（实现细节在 en_de_algo.c，外部只持有指针） */
+struct Algo_KeySched_s;
+
 /**
  * @brief 算法上下文 (动态对象)
  */
@@ -60,6 +74,8 @@ typedef struct Algo_Context_s {
 
     uint8_t key[ALGO_MAX_KEY_LEN]; /**< 密钥存储 */
     uint8_t iv[ALGO_MAX_IV_LEN];   /**< 初始化向量 */
+
+    struct Algo_KeySched_s* sched; /**< 会话预展开轮密钥；NULL=每次现算 */
 } Algo_Context_t;
 
 /* ==================== API 声明 ==================== */
@@ -83,6 +99,40 @@ bool Algo_Bind(Algo_Context_t* ctx, algo_type_t type);
  */
 void Algo_SetKeyIV(Algo_Context_t* ctx, const uint8_t* key, const uint8_t* iv);
 
+/**
+ * @brief 打开一个加解密会话（绑定算法 + 设置密钥 + 一次性预展开轮密钥）
+ *
+ * @why
+ * - Algo_Bind + Algo_SetKeyIV 的临时上下文每帧都要重新做 AES 密钥扩展
+ *   （AES_set_key，解密还要 AES_convert_key），而 Key 在整个连接期间不变。
+ * - 会话把加密/解密两套轮密钥只算一次，收发两个方向复用；相同 Key 的会话
+ *   共享同一份轮密钥，不随连接数成倍占 RAM。
+ *
+ * @param ctx  会话对象（调用方持有，通常按 conidx 静态分配）
+ * @param type 算法类型
+ * @param key  密钥（NONE 时可为 NULL）
+ * @param iv   向量（NULL 表示全 0）
+ * @return true 成功（轮密钥池满时回退为每次现算，仍返回 true）
+ * @return false 不支持的算法类型
+ */
+bool Algo_Session_Open(Algo_Context_t* ctx,
+                       algo_type_t     type,
+                       const uint8_t*  key,
+                       const uint8_t*  iv);
+
+/**
+ * @brief 关闭会话，释放对共享轮密钥的引用（可重复调用）
+ */
+void Algo_Session_Close(Algo_Context_t* ctx);
+
+/**
+ * @brief 会话是否已按指定算法打开
+ */
+static inline bool Algo_Session_IsOpen(const Algo_Context_t* ctx,
+                                       algo_type_t           type) {
+    return (ctx != NULL) && (ctx->ops != NULL) && (ctx->type == type);
+}
+
 /**
  * @brief 执行加密 (内联封装)
  */
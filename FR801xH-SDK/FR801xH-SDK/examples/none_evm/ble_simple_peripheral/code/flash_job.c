@@ -0,0 +1,188 @@
+/*********************************************************************
+ * @file flash_job.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief flash 后台作业队列实现
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "flash_job.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "driver_flash.h"
+#include "flash_usage_config.h"
+#include "idle_hook.h"
+
+#define FLASH_JOB_PAGE 0x100u
+
+#if (FLASH_JOB_ERASE_UNIT != 0x1000u) && (FLASH_JOB_ERASE_UNIT != FLASH_JOB_PAGE)
+#error "FLASH_JOB_ERASE_UNIT must be 0x1000 (sector) or 0x100 (Puya page)"
+#endif
+
+typedef enum
+{
+    FLASH_JOB_OP_ERASE = 0,
+    FLASH_JOB_OP_PROG,
+} flash_job_op_t;
+
+typedef struct
+{
+    uint8_t        op;
+    uint32_t       addr;
+    uint32_t       len;
+    uint32_t       done; /* 已完成字节 */
+    const uint8_t* src;
+    flash_job_cb_t cb;
+    void*          arg;
+} flash_job_t;
+
+static flash_job_t    s_q[FLASH_JOB_QUEUE_LEN];
+static uint8_t        s_head = 0u;
+static uint8_t        s_cnt  = 0u;
+static FlashJob_Stats s_stats;
+
+static bool flash_job_idle(void)
+{
+    return FlashJob_Poll();
+}
+
+static bool flash_job_push(uint8_t op, uint32_t addr, uint32_t len, const uint8_t* src,
+                           flash_job_cb_t cb, void* arg)
+{
+    if (s_cnt >= FLASH_JOB_QUEUE_LEN)
+    {
+        s_stats.rejected++;
+        return false;
+    }
+
+    flash_job_t* j = &s_q[(s_head + s_cnt) % FLASH_JOB_QUEUE_LEN];
+    j->op          = op;
+    j->addr        = addr;
+    j->len         = len;
+    j->done        = 0u;
+    j->src         = src;
+    j->cb          = cb;
+    j->arg         = arg;
+    s_cnt++;
+    s_stats.jobs++;
+    if (s_cnt > s_stats.max_depth)
+    {
+        s_stats.max_depth = s_cnt;
+    }
+
+#if FLASH_JOB_ENABLE
+    IdleHook_Arm(IDLE_HOOK_FLASH, flash_job_idle);
+#else
+    FlashJob_Flush();
+#endif
+    return true;
+}
+
+void FlashJob_Init(void)
+{
+    s_head = 0u;
+    s_cnt  = 0u;
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+bool FlashJob_Erase(uint32_t addr, uint32_t len, flash_job_cb_t cb, void* arg)
+{
+    if (len == 0u || (addr % FLASH_JOB_ERASE_UNIT) != 0u || (len % FLASH_JOB_ERASE_UNIT) != 0u)
+    {
+        return false;
+    }
+    return flash_job_push(FLASH_JOB_OP_ERASE, addr, len, NULL, cb, arg);
+}
+
+bool FlashJob_Program(uint32_t addr, const uint8_t* data, uint32_t len, flash_job_cb_t cb,
+                      void* arg)
+{
+    if (data == NULL || len == 0u)
+    {
+        return false;
+    }
+    return flash_job_push(FLASH_JOB_OP_PROG, addr, len, data, cb, arg);
+}
+
+bool FlashJob_Poll(void)
+{
+    if (s_cnt == 0u)
+    {
+        return false;
+    }
+
+    flash_job_t* j    = &s_q[s_head];
+    uint32_t     addr = j->addr + j->done;
+    uint32_t     n;
+
+#ifdef FLASH_PROTECT
+    flash_protect_disable(1);
+#endif
+    if (j->op == FLASH_JOB_OP_ERASE)
+    {
+        n = FLASH_JOB_ERASE_UNIT;
+#if FLASH_JOB_ERASE_UNIT == FLASH_JOB_PAGE
+        flash_page_erase(addr);
+#else
+        flash_erase(addr, n);
+#endif
+    }
+    else
+    {
+        n = FLASH_JOB_PAGE - (addr % FLASH_JOB_PAGE);
+        if (n > FLASH_JOB_PROG_CHUNK)
+        {
+            n = FLASH_JOB_PROG_CHUNK;
+        }
+        if (n > j->len - j->done)
+        {
+            n = j->len - j->done;
+        }
+        flash_write(addr, n, (uint8_t*)&j->src[j->done]);
+    }
+#ifdef FLASH_PROTECT
+    flash_protect_enable(1);
+#endif
+    s_stats.chunks++;
+
+    j->done += n;
+    if (j->done >= j->len)
+    {
+        /* 先出队再回调：回调里可以接着排下一个作业 */
+        flash_job_cb_t cb  = j->cb;
+        void*          arg = j->arg;
+        s_head             = (uint8_t)((s_head + 1u) % FLASH_JOB_QUEUE_LEN);
+        s_cnt--;
+        if (cb != NULL)
+        {
+            cb(arg);
+        }
+    }
+    return s_cnt != 0u;
+}
+
+void FlashJob_Flush(void)
+{
+    if (s_cnt != 0u)
+    {
+        s_stats.flushes++;
+    }
+    while (FlashJob_Poll())
+    {
+    }
+}
+
+uint8_t FlashJob_Pending(void)
+{
+    return s_cnt;
+}
+
+void FlashJob_GetStats(FlashJob_Stats* out)
+{
+    if (out != NULL)
+    {
+        *out = s_stats;
+    }
+}
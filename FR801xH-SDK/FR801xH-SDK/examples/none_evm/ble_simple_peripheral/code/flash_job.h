@@ -0,0 +1,96 @@
+/*********************************************************************
+ * @file flash_job.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief flash 后台作业队列：擦除/编程拆成小块，在 os 空闲循环里逐块执行
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 片内 flash 擦写期间取指停顿、中断得不到响应：一次 4KB 扇区擦除是几十毫秒，
+ *   放在 GATT 写回调/定时器回调里做，连接事件、UART 接收中断都要跟着等。
+ * - 这里把擦写排进队列，由空闲循环（idle_hook）每轮只做一块：
+ *   编程每块最多 FLASH_JOB_PROG_CHUNK 字节且不跨 256B 页，擦除每块一个
+ *   FLASH_JOB_ERASE_UNIT。空闲循环只在协议栈没有待处理事件时才跑，
+ *   所以每块都落在两次连接事件之间，单次停顿不超过一块的耗时。
+ * - 做完一个作业调完成回调；急用时 FlashJob_Flush 同步做完。
+ *
+ * @note 只在 os 任务上下文调用，不要在中断里排作业。
+ *       FlashJob_Program 的源缓冲区要保持有效，直到完成回调。
+ *********************************************************************/
+
+#ifndef FLASH_JOB_H
+#define FLASH_JOB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* 0：不排队，FlashJob_* 在调用方里同步做完（旧行为，便于对照） */
+#ifndef FLASH_JOB_ENABLE
+#define FLASH_JOB_ENABLE 1
+#endif
+
+/* 同时排队的作业数 */
+#ifndef FLASH_JOB_QUEUE_LEN
+#define FLASH_JOB_QUEUE_LEN 4u
+#endif
+
+/* 编程每块最多多少字节（块不跨 256B 页） */
+#ifndef FLASH_JOB_PROG_CHUNK
+#define FLASH_JOB_PROG_CHUNK 64u
+#endif
+
+/*
+ * 擦除每块的粒度：0x1000 = 扇区擦除（所有 flash 都支持）；
+ * 0x100 = flash_page_erase 页擦除，只有 Puya flash 支持，单块停顿更短。
+ */
+#ifndef FLASH_JOB_ERASE_UNIT
+#define FLASH_JOB_ERASE_UNIT 0x1000u
+#endif
+
+typedef void (*flash_job_cb_t)(void* arg);
+
+typedef struct
+{
+    uint32_t jobs;      /* 累计排队的作业数 */
+    uint32_t chunks;    /* 累计执行的块数 */
+    uint32_t flushes;   /* FlashJob_Flush 时还有作业没做完的次数 */
+    uint32_t rejected;  /* 队列满被拒的作业数 */
+    uint8_t  max_depth; /* 队列最大深度 */
+} FlashJob_Stats;
+
+/**
+ * @brief 清空队列（上电调用；未完成的作业直接丢弃，不调回调）
+ */
+void FlashJob_Init(void);
+
+/**
+ * @brief 排一个擦除作业
+ * @param addr/len 按 FLASH_JOB_ERASE_UNIT 对齐
+ * @param cb 擦完后调用，可为 NULL
+ * @return false：参数未对齐或队列已满
+ */
+bool FlashJob_Erase(uint32_t addr, uint32_t len, flash_job_cb_t cb, void* arg);
+
+/**
+ * @brief 排一个编程作业（目标区域须已擦除）
+ * @return false：队列已满
+ */
+bool FlashJob_Program(uint32_t addr, const uint8_t* data, uint32_t len, flash_job_cb_t cb,
+                      void* arg);
+
+/**
+ * @brief 执行一块
+ * @return 还有没做完的作业
+ */
+bool FlashJob_Poll(void);
+
+/**
+ * @brief 同步做完所有作业
+ */
+void FlashJob_Flush(void);
+
+uint8_t FlashJob_Pending(void);
+
+void FlashJob_GetStats(FlashJob_Stats* out);
+
+#endif // FLASH_JOB_H
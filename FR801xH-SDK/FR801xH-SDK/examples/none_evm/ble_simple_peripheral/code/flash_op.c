@@ -51,6 +51,7 @@ void flash_op_erase_sector(uint32_t addr)
  * @param  addr  目标扇区起始地址，默认使用 TPMS_BINDING_INFO_SAVE_ADDR。
  * @param  info  待写入结构体指针。
  * @note   假定该扇区仅存此结构；若还有其他数据，需先整扇区读出再合并写回。
+ *         需要频繁改写的小数据请放 kv_store（KV_Put/KV_Get），不要再各占一个扇区。
  */
 void flash_op_save_tpms_info(uint32_t addr, tpms_bind_info_t *info)
 {
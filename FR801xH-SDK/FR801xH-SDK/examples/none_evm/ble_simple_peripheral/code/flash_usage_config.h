@@ -57,6 +57,18 @@
     #define FLASH_MAX_SIZE                  0x40000
 #endif	//FOR_2M_FLASH
 
+/**
+ * @brief kv_store 日志区：紧挨在 TPMS 旧绑定扇区之前的 KV_STORE_SECTORS 个 4KB 扇区，轮流使用
+ * @note OTA 双镜像必须整体落在 KV_STORE_BASE_ADDR 之下；
+ *       旧的 TPMS_BINDING_INFO_SAVE_ADDR 扇区只在首次启动迁移时读一次。
+ */
+#ifndef KV_STORE_SECTORS
+	#define KV_STORE_SECTORS                2
+#endif
+#ifndef KV_STORE_BASE_ADDR
+	#define KV_STORE_BASE_ADDR              (TPMS_BINDING_INFO_SAVE_ADDR - KV_STORE_SECTORS * 0x1000)
+#endif
+
 /*
  * uncomment this MACRO if user need protect flash from unexpected erase or write operation
  */
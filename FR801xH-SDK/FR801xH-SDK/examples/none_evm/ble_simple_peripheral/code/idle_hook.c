@@ -0,0 +1,66 @@
+/*********************************************************************
+ * @file idle_hook.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief os 空闲循环分发实现
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "idle_hook.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ll.h"
+#include "os_task.h"
+
+static volatile uint8_t s_armed = 0u;
+static idle_hook_fn_t   s_fn[IDLE_HOOK_NUM];
+
+static void idle_hook_loop(void)
+{
+    uint8_t run;
+
+    /* 先取走再执行：执行期间中断里新登记的会留在 s_armed 里，下一轮再跑 */
+    GLOBAL_INT_DISABLE();
+    run     = s_armed;
+    s_armed = 0u;
+    GLOBAL_INT_RESTORE();
+
+    for (uint8_t i = 0; i < IDLE_HOOK_NUM; i++)
+    {
+        if ((run & (1u << i)) != 0u && s_fn[i] != NULL && s_fn[i]())
+        {
+            IdleHook_Arm((idle_hook_slot_t)i, s_fn[i]);
+        }
+    }
+
+    {
+        GLOBAL_INT_DISABLE();
+        if (s_armed == 0u)
+        {
+            /* 都做完了：摘掉空闲事件，允许系统进入休眠 */
+            os_user_loop_event_clear();
+        }
+        GLOBAL_INT_RESTORE();
+    }
+}
+
+void IdleHook_Arm(idle_hook_slot_t slot, idle_hook_fn_t fn)
+{
+    uint8_t bit = (uint8_t)(1u << slot);
+
+    if (slot >= IDLE_HOOK_NUM || (s_armed & bit) != 0u)
+    {
+        return;
+    }
+
+    GLOBAL_INT_DISABLE();
+    s_fn[slot] = fn;
+    if (s_armed == 0u)
+    {
+        os_user_loop_event_set(idle_hook_loop);
+    }
+    s_armed |= bit;
+    GLOBAL_INT_RESTORE();
+}
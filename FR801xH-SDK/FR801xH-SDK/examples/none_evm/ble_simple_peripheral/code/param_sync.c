@@ -1,260 +1,217 @@
 #include "param_sync.h"
-
 #include "protocol.h"
-
+#include "conn_ctx.h"
 #include "protocol_cmd.h"
-
-#include "co_printf.h"
+#include "app_log.h"
 
 #include <string.h>
 #include "gap_api.h"
 
 /*
-
- * 说明�?
-
- * - 0x64FD �?payload 字段非常多，且文档后半段字段在你发的片段里存在“排�?含义不完整”的情况�?
-
- * - 为了保证 APP 至少能收到“结构正确、长度稳定”的同步帧，这里先按已知字段顺序组包�?
-
- * - 未明确的字段/保留字段默认�?0x00�?
-
+ * 说明：
+ * - 0x64FD 的 payload 按协议文档 6.10 的字段顺序组包（User 档三个字段已被文档删除），
+ *   未明确的字段/保留字段默认 0x00。
+ * - 参数按“字段下标 -> 1 字节值”存成一个带版本号的数组，每个连接一份脏位：
+ *   1) 鉴权后第一次同步（或 App 不认增量帧）发完整 0x64FD 快照；
+ *   2) 之后 MCU 每次上报 0x0208 只比较出变化的字段，用 0x67FD 推 (下标, 值) 对
+ *      （PARAM_SYNC_DELTA_ENABLE，默认关：原版 App 不认 0x67FD，关闭时每次有变化发全量）；
+ *   3) 没有字段变化就什么都不发。
+ * - 以前每次 0x0208 都把 34 字节整块加密推送（AES 3 个分组），而 MCU 周期上报里
+ *   通常只有 0~2 个字段真的变了；增量帧 2+2n 字节，n<=6 时只有 1 个 AES 分组。
  *
-
- * 你后续如果确认了字段长度/顺序，只需要修改这里的打包顺序即可，不用动 ble_function.c�?
-
+ * 后续确认了字段长度/顺序，只需要修改 param_sync_field_t 的顺序，不用动 ble_function.c。
  */
 
-/* 6.10�?x64FD payload（按你提供的表格顺序，单位：byte�?*/
-
-typedef struct {
-
-    // uint8_t userControl;
-
-    // uint8_t userSpeed;
-
-    // uint8_t userMaxTorque;
-
-    uint8_t boosterCartControl;
-
-    uint8_t boosterSpeed;
-
-    uint8_t delayedHeadlightsControl;
-
-    uint8_t delayedHeadlightsDelay;
-
-    uint8_t chargingPower;
-
-    uint8_t autoShiftToPControl;
-
-    uint8_t autoShiftToPDelay;
-
-    uint8_t chordHornSoundSource;
-
-    uint8_t chordHornVolume;
-
-    uint8_t lightingEffects;
-
-    uint8_t gradual;
-
-    uint8_t changliangRgbr;
-
-    uint8_t changliangRgbg;
-
-    uint8_t changliangRgbb;
-
-    uint8_t breatheRgbr;
-
-    uint8_t breatheRgbg;
-
-    uint8_t breatheRgbb;
-
-    uint8_t marqueeRgbr;
-
-    uint8_t marqueeRgbg;
-
-    uint8_t marqueeRgbb;
-
-    uint8_t intelligentSwitch1;
-
-    uint8_t intelligentSwitch2;
-
-    uint8_t reverseControl;
-
-    uint8_t reverseSpeed;
-
-    uint8_t isAlarmArmed;
-
-    uint8_t alarmSensitivity;
-
-    uint8_t alarmVolume;
-
-    uint8_t AutoTurnResetSettings;
-
-    uint8_t ebsSettings;
-
-    uint8_t eSaveModeSettings;
-
-    uint8_t dynModeSettings;
-
-    uint8_t sportModeSettings;
-
-    uint8_t intelligentSwitch3;
-
-    uint8_t intelligentSwitch4;
+/* 6.10：0x64FD payload 字段下标（= 在 payload 中的偏移，单位：byte） */
+typedef enum {
+    PARAM_SYNC_F_BOOSTER_CART_CONTROL = 0,
+    PARAM_SYNC_F_BOOSTER_SPEED,
+    PARAM_SYNC_F_DELAYED_HEADLIGHTS_CONTROL,
+    PARAM_SYNC_F_DELAYED_HEADLIGHTS_DELAY,
+    PARAM_SYNC_F_CHARGING_POWER,
+    PARAM_SYNC_F_AUTO_SHIFT_TO_P_CONTROL,
+    PARAM_SYNC_F_AUTO_SHIFT_TO_P_DELAY,
+    PARAM_SYNC_F_CHORD_HORN_SOUND_SOURCE,
+    PARAM_SYNC_F_CHORD_HORN_VOLUME,
+    PARAM_SYNC_F_LIGHTING_EFFECTS,
+    PARAM_SYNC_F_GRADUAL,
+    PARAM_SYNC_F_CHANGLIANG_RGB_R,
+    PARAM_SYNC_F_CHANGLIANG_RGB_G,
+    PARAM_SYNC_F_CHANGLIANG_RGB_B,
+    PARAM_SYNC_F_BREATHE_RGB_R,
+    PARAM_SYNC_F_BREATHE_RGB_G,
+    PARAM_SYNC_F_BREATHE_RGB_B,
+    PARAM_SYNC_F_MARQUEE_RGB_R,
+    PARAM_SYNC_F_MARQUEE_RGB_G,
+    PARAM_SYNC_F_MARQUEE_RGB_B,
+    PARAM_SYNC_F_INTELLIGENT_SWITCH1,
+    PARAM_SYNC_F_INTELLIGENT_SWITCH2,
+    PARAM_SYNC_F_REVERSE_CONTROL,
+    PARAM_SYNC_F_REVERSE_SPEED,
+    PARAM_SYNC_F_IS_ALARM_ARMED,
+    PARAM_SYNC_F_ALARM_SENSITIVITY,
+    PARAM_SYNC_F_ALARM_VOLUME,
+    PARAM_SYNC_F_AUTO_TURN_RESET_SETTINGS,
+    PARAM_SYNC_F_EBS_SETTINGS,
+    PARAM_SYNC_F_E_SAVE_MODE_SETTINGS,
+    PARAM_SYNC_F_DYN_MODE_SETTINGS,
+    PARAM_SYNC_F_SPORT_MODE_SETTINGS,
+    PARAM_SYNC_F_INTELLIGENT_SWITCH3,
+    PARAM_SYNC_F_INTELLIGENT_SWITCH4,
+    /* 文档里待定的字段：ecoSpeedSetting / startStrengthSetting /
+     * bleUnlockSensitivity(2B) / sportSpeedSetting / ebsStrength，确认后加在这里 */
+    PARAM_SYNC_FIELD_NUM
+} param_sync_field_t;
+
+/* MCU 0x0208 数据段最短长度（后面的字节是保留位）；带 2 字节前缀时为 +2 */
+#define PARAM_SYNC_64FD_LEN (43u)
 
-} param_sync_64fd_t;
+#define PARAM_SYNC_CONN_NUM (APP_MAX_CONN)
 
-static param_sync_64fd_t s_64fd_cache;
+/* 0x67FD 头：version(1) + count(1) */
+#define PARAM_SYNC_DELTA_HDR_LEN (2u)
 
-static uint8_t s_64fd_valid = 0u;
+/* 增量帧不比全量短时直接发全量：2 + 2n < 34 -> n <= 15 */
+#define PARAM_SYNC_DELTA_MAX_FIELDS \
+    ((PARAM_SYNC_FIELD_NUM - PARAM_SYNC_DELTA_HDR_LEN - 1u) / 2u)
 
-static uint8_t s_64fd_pending_mask = 0u;
+typedef char param_sync_mask_check[(PARAM_SYNC_FIELD_NUM <= 64u) ? 1 : -1];
 
-#define PARAM_SYNC_64FD_LEN (43u)
+typedef struct {
+    uint8_t val[PARAM_SYNC_FIELD_NUM];
+    uint8_t valid;   /* 收到过至少一次 0x0208 */
+    uint8_t version; /* 每次有字段变化 +1（回绕），随 0x67FD 下发 */
+} param_sync_store_t;
 
-/* 6.11�?x66FD payload = intelligentSwitch1(车辆状�?1byte) + speed(2byte, 0.1km/h) */
+typedef struct {
+    uint64_t dirty;     /* bit i：字段 i 的新值还没推给这个连接 */
+    uint8_t  synced;    /* 已发过完整快照，可以在它上面叠增量 */
+    uint8_t  full_only; /* App 拒绝过 0x67FD：本连接只发全量 */
+} param_sync_conn_t;
 
-static uint8_t s_66fd_vehicle_status;
+static param_sync_store_t s_64fd_store;
+static param_sync_conn_t  s_64fd_conn[PARAM_SYNC_CONN_NUM];
+static uint8_t            s_64fd_delta_enable = PARAM_SYNC_DELTA_ENABLE;
 
+/* 6.11：0x66FD payload = intelligentSwitch1(车辆状态 1byte) + speed(2byte, 0.1km/h) */
+static uint8_t  s_66fd_vehicle_status;
 static uint16_t s_66fd_speed_01kmh;
 
-/*
-
- * 为什么不�?Protocol_Send_Unicast�?
+static uint8_t ParamSync_MaskCount(uint64_t mask)
+{
+    uint8_t n = 0u;
 
- * - Protocol_Send_Unicast 会优先复�?last_rx_seq（为了“应答回�?seq”）�?
+    while (mask != 0u) {
+        mask &= mask - 1u;
+        n++;
+    }
+    return n;
+}
 
- * - 0x64FD/0x66FD 属于设备主动推送，不应复用上一个请�?seq，否�?APP 可能把它当成上一个请求的应答而丢弃�?
+static bool ParamSync_LinkReady(uint8_t conidx)
+{
+    return Protocol_Auth_IsOk(conidx) && gap_get_connect_status(conidx) != 0;
+}
 
+/*
+ * 为什么不用 Protocol_Send_Unicast：
+ * - Protocol_Send_Unicast 会优先复用 last_rx_seq（为了“应答回同 seq”）；
+ * - 0x64FD/0x66FD/0x67FD 属于设备主动推送，不应复用上一个请求的 seq，否则
+ *   APP 可能把它当成上一个请求的应答而丢弃。
  *
-
- * 因此这里使用 Protocol_Send_Unicast_Async（新加的接口），强制用新�?seq�?
-
+ * 因此这里使用 Protocol_Send_Unicast_Async，强制用新的 seq。
  */
-
-static void ParamSync_Send64FD(uint8_t conidx)
-
+static bool ParamSync_Send64FD(uint8_t conidx)
 {
+    APP_LOGI("[PARAM_SYNC] TX 0x64FD conidx=%u len=%u ver=%u\r\n",
+             (unsigned)conidx,
+             (unsigned)PARAM_SYNC_FIELD_NUM,
+             (unsigned)s_64fd_store.version);
+
+    /* 存储顺序就是 payload 顺序，整块发出 */
+    return Protocol_Send_Unicast_Async(conidx,
+                                       paramter_synchronize,
+                                       s_64fd_store.val,
+                                       (uint16_t)PARAM_SYNC_FIELD_NUM) == 0;
+}
 
-    uint8_t payload[64];
-
-    uint16_t i = 0;
-
-    memset(payload, 0, sizeof(payload));
-
-    /* 按结构体顺序逐字节打包，确保 payload 顺序稳定 */
-
-    // payload[i++] = s_64fd_cache.userControl;
-
-    // payload[i++] = s_64fd_cache.userSpeed;
-
-    // payload[i++] = s_64fd_cache.userMaxTorque;
-
-    payload[i++] = s_64fd_cache.boosterCartControl;
-
-    payload[i++] = s_64fd_cache.boosterSpeed;
-
-    payload[i++] = s_64fd_cache.delayedHeadlightsControl;
-
-    payload[i++] = s_64fd_cache.delayedHeadlightsDelay;
-
-    payload[i++] = s_64fd_cache.chargingPower;
-
-    payload[i++] = s_64fd_cache.autoShiftToPControl;
-
-    payload[i++] = s_64fd_cache.autoShiftToPDelay;
-
-    payload[i++] = s_64fd_cache.chordHornSoundSource;
-
-    payload[i++] = s_64fd_cache.chordHornVolume;
-
-    payload[i++] = s_64fd_cache.lightingEffects;
-
-    payload[i++] = s_64fd_cache.gradual;
-
-    payload[i++] = s_64fd_cache.changliangRgbr;
-
-    payload[i++] = s_64fd_cache.changliangRgbg;
-
-    payload[i++] = s_64fd_cache.changliangRgbb;
-
-    payload[i++] = s_64fd_cache.breatheRgbr;
-
-    payload[i++] = s_64fd_cache.breatheRgbg;
-
-    payload[i++] = s_64fd_cache.breatheRgbb;
-
-    payload[i++] = s_64fd_cache.marqueeRgbr;
-
-    payload[i++] = s_64fd_cache.marqueeRgbg;
-
-    payload[i++] = s_64fd_cache.marqueeRgbb;
-
-    payload[i++] = s_64fd_cache.intelligentSwitch1;
-
-    payload[i++] = s_64fd_cache.intelligentSwitch2;
-
-    payload[i++] = s_64fd_cache.reverseControl;
-
-    payload[i++] = s_64fd_cache.reverseSpeed;
-
-    payload[i++] = s_64fd_cache.isAlarmArmed;
-
-    payload[i++] = s_64fd_cache.alarmSensitivity;
-
-    payload[i++] = s_64fd_cache.alarmVolume;
-
-    payload[i++] = s_64fd_cache.AutoTurnResetSettings;
-
-    payload[i++] = s_64fd_cache.ebsSettings;
-
-    payload[i++] = s_64fd_cache.eSaveModeSettings;
-
-    payload[i++] = s_64fd_cache.dynModeSettings;
-
-    payload[i++] = s_64fd_cache.sportModeSettings;
-
-    payload[i++] = s_64fd_cache.intelligentSwitch3;
-
-    payload[i++] = s_64fd_cache.intelligentSwitch4;
-
-    // payload[i++] = s_64fd_cache.ecoSpeedSetting;
+/*
+ * 0x67FD payload = version + count + count * {fieldIndex, value}
+ * 直接拼在组帧块的数据段里（Protocol_Tx_Begin），不经过栈上中转数组。
+ */
+static bool ParamSync_Send67FD(uint8_t conidx, uint64_t mask)
+{
+    uint8_t* payload = Protocol_Tx_Begin();
+    uint16_t i       = PARAM_SYNC_DELTA_HDR_LEN;
 
-    // payload[i++] = s_64fd_cache.startStrengthSetting;
+    if (payload == NULL) {
+        return false;
+    }
+    payload[0] = s_64fd_store.version;
+    while (mask != 0u) {
+        uint8_t f = 0u;
+        while ((mask & ((uint64_t)1u << f)) == 0u) {
+            f++;
+        }
+        mask &= mask - 1u;
+        payload[i++] = f;
+        payload[i++] = s_64fd_store.val[f];
+    }
+    payload[1] = (uint8_t)((i - PARAM_SYNC_DELTA_HDR_LEN) / 2u);
 
-    // payload[i++] = (uint8_t)(s_64fd_cache.bleUnlockSensitivity & 0xFFu);
+    APP_LOGI("[PARAM_SYNC] TX 0x67FD conidx=%u fields=%u ver=%u\r\n",
+             (unsigned)conidx,
+             (unsigned)payload[1],
+             (unsigned)payload[0]);
 
-    // payload[i++] = (uint8_t)((s_64fd_cache.bleUnlockSensitivity >> 8) & 0xFFu);
+    return Protocol_Tx_Commit(conidx, paramter_synchronize_delta, payload, i, true) == 0;
+}
 
-    // payload[i++] = s_64fd_cache.sportSpeedSetting;
+/*
+ * 把该连接欠下的参数推出去：
+ * - 还没有基线（刚鉴权 / App 要求重同步 / 本连接只认全量 / 增量关闭）且有变化 -> 全量；
+ * - 变化字段太多（增量不比全量短）-> 全量；
+ * - 其余 -> 增量。
+ * 发送失败时脏位保留，下一次 0x0208 或重新鉴权时一起补发。
+ */
+static void ParamSync_Flush64FD(uint8_t conidx)
+{
+    param_sync_conn_t* c = &s_64fd_conn[conidx];
 
-    // payload[i++] = s_64fd_cache.ebsStrength;
+    if (s_64fd_store.valid == 0u) {
+        return;
+    }
+    if (c->synced != 0u && c->dirty == 0u) {
+        return;
+    }
 
-    co_printf("[PARAM_SYNC] TX 0x64FD conidx=%u len=%u\\r\\n",
-              (unsigned)conidx,
-              (unsigned)i);
+    if (c->synced == 0u || c->full_only != 0u || s_64fd_delta_enable == 0u ||
+        ParamSync_MaskCount(c->dirty) > PARAM_SYNC_DELTA_MAX_FIELDS) {
+        if (ParamSync_Send64FD(conidx)) {
+            c->synced = 1u;
+            c->dirty  = 0u;
+        }
+        return;
+    }
 
-    (void)Protocol_Send_Unicast_Async(conidx, paramter_synchronize, payload, i);
+    if (ParamSync_Send67FD(conidx, c->dirty)) {
+        c->dirty = 0u;
+    }
 }
 
 static void ParamSync_Send66FD(uint8_t conidx)
-
 {
-
     uint8_t payload[3];
 
     payload[0] = s_66fd_vehicle_status;
-
     payload[1] = (uint8_t)(s_66fd_speed_01kmh & 0xFFu);
-
     payload[2] = (uint8_t)((s_66fd_speed_01kmh >> 8) & 0xFFu);
 
-    co_printf("[PARAM_SYNC] TX 0x66FD conidx=%u status=0x%02X "
-              "speed=%u(0.1km/h)\\r\\n",
-              (unsigned)conidx,
-              (unsigned)payload[0],
-              (unsigned)s_66fd_speed_01kmh);
+    APP_LOGI("[PARAM_SYNC] TX 0x66FD conidx=%u status=0x%02X "
+             "speed=%u(0.1km/h)\r\n",
+             (unsigned)conidx,
+             (unsigned)payload[0],
+             (unsigned)s_66fd_speed_01kmh);
 
     (void)Protocol_Send_Unicast_Async(conidx,
                                       paramter_synchronize_change,
@@ -262,209 +219,98 @@ static void ParamSync_Send66FD(uint8_t conidx)
                                       (uint16_t)sizeof(payload));
 }
 
-static bool ParamSync_Update64FD(const uint8_t* data, uint16_t len)
-
+/**
+ * @brief 用 MCU 0x0208 更新存储
+ * @param changed [out] 变化字段位图（第一次收到时为全部字段）
+ * @return false：长度不足，存储未改动
+ */
+static bool ParamSync_Update64FD(const uint8_t* data, uint16_t len, uint64_t* changed)
 {
+    uint64_t mask = 0u;
+    uint16_t i    = 0u;
 
     if (data == NULL) {
-
         return false;
     }
-
-    uint16_t i = 0;
-
     if (len == (uint16_t)(PARAM_SYNC_64FD_LEN + 2u)) {
-
         i = 2u;
-
     } else if (len < PARAM_SYNC_64FD_LEN) {
-
         return false;
     }
 
-    // s_64fd_cache.userControl = data[i++];
-
-    // s_64fd_cache.userSpeed = data[i++];
-
-    // s_64fd_cache.userMaxTorque = data[i++];
-
-    s_64fd_cache.boosterCartControl = data[i++];
-
-    s_64fd_cache.boosterSpeed = data[i++];
-
-    s_64fd_cache.delayedHeadlightsControl = data[i++];
-
-    s_64fd_cache.delayedHeadlightsDelay = data[i++];
-
-    s_64fd_cache.chargingPower = data[i++];
-
-    s_64fd_cache.autoShiftToPControl = data[i++];
-
-    s_64fd_cache.autoShiftToPDelay = data[i++];
-
-    s_64fd_cache.chordHornSoundSource = data[i++];
-
-    s_64fd_cache.chordHornVolume = data[i++];
-
-    s_64fd_cache.lightingEffects = data[i++];
-
-    s_64fd_cache.gradual = data[i++];
-
-    s_64fd_cache.changliangRgbr = data[i++];
-
-    s_64fd_cache.changliangRgbg = data[i++];
-
-    s_64fd_cache.changliangRgbb = data[i++];
-
-    s_64fd_cache.breatheRgbr = data[i++];
-
-    s_64fd_cache.breatheRgbg = data[i++];
-
-    s_64fd_cache.breatheRgbb = data[i++];
-
-    s_64fd_cache.marqueeRgbr = data[i++];
-
-    s_64fd_cache.marqueeRgbg = data[i++];
-
-    s_64fd_cache.marqueeRgbb = data[i++];
-
-    s_64fd_cache.intelligentSwitch1 = data[i++];
-
-    s_64fd_cache.intelligentSwitch2 = data[i++];
-
-    s_64fd_cache.reverseControl = data[i++];
-
-    s_64fd_cache.reverseSpeed = data[i++];
-
-    s_64fd_cache.isAlarmArmed = data[i++];
-
-    s_64fd_cache.alarmSensitivity = data[i++];
-
-    s_64fd_cache.alarmVolume = data[i++];
-
-    s_64fd_cache.AutoTurnResetSettings = data[i++];
-
-    s_64fd_cache.ebsSettings = data[i++];
-
-    s_64fd_cache.eSaveModeSettings = data[i++];
-
-    s_64fd_cache.dynModeSettings = data[i++];
-
-    s_64fd_cache.sportModeSettings = data[i++];
-
-    s_64fd_cache.intelligentSwitch3 = data[i++];
-
-    s_64fd_cache.intelligentSwitch4 = data[i++];
-
-    // s_64fd_cache.ecoSpeedSetting = data[i++];
-
-    // s_64fd_cache.startStrengthSetting = data[i++];
-
-    // s_64fd_cache.bleUnlockSensitivity =
-    //     (uint16_t)((uint16_t)data[i] | ((uint16_t)data[i + 1] << 8));
-
-    // i = (uint16_t)(i + 2u);
-
-    // s_64fd_cache.sportSpeedSetting = data[i++];
-
-    // s_64fd_cache.ebsStrength = data[i++];
-
-    s_64fd_valid = 1u;
-
+    data += i;
+    for (uint8_t f = 0u; f < PARAM_SYNC_FIELD_NUM; f++) {
+        if (s_64fd_store.val[f] != data[f]) {
+            s_64fd_store.val[f] = data[f];
+            mask |= (uint64_t)1u << f;
+        }
+    }
+    if (s_64fd_store.valid == 0u) {
+        s_64fd_store.valid = 1u;
+        mask = ((uint64_t)1u << PARAM_SYNC_FIELD_NUM) - 1u;
+    }
+    if (mask != 0u) {
+        s_64fd_store.version++;
+    }
+    *changed = mask;
     return true;
 }
 
 void ParamSync_OnMcuSync64FD(const uint8_t* data, uint16_t len)
-
 {
+    uint64_t changed = 0u;
 
-    if (!ParamSync_Update64FD(data, len)) {
-
-        co_printf("[PARAM_SYNC] RX 0x0208 len=%u (short)\r\n", (unsigned)len);
-
+    if (!ParamSync_Update64FD(data, len, &changed)) {
+        APP_LOGW("[PARAM_SYNC] RX 0x0208 len=%u (short)\r\n", (unsigned)len);
         return;
     }
 
-    co_printf("[PARAM_SYNC] RX 0x0208 len=%u\r\n", (unsigned)len);
-
-    for (uint8_t conidx = 0; conidx < 3u; conidx++) {
-
-        if (!Protocol_Auth_IsOk(conidx)) {
-
-            continue;
-        }
-
-        if (gap_get_connect_status(conidx) == 0) {
+    APP_LOGD("[PARAM_SYNC] RX 0x0208 len=%u changed=%u ver=%u\r\n",
+             (unsigned)len,
+             (unsigned)ParamSync_MaskCount(changed),
+             (unsigned)s_64fd_store.version);
 
+    for (uint8_t conidx = 0; conidx < PARAM_SYNC_CONN_NUM; conidx++) {
+        if (!ParamSync_LinkReady(conidx)) {
             continue;
         }
-
-        if ((s_64fd_pending_mask & (uint8_t)(1u << conidx)) != 0u) {
-
-            ParamSync_Send64FD(conidx);
-
-            s_64fd_pending_mask &=
-
-                (uint8_t)~(uint8_t)(1u << conidx);
-        }
+        s_64fd_conn[conidx].dirty |= changed;
+        ParamSync_Flush64FD(conidx);
     }
 }
 
 void ParamSync_OnBleAuthed(uint8_t conidx)
-
 {
-
-    /* ֻ�����������Ѽ�Ȩ conidx ��������δ��¼�����յ�ҵ��֡ */
-
-    if (!Protocol_Auth_IsOk(conidx)) {
-
+    /* 只给当前连接且已鉴权的 conidx 发，避免未登录就收到业务帧 */
+    if (conidx >= PARAM_SYNC_CONN_NUM || !ParamSync_LinkReady(conidx)) {
         return;
     }
 
-    if (gap_get_connect_status(conidx) == 0) {
-
-        return;
-    }
-
-    /* 0x64FD wait MCU 0x0208 then sync */
-
-    if (s_64fd_valid != 0u) {
-
-        ParamSync_Send64FD(conidx);
-
-    } else {
-
-        s_64fd_pending_mask |= (uint8_t)(1u << conidx);
-    }
+    /* 新会话：丢掉上一个连接残留的状态，重新从全量快照开始；
+     * 还没收到过 0x0208 时等 MCU 上报后由 ParamSync_OnMcuSync64FD 补发 */
+    memset(&s_64fd_conn[conidx], 0, sizeof(s_64fd_conn[conidx]));
+    ParamSync_Flush64FD(conidx);
 
     ParamSync_Send66FD(conidx);
 }
 
+void ParamSync_SetDeltaMode(bool enable)
+{
+    s_64fd_delta_enable = enable ? 1u : 0u;
+}
+
 void ParamSync_NotifyChange(uint8_t  intelligentSwitch1_vehicleStatus,
                             uint16_t speed_01kmh)
-
 {
-
     /* 更新缓存 */
-
     s_66fd_vehicle_status = intelligentSwitch1_vehicleStatus;
-
-    s_66fd_speed_01kmh = speed_01kmh;
+    s_66fd_speed_01kmh    = speed_01kmh;
 
     /* 变化同步：推给所有已鉴权连接 */
-
-    for (uint8_t conidx = 0; conidx < 3u; conidx++) {
-
-        if (!Protocol_Auth_IsOk(conidx)) {
-
+    for (uint8_t conidx = 0; conidx < PARAM_SYNC_CONN_NUM; conidx++) {
+        if (!ParamSync_LinkReady(conidx)) {
             continue;
         }
-
-        if (gap_get_connect_status(conidx) == 0) {
-
-            continue;
-        }
-
         ParamSync_Send66FD(conidx);
     }
 }
@@ -473,38 +319,43 @@ void ParamSync_OnAppReply(uint8_t        conidx,
                           uint16_t       cmd,
                           const uint8_t* payload,
                           uint8_t        len)
-
 {
-
     uint8_t rc = 0xFFu;
 
     if (payload != NULL && len >= 1u) {
-
         rc = payload[0];
     }
 
     if (cmd == (uint16_t)0x6402u) {
-
-        co_printf("[PARAM_SYNC] RX 0x6402 conidx=%u rc=0x%02X\\r\\n",
-                  (unsigned)conidx,
-                  (unsigned)rc);
-
+        APP_LOGI("[PARAM_SYNC] RX 0x6402 conidx=%u rc=0x%02X\r\n",
+                 (unsigned)conidx,
+                 (unsigned)rc);
         return;
     }
 
     if (cmd == (uint16_t)0x6602u) {
-
-        co_printf("[PARAM_SYNC] RX 0x6602 conidx=%u rc=0x%02X\\r\\n",
-                  (unsigned)conidx,
-                  (unsigned)rc);
-
+        APP_LOGI("[PARAM_SYNC] RX 0x6602 conidx=%u rc=0x%02X\r\n",
+                 (unsigned)conidx,
+                 (unsigned)rc);
         return;
     }
 
-    /* 其他 0x??02 暂不处理，仅打日�?*/
+    if (cmd == (uint16_t)0x6702u) {
+        APP_LOGI("[PARAM_SYNC] RX 0x6702 conidx=%u rc=0x%02X\r\n",
+                 (unsigned)conidx,
+                 (unsigned)rc);
+        /* App 不认增量（老版本 / 版本号对不上）：本连接退回全量并立即重同步 */
+        if (rc != 0u && conidx < PARAM_SYNC_CONN_NUM && ParamSync_LinkReady(conidx)) {
+            s_64fd_conn[conidx].full_only = 1u;
+            s_64fd_conn[conidx].synced    = 0u;
+            ParamSync_Flush64FD(conidx);
+        }
+        return;
+    }
 
-    co_printf("[PARAM_SYNC] RX 0x%04X conidx=%u len=%u\\r\\n",
-              (unsigned)cmd,
-              (unsigned)conidx,
-              (unsigned)len);
+    /* 其他 0x??02 暂不处理，仅打日志 */
+    APP_LOGI("[PARAM_SYNC] RX 0x%04X conidx=%u len=%u\r\n",
+             (unsigned)cmd,
+             (unsigned)conidx,
+             (unsigned)len);
 }
@@ -1,4 +1,6 @@
 #include "protocol.h"
+#include "bcc.h"
+#include "conn_ctx.h"
 #include "protocol_cmd.h"
 #include "protocol_fe.h"
 #include "protocol_fd.h"
@@ -12,6 +14,20 @@
 #include <string.h>
 #include "co_printf.h"
 
+/*
+ * 日志级别（为什么需要）：
+ * - 以前 PROTOCOL_DEBUG_TX 固定为 1，每帧都同步打印 TX 选通道、整帧 HEX 和
+ *   payload 头，115200 下单条手机命令就要多花几毫秒在串口上。
+ * - 现在逐字节 dump 统一降为 DEBUG 级，默认 INFO 时在编译期整段删除；
+ *   联调“App 收不到 0x0101”这类问题时编译加 -DPROTOCOL_DEBUG_TX=1 即可恢复。
+ */
+#if defined(PROTOCOL_DEBUG_TX) && PROTOCOL_DEBUG_TX
+#define APP_LOG_LEVEL LOG_LEVEL_DEBUG
+#else
+#define APP_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#include "app_log.h"
+
 // 定义预置密钥（AES-128 Key，16 字节 ASCII）
 // 注意：这里必须与手机端 AES 加解密使用的 Key 完全一致。
 static const uint8_t s_default_aes_key[16] = {'Q',
@@ -38,23 +54,11 @@ Protocol_Handler_t g_protocol_handler;
 /* 当前正在解析的连接索引（为业务层提供 conidx 上下文） */
 static uint8_t g_protocol_rx_conidx = 0xFF;
 
-/* 发送上下文（按连接跟踪 ACK） */
-#define PROTOCOL_MAX_CONN 3 /* 与 simple_gatt_service 的 SP_MAX_CONN_NUM 对齐 */
-#define PROTOCOL_MAX_LEN                                                       \
-    240 /* payload 最大长度，确保总长度 fits uint8_t length 字段 */
+/* 连接数与每连接状态统一在 conn_ctx.h（APP_MAX_CONN / app_conn_t.proto） */
+#define PROTOCOL_MAX_CONN APP_MAX_CONN
 #define PROTOCOL_ACK_TIMEOUT 3000
 #define PROTOCOL_MAX_RETRY   3
 
-/*
- * 发送调试开关（为什么需要）：
- * - 你当前日志里已经看到 0x01FE 被正确解密/鉴权成功，但 App 没看到 0x0101。
- * - 0x0101 是通过 GATT Notify 发出，若 App 未订阅正确的特征（CHAR1/CHAR2），或者设备选错通道，就会“看起来没回包”。
- * - 打开该日志能直接看到：本次发送选了哪个 att_idx、cmd/len、以及帧头 16B。
- */
-#ifndef PROTOCOL_DEBUG_TX
-#define PROTOCOL_DEBUG_TX 1
-#endif
-
 /*
  * 回包通道固定开关（为什么需要）：
  * - 目前发送通道会随“最近一次 RX 的 att_idx + notify 使能”在两个特征之间切换，App 若只订阅一个特征会出现“偶发收不到回包”。
@@ -67,41 +71,18 @@ static uint8_t g_protocol_rx_conidx = 0xFF;
 #define PROTOCOL_TX_FORCE_FFF1 1
 #endif
 
-/* 鉴权状态（按连接） */
-static uint8_t g_protocol_authed[PROTOCOL_MAX_CONN] = {0};
-
-/* 每个连接：最后一次从哪个特征值收到数据（用于回包跟随通道） */
-static uint8_t g_protocol_last_rx_att_idx[PROTOCOL_MAX_CONN] = {0};
-
 /*
- * 每个连接：最后一次收到的“流水号(seq)”（用于同步应答回显）
- * 协议要求：终端回复的流水号与 APP 下发的流水号一致。
+ * 每连接协议状态见 app_conn_t.proto：
+ * - authed：鉴权状态；
+ * - last_rx_att_idx：最后一次从哪个特征值收到数据（用于回包跟随通道）；
+ * - last_rx_seq：最后一次收到的流水号（协议要求回复流水号与 APP 下发一致）；
+ * - last_rx_crypto：最后一次收到的加密类型（回包按同样方式加密）。
  */
-static uint8_t g_protocol_last_rx_seq[PROTOCOL_MAX_CONN] = {0xFF, 0xFF, 0xFF};
-
-/* 每个连接：最后一次收到的加密类型（用于回包按同样方式加密） */
-static uint8_t g_protocol_last_rx_crypto[PROTOCOL_MAX_CONN] = {
-    CRYPTO_TYPE_NONE, CRYPTO_TYPE_NONE, CRYPTO_TYPE_NONE};
+#define PROTO_CONN(conidx) (&Conn_Get(conidx)->proto)
 
 /* gap_api.h 在当前 SDK 版本中若未暴露原型，这里显式声明以避免隐式声明告警 */
 void gap_disconnect_req(uint8_t conidx);
 
-#if PROTOCOL_USE_ACK
-typedef struct
-{
-    bool     in_flight;
-    bool     critical;
-    uint8_t  seq;
-    uint16_t cmd;
-    uint8_t  retry;
-    uint8_t  buf[PROTOCOL_MAX_LEN + 10];
-    uint16_t len;
-} proto_tx_ctx_t;
-
-static proto_tx_ctx_t g_tx_ctx[PROTOCOL_MAX_CONN];
-static os_timer_t     g_ack_timer[PROTOCOL_MAX_CONN];
-#endif
-
 static uint8_t g_seq = 0;
 
 /*
@@ -109,11 +90,16 @@ static uint8_t g_seq = 0;
  * - 之前 Protocol_Send_Unicast/Async/Broadcast 在栈上分配 frame/enc_payload 大数组。
  * - 这些函数经常在 BLE 协议栈回调、UART 任务回调中被调用，任务/回调栈通常较小，
  *   容易触发栈溢出，表现为：PC/LR 异常（跳到 rodata/errno 等地址）=> HardFault => SOC 重启。
- * - 这里改为“按连接的静态缓冲”，避免栈爆。
- * 注意：该缓冲不是可重入的；但当前工程发送路径是串行的（同一 conidx 同时只会走一次发送）。
+ * - 这里改为静态缓冲，避免栈爆；缓冲是 conn_ctx 的定长组帧块（Conn_TxAlloc），
+ *   只在一次发送内租用，不按连接常驻。
+ *
+ * 就地组帧（为什么）：
+ * - 以前一帧要拷三遍：调用方 -> enc_payload（加密输出）-> frame[7..] -> GATT。
+ * - 现在块的前 7 字节留给帧头，明文直接落在 buf+7，原地 PKCS7 填充 + 加密，
+ *   再补帧头/BCC/帧尾，整块交给 ntf_data：少一遍拷贝，也不再需要单独的密文缓冲。
+ * - 调用方自己拼 payload 的（如 0x67FD 增量）可用 Protocol_Tx_Begin/Commit 直接写进块，
+ *   连调用方 -> 块这一遍也省掉。
  */
-static uint8_t s_tx_frame_buf[PROTOCOL_MAX_CONN][PROTOCOL_MAX_LEN + 10];
-static uint8_t s_tx_enc_buf[PROTOCOL_MAX_CONN][PROTOCOL_MAX_LEN];
 
 #if PROTOCOL_USE_ACK
 static void proto_ack_timeout(void* arg);
@@ -123,6 +109,50 @@ static void proto_restart_timer(uint8_t conidx);
 static bool
 proto_send_frame(uint8_t conidx, const uint8_t* frame, uint16_t len);
 
+/*
+ * 按连接缓存的加解密会话（为什么需要）：
+ * - 以前每帧收/发都 Algo_Bind + Algo_SetKeyIV 一个临时上下文，AES 每次都要重新做
+ *   密钥扩展（解密还要再转换一次），而 Key 在整个连接期间不变。
+ * - 现在每个连接在首个加密帧时打开会话（轮密钥只算一次，收发复用），
+ *   Protocol_Auth_Clear（新连接/断连都会调用）时关闭。会话放在 app_conn_t.proto.crypto。
+ */
+
+/**
+ * @brief 取本连接的加解密上下文（按需打开会话）
+ * @param scratch 无有效 conidx 时使用的临时上下文（退回每帧现算）
+ * @return NULL 表示不支持的加密类型
+ */
+static Algo_Context_t*
+proto_crypto_ctx(uint8_t conidx, uint8_t crypto, Algo_Context_t* scratch)
+{
+    const uint8_t* key =
+        (crypto != CRYPTO_TYPE_NONE) ? s_default_aes_key : NULL;
+
+    if (conidx < PROTOCOL_MAX_CONN)
+    {
+        Algo_Context_t* sess = &PROTO_CONN(conidx)->crypto;
+        if (Algo_Session_IsOpen(sess, (algo_type_t)crypto))
+        {
+            return sess;
+        }
+        if (Algo_Session_Open(sess, (algo_type_t)crypto, key, s_default_aes_iv))
+        {
+            return sess;
+        }
+        return NULL;
+    }
+
+    if (!Algo_Bind(scratch, (algo_type_t)crypto))
+    {
+        return NULL;
+    }
+    if (key != NULL)
+    {
+        Algo_SetKeyIV(scratch, key, s_default_aes_iv);
+    }
+    return scratch;
+}
+
 // BCC 校验函数实现
 static bool Protocol_Check_BCC(Protocol_Handler_t* self)
 {
@@ -131,24 +161,11 @@ static bool Protocol_Check_BCC(Protocol_Handler_t* self)
         return false;
     }
 
-    uint8_t bcc = 0;
     // BCC 校验范围：从 Header 到 Data (不包含 BCC 和 Footer)
     // Header(2) + Length(1) + Crypto(1) + Seq(1) + Cmd(2) = 7 bytes
-    // Data 长度 = self->payload_len
-    // 总校验长度 = 7 + self->payload_len
-    // 也就是 rx_len - 3 (BCC 1 byte + Footer 2 bytes)
-
-    uint16_t check_len = self->rx_len - 3;
-
-    for (uint16_t i = 0; i < check_len; i++)
-    {
-        bcc ^= self->rx_buffer[i];
-    }
-
-    // 获取接收到的 BCC (倒数第3个字节)
-    uint8_t received_bcc = self->rx_buffer[self->rx_len - 3];
-
-    return (bcc == received_bcc);
+    // 把收到的 BCC 一起异或进去：算出的 BCC == 收到的 BCC 等价于结果为 0，
+    // 整段 rx_len - 2 字节按字走一遍即可，不用再单独取尾部比较
+    return Bcc_Xor(0, self->rx_buffer, (uint16_t)(self->rx_len - 2)) == 0;
 }
 
 // 协议解析函数实现
@@ -162,7 +179,7 @@ static bool Protocol_Parse(Protocol_Handler_t* self)
     // 1. 检查最小长度 (Header 2 + Len 1 + Crypto 1 + Seq 1 + Cmd 2 + BCC 1 + Footer 2 = 10)
     if (self->rx_len < 10)
     {
-        co_printf("Protocol: Len too short %d\r\n", self->rx_len);
+        APP_LOGW("Protocol: Len too short %d\r\n", self->rx_len);
         return false;
     }
 
@@ -172,7 +189,7 @@ static bool Protocol_Parse(Protocol_Handler_t* self)
     // 3. 检查 Header Magic (0x5555)
     if (pHead->header != PROTOCOL_HEADER_MAGIC)
     {
-        co_printf("Protocol: Header Error 0x%04X\r\n", pHead->header);
+        APP_LOGW("Protocol: Header Error 0x%04X\r\n", pHead->header);
         return false;
     }
 
@@ -181,19 +198,26 @@ static bool Protocol_Parse(Protocol_Handler_t* self)
     if (self->rx_buffer[self->rx_len - 2] != 0xAA ||
         self->rx_buffer[self->rx_len - 1] != 0xAA)
     {
-        co_printf("Protocol: Footer Error\r\n");
+        APP_LOGW("Protocol: Footer Error\r\n");
         return false;
     }
     // 5. 检查长度字段
     // 协议定义 Length 为 "数据包长度，包括 header、footer"
     if (pHead->length != self->rx_len)
     {
-        co_printf(
+        APP_LOGW(
             "Protocol: Len mismatch %d != %d\r\n", pHead->length, self->rx_len);
         return false;
     }
 
-    // 6. 填充 header_info
+    // 6. 校验 BCC：与上面的头尾/长度检查放在一起，坏帧在取字段、解密之前就丢掉
+    if (!self->Check_BCC(self))
+    {
+        APP_LOGW("Protocol: BCC Error\r\n");
+        return false;
+    }
+
+    // 7. 填充 header_info
     self->header_info = *pHead;
 
     /* [Fix] 协议兼容：App 发送的 Cmd 为大端序 (如 01 FE)，ARM 小端读取为 0xFE01
@@ -202,51 +226,37 @@ static bool Protocol_Parse(Protocol_Handler_t* self)
     self->header_info.cmd =
         (uint16_t)((self->header_info.cmd >> 8) | (self->header_info.cmd << 8));
 
-    // 7. 计算 Payload 信息
+    // 8. 计算 Payload 信息
     // Payload 位于 Cmd 之后，BCC 之前
     // Header(2)+Len(1)+Crypto(1)+Seq(1)+Cmd(2) = 7 bytes offset
     self->payload     = &self->rx_buffer[7];
     self->payload_len = self->rx_len - 10; // 总长 - (Header7 + BCC1 + Footer2)
 
-    // 8. 校验 BCC
-    // 先校验完整性，再进行解密
-    if (!self->Check_BCC(self))
-    {
-        co_printf("Protocol: BCC Error\r\n");
-        return false;
-    }
-
     // 9. 解密 Data 段 (OPP 动态策略)
     if (self->payload_len > 0)
     {
-        Algo_Context_t algo_ctx;
+        Algo_Context_t  scratch;
 
         // A. 动态绑定算法 (0x00=None, 0x01=DES3, 0x02=AES128)
-        if (Algo_Bind(&algo_ctx, (algo_type_t)pHead->crypto))
+        //    密钥随会话设置，轮密钥在本连接首个加密帧时展开一次
+        Algo_Context_t* algo =
+            proto_crypto_ctx(g_protocol_rx_conidx, pHead->crypto, &scratch);
+        if (algo != NULL)
         {
 
             /* Debug：打印解密前 payload 前 16 字节，便于对齐 App 端 AES 参数 */
-            co_printf("Protocol: crypto=0x%02X payload_len=%d\r\n",
-                      (unsigned)pHead->crypto,
-                      (int)self->payload_len);
-            co_printf("Protocol: payload head (enc): ");
-            for (uint16_t i = 0; i < 16 && i < self->payload_len; i++)
-            {
-                co_printf("%02X ", self->payload[i]);
-            }
-            co_printf("\r\n");
-
-            // B. 设置密钥 (仅当非 None 模式时生效)
-            if (pHead->crypto != ALGO_TYPE_NONE)
-            {
-                Algo_SetKeyIV(&algo_ctx, s_default_aes_key, s_default_aes_iv);
-            }
-
-            // C. 执行解密 (原地解密: 输入=输出=payload)
+            APP_LOGD("Protocol: crypto=0x%02X payload_len=%d\r\n",
+                     (unsigned)pHead->crypto,
+                     (int)self->payload_len);
+            APP_LOGD_HEX("Protocol: payload head (enc):",
+                         self->payload,
+                         (self->payload_len < 16u) ? self->payload_len : 16u);
+
+            // B. 执行解密 (原地解密: 输入=输出=payload)
             if (!Algo_Decrypt(
-                    &algo_ctx, self->payload, self->payload_len, self->payload))
+                    algo, self->payload, self->payload_len, self->payload))
             {
-                co_printf("Protocol: Decrypt Error\r\n");
+                APP_LOGW("Protocol: Decrypt Error\r\n");
                 return false;
             }
 
@@ -273,23 +283,20 @@ static bool Protocol_Parse(Protocol_Handler_t* self)
                     if (pad_ok)
                     {
                         self->payload_len = (uint16_t)(self->payload_len - pad);
-                        co_printf("Protocol: unpad pkcs7 -> payload_len=%d\r\n",
-                                  (int)self->payload_len);
+                        APP_LOGD("Protocol: unpad pkcs7 -> payload_len=%d\r\n",
+                                 (int)self->payload_len);
                     }
                 }
             }
 
             /* Debug：打印解密后 payload 前 16 字节 */
-            co_printf("Protocol: payload head (dec): ");
-            for (uint16_t i = 0; i < 16 && i < self->payload_len; i++)
-            {
-                co_printf("%02X ", self->payload[i]);
-            }
-            co_printf("\r\n");
+            APP_LOGD_HEX("Protocol: payload head (dec):",
+                         self->payload,
+                         (self->payload_len < 16u) ? self->payload_len : 16u);
         }
         else
         {
-            co_printf("Protocol: Unknown Algo 0x%02X\r\n", pHead->crypto);
+            APP_LOGW("Protocol: Unknown Algo 0x%02X\r\n", pHead->crypto);
             return false;
         }
     }
@@ -307,18 +314,16 @@ void Protocol_Init(void)
 
     for (uint8_t i = 0; i < PROTOCOL_MAX_CONN; i++)
     {
-        g_protocol_last_rx_att_idx[i] = SP_IDX_CHAR1_VALUE;
-        g_protocol_last_rx_seq[i]     = 0xFF;
-        g_protocol_last_rx_crypto[i]  = CRYPTO_TYPE_NONE;
-    }
-
+        PROTO_CONN(i)->authed          = 0;
+        PROTO_CONN(i)->last_rx_att_idx = SP_IDX_CHAR1_VALUE;
+        PROTO_CONN(i)->last_rx_seq     = 0xFF;
+        PROTO_CONN(i)->last_rx_crypto  = CRYPTO_TYPE_NONE;
+        Algo_Session_Close(&PROTO_CONN(i)->crypto);
 #if PROTOCOL_USE_ACK
-    memset(g_tx_ctx, 0, sizeof(g_tx_ctx));
-    for (uint8_t i = 0; i < PROTOCOL_MAX_CONN; i++)
-    {
-        os_timer_init(&g_ack_timer[i], proto_ack_timeout, (void*)(uint32_t)i);
-    }
+        PROTO_CONN(i)->in_flight = false;
+        os_timer_init(&PROTO_CONN(i)->ack_timer, proto_ack_timeout, (void*)(uint32_t)i);
 #endif
+    }
 }
 
 // 处理接收到的数据 (供外部调用)
@@ -339,31 +344,32 @@ void Protocol_Handle_Data(uint8_t conidx, uint8_t* data, uint16_t len)
     /* 记录最近一次 RX 的流水号，用于后续回复帧“回显相同流水号” */
     if (conidx < PROTOCOL_MAX_CONN)
     {
-        g_protocol_last_rx_seq[conidx] = seq;
-        g_protocol_last_rx_crypto[conidx] =
-            g_protocol_handler.header_info.crypto;
+        PROTO_CONN(conidx)->last_rx_seq    = seq;
+        PROTO_CONN(conidx)->last_rx_crypto = g_protocol_handler.header_info.crypto;
     }
 
 #if PROTOCOL_USE_ACK
     /* 如果是 ACK，匹配流水号后停止对应定时器 */
     if (cmd == CMD_ACK_ID)
     {
-        if (conidx < PROTOCOL_MAX_CONN && g_tx_ctx[conidx].in_flight &&
-            g_tx_ctx[conidx].seq == seq)
+        if (conidx < PROTOCOL_MAX_CONN && PROTO_CONN(conidx)->in_flight &&
+            PROTO_CONN(conidx)->seq == seq)
         {
-            g_tx_ctx[conidx].in_flight = false;
-            os_timer_stop(&g_ack_timer[conidx]);
-            co_printf("Protocol: ACK ok conidx=%d seq=%d\r\n", conidx, seq);
+            PROTO_CONN(conidx)->in_flight = false;
+            os_timer_stop(&PROTO_CONN(conidx)->ack_timer);
+            Conn_TxFree(PROTO_CONN(conidx)->retx);
+            PROTO_CONN(conidx)->retx = NULL;
+            APP_LOGI("Protocol: ACK ok conidx=%d seq=%d\r\n", conidx, seq);
         }
         return;
     }
 
-    co_printf("Protocol: Parse Success! Cmd: 0x%04X seq=%d\r\n", cmd, seq);
+    APP_LOGI("Protocol: Parse Success! Cmd: 0x%04X seq=%d\r\n", cmd, seq);
 
     /* 收到业务数据后立即回 ACK（Cmd=0x0000，Data 长度=0，加密=0x00，流水号同对端） */
     proto_send_ack(conidx, seq);
 #else
-    co_printf("Protocol: Parse Success! Cmd: 0x%04X seq=%d\r\n", cmd, seq);
+    APP_LOGI("Protocol: Parse Success! Cmd: 0x%04X seq=%d\r\n", cmd, seq);
 #endif
 
     // 根据命令低字节区分 FE 和 FD
@@ -389,26 +395,26 @@ void Protocol_Handle_Data(uint8_t conidx, uint8_t* data, uint16_t len)
     }
     else
     {
-        co_printf("Protocol: Unknown Cmd Type 0x%02X\r\n", cmd_type);
+        APP_LOGW("Protocol: Unknown Cmd Type 0x%02X\r\n", cmd_type);
     }
 }
 
 /**
- * @brief 发送侧加密封装（与接收侧解密策略一致）
+ * @brief 发送侧加密封装（与接收侧解密策略一致），原地进行
  * @note 为什么要做：App 发来 crypto=0x02 的包时，通常也期望设备回包带同样 crypto，并对 Data 段做 AES+PKCS7。
+ * @param conidx     连接索引（复用该连接的加解密会话）
  * @param crypto     加密类型（CRYPTO_TYPE_*）
- * @param plain      明文 payload
+ * @param buf        入：明文；出：密文（填充直接写在明文后面）
  * @param plain_len  明文长度
- * @param out        输出缓冲区（用于存放密文）
- * @param out_cap    输出缓冲区容量
+ * @param cap        buf 容量（含填充）
  * @param out_len    输出密文长度
  */
-static bool proto_encrypt_payload(uint8_t        crypto,
-                                  const uint8_t* plain,
-                                  uint16_t       plain_len,
-                                  uint8_t*       out,
-                                  uint16_t       out_cap,
-                                  uint16_t*      out_len)
+static bool proto_encrypt_inplace(uint8_t   conidx,
+                                  uint8_t   crypto,
+                                  uint8_t*  buf,
+                                  uint16_t  plain_len,
+                                  uint16_t  cap,
+                                  uint16_t* out_len)
 {
     if (out_len == NULL)
     {
@@ -416,53 +422,43 @@ static bool proto_encrypt_payload(uint8_t        crypto,
     }
     *out_len = 0;
 
+    if (plain_len > cap)
+    {
+        return false;
+    }
     if (crypto == CRYPTO_TYPE_NONE || plain_len == 0)
     {
-        /* 无加密：直接输出原文 */
-        if (plain_len > 0)
-        {
-            if (plain == NULL || out == NULL || out_cap < plain_len)
-            {
-                return false;
-            }
-            memcpy(out, plain, plain_len);
-        }
+        /* 无加密：明文就是输出 */
         *out_len = plain_len;
         return true;
     }
-
-    /* 需要加密：必须有输入输出缓冲区 */
-    if (plain == NULL || out == NULL)
-    {
-        return false;
-    }
-
-    Algo_Context_t algo_ctx;
-    if (!Algo_Bind(&algo_ctx, (algo_type_t)crypto))
+    if (buf == NULL)
     {
         return false;
     }
-    Algo_SetKeyIV(&algo_ctx, s_default_aes_key, s_default_aes_iv);
 
-    /* PKCS7Padding：先拷贝明文到 out，再做 padding，再原地加密 */
-    if (out_cap < plain_len)
+    Algo_Context_t  scratch;
+    Algo_Context_t* algo = proto_crypto_ctx(conidx, crypto, &scratch);
+    if (algo == NULL)
     {
         return false;
     }
-    memcpy(out, plain, plain_len);
 
     uint8_t block_size = 16u;
-    if (algo_ctx.ops != NULL && algo_ctx.ops->block_size != 0)
+    if (algo->ops != NULL && algo->ops->block_size != 0)
     {
-        block_size = algo_ctx.ops->block_size;
+        block_size = algo->ops->block_size;
     }
-    uint32_t padded_len = Algo_Padding(out, (uint32_t)plain_len, block_size);
-    if (padded_len == 0 || padded_len > out_cap || padded_len > 0xFFu)
+
+    /* PKCS7 总会补 1..block_size 字节：先算好长度，确认放得下再写 */
+    uint32_t padded_len = ((uint32_t)plain_len / block_size + 1u) * block_size;
+    if (padded_len > cap || padded_len > 0xFFu)
     {
         return false;
     }
+    (void)Algo_Padding(buf, (uint32_t)plain_len, block_size);
 
-    if (!Algo_Encrypt(&algo_ctx, out, padded_len, out))
+    if (!Algo_Encrypt(algo, buf, padded_len, buf))
     {
         return false;
     }
@@ -471,6 +467,79 @@ static bool proto_encrypt_payload(uint8_t        crypto,
     return true;
 }
 
+/**
+ * @brief 就地组帧：块数据段（buf+7）里已是明文，原地加密后补帧头/BCC/帧尾
+ * @param plain_bcc 拷入明文时顺带算好的数据段异或（Bcc_CopyXor）；NULL=没算过。
+ *                  不加密时直接当数据段 BCC 用，省掉组帧后的回扫
+ * @return 整帧长度；0 表示加密失败/超长
+ */
+static uint16_t proto_build_inplace(uint8_t        conidx,
+                                    conn_tx_blk_t* blk,
+                                    uint8_t        crypto,
+                                    uint8_t        seq,
+                                    uint16_t       cmd,
+                                    uint16_t       plain_len,
+                                    const uint8_t* plain_bcc)
+{
+    uint8_t* frame   = blk->buf;
+    uint16_t enc_len = 0;
+    uint8_t  bcc;
+
+    if (!proto_encrypt_inplace(conidx,
+                               crypto,
+                               &frame[PROTOCOL_TX_HDR_LEN],
+                               plain_len,
+                               (uint16_t)PROTOCOL_MAX_LEN,
+                               &enc_len))
+    {
+        return 0;
+    }
+
+    uint16_t total_len = (uint16_t)(enc_len + 10u);
+    frame[0] = 0x55;
+    frame[1] = 0x55;
+    frame[2] = (uint8_t)total_len;
+    frame[3] = crypto;
+    frame[4] = seq;
+    /* Cmd：协议帧里是大端 */
+    frame[5] = (uint8_t)(cmd >> 8);
+    frame[6] = (uint8_t)(cmd & 0xFF);
+
+    /*
+     * BCC = Header..Data 的异或：0x55^0x55 抵消，帧头只剩 5 个字节；
+     * 数据段不加密且拷贝时已累计过就直接用，否则（密文）按字异或一遍。
+     * 密文那一遍没法并进加密：板上 AES_cbc_encrypt 是 SDK 整段接口，拿不到逐块输出。
+     */
+    if (plain_bcc != NULL && enc_len == plain_len && crypto == CRYPTO_TYPE_NONE)
+    {
+        bcc = *plain_bcc;
+    }
+    else
+    {
+        bcc = Bcc_Xor(0, &frame[PROTOCOL_TX_HDR_LEN], enc_len);
+    }
+    bcc ^= (uint8_t)(frame[2] ^ frame[3] ^ frame[4] ^ frame[5] ^ frame[6]);
+    frame[7 + enc_len] = bcc;
+    frame[8 + enc_len] = 0xAA;
+    frame[9 + enc_len] = 0xAA;
+    return total_len;
+}
+
+/*
+ * 取发送流水号：
+ * - echo_rx=true：同步应答，回显该连接最近一次请求的流水号（若有）；
+ * - 否则（或没有有效的 RX seq）：本地自增。
+ */
+static uint8_t proto_tx_seq(uint8_t conidx, bool echo_rx)
+{
+    if (echo_rx && conidx < PROTOCOL_MAX_CONN && PROTO_CONN(conidx)->last_rx_seq != 0xFF)
+    {
+        return PROTO_CONN(conidx)->last_rx_seq;
+    }
+    g_seq = (g_seq + 1) & 0xFF;
+    return g_seq;
+}
+
 uint8_t Protocol_Get_Rx_Conidx(void)
 {
     return g_protocol_rx_conidx;
@@ -484,19 +553,19 @@ void Protocol_Set_Rx_AttIdx(uint8_t conidx, uint16_t att_idx)
     /* 只接受我们关心的通道；CHAR3 无 Notify，因此记录为 CHAR2 作为回包通道 */
     if (att_idx == SP_IDX_CHAR1_VALUE)
     {
-        g_protocol_last_rx_att_idx[conidx] = SP_IDX_CHAR1_VALUE;
+        PROTO_CONN(conidx)->last_rx_att_idx = SP_IDX_CHAR1_VALUE;
     }
     else if (att_idx == SP_IDX_CHAR2_VALUE)
     {
-        g_protocol_last_rx_att_idx[conidx] = SP_IDX_CHAR2_VALUE;
+        PROTO_CONN(conidx)->last_rx_att_idx = SP_IDX_CHAR2_VALUE;
     }
     else if (att_idx == SP_IDX_CHAR3_VALUE)
     {
-        g_protocol_last_rx_att_idx[conidx] = SP_IDX_CHAR2_VALUE;
+        PROTO_CONN(conidx)->last_rx_att_idx = SP_IDX_CHAR2_VALUE;
     }
     else
     {
-        g_protocol_last_rx_att_idx[conidx] = SP_IDX_CHAR1_VALUE;
+        PROTO_CONN(conidx)->last_rx_att_idx = SP_IDX_CHAR1_VALUE;
     }
 }
 
@@ -504,7 +573,9 @@ void Protocol_Auth_Clear(uint8_t conidx)
 {
     if (conidx < PROTOCOL_MAX_CONN)
     {
-        g_protocol_authed[conidx] = 0;
+        PROTO_CONN(conidx)->authed = 0;
+        /* 新连接/断连：会话随连接生命周期结束，下一条加密帧再重新打开 */
+        Algo_Session_Close(&PROTO_CONN(conidx)->crypto);
     }
 }
 
@@ -512,7 +583,7 @@ void Protocol_Auth_Set(uint8_t conidx, bool ok)
 {
     if (conidx < PROTOCOL_MAX_CONN)
     {
-        g_protocol_authed[conidx] = ok ? 1 : 0;
+        PROTO_CONN(conidx)->authed = ok ? 1 : 0;
     }
 }
 
@@ -520,109 +591,74 @@ bool Protocol_Auth_IsOk(uint8_t conidx)
 {
     if (conidx < PROTOCOL_MAX_CONN)
     {
-        return g_protocol_authed[conidx] != 0;
+        return PROTO_CONN(conidx)->authed != 0;
     }
     return false;
 }
 
 void Protocol_Auth_SendResult(uint8_t conidx, bool ok)
 {
-    uint8_t  frame[PHONE_REPLY_FRAME_OVERHEAD + 32u];
-    uint16_t frame_len = 0;
-
     /*
      * 协议要求：回复流水号必须与请求流水号一致。
      * - 优先使用最近一次收到的 seq。
      * - 若当前没有有效的 RX seq（例如无请求触发的异步通知），回退为本地自增。
      */
-    uint8_t tx_seq = 0;
-    if (conidx < PROTOCOL_MAX_CONN && g_protocol_last_rx_seq[conidx] != 0xFF)
-    {
-        tx_seq = g_protocol_last_rx_seq[conidx];
-    }
-    else
+    uint8_t tx_seq = proto_tx_seq(conidx, true);
+
+    conn_tx_blk_t* blk = Conn_TxAlloc();
+    if (blk == NULL)
     {
-        g_seq  = (g_seq + 1) & 0xFF;
-        tx_seq = g_seq;
+        APP_LOGW("Protocol: auth result no tx block\r\n");
+        return;
     }
 
     /*
-     * 0x0101 Data 先按明文拼好，再根据 last_rx_crypto 做加密。
+     * 0x0101 Data 先按明文直接写进组帧块的数据段，再根据 last_rx_crypto 原地加密。
      * 为什么：App 发来的 Connect(0x01FE) 多数是 crypto=0x02(AES+PKCS7)，回包也需要同样加密方式才能被 App 正确解密。
      */
-    uint8_t peer_mac[PHONE_REPLY_MODEL_MAC_MAX_LEN];
-    uint8_t mac_len = 0;
-    if (RSSI_Check_Get_Peer_Addr(conidx, peer_mac))
+    uint8_t* plain   = &blk->buf[PROTOCOL_TX_HDR_LEN];
+    uint8_t  mac_len = 0;
+    if (RSSI_Check_Get_Peer_Addr(conidx, &plain[5]))
     {
         mac_len = PHONE_REPLY_MODEL_MAC_MAX_LEN;
     }
-
-    uint8_t plain_payload[5u + PHONE_REPLY_MODEL_MAC_MAX_LEN];
-    plain_payload[0] = ok ? 0 : 1; /* ResultCode: 0=成功，1=失败 */
-    plain_payload[1] = 2u;         /* InductionStatus: 联调默认开 */
-    plain_payload[2] = 2u;         /* NfcSwitch: 联调默认开 */
-    plain_payload[3] = 0x02u;      /* CarSearchVolume: 联调默认中 */
-    plain_payload[4] = mac_len;
-    if (mac_len == PHONE_REPLY_MODEL_MAC_MAX_LEN)
-    {
-        memcpy(&plain_payload[5], peer_mac, PHONE_REPLY_MODEL_MAC_MAX_LEN);
-    }
+    plain[0] = ok ? 0 : 1; /* ResultCode: 0=成功，1=失败 */
+    plain[1] = 2u;         /* InductionStatus: 联调默认开 */
+    plain[2] = 2u;         /* NfcSwitch: 联调默认开 */
+    plain[3] = 0x02u;      /* CarSearchVolume: 联调默认中 */
+    plain[4] = mac_len;
     uint16_t plain_len = (uint16_t)(5u + (uint16_t)mac_len);
 
     uint8_t crypto = CRYPTO_TYPE_NONE;
     if (conidx < PROTOCOL_MAX_CONN)
     {
-        crypto = g_protocol_last_rx_crypto[conidx];
+        crypto = PROTO_CONN(conidx)->last_rx_crypto;
     }
 
-    uint8_t  enc_payload[32u];
-    uint16_t enc_len = 0;
-    if (!proto_encrypt_payload(crypto,
-                               plain_payload,
-                               plain_len,
-                               enc_payload,
-                               (uint16_t)sizeof(enc_payload),
-                               &enc_len))
+    uint16_t frame_len =
+        proto_build_inplace(conidx, blk, crypto, tx_seq, auth_result_ID, plain_len, NULL);
+    if (frame_len == 0)
     {
-        co_printf("Protocol: auth result encrypt fail\r\n");
+        APP_LOGW("Protocol: auth result encrypt fail\r\n");
+        Conn_TxFree(blk);
         return;
     }
 
-#if PROTOCOL_DEBUG_TX
-    co_printf("Protocol: AuthResult enc payload (%dB crypto=0x%02X): ",
-              (int)enc_len,
-              (unsigned)crypto);
-    for (uint16_t i = 0; i < enc_len; i++)
-    {
-        co_printf("%02X ", enc_payload[i]);
-    }
-    co_printf("\r\n");
-#endif
-
-    if (!PhoneReply_BuildFrameEx(auth_result_ID,
-                                 crypto,
-                                 tx_seq,
-                                 enc_payload,
-                                 enc_len,
-                                 frame,
-                                 (uint16_t)sizeof(frame),
-                                 &frame_len))
-    {
-        co_printf("Protocol: build auth result fail\r\n");
-        return;
-    }
+    APP_LOGD("Protocol: AuthResult enc payload (%dB crypto=0x%02X)\r\n",
+             (int)(frame_len - 10u),
+             (unsigned)crypto);
+    APP_LOGD_HEX("Protocol: AuthResult enc:", plain, (uint16_t)(frame_len - 10u));
 
-#if PROTOCOL_DEBUG_TX
     /* 0x0101 回包属于 Notify：这里先打印，确认确实走到了发送逻辑 */
-    co_printf("Protocol: AuthResult(0x0101) build ok=%d conidx=%d seq=%d "
-              "frame_len=%d\r\n",
-              ok ? 1 : 0,
-              (int)conidx,
-              (int)tx_seq,
-              (int)frame_len);
-#endif
-
-    proto_send_frame(conidx, frame, frame_len);
+    APP_LOGD("Protocol: AuthResult(0x0101) build ok=%d conidx=%d seq=%d "
+             "frame_len=%d\r\n",
+             ok ? 1 : 0,
+             (int)conidx,
+             (int)tx_seq,
+             (int)frame_len);
+
+    proto_send_frame(conidx, blk->buf, frame_len);
+    Conn_TxFree(blk);
 }
 
 void Protocol_Disconnect(uint8_t conidx)
@@ -668,7 +704,7 @@ void Protocol_Create_Test_Data(void)
     test_buf[i++] = 0xAA;
     test_buf[i++] = 0xAA;
 
-    co_printf("Protocol: Generated Test Data (%d bytes)\r\n", i);
+    APP_LOGI("Protocol: Generated Test Data (%d bytes)\r\n", i);
     Protocol_Handle_Data(0, test_buf, i);
 }
 
@@ -727,7 +763,7 @@ void Protocol_Create_Test_FE_Connect_01FE(void)
     test_buf[i++] = 0xAA;
     test_buf[i++] = 0xAA;
 
-    co_printf("Protocol: Generated FE Connect 0x01FE (%d bytes)\r\n", (int)i);
+    APP_LOGI("Protocol: Generated FE Connect 0x01FE (%d bytes)\r\n", (int)i);
     Protocol_Handle_Data(0, test_buf, i);
 }
 
@@ -741,7 +777,7 @@ static uint8_t proto_pick_tx_att_idx(uint8_t conidx)
     /* 统一回包到 FFF1（SP_IDX_CHAR2_VALUE） */
     return SP_IDX_CHAR2_VALUE;
 #else
-    uint8_t prefer = g_protocol_last_rx_att_idx[conidx];
+    uint8_t prefer = PROTO_CONN(conidx)->last_rx_att_idx;
     if (prefer != SP_IDX_CHAR1_VALUE && prefer != SP_IDX_CHAR2_VALUE)
     {
         prefer = SP_IDX_CHAR1_VALUE;
@@ -772,36 +808,23 @@ static bool proto_send_frame(uint8_t conidx, const uint8_t* frame, uint16_t len)
 
     uint8_t att_idx = proto_pick_tx_att_idx(conidx);
 
-#if PROTOCOL_DEBUG_TX
-    /* cmd 在 frame[5..6]（小端），打印用于确认到底发了什么 */
-    uint16_t cmd_be = 0;
-    if (len >= 7)
-    {
-        /* Cmd：协议帧里是大端 */
-        cmd_be = ((uint16_t)frame[5] << 8) | (uint16_t)frame[6];
-    }
-    co_printf("Protocol: TX pick att_idx=%d prefer=%d c1=%d c2=%d len=%d "
-              "cmd=0x%04X\r\n",
-              (int)att_idx,
-              (int)g_protocol_last_rx_att_idx[conidx],
-              sp_is_char1_ntf_enabled(conidx) ? 1 : 0,
-              sp_is_char2_ntf_enabled(conidx) ? 1 : 0,
-              (int)len,
-              (unsigned)cmd_be);
-    co_printf("Protocol: TX frame(all %dB): ", (int)len);
-    for (uint16_t i = 0; i < len; i++)
-    {
-        co_printf("%02X ", frame[i]);
-    }
-    co_printf("\r\n");
-#endif
+    /* cmd 在 frame[5..6]（协议帧里是大端），打印用于确认到底发了什么 */
+    APP_LOGD("Protocol: TX pick att_idx=%d prefer=%d c1=%d c2=%d len=%d "
+             "cmd=0x%04X\r\n",
+             (int)att_idx,
+             (int)PROTO_CONN(conidx)->last_rx_att_idx,
+             sp_is_char1_ntf_enabled(conidx) ? 1 : 0,
+             sp_is_char2_ntf_enabled(conidx) ? 1 : 0,
+             (int)len,
+             (len >= 7) ? (((unsigned)frame[5] << 8) | frame[6]) : 0u);
+    APP_LOGD_HEX("Protocol: TX frame:", frame, len);
 
     if (att_idx == SP_IDX_CHAR1_VALUE)
     {
         if (!sp_is_char1_ntf_enabled(conidx))
         {
-            co_printf("Protocol: TX drop (char1 notify disabled) conidx=%d\r\n",
-                      conidx);
+            APP_LOGW("Protocol: TX drop (char1 notify disabled) conidx=%d\r\n",
+                     conidx);
             return false;
         }
     }
@@ -809,102 +832,98 @@ static bool proto_send_frame(uint8_t conidx, const uint8_t* frame, uint16_t len)
     {
         if (!sp_is_char2_ntf_enabled(conidx))
         {
-            co_printf("Protocol: TX drop (char2 notify disabled) conidx=%d\r\n",
-                      conidx);
+            APP_LOGW("Protocol: TX drop (char2 notify disabled) conidx=%d\r\n",
+                     conidx);
             return false;
         }
     }
 
     ntf_data(conidx, att_idx, (uint8_t*)frame, len);
 
-#if PROTOCOL_DEBUG_TX
-    co_printf("Protocol: TX notify queued att_idx=%d len=%d\r\n",
-              (int)att_idx,
-              (int)len);
-#endif
+    APP_LOGD("Protocol: TX notify queued att_idx=%d len=%d\r\n",
+             (int)att_idx,
+             (int)len);
     return true;
 }
 
-int Protocol_Send_Unicast(uint8_t        conidx,
-                          uint16_t       cmd,
-                          const uint8_t* payload,
-                          uint16_t       len)
+static int proto_unicast_check(uint8_t conidx, uint16_t len)
 {
     if (conidx >= PROTOCOL_MAX_CONN)
         return -1;
     if (gap_get_connect_status(conidx) == 0)
         return -2;
-    if (len + 10 > PROTOCOL_MAX_LEN + 10)
+    if (len > PROTOCOL_MAX_LEN)
         return -3;
+    return 0;
+}
 
-    uint8_t* frame       = s_tx_frame_buf[conidx];
-    uint8_t* enc_payload = s_tx_enc_buf[conidx];
-    uint16_t enc_len     = 0;
-    uint8_t  bcc         = 0;
-    uint16_t total_len   = 0;
-
-    /* 组帧 */
-    frame[0] = 0x55;
-    frame[1] = 0x55;
+/* 单播核心：明文已在块的数据段里；组帧、发送，然后归还块 */
+static int proto_unicast_blk(uint8_t        conidx,
+                             uint16_t       cmd,
+                             conn_tx_blk_t* blk,
+                             uint16_t       len,
+                             bool           echo_rx,
+                             const uint8_t* plain_bcc)
+{
+    int ret;
 
     /* 回包加密：默认跟随该连接最近一次请求的 crypto */
-    uint8_t crypto = g_protocol_last_rx_crypto[conidx];
-    if (!proto_encrypt_payload(crypto,
-                               payload,
-                               len,
-                               enc_payload,
-                               (uint16_t)PROTOCOL_MAX_LEN,
-                               &enc_len))
+    uint8_t  crypto    = PROTO_CONN(conidx)->last_rx_crypto;
+    uint16_t total_len = proto_build_inplace(
+        conidx, blk, crypto, proto_tx_seq(conidx, echo_rx), cmd, len, plain_bcc);
+    if (total_len == 0)
     {
-        return -5;
+        ret = -5;
     }
-
-#if PROTOCOL_DEBUG_TX
-    co_printf("Protocol: Unicast enc payload (%dB crypto=0x%02X): ",
-              (int)enc_len,
-              (unsigned)crypto);
-    for (uint16_t i = 0; i < enc_len; i++)
+    else
     {
-        co_printf("%02X ", enc_payload[i]);
+        APP_LOGD("Protocol: Unicast enc payload (%dB crypto=0x%02X)\r\n",
+                 (int)(total_len - 10u),
+                 (unsigned)crypto);
+        /* 发送：内部会按 last_rx_att_idx 选通道，并检查 notify 是否开启 */
+        ret = proto_send_frame(conidx, blk->buf, total_len) ? 0 : -4;
     }
-    co_printf("\r\n");
-#endif
+    Conn_TxFree(blk);
+    return ret;
+}
 
-    total_len = (uint16_t)(enc_len + 10u);
-    frame[2]  = (uint8_t)total_len;
-    frame[3]  = crypto;
+static int proto_unicast_copy(uint8_t        conidx,
+                              uint16_t       cmd,
+                              const uint8_t* payload,
+                              uint16_t       len,
+                              bool           echo_rx)
+{
+    int ret = proto_unicast_check(conidx, len);
+    if (ret != 0)
+        return ret;
+    if (len > 0 && payload == NULL)
+        return -5;
 
-    /* 同步应答：流水号与请求保持一致（若有） */
-    uint8_t tx_seq = 0;
-    if (conidx < PROTOCOL_MAX_CONN && g_protocol_last_rx_seq[conidx] != 0xFF)
-    {
-        tx_seq = g_protocol_last_rx_seq[conidx];
-    }
-    else
-    {
-        g_seq  = (g_seq + 1) & 0xFF;
-        tx_seq = g_seq;
-    }
-    frame[4] = tx_seq;
-    /* Cmd：协议帧里是大端 */
-    frame[5] = (uint8_t)(cmd >> 8);
-    frame[6] = (uint8_t)(cmd & 0xFF);
+    conn_tx_blk_t* blk = Conn_TxAlloc();
+    if (blk == NULL)
+        return -6;
 
-    if (enc_len > 0)
+    /* 发送路径上唯一一次拷贝：调用方数据 -> 块的数据段；不加密时顺带累计 BCC */
+    uint8_t plain_bcc = 0;
+    if (PROTO_CONN(conidx)->last_rx_crypto == CRYPTO_TYPE_NONE)
     {
-        memcpy(&frame[7], enc_payload, enc_len);
+        plain_bcc = Bcc_CopyXor(0, &blk->buf[PROTOCOL_TX_HDR_LEN], payload, len);
+        return proto_unicast_blk(conidx, cmd, blk, len, echo_rx, &plain_bcc);
     }
-
-    for (uint16_t i = 0; i < (uint16_t)(7u + enc_len); i++)
+    if (len > 0)
     {
-        bcc ^= frame[i];
+        memcpy(&blk->buf[PROTOCOL_TX_HDR_LEN], payload, len);
     }
-    frame[7 + enc_len] = bcc;
-    frame[8 + enc_len] = 0xAA;
-    frame[9 + enc_len] = 0xAA;
+    return proto_unicast_blk(conidx, cmd, blk, len, echo_rx, NULL);
+}
 
-    /* 发送：内部会按 last_rx_att_idx 选通道，并检查 notify 是否开启 */
-    return proto_send_frame(conidx, frame, total_len) ? 0 : -4;
+int Protocol_Send_Unicast(uint8_t        conidx,
+                          uint16_t       cmd,
+                          const uint8_t* payload,
+                          uint16_t       len)
+{
+    /* 同步应答：流水号与请求保持一致（若有） */
+    return proto_unicast_copy(conidx, cmd, payload, len, true);
 }
 
 int Protocol_Send_Unicast_Async(uint8_t        conidx,
@@ -912,68 +931,50 @@ int Protocol_Send_Unicast_Async(uint8_t        conidx,
                                 const uint8_t* payload,
                                 uint16_t       len)
 {
-    if (conidx >= PROTOCOL_MAX_CONN)
-        return -1;
-    if (gap_get_connect_status(conidx) == 0)
-        return -2;
-    if (len + 10 > PROTOCOL_MAX_LEN + 10)
-        return -3;
+    /* 强制使用新的流水号（避免复用 last_rx_seq 被 APP 当成上一次指令应答） */
+    return proto_unicast_copy(conidx, cmd, payload, len, false);
+}
 
-    uint8_t* frame       = s_tx_frame_buf[conidx];
-    uint8_t* enc_payload = s_tx_enc_buf[conidx];
-    uint16_t enc_len     = 0;
-    uint8_t  bcc         = 0;
-    uint16_t total_len   = 0;
+/* 数据段指针 -> 所在组帧块（buf 是块的第一个成员） */
+static conn_tx_blk_t* proto_blk_of(uint8_t* data)
+{
+    return (conn_tx_blk_t*)(void*)(data - PROTOCOL_TX_HDR_LEN);
+}
 
-    /* 组帧 */
-    frame[0] = 0x55;
-    frame[1] = 0x55;
+uint8_t* Protocol_Tx_Begin(void)
+{
+    conn_tx_blk_t* blk = Conn_TxAlloc();
+    return (blk != NULL) ? &blk->buf[PROTOCOL_TX_HDR_LEN] : NULL;
+}
 
-    /* 主动推送：加密策略跟随该连接最近一次请求的 crypto */
-    uint8_t crypto = g_protocol_last_rx_crypto[conidx];
-    if (!proto_encrypt_payload(crypto,
-                               payload,
-                               len,
-                               enc_payload,
-                               (uint16_t)PROTOCOL_MAX_LEN,
-                               &enc_len))
-    {
+int Protocol_Tx_Commit(uint8_t conidx, uint16_t cmd, uint8_t* data, uint16_t len, bool async)
+{
+    if (data == NULL)
         return -5;
-    }
 
-    total_len = (uint16_t)(enc_len + 10u);
-    frame[2]  = (uint8_t)total_len;
-    frame[3]  = crypto;
-
-    /* 强制使用新的流水号（避免复用 last_rx_seq 被 APP 当成上一次指令应答） */
-    g_seq    = (g_seq + 1) & 0xFF;
-    frame[4] = g_seq;
-
-    /* Cmd：协议帧里是大端 */
-    frame[5] = (uint8_t)(cmd >> 8);
-    frame[6] = (uint8_t)(cmd & 0xFF);
-
-    if (enc_len > 0)
+    conn_tx_blk_t* blk = proto_blk_of(data);
+    int            ret = proto_unicast_check(conidx, len);
+    if (ret != 0)
     {
-        memcpy(&frame[7], enc_payload, enc_len);
+        Conn_TxFree(blk);
+        return ret;
     }
+    return proto_unicast_blk(conidx, cmd, blk, len, !async, NULL);
+}
 
-    for (uint16_t i = 0; i < (uint16_t)(7u + enc_len); i++)
+void Protocol_Tx_Abort(uint8_t* data)
+{
+    if (data != NULL)
     {
-        bcc ^= frame[i];
+        Conn_TxFree(proto_blk_of(data));
     }
-    frame[7 + enc_len] = bcc;
-    frame[8 + enc_len] = 0xAA;
-    frame[9 + enc_len] = 0xAA;
-
-    return proto_send_frame(conidx, frame, total_len) ? 0 : -4;
 }
+
 /* 发送 ACK（Cmd=0x0000，Data 长度=0） */
 #if PROTOCOL_USE_ACK
 static void proto_send_ack(uint8_t conidx, uint8_t seq)
 {
     uint8_t ack[10];
-    uint8_t bcc = 0;
     ack[0]      = 0x55;
     ack[1]      = 0x55;
     ack[2]      = 10; // 总长度
@@ -981,9 +982,8 @@ static void proto_send_ack(uint8_t conidx, uint8_t seq)
     ack[4]      = seq;
     ack[5]      = 0x00;
     ack[6]      = 0x00; // CMD_ACK_ID（大端/小端一致）
-    for (uint8_t i = 0; i < 7; i++)
-        bcc ^= ack[i];
-    ack[7] = bcc;
+    /* 无数据段：BCC = 0x55^0x55^10^0^seq^0^0，直接算出，不用走循环 */
+    ack[7] = (uint8_t)(10u ^ seq);
     ack[8] = 0xAA;
     ack[9] = 0xAA;
     proto_send_frame(conidx, ack, sizeof(ack));
@@ -997,32 +997,34 @@ static void proto_ack_timeout(void* arg)
     uint8_t conidx = (uint8_t)(uint32_t)arg;
     if (conidx >= PROTOCOL_MAX_CONN)
         return;
-    proto_tx_ctx_t* ctx = &g_tx_ctx[conidx];
-    if (!ctx->in_flight)
+    app_conn_proto_t* ctx = PROTO_CONN(conidx);
+    if (!ctx->in_flight || ctx->retx == NULL)
         return;
 
     if (ctx->retry < PROTOCOL_MAX_RETRY)
     {
         ctx->retry++;
-        co_printf("Protocol: RETRY conidx=%d seq=%d try=%d\r\n",
-                  conidx,
-                  ctx->seq,
-                  ctx->retry);
-        proto_send_frame(conidx, ctx->buf, ctx->len);
+        APP_LOGI("Protocol: RETRY conidx=%d seq=%d try=%d\r\n",
+                 conidx,
+                 ctx->seq,
+                 ctx->retry);
+        proto_send_frame(conidx, ctx->retx->buf, ctx->len);
         proto_restart_timer(conidx);
     }
     else
     {
-        co_printf(
+        APP_LOGW(
             "Protocol: RETRY FAIL conidx=%d seq=%d\r\n", conidx, ctx->seq);
         ctx->in_flight = false;
+        Conn_TxFree(ctx->retx);
+        ctx->retx = NULL;
     }
 }
 
 static void proto_restart_timer(uint8_t conidx)
 {
-    os_timer_stop(&g_ack_timer[conidx]);
-    os_timer_start(&g_ack_timer[conidx], PROTOCOL_ACK_TIMEOUT, 0);
+    os_timer_stop(&PROTO_CONN(conidx)->ack_timer);
+    os_timer_start(&PROTO_CONN(conidx)->ack_timer, PROTOCOL_ACK_TIMEOUT, 0);
 }
 #endif
 
@@ -1050,52 +1052,60 @@ int Protocol_Send_Broadcast(uint16_t       cmd,
 	 * 广播：不同连接的 last_rx_crypto 可能不同，因此需要“逐连接组帧并加密”。
 	 * 为什么：否则 crypto=0x02 的连接会拿到明文/crypto=0 的帧，App 端会解密失败。
 	 */
-    g_seq          = (g_seq + 1) & 0xFF;
-    uint8_t tx_seq = g_seq;
+    uint8_t tx_seq = proto_tx_seq(0xFF, false);
 
-#if PROTOCOL_USE_ACK
-    /* 逐连接发送，仅对已连接且已打开 CHAR1 通知的连接生效 */
+    /* 逐连接发送（按最后 RX 通道选择 CHAR1/CHAR2）；开 ACK 时每帧等确认、超时重传 */
     bool sent_any = false;
     for (uint8_t idx = 0; idx < PROTOCOL_MAX_CONN; idx++)
     {
         if (gap_get_connect_status(idx) == 0)
             continue;
 
-        uint8_t* frame       = s_tx_frame_buf[idx];
-        uint8_t* enc_payload = s_tx_enc_buf[idx];
-        uint16_t enc_len     = 0;
-        uint8_t  bcc         = 0;
-        uint8_t  crypto      = g_protocol_last_rx_crypto[idx];
-        if (!proto_encrypt_payload(crypto,
-                                   payload,
-                                   len,
-                                   enc_payload,
-                                   (uint16_t)PROTOCOL_MAX_LEN,
-                                   &enc_len))
+#if PROTOCOL_USE_ACK
+        /* 上一帧还没确认：新帧顶替它，旧的待重传块先还回池里 */
+        app_conn_proto_t* ctx = PROTO_CONN(idx);
+        if (ctx->retx != NULL)
+        {
+            os_timer_stop(&ctx->ack_timer);
+            ctx->in_flight = false;
+            Conn_TxFree(ctx->retx);
+            ctx->retx = NULL;
+        }
+#endif
+
+        conn_tx_blk_t* blk = Conn_TxAlloc();
+        if (blk == NULL)
+            continue;
+
+        /* 原地加密会覆盖数据段，所以每个连接各拷一次明文；不加密时顺带累计 BCC */
+        if (len > 0 && payload == NULL)
+        {
+            Conn_TxFree(blk);
+            continue;
+        }
+        uint8_t        crypto    = PROTO_CONN(idx)->last_rx_crypto;
+        uint8_t        plain_bcc = 0;
+        const uint8_t* bcc_hint  = NULL;
+        if (crypto == CRYPTO_TYPE_NONE)
+        {
+            plain_bcc = Bcc_CopyXor(0, &blk->buf[PROTOCOL_TX_HDR_LEN], payload, len);
+            bcc_hint  = &plain_bcc;
+        }
+        else if (len > 0)
+        {
+            memcpy(&blk->buf[PROTOCOL_TX_HDR_LEN], payload, len);
+        }
+        uint16_t total_len =
+            proto_build_inplace(idx, blk, crypto, tx_seq, cmd, len, bcc_hint);
+        if (total_len == 0)
         {
+            Conn_TxFree(blk);
             continue;
         }
-        uint16_t total_len = (uint16_t)(enc_len + 10u);
-
-        frame[0] = 0x55;
-        frame[1] = 0x55;
-        frame[2] = (uint8_t)total_len;
-        frame[3] = crypto;
-        frame[4] = tx_seq;
-        /* Cmd：协议帧里是大端 */
-        frame[5] = (uint8_t)(cmd >> 8);
-        frame[6] = (uint8_t)(cmd & 0xFF);
-        if (enc_len > 0)
-            memcpy(&frame[7], enc_payload, enc_len);
-        for (uint16_t i = 0; i < (uint16_t)(7u + enc_len); i++)
-            bcc ^= frame[i];
-        frame[7 + enc_len] = bcc;
-        frame[8 + enc_len] = 0xAA;
-        frame[9 + enc_len] = 0xAA;
-
-        /* 由 proto_send_frame 内部按最后 RX 通道选择 CHAR1/CHAR2，并检查 notify 使能 */
-        proto_tx_ctx_t* ctx = &g_tx_ctx[idx];
-        memcpy(ctx->buf, frame, total_len);
+
+#if PROTOCOL_USE_ACK
+        /* 块本身就是待重传帧：扣住直到确认/放弃，不再另拷一份 */
+        ctx->retx      = blk;
         ctx->len       = total_len;
         ctx->seq       = tx_seq;
         ctx->cmd       = cmd;
@@ -1103,7 +1113,7 @@ int Protocol_Send_Broadcast(uint16_t       cmd,
         ctx->critical  = critical;
         ctx->in_flight = true;
 
-        if (proto_send_frame(idx, frame, total_len))
+        if (proto_send_frame(idx, blk->buf, total_len))
         {
             proto_restart_timer(idx);
             sent_any = true;
@@ -1111,59 +1121,17 @@ int Protocol_Send_Broadcast(uint16_t       cmd,
         else
         {
             ctx->in_flight = false;
+            ctx->retx      = NULL;
+            Conn_TxFree(blk);
         }
-    }
-
-    if (!sent_any)
-    {
-        return -3; // 没有任何连接/订阅者
-    }
-    return 0;
 #else
-    /* 开发阶段：不启用 ACK/重传，逐连接发送（按最后 RX 通道选择 CHAR1/CHAR2） */
-    bool sent_any = false;
-    for (uint8_t idx = 0; idx < PROTOCOL_MAX_CONN; idx++)
-    {
-        if (gap_get_connect_status(idx) == 0)
-            continue;
-
-        uint8_t* frame       = s_tx_frame_buf[idx];
-        uint8_t* enc_payload = s_tx_enc_buf[idx];
-        uint16_t enc_len     = 0;
-        uint8_t  bcc         = 0;
-        uint8_t  crypto      = g_protocol_last_rx_crypto[idx];
-        if (!proto_encrypt_payload(crypto,
-                                   payload,
-                                   len,
-                                   enc_payload,
-                                   (uint16_t)PROTOCOL_MAX_LEN,
-                                   &enc_len))
-        {
-            continue;
-        }
-        uint16_t total_len = (uint16_t)(enc_len + 10u);
-
-        frame[0] = 0x55;
-        frame[1] = 0x55;
-        frame[2] = (uint8_t)total_len;
-        frame[3] = crypto;
-        frame[4] = tx_seq;
-        /* Cmd：协议帧里是大端 */
-        frame[5] = (uint8_t)(cmd >> 8);
-        frame[6] = (uint8_t)(cmd & 0xFF);
-        if (enc_len > 0)
-            memcpy(&frame[7], enc_payload, enc_len);
-        for (uint16_t i = 0; i < (uint16_t)(7u + enc_len); i++)
-            bcc ^= frame[i];
-        frame[7 + enc_len] = bcc;
-        frame[8 + enc_len] = 0xAA;
-        frame[9 + enc_len] = 0xAA;
-
-        if (proto_send_frame(idx, frame, total_len))
+        (void)critical;
+        if (proto_send_frame(idx, blk->buf, total_len))
         {
             sent_any = true;
         }
-    }
-    return sent_any ? 0 : -3;
+        Conn_TxFree(blk);
 #endif
+    }
+    return sent_any ? 0 : -3; // 没有任何连接/订阅者
 }
@@ -0,0 +1,118 @@
+/*********************************************************************
+ * @file protocol_cmd_table.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 手机 FE/FD 命令描述符：O(1) 索引分派 + 数据化的 BLE->MCU 命令号映射
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 以前 Protocol_Process_FE/FD 每条命令线性扫一遍表（命中还 co_printf 一次），
+ *   BleFunc_MapBleCmdToMcuId 是一个几百行的 switch + if 梯子，
+ *   每加一条命令热路径就更长一截，规则散在代码里也没法统一校验。
+ * - 现在每条命令一个描述符 {cmd, handler, mcu 映射规则}：
+ *   1) 命令号高字节直接下标 256 项索引表（编译期由 X-macro 生成），查找 O(1)；
+ *   2) MCU 命令号映射写成数据（取哪个字节当 key、key 值 -> MCU id 表），
+ *      由 Protocol_Cmd_MapMcuId 统一解释，新命令只加一行表项。
+ * - 编译期校验：同一类型里高字节重复会变成 switch 的重复 case（编译报错），
+ *   低字节不是 FE/FD 会变成枚举里的除零（编译报错）。
+ *********************************************************************/
+
+#ifndef PROTOCOL_CMD_TABLE_H
+#define PROTOCOL_CMD_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void (*protocol_cmd_handler_t)(uint16_t cmd, const uint8_t* payload, uint8_t len);
+
+/* ==================== BLE -> MCU 命令号映射规则 ==================== */
+
+/* 映射 key 从哪里取（payload 一般以 Time6 开头，control 在 [6]） */
+typedef enum
+{
+    PROTOCOL_MCU_KEY_NONE = 0,   /**< 固定映射：直接取 dflt */
+    PROTOCOL_MCU_KEY_BYTE,       /**< key = payload[off] */
+    PROTOCOL_MCU_KEY_TIME6_OPT,  /**< 带 Time6（len>=7）取 payload[6]，否则取 payload[0] */
+    PROTOCOL_MCU_KEY_TIME6_LAST, /**< 带 Time6 取 payload[6]，否则取最后一个字节 */
+    PROTOCOL_MCU_KEY_LEN,        /**< key = payload_len - off（按长度区分子命令） */
+} protocol_mcu_key_t;
+
+/* key 后一字节（controlType）命中 type 时改用这一组映射 */
+typedef struct
+{
+    uint8_t         type;
+    uint8_t         n_ids;
+    uint16_t        dflt;
+    const uint16_t* ids;
+} protocol_mcu_sub_t;
+
+/*
+ * MCU id = (key < n_ids) ? ids[key] : dflt；payload 不够取 key 时为 short_id。
+ * 结果为 0 表示该 BLE 命令没有对应的 MCU 命令。
+ */
+typedef struct
+{
+    uint8_t                   key; /**< protocol_mcu_key_t */
+    uint8_t                   off;
+    uint8_t                   n_ids;
+    uint8_t                   n_sub;
+    uint16_t                  dflt;
+    uint16_t                  short_id;
+    const uint16_t*           ids;
+    const protocol_mcu_sub_t* sub;
+} protocol_mcu_map_t;
+
+#define PROTOCOL_ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+/* 固定映射 */
+#define PROTOCOL_MCU_FIXED(id) {PROTOCOL_MCU_KEY_NONE, 0u, 0u, 0u, (id), 0u, NULL, NULL}
+
+/* 按 key 查表（ids 必须是数组名） */
+#define PROTOCOL_MCU_TABLE(key, off, ids, dflt, short_id) \
+    {(key), (off), (uint8_t)PROTOCOL_ARRAY_SIZE(ids), 0u, (dflt), (short_id), (ids), NULL}
+
+/* 按 key 查表 + controlType 二级分派 */
+#define PROTOCOL_MCU_TABLE_SUB(key, off, ids, dflt, short_id, sub)                  \
+    {(key), (off), (uint8_t)PROTOCOL_ARRAY_SIZE(ids), (uint8_t)PROTOCOL_ARRAY_SIZE(sub), \
+     (dflt), (short_id), (ids), (sub)}
+
+/* ==================== 命令描述符 ==================== */
+
+typedef struct
+{
+    uint16_t                  cmd;
+    protocol_cmd_handler_t    handler; /**< 表内保证非空 */
+    const protocol_mcu_map_t* mcu;     /**< NULL：不是直接转发给 MCU 的命令 */
+} protocol_cmd_desc_t;
+
+/*
+ * 表生成辅助宏，配合各模块的 X-macro 命令列表使用：
+ *   #define FE_CMD_LIST(X) X(connect_ID, BleFunc_FE_Connect, NULL) ...
+ *   enum { FE_CMD_LIST(PROTOCOL_CMD_POS) };                       // 表内位置
+ *   static const protocol_cmd_desc_t tab[] = { FE_CMD_LIST(PROTOCOL_CMD_DESC) };
+ *   static const uint8_t idx[256] = { FE_CMD_LIST(PROTOCOL_CMD_INDEX) };
+ *   switch (hi) { FE_CMD_LIST(PROTOCOL_CMD_CASE) break; }        // 重复高字节 -> 编译错误
+ * 索引值 = 表内位置 + 1，0 表示未定义。
+ */
+#define PROTOCOL_CMD_POS(cmd, handler, mcu)  PROTOCOL_CMD_POS_##cmd,
+#define PROTOCOL_CMD_DESC(cmd, handler, mcu) {(uint16_t)(cmd), (handler), (mcu)},
+#define PROTOCOL_CMD_INDEX(cmd, handler, mcu) \
+    [((cmd) >> 8) & 0xFFu] = (uint8_t)(PROTOCOL_CMD_POS_##cmd + 1u),
+#define PROTOCOL_CMD_CASE(cmd, handler, mcu) case (((cmd) >> 8) & 0xFFu):
+
+/**
+ * @brief 按完整命令号查描述符（按低字节 FE/FD 选表，高字节直接下标）
+ * @return NULL 表示未定义的命令
+ */
+const protocol_cmd_desc_t* Protocol_Cmd_Find(uint16_t cmd);
+
+/**
+ * @brief 按映射规则把 BLE 命令翻译成 MCU 命令号
+ * @param payload 原始 payload（含 Time6）
+ * @return 0 表示没有对应的 MCU 命令
+ */
+uint16_t Protocol_Cmd_MapMcuId(const protocol_mcu_map_t* m,
+                               const uint8_t*            payload,
+                               uint16_t                  payload_len);
+
+#endif // PROTOCOL_CMD_TABLE_H
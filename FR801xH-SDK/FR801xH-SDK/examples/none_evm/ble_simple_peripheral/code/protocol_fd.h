@@ -3,6 +3,11 @@
 
 #include <stdint.h>
 
+#include "protocol_cmd_table.h"
+
+/* O(1)：命令号高字节直接下标索引表，NULL 表示未定义 */
+const protocol_cmd_desc_t* Protocol_FD_Find(uint16_t cmd);
+
 void Protocol_Process_FD(uint16_t cmd, uint8_t* payload, uint8_t len);
 
 #endif // __PROTOCOL_FD_H__
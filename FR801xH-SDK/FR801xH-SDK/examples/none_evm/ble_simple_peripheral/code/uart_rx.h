@@ -0,0 +1,151 @@
+/*********************************************************************
+ * @file uart_rx.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief SOC<->MCU UART 接收：SPSC 字节环 + 帧池 + 按连续块解析的帧/文本行解析器
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 旧实现每收 1 个字节就重新 uart0_read(&rx_byte, 1, cb)，并在中断回调里
+ *   跑完整的帧状态机；115200 波特率下 TPMS 转发 + 车况上报时约 11k 次/秒回调。
+ * - 现在拆成两半：
+ *   1) 中断里只把 UART FIFO 整块搬进字节环（单生产者），不解析；
+ *   2) user_task 里按环的连续区间（span）整块喂给解析器（单消费者），
+ *      数据段直接 memcpy，不再逐字节切状态。
+ * - 帧直接组在固定帧池的槽位里，交付的是带解析结果的描述符（uart_rx_frame_t），
+ *   上层不再 os_msg_malloc + memcpy，也不再重新校验帧头。
+ * - 本模块不依赖 SDK 驱动，主机上可直接编译（host/bench/uart_rx_bench.c）。
+ *
+ * 帧格式与校验见 soc_mcu_codec.h（本模块只负责行/帧分流和帧池，帧解码交给它）；
+ * 非 0xFE 开头的数据按文本行（\n 结束）处理。
+ *********************************************************************/
+
+#ifndef UART_RX_H
+#define UART_RX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "soc_mcu_codec.h"
+
+/* 单帧最大长度（与 SocMcu_Frame_Build 同一上限） */
+#define UART_RX_FRAME_MAX SOC_MCU_FRAME_MAX_LEN
+
+/* 编译器屏障：生产者先写数据再发布 head，消费者先用完数据再发布 tail */
+#if defined(__GNUC__)
+#define UART_RX_BARRIER() __asm volatile("" ::: "memory")
+#else
+#define UART_RX_BARRIER() __schedule_barrier()
+#endif
+
+/* ==================== SPSC 字节环 ==================== */
+
+/*
+ * head 只由生产者（UART 中断）写，tail 只由消费者（user_task）写，
+ * 两者都是自由递增的 16bit 下标，(head - tail) 即已用长度；
+ * 单核 M3 上 16bit 读写天然原子，因此两端都不需要关中断。
+ */
+typedef struct
+{
+    uint8_t*          buf;
+    uint16_t          mask;     /**< size - 1（size 必须是 2 的幂） */
+    volatile uint16_t head;     /**< 生产者写 */
+    volatile uint16_t tail;     /**< 消费者写 */
+    uint32_t          overflow; /**< 环满丢弃的字节数（生产者写） */
+} uart_rx_ring_t;
+
+/**
+ * @brief 初始化字节环
+ * @param size 缓冲大小，必须是 2 的幂且不超过 32768
+ * @return false 表示参数非法
+ */
+bool uart_rx_ring_init(uart_rx_ring_t* r, uint8_t* buf, uint16_t size);
+
+/* 生产者：当前可连续写入的区间（到缓冲尾或到 tail 为止），返回起始指针 */
+uint8_t* uart_rx_ring_write_span(uart_rx_ring_t* r, uint16_t* room);
+
+/* 生产者：发布已写入的 n 个字节 */
+void uart_rx_ring_produce(uart_rx_ring_t* r, uint16_t n);
+
+/* 消费者：当前可连续读取的区间，返回起始指针（*len 为 0 表示空） */
+const uint8_t* uart_rx_ring_read_span(uart_rx_ring_t* r, uint16_t* len);
+
+/* 消费者：释放已处理的 n 个字节 */
+void uart_rx_ring_consume(uart_rx_ring_t* r, uint16_t n);
+
+static inline uint16_t uart_rx_ring_used(const uart_rx_ring_t* r)
+{
+    return (uint16_t)(r->head - r->tail);
+}
+
+/* ==================== 帧池 + 块解析器 ==================== */
+
+/* 帧池槽位数：解析器占 1 个组帧，其余可被上层暂扣（延后处理）*/
+#ifndef UART_RX_FRAME_POOL
+#define UART_RX_FRAME_POOL 2u
+#endif
+
+/* 文本行（AT 调试命令）最大长度，超出按满行截断交付 */
+#ifndef UART_RX_LINE_MAX
+#define UART_RX_LINE_MAX 64u
+#endif
+
+/*
+ * 帧描述符：解码器组帧时已经校验过 head/sync/len/end 并边收边算好校验和，
+ * 上层直接用这里的字段，不再重新解析帧头、不再拷贝帧内容。
+ */
+typedef soc_mcu_frame_t uart_rx_frame_t;
+
+typedef struct
+{
+    uart_rx_frame_t desc; /**< 必须是第一个成员（release 按地址找回槽位） */
+    uint8_t         in_use;
+    uint8_t         buf[UART_RX_FRAME_MAX];
+} uart_rx_slot_t;
+
+/*
+ * 完整帧回调。
+ * @return false：回调内已处理完，槽位立即归还；
+ *         true ：上层暂扣该帧，处理完后调用 uart_rx_frame_release()。
+ */
+typedef bool (*uart_rx_frame_cb_t)(const uart_rx_frame_t* f);
+/* 一行文本（含结尾 \n，已补 '\0'，回调内可原地修改） */
+typedef void (*uart_rx_line_cb_t)(char* line, uint16_t len);
+
+typedef struct
+{
+    uint8_t            st;             /**< 解析状态（uart_rx.c 内部枚举） */
+    uint16_t           idx;            /**< 当前文本行已收长度 */
+    soc_mcu_dec_t      dec;            /**< 帧解码器（帧头收齐后才分配槽位） */
+    uart_rx_slot_t*    cur;            /**< 正在组帧的槽位；NULL 表示丢弃本帧 */
+    uart_rx_frame_cb_t on_frame;
+    uart_rx_line_cb_t  on_line;
+    uint32_t           frames;         /**< 交付的完整帧数 */
+    uint32_t           lines;          /**< 交付的文本行数 */
+    uint32_t           bad_frames;     /**< sync/len/end 不合法而丢弃的帧数 */
+    uint32_t           pool_exhausted; /**< 帧池无空闲槽位而丢弃的帧数 */
+    uart_rx_slot_t     pool[UART_RX_FRAME_POOL];
+    char               line[UART_RX_LINE_MAX];
+} uart_rx_parser_t;
+
+void uart_rx_parser_init(uart_rx_parser_t*  p,
+                         uart_rx_frame_cb_t on_frame,
+                         uart_rx_line_cb_t  on_line);
+
+/**
+ * @brief 解析一段连续字节（可以是任意切分，状态跨调用保存）
+ */
+void uart_rx_parse(uart_rx_parser_t* p, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief 归还被上层暂扣的帧（on_frame 返回 true 的那些）
+ */
+void uart_rx_frame_release(const uart_rx_frame_t* f);
+
+/**
+ * @brief 把环里当前全部数据按连续区间喂给解析器（最多两段：环尾 + 环头）
+ * @return 本次处理的字节数
+ */
+uint16_t uart_rx_drain(uart_rx_ring_t* r, uart_rx_parser_t* p);
+
+#endif // UART_RX_H
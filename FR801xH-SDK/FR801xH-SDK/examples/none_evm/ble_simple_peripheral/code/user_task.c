@@ -10,6 +10,7 @@
 #include "usart_cmd.h"
 
 #include "usart_device.h" 
+#include "uart_rx.h"
 #include "TPMS.h" // Add TPMS header
 
 /* MCU 回包判定需要把 UART 帧上报给 ble_function */
@@ -112,70 +113,22 @@ static void handle_at_command(char *line)
     co_printf("[TPMS] unknown cmd: %s\r\n", cmd);
 }
 
-typedef struct {
-    uint16_t len;
-    uint8_t data[1];
-} uart_frame_msg_t;
+/* 块解析器实例：只在 user_task 里使用（UART_Rx_Drain 的消费端） */
+static uart_rx_parser_t s_uart_rx_parser;
 
-static uint8_t BinComplementCheckSum(const uint8_t *buf, uint16_t len)
+/*
+ * head/sync/len/end 与校验和已由 uart_rx 解析器在组帧时处理，
+ * 这里直接用描述符里的字段；返回 false 表示处理完毕、帧池槽位立即归还。
+ */
+static bool handle_uart_frame(const uart_rx_frame_t *d)
 {
-    uint8_t sum = 0;
-    for (uint16_t i = 0; i < len; i++) {
-        sum = (uint8_t)(sum + buf[i]);
-    }
-    return (uint8_t)(~sum + 1u);
-}
-
-static void handle_uart_frame(const uart_frame_msg_t *m)
-{
-    if (!m || m->len < 1u) return;
-    const uint8_t *f = m->data;
-    const uint16_t flen = m->len;
-
-    /* 基本长度校验：head(1)+sync(1)+len(2)+feature(2)+id(2)+crc+end(2) */
-    const uint16_t min_len = (uint16_t)(1u + 1u + 2u + 2u + 2u + SOC_MCU_CRC_LEN + 2u);
-    if (flen < min_len) {
-        co_printf("[UART] frame too short: %u\r\n", (unsigned)flen);
-        return;
-    }
-    if (f[0] != SOC_MCU_FRAME_HEAD) {
-        co_printf("[UART] bad head: 0x%02X\r\n", (unsigned)f[0]);
-        return;
-    }
-    if (f[flen - 2] != SOC_MCU_FRAME_END0 || f[flen - 1] != SOC_MCU_FRAME_END1) {
-        co_printf("[UART] bad end: %02X %02X\r\n", (unsigned)f[flen - 2], (unsigned)f[flen - 1]);
-        return;
-    }
-
-    /* Big Endian Parsing */
-    uint16_t sync = (uint16_t)f[1]; /* 1 Byte Sync */
-    uint16_t len_field = (uint16_t)((f[2] << 8) | f[3]);
-    uint16_t feature = (uint16_t)((f[4] << 8) | f[5]);
-    uint16_t id = (uint16_t)((f[6] << 8) | f[7]);
-    if (len_field < 4u) {
-        co_printf("[UART] len too small: %u\r\n", (unsigned)len_field);
-        return;
-    }
-    uint16_t data_len = (uint16_t)(len_field - 4u);
-    /* total = head(1)+sync(1)+len(2)+feature(2)+id(2)+data+crc+end(2) */
-    uint16_t expected = (uint16_t)(1u + 1u + 2u + 2u + 2u + data_len + SOC_MCU_CRC_LEN + 2u);
-    if (expected != flen) {
-        co_printf("[UART] len mismatch: expected=%u actual=%u\r\n", (unsigned)expected, (unsigned)flen);
-        return;
-    }
-
-    if (sync != (SOC_MCU_SYNC_SOC_TO_MCU & 0xFF) && sync != (SOC_MCU_SYNC_MCU_TO_SOC & 0xFF)) {
-        co_printf("[UART] bad sync: 0x%02X\r\n", (unsigned)sync);
-        return;
-    }
-
-    const uint8_t *payload = &f[8];
-    const uint8_t *crc_ptr = &payload[data_len];
-
-    uint8_t crc_rx = crc_ptr[0];
-    uint16_t crc_off = (uint16_t)(8u + data_len);
-    uint8_t crc_calc = BinComplementCheckSum(&f[4], len_field);
-    bool crc_ok = (crc_calc == crc_rx);
+    if (!d) return false;
+    uint16_t sync = d->sync;
+    uint16_t feature = d->feature;
+    uint16_t id = d->id;
+    uint16_t data_len = d->data_len;
+    const uint8_t *payload = d->data;
+    bool crc_ok = d->crc_ok;
 
     co_printf("[UART] sync=0x%04X feature=0x%04X id=0x%04X data_len=%u crc_%s\r\n",
               (unsigned)sync,
@@ -234,12 +187,19 @@ static void handle_uart_frame(const uart_frame_msg_t *m)
                               CMD_Tire_pressure_monitoring_get,
                               resp_data,
                               sizeof(resp_data));
-            return; // Handled, no need to pass to BleFunc
+            return false; // Handled, no need to pass to BleFunc
         }
     }
 
     /* 上报?BLE 业务层：用于判断 MCU 是否回包 */
     BleFunc_OnMcuUartFrame(sync, feature, id, payload, data_len, (uint8_t)(crc_ok ? 1 : 0));
+    return false;
+}
+
+static void handle_uart_line(char *line, uint16_t len)
+{
+    (void)len;
+    handle_at_command(line);
 }
 
 static int user_task_func(os_event_t *param)
@@ -255,13 +215,9 @@ static int user_task_func(os_event_t *param)
                 }
             }
             break;
-        case USER_EVT_UART_FRAME:
-            {
-                const uart_frame_msg_t *m = (const uart_frame_msg_t *)param->param;
-                if (m) {
-                    handle_uart_frame(m);
-                }
-            }
+        case USER_EVT_UART_RX:
+            /* 中断只搬字节，帧/文本行在这里按块解析 */
+            UART_Rx_Drain(&s_uart_rx_parser);
             break;
         case USER_EVT_BUTTON:
             {
@@ -298,6 +254,7 @@ static int user_task_func(os_event_t *param)
 
 void user_task_init(void)
 {
+    uart_rx_parser_init(&s_uart_rx_parser, handle_uart_frame, handle_uart_line);
     user_task_id = os_task_create(user_task_func);
 }
 
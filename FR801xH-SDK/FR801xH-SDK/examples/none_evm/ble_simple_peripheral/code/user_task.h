@@ -3,7 +3,7 @@
 
 enum user_event_t {
     USER_EVT_AT_COMMAND,
-    USER_EVT_UART_FRAME,
+    USER_EVT_UART_RX, /* UART 字节环有新数据（不带参数），见 UART_Rx_Drain */
     USER_EVT_BUTTON,
 };
 
@@ -0,0 +1,185 @@
+/*********************************************************************
+ * @file bcc_bench.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief BCC 按字计算微基准：逐字节回扫 vs Bcc_Xor / Bcc_CopyXor
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 正确性（差分，任一不符返回 1）：
+ * - src/dst 各 0..3 字节错位、长度 0..260，Bcc_Xor / Bcc_CopyXor 与逐字节异或一致，
+ *   Bcc_CopyXor 拷贝结果与源一致且不越界写。
+ * 计时（只打印不判定）：组一帧明文 Notify 的“拷 payload + 算 BCC”
+ * - before：memcpy 到帧里，再从 Header 逐字节异或到 Data 末尾（改造前的写法）
+ * - after ：帧头 5 字节直接异或，Data 用 Bcc_CopyXor 边拷边算
+ * 以及收包校验：逐字节回扫 vs Bcc_Xor 整段。
+ *
+ * 用法：bcc_bench [--frames N] [--len L]
+ *********************************************************************/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bcc.h"
+#include "bench_timer.h"
+
+#define BENCH_DEFAULT_FRAMES 200000u
+#define BENCH_DEFAULT_LEN    240u
+#define BENCH_CHECK_MAX      260u
+#define BENCH_GUARD          0xC3u
+
+/* 逐字节参考实现（改造前的写法）；Cortex-M3 没有 SIMD，主机上关掉自动向量化才可比 */
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-tree-vectorize")))
+#endif
+static uint8_t ref_xor(uint8_t acc, const uint8_t* p, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        acc ^= p[i];
+    }
+    return acc;
+}
+
+static int bench_check(void)
+{
+    static uint8_t src[BENCH_CHECK_MAX + 8u];
+    static uint8_t dst[BENCH_CHECK_MAX + 16u];
+    int            fail = 0;
+
+    for (uint16_t i = 0; i < sizeof(src); i++)
+    {
+        src[i] = (uint8_t)(i * 37u + 11u);
+    }
+
+    for (uint8_t so = 0; so < 4u; so++)
+    {
+        for (uint8_t d = 0; d < 4u; d++)
+        {
+            for (uint16_t n = 0; n <= BENCH_CHECK_MAX; n++)
+            {
+                uint8_t want = ref_xor(0x5Au, &src[so], n);
+                if (Bcc_Xor(0x5Au, &src[so], n) != want)
+                {
+                    fprintf(stderr, "Bcc_Xor mismatch off=%u len=%u\n", so, n);
+                    fail = 1;
+                }
+
+                memset(dst, BENCH_GUARD, sizeof(dst));
+                uint8_t got = Bcc_CopyXor(0x5Au, &dst[4u + d], &src[so], n);
+                if (got != want || memcmp(&dst[4u + d], &src[so], n) != 0 ||
+                    dst[3u + d] != BENCH_GUARD || dst[4u + d + n] != BENCH_GUARD)
+                {
+                    fprintf(stderr, "Bcc_CopyXor mismatch src=%u dst=%u len=%u\n", so, d, n);
+                    fail = 1;
+                }
+            }
+        }
+    }
+    return fail;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frames = BENCH_DEFAULT_FRAMES;
+    uint16_t len    = BENCH_DEFAULT_LEN;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--len") == 0 && i + 1 < argc)
+        {
+            len = (uint16_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames N] [--len L]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (len > 240u)
+    {
+        len = 240u;
+    }
+
+    int fail = bench_check();
+
+    static uint8_t payload[256];
+    static uint8_t frame[256];
+    volatile uint8_t sink = 0;
+
+    for (uint16_t i = 0; i < sizeof(payload); i++)
+    {
+        payload[i] = (uint8_t)(i ^ 0xA5u);
+    }
+    frame[0] = 0x55;
+    frame[1] = 0x55;
+    frame[2] = (uint8_t)(len + 10u);
+    frame[3] = 0x00;
+    frame[4] = 0x01;
+    frame[5] = 0x13;
+    frame[6] = 0xFD;
+
+    /* TX：before = memcpy + 逐字节回扫；after = 帧头 5 字节 + Bcc_CopyXor */
+    uint64_t t0 = bench_now();
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        payload[0] = (uint8_t)f;
+        memcpy(&frame[7], payload, len);
+        frame[7 + len] = ref_xor(0, frame, (uint16_t)(7u + len));
+        sink ^= frame[7 + len];
+    }
+    uint64_t t_tx_old = (bench_now() - t0) / (frames ? frames : 1u);
+    uint8_t  bcc_old  = frame[7 + len];
+
+    t0 = bench_now();
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        payload[0] = (uint8_t)f;
+        uint8_t bcc = (uint8_t)(frame[2] ^ frame[3] ^ frame[4] ^ frame[5] ^ frame[6]);
+        frame[7 + len] = Bcc_CopyXor(bcc, &frame[7], payload, len);
+        sink ^= frame[7 + len];
+    }
+    uint64_t t_tx_new = (bench_now() - t0) / (frames ? frames : 1u);
+    if (frame[7 + len] != bcc_old)
+    {
+        fprintf(stderr, "TX BCC mismatch\n");
+        fail = 1;
+    }
+
+    /* RX：before = 逐字节到 BCC 前再比较；after = 连 BCC 一起按字异或，结果应为 0 */
+    t0 = bench_now();
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        sink ^= (uint8_t)(ref_xor(0, frame, (uint16_t)(7u + len)) == frame[7 + len]);
+    }
+    uint64_t t_rx_old = (bench_now() - t0) / (frames ? frames : 1u);
+
+    t0 = bench_now();
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        sink ^= (uint8_t)(Bcc_Xor(0, frame, (uint16_t)(8u + len)) == 0u);
+    }
+    uint64_t t_rx_new = (bench_now() - t0) / (frames ? frames : 1u);
+    if (Bcc_Xor(0, frame, (uint16_t)(8u + len)) != 0u)
+    {
+        fprintf(stderr, "RX BCC self-check failed\n");
+        fail = 1;
+    }
+
+    printf("bcc_bench (payload %u B, %u frames):\n", (unsigned)len, (unsigned)frames);
+    printf("  TX copy+BCC  before %6llu %s/frame  after %6llu %s/frame\n",
+           (unsigned long long)t_tx_old, BENCH_UNIT,
+           (unsigned long long)t_tx_new, BENCH_UNIT);
+    printf("  RX BCC check before %6llu %s/frame  after %6llu %s/frame\n",
+           (unsigned long long)t_rx_old, BENCH_UNIT,
+           (unsigned long long)t_rx_new, BENCH_UNIT);
+    (void)sink;
+    printf("bcc_bench: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
@@ -0,0 +1,55 @@
+/*********************************************************************
+ * @file bench_timer.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 主机基准程序共用的计时：x86 用 rdtsc 计 cycles，其它平台退回 ns；
+ *        同时报 ns 和 cycles 的基准直接用 bench_ns()/bench_cycles()
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 各基准在系统头文件之后包含（_GNU_SOURCE 等特性宏要先于 <time.h> 定义）。
+ *********************************************************************/
+
+#ifndef BENCH_TIMER_H
+#define BENCH_TIMER_H
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#define BENCH_UNIT     "cycles"
+#else
+#define BENCH_HAVE_TSC 0
+#define BENCH_UNIT     "ns"
+#endif
+
+/* 单调时钟，纳秒 */
+static inline uint64_t bench_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* TSC 计数；没有 TSC 的平台恒为 0，调用方据 BENCH_HAVE_TSC 决定是否打印 */
+static inline uint64_t bench_cycles(void)
+{
+#if BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0u;
+#endif
+}
+
+/* 单一计时源：有 TSC 用 cycles，否则用 ns，单位见 BENCH_UNIT */
+static inline uint64_t bench_now(void)
+{
+#if BENCH_HAVE_TSC
+    return bench_cycles();
+#else
+    return bench_ns();
+#endif
+}
+
+#endif // BENCH_TIMER_H
@@ -0,0 +1,221 @@
+/*********************************************************************
+ * @file crypto_bench.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief AES 会话微基准：每帧现算轮密钥 vs 会话缓存轮密钥
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 被测对象：48 字节 0x01FE（Connect）密文 payload 的解密 + 0x0101 回包
+ *          16 字节明文的加密，即一帧鉴权在加解密上的全部开销。
+ * - before：Algo_Bind + Algo_SetKeyIV 临时上下文（协议栈改造前的写法）
+ * - after ：Algo_Session_Open 一次，之后每帧直接复用
+ *
+ * 正确性：两条路径输出逐字节一致，否则返回非 0（ctest 以此判定）。
+ * 计时：x86_64 用 rdtsc 计 cycles，其它平台退回 ns；只打印不判定，
+ *       避免 CI 机器抖动导致误报。
+ *
+ * 用法：crypto_bench [--frames N]
+ *********************************************************************/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_timer.h"
+#include "en_de_algo.h"
+
+#define BENCH_DEFAULT_FRAMES 20000u
+#define BENCH_BATCH          64u
+#define BENCH_CT_LEN         48u
+#define BENCH_REPLY_LEN      16u
+
+/* 与 protocol.c 的 s_default_aes_key 一致 */
+static const uint8_t s_key[16] = {'Q', 'S', 'D', 'f', 'a', 'g', 'Q', '1',
+                                  '4', '1', 'G', 'S', '6', 'J', 'F', '8'};
+static const uint8_t s_iv[16]  = {0};
+
+static uint8_t s_plain[BENCH_CT_LEN];   /* 39B 明文 + PKCS7 */
+static uint8_t s_cipher[BENCH_CT_LEN];  /* 48B 密文（App 下发） */
+static uint8_t s_reply[BENCH_REPLY_LEN]; /* 0x0101 回包明文（已填充到块长） */
+
+typedef void (*bench_frame_fn)(Algo_Context_t* sess,
+                               uint8_t         rx[BENCH_CT_LEN],
+                               uint8_t         tx[BENCH_REPLY_LEN]);
+
+/* 改造前：每帧（收、发各一次）都 Bind + SetKeyIV，AES 每次重新展开密钥 */
+static void bench_frame_legacy(Algo_Context_t* sess,
+                               uint8_t         rx[BENCH_CT_LEN],
+                               uint8_t         tx[BENCH_REPLY_LEN])
+{
+    Algo_Context_t ctx;
+    (void)sess;
+
+    Algo_Bind(&ctx, ALGO_TYPE_AES_CBC);
+    Algo_SetKeyIV(&ctx, s_key, s_iv);
+    Algo_Decrypt(&ctx, rx, BENCH_CT_LEN, rx);
+
+    Algo_Bind(&ctx, ALGO_TYPE_AES_CBC);
+    Algo_SetKeyIV(&ctx, s_key, s_iv);
+    Algo_Encrypt(&ctx, tx, BENCH_REPLY_LEN, tx);
+}
+
+/* 改造后：会话已打开，直接复用预展开的轮密钥 */
+static void bench_frame_session(Algo_Context_t* sess,
+                                uint8_t         rx[BENCH_CT_LEN],
+                                uint8_t         tx[BENCH_REPLY_LEN])
+{
+    Algo_Decrypt(sess, rx, BENCH_CT_LEN, rx);
+    Algo_Encrypt(sess, tx, BENCH_REPLY_LEN, tx);
+}
+
+static int bench_cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* 返回每帧耗时中位数（按 BENCH_BATCH 帧一批计时，摊薄计时本身的开销） */
+static uint64_t bench_run(bench_frame_fn  fn,
+                          Algo_Context_t* sess,
+                          uint32_t        frames,
+                          uint8_t         out_rx[BENCH_CT_LEN],
+                          uint8_t         out_tx[BENCH_REPLY_LEN])
+{
+    uint32_t  batches = (frames + BENCH_BATCH - 1u) / BENCH_BATCH;
+    uint64_t* samples = (uint64_t*)calloc(batches, sizeof(uint64_t));
+    uint8_t   rx[BENCH_CT_LEN];
+    uint8_t   tx[BENCH_REPLY_LEN];
+
+    if (samples == NULL)
+    {
+        return 0;
+    }
+
+    for (uint32_t b = 0; b < batches; b++)
+    {
+        uint64_t t0 = bench_now();
+        for (uint32_t k = 0; k < BENCH_BATCH; k++)
+        {
+            memcpy(rx, s_cipher, sizeof(rx));
+            memcpy(tx, s_reply, sizeof(tx));
+            fn(sess, rx, tx);
+        }
+        samples[b] = (bench_now() - t0) / BENCH_BATCH;
+    }
+    memcpy(out_rx, rx, sizeof(rx));
+    memcpy(out_tx, tx, sizeof(tx));
+
+    qsort(samples, batches, sizeof(uint64_t), bench_cmp_u64);
+    uint64_t p50 = samples[batches / 2u];
+    free(samples);
+    return p50;
+}
+
+static void bench_build_vectors(void)
+{
+    static const uint8_t s_time6[6] = {0x1A, 0x01, 0x06, 0x11, 0x0E, 0x15};
+
+    memcpy(&s_plain[0], s_time6, 6);
+    memcpy(&s_plain[6], "6F35E30C05DBE6D747EB938DF71863D1", 32);
+    s_plain[38] = 0x01;
+    Algo_Padding(s_plain, 39u, 16u);
+
+    Algo_Context_t ctx;
+    Algo_Bind(&ctx, ALGO_TYPE_AES_CBC);
+    Algo_SetKeyIV(&ctx, s_key, s_iv);
+    Algo_Encrypt(&ctx, s_plain, BENCH_CT_LEN, s_cipher);
+
+    /* 0x0101 鉴权结果回包：result(1) + PKCS7 */
+    s_reply[0] = 0x01;
+    Algo_Padding(s_reply, 1u, 16u);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frames = BENCH_DEFAULT_FRAMES;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames < BENCH_BATCH)
+    {
+        frames = BENCH_BATCH;
+    }
+
+    bench_build_vectors();
+
+    static Algo_Context_t sess_a;
+    static Algo_Context_t sess_b;
+    if (!Algo_Session_Open(&sess_a, ALGO_TYPE_AES_CBC, s_key, s_iv) ||
+        !Algo_Session_Open(&sess_b, ALGO_TYPE_AES_CBC, s_key, s_iv))
+    {
+        fprintf(stderr, "crypto_bench: session open failed\n");
+        return 1;
+    }
+
+    int fail = 0;
+    /* 同一把 Key 的两个会话应共享同一份轮密钥（不随连接数成倍占 RAM） */
+    if (sess_a.sched == NULL || sess_a.sched != sess_b.sched)
+    {
+        fprintf(stderr, "crypto_bench: key schedule not shared\n");
+        fail = 1;
+    }
+
+    uint8_t rx_old[BENCH_CT_LEN], tx_old[BENCH_REPLY_LEN];
+    uint8_t rx_new[BENCH_CT_LEN], tx_new[BENCH_REPLY_LEN];
+
+    uint64_t t_old =
+        bench_run(bench_frame_legacy, NULL, frames, rx_old, tx_old);
+    uint64_t t_new =
+        bench_run(bench_frame_session, &sess_a, frames, rx_new, tx_new);
+
+    if (memcmp(rx_old, s_plain, BENCH_CT_LEN) != 0 ||
+        memcmp(rx_new, s_plain, BENCH_CT_LEN) != 0)
+    {
+        fprintf(stderr, "crypto_bench: decrypt mismatch\n");
+        fail = 1;
+    }
+    if (memcmp(tx_old, tx_new, BENCH_REPLY_LEN) != 0)
+    {
+        fprintf(stderr, "crypto_bench: encrypt mismatch\n");
+        fail = 1;
+    }
+
+    /* 关闭后再打开：轮密钥槽复用，不应泄漏引用 */
+    Algo_Session_Close(&sess_a);
+    Algo_Session_Close(&sess_b);
+    Algo_Session_Close(&sess_b);
+    if (!Algo_Session_Open(&sess_a, ALGO_TYPE_AES_CBC, s_key, s_iv) ||
+        sess_a.sched == NULL)
+    {
+        fprintf(stderr, "crypto_bench: session reopen failed\n");
+        fail = 1;
+    }
+    Algo_Session_Close(&sess_a);
+
+    printf("0x01FE frame (48B decrypt + 16B reply encrypt), %u frames\n",
+           (unsigned)frames);
+    printf("  before (per-frame key expansion): %8llu %s/frame\n",
+           (unsigned long long)t_old,
+           BENCH_UNIT);
+    printf("  after  (cached key schedule)    : %8llu %s/frame\n",
+           (unsigned long long)t_new,
+           BENCH_UNIT);
+    if (t_new != 0u)
+    {
+        printf("  speedup: %.2fx\n", (double)t_old / (double)t_new);
+    }
+    printf("%s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
@@ -0,0 +1,550 @@
+/*********************************************************************
+ * @file dispatch_bench.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 手机 FE/FD 命令分派微基准：线性扫表 + switch 映射 vs 高字节索引 + 数据化映射
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 对表里全部 FE/FD 命令（约 50 条）逐条计时“找到描述符 + 翻译 MCU 命令号”：
+ * - legacy：改造前的做法（按原表顺序线性比较 cmd，再走 BleFunc_MapBleCmdToMcuId
+ *   的 switch/if 梯子），代码原样保留在本文件末尾作为参照；
+ * - index ：Protocol_Cmd_Find（高字节直接下标）+ Protocol_Cmd_MapMcuId。
+ * 只计分派本身，不调用业务 handler（handler 在两种做法下完全相同）。
+ *
+ * 正确性（不一致返回 1，ctest 以此判定）：
+ * - 65536 个命令号逐个比较：索引查找命中 <=> 原表里有该命令，且描述符 cmd 一致；
+ * - 每条命令 x payload 长度 0..12 x key 值 0..255 x controlType 若干，
+ *   外加 payload 为 NULL，新旧 MCU 命令号映射必须完全一致。
+ * 耗时只打印不判定。
+ *
+ * 用法：dispatch_bench [--rounds N]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_timer.h"
+#include "protocol_cmd.h"
+#include "protocol_cmd_table.h"
+#include "usart_cmd.h"
+
+#define BENCH_DEFAULT_ROUNDS 2000u
+#define BENCH_SAMPLES        9u
+
+/* ==================== 改造前的做法（参照） ==================== */
+
+/* 原 s_fe_cmd_table / s_fd_cmd_table 的命令顺序（线性扫描的比较次数取决于它） */
+static const uint16_t s_legacy_fe[] = {
+    connect_ID,          defences_ID,         anti_theft_ID,       phone_message_ID,
+    riss_strength_ID,    car_search_ID,       factory_settings_ID, ble_unpair_ID,
+    add_nfc_ID,          delete_nfc_ID,       search_nfc_ID,       oil_defence_ID,
+    oil_car_search_ID,   set_boot_lock_ID,    set_nfc_ID,          set_seat_lock_ID,
+    set_car_mute_ID,     set_mid_box_lock_ID, set_emergency_mode_ID,
+    get_phone_mac_ID,    set_unlock_mode_ID,  charge_display_ID,
+};
+
+static const uint16_t s_legacy_fd[] = {
+    assistive_trolley,     delayed_headlight,      set_charging_power,
+    set_p_gear_mode,       set_chord_horn_mode,    set_RGB_light_mode,
+    set_auxiliary_parking, set_intelligent_switch, paramter_synchronize,
+    paramter_synchronize_change, set_default_mode, set_vichle_gurd_mode,
+    set_auto_return_mode,  set_EBS_switch,         set_E_SAVE_mode,
+    set_DYN_mode,          set_sport_mode,         set_lost_mode,
+    set_TCS_switch,        set_side_stand,         set_battery_parameter,
+    set_updata_APP,        set_HDC_mode,           set_HHC_mode,
+    set_start_ability,     set_sport_power_speed,  set_ECO_mode,
+    set_radar_switch,
+};
+
+#define BENCH_CMD_COUNT \
+    (sizeof(s_legacy_fe) / sizeof(s_legacy_fe[0]) + sizeof(s_legacy_fd) / sizeof(s_legacy_fd[0]))
+
+/* 返回表内位置，-1 表示未定义（与原 Protocol_Process_FE/FD 的 for 循环相同） */
+static int legacy_find(uint16_t cmd)
+{
+    const uint16_t* tab;
+    uint32_t        n;
+
+    if ((cmd & 0xFFu) == 0xFEu)
+    {
+        tab = s_legacy_fe;
+        n   = (uint32_t)(sizeof(s_legacy_fe) / sizeof(s_legacy_fe[0]));
+    }
+    else if ((cmd & 0xFFu) == 0xFDu)
+    {
+        tab = s_legacy_fd;
+        n   = (uint32_t)(sizeof(s_legacy_fd) / sizeof(s_legacy_fd[0]));
+    }
+    else
+    {
+        return -1;
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (tab[i] == cmd)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/* 原 BleFunc_MapBleCmdToMcuId（去掉注释，逻辑原样） */
+static uint16_t legacy_map_mcu_id(uint16_t       ble_cmd,
+                                  const uint8_t* payload,
+                                  uint16_t       payload_len) {
+    switch (ble_cmd) {
+    case 0x63FDu:
+        if (payload != NULL && payload_len >= 1u && payload_len < 7u) {
+            uint8_t control = payload[0];
+            if (payload_len >= 2u) {
+                uint8_t controlType = payload[1];
+                if (controlType == 0x04u) {
+                    return (control == 0x01u) ? (uint16_t)CMD_CHARGE_DISPLAY_ON
+                                              : (uint16_t)CMD_CHARGE_DISPLAY_OFF;
+                }
+                if (controlType == 0x0Au) {
+                    if (control == 0x01u)
+                        return (uint16_t)CMD_Three_shooting_lamp_on;
+                    if (control == 0x00u)
+                        return (uint16_t)CMD_Three_shooting_lamp_off;
+                    if (control == 0x02u)
+                        return (uint16_t)CMD_Three_shooting_lamp_default;
+                    return 0u;
+                }
+            }
+            if (control == 0x01u)
+                return (uint16_t)CMD_POWER_RECOVER_ON;
+            if (control == 0x00u)
+                return (uint16_t)CMD_POWER_RECOVER_OFF;
+            return 0u;
+        }
+        if (payload_len >= 8u && payload != NULL) {
+            uint8_t control     = payload[6];
+            uint8_t controlType = payload[7];
+            if (controlType == 0x04u) {
+                return (control == 0x01u) ? (uint16_t)CMD_CHARGE_DISPLAY_ON
+                                          : (uint16_t)CMD_CHARGE_DISPLAY_OFF;
+            }
+            if (controlType == 0x0Au) {
+                if (control == 0x01u)
+                    return (uint16_t)CMD_Three_shooting_lamp_on;
+                if (control == 0x00u)
+                    return (uint16_t)CMD_Three_shooting_lamp_off;
+                if (control == 0x02u)
+                    return (uint16_t)CMD_Three_shooting_lamp_default;
+                return 0u;
+            }
+        }
+        if (payload_len >= 7u && payload != NULL) {
+            uint8_t control = payload[6];
+            if (control == 0x01u)
+                return (uint16_t)CMD_POWER_RECOVER_ON;
+            if (control == 0x00u)
+                return (uint16_t)CMD_POWER_RECOVER_OFF;
+        }
+        return 0u;
+    case 0x09FDu:
+        (void)payload;
+        (void)payload_len;
+        return (uint16_t)CMD_OIL_VEHICLE_PREVENTION;
+    case 0x02FDu:
+        if (payload_len >= 7u && payload != NULL) {
+            uint8_t control = payload[6];
+            if (control == 0x01u)
+                return (uint16_t)CMD_Assistive_trolley_mode_on;
+            if (control == 0x00u)
+                return (uint16_t)CMD_Assistive_trolley_mode_off;
+            if (control == 0x02u)
+                return (uint16_t)CMD_Assistive_trolley_mode_default;
+        }
+        return 0u;
+    case 0x03FEu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x00u)
+                       ? (uint16_t)CMD_OIL_VEHICLE_UNPREVENTION
+                       : (uint16_t)CMD_OIL_VEHICLE_PREVENTION;
+        }
+        return 0u;
+    case 0x07FEu:
+        return (uint16_t)CMD_BLE_RSSI_RANGE_SET;
+    case 0x03FDu:
+        if (payload_len >= 7u && payload != NULL) {
+            uint8_t control = payload[6];
+            if (control == 0x01u)
+                return (uint16_t)CMD_Delayed_headlight_on;
+            if (control == 0x00u)
+                return (uint16_t)CMD_Delayed_headlight_off;
+            if (control == 0x02u)
+                return (uint16_t)CMD_Delayed_headlight_default;
+            if (control == 0x03u)
+                return (uint16_t)CMD_Delayed_headlight_time_set;
+        }
+        return 0u;
+    case 0x04FDu:  return (uint16_t)CMD_Charging_power_set;
+    case 0x05FDu:
+        if (payload_len >= 7u && payload != NULL) {
+            uint8_t control = payload[6];
+            if (control == 0x01u)
+                return (uint16_t)CMD_AUTO_P_GEAR_on;
+            if (control == 0x00u)
+                return (uint16_t)CMD_AUTO_P_GEAR_off;
+            if (control == 0x02u)
+                return (uint16_t)CMD_AUTO_P_GEAR_default;
+            if (control == 0x03u)
+                return (uint16_t)CMD_AUTO_P_GEAR_time_set;
+        }
+        return 0u;
+    case 0x06FDu:
+        (void)payload;
+        (void)payload_len;
+        return 0u;
+    case 0x07FDu:
+        return (uint16_t)CMD_Three_shooting_lamp_mode_set;
+    case 0x08FDu:
+        if (payload_len >= 7u && payload != NULL) {
+            uint8_t control = payload[6];
+            if (control == 0x01u)
+                return (uint16_t)CMD_Assistive_reversing_gear_on;
+            if (control == 0x00u)
+                return (uint16_t)CMD_Assistive_reversing_gear_off;
+            if (control == 0x02u)
+                return (uint16_t)CMD_Assistive_reversing_gear_default;
+        }
+        return 0u;
+    case 0x0AFDu:
+        if (payload_len >= 7u && payload != NULL) {
+            uint8_t control = payload[6];
+            if (control == 0x01u)
+                return (uint16_t)CMD_Automatic_steering_reset_on;
+            if (control == 0x00u)
+                return (uint16_t)CMD_Automatic_steering_reset_off;
+            if (control == 0x02u)
+                return (uint16_t)CMD_Automatic_steering_reset_default;
+        }
+        return 0u;
+    case 0x0BFEu:  return (uint16_t)CMD_ADD_NFC_KEY;
+    case 0x0CFEu:  return (uint16_t)CMD_DELETE_NFC_KEY;
+    case 0x0BFDu:
+        return (uint16_t)CMD_EBS_switch_on;
+    case 0x0CFDu:
+        if (payload_len >= 1u && payload != NULL) {
+            uint8_t control = payload[0];
+            if (control == 0x01u)
+                return (uint16_t)CMD_Low_speed_gear_on;
+            if (control == 0x00u)
+                return (uint16_t)CMD_Low_speed_gear_off;
+            if (control == 0x02u)
+                return (uint16_t)CMD_Low_speed_gear_default;
+        }
+        return 0u;
+    case 0x0DFDu:
+        if (payload_len >= 1u && payload != NULL) {
+            uint8_t control = payload[0];
+            if (control == 0x01u)
+                return (uint16_t)CMD_Medium_speed_gear_on;
+            if (control == 0x00u)
+                return (uint16_t)CMD_Medium_speed_gear_off;
+            if (control == 0x02u)
+                return (uint16_t)CMD_Medium_speed_gear_default;
+        }
+        return 0u;
+    case 0x0EFDu:
+        if (payload_len >= 1u && payload != NULL) {
+            uint8_t control = payload[0];
+            if (control == 0x01u)
+                return (uint16_t)CMD_High_speed_gear_on;
+            if (control == 0x00u)
+                return (uint16_t)CMD_High_speed_gear_off;
+            if (control == 0x02u)
+                return (uint16_t)CMD_High_speed_gear_default;
+        }
+        return 0u;
+    case 0x0FFDu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x01u) ? (uint16_t)CMD_Lost_mode_on
+                                         : (uint16_t)CMD_Lost_mode_off;
+        }
+        return 0u;
+    case 0x10FDu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x01u) ? (uint16_t)CMD_TCS_switch_on
+                                         : (uint16_t)CMD_TCS_switch_off;
+        }
+        return 0u;
+    case 0x11FDu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x01u) ? (uint16_t)CMD_Side_stand_switch_on
+                                         : (uint16_t)CMD_Side_stand_switch_off;
+        }
+        return 0u;
+    case 0x12FDu:
+        return (uint16_t)CMD_Battery_type_set;
+    case 0x14FDu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x01u) ? (uint16_t)CMD_HDC_switch_on
+                                         : (uint16_t)CMD_HDC_switch_off;
+        }
+        return 0u;
+    case 0x15FDu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x01u) ? (uint16_t)CMD_HHC_switch_on
+                                         : (uint16_t)CMD_HHC_switch_off;
+        }
+        return 0u;
+    case 0x0FFEu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x00u)
+                       ? (uint16_t)CMD_OIL_VEHICLE_UNPREVENTION
+                       : (uint16_t)CMD_OIL_VEHICLE_PREVENTION;
+        }
+        return 0u;
+    case 0x08FEu:
+        return (uint16_t)CMD_OIL_VEHICLE_FIND_STATUS;
+    case 0x11FEu:
+        return (uint16_t)CMD_OIL_VEHICLE_FIND_STATUS;
+    case 0x12FEu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x00u)
+                       ? (uint16_t)CMD_OIL_VEHICLE_UNLOCK_TRUNK
+                       : (uint16_t)CMD_OIL_VEHICLE_LOCK_TRUNK;
+        }
+        return 0u;
+    case 0x13FEu:  return (uint16_t)CMD_NFC_SWITCH;
+    case 0x14FEu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x00u) ? (uint16_t)CMD_VEHICLE_UNLOCK_SEAT
+                                         : (uint16_t)CMD_VEHICLE_LOCK_SEAT;
+        }
+        return 0u;
+    case 0x15FEu:  return (uint16_t)CMD_VEHICLE_MUTE_SETTING;
+    case 0x16FEu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x00u)
+                       ? (uint16_t)CMD_VEHICLE_UNLOCK_MIDDLE_BOX
+                       : (uint16_t)CMD_VEHICLE_LOCK_MIDDLE_BOX;
+        }
+        return 0u;
+    case 0x17FEu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x01u)
+                       ? (uint16_t)CMD_VEHICLE_EMERGENCY_MODE_LOCK
+                       : (uint16_t)CMD_VEHICLE_EMERGENCY_MODE_UNLOCK;
+        }
+        return 0u;
+    case 0x18FEu:
+        if (payload_len == 6u) {
+            return (uint16_t)CMD_BLE_MAC_READ;
+        }
+        if (payload_len == 7u) {
+            return (uint16_t)CMD_SINGLE_CONTROL_UNLOCK;
+        }
+        return 0u;
+    case 0x1AFEu:
+        if (payload_len >= 7u && payload != NULL) {
+            return (payload[6] == 0x01u) ? (uint16_t)CMD_CHARGE_DISPLAY_ON
+                                         : (uint16_t)CMD_CHARGE_DISPLAY_OFF;
+        }
+        return 0u;
+    case 0x04FEu: {
+        uint8_t status = 0u;
+        if (payload != NULL) {
+            if (payload_len >= 7u) {
+                status = payload[6];
+            } else if (payload_len >= 1u) {
+                status = payload[payload_len - 1u];
+            }
+        }
+        return (status == 0x01u) ? (uint16_t)CMD_BLE_RSSI_LOCK_ON
+                                 : (uint16_t)CMD_BLE_RSSI_LOCK_OFF;
+    }
+    default: return 0u;
+    }
+}
+
+/* ==================== 计时 ==================== */
+
+static uint16_t s_cmds[BENCH_CMD_COUNT];
+static uint8_t  s_payload[16];
+
+static int bench_cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t bench_legacy_one(uint16_t cmd)
+{
+    int pos = legacy_find(cmd);
+    return (uint32_t)(pos + 1) + legacy_map_mcu_id(cmd, s_payload, 7u);
+}
+
+static uint32_t bench_index_one(uint16_t cmd)
+{
+    const protocol_cmd_desc_t* d = Protocol_Cmd_Find(cmd);
+    if (d == NULL)
+    {
+        return 0u;
+    }
+    return (uint32_t)(d->handler != NULL) + Protocol_Cmd_MapMcuId(d->mcu, s_payload, 7u);
+}
+
+/* 单条命令的中位耗时（每个样本连续跑 rounds 次再平均） */
+static uint64_t bench_cmd(uint32_t (*fn)(uint16_t), uint16_t cmd, uint32_t rounds, uint32_t* sink)
+{
+    uint64_t samples[BENCH_SAMPLES];
+    for (uint32_t s = 0; s < BENCH_SAMPLES; s++)
+    {
+        uint64_t t0 = bench_now();
+        for (uint32_t r = 0; r < rounds; r++)
+        {
+            /* volatile 读命令号，防止整段被常量折叠 */
+            volatile uint16_t c = cmd;
+            *sink += fn(c);
+        }
+        samples[s] = (bench_now() - t0) / rounds;
+    }
+    qsort(samples, BENCH_SAMPLES, sizeof(samples[0]), bench_cmp_u64);
+    return samples[BENCH_SAMPLES / 2u];
+}
+
+/* ==================== 一致性 ==================== */
+
+static int bench_check_find(void)
+{
+    int fail = 0;
+    for (uint32_t c = 0; c <= 0xFFFFu; c++)
+    {
+        const protocol_cmd_desc_t* d = Protocol_Cmd_Find((uint16_t)c);
+        bool                       in_old = (legacy_find((uint16_t)c) >= 0);
+        if ((d != NULL) != in_old || (d != NULL && (d->cmd != c || d->handler == NULL)))
+        {
+            fprintf(stderr, "dispatch_bench: find mismatch for 0x%04X\n", (unsigned)c);
+            fail = 1;
+        }
+    }
+    return fail;
+}
+
+static int bench_check_map_one(uint16_t cmd, const uint8_t* p, uint16_t len)
+{
+    const protocol_cmd_desc_t* d   = Protocol_Cmd_Find(cmd);
+    uint16_t                   got = (d != NULL) ? Protocol_Cmd_MapMcuId(d->mcu, p, len) : 0u;
+    uint16_t                   exp = legacy_map_mcu_id(cmd, p, len);
+    if (got != exp)
+    {
+        fprintf(stderr, "dispatch_bench: map 0x%04X len %u p0 %02X p1 %02X p6 %02X: %04X != %04X\n",
+                (unsigned)cmd, (unsigned)len, p ? p[0] : 0u, p ? p[1] : 0u, p ? p[6] : 0u,
+                (unsigned)got, (unsigned)exp);
+        return 1;
+    }
+    return 0;
+}
+
+static int bench_check_map(void)
+{
+    static const uint8_t s_types[] = {0x00u, 0x01u, 0x02u, 0x03u, 0x04u, 0x05u, 0x0Au, 0xFFu};
+    uint8_t              p[16];
+    int                  fail = 0;
+
+    for (uint32_t k = 0; k < BENCH_CMD_COUNT && !fail; k++)
+    {
+        uint16_t cmd = s_cmds[k];
+        for (uint16_t len = 0; len <= 12u && !fail; len++)
+        {
+            fail |= bench_check_map_one(cmd, NULL, len);
+            for (uint32_t v = 0; v < 256u && !fail; v++)
+            {
+                /* 全部字节相同：覆盖“取最后一个字节”之类的规则 */
+                memset(p, (int)v, sizeof(p));
+                fail |= bench_check_map_one(cmd, p, len);
+                for (uint32_t t = 0; t < sizeof(s_types) && !fail; t++)
+                {
+                    /* control / controlType 放在带 Time6 与不带 Time6 两种位置 */
+                    memset(p, (int)(v ^ 0x5Au), sizeof(p));
+                    p[0] = (uint8_t)v;
+                    p[1] = s_types[t];
+                    p[6] = (uint8_t)v;
+                    p[7] = s_types[t];
+                    fail |= bench_check_map_one(cmd, p, len);
+                }
+            }
+        }
+    }
+    return fail;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t rounds = BENCH_DEFAULT_ROUNDS;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+        {
+            rounds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--rounds N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rounds == 0u)
+    {
+        rounds = 1u;
+    }
+
+    uint32_t n = 0u;
+    for (uint32_t i = 0; i < sizeof(s_legacy_fe) / sizeof(s_legacy_fe[0]); i++)
+    {
+        s_cmds[n++] = s_legacy_fe[i];
+    }
+    for (uint32_t i = 0; i < sizeof(s_legacy_fd) / sizeof(s_legacy_fd[0]); i++)
+    {
+        s_cmds[n++] = s_legacy_fd[i];
+    }
+    /* Time6 + control=0x01 + controlType=0x04 */
+    memset(s_payload, 0, sizeof(s_payload));
+    s_payload[6] = 0x01u;
+    s_payload[7] = 0x04u;
+
+    int fail = bench_check_find();
+    fail |= bench_check_map();
+
+    uint32_t sink      = 0u;
+    uint64_t sum_old   = 0u;
+    uint64_t sum_new   = 0u;
+    uint64_t worst_old = 0u;
+    uint64_t worst_new = 0u;
+    uint16_t worst_cmd = 0u;
+    for (uint32_t k = 0; k < n; k++)
+    {
+        uint64_t t_old = bench_cmd(bench_legacy_one, s_cmds[k], rounds, &sink);
+        uint64_t t_new = bench_cmd(bench_index_one, s_cmds[k], rounds, &sink);
+        sum_old += t_old;
+        sum_new += t_new;
+        if (t_old > worst_old)
+        {
+            worst_old = t_old;
+            worst_cmd = s_cmds[k];
+        }
+        if (t_new > worst_new)
+        {
+            worst_new = t_new;
+        }
+    }
+
+    printf("dispatch_bench: %u commands, %u rounds/sample (sink %u)\n", (unsigned)n,
+           (unsigned)rounds, (unsigned)(sink & 1u));
+    printf("  legacy scan + switch : avg %6.1f %s/cmd, worst %4llu (0x%04X)\n",
+           (double)sum_old / n, BENCH_UNIT, (unsigned long long)worst_old, (unsigned)worst_cmd);
+    printf("  index + map table    : avg %6.1f %s/cmd, worst %4llu\n", (double)sum_new / n,
+           BENCH_UNIT, (unsigned long long)worst_new);
+    printf("dispatch_bench: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
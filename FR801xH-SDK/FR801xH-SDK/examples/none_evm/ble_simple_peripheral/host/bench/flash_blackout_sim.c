@@ -0,0 +1,431 @@
+/*********************************************************************
+ * @file flash_blackout_sim.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief flash 擦写对中断/连接事件的影响：TPMS 绑定保存 + 一次完整 OTA
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 按 host_stubs 的 flash 耗时模型记账（默认扇区擦除 45ms、页擦除 10ms、整页编程 0.7ms，
+ * 可用 --se/--pe/--pp 改成实际 flash 手册的值）：
+ * - 回调内 flash 占用：一次 BLE/定时器回调里擦写花掉的时间，回调期间协议栈事件排队；
+ * - 中断停顿：擦写期间取指停顿、中断挂起，每段停顿按连接间隔折算“期望错过的连接事件”，
+ *   按 UART 波特率和接收 FIFO 深度折算“MCU 连续发送时会丢的字节”。
+ *
+ * 负载：
+ * 1. tpms bind：每轮换绑一个轮位并保存绑定表（与 tpms_bind_store_save 相同的 KV_Put），
+ *    每个回调之后跑一次 os 空闲循环（flash_job 在这里做预擦除）。
+ * 2. ota：SDK ota.c 原样编译，按手机 App 的顺序发 GET_STR_BASE / PAGE_ERASE /
+ *    WRITE_DATA / REBOOT；WRITE_DATA 单独统计，其余（含 REBOOT 时首页的页擦除）算擦除。
+ *
+ * 同一源码编三份：flash_blackout_sim（当前固件）、flash_blackout_sim_legacy
+ * （KV_STORE_BG_ERASE=0、OTA_SAVE_CHUNK=0，即改动前的同步擦除 + 整包写入）、
+ * flash_blackout_sim_page_erase（FLASH_JOB_ERASE_UNIT=0x100，Puya flash 按页预擦除）。
+ *
+ * 自检，任一不满足返回 1：
+ * - 重新上电后 TPMS 绑定表是最后一次保存的内容，OTA 镜像逐字节一致、每条回包成功；
+ * - 当前固件：TPMS 回调里没有扇区擦除；OTA 写入的单段中断停顿不超过
+ *   一个 OTA_SAVE_CHUNK 的编程时间；按页预擦除时 TPMS 的单段中断停顿短于一次扇区擦除。
+ *
+ * 用法：flash_blackout_sim [--cycles N] [--image KB] [--mtu N] [--ci-ms N]
+ *                          [--baud N] [--fifo N] [--se us] [--pe us] [--pp us]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TPMS.h"
+#include "driver_flash.h"
+#include "flash_job.h"
+#include "flash_usage_config.h"
+#include "host_stubs.h"
+#include "jump_table.h"
+#include "kv_store.h"
+#include "ota.h"
+
+#ifndef SIM_LEGACY
+#define SIM_LEGACY 0
+#endif
+
+#ifndef OTA_SAVE_CHUNK
+#define OTA_SAVE_CHUNK 64
+#endif
+
+#define SIM_IMAGE_SIZE 0x30000u /* 镜像 A 大小 = 镜像 B 起始地址，B 区在 KV 区之前结束 */
+#define SIM_LEARN_MS   1000u
+#define SIM_RSP_MAX    300u
+
+/* ota.c 里的 CRC32（OTA_CRC_CHECK 打开时对外可见） */
+uint32_t Crc32CalByByte(int crc, uint8_t* ptr, int len);
+
+typedef struct
+{
+    uint32_t calls;         /* 回调次数 */
+    uint32_t cb_max_us;     /* 单次回调内 flash 占用最大值 */
+    uint32_t blk_n;         /* 中断停顿段数 */
+    uint32_t blk_max_us;    /* 最长中断停顿 */
+    uint32_t blk_over_ci;   /* 超过一个连接间隔的停顿段数 */
+    double   ce_missed;     /* 期望错过的连接事件数 */
+    uint32_t uart_lost_max; /* 单段停顿最坏丢字节 */
+    uint64_t uart_lost;     /* 累计丢字节 */
+} sim_phase_t;
+
+static uint32_t     s_ci_us   = 30000u;
+static uint32_t     s_baud    = 115200u;
+static uint32_t     s_fifo    = 16u;
+static sim_phase_t* s_ph      = NULL;
+static uint32_t     s_rsp_bad = 0u;
+static uint32_t     s_rsp_n   = 0u;
+static uint8_t      s_rsp[SIM_RSP_MAX];
+static uint16_t     s_rsp_len = 0u;
+
+static void sim_blackout_hook(uint32_t us)
+{
+    if (s_ph == NULL)
+    {
+        return;
+    }
+    /* 10 bit/字节：停顿期间线上到达的字节，超出 FIFO 的部分被覆盖 */
+    uint64_t arrived = (uint64_t)us * s_baud / 10000000u;
+    uint32_t lost    = (arrived > s_fifo) ? (uint32_t)(arrived - s_fifo) : 0u;
+
+    s_ph->blk_n++;
+    s_ph->blk_max_us = (us > s_ph->blk_max_us) ? us : s_ph->blk_max_us;
+    s_ph->blk_over_ci += (us >= s_ci_us);
+    s_ph->ce_missed += (double)us / (double)s_ci_us;
+    s_ph->uart_lost += lost;
+    s_ph->uart_lost_max = (lost > s_ph->uart_lost_max) ? lost : s_ph->uart_lost_max;
+}
+
+/* 一次回调的开始/结束：记录回调内 flash 占用 */
+static uint64_t s_cb_t0;
+
+static void sim_cb_begin(sim_phase_t* ph)
+{
+    s_ph    = ph;
+    s_cb_t0 = host_flash_busy_us();
+}
+
+static void sim_cb_end(void)
+{
+    uint32_t us = (uint32_t)(host_flash_busy_us() - s_cb_t0);
+    s_ph->calls++;
+    s_ph->cb_max_us = (us > s_ph->cb_max_us) ? us : s_ph->cb_max_us;
+}
+
+/* ==================== 1. TPMS 绑定保存 ==================== */
+
+/* TPMS.c tpms_bind_store_t 的布局 */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    struct
+    {
+        uint8_t  valid;
+        uint8_t  rsv0[3];
+        uint32_t sensor_id;
+        uint8_t  mac_le[6];
+        uint8_t  rsv1[2];
+    } entry[TPMS_SENSOR_MAX];
+    uint16_t crc16;
+    uint16_t rsv2;
+} sim_bind_t;
+
+static uint16_t sim_crc16(const uint8_t* p, uint32_t n)
+{
+    uint16_t crc = 0xFFFFu;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        crc ^= (uint16_t)p[i] << 8;
+        for (uint8_t b = 0; b < 8u; b++)
+        {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/*
+ * 每轮换绑一个轮位，按 tpms_bind_store_save 的做法整表 KV_Put。
+ * 不走 TPMS_Replace_Start 的学习窗口：学习候选目前没有从广播收集，窗口到期不会绑定。
+ */
+static bool sim_tpms(uint32_t cycles, sim_phase_t* ph)
+{
+    sim_bind_t st, back;
+    bool       ok = true;
+
+    host_stubs_reset();
+    host_flash_reset();
+    FlashJob_Init();
+    KV_Init();
+    TPMS_Init();
+    host_run_idle();
+
+    memset(&st, 0, sizeof(st));
+    st.magic   = 0x534D5054u;
+    st.version = 1u;
+    st.size    = (uint16_t)sizeof(st);
+    for (uint32_t c = 0; c < cycles; c++)
+    {
+        uint32_t w = c % TPMS_SENSOR_MAX;
+
+        st.entry[w].valid     = 1u;
+        st.entry[w].sensor_id = 0x5A000000u + c;
+        st.entry[w].mac_le[0] = (uint8_t)c;
+        st.entry[w].mac_le[1] = (uint8_t)(c >> 8);
+        st.crc16              = sim_crc16((const uint8_t*)&st, (uint32_t)(sizeof(st) - 4u));
+
+        /* 手机/MCU 命令回调里保存；之后 os 空闲循环 */
+        sim_cb_begin(ph);
+        ok = KV_Put(KV_KEY_TPMS_BIND, &st, sizeof(st)) && ok;
+        sim_cb_end();
+        host_run_idle();
+    }
+    s_ph = NULL;
+
+    KV_Stats       kv;
+    FlashJob_Stats fj;
+    KV_GetStats(&kv);
+    FlashJob_GetStats(&fj);
+
+    FlashJob_Init(); /* 重新上电：绑定表从 kv_store 恢复 */
+    KV_Init();
+    TPMS_Init();
+    if (KV_Get(KV_KEY_TPMS_BIND, &back, sizeof(back)) != sizeof(st) ||
+        memcmp(&st, &back, sizeof(st)) != 0)
+    {
+        printf("  tpms: binding table lost across reboot\n");
+        ok = false;
+    }
+    printf("  tpms: %u saves, kv gc %u, erases %u; flash_job %u jobs / %u chunks, "
+           "%u flushed by GC\n",
+           (unsigned)cycles, (unsigned)kv.gc_runs, (unsigned)kv.erases, (unsigned)fj.jobs,
+           (unsigned)fj.chunks, (unsigned)fj.flushes);
+    return ok;
+}
+
+/* ==================== 2. OTA ==================== */
+
+static void sim_ota_rsp(uint8_t conidx, const uint8_t* data, uint16_t len)
+{
+    (void)conidx;
+    s_rsp_n++;
+    s_rsp_len = (len > SIM_RSP_MAX) ? SIM_RSP_MAX : len;
+    memcpy(s_rsp, data, s_rsp_len);
+    if (len < 1u || data[0] != OTA_RSP_SUCCESS)
+    {
+        s_rsp_bad++;
+    }
+}
+
+static void sim_ota_cmd(sim_phase_t* ph, uint8_t* pkt, uint16_t len)
+{
+    sim_cb_begin(ph);
+    app_otas_recv_data(0u, pkt, len);
+    sim_cb_end();
+    host_run_idle();
+}
+
+static bool sim_ota(uint32_t image_bytes, uint16_t mtu, sim_phase_t* ph_erase,
+                    sim_phase_t* ph_write)
+{
+    static uint8_t      image[SIM_IMAGE_SIZE];
+    uint8_t             pkt[600];
+    struct jump_table_t jt;
+    bool                ok = true;
+
+    host_stubs_reset();
+    host_flash_reset();
+    host_set_ota_rsp_hook(sim_ota_rsp);
+    host_set_mtu(mtu);
+
+    /* 正在运行的镜像 A：jump table 在 flash 0 地址 */
+    memset(&jt, 0, sizeof(jt));
+    jt.image_size       = SIM_IMAGE_SIZE;
+    jt.firmware_version = 1u;
+    flash_write(0u, sizeof(jt), (uint8_t*)&jt);
+
+    /* 新镜像：开头是 jump table（版本号更高，ota.c 不改写），后面伪随机 */
+    uint32_t seed = 5u;
+    for (uint32_t i = 0; i < image_bytes; i++)
+    {
+        seed     = seed * 1103515245u + 12345u;
+        image[i] = (uint8_t)(seed >> 16);
+    }
+    jt.firmware_version = 2u;
+    memcpy(image, &jt, sizeof(jt));
+
+    ota_init(0u);
+
+    /* GET_STR_BASE */
+    memset(pkt, 0, sizeof(pkt));
+    pkt[0] = OTA_CMD_GET_STR_BASE;
+    sim_ota_cmd(ph_erase, pkt, 3u);
+    uint32_t base;
+    memcpy(&base, &s_rsp[4], 4u);
+    if (base != SIM_IMAGE_SIZE)
+    {
+        printf("  ota: storage base 0x%X, expected 0x%X\n", (unsigned)base, SIM_IMAGE_SIZE);
+        return false;
+    }
+
+    /* PAGE_ERASE：每个 4KB 一条 */
+    for (uint32_t off = 0; off < image_bytes; off += 0x1000u)
+    {
+        struct app_ota_cmd_hdr_t* h = (struct app_ota_cmd_hdr_t*)pkt;
+        h->opcode                   = OTA_CMD_PAGE_ERASE;
+        h->length                   = sizeof(struct page_erase_cmd);
+        h->cmd.page_erase.base_address = base + off;
+        sim_ota_cmd(ph_erase, pkt, 3u + sizeof(struct page_erase_cmd));
+    }
+
+    /* WRITE_DATA：一包 = ATT 写入载荷（MTU-3）去掉 9 字节命令头 */
+    uint16_t chunk = (uint16_t)(mtu - 3u - 3u - sizeof(struct write_data_cmd));
+    for (uint32_t off = 0; off < image_bytes; off += chunk)
+    {
+        uint16_t                  n = (uint16_t)((image_bytes - off < chunk) ? image_bytes - off : chunk);
+        struct app_ota_cmd_hdr_t* h = (struct app_ota_cmd_hdr_t*)pkt;
+        h->opcode                   = OTA_CMD_WRITE_DATA;
+        h->length                   = (uint16_t)(sizeof(struct write_data_cmd) + n);
+        h->cmd.write_data.base_address = base + off;
+        h->cmd.write_data.length       = n;
+        memcpy(&pkt[3u + sizeof(struct write_data_cmd)], &image[off], n);
+        sim_ota_cmd(ph_write, pkt, (uint16_t)(3u + sizeof(struct write_data_cmd) + n));
+    }
+
+    /* REBOOT：带整包长度和 CRC32（从 256 字节起算，与 ota.c 一致） */
+    {
+        struct app_ota_cmd_hdr_t* h         = (struct app_ota_cmd_hdr_t*)pkt;
+        h->opcode                           = OTA_CMD_REBOOT;
+        h->length                           = sizeof(struct firmware_check);
+        h->cmd.fir_crc_data.firmware_length = image_bytes;
+        h->cmd.fir_crc_data.CRC32_data      = Crc32CalByByte(0, &image[256], (int)image_bytes - 256);
+        sim_ota_cmd(ph_erase, pkt, 3u + sizeof(struct firmware_check));
+    }
+    s_ph = NULL;
+
+    if (memcmp(host_flash_mem() + base, image, image_bytes) != 0)
+    {
+        printf("  ota: bank B differs from image\n");
+        ok = false;
+    }
+    if (s_rsp_bad != 0u || host_reset_count() != 1u)
+    {
+        printf("  ota: %u failed responses, %u resets\n", (unsigned)s_rsp_bad,
+               (unsigned)host_reset_count());
+        ok = false;
+    }
+    printf("  ota: %u KB image, MTU %u (%u B/packet), %u commands\n", (unsigned)(image_bytes / 1024u),
+           (unsigned)mtu, (unsigned)chunk, (unsigned)s_rsp_n);
+    host_set_ota_rsp_hook(NULL);
+    return ok;
+}
+
+/* ==================== 输出 ==================== */
+
+static void sim_print(const char* name, const sim_phase_t* p)
+{
+    printf("  %-10s %6u %9.2f %8u %9.2f %6u %10.2f %8u %10llu\n", name, (unsigned)p->calls,
+           p->cb_max_us / 1000.0, (unsigned)p->blk_n, p->blk_max_us / 1000.0,
+           (unsigned)p->blk_over_ci, p->ce_missed, (unsigned)p->uart_lost_max,
+           (unsigned long long)p->uart_lost);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t            cycles = 400u;
+    uint32_t            image  = 128u;
+    uint32_t            mtu    = 247u;
+    host_flash_timing_t tm;
+
+    host_flash_get_timing(&tm);
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        uint32_t v = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        if (strcmp(argv[i], "--cycles") == 0)
+            cycles = v;
+        else if (strcmp(argv[i], "--image") == 0)
+            image = v;
+        else if (strcmp(argv[i], "--mtu") == 0)
+            mtu = v;
+        else if (strcmp(argv[i], "--ci-ms") == 0)
+            s_ci_us = v * 1000u;
+        else if (strcmp(argv[i], "--baud") == 0)
+            s_baud = v;
+        else if (strcmp(argv[i], "--fifo") == 0)
+            s_fifo = v;
+        else if (strcmp(argv[i], "--se") == 0)
+            tm.sector_erase_us = v;
+        else if (strcmp(argv[i], "--pe") == 0)
+            tm.page_erase_us = v;
+        else if (strcmp(argv[i], "--pp") == 0)
+            tm.page_prog_us = v;
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (cycles == 0u || image < 1u || image * 1024u > SIM_IMAGE_SIZE || mtu < 23u || mtu > 512u ||
+        s_ci_us == 0u)
+    {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+    host_flash_set_timing(&tm);
+    host_set_blackout_hook(sim_blackout_hook);
+
+    sim_phase_t tpms, ota_erase, ota_write;
+    memset(&tpms, 0, sizeof(tpms));
+    memset(&ota_erase, 0, sizeof(ota_erase));
+    memset(&ota_write, 0, sizeof(ota_write));
+
+    printf("flash_blackout_sim (%s, erase unit 0x%X): SE %.1f ms, PE %.1f ms, PP %.2f ms/page, CI %u ms, "
+           "UART %u baud / %u B FIFO\n",
+           SIM_LEGACY ? "legacy: sync erase, whole-packet OTA writes"
+                      : "flash_job pre-erase, chunked OTA writes",
+           (unsigned)FLASH_JOB_ERASE_UNIT,
+           tm.sector_erase_us / 1000.0, tm.page_erase_us / 1000.0, tm.page_prog_us / 1000.0,
+           (unsigned)(s_ci_us / 1000u), (unsigned)s_baud, (unsigned)s_fifo);
+
+    bool ok = sim_tpms(cycles, &tpms);
+    ok      = sim_ota(image * 1024u, (uint16_t)mtu, &ota_erase, &ota_write) && ok;
+
+    printf("  %-10s %6s %9s %8s %9s %6s %10s %8s %10s\n", "workload", "calls", "cb max ms",
+           "stalls", "stall max", ">=CI", "missed CE", "UART max", "UART lost");
+    sim_print("tpms bind", &tpms);
+    sim_print("ota erase", &ota_erase);
+    sim_print("ota write", &ota_write);
+
+#if !SIM_LEGACY
+    /* 回调里不再有扇区擦除 */
+    if (tpms.cb_max_us >= tm.sector_erase_us)
+    {
+        printf("  tpms: sector erase still inside a callback (%u us)\n",
+               (unsigned)tpms.cb_max_us);
+        ok = false;
+    }
+    /* OTA 写入的单段停顿不超过一块的编程时间 */
+    uint32_t chunk_us =
+        tm.prog_setup_us + (tm.page_prog_us - tm.prog_setup_us) * OTA_SAVE_CHUNK / 256u;
+    if (ota_write.blk_max_us > chunk_us)
+    {
+        printf("  ota: write stall %u us exceeds one %u B chunk (%u us)\n",
+               (unsigned)ota_write.blk_max_us, (unsigned)OTA_SAVE_CHUNK, (unsigned)chunk_us);
+        ok = false;
+    }
+#if FLASH_JOB_ERASE_UNIT < 0x1000u
+    if (tpms.blk_max_us >= tm.sector_erase_us)
+    {
+        printf("  tpms: page-erase build still stalls for a sector erase\n");
+        ok = false;
+    }
+#endif
+#endif
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
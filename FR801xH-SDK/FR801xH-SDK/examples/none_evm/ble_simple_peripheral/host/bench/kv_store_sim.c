@@ -0,0 +1,477 @@
+/*********************************************************************
+ * @file kv_store_sim.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief kv_store 仿真：写放大 / 磨损分布 / 查找耗时 / 逐字节掉电恢复
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 1. 写放大：设置(16 B)、TPMS 绑定表(44 B)、TBOX 密钥(16 B)、NFC 钥匙表(96 B)
+ *    混合更新 N 次，对比旧做法（每项独占一个扇区，每次先擦后写）与 kv_store
+ *    的擦除次数、写入字节、单扇区最大擦除次数。
+ * 2. 查找：KV_Get 每次的周期数与 flash 读次数；写满一个扇区后 KV_Init 挂载耗时。
+ * 3. 掉电：一段跨 GC 的操作序列（覆盖写 + 删除 + 重写），掉电点从 0 扫到序列
+ *    写完所需的全部“字节 + 扇区”单位，每个点掉电后重新挂载并检查。
+ *
+ * 自检，任一不满足返回 1：
+ * - 写放大场景结束后重新挂载，每个键读回最后一次写入的值；
+ * - kv_store 的单扇区最大擦除次数小于旧做法的 1/10；
+ * - KV_Get 命中时只读一次 flash；
+ * - 每个掉电点：每个键是掉电前最后完成的值，或正在写的那个新值（删除同理），
+ *   并且恢复后还能继续写、写完重新挂载读得回。
+ *
+ * 用法：kv_store_sim [--updates N] [--lookups N] [--cut-step N]
+ *********************************************************************/
+
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_timer.h"
+#include "flash_job.h"
+#include "flash_op.h"
+#include "flash_usage_config.h"
+#include "host_stubs.h"
+#include "kv_store.h"
+
+#define SIM_KEYS          4u
+#define SIM_SECTOR        0x1000u
+#define SIM_REGION_BYTES  (KV_STORE_SECTORS * SIM_SECTOR)
+#define SIM_LEGACY_BASE   0x60000u /* 旧做法：每项一个扇区，放在空闲区 */
+#define SIM_CUT_OPS       48u
+
+typedef struct
+{
+    uint16_t key;
+    uint16_t len;
+    uint8_t  weight; /* 混合负载里的占比（%） */
+} sim_item_t;
+
+static const sim_item_t s_items[SIM_KEYS] = {
+    {KV_KEY_PARAM_64FD, 16u, 60u},
+    {KV_KEY_TPMS_BIND, 44u, 25u},
+    {KV_KEY_TBOX_KEY, 16u, 5u},
+    {KV_KEY_NFC_KEYS, 96u, 10u},
+};
+
+static uint32_t s_seed = 1u;
+
+/* 重新上电：RAM 里的 flash 作业队列随之清空，再挂载 */
+static void sim_boot(void)
+{
+    FlashJob_Init();
+    KV_Init();
+}
+
+static uint32_t sim_rand(void)
+{
+    s_seed = s_seed * 1103515245u + 12345u;
+    return s_seed >> 8;
+}
+
+/* (键, 版本) -> 确定性内容，版本不同内容必不同 */
+static void sim_value(uint32_t item, uint32_t ver, uint8_t* out)
+{
+    uint32_t x = (ver + 1u) * 2654435761u ^ (item * 40503u);
+    for (uint32_t i = 0; i < s_items[item].len; i++)
+    {
+        x      = x * 1664525u + 1013904223u;
+        out[i] = (uint8_t)(x >> 24);
+    }
+    out[0] = (uint8_t)ver;
+    out[1] = (uint8_t)(ver >> 8);
+}
+
+static uint32_t sim_pick(void)
+{
+    uint32_t r = sim_rand() % 100u;
+    for (uint32_t i = 0; i < SIM_KEYS; i++)
+    {
+        if (r < s_items[i].weight)
+        {
+            return i;
+        }
+        r -= s_items[i].weight;
+    }
+    return 0u;
+}
+
+/* 读回并比较；ver<0 表示应当不存在 */
+static bool sim_check(uint32_t item, int32_t ver)
+{
+    uint8_t  want[KV_VALUE_MAX];
+    uint8_t  got[KV_VALUE_MAX];
+    uint16_t len = KV_Get(s_items[item].key, got, sizeof(got));
+
+    if (ver < 0)
+    {
+        return len == 0u;
+    }
+    sim_value(item, (uint32_t)ver, want);
+    return len == s_items[item].len && memcmp(got, want, len) == 0;
+}
+
+/* ==================== 1. 写放大 / 磨损 ==================== */
+
+typedef struct
+{
+    uint64_t erases;
+    uint64_t prog_bytes;
+    uint64_t logical_bytes;
+    uint32_t max_wear;
+} sim_wa_t;
+
+static uint32_t sim_max_wear(uint32_t base, uint32_t sectors)
+{
+    uint32_t m = 0;
+    for (uint32_t i = 0; i < sectors; i++)
+    {
+        uint32_t e = host_flash_sector_erases(base + i * SIM_SECTOR);
+        m          = (e > m) ? e : m;
+    }
+    return m;
+}
+
+static sim_wa_t sim_wa_legacy(uint32_t updates)
+{
+    sim_wa_t r;
+    uint8_t  v[KV_VALUE_MAX];
+
+    memset(&r, 0, sizeof(r));
+    host_stubs_reset();
+    host_flash_reset();
+    s_seed = 7u;
+    for (uint32_t n = 0; n < updates; n++)
+    {
+        uint32_t item = sim_pick();
+        uint32_t addr = SIM_LEGACY_BASE + item * SIM_SECTOR;
+        sim_value(item, n, v);
+        flash_op_erase_sector(addr);
+        flash_op_write_direct(addr, v, s_items[item].len);
+        r.logical_bytes += s_items[item].len;
+    }
+    r.erases     = g_host_stats.flash_erases;
+    r.prog_bytes = g_host_stats.flash_bytes;
+    r.max_wear   = sim_max_wear(SIM_LEGACY_BASE, SIM_KEYS);
+    return r;
+}
+
+static sim_wa_t sim_wa_kv(uint32_t updates, bool* ok)
+{
+    sim_wa_t r;
+    uint8_t  v[KV_VALUE_MAX];
+    int32_t  last[SIM_KEYS] = {-1, -1, -1, -1};
+
+    memset(&r, 0, sizeof(r));
+    host_stubs_reset();
+    host_flash_reset();
+    sim_boot();
+    g_host_stats.flash_erases = 0u; /* 首次格式化不算 */
+    g_host_stats.flash_bytes  = 0u;
+    s_seed                    = 7u;
+    for (uint32_t n = 0; n < updates; n++)
+    {
+        uint32_t item = sim_pick();
+        sim_value(item, n, v);
+        if (!KV_Put(s_items[item].key, v, s_items[item].len))
+        {
+            *ok = false;
+        }
+        last[item] = (int32_t)n;
+        r.logical_bytes += s_items[item].len;
+    }
+    r.erases     = g_host_stats.flash_erases;
+    r.prog_bytes = g_host_stats.flash_bytes;
+    r.max_wear   = sim_max_wear(KV_STORE_BASE_ADDR, KV_STORE_SECTORS);
+
+    sim_boot(); /* 重新上电 */
+    for (uint32_t i = 0; i < SIM_KEYS; i++)
+    {
+        if (!sim_check(i, last[i]))
+        {
+            printf("  remount: key 0x%04X mismatch\n", (unsigned)s_items[i].key);
+            *ok = false;
+        }
+    }
+    return r;
+}
+
+static void sim_wa_print(const char* name, const sim_wa_t* r, uint32_t updates)
+{
+    printf("  %-7s: %6.1f erases/1000 upd  prog %5.2fx  (prog+erase) %7.2fx  max wear %u\n",
+           name,
+           (double)r->erases * 1000.0 / (double)updates,
+           (double)r->prog_bytes / (double)r->logical_bytes,
+           (double)(r->prog_bytes + r->erases * SIM_SECTOR) / (double)r->logical_bytes,
+           (unsigned)r->max_wear);
+}
+
+/* ==================== 2. 查找 / 挂载 ==================== */
+
+static bool sim_lookup(uint32_t lookups)
+{
+    uint8_t  buf[KV_VALUE_MAX];
+    uint64_t sink = 0;
+    KV_Stats st;
+
+    /* 写到活动扇区将满，让挂载扫描最长 */
+    for (uint32_t n = 0;; n++)
+    {
+        KV_GetStats(&st);
+        if (st.used + 64u > SIM_SECTOR)
+        {
+            break;
+        }
+        uint32_t item = n % SIM_KEYS;
+        sim_value(item, 100000u + n, buf);
+        KV_Put(s_items[item].key, buf, s_items[item].len);
+    }
+
+    uint64_t r0 = g_host_stats.flash_reads;
+    uint64_t t0 = bench_now();
+    sim_boot();
+    uint64_t mount = bench_now() - t0;
+    uint64_t mount_reads = g_host_stats.flash_reads - r0;
+    KV_GetStats(&st);
+
+    s_seed = 3u;
+    r0     = g_host_stats.flash_reads;
+    t0     = bench_now();
+    for (uint32_t n = 0; n < lookups; n++)
+    {
+        sink += KV_Get(s_items[sim_rand() % SIM_KEYS].key, buf, sizeof(buf));
+        sink += buf[0];
+    }
+    uint64_t get = bench_now() - t0;
+    uint64_t get_reads = g_host_stats.flash_reads - r0;
+
+    t0 = bench_now();
+    for (uint32_t n = 0; n < lookups; n++)
+    {
+        sink += KV_Get(0x7F00u, buf, sizeof(buf));
+    }
+    uint64_t miss = bench_now() - t0;
+
+    printf("  mount  : %8.0f %s, %u flash reads (%u B used, incl. spare-sector blank check)\n",
+           (double)mount, BENCH_UNIT, (unsigned)mount_reads, (unsigned)st.used);
+    printf("  get hit: %8.1f %s/op, %.2f flash reads/op\n", (double)get / lookups, BENCH_UNIT,
+           (double)get_reads / lookups);
+    printf("  get miss:%8.1f %s/op  (sink %llu)\n", (double)miss / lookups, BENCH_UNIT,
+           (unsigned long long)(sink & 0xFFu));
+    return get_reads == lookups;
+}
+
+/* ==================== 3. 掉电 ==================== */
+
+typedef struct
+{
+    uint32_t item;
+    bool     del;
+    uint32_t ver;
+} sim_op_t;
+
+static sim_op_t s_ops[SIM_CUT_OPS];
+static uint8_t  s_snapshot[SIM_REGION_BYTES];
+static int32_t  s_base_ver[SIM_KEYS];
+
+static void sim_apply(const sim_op_t* op)
+{
+    uint8_t v[KV_VALUE_MAX];
+    if (op->del)
+    {
+        KV_Del(s_items[op->item].key);
+    }
+    else
+    {
+        sim_value(op->item, op->ver, v);
+        KV_Put(s_items[op->item].key, v, s_items[op->item].len);
+    }
+}
+
+/* 初始状态：4 个键都有值，活动扇区剩约 300 B，后面的序列必然跨一次 GC */
+static void sim_cut_setup(void)
+{
+    uint8_t  v[KV_VALUE_MAX];
+    KV_Stats st;
+    uint32_t ver = 0;
+
+    host_stubs_reset();
+    host_flash_reset();
+    sim_boot();
+    for (;;)
+    {
+        KV_GetStats(&st);
+        if (st.gc_runs > 0u && st.used + 300u > SIM_SECTOR)
+        {
+            break;
+        }
+        uint32_t item = ver % SIM_KEYS;
+        sim_value(item, ver, v);
+        KV_Put(s_items[item].key, v, s_items[item].len);
+        s_base_ver[item] = (int32_t)ver;
+        ver++;
+    }
+    memcpy(s_snapshot, host_flash_mem() + KV_STORE_BASE_ADDR, SIM_REGION_BYTES);
+
+    s_seed = 11u;
+    for (uint32_t i = 0; i < SIM_CUT_OPS; i++)
+    {
+        s_ops[i].item = sim_rand() % SIM_KEYS;
+        s_ops[i].del  = (i % 9u == 4u);
+        s_ops[i].ver  = ver++;
+    }
+}
+
+static void sim_cut_restore(void)
+{
+    memcpy(host_flash_mem() + KV_STORE_BASE_ADDR, s_snapshot, SIM_REGION_BYTES);
+    sim_boot();
+}
+
+/* 前 n 个操作完成后各键的版本 */
+static void sim_model(uint32_t n, int32_t* ver)
+{
+    memcpy(ver, s_base_ver, sizeof(s_base_ver));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        ver[s_ops[i].item] = s_ops[i].del ? -1 : (int32_t)s_ops[i].ver;
+    }
+}
+
+static bool sim_power_cut(uint32_t step)
+{
+    uint32_t points = 0, fails = 0, gc_points = 0, torn_mounts = 0;
+
+    sim_cut_setup();
+
+    /* 不掉电跑一遍，量出整个序列的“字节 + 扇区”单位数 */
+    sim_cut_restore();
+    uint64_t b0 = g_host_stats.flash_bytes, e0 = g_host_stats.flash_erases;
+    for (uint32_t i = 0; i < SIM_CUT_OPS; i++)
+    {
+        sim_apply(&s_ops[i]);
+        host_run_idle();
+    }
+    uint32_t units = (uint32_t)(g_host_stats.flash_bytes - b0 + g_host_stats.flash_erases - e0);
+    KV_Stats st;
+    KV_GetStats(&st);
+    bool crossed_gc = st.gc_runs > 0u;
+
+    for (uint32_t cut = 0; cut <= units; cut += step)
+    {
+        int32_t  before[SIM_KEYS], after[SIM_KEYS];
+        uint32_t f = SIM_CUT_OPS;
+
+        sim_cut_restore();
+        host_flash_cut_arm(cut);
+        for (uint32_t i = 0; i < SIM_CUT_OPS; i++)
+        {
+            KV_GetStats(&st);
+            uint32_t gc0 = st.gc_runs;
+            sim_apply(&s_ops[i]);
+            host_run_idle(); /* 空闲时的下一扇区预擦除也在掉电范围内 */
+            if (host_flash_cut_fired())
+            {
+                KV_GetStats(&st);
+                gc_points += (st.gc_runs != gc0);
+                f = i;
+                break;
+            }
+        }
+        host_flash_cut_disarm();
+
+        sim_boot(); /* 重新上电 */
+        KV_GetStats(&st);
+        torn_mounts += (st.torn > 0u);
+        sim_model(f, before);
+        sim_model(f < SIM_CUT_OPS ? f + 1u : f, after);
+
+        bool ok = true;
+        for (uint32_t k = 0; k < SIM_KEYS; k++)
+        {
+            if (!sim_check(k, before[k]) && !sim_check(k, after[k]))
+            {
+                ok = false;
+            }
+        }
+
+        /* 恢复后继续可写 */
+        uint8_t v[KV_VALUE_MAX];
+        for (uint32_t k = 0; k < SIM_KEYS; k++)
+        {
+            sim_value(k, 900000u + k, v);
+            ok = KV_Put(s_items[k].key, v, s_items[k].len) && ok;
+        }
+        sim_boot();
+        for (uint32_t k = 0; k < SIM_KEYS; k++)
+        {
+            ok = sim_check(k, (int32_t)(900000u + k)) && ok;
+        }
+
+        if (!ok && fails++ < 5u)
+        {
+            printf("  cut @%u (op %u) FAILED\n", (unsigned)cut, (unsigned)f);
+        }
+        points++;
+    }
+
+    printf("  %u ops, %u units, %u cut points (%u inside GC, %u mounts dropped a torn record), "
+           "%u failed\n",
+           (unsigned)SIM_CUT_OPS, (unsigned)units, (unsigned)points, (unsigned)gc_points,
+           (unsigned)torn_mounts, (unsigned)fails);
+    return fails == 0u && crossed_gc && gc_points > 0u;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t updates  = 3000u;
+    uint32_t lookups  = 100000u;
+    uint32_t cut_step = 1u;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--updates") == 0 && i + 1 < argc)
+        {
+            updates = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--lookups") == 0 && i + 1 < argc)
+        {
+            lookups = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--cut-step") == 0 && i + 1 < argc)
+        {
+            cut_step = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--updates N] [--lookups N] [--cut-step N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (updates == 0u || lookups == 0u || cut_step == 0u)
+    {
+        fprintf(stderr, "kv_store_sim: counts must be > 0\n");
+        return 2;
+    }
+
+    bool ok = true;
+
+    printf("kv_store_sim: write amplification (%u mixed updates, %u sectors):\n",
+           (unsigned)updates, (unsigned)KV_STORE_SECTORS);
+    sim_wa_t legacy = sim_wa_legacy(updates);
+    sim_wa_t kv     = sim_wa_kv(updates, &ok);
+    sim_wa_print("legacy", &legacy, updates);
+    sim_wa_print("kv", &kv, updates);
+    ok = ok && kv.max_wear * 10u < legacy.max_wear;
+
+    printf("kv_store_sim: lookup (%u gets):\n", (unsigned)lookups);
+    ok = sim_lookup(lookups) && ok;
+
+    printf("kv_store_sim: power cut sweep (step %u):\n", (unsigned)cut_step);
+    ok = sim_power_cut(cut_step) && ok;
+
+    printf("kv_store_sim: %s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,528 @@
+/*********************************************************************
+ * @file mcu_txn_sim.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief BLE->MCU 事务引擎突发负载仿真：commands/s + 拒绝率
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 链路：App 帧 -> Protocol_Handle_Data -> BleFunc_* -> BleFunc_McuTxn_Start
+ *       （多步指令经 BleFunc_McuSeq_Start 拆成若干事务）
+ *       -> SocMcu_Frame_Send(桩，进 MCU 模型) -> MCU 模型按序回包
+ *       -> BleFunc_OnMcuUartFrame -> Protocol_Send_Unicast -> ntf_data(桩)
+ *
+ * MCU 模型（虚拟时钟，1ms 一拍）：
+ * - 帧到达 MCU 需要 --lat ms（UART 传输 + MCU 调度），回包同样 --lat ms；
+ * - MCU 串行处理，每条 --svc ms；
+ * - --loss 按百分比丢弃回包，用来覆盖超时路径。
+ *
+ * 负载：--conns 条链路各自鉴权后，每 --period ms 连发 --burst 条不同指令
+ * （混合 FE/FD 单步指令和 0x06FD 两步序列），持续 --seconds 秒。
+ *
+ * 输出：App 视角的 commands/s（成功回包/仿真秒）、拒绝率（被判忙的比例）、
+ * 超时数、平均回包延迟、在途/排队峰值。链接 fw_proto_mcu_single
+ * （BLEFUNC_MCU_TXN_SLOTS=1，等同旧的单槽实现）即可得到对照数据。
+ *
+ * 自检：每条指令必须恰好收到一个回包；否则返回 1。
+ * 开跑前另做序列发送失败自检（见 sim_seq_send_fail）。
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ble_function.h"
+#include "gap_api.h"
+#include "host_stubs.h"
+#include "protocol.h"
+#include "protocol_cmd.h"
+#include "usart_cmd.h"
+
+#define SIM_MAX_CONNS    3u
+#define SIM_MCU_FIFO_MAX 256u
+#define SIM_FRAME_MAX    64u
+
+/* Time6 统一用 BIN 格式 26-01-06 17:14:21（与 proto_bench 一致） */
+static const uint8_t s_time6[6] = {0x1A, 0x01, 0x06, 0x11, 0x0E, 0x15};
+
+/*
+ * 指令组合：每条都会走事务层；0x06FD 是两步序列（音源/音量两步并发下发）。
+ * 同一个突发里指令互不相同（同链路同指令在途会被判为重复提交）。
+ */
+typedef struct
+{
+    uint16_t cmd;
+    uint8_t  arg_len;
+    uint8_t  arg[2];
+} sim_cmd_t;
+
+static const sim_cmd_t s_mix[] = {
+    {defences_ID, 1u, {0x01}},
+    {set_chord_horn_mode, 2u, {0x01, 0x03}},
+    {set_seat_lock_ID, 1u, {0x01}},
+    {set_EBS_switch, 1u, {0x01}},
+    {car_search_ID, 1u, {0x01}},
+    {set_TCS_switch, 1u, {0x01}},
+    {set_side_stand, 1u, {0x01}},
+    {set_HDC_mode, 1u, {0x01}},
+};
+#define SIM_MIX_CNT (sizeof(s_mix) / sizeof(s_mix[0]))
+
+/* 序列发送失败自检：0x06FD 两步并发下发，0x0CFD（E-SAVE 1 档）先 on 再 speed_set 串行 */
+static const sim_cmd_t s_seq_probe[] = {
+    {set_chord_horn_mode, 2u, {0x01, 0x03}},
+    {set_E_SAVE_mode, 1u, {0x01}},
+};
+#define SIM_SEQ_PROBE_CNT (sizeof(s_seq_probe) / sizeof(s_seq_probe[0]))
+
+typedef struct
+{
+    uint32_t conns;
+    uint32_t burst;
+    uint32_t period_ms;
+    uint32_t seconds;
+    uint32_t lat_ms;
+    uint32_t svc_ms;
+    uint32_t loss_pct;
+} sim_cfg_t;
+
+/* ==================== MCU 模型 ==================== */
+typedef struct
+{
+    uint32_t due_ms; /* 回包到达 SoC 的时刻 */
+    uint16_t id;
+    bool     drop;
+} sim_mcu_reply_t;
+
+static sim_mcu_reply_t  s_mcu_fifo[SIM_MCU_FIFO_MAX];
+static uint32_t         s_mcu_head    = 0u;
+static uint32_t         s_mcu_cnt     = 0u;
+static uint32_t         s_mcu_free_ms = 0u; /* MCU 下一次空闲的时刻 */
+static uint32_t         s_lcg         = 12345u;
+static const sim_cfg_t* s_cfg         = NULL;
+
+static uint32_t sim_rand(void)
+{
+    s_lcg = s_lcg * 1103515245u + 12345u;
+    return (s_lcg >> 16) & 0x7FFFu;
+}
+
+static void sim_uart_hook(uint16_t       sync,
+                          uint16_t       feature,
+                          uint16_t       id,
+                          const uint8_t* data,
+                          uint16_t       len)
+{
+    (void)feature;
+    (void)data;
+    (void)len;
+    if (sync != SOC_MCU_SYNC_SOC_TO_MCU || s_mcu_cnt >= SIM_MCU_FIFO_MAX)
+    {
+        return;
+    }
+
+    /* MCU 串行处理：到达时刻与上一条处理完毕取较晚者，再加处理时间 */
+    uint32_t arrive = host_time_now_ms() + s_cfg->lat_ms;
+    uint32_t start  = (arrive > s_mcu_free_ms) ? arrive : s_mcu_free_ms;
+    s_mcu_free_ms   = start + s_cfg->svc_ms;
+
+    sim_mcu_reply_t* r = &s_mcu_fifo[(s_mcu_head + s_mcu_cnt) % SIM_MCU_FIFO_MAX];
+    r->due_ms          = s_mcu_free_ms + s_cfg->lat_ms;
+    r->id              = id;
+    r->drop            = (sim_rand() % 100u) < s_cfg->loss_pct;
+    s_mcu_cnt++;
+}
+
+static void sim_mcu_deliver(void)
+{
+    static const uint8_t ok[1] = {0x00};
+    while (s_mcu_cnt > 0u && s_mcu_fifo[s_mcu_head].due_ms <= host_time_now_ms())
+    {
+        sim_mcu_reply_t r = s_mcu_fifo[s_mcu_head];
+        s_mcu_head        = (s_mcu_head + 1u) % SIM_MCU_FIFO_MAX;
+        s_mcu_cnt--;
+        if (!r.drop)
+        {
+            BleFunc_OnMcuUartFrame(SOC_MCU_SYNC_MCU_TO_SOC,
+                                   SOC_MCU_FEATURE_FF02,
+                                   r.id,
+                                   ok,
+                                   (uint16_t)sizeof(ok),
+                                   1u);
+        }
+    }
+}
+
+/* ==================== App 侧 ==================== */
+typedef struct
+{
+    uint32_t sent;
+    uint32_t replies;
+    uint32_t ok;
+    uint32_t fail;
+    uint64_t sent_ms_sum;  /* 发送时刻之和 */
+    uint64_t reply_ms_sum; /* 回包时刻之和：每条恰好一个回包时，差值/条数 = 平均延迟 */
+    uint8_t  seq;
+} sim_conn_t;
+
+static sim_conn_t s_conn[SIM_MAX_CONNS];
+static bool       s_counting    = false;
+static uint16_t   s_probe_reply = 0u; /* 自检中额外计数的回包 cmd */
+
+/* App 指令对应的回包 cmd：xxFE -> xx01，xxFD -> xx02 */
+static uint16_t sim_reply_cmd(uint16_t cmd)
+{
+    return (uint16_t)((cmd & 0xFF00u) | (((cmd & 0xFFu) == 0xFEu) ? 0x01u : 0x02u));
+}
+
+static bool sim_is_mix_reply(uint16_t cmd)
+{
+    uint8_t lo = (uint8_t)(cmd & 0xFFu);
+    if (lo != 0x01u && lo != 0x02u)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < SIM_MIX_CNT; i++)
+    {
+        if ((s_mix[i].cmd >> 8) == (cmd >> 8) &&
+            ((s_mix[i].cmd & 0xFFu) == 0xFEu) == (lo == 0x01u))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sim_ntf_hook(uint8_t        conidx,
+                         uint8_t        att_idx,
+                         const uint8_t* data,
+                         uint16_t       len)
+{
+    (void)att_idx;
+    if (!s_counting || conidx >= SIM_MAX_CONNS || len < 11u)
+    {
+        return;
+    }
+    uint16_t cmd = (uint16_t)(((uint16_t)data[5] << 8) | data[6]);
+    if (!sim_is_mix_reply(cmd) && cmd != s_probe_reply)
+    {
+        return;
+    }
+    sim_conn_t* c = &s_conn[conidx];
+    c->replies++;
+    c->reply_ms_sum += host_time_now_ms();
+    if (data[7] == 0x00u)
+    {
+        c->ok++;
+    }
+    else
+    {
+        c->fail++;
+    }
+}
+
+static void sim_send(uint8_t conidx, uint16_t cmd, const uint8_t* arg, uint8_t arg_len)
+{
+    uint8_t     frame[SIM_FRAME_MAX];
+    sim_conn_t* c    = &s_conn[conidx];
+    uint16_t    plen = (uint16_t)(6u + arg_len);
+    uint16_t    i    = 0;
+
+    frame[i++] = 0x55;
+    frame[i++] = 0x55;
+    frame[i++] = (uint8_t)(plen + 10u);
+    frame[i++] = CRYPTO_TYPE_NONE;
+    frame[i++] = ++c->seq;
+    frame[i++] = (uint8_t)(cmd >> 8);
+    frame[i++] = (uint8_t)(cmd & 0xFFu);
+    memcpy(&frame[i], s_time6, 6);
+    i = (uint16_t)(i + 6u);
+    memcpy(&frame[i], arg, arg_len);
+    i = (uint16_t)(i + arg_len);
+
+    uint8_t bcc = 0;
+    for (uint16_t k = 0; k < i; k++)
+    {
+        bcc ^= frame[k];
+    }
+    frame[i++] = bcc;
+    frame[i++] = 0xAA;
+    frame[i++] = 0xAA;
+
+    if (s_counting)
+    {
+        c->sent++;
+        c->sent_ms_sum += host_time_now_ms();
+    }
+    Protocol_Handle_Data(conidx, frame, i);
+}
+
+static void sim_connect(uint8_t conidx)
+{
+    uint8_t arg[33];
+    memcpy(arg, "6F35E30C05DBE6D747EB938DF71863D1", 32);
+    arg[32] = 0x01; /* mobileSystem: android */
+    host_gap_set_connected(conidx, true);
+    Protocol_Auth_Clear(conidx);
+    sim_send(conidx, connect_ID, arg, (uint8_t)sizeof(arg));
+}
+
+/* 推进 1ms：先交付 MCU 回包，再走定时器（超时），最后刷日志 */
+static void sim_tick(void)
+{
+    sim_mcu_deliver();
+    host_time_advance(1u);
+    sim_mcu_deliver();
+    host_run_idle();
+}
+
+/* 发一条指令并等它结束；返回回包条数，*ok 为成功回包条数 */
+static uint32_t sim_probe_once(const sim_cmd_t* p, uint32_t* ok)
+{
+    sim_conn_t* c = &s_conn[0];
+
+    c->replies = c->ok = 0u;
+    sim_send(0u, p->cmd, p->arg, p->arg_len);
+    for (uint32_t t = 0; t < 2000u; t++)
+    {
+        sim_tick();
+    }
+    *ok = c->ok;
+    return c->replies;
+}
+
+/*
+ * 序列中途串口发送失败：第 fail_at 次 SocMcu_Frame_Send 立即返回 0。
+ * 失败经 Finish -> OnStepDone 重入序列推进，序列可能在重入时就结束；
+ * App 必须恰好收到一个失败回包，随后同一条指令的结果与注入前相同（序列槽已释放）。
+ * 单槽对照版里 0x06FD 的并发步骤本来就占不到槽位，所以和注入前比，不要求成功。
+ */
+static int sim_seq_send_fail(const sim_cfg_t* cfg)
+{
+    sim_cfg_t quiet = *cfg;
+
+    quiet.loss_pct = 0u;
+    s_cfg          = &quiet;
+    host_stubs_reset();
+    host_set_uart_hook(sim_uart_hook);
+    host_set_ntf_hook(sim_ntf_hook);
+    Protocol_Init();
+    sim_connect(0u);
+    for (uint32_t t = 0; t < 1000u; t++)
+    {
+        sim_tick();
+    }
+
+    for (uint32_t i = 0; i < SIM_SEQ_PROBE_CNT; i++)
+    {
+        const sim_cmd_t* p = &s_seq_probe[i];
+        uint32_t         ok0, ok1, ok2;
+
+        s_probe_reply = sim_reply_cmd(p->cmd);
+        s_counting    = true;
+        if (sim_probe_once(p, &ok0) != 1u)
+        {
+            fprintf(stderr, "mcu_txn_sim: seq 0x%04X: no reply\n", (unsigned)p->cmd);
+            return 1;
+        }
+        for (uint32_t fail_at = 0; fail_at < 2u; fail_at++)
+        {
+            host_set_uart_fail(fail_at, 1u);
+            uint32_t n1 = sim_probe_once(p, &ok1);
+            host_set_uart_fail(0u, 0u);
+            uint32_t n2 = sim_probe_once(p, &ok2);
+            if (n1 != 1u || ok1 != 0u || n2 != 1u || ok2 != ok0)
+            {
+                fprintf(stderr,
+                        "mcu_txn_sim: seq 0x%04X send fail at step %u: replies=%u ok=%u, "
+                        "then replies=%u ok=%u (expect 1/0 then 1/%u)\n",
+                        (unsigned)p->cmd,
+                        (unsigned)fail_at,
+                        (unsigned)n1,
+                        (unsigned)ok1,
+                        (unsigned)n2,
+                        (unsigned)ok2,
+                        (unsigned)ok0);
+                return 1;
+            }
+        }
+        s_counting = false;
+    }
+    s_probe_reply = 0u;
+    memset(s_conn, 0, sizeof(s_conn));
+    printf("mcu_txn_sim: sequence uart send failure at step 0/1: one failure reply each, slot released\n");
+    return 0;
+}
+
+static int sim_run(const sim_cfg_t* cfg)
+{
+    s_cfg = cfg;
+    host_stubs_reset();
+    host_set_uart_hook(sim_uart_hook);
+    host_set_ntf_hook(sim_ntf_hook);
+    Protocol_Init();
+
+    for (uint8_t k = 0; k < cfg->conns; k++)
+    {
+        sim_connect((uint8_t)k);
+    }
+    /* 鉴权阶段的 MCU 交互全部收尾后再开始计数 */
+    for (uint32_t t = 0; t < 1000u; t++)
+    {
+        sim_tick();
+    }
+
+    BleFunc_McuTxnStats_t st0;
+    BleFunc_McuTxn_GetStats(&st0);
+    s_counting      = true;
+    uint32_t t0     = host_time_now_ms();
+    uint32_t end_ms = cfg->seconds * 1000u;
+    uint32_t rr     = 0u;
+
+    for (uint32_t t = 0; t < end_ms; t++)
+    {
+        if ((t % cfg->period_ms) == 0u)
+        {
+            for (uint8_t k = 0; k < cfg->conns; k++)
+            {
+                for (uint32_t b = 0; b < cfg->burst; b++)
+                {
+                    const sim_cmd_t* m = &s_mix[(rr + b) % SIM_MIX_CNT];
+                    sim_send(k, m->cmd, m->arg, m->arg_len);
+                }
+            }
+            rr++;
+        }
+        sim_tick();
+    }
+    /* 收尾：等在途事务全部回包或超时 */
+    for (uint32_t t = 0; t < 2000u; t++)
+    {
+        sim_tick();
+    }
+    double secs = (double)(host_time_now_ms() - t0 - 2000u) / 1000.0;
+    s_counting  = false;
+
+    BleFunc_McuTxnStats_t st;
+    BleFunc_McuTxn_GetStats(&st);
+
+    sim_conn_t sum;
+    memset(&sum, 0, sizeof(sum));
+    for (uint32_t k = 0; k < cfg->conns; k++)
+    {
+        sum.sent += s_conn[k].sent;
+        sum.replies += s_conn[k].replies;
+        sum.ok += s_conn[k].ok;
+        sum.fail += s_conn[k].fail;
+        sum.sent_ms_sum += s_conn[k].sent_ms_sum;
+        sum.reply_ms_sum += s_conn[k].reply_ms_sum;
+    }
+
+    uint32_t submitted = st.submitted - st0.submitted;
+    uint32_t busy      = st.rejected_busy - st0.rejected_busy;
+    uint32_t timeouts  = st.timeouts - st0.timeouts;
+    double   reject    = (submitted > 0u) ? (100.0 * busy / submitted) : 0.0;
+    double   lat_avg   = (sum.replies > 0u)
+                             ? ((double)(sum.reply_ms_sum - sum.sent_ms_sum) /
+                                (double)sum.replies)
+                             : 0.0;
+
+    printf("mcu_txn_sim: conns=%u burst=%u period=%ums lat=%ums svc=%ums loss=%u%%\n",
+           (unsigned)cfg->conns,
+           (unsigned)cfg->burst,
+           (unsigned)cfg->period_ms,
+           (unsigned)cfg->lat_ms,
+           (unsigned)cfg->svc_ms,
+           (unsigned)cfg->loss_pct);
+    printf("cmds=%-6u ok=%-6u fail=%-6u cmds/s=%-8.1f reject=%5.1f%% timeouts=%-4u "
+           "lat_avg=%.1fms inflight_peak=%u queue_peak=%u\n",
+           (unsigned)sum.sent,
+           (unsigned)sum.ok,
+           (unsigned)sum.fail,
+           (double)sum.ok / secs,
+           reject,
+           (unsigned)timeouts,
+           lat_avg,
+           (unsigned)st.max_inflight,
+           (unsigned)st.max_queued);
+
+    /* 自检：每条指令恰好一个回包；成功 + 判忙 + 超时 覆盖全部失败 */
+    if (sum.sent == 0u || sum.replies != sum.sent || sum.ok + sum.fail != sum.sent)
+    {
+        fprintf(stderr,
+                "mcu_txn_sim: reply accounting broken sent=%u replies=%u\n",
+                (unsigned)sum.sent,
+                (unsigned)sum.replies);
+        return 1;
+    }
+    if (cfg->loss_pct == 0u && sum.fail != busy + timeouts)
+    {
+        fprintf(stderr,
+                "mcu_txn_sim: fail=%u but busy=%u timeouts=%u\n",
+                (unsigned)sum.fail,
+                (unsigned)busy,
+                (unsigned)timeouts);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    sim_cfg_t cfg = {
+        .conns     = SIM_MAX_CONNS,
+        .burst     = 4u,
+        .period_ms = 100u,
+        .seconds   = 10u,
+        .lat_ms    = 4u,
+        .svc_ms    = 2u,
+        .loss_pct  = 0u,
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        uint32_t* dst = NULL;
+        if (strcmp(argv[i], "--conns") == 0)
+            dst = &cfg.conns;
+        else if (strcmp(argv[i], "--burst") == 0)
+            dst = &cfg.burst;
+        else if (strcmp(argv[i], "--period") == 0)
+            dst = &cfg.period_ms;
+        else if (strcmp(argv[i], "--seconds") == 0)
+            dst = &cfg.seconds;
+        else if (strcmp(argv[i], "--lat") == 0)
+            dst = &cfg.lat_ms;
+        else if (strcmp(argv[i], "--svc") == 0)
+            dst = &cfg.svc_ms;
+        else if (strcmp(argv[i], "--loss") == 0)
+            dst = &cfg.loss_pct;
+
+        if (dst == NULL || i + 1 >= argc)
+        {
+            fprintf(stderr,
+                    "usage: %s [--conns N] [--burst N] [--period MS] [--seconds N]\n"
+                    "          [--lat MS] [--svc MS] [--loss PCT]\n",
+                    argv[0]);
+            return 2;
+        }
+        *dst = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    if (cfg.conns == 0u || cfg.conns > SIM_MAX_CONNS)
+    {
+        cfg.conns = SIM_MAX_CONNS;
+    }
+    if (cfg.burst > SIM_MIX_CNT)
+    {
+        cfg.burst = SIM_MIX_CNT;
+    }
+    if (cfg.period_ms == 0u)
+    {
+        cfg.period_ms = 1u;
+    }
+    if (sim_seq_send_fail(&cfg) != 0)
+    {
+        return 1;
+    }
+    return sim_run(&cfg);
+}
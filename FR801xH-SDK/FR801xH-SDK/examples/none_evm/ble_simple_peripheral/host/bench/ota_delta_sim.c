@@ -0,0 +1,321 @@
+/*********************************************************************
+ * @file ota_delta_sim.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 差分 OTA：补丁在设备重建器上的回放校验，传输量对比整包 / LZ 压缩包
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 仓库里只有一版固件，发版用 ota_delta_enc.h 的“发版模型”在真实固件上模拟：
+ * - identical：原样重发（只改版本号）；
+ * - edit：ble_function.c 里 4 个函数各改几条指令；
+ * - grow1k / grow4k：再让其中一个函数变长 1KB / 4KB，后面的代码整体平移；
+ * - unrelated：第二个固件（central）当旧镜像，补丁接近整包，只验证正确性；
+ * - --old/--new 给一对真实固件时再加一项 release。
+ *
+ * 回放：补丁按 1~--chunk 字节随机切包，每包（和之后每个泵定时周期）最多复制 --budget 字节，
+ * 与 ota.c 的做法一致；读旧镜像的偏移必须 >= 256。重建结果必须与新镜像逐字节一致，
+ * 且正好在补丁最后一个字节处结束；旧镜像不符（中间改一个字节）必须在补丁头处就被拒绝，
+ * 截断或改了字节的补丁不能结束。edit / grow 的补丁必须比 LZ 压缩包小，否则返回 1。
+ *
+ * 用法：ota_delta_sim [--chunk N] [--budget N] [--kbps N] [--old old.axf --new new.axf]
+ *                      firmware.axf [unrelated.axf]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ota_delta.h"
+#include "ota_delta_enc.h"
+#include "ota_lz.h"
+#include "ota_lz_enc.h"
+
+#ifndef OTA_LZ_WINDOW_BITS
+#define OTA_LZ_WINDOW_BITS 11
+#endif
+
+#define SIM_MAX_FUNCS 4096u
+
+static const uint8_t* s_old;
+static uint32_t       s_old_len;
+static uint32_t       s_old_crc;
+static uint8_t*       s_out;
+static uint32_t       s_out_cap;
+static uint32_t       s_pages;
+static bool           s_bad_read;
+
+static void sim_read(uint8_t* dst, uint32_t old_offset, uint32_t len)
+{
+    if (old_offset < OTA_DELTA_PAGE || old_offset + len > s_old_len)
+    {
+        s_bad_read = true;
+        memset(dst, 0, len);
+        return;
+    }
+    memcpy(dst, &s_old[old_offset], len);
+}
+
+static void sim_page(const uint8_t* page, uint32_t offset, uint32_t len)
+{
+    if (offset + len <= s_out_cap)
+    {
+        memcpy(&s_out[offset], page, len);
+    }
+    s_pages++;
+}
+
+/* 设备端 check_fn：运行区长度和 CRC 与补丁头一致 */
+static uint8_t sim_check(const struct ota_delta_hdr* hdr)
+{
+    return hdr->old_length == s_old_len && hdr->old_crc == s_old_crc && hdr->new_length <= s_out_cap;
+}
+
+static uint32_t sim_rand(uint32_t* s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+typedef struct
+{
+    uint8_t  state;
+    uint32_t consumed; /* 结束时消费的补丁字节数 */
+    uint32_t tail;     /* 补丁收完后还要几个泵周期 */
+} sim_apply_t;
+
+/* 按设备的节奏回放：每包先做预算内的复制，再喂能喂的输入；补丁收完后按泵周期继续 */
+static sim_apply_t sim_apply(const uint8_t* patch, uint32_t m, uint32_t chunk, uint32_t budget, uint32_t seed)
+{
+    struct ota_delta_t d;
+    uint8_t            page[OTA_DELTA_PAGE];
+    uint32_t           rng = seed | 1u, avail = 0u, used = 0u;
+    sim_apply_t        r;
+
+    memset(&r, 0, sizeof(r));
+    s_pages    = 0u;
+    s_bad_read = false;
+    ota_delta_init(&d, page, sim_read, sim_page, sim_check);
+    for (;;)
+    {
+        if (avail < m)
+        {
+            uint32_t n = 1u + sim_rand(&rng) % chunk;
+            avail      = (m - avail < n) ? m : avail + n;
+        }
+        else
+        {
+            r.tail++;
+        }
+
+        uint32_t left = budget;
+        for (;;)
+        {
+            if (ota_delta_state(&d) == OTA_DELTA_COPYING)
+            {
+                uint32_t before = d.out_pos;
+                ota_delta_copy(&d, left);
+                left -= d.out_pos - before;
+                if (ota_delta_state(&d) == OTA_DELTA_COPYING)
+                    break;
+            }
+            if (used == avail || ota_delta_state(&d) == OTA_DELTA_ERROR)
+                break;
+            used += ota_delta_feed(&d, patch + used, avail - used);
+        }
+
+        uint8_t st = ota_delta_state(&d);
+        if (st == OTA_DELTA_ERROR || (avail == m && used == m && st != OTA_DELTA_COPYING) || r.tail > 1000000u)
+            break;
+    }
+    r.state    = ota_delta_state(&d);
+    r.consumed = used;
+    return r;
+}
+
+typedef struct
+{
+    uint32_t chunk;
+    uint32_t budget;
+    uint32_t kbps;
+} sim_opts_t;
+
+static bool sim_scenario(const char* name, const uint8_t* old, uint32_t old_len, const uint8_t* img, uint32_t n,
+                         bool must_beat_lz, const sim_opts_t* o, uint32_t seed)
+{
+    bool     ok    = true;
+    uint8_t* patch = (uint8_t*)malloc(OTA_DELTA_ENC_BOUND(n));
+    uint8_t* comp  = (uint8_t*)malloc(OTA_LZ_ENC_BOUND(n));
+    s_out          = (uint8_t*)malloc(n);
+    s_out_cap      = n;
+    s_old          = old;
+    s_old_len      = old_len;
+    s_old_crc      = ota_delta_crc32(0u, old + 256, old_len - 256u);
+
+    ota_delta_stats_t st;
+    uint32_t          m  = ota_delta_encode(old, old_len, img, n, patch, &st);
+    uint32_t          lz = ota_lz_encode(img, n, OTA_LZ_WINDOW_BITS, comp);
+
+    /* 回放：字节一致、正好在补丁末尾结束、不读首页 */
+    memset(s_out, 0, n);
+    sim_apply_t r = sim_apply(patch, m, o->chunk, o->budget, seed);
+    if (r.state != OTA_DELTA_DONE || r.consumed != m || memcmp(s_out, img, n) != 0 || s_bad_read)
+    {
+        printf("  %-10s apply failed: state %u, consumed %u/%u%s\n", name, (unsigned)r.state,
+               (unsigned)r.consumed, (unsigned)m, s_bad_read ? ", read outside [256, old_length)" : "");
+        ok = false;
+    }
+    uint32_t tail = r.tail;
+
+    /* 截断、改了一个字节的补丁不能结束（改到插入的数据上靠新镜像 CRC 兜住） */
+    r = sim_apply(patch, m - 1u, o->chunk, o->budget, seed);
+    if (r.state == OTA_DELTA_DONE)
+    {
+        printf("  %-10s truncated patch accepted\n", name);
+        ok = false;
+    }
+    for (uint32_t k = 1u; k < 8u; k++)
+    {
+        uint32_t at = OTA_DELTA_HDR_LEN + (m - OTA_DELTA_HDR_LEN) * k / 8u;
+        patch[at] ^= 0x01u;
+        r = sim_apply(patch, m, o->chunk, o->budget, seed);
+        patch[at] ^= 0x01u;
+        if (r.state == OTA_DELTA_DONE)
+        {
+            printf("  %-10s corrupt patch (byte %u) accepted\n", name, (unsigned)at);
+            ok = false;
+        }
+    }
+
+    /* 运行区不是这个旧镜像：头一收齐就拒绝，一页都不输出 */
+    uint8_t* wrong = (uint8_t*)malloc(old_len);
+    memcpy(wrong, old, old_len);
+    wrong[old_len / 2u] ^= 0x5Au;
+    s_old     = wrong;
+    s_old_crc = ota_delta_crc32(0u, wrong + 256, old_len - 256u);
+    r         = sim_apply(patch, m, o->chunk, o->budget, seed);
+    if (r.state != OTA_DELTA_ERROR || r.consumed != OTA_DELTA_HDR_LEN || s_pages != 0u)
+    {
+        printf("  %-10s wrong base image not rejected at the header\n", name);
+        ok = false;
+    }
+    free(wrong);
+
+    if (must_beat_lz && m >= lz)
+    {
+        printf("  %-10s delta %u B not smaller than LZ %u B\n", name, (unsigned)m, (unsigned)lz);
+        ok = false;
+    }
+
+    printf("  %-10s %7u %7u %6.1f%% %7u %6u %8u %6.1f %5.1f %5.2f %5u\n", name, (unsigned)n, (unsigned)m,
+           100.0 * m / n, (unsigned)lz, (unsigned)st.copies, (unsigned)st.insert_bytes, n / 1024.0 / o->kbps,
+           lz / 1024.0 / o->kbps, m / 1024.0 / o->kbps, (unsigned)tail);
+    free(patch);
+    free(comp);
+    free(s_out);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    sim_opts_t  o        = {239u, 1024u, 24u}; /* MTU 247 一包的载荷；与 ota.c OTA_DELTA_BUDGET 相同 */
+    const char* fw       = NULL;
+    const char* other    = NULL;
+    const char* old_path = NULL;
+    const char* new_path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+            o.chunk = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+            o.budget = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--kbps") == 0 && i + 1 < argc)
+            o.kbps = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--old") == 0 && i + 1 < argc)
+            old_path = argv[++i];
+        else if (strcmp(argv[i], "--new") == 0 && i + 1 < argc)
+            new_path = argv[++i];
+        else if (fw == NULL)
+            fw = argv[i];
+        else
+            other = argv[i];
+    }
+    if (fw == NULL || o.chunk == 0u || o.budget == 0u || o.kbps == 0u || (old_path == NULL) != (new_path == NULL))
+    {
+        fprintf(stderr, "usage: ota_delta_sim [--chunk N] [--budget N] [--kbps N] [--old old.axf --new new.axf] "
+                        "firmware.axf [unrelated.axf]\n");
+        return 2;
+    }
+
+    if (ota_delta_crc32(0u, (const uint8_t*)"123456789", 9u) != 0xCBF43926u)
+    {
+        printf("ota_delta_crc32: wrong check value\n");
+        return 1;
+    }
+
+    uint32_t n, base;
+    uint8_t* img   = fw_image_load(fw, &n);
+    fw_func_t* fns = (fw_func_t*)malloc(sizeof(fw_func_t) * SIM_MAX_FUNCS);
+    uint32_t nfns  = (fns != NULL) ? fw_image_funcs(fw, "BleFunc_", fns, SIM_MAX_FUNCS, &base) : 0u;
+    if (img == NULL || n <= 256u || nfns == 0u)
+    {
+        fprintf(stderr, "%s: cannot read firmware image / BleFunc_* symbols\n", fw);
+        return 1;
+    }
+    uint8_t* rel = (uint8_t*)malloc(n + 8192u);
+    bool     ok  = true;
+
+    printf("%s: %u bytes, %u BleFunc_* functions, chunk <= %u B, copy budget %u B, BLE at %u KB/s\n", fw,
+           (unsigned)n, (unsigned)nfns, (unsigned)o.chunk, (unsigned)o.budget, (unsigned)o.kbps);
+    printf("  scenario       new   patch  ratio      lz copies  insert  full_s  lz_s delta_s tail\n");
+
+    uint32_t m = fw_synth_release(img, n, base, fns, nfns, 0u, 0u, 1u, rel);
+    ok         = sim_scenario("identical", img, n, rel, m, false, &o, 11u) && ok;
+    m          = fw_synth_release(img, n, base, fns, nfns, 4u, 0u, 2u, rel);
+    ok         = sim_scenario("edit", img, n, rel, m, true, &o, 12u) && ok;
+    m          = fw_synth_release(img, n, base, fns, nfns, 4u, 1024u, 3u, rel);
+    ok         = sim_scenario("grow1k", img, n, rel, m, true, &o, 13u) && ok;
+    m          = fw_synth_release(img, n, base, fns, nfns, 4u, 4096u, 4u, rel);
+    ok         = sim_scenario("grow4k", img, n, rel, m, true, &o, 14u) && ok;
+
+    if (other != NULL)
+    {
+        uint32_t on;
+        uint8_t* oimg = fw_image_load(other, &on);
+        if (oimg == NULL || on <= 256u)
+        {
+            printf("%s: cannot read firmware image\n", other);
+            ok = false;
+        }
+        else
+            ok = sim_scenario("unrelated", oimg, on, img, n, false, &o, 15u) && ok;
+        free(oimg);
+    }
+    if (old_path != NULL)
+    {
+        uint32_t on, nn;
+        uint8_t* oimg = fw_image_load(old_path, &on);
+        uint8_t* nimg = fw_image_load(new_path, &nn);
+        if (oimg == NULL || on <= 256u || nimg == NULL || nn <= 256u)
+        {
+            printf("%s / %s: cannot read firmware images\n", old_path, new_path);
+            ok = false;
+        }
+        else
+            ok = sim_scenario("release", oimg, on, nimg, nn, false, &o, 16u) && ok;
+        free(oimg);
+        free(nimg);
+    }
+
+    free(img);
+    free(fns);
+    free(rel);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+/*********************************************************************
+ * @file ota_lz_bench.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief OTA 压缩镜像：真实固件的压缩率、编码耗时、流式解码 MB/s，按窗口位数分档
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 每个输入固件（Keil .axf / .elf / .bin）按窗口 2^bits 字节（bits = 9~12）各压一次：
+ * - ratio：压缩后 / 原镜像；
+ * - decode：用设备同一份解码器（ota_lz.c），压缩数据按 --chunk 字节（一包 STREAM_DATA
+ *   的载荷）切块喂入，页回调里只拷贝，跑 BENCH_ROUNDS 轮取中位数；
+ * - BLE 时间：按 --kbps（流式传输的有效速率）折算原镜像 / 压缩镜像的传输时间。
+ *
+ * 正确性：每档解出的镜像必须与原镜像逐字节一致，且默认窗口下压缩后比原镜像小，
+ * 否则返回 1（ctest 以此判定）；速度只打印不判定。
+ *
+ * 用法：ota_lz_bench [--chunk N] [--kbps N] firmware.axf [firmware2.axf ...]
+ *********************************************************************/
+
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_timer.h"
+#include "ota_lz.h"
+#include "ota_lz_enc.h"
+
+#ifndef OTA_LZ_WINDOW_BITS
+#define OTA_LZ_WINDOW_BITS 11
+#endif
+
+#define BENCH_ROUNDS 5u
+
+static uint8_t* s_out = NULL;
+
+typedef struct
+{
+    uint64_t ns;
+    uint64_t cycles;
+} bench_sample_t;
+
+static int bench_cmp_sample(const void* a, const void* b)
+{
+    uint64_t x = ((const bench_sample_t*)a)->ns;
+    uint64_t y = ((const bench_sample_t*)b)->ns;
+    return (x > y) - (x < y);
+}
+
+static void bench_page(const uint8_t* page, uint32_t offset, uint32_t len)
+{
+    memcpy(&s_out[offset], page, len);
+}
+
+static uint8_t bench_decode(const uint8_t* comp, uint32_t m, uint32_t n, uint8_t bits, uint8_t* win,
+                            uint32_t chunk)
+{
+    struct ota_lz_t lz;
+    uint8_t         rc = OTA_LZ_OK;
+
+    ota_lz_init(&lz, win, bits, n, bench_page);
+    for (uint32_t off = 0; off < m && rc == OTA_LZ_OK; off += chunk)
+    {
+        rc = ota_lz_decode(&lz, &comp[off], (m - off < chunk) ? m - off : chunk);
+    }
+    return rc;
+}
+
+static bool bench_file(const char* path, uint32_t chunk, uint32_t kbps)
+{
+    uint32_t n;
+    uint8_t* img = fw_image_load(path, &n);
+    bool     ok  = true;
+
+    if (img == NULL || n == 0u)
+    {
+        printf("%s: cannot read firmware image\n", path);
+        return false;
+    }
+    const char* name = strrchr(path, '/');
+    name             = (name != NULL) ? name + 1 : path;
+
+    uint8_t* comp = (uint8_t*)malloc(OTA_LZ_ENC_BOUND(n));
+    uint8_t* win  = (uint8_t*)malloc(1u << OTA_LZ_BITS_MAX);
+    s_out         = (uint8_t*)malloc(n);
+
+    printf("%s: %u bytes, BLE %.1f s at %u KB/s\n", name, (unsigned)n, n / 1024.0 / kbps, (unsigned)kbps);
+    printf("  window    comp  ratio  enc ms  dec MB/s  dec cyc/B  BLE s\n");
+    for (uint8_t bits = 9u; bits <= OTA_LZ_BITS_MAX; bits++)
+    {
+        uint64_t t0 = bench_ns();
+        uint32_t m  = ota_lz_encode(img, n, bits, comp);
+        uint64_t te = bench_ns() - t0;
+
+        bench_sample_t dec[BENCH_ROUNDS];
+        uint8_t        rc = OTA_LZ_OK;
+        for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+        {
+            memset(s_out, 0, n);
+            uint64_t c0 = bench_cycles();
+            uint64_t n0 = bench_ns();
+            rc          = bench_decode(comp, m, n, bits, win, chunk);
+            dec[r].ns     = bench_ns() - n0;
+            dec[r].cycles = bench_cycles() - c0;
+        }
+        qsort(dec, BENCH_ROUNDS, sizeof(dec[0]), bench_cmp_sample);
+        bench_sample_t med = dec[BENCH_ROUNDS / 2u];
+
+        if (rc != OTA_LZ_DONE || memcmp(s_out, img, n) != 0)
+        {
+            printf("  %u-bit window: round trip failed\n", (unsigned)bits);
+            ok = false;
+        }
+        if (bits == OTA_LZ_WINDOW_BITS && m >= n)
+        {
+            printf("  %u-bit window: no gain\n", (unsigned)bits);
+            ok = false;
+        }
+        printf("  %4u B %8u %5.1f%% %7.1f %9.1f %10.2f %6.1f%s\n", 1u << bits, (unsigned)m, 100.0 * m / n,
+               te / 1e6, (double)n / (med.ns / 1e9) / 1e6, (double)med.cycles / n,
+               m / 1024.0 / kbps, (bits == OTA_LZ_WINDOW_BITS) ? "  <- device default" : "");
+    }
+    free(img);
+    free(comp);
+    free(win);
+    free(s_out);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t chunk = 239u; /* MTU 247 时一包 STREAM_DATA 的载荷 */
+    uint32_t kbps  = 24u;
+    bool     ok    = true;
+    int      files = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+            chunk = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--kbps") == 0 && i + 1 < argc)
+            kbps = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else
+        {
+            if (chunk == 0u || kbps == 0u)
+            {
+                fprintf(stderr, "bad arguments\n");
+                return 2;
+            }
+            ok = bench_file(argv[i], chunk, kbps) && ok;
+            files++;
+        }
+    }
+    if (files == 0)
+    {
+        fprintf(stderr, "usage: ota_lz_bench [--chunk N] [--kbps N] firmware.axf [...]\n");
+        return 2;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,546 @@
+/*********************************************************************
+ * @file proto_bench.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 手机协议栈主机基准：回放 0x5555..0xAAAA 帧，统计每帧成本
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 链路：Protocol_Handle_Data -> Protocol_Parse -> Protocol_Process_FE/FD
+ *       -> BleFunc_* -> Protocol_Send_Unicast -> ntf_data(桩)
+ *
+ * 输出（按 crypto 分组：plain / aes）：
+ * - frames/s、每帧延迟 p50/p99（ns）
+ * - 每帧 memcpy/memmove 字节数（链接期 --wrap 统计）
+ * - 每帧 Notify/UART/日志字节数（日志 = co_printf 文本 + 空闲刷出的二进制记录）
+ * - 峰值栈（独立 ucontext 栈涂色后回扫）
+ *
+ * 用法：
+ *   proto_bench [--corpus FILE] [--frames N] [--dump-corpus]
+ *   - 不给 --corpus 时使用内置语料（与 corpus_default.txt 相同生成规则）
+ *   - --dump-corpus 把内置语料按“每行一帧 HEX”打印，便于抓包替换
+ *********************************************************************/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "en_de_algo.h"
+#include "gap_api.h"
+#include "host_stubs.h"
+#include "protocol.h"
+#include "protocol_cmd.h"
+#include "rssi_check.h"
+
+#define BENCH_CORPUS_MAX   128
+#define BENCH_FRAME_MAX    256
+#define BENCH_STACK_SIZE   (256u * 1024u)
+#define BENCH_STACK_PAINT  0xA5u
+#define BENCH_CONIDX       0u
+#define BENCH_DEFAULT_RUNS 20000u
+
+/* 与 protocol.c 的 s_default_aes_key 一致（App 侧同一把 Key） */
+static const uint8_t s_bench_aes_key[16] = {'Q', 'S', 'D', 'f', 'a', 'g',
+                                            'Q', '1', '4', '1', 'G', 'S',
+                                            '6', 'J', 'F', '8'};
+
+typedef struct
+{
+    uint8_t  data[BENCH_FRAME_MAX];
+    uint16_t len;
+} bench_frame_t;
+
+static bench_frame_t s_corpus[BENCH_CORPUS_MAX];
+static uint32_t      s_corpus_cnt = 0;
+
+/* ==================== 语料构造 ==================== */
+static uint16_t bench_build_frame(uint8_t        crypto,
+                                  uint8_t        seq,
+                                  uint16_t       cmd,
+                                  const uint8_t* plain,
+                                  uint16_t       plain_len,
+                                  uint8_t*       out)
+{
+    uint8_t  body[BENCH_FRAME_MAX];
+    uint16_t body_len = plain_len;
+
+    if (plain_len > 0u)
+    {
+        memcpy(body, plain, plain_len);
+    }
+    if (crypto == CRYPTO_TYPE_AES128 && plain_len > 0u)
+    {
+        Algo_Context_t ctx;
+        Algo_Bind(&ctx, ALGO_TYPE_AES_CBC);
+        Algo_SetKeyIV(&ctx, s_bench_aes_key, NULL);
+        body_len = (uint16_t)Algo_Padding(body, plain_len, 16u);
+        Algo_Encrypt(&ctx, body, body_len, body);
+    }
+
+    uint16_t i = 0;
+    out[i++]   = 0x55;
+    out[i++]   = 0x55;
+    out[i++]   = (uint8_t)(body_len + 10u);
+    out[i++]   = crypto;
+    out[i++]   = seq;
+    out[i++]   = (uint8_t)(cmd >> 8); /* Cmd：协议帧里是大端 */
+    out[i++]   = (uint8_t)(cmd & 0xFFu);
+    memcpy(&out[i], body, body_len);
+    i = (uint16_t)(i + body_len);
+
+    uint8_t bcc = 0;
+    for (uint16_t k = 0; k < i; k++)
+    {
+        bcc ^= out[k];
+    }
+    out[i++] = bcc;
+    out[i++] = 0xAA;
+    out[i++] = 0xAA;
+    return i;
+}
+
+static void bench_corpus_add(uint8_t        crypto,
+                             uint16_t       cmd,
+                             const uint8_t* plain,
+                             uint16_t       plain_len)
+{
+    if (s_corpus_cnt >= BENCH_CORPUS_MAX)
+    {
+        return;
+    }
+    bench_frame_t* f = &s_corpus[s_corpus_cnt];
+    f->len = bench_build_frame(
+        crypto, (uint8_t)(s_corpus_cnt + 1u), cmd, plain, plain_len, f->data);
+    s_corpus_cnt++;
+}
+
+/*
+ * 内置语料：按 App 实际会话顺序，先 0x01FE 鉴权，再是常用的 FE/FD 控制指令。
+ * - 跳过 0x09FE/0x0AFE（恢复出厂/解绑会清 bond、断链，回放时会打断会话）
+ * - Time6 统一用 BIN 格式 26-01-06 17:14:21（联调日志中 App 的真实格式）
+ */
+static void bench_corpus_build_default(void)
+{
+    static const uint16_t s_cmds[] = {
+        defences_ID,       anti_theft_ID,         riss_strength_ID,
+        car_search_ID,     oil_defence_ID,        set_boot_lock_ID,
+        set_seat_lock_ID,  set_car_mute_ID,       assistive_trolley,
+        delayed_headlight, set_charging_power,    set_p_gear_mode,
+        set_vichle_gurd_mode, set_EBS_switch,     set_TCS_switch,
+        set_side_stand,    set_HDC_mode,          set_HHC_mode,
+    };
+    static const uint8_t s_time6[6] = {0x1A, 0x01, 0x06, 0x11, 0x0E, 0x15};
+    static const uint8_t s_crypto[2] = {CRYPTO_TYPE_NONE, CRYPTO_TYPE_AES128};
+
+    s_corpus_cnt = 0;
+    for (uint32_t c = 0; c < 2u; c++)
+    {
+        uint8_t connect[39];
+        memcpy(&connect[0], s_time6, 6);
+        memcpy(&connect[6], "6F35E30C05DBE6D747EB938DF71863D1", 32);
+        connect[38] = 0x01; /* mobileSystem: android */
+        bench_corpus_add(s_crypto[c], connect_ID, connect, sizeof(connect));
+
+        for (uint32_t k = 0; k < sizeof(s_cmds) / sizeof(s_cmds[0]); k++)
+        {
+            uint8_t payload[7];
+            memcpy(payload, s_time6, 6);
+            payload[6] = 0x01;
+            bench_corpus_add(s_crypto[c], s_cmds[k], payload, sizeof(payload));
+        }
+    }
+}
+
+static int bench_hex_nibble(int ch)
+{
+    if (ch >= '0' && ch <= '9')
+        return ch - '0';
+    if (ch >= 'a' && ch <= 'f')
+        return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F')
+        return ch - 'A' + 10;
+    return -1;
+}
+
+/* 语料文件：每行一帧 HEX（空格可选），'#' 开头为注释 */
+static bool bench_corpus_load(const char* path)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "proto_bench: cannot open %s\n", path);
+        return false;
+    }
+
+    char line[1024];
+    s_corpus_cnt = 0;
+    while (fgets(line, sizeof(line), fp) != NULL &&
+           s_corpus_cnt < BENCH_CORPUS_MAX)
+    {
+        bench_frame_t* f  = &s_corpus[s_corpus_cnt];
+        int            hi = -1;
+        f->len            = 0;
+        for (char* p = line; *p != '\0' && *p != '#'; p++)
+        {
+            int v = bench_hex_nibble((unsigned char)*p);
+            if (v < 0)
+            {
+                continue;
+            }
+            if (hi < 0)
+            {
+                hi = v;
+            }
+            else if (f->len < BENCH_FRAME_MAX)
+            {
+                f->data[f->len++] = (uint8_t)((hi << 4) | v);
+                hi                = -1;
+            }
+        }
+        if (f->len >= 10u)
+        {
+            s_corpus_cnt++;
+        }
+    }
+    fclose(fp);
+    return s_corpus_cnt > 0u;
+}
+
+static void bench_corpus_dump(void)
+{
+    printf("# proto_bench corpus: one 0x5555..0xAAAA frame per line\n");
+    for (uint32_t i = 0; i < s_corpus_cnt; i++)
+    {
+        const bench_frame_t* f = &s_corpus[i];
+        printf("# cmd=0x%02X%02X crypto=0x%02X len=%u\n",
+               f->data[5],
+               f->data[6],
+               f->data[3],
+               (unsigned)f->len);
+        for (uint16_t k = 0; k < f->len; k++)
+        {
+            printf("%02X%s", f->data[k], (k + 1u < f->len) ? " " : "\n");
+        }
+    }
+}
+
+/* ==================== 计时 / 统计 ==================== */
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_cmp_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* ==================== 回放 ==================== */
+typedef struct
+{
+    const char* name;
+    uint8_t     crypto;
+    uint32_t    runs;
+
+    /* 输出 */
+    uint32_t  frames;
+    uint64_t  total_ns;
+    uint32_t* lat_ns;
+    uint64_t  copy_bytes;
+    uint64_t  ntf_frames;
+    uint64_t  ntf_bytes;
+    uint64_t  uart_bytes;
+    uint64_t  log_bytes;
+    uint32_t  stack_peak;
+    uint32_t  bad_replies;
+} bench_class_t;
+
+static bench_class_t* s_cur_class = NULL;
+static uint8_t        s_expect_crypto;
+
+static void bench_ntf_hook(uint8_t        conidx,
+                           uint8_t        att_idx,
+                           const uint8_t* data,
+                           uint16_t       len)
+{
+    (void)conidx;
+    (void)att_idx;
+    /* 回包必须是完整帧，且 crypto 跟随请求（protocol.c 的 last_rx_crypto 策略） */
+    if (s_cur_class == NULL)
+    {
+        return;
+    }
+    if (len < 10u || data[0] != 0x55 || data[1] != 0x55 ||
+        data[len - 1u] != 0xAA || data[3] != s_expect_crypto)
+    {
+        s_cur_class->bad_replies++;
+    }
+}
+
+static void bench_session_reset(void)
+{
+    host_stubs_reset();
+    host_gap_set_connected(BENCH_CONIDX, true);
+    host_set_ntf_hook(bench_ntf_hook);
+
+    static const uint8_t peer[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+    Protocol_Init();
+    Protocol_Auth_Clear(BENCH_CONIDX);
+    RSSI_Check_Init();
+    RSSI_Check_Enable(BENCH_CONIDX, NULL);
+    RSSI_Check_Set_Peer_Addr(BENCH_CONIDX, peer);
+}
+
+/* 取出本组（同 crypto）的帧下标 */
+static uint32_t bench_class_frames(uint8_t crypto, uint32_t* idx, uint32_t cap)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < s_corpus_cnt && n < cap; i++)
+    {
+        if (s_corpus[i].data[3] == crypto)
+        {
+            idx[n++] = i;
+        }
+    }
+    return n;
+}
+
+static void bench_replay(bench_class_t* cls, bool timed)
+{
+    uint32_t idx[BENCH_CORPUS_MAX];
+    uint32_t n = bench_class_frames(cls->crypto, idx, BENCH_CORPUS_MAX);
+    if (n == 0u)
+    {
+        return;
+    }
+
+    uint8_t buf[BENCH_FRAME_MAX];
+    s_cur_class     = cls;
+    s_expect_crypto = cls->crypto;
+
+    for (uint32_t r = 0; r < cls->runs; r++)
+    {
+        const bench_frame_t* f = &s_corpus[idx[r % n]];
+
+        /* 解密是原地进行的：每次回放前恢复原始密文（不计入测量窗口） */
+        for (uint16_t k = 0; k < f->len; k++)
+        {
+            buf[k] = f->data[k];
+        }
+
+        uint64_t copy0 = g_host_stats.memcpy_bytes;
+        uint64_t t0    = timed ? bench_now_ns() : 0u;
+        Protocol_Handle_Data(BENCH_CONIDX, buf, f->len);
+        uint64_t t1 = timed ? bench_now_ns() : 0u;
+
+        cls->copy_bytes += g_host_stats.memcpy_bytes - copy0;
+        /* 板上二进制日志在空闲循环里刷出，不在命令处理路径上，这里同样放在计时窗口之外 */
+        host_run_idle();
+        if (timed)
+        {
+            cls->lat_ns[r] = (uint32_t)(t1 - t0);
+            cls->total_ns += (t1 - t0);
+        }
+        cls->frames++;
+    }
+
+    s_cur_class = NULL;
+}
+
+/* ---- 峰值栈：在独立 ucontext 栈上回放，涂色后回扫 ---- */
+static ucontext_t     s_main_uc;
+static ucontext_t     s_bench_uc;
+static bench_class_t* s_stack_cls = NULL;
+
+static void bench_stack_entry(void)
+{
+    if (s_stack_cls != NULL)
+    {
+        bench_replay(s_stack_cls, false);
+    }
+}
+
+static uint32_t bench_stack_run(bench_class_t* cls)
+{
+    uint8_t* stack = (uint8_t*)malloc(BENCH_STACK_SIZE);
+    if (stack == NULL)
+    {
+        return 0u;
+    }
+    for (uint32_t i = 0; i < BENCH_STACK_SIZE; i++)
+    {
+        stack[i] = BENCH_STACK_PAINT;
+    }
+
+    getcontext(&s_bench_uc);
+    s_bench_uc.uc_stack.ss_sp   = stack;
+    s_bench_uc.uc_stack.ss_size = BENCH_STACK_SIZE;
+    s_bench_uc.uc_link          = &s_main_uc;
+    s_stack_cls                 = cls;
+    makecontext(&s_bench_uc, bench_stack_entry, 0);
+    swapcontext(&s_main_uc, &s_bench_uc);
+
+    /* 栈向低地址增长：从底部往上找第一个被改写的字节 */
+    uint32_t untouched = 0;
+    while (untouched < BENCH_STACK_SIZE && stack[untouched] == BENCH_STACK_PAINT)
+    {
+        untouched++;
+    }
+    free(stack);
+    return BENCH_STACK_SIZE - untouched;
+}
+
+static void bench_run_class(bench_class_t* cls)
+{
+    /* 1) 计时回放（co_printf 照常格式化，贴近板上 CPU 成本） */
+    bench_session_reset();
+    cls->lat_ns = (uint32_t*)calloc(cls->runs, sizeof(uint32_t));
+    bench_replay(cls, true);
+    cls->ntf_frames = g_host_stats.ntf_frames;
+    cls->ntf_bytes  = g_host_stats.ntf_bytes;
+    cls->uart_bytes = g_host_stats.uart_bytes;
+    cls->log_bytes  = g_host_stats.log_bytes;
+
+    /*
+     * 2) 峰值栈：
+     * - 主机 vsnprintf 的栈开销与板上 co_printf 无关，会淹没协议栈本身，
+     *   因此这一轮只计日志次数不格式化；
+     * - 先跑一遍“空回放”（runs=0）得到驱动自身的基线，再做差。
+     */
+    bench_class_t probe = *cls;
+    probe.frames        = 0;
+    probe.copy_bytes    = 0;
+    probe.lat_ns        = NULL;
+
+    host_set_log_format(false);
+    bench_session_reset();
+    probe.runs          = 0;
+    uint32_t base       = bench_stack_run(&probe);
+    bench_session_reset();
+    probe.runs          = (cls->runs < 1000u) ? cls->runs : 1000u;
+    uint32_t used       = bench_stack_run(&probe);
+    cls->stack_peak     = (used > base) ? (used - base) : 0u;
+    cls->bad_replies   += probe.bad_replies;
+    host_set_log_format(true);
+}
+
+static void bench_report(const bench_class_t* cls)
+{
+    if (cls->frames == 0u)
+    {
+        printf("%-6s no frames in corpus\n", cls->name);
+        return;
+    }
+
+    qsort(cls->lat_ns, cls->frames, sizeof(uint32_t), bench_cmp_u32);
+    uint32_t p50 = cls->lat_ns[(cls->frames * 50u) / 100u];
+    uint32_t p99 = cls->lat_ns[(cls->frames * 99u) / 100u];
+    double   fps = (cls->total_ns > 0u)
+                       ? ((double)cls->frames * 1e9 / (double)cls->total_ns)
+                       : 0.0;
+
+    printf("%-6s frames=%-7u frames/s=%-10.0f p50=%-6uns p99=%-6uns "
+           "copy=%-6.1fB/frame ntf=%.2f/frame(%.1fB) uart=%.1fB/frame "
+           "log=%.1fB/frame stack_peak=%uB\n",
+           cls->name,
+           (unsigned)cls->frames,
+           fps,
+           (unsigned)p50,
+           (unsigned)p99,
+           (double)cls->copy_bytes / (double)cls->frames,
+           (double)cls->ntf_frames / (double)cls->frames,
+           (double)cls->ntf_bytes / (double)cls->frames,
+           (double)cls->uart_bytes / (double)cls->frames,
+           (double)cls->log_bytes / (double)cls->frames,
+           (unsigned)cls->stack_peak);
+}
+
+int main(int argc, char** argv)
+{
+    const char* corpus_path = NULL;
+    uint32_t    runs        = BENCH_DEFAULT_RUNS;
+    bool        dump        = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc)
+        {
+            corpus_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--dump-corpus") == 0)
+        {
+            dump = true;
+        }
+        else
+        {
+            fprintf(stderr,
+                    "usage: %s [--corpus FILE] [--frames N] [--dump-corpus]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if (corpus_path != NULL)
+    {
+        if (!bench_corpus_load(corpus_path))
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        bench_corpus_build_default();
+    }
+
+    if (dump)
+    {
+        bench_corpus_dump();
+        return 0;
+    }
+    if (runs == 0u)
+    {
+        runs = 1u;
+    }
+
+    bench_class_t classes[2] = {
+        {.name = "plain", .crypto = CRYPTO_TYPE_NONE, .runs = runs},
+        {.name = "aes", .crypto = CRYPTO_TYPE_AES128, .runs = runs},
+    };
+
+    printf("proto_bench: corpus=%s frames=%u runs/class=%u\n",
+           corpus_path ? corpus_path : "<builtin>",
+           (unsigned)s_corpus_cnt,
+           (unsigned)runs);
+
+    int rc = 0;
+    for (uint32_t c = 0; c < 2u; c++)
+    {
+        bench_run_class(&classes[c]);
+        bench_report(&classes[c]);
+
+        /* 冒烟校验：每类都必须产生回包，且回包格式/crypto 正确 */
+        if (classes[c].frames > 0u &&
+            (classes[c].ntf_frames == 0u || classes[c].bad_replies != 0u))
+        {
+            fprintf(stderr,
+                    "proto_bench: %s replies invalid (ntf=%llu bad=%u)\n",
+                    classes[c].name,
+                    (unsigned long long)classes[c].ntf_frames,
+                    (unsigned)classes[c].bad_replies);
+            rc = 1;
+        }
+        free(classes[c].lat_ns);
+    }
+    return rc;
+}
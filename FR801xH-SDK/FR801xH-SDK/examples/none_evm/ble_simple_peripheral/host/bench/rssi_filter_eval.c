@@ -0,0 +1,375 @@
+/*********************************************************************
+ * @file rssi_filter_eval.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief RSSI 滤波策略离线评估：带真值的轨迹逐个策略回放，对比解锁延迟与误判
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 链路（与板上 GAP_EVT_LINK_RSSI 分支一致）：
+ *   轨迹样本 -> RSSI_Check_Update（当前策略 + 滞回）-> RSSI_Check_Get_Distance
+ *
+ * 轨迹格式（CSV，# 开头为注释）：t_ms,conidx,rssi,truth
+ *   truth = 真实距离区间（rssi_distance_t）；没有第 4 列的样本只参与计时。
+ *
+ * 每个策略输出：
+ * - NEAR 延迟：真值进入 NEAR 到判为 NEAR 的时间（平均/中位/最大），
+ *   真值离开 NEAR 前都没判出记一次 miss；
+ * - 误解锁：判为进入 NEAR 时真值不是 NEAR；
+ * - 误上锁：判为离开 NEAR 时真值仍是 NEAR（站在车旁被锁上）；
+ * - 每样本开销：只计 Step（x86_64 用 rdtsc 计 cycles，其它平台退回 ns）。
+ * 只打印不判定哪个好；最后一行按“误判最少、其次延迟最短”给个参考。
+ *
+ * 自检，任一不满足返回 1：
+ * - 轨迹里至少有一个带真值的 NEAR 区间；
+ * - 每个策略对无噪声阶跃（-90 -> -50 dBm）在 30 个样本内收敛到 +-3 dB
+ *   （3avg+ema 的整数 EMA 在残差 < 4 dB 时截断为 0，会停在 -53），
+ *   并且恒定输入时输出不漂。
+ *
+ * 用法：rssi_filter_eval [--trace FILE] [--filter NAME]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_timer.h"
+#include "host_stubs.h"
+#include "rssi_check.h"
+
+#define EVAL_SAMPLES_MAX  65536u
+#define EVAL_EDGES_MAX    1024u
+#define EVAL_TIMING_ROUNDS 20u
+#define EVAL_NO_TRUTH     0xFFu
+
+typedef struct
+{
+    uint32_t t_ms;
+    uint8_t  conidx;
+    int8_t   rssi;
+    uint8_t  truth;
+} eval_sample_t;
+
+typedef struct
+{
+    uint32_t edges;         /* 真值进入 NEAR 的次数 */
+    uint32_t detected;
+    uint32_t missed;
+    uint32_t false_unlock;
+    uint32_t false_lock;
+    uint32_t lat_ms[EVAL_EDGES_MAX];
+    double   cost_per_sample;
+} eval_result_t;
+
+static eval_sample_t s_trace[EVAL_SAMPLES_MAX];
+static uint32_t      s_trace_cnt;
+static eval_result_t s_res[RSSI_FILTER_NUM];
+
+static bool eval_load(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    char  line[128];
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "rssi_filter_eval: cannot open %s\n", path);
+        return false;
+    }
+    s_trace_cnt = 0u;
+    while (fgets(line, sizeof(line), f) != NULL && s_trace_cnt < EVAL_SAMPLES_MAX)
+    {
+        unsigned t;
+        unsigned c;
+        int      r;
+        unsigned truth = EVAL_NO_TRUTH;
+        int      n;
+        if (line[0] == '#')
+        {
+            continue;
+        }
+        n = sscanf(line, "%u,%u,%d,%u", &t, &c, &r, &truth);
+        if (n < 3 || c >= RSSI_MAX_CONN)
+        {
+            continue;
+        }
+        s_trace[s_trace_cnt].t_ms   = t;
+        s_trace[s_trace_cnt].conidx = (uint8_t)c;
+        s_trace[s_trace_cnt].rssi   = (int8_t)r;
+        s_trace[s_trace_cnt].truth  = (n == 4 && truth <= RSSI_DIST_NEAR) ? (uint8_t)truth : EVAL_NO_TRUTH;
+        s_trace_cnt++;
+    }
+    fclose(f);
+    return s_trace_cnt > 0u;
+}
+
+static int eval_cmp_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* 走一遍完整的判定链路，统计延迟与误判 */
+static void eval_replay(uint8_t id, eval_result_t* r)
+{
+    bool     seen[RSSI_MAX_CONN]        = {false};
+    uint8_t  prev_truth[RSSI_MAX_CONN];
+    bool     pending[RSSI_MAX_CONN]     = {false};
+    uint32_t pending_ms[RSSI_MAX_CONN]  = {0};
+
+    memset(r, 0, sizeof(*r));
+    host_stubs_reset();
+    RSSI_Check_Init();
+    (void)RSSI_Check_Set_Filter(id);
+
+    for (uint32_t i = 0; i < s_trace_cnt; i++)
+    {
+        const eval_sample_t* s = &s_trace[i];
+        uint8_t              c = s->conidx;
+
+        if (!seen[c])
+        {
+            RSSI_Check_Enable(c, NULL);
+            seen[c]       = true;
+            prev_truth[c] = RSSI_DIST_LOST;
+        }
+
+        uint8_t before = RSSI_Check_Get_Distance(c);
+        RSSI_Check_Update(c, s->rssi);
+        uint8_t after = RSSI_Check_Get_Distance(c);
+
+        if (s->truth == EVAL_NO_TRUTH)
+        {
+            continue;
+        }
+
+        bool truth_near = (s->truth == RSSI_DIST_NEAR);
+        if (truth_near && prev_truth[c] != RSSI_DIST_NEAR)
+        {
+            r->edges++;
+            pending[c]    = (after != RSSI_DIST_NEAR);
+            pending_ms[c] = s->t_ms;
+            if (!pending[c] && r->detected < EVAL_EDGES_MAX)
+            {
+                r->lat_ms[r->detected++] = 0u;
+            }
+        }
+        else if (!truth_near && pending[c])
+        {
+            r->missed++;
+            pending[c] = false;
+        }
+        prev_truth[c] = s->truth;
+
+        if (before != RSSI_DIST_NEAR && after == RSSI_DIST_NEAR)
+        {
+            if (!truth_near)
+            {
+                r->false_unlock++;
+            }
+            else if (pending[c])
+            {
+                pending[c] = false;
+                if (r->detected < EVAL_EDGES_MAX)
+                {
+                    r->lat_ms[r->detected++] = s->t_ms - pending_ms[c];
+                }
+            }
+        }
+        else if (before == RSSI_DIST_NEAR && after != RSSI_DIST_NEAR && truth_near)
+        {
+            r->false_lock++;
+        }
+    }
+    for (uint8_t c = 0; c < RSSI_MAX_CONN; c++)
+    {
+        if (seen[c])
+        {
+            RSSI_Check_Disable(c);
+        }
+        if (pending[c])
+        {
+            r->missed++;
+        }
+    }
+}
+
+/* 只计 Step：同一条轨迹重复若干遍取平均 */
+static double eval_cost(uint8_t id)
+{
+    const RSSI_FilterOps* ops = RSSI_Filter_Get_Ops(id);
+    RSSI_ConnCtx          ctx;
+    volatile int32_t      sink = 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.owner = RSSI_Get_Default();
+    ops->Reset(&ctx);
+
+    uint64_t t0 = bench_now();
+    for (uint32_t round = 0; round < EVAL_TIMING_ROUNDS; round++)
+    {
+        for (uint32_t i = 0; i < s_trace_cnt; i++)
+        {
+            sink += ops->Step(&ctx, s_trace[i].rssi);
+        }
+    }
+    uint64_t t1 = bench_now();
+    (void)sink;
+    return (double)(t1 - t0) / (double)(EVAL_TIMING_ROUNDS * s_trace_cnt);
+}
+
+/* 无噪声阶跃 + 恒定输入：定点实现的基本正确性 */
+static bool eval_selfcheck(uint8_t id)
+{
+    const RSSI_FilterOps* ops = RSSI_Filter_Get_Ops(id);
+    RSSI_ConnCtx          ctx;
+    int16_t               out = 0;
+    int                   settled_at = -1;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.owner = RSSI_Get_Default();
+    ctx.ema   = -70;
+    ops->Reset(&ctx);
+    for (int i = 0; i < 20; i++)
+    {
+        out = ops->Step(&ctx, -90);
+    }
+    if (out != -90)
+    {
+        fprintf(stderr, "rssi_filter_eval: %s drifts on constant input (%d)\n", ops->name, (int)out);
+        return false;
+    }
+    for (int i = 0; i < 60; i++)
+    {
+        out = ops->Step(&ctx, -50);
+        if (settled_at < 0 && out >= -53 && out <= -47)
+        {
+            settled_at = i;
+        }
+    }
+    if (settled_at < 0 || settled_at >= 30 || out < -53 || out > -47)
+    {
+        fprintf(stderr, "rssi_filter_eval: %s step response %d after 60 samples, settled at %d\n",
+                ops->name, (int)out, settled_at);
+        return false;
+    }
+    return true;
+}
+
+static void eval_print(uint8_t id, eval_result_t* r)
+{
+    double   mean = 0.0;
+    uint32_t p50  = 0u;
+    uint32_t max  = 0u;
+
+    if (r->detected > 0u)
+    {
+        qsort(r->lat_ms, r->detected, sizeof(r->lat_ms[0]), eval_cmp_u32);
+        for (uint32_t i = 0; i < r->detected; i++)
+        {
+            mean += r->lat_ms[i];
+        }
+        mean /= (double)r->detected;
+        p50 = r->lat_ms[r->detected / 2u];
+        max = r->lat_ms[r->detected - 1u];
+    }
+    printf("  %-9s %5u/%-5u %4u %8.0f %7u %7u %8u %8u %9.1f\n",
+           RSSI_Filter_Get_Ops(id)->name,
+           (unsigned)r->detected,
+           (unsigned)r->edges,
+           (unsigned)r->missed,
+           mean,
+           (unsigned)p50,
+           (unsigned)max,
+           (unsigned)r->false_unlock,
+           (unsigned)r->false_lock,
+           r->cost_per_sample);
+}
+
+int main(int argc, char** argv)
+{
+    const char* trace = NULL;
+    const char* only  = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            trace = argv[++i];
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--trace FILE] [--filter NAME]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (trace == NULL)
+    {
+        trace = RSSI_EVAL_DEFAULT_TRACE;
+    }
+    if (!eval_load(trace))
+    {
+        return 1;
+    }
+
+    int     fail = 0;
+    uint8_t best = RSSI_FILTER_NUM;
+
+    printf("rssi_filter_eval (%s, %u samples):\n", trace, (unsigned)s_trace_cnt);
+    printf("  %-9s %11s %4s %8s %7s %7s %8s %8s %9s\n",
+           "filter", "near/edges", "miss", "lat_avg", "lat_p50", "lat_max",
+           "f_unlock", "f_lock", BENCH_UNIT "/smp");
+    for (uint8_t id = 0; id < RSSI_FILTER_NUM; id++)
+    {
+        eval_result_t* r = &s_res[id];
+
+        if (only != NULL && strcmp(only, RSSI_Filter_Get_Ops(id)->name) != 0)
+        {
+            continue;
+        }
+        if (!eval_selfcheck(id))
+        {
+            fail = 1;
+        }
+        eval_replay(id, r);
+        r->cost_per_sample = eval_cost(id);
+        eval_print(id, r);
+        if (r->edges == 0u)
+        {
+            fail = 1;
+        }
+
+        /* 参考：误判（含 miss）最少，其次 NEAR 中位延迟最短 */
+        if (best == RSSI_FILTER_NUM)
+        {
+            best = id;
+        }
+        else
+        {
+            eval_result_t* b   = &s_res[best];
+            uint32_t       bad = r->false_unlock + r->false_lock + r->missed;
+            uint32_t       bb  = b->false_unlock + b->false_lock + b->missed;
+            uint32_t       lp  = r->detected ? r->lat_ms[r->detected / 2u] : UINT32_MAX;
+            uint32_t       bp  = b->detected ? b->lat_ms[b->detected / 2u] : UINT32_MAX;
+            if (bad < bb || (bad == bb && lp < bp))
+            {
+                best = id;
+            }
+        }
+    }
+    if (best == RSSI_FILTER_NUM)
+    {
+        fprintf(stderr, "rssi_filter_eval: no filter named %s\n", only);
+        return 2;
+    }
+    printf("  fewest misjudgements, then fastest: %s (current default: %s)\n",
+           RSSI_Filter_Get_Ops(best)->name,
+           RSSI_Filter_Get_Ops(RSSI_FILTER_DEFAULT)->name);
+    printf("rssi_filter_eval: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
@@ -0,0 +1,258 @@
+/*********************************************************************
+ * @file rssi_report_sim.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief RSSI 上报策略回放：录制的 RSSI 轨迹 -> FF01/0x0118 UART 字节/分钟（旧 vs 新）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 链路（与板上 GAP_EVT_LINK_RSSI 分支一致）：
+ *   轨迹样本 -> RSSI_Check_Update -> BleFunc_RSSI_RawInd -> RSSI_Report_OnSample
+ *   -> SocMcu_Frame_Send(桩) -> 本程序的 MCU 视图
+ * 虚拟时钟按样本时间戳推进，最小间隔的补发定时器在两个样本之间按时触发。
+ *
+ * 轨迹格式（CSV，# 开头为注释）：t_ms,conidx,rssi；某连接第一次出现时视为连上。
+ *
+ * 每条轨迹跑两遍：legacy（enable=0，每个样本一帧）与 policy（默认策略），
+ * 输出帧数、记录数、线上字节数（含 SOC<->MCU 帧头尾）与字节/分钟。
+ *
+ * 自检（policy），任一不满足返回 1：
+ * - 距离状态变化的那个样本必须立刻带出该连接的记录；
+ * - 任一连接两次上报间隔不超过 stable_interval + 一个采样周期；
+ * - 记录里的 MAC 对应该连接，RSSI 等于发送时刻的滤波值。
+ *
+ * 用法：rssi_report_sim [--trace FILE]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ble_function.h"
+#include "host_stubs.h"
+#include "rssi_check.h"
+#include "rssi_report.h"
+#include "soc_mcu_codec.h"
+#include "usart_cmd.h"
+
+#define SIM_SAMPLES_MAX   65536u
+#define SIM_SAMPLE_PERIOD 500u
+
+typedef struct
+{
+    uint32_t t_ms;
+    uint8_t  conidx;
+    int8_t   rssi;
+} sim_sample_t;
+
+typedef struct
+{
+    uint64_t frames;
+    uint64_t records;
+    uint64_t wire_bytes;
+    uint32_t errors;
+} sim_result_t;
+
+static sim_sample_t s_trace[SIM_SAMPLES_MAX];
+static uint32_t     s_trace_cnt;
+
+static sim_result_t s_res;
+static bool         s_connected[RSSI_MAX_CONN];
+static bool         s_rec_seen[RSSI_MAX_CONN];
+static uint32_t     s_last_rec_ms[RSSI_MAX_CONN];
+
+static void sim_peer(uint8_t conidx, uint8_t mac[6])
+{
+    static const uint8_t base[6] = {0xC0, 0x11, 0x22, 0x33, 0x44, 0x00};
+    memcpy(mac, base, 6);
+    mac[5] = (uint8_t)(0x50u + conidx);
+}
+
+static void sim_uart_hook(uint16_t       sync,
+                          uint16_t       feature,
+                          uint16_t       id,
+                          const uint8_t* data,
+                          uint16_t       len)
+{
+    (void)sync;
+    if (feature != SOC_MCU_FEATURE_FF01 || id != RSSI_REPORT_CMD)
+    {
+        return;
+    }
+    s_res.frames++;
+    s_res.wire_bytes += SOC_MCU_FRAME_LEN(len);
+    if (len == 0u || (len % RSSI_REPORT_REC_LEN) != 0u)
+    {
+        s_res.errors++;
+        return;
+    }
+    for (uint16_t off = 0; off < len; off = (uint16_t)(off + RSSI_REPORT_REC_LEN))
+    {
+        uint8_t mac[6];
+        uint8_t c = (uint8_t)(data[off + 6u] - 0x50u);
+
+        s_res.records++;
+        if (c >= RSSI_MAX_CONN)
+        {
+            s_res.errors++;
+            continue;
+        }
+        sim_peer(c, mac);
+        if (memcmp(&data[off + 1u], mac, 6) != 0 ||
+            (int8_t)data[off] != (int8_t)RSSI_Check_Get_Filtered(c))
+        {
+            s_res.errors++;
+        }
+        s_rec_seen[c]    = true;
+        s_last_rec_ms[c] = host_time_now_ms();
+    }
+}
+
+static bool sim_load(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    char  line[128];
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "rssi_report_sim: cannot open %s\n", path);
+        return false;
+    }
+    s_trace_cnt = 0u;
+    while (fgets(line, sizeof(line), f) != NULL && s_trace_cnt < SIM_SAMPLES_MAX)
+    {
+        unsigned t;
+        unsigned c;
+        int      r;
+        if (line[0] == '#' || sscanf(line, "%u,%u,%d", &t, &c, &r) != 3 || c >= RSSI_MAX_CONN)
+        {
+            continue;
+        }
+        s_trace[s_trace_cnt].t_ms   = t;
+        s_trace[s_trace_cnt].conidx = (uint8_t)c;
+        s_trace[s_trace_cnt].rssi   = (int8_t)r;
+        s_trace_cnt++;
+    }
+    fclose(f);
+    return s_trace_cnt > 0u;
+}
+
+static sim_result_t sim_run(bool policy)
+{
+    RSSI_ReportCfg cfg;
+    uint32_t       t0 = host_time_now_ms();
+
+    memset(&s_res, 0, sizeof(s_res));
+    memset(s_connected, 0, sizeof(s_connected));
+    host_stubs_reset();
+    host_set_uart_hook(sim_uart_hook);
+    RSSI_Check_Init();
+    RSSI_Report_Init();
+    RSSI_Report_GetConfig(&cfg);
+    cfg.enable = policy ? 1u : 0u;
+    RSSI_Report_SetConfig(&cfg);
+
+    for (uint32_t i = 0; i < s_trace_cnt; i++)
+    {
+        const sim_sample_t* s = &s_trace[i];
+        uint8_t             c = s->conidx;
+        uint32_t            now = t0 + s->t_ms;
+
+        if (now > host_time_now_ms())
+        {
+            host_time_advance(now - host_time_now_ms());
+        }
+        if (!s_connected[c])
+        {
+            uint8_t mac[6];
+            sim_peer(c, mac);
+            RSSI_Check_Enable(c, NULL);
+            RSSI_Check_Set_Peer_Addr(c, mac);
+            RSSI_Report_Reset(c);
+            s_connected[c]   = true;
+            s_last_rec_ms[c] = now;
+        }
+
+        uint8_t dist_before = RSSI_Check_Get_Distance(c);
+        s_rec_seen[c]       = false;
+        RSSI_Check_Update(c, s->rssi);
+        BleFunc_RSSI_RawInd(c, s->rssi);
+        if (!policy)
+        {
+            continue;
+        }
+
+        if (RSSI_Check_Get_Distance(c) != dist_before && !s_rec_seen[c])
+        {
+            fprintf(stderr, "rssi_report_sim: link %u distance change at %u ms not reported\n",
+                    (unsigned)c, (unsigned)s->t_ms);
+            s_res.errors++;
+        }
+        if (now - s_last_rec_ms[c] > (uint32_t)cfg.stable_interval_ms + SIM_SAMPLE_PERIOD)
+        {
+            fprintf(stderr, "rssi_report_sim: link %u silent for %u ms at %u ms\n",
+                    (unsigned)c, (unsigned)(now - s_last_rec_ms[c]), (unsigned)s->t_ms);
+            s_res.errors++;
+        }
+    }
+    /* 把最后一个补发定时器跑完 */
+    host_time_advance(cfg.min_interval_ms);
+    host_set_uart_hook(NULL);
+    return s_res;
+}
+
+static void sim_print(const char* name, const sim_result_t* r, double minutes)
+{
+    printf("  %-7s: %6llu frames %6llu records %8llu B on UART  %8.1f B/min  %6.1f frames/min\n",
+           name,
+           (unsigned long long)r->frames,
+           (unsigned long long)r->records,
+           (unsigned long long)r->wire_bytes,
+           (double)r->wire_bytes / minutes,
+           (double)r->frames / minutes);
+}
+
+int main(int argc, char** argv)
+{
+    const char* trace = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            trace = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--trace FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (trace == NULL)
+    {
+        trace = RSSI_SIM_DEFAULT_TRACE;
+    }
+    if (!sim_load(trace))
+    {
+        return 1;
+    }
+
+    double minutes = (double)(s_trace[s_trace_cnt - 1u].t_ms + SIM_SAMPLE_PERIOD) / 60000.0;
+    printf("rssi_report_sim (%s, %u samples, %.1f min):\n", trace, (unsigned)s_trace_cnt, minutes);
+
+    sim_result_t legacy = sim_run(false);
+    sim_print("legacy", &legacy, minutes);
+    sim_result_t policy = sim_run(true);
+    sim_print("policy", &policy, minutes);
+    if (policy.wire_bytes > 0u)
+    {
+        printf("  policy vs legacy: %.1fx fewer UART bytes\n",
+               (double)legacy.wire_bytes / (double)policy.wire_bytes);
+    }
+
+    int fail = (legacy.errors != 0u || policy.errors != 0u ||
+                legacy.records != (uint64_t)s_trace_cnt);
+    printf("rssi_report_sim: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
@@ -0,0 +1,190 @@
+/*********************************************************************
+ * @file rssi_sample_sim.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief RSSI 自适应采样仿真：固定 500 ms 轮询 vs 按距离状态调度的采样
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 链路（与板上一致）：
+ *   RSSI_Check_Enable_Sampling -> 定时器 -> sampler(=本程序的 gap_get_link_rssi)
+ *   -> 合成信道给出当前 RSSI -> RSSI_Check_Update（即 GAP_EVT_LINK_RSSI 分支）
+ *
+ * 场景（单连接，虚拟时钟 1 ms 步进）：
+ *   0-120 s 手机在远处口袋里（-97 dBm）；120-135 s 走近到 -50 dBm；
+ *   135-315 s 站在车旁；315-330 s 走开；330-450 s 远处。
+ *   叠加 +-2 dB 的伪随机噪声（固定种子，两遍一致）。
+ *
+ * 输出：每分钟采样次数、走近时从真值越过 near_threshold 到判为 NEAR 的延迟、
+ *       走开时从真值跌破 lost_threshold 到判为 LOST 的延迟。
+ *
+ * 自检（adaptive），任一不满足返回 1：
+ * - 两遍都判出过 NEAR 和 LOST；
+ * - NEAR 延迟不劣于固定轮询；
+ * - 总采样次数少于固定轮询。
+ *
+ * 用法：rssi_sample_sim
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "host_stubs.h"
+#include "rssi_check.h"
+
+#define SIM_CONIDX      0u
+#define SIM_END_MS      450000u
+#define SIM_FAR_DBM     (-97)
+#define SIM_NEAR_DBM    (-50)
+#define SIM_APPROACH_MS 120000u
+#define SIM_LEAVE_MS    315000u
+#define SIM_WALK_MS     15000u
+
+typedef struct
+{
+    uint32_t samples;
+    uint32_t near_ms;  /* 判为 NEAR 的时刻（0 = 未判出） */
+    uint32_t lost_ms;  /* 走开后判为 LOST 的时刻（0 = 未判出） */
+} sim_result_t;
+
+static sim_result_t s_res;
+static uint32_t     s_t0;
+static uint32_t     s_seed;
+static RSSI_Config  s_default_cfg; /* RSSI_Check_Init 不重置 cfg，每遍从这里恢复 */
+
+/* 合成信道：按场景时间线给出真值（dBm） */
+static int sim_truth(uint32_t t)
+{
+    if (t < SIM_APPROACH_MS)
+    {
+        return SIM_FAR_DBM;
+    }
+    if (t < SIM_APPROACH_MS + SIM_WALK_MS)
+    {
+        return SIM_FAR_DBM + (int)((SIM_NEAR_DBM - SIM_FAR_DBM) * (int)(t - SIM_APPROACH_MS) /
+                                   (int)SIM_WALK_MS);
+    }
+    if (t < SIM_LEAVE_MS)
+    {
+        return SIM_NEAR_DBM;
+    }
+    if (t < SIM_LEAVE_MS + SIM_WALK_MS)
+    {
+        return SIM_NEAR_DBM + (int)((SIM_FAR_DBM - SIM_NEAR_DBM) * (int)(t - SIM_LEAVE_MS) /
+                                    (int)SIM_WALK_MS);
+    }
+    return SIM_FAR_DBM;
+}
+
+/* 第一次越过阈值的场景时刻（真值） */
+static uint32_t sim_truth_cross(uint32_t from, int threshold, bool rising)
+{
+    for (uint32_t t = from; t < SIM_END_MS; t++)
+    {
+        int v = sim_truth(t);
+        if (rising ? (v >= threshold) : (v < threshold))
+        {
+            return t;
+        }
+    }
+    return SIM_END_MS;
+}
+
+static void sim_sample_req(uint8_t conidx)
+{
+    uint32_t t = host_time_now_ms() - s_t0;
+
+    s_seed = s_seed * 1103515245u + 12345u;
+    int rssi = sim_truth(t) + (int)((s_seed >> 16) % 5u) - 2;
+
+    s_res.samples++;
+    RSSI_Check_Update(conidx, (int8_t)rssi);
+}
+
+static void sim_dist_cb(uint8_t conidx, uint8_t new_dist, int16_t filtered, int8_t raw)
+{
+    uint32_t t = host_time_now_ms() - s_t0;
+
+    (void)conidx;
+    (void)filtered;
+    (void)raw;
+    if (new_dist == RSSI_DIST_NEAR && s_res.near_ms == 0u)
+    {
+        s_res.near_ms = t;
+    }
+    if (new_dist == RSSI_DIST_LOST && t >= SIM_LEAVE_MS && s_res.lost_ms == 0u)
+    {
+        s_res.lost_ms = t;
+    }
+}
+
+static sim_result_t sim_run(bool adaptive)
+{
+    RSSI_Checker* self = RSSI_Get_Default();
+
+    memset(&s_res, 0, sizeof(s_res));
+    s_seed = 1u;
+    host_stubs_reset();
+    RSSI_Check_Init();
+    self->cfg = s_default_cfg;
+    if (!adaptive)
+    {
+        /* 三档都设成 500 ms，等价于原来的 sp_rssi_req_timer */
+        self->cfg.fast_period_ms   = 500u;
+        self->cfg.normal_period_ms = 500u;
+        self->cfg.slow_period_ms   = 500u;
+    }
+    RSSI_Check_Set_DistanceChangeCb(sim_dist_cb);
+
+    s_t0 = host_time_now_ms();
+    RSSI_Check_Enable(SIM_CONIDX, NULL);
+    RSSI_Check_Enable_Sampling(SIM_CONIDX, sim_sample_req);
+    host_time_advance(SIM_END_MS);
+    RSSI_Check_Disable(SIM_CONIDX);
+    return s_res;
+}
+
+static void sim_print(const char* name, const sim_result_t* r, uint32_t near_truth, uint32_t lost_truth)
+{
+    printf("  %-8s: %6u samples  %6.1f samples/min  NEAR after %5u ms  LOST after %5u ms\n",
+           name,
+           (unsigned)r->samples,
+           (double)r->samples * 60000.0 / (double)SIM_END_MS,
+           (unsigned)(r->near_ms ? r->near_ms - near_truth : 0u),
+           (unsigned)(r->lost_ms ? r->lost_ms - lost_truth : 0u));
+}
+
+int main(void)
+{
+    RSSI_Check_Init();
+
+    RSSI_Config* cfg        = &RSSI_Get_Default()->cfg;
+    s_default_cfg           = *cfg;
+    uint32_t     near_truth = sim_truth_cross(0u, cfg->near_threshold, true);
+    uint32_t     lost_truth = sim_truth_cross(SIM_LEAVE_MS, cfg->lost_threshold, false);
+
+    printf("rssi_sample_sim (%.1f min, near %d dBm @%u ms, lost %d dBm @%u ms):\n",
+           (double)SIM_END_MS / 60000.0,
+           (int)cfg->near_threshold,
+           (unsigned)near_truth,
+           (int)cfg->lost_threshold,
+           (unsigned)lost_truth);
+
+    sim_result_t fixed = sim_run(false);
+    sim_print("fixed", &fixed, near_truth, lost_truth);
+    sim_result_t adapt = sim_run(true);
+    sim_print("adaptive", &adapt, near_truth, lost_truth);
+    if (adapt.samples > 0u)
+    {
+        printf("  adaptive vs fixed: %.1fx fewer samples\n",
+               (double)fixed.samples / (double)adapt.samples);
+    }
+
+    int fail = (fixed.near_ms == 0u || fixed.lost_ms == 0u ||
+                adapt.near_ms == 0u || adapt.lost_ms == 0u ||
+                adapt.near_ms > fixed.near_ms ||
+                adapt.samples >= fixed.samples);
+    printf("rssi_sample_sim: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
@@ -0,0 +1,192 @@
+/*********************************************************************
+ * @file soc_mcu_codec_bench.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief soc_mcu_codec.h 吞吐基准：编码 / 流式解码 bytes/s（按数据段长度分档）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 每档 data 长度（默认 8 / 32 / 128 / 最大）各生成 --frames 帧：
+ * - encode：soc_mcu_encode 逐帧编码进一段连续缓冲；
+ * - decode：把这段缓冲按 --chunk 字节（FIFO 水位）切块 feed，HDR_OK 时 attach 帧缓冲。
+ * 每项跑 BENCH_ROUNDS 轮取中位数，输出 MB/s 与每字节周期数。
+ *
+ * 正确性：解出的帧数必须等于编码帧数且全部 crc_ok，否则返回 1（ctest 以此判定）；
+ * 吞吐只打印不判定。同一份源码按 SOC_MCU_USE_CRC16=0/1 各编一个可执行文件。
+ *
+ * 用法：soc_mcu_codec_bench [--frames N] [--chunk N]
+ *********************************************************************/
+
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_timer.h"
+#include "soc_mcu_codec.h"
+
+#define BENCH_DEFAULT_FRAMES 20000u
+#define BENCH_DEFAULT_CHUNK  16u
+#define BENCH_ROUNDS         5u
+
+static const uint16_t s_sizes[] = {8u, 32u, 128u, SOC_MCU_DATA_MAX};
+
+static uint8_t* s_stream = NULL;
+static uint8_t  s_payload[SOC_MCU_DATA_MAX];
+
+typedef struct
+{
+    uint64_t ns;
+    uint64_t cycles;
+} bench_sample_t;
+
+static int bench_cmp_sample(const void* a, const void* b)
+{
+    uint64_t x = ((const bench_sample_t*)a)->ns;
+    uint64_t y = ((const bench_sample_t*)b)->ns;
+    return (x > y) - (x < y);
+}
+
+static uint32_t bench_encode(uint16_t data_len, uint32_t frames)
+{
+    uint32_t n = 0u;
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        /* id 每帧不同，避免编译器把循环体当成不变量 */
+        n += soc_mcu_encode(SOC_MCU_SYNC_SOC_TO_MCU, 0xFF02u, (uint16_t)i, s_payload, data_len,
+                            &s_stream[n], SOC_MCU_FRAME_MAX_LEN);
+    }
+    return n;
+}
+
+static uint32_t bench_decode(uint32_t len, uint16_t chunk, uint32_t* crc_bad)
+{
+    static uint8_t  buf[SOC_MCU_FRAME_MAX_LEN];
+    soc_mcu_dec_t   dec;
+    soc_mcu_frame_t fr;
+    uint32_t        frames = 0u;
+
+    memset(&dec, 0, sizeof(dec));
+    soc_mcu_dec_reset(&dec);
+    *crc_bad = 0u;
+    for (uint32_t pos = 0; pos < len; pos += chunk)
+    {
+        const uint8_t* p = &s_stream[pos];
+        uint16_t       n = (uint16_t)((len - pos < chunk) ? (len - pos) : chunk);
+        while (n > 0u)
+        {
+            soc_mcu_dec_ev_t ev;
+            uint16_t         used = soc_mcu_dec_feed(&dec, p, n, &ev, &fr);
+            if (ev == SOC_MCU_DEC_HDR_OK)
+            {
+                soc_mcu_dec_attach(&dec, buf);
+            }
+            else if (ev == SOC_MCU_DEC_FRAME)
+            {
+                frames++;
+                *crc_bad += fr.crc_ok ? 0u : 1u;
+            }
+            p += used;
+            n  = (uint16_t)(n - used);
+        }
+    }
+    return frames;
+}
+
+static void bench_print(const char* what, uint16_t data_len, uint32_t bytes, bench_sample_t s)
+{
+    double mbps = (s.ns > 0u) ? (double)bytes * 1000.0 / (double)s.ns : 0.0;
+    printf("  %-6s data %3u B : %8.1f MB/s", what, (unsigned)data_len, mbps);
+    if (BENCH_HAVE_TSC)
+    {
+        printf("  %6.2f cycles/byte", (double)s.cycles / (double)bytes);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frames = BENCH_DEFAULT_FRAMES;
+    uint16_t chunk  = BENCH_DEFAULT_CHUNK;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+        {
+            chunk = (uint16_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames N] [--chunk N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames == 0u)
+    {
+        frames = 1u;
+    }
+    if (chunk == 0u)
+    {
+        chunk = 1u;
+    }
+
+    s_stream = (uint8_t*)malloc((size_t)frames * SOC_MCU_FRAME_MAX_LEN);
+    if (s_stream == NULL)
+    {
+        fprintf(stderr, "soc_mcu_codec_bench: out of memory\n");
+        return 1;
+    }
+    for (uint16_t i = 0; i < SOC_MCU_DATA_MAX; i++)
+    {
+        s_payload[i] = (uint8_t)(i * 37u + 11u);
+    }
+
+    int fail = 0;
+    printf("soc_mcu_codec_bench (%s, %u frames/size, chunk %u B):\n",
+           SOC_MCU_USE_CRC16 ? "crc16" : "sum8", (unsigned)frames, (unsigned)chunk);
+    for (size_t k = 0; k < sizeof(s_sizes) / sizeof(s_sizes[0]); k++)
+    {
+        uint16_t       data_len = s_sizes[k];
+        bench_sample_t enc[BENCH_ROUNDS];
+        bench_sample_t dec[BENCH_ROUNDS];
+        uint32_t       bytes = 0u;
+        uint32_t       got   = 0u;
+        uint32_t       bad   = 0u;
+
+        for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+        {
+            uint64_t t0 = bench_ns();
+            uint64_t c0 = bench_cycles();
+            bytes       = bench_encode(data_len, frames);
+            enc[r].cycles = bench_cycles() - c0;
+            enc[r].ns     = bench_ns() - t0;
+
+            t0            = bench_ns();
+            c0            = bench_cycles();
+            got           = bench_decode(bytes, chunk, &bad);
+            dec[r].cycles = bench_cycles() - c0;
+            dec[r].ns     = bench_ns() - t0;
+        }
+        qsort(enc, BENCH_ROUNDS, sizeof(enc[0]), bench_cmp_sample);
+        qsort(dec, BENCH_ROUNDS, sizeof(dec[0]), bench_cmp_sample);
+
+        if (bytes != frames * (uint32_t)SOC_MCU_FRAME_LEN(data_len) || got != frames || bad != 0u)
+        {
+            fprintf(stderr, "soc_mcu_codec_bench: data %u: %u bytes, %u/%u frames, %u crc errors\n",
+                    (unsigned)data_len, (unsigned)bytes, (unsigned)got, (unsigned)frames,
+                    (unsigned)bad);
+            fail = 1;
+        }
+        bench_print("encode", data_len, bytes, enc[BENCH_ROUNDS / 2u]);
+        bench_print("decode", data_len, bytes, dec[BENCH_ROUNDS / 2u]);
+    }
+
+    free(s_stream);
+    printf("soc_mcu_codec_bench: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
@@ -0,0 +1,282 @@
+/*********************************************************************
+ * @file tpms_relay_sim.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief TPMS 透传去重仿真：每条广播一帧 UART vs 按 sensor_id 去重 + 心跳
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 场景（虚拟时钟，20 min）：本车 2 个传感器 + 旁边车 4 个传感器。
+ * - 0-10 min 行驶：每 4 s 唤醒一次，胎温/胎压随行驶慢慢升；
+ * - 10-20 min 驻车：每 30 s 唤醒一次，胎温慢慢降；15 min 起本车 1 号轮漏气，
+ *   胎压每次唤醒掉一格，状态切到“驻车漏气”。
+ * 每次唤醒 rolling_cnt 加一，同一内容连发 SIM_BURST_PKTS 包，ADV/SCAN_RSP 各收到一份。
+ *
+ * 自检（两遍都做），任一不满足返回 1：
+ * - 每次唤醒后，MCU 侧（UART 抓包）看到的该传感器数值必须就是这次唤醒的数值
+ *   （数值变化/漏气报警不能被吞、不能延迟）；
+ * - 心跳打开时，同一传感器两帧 UART 间隔不超过 心跳 + 唤醒周期；
+ * - 去重后的帧数少于去重前。
+ * 帧数、每分钟 MCU 唤醒次数、UART 字节数、抑制原因分布只打印。
+ *
+ * 用法：tpms_relay_sim [--heartbeat MS]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TPMS.h"
+#include "host_stubs.h"
+
+#define SIM_END_MS        (20u * 60000u)
+#define SIM_PARK_MS       (10u * 60000u)
+#define SIM_LEAK_MS       (15u * 60000u)
+#define SIM_DRIVE_PERIOD  4000u
+#define SIM_PARK_PERIOD   30000u
+#define SIM_BURST_PKTS    4u
+#define SIM_PKT_GAP_MS    20u
+#define SIM_SENSORS       6u /* 前 2 个是本车的 */
+#define SIM_UART_FRAME_B  (18u + 10u) /* 透传 payload + SOC<->MCU 帧头尾（只用于估算字节数） */
+
+typedef struct
+{
+    uint8_t status;
+    uint8_t p_raw;
+    int8_t  t_c;
+    uint8_t v_raw;
+} sim_val_t;
+
+typedef struct
+{
+    uint32_t id;
+    uint8_t  mac[6];
+    uint32_t rolling;
+    uint32_t next_ms;
+
+    /* MCU 侧看到的最新一帧 */
+    bool      seen;
+    sim_val_t mcu;
+    uint32_t  mcu_ms;
+    uint32_t  max_gap_ms;
+} sim_sensor_t;
+
+typedef struct
+{
+    uint32_t        frames;
+    uint32_t        stale;   /* 唤醒后 MCU 数值不是最新的次数 */
+    uint32_t        max_gap; /* 所有传感器里最长的 UART 间隔 */
+    TPMS_RelayStats st;
+} sim_result_t;
+
+static sim_sensor_t s_sensor[SIM_SENSORS];
+static sim_result_t s_res;
+
+/* 按场景时间线给出某个传感器当前的测量值 */
+static sim_val_t sim_values(uint32_t idx, uint32_t t)
+{
+    sim_val_t v;
+    uint32_t  drive_t = (t < SIM_PARK_MS) ? t : SIM_PARK_MS;
+
+    v.v_raw  = (uint8_t)(170u + idx);
+    v.p_raw  = (uint8_t)(72u + idx % 3u + drive_t / 90000u);
+    v.t_c    = (int8_t)(18 + (int)(drive_t / 60000u));
+    v.status = 0x93u; /* 电池正常 + 行驶 */
+    if (t >= SIM_PARK_MS)
+    {
+        uint32_t cool = (t - SIM_PARK_MS) / 60000u;
+        v.t_c         = (int8_t)(v.t_c - (int)(cool > 8u ? 8u : cool));
+        v.status      = 0x91u;
+    }
+    if (idx == 1u && t >= SIM_LEAK_MS)
+    {
+        uint32_t drop = (t - SIM_LEAK_MS) / SIM_PARK_PERIOD + 1u;
+        v.p_raw       = (uint8_t)(v.p_raw > drop + 20u ? v.p_raw - drop : 20u);
+        v.status      = 0x96u;
+    }
+    return v;
+}
+
+/* 透传帧：Wheel(1) ID(4,BE) P(2,BE,x100) T(1) V(2,BE,x100) Status(1) MAC(6) RSSI(1) */
+static void sim_uart_hook(uint16_t sync, uint16_t feature, uint16_t id, const uint8_t* data,
+                          uint16_t len)
+{
+    (void)sync;
+    (void)feature;
+    (void)id;
+    if (len < 11u)
+    {
+        return;
+    }
+    uint32_t sid = ((uint32_t)data[1] << 24) | ((uint32_t)data[2] << 16) |
+                   ((uint32_t)data[3] << 8) | data[4];
+    uint32_t now = host_time_now_ms();
+
+    s_res.frames++;
+    for (uint32_t i = 0; i < SIM_SENSORS; i++)
+    {
+        sim_sensor_t* s = &s_sensor[i];
+        if (s->id != sid)
+        {
+            continue;
+        }
+        if (s->seen && now - s->mcu_ms > s->max_gap_ms)
+        {
+            s->max_gap_ms = now - s->mcu_ms;
+        }
+        s->seen       = true;
+        s->mcu_ms     = now;
+        s->mcu.p_raw  = (uint8_t)((((uint16_t)data[5] << 8) | data[6]) / 314u);
+        s->mcu.t_c    = (int8_t)data[7];
+        s->mcu.v_raw  = (uint8_t)((((uint16_t)data[8] << 8) | data[9]) - 122u);
+        s->mcu.status = data[10];
+    }
+}
+
+/* 0x14 0xFF 0x4D status rolling(4,LE) id(4,LE) P T V mac(6) */
+static void sim_send_burst(uint32_t idx, uint32_t t)
+{
+    sim_sensor_t* s = &s_sensor[idx];
+    sim_val_t     v = sim_values(idx, t);
+    uint8_t       d[21];
+
+    s->rolling++;
+    d[0] = 0x14u;
+    d[1] = 0xFFu;
+    d[2] = 0x4Du;
+    d[3] = v.status;
+    for (uint32_t k = 0; k < 4u; k++)
+    {
+        d[4u + k] = (uint8_t)(s->rolling >> (8u * k));
+        d[8u + k] = (uint8_t)(s->id >> (8u * k));
+    }
+    d[12] = v.p_raw;
+    d[13] = (uint8_t)v.t_c;
+    d[14] = v.v_raw;
+    memcpy(&d[15], s->mac, 6);
+
+    for (uint32_t n = 0; n < SIM_BURST_PKTS; n++)
+    {
+        TPMS_Feed_Adv(s->mac, (int8_t)(-70 - (int)n), d, sizeof(d)); /* ADV */
+        TPMS_Feed_Adv(s->mac, (int8_t)(-71 - (int)n), d, sizeof(d)); /* SCAN_RSP */
+        host_time_advance(SIM_PKT_GAP_MS);
+    }
+
+    if (!s->seen || memcmp(&s->mcu, &v, sizeof(v)) != 0)
+    {
+        s_res.stale++;
+    }
+}
+
+static sim_result_t sim_run(bool relay, uint32_t heartbeat_ms)
+{
+    memset(&s_res, 0, sizeof(s_res));
+    memset(s_sensor, 0, sizeof(s_sensor));
+    for (uint32_t i = 0; i < SIM_SENSORS; i++)
+    {
+        s_sensor[i].id      = (i < 2u) ? (0x11223344u + i) : (0xB0000000u + i);
+        s_sensor[i].next_ms = 137u * i; /* 各传感器唤醒时刻错开 */
+        for (uint32_t k = 0; k < 6u; k++)
+        {
+            s_sensor[i].mac[k] = (uint8_t)(0x40u + i * 6u + k);
+        }
+    }
+
+    host_stubs_reset();
+    host_flash_reset();
+    TPMS_Init();
+    TPMS_Relay_Set_Enable(relay);
+    TPMS_Relay_Set_Heartbeat(heartbeat_ms);
+    host_set_uart_hook(sim_uart_hook);
+
+    uint32_t t0 = host_time_now_ms();
+    for (;;)
+    {
+        uint32_t next = 0u;
+        for (uint32_t i = 1; i < SIM_SENSORS; i++)
+        {
+            if (s_sensor[i].next_ms < s_sensor[next].next_ms)
+            {
+                next = i;
+            }
+        }
+        uint32_t t = s_sensor[next].next_ms;
+        if (t >= SIM_END_MS)
+        {
+            break;
+        }
+        uint32_t now = host_time_now_ms() - t0;
+        if (t > now)
+        {
+            host_time_advance(t - now);
+        }
+        sim_send_burst(next, t);
+        s_sensor[next].next_ms += (t < SIM_PARK_MS) ? SIM_DRIVE_PERIOD : SIM_PARK_PERIOD;
+    }
+
+    host_set_uart_hook(NULL);
+    TPMS_Relay_Get_Stats(&s_res.st);
+    for (uint32_t i = 0; i < SIM_SENSORS; i++)
+    {
+        if (s_sensor[i].max_gap_ms > s_res.max_gap)
+        {
+            s_res.max_gap = s_sensor[i].max_gap_ms;
+        }
+    }
+    return s_res;
+}
+
+static void sim_print(const char* name, const sim_result_t* r)
+{
+    double min = (double)SIM_END_MS / 60000.0;
+
+    printf("  %-6s: %6u frames  %6.1f MCU wakeups/min  %7.0f UART B/min  max gap %6u ms"
+           "  stale %u  hb/dup/unchanged %u/%u/%u\n",
+           name,
+           (unsigned)r->frames,
+           (double)r->frames / min,
+           (double)r->frames * SIM_UART_FRAME_B / min,
+           (unsigned)r->max_gap,
+           (unsigned)r->stale,
+           (unsigned)r->st.heartbeats,
+           (unsigned)r->st.sup_dup,
+           (unsigned)r->st.sup_unchanged);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t heartbeat_ms = TPMS_RELAY_HEARTBEAT_MS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--heartbeat") == 0 && i + 1 < argc)
+        {
+            heartbeat_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--heartbeat MS]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("tpms_relay_sim (%.0f min, %u sensors, %u pkts x ADV+SCAN_RSP per wakeup, "
+           "heartbeat %u ms):\n",
+           (double)SIM_END_MS / 60000.0, (unsigned)SIM_SENSORS, (unsigned)SIM_BURST_PKTS,
+           (unsigned)heartbeat_ms);
+
+    sim_result_t off = sim_run(false, heartbeat_ms);
+    sim_print("off", &off);
+    sim_result_t on = sim_run(true, heartbeat_ms);
+    sim_print("relay", &on);
+    if (on.frames > 0u)
+    {
+        printf("  relay vs off: %.1fx fewer UART frames\n", (double)off.frames / (double)on.frames);
+    }
+
+    int fail = (off.stale != 0u || on.stale != 0u || on.frames >= off.frames ||
+                (heartbeat_ms != 0u && on.max_gap > heartbeat_ms + SIM_PARK_PERIOD));
+    printf("tpms_relay_sim: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
@@ -0,0 +1,431 @@
+/*********************************************************************
+ * @file tpms_scan_bench.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief TPMS 扫描前置过滤基准：停车场背景广播下每条扫描报告的处理成本
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 场景：200 个背景广播源（iBeacon、flags+名字、微软厂商段、Eddystone、
+ * 恰好 0x14 长度但头字节不对的 0xFF 段、别的车的 TPMS 传感器）+ 本车 2 个传感器，
+ * 按固定种子随机交错，经 BLE_Scanner_Event_Handler（= 板上 GAP_EVT_ADV_REPORT 分支）
+ * 一路走到 TPMS_Feed_Adv -> SocMcu_Frame_Send。
+ *
+ * 两种绑定状态 x 过滤开/关各跑一遍：
+ * - unbound：flash 里没有绑定表，透传所有 TPMS；
+ * - bound  ：旧绑定扇区预置本车 2 个传感器的绑定表，TPMS_Init 迁移进 kv_store 后读回。
+ *
+ * 自检，任一不满足返回 1：
+ * - unbound：过滤开/关的 UART 输出逐帧一致（过滤不能漏掉任何 TPMS）；
+ * - bound  ：过滤开时只转发绑定的 sensor_id，且与过滤关时这两个 ID 的输出逐帧一致；
+ * - 过滤开时每个非 TPMS 背景源都在前置过滤里被拒。
+ * 每条报告的周期数、memcpy 字节数、拒绝原因分布只打印。
+ *
+ * 用法：tpms_scan_bench [--reports N]
+ *********************************************************************/
+
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TPMS.h"
+#include "bench_timer.h"
+#include "driver_flash.h"
+#include "flash_job.h"
+#include "flash_usage_config.h"
+#include "host_stubs.h"
+#include "kv_store.h"
+#include "scanner.h"
+
+#define BENCH_DEFAULT_REPORTS 200000u
+#define BENCH_BACKGROUND      200u
+#define BENCH_OTHER_CARS      20u /* 背景里有多少个是别的车的 TPMS */
+#define BENCH_SOURCES         (BENCH_BACKGROUND + TPMS_SENSOR_MAX)
+
+typedef struct
+{
+    uint8_t  mac[6];
+    uint8_t  data[31];
+    uint8_t  len;
+    bool     is_tpms;
+    uint32_t sensor_id;
+} bench_src_t;
+
+typedef struct
+{
+    uint64_t cycles;
+    uint64_t memcpy_bytes;
+    uint32_t frames;
+    uint32_t bound_frames; /* 其中 sensor_id 属于本车的 */
+    uint64_t hash;         /* 全部帧 */
+    uint64_t bound_hash;   /* 只算本车的帧 */
+    uint32_t foreign;      /* 过滤开 + bound 时不该出现的 ID */
+
+    TPMS_PrefilterStats pf;
+} bench_result_t;
+
+static const uint32_t s_bound_ids[TPMS_SENSOR_MAX] = {0x11223344u, 0x55667788u};
+
+static bench_src_t    s_src[BENCH_SOURCES];
+static uint16_t*      s_seq;
+static bench_result_t s_res;
+static bool           s_expect_bound_only;
+
+static uint32_t s_seed = 1u;
+static uint32_t bench_rand(void)
+{
+    s_seed = s_seed * 1103515245u + 12345u;
+    return s_seed >> 8;
+}
+
+static uint64_t bench_fnv(uint64_t h, const uint8_t* p, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        h = (h ^ p[i]) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+static bool bench_is_bound(uint32_t id)
+{
+    for (uint32_t i = 0; i < TPMS_SENSOR_MAX; i++)
+    {
+        if (s_bound_ids[i] == id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* 透传帧：Wheel(1) + ID(4, 大端) + ... */
+static void bench_uart_hook(uint16_t sync, uint16_t feature, uint16_t id, const uint8_t* data,
+                            uint16_t len)
+{
+    (void)sync;
+    (void)feature;
+    (void)id;
+    if (len < 5u)
+    {
+        return;
+    }
+    uint32_t sid = ((uint32_t)data[1] << 24) | ((uint32_t)data[2] << 16) |
+                   ((uint32_t)data[3] << 8) | data[4];
+
+    s_res.frames++;
+    s_res.hash = bench_fnv(s_res.hash, data, len);
+    if (bench_is_bound(sid))
+    {
+        s_res.bound_frames++;
+        s_res.bound_hash = bench_fnv(s_res.bound_hash, data, len);
+    }
+    else if (s_expect_bound_only)
+    {
+        s_res.foreign++;
+    }
+}
+
+/* ---- 背景广播源 ---- */
+static uint8_t bench_put(uint8_t* d, uint8_t at, const uint8_t* p, uint8_t n)
+{
+    memcpy(&d[at], p, n);
+    return (uint8_t)(at + n);
+}
+
+/* 本车/别的车的 TPMS：0x14 0xFF 0x4D status rolling(4) id(4, 小端) P T V mac(6) */
+static void bench_make_tpms(bench_src_t* s, uint32_t id)
+{
+    uint8_t* d = s->data;
+
+    d[0]  = 0x14u;
+    d[1]  = 0xFFu;
+    d[2]  = 0x4Du;
+    d[3]  = 0x93u;
+    d[4]  = (uint8_t)bench_rand();
+    d[5]  = 0u;
+    d[6]  = 0u;
+    d[7]  = 0u;
+    d[8]  = (uint8_t)id;
+    d[9]  = (uint8_t)(id >> 8);
+    d[10] = (uint8_t)(id >> 16);
+    d[11] = (uint8_t)(id >> 24);
+    d[12] = (uint8_t)(70u + bench_rand() % 10u);
+    d[13] = 25u;
+    d[14] = 180u;
+    memcpy(&d[15], s->mac, 6);
+    s->len       = 21u;
+    s->is_tpms   = true;
+    s->sensor_id = id;
+}
+
+static void bench_make_background(bench_src_t* s, uint32_t i)
+{
+    static const uint8_t flags[]   = {0x02, 0x01, 0x06};
+    static const uint8_t ibeacon[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15};
+    static const uint8_t msft[]    = {0x1E, 0xFF, 0x06, 0x00, 0x01, 0x09, 0x20, 0x02};
+    static const uint8_t eddy[]    = {0x03, 0x03, 0xAA, 0xFE, 0x11, 0x16, 0xAA, 0xFE, 0x10};
+    uint8_t*             d         = s->data;
+    uint8_t              n         = 0;
+
+    switch (i % 5u)
+    {
+    case 0: /* iBeacon：30 B，0xFF 段长度 0x1A */
+        n = bench_put(d, n, flags, sizeof(flags));
+        n = bench_put(d, n, ibeacon, sizeof(ibeacon));
+        while (n < 30u)
+        {
+            d[n++] = (uint8_t)bench_rand();
+        }
+        break;
+    case 1: /* flags + 完整名字（手表/耳机之类），短报告 */
+        n      = bench_put(d, n, flags, sizeof(flags));
+        d[n++] = 0x08u;
+        d[n++] = 0x09u;
+        n      = bench_put(d, n, (const uint8_t*)"Band-", 5u);
+        d[n++] = (uint8_t)('0' + i % 10u);
+        d[n++] = (uint8_t)('A' + i % 26u);
+        break;
+    case 2: /* 微软 Swift Pair 厂商段，31 B */
+        n = bench_put(d, n, msft, sizeof(msft));
+        while (n < 31u)
+        {
+            d[n++] = (uint8_t)bench_rand();
+        }
+        break;
+    case 3: /* Eddystone-URL */
+        n = bench_put(d, n, flags, sizeof(flags));
+        n = bench_put(d, n, eddy, sizeof(eddy));
+        while (n < 3u + 4u + 0x12u)
+        {
+            d[n++] = (uint8_t)('a' + bench_rand() % 26u);
+        }
+        break;
+    default: /* 对抗样本：0xFF 段恰好 0x14 长，但头字节不是 0x4D */
+        n      = bench_put(d, n, flags, sizeof(flags));
+        d[n++] = 0x14u;
+        d[n++] = 0xFFu;
+        d[n++] = (uint8_t)(0x4Eu + i % 16u);
+        while (n < 24u)
+        {
+            d[n++] = (uint8_t)bench_rand();
+        }
+        break;
+    }
+    s->len     = n;
+    s->is_tpms = false;
+}
+
+static void bench_build_sources(void)
+{
+    for (uint32_t i = 0; i < BENCH_SOURCES; i++)
+    {
+        bench_src_t* s = &s_src[i];
+        for (uint32_t k = 0; k < 6u; k++)
+        {
+            s->mac[k] = (uint8_t)bench_rand();
+        }
+        if (i >= BENCH_BACKGROUND)
+        {
+            bench_make_tpms(s, s_bound_ids[i - BENCH_BACKGROUND]);
+        }
+        else if (i < BENCH_OTHER_CARS)
+        {
+            bench_make_tpms(s, 0xA0000000u + i);
+        }
+        else
+        {
+            bench_make_background(s, i);
+        }
+    }
+}
+
+/* 按 TPMS.c 的 tpms_bind_store_t 布局把绑定表写进旧扇区（TPMS_Init 迁移进 kv_store） */
+static uint16_t bench_crc16(const uint8_t* p, uint32_t n)
+{
+    uint16_t crc = 0xFFFFu;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        crc ^= (uint16_t)p[i] << 8;
+        for (uint8_t b = 0; b < 8u; b++)
+        {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void bench_preload_bindings(void)
+{
+    struct
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t size;
+        struct
+        {
+            uint8_t  valid;
+            uint8_t  rsv0[3];
+            uint32_t sensor_id;
+            uint8_t  mac_le[6];
+            uint8_t  rsv1[2];
+        } entry[TPMS_SENSOR_MAX];
+        uint16_t crc16;
+        uint16_t rsv2;
+    } st;
+
+    memset(&st, 0, sizeof(st));
+    st.magic   = 0x534D5054u;
+    st.version = 1u;
+    st.size    = (uint16_t)sizeof(st);
+    for (uint32_t i = 0; i < TPMS_SENSOR_MAX; i++)
+    {
+        st.entry[i].valid     = 1u;
+        st.entry[i].sensor_id = s_bound_ids[i];
+        memcpy(st.entry[i].mac_le, s_src[BENCH_BACKGROUND + i].mac, 6);
+    }
+    st.crc16 = bench_crc16((const uint8_t*)&st, (uint32_t)(sizeof(st) - 4u));
+    flash_erase(TPMS_BINDING_INFO_SAVE_ADDR, 0x1000u);
+    flash_write(TPMS_BINDING_INFO_SAVE_ADDR, sizeof(st), (uint8_t*)&st);
+}
+
+static bench_result_t bench_run(uint32_t reports, bool bound, bool prefilter)
+{
+    BLE_Central_Base_t   scanner;
+    gap_evt_adv_report_t rpt;
+    gap_event_t          evt;
+
+    host_stubs_reset();
+    host_flash_reset();
+    if (bound)
+    {
+        bench_preload_bindings();
+    }
+    FlashJob_Init(); /* 重新上电：flash 已换成新的，清掉旧作业再挂载 */
+    KV_Init();
+    TPMS_Init();
+    TPMS_Prefilter_Set_Enable(prefilter);
+    TPMS_Relay_Set_Enable(false); /* 只比较前置过滤：每条放行的报告都要有一帧 UART */
+    BLE_Scanner_Create(&scanner);
+
+    memset(&s_res, 0, sizeof(s_res));
+    s_res.hash          = 0xCBF29CE484222325ull;
+    s_res.bound_hash    = 0xCBF29CE484222325ull;
+    s_expect_bound_only = bound && prefilter;
+    host_set_uart_hook(bench_uart_hook);
+
+    memset(&rpt, 0, sizeof(rpt));
+    memset(&evt, 0, sizeof(evt));
+    evt.type          = GAP_EVT_ADV_REPORT;
+    evt.param.adv_rpt = &rpt;
+
+    uint64_t m0 = g_host_stats.memcpy_bytes;
+    uint64_t t0 = bench_now();
+    for (uint32_t r = 0; r < reports; r++)
+    {
+        bench_src_t* s = &s_src[s_seq[r]];
+        memcpy(rpt.src_addr.addr.addr, s->mac, 6);
+        rpt.rssi   = (int8_t)(-60 - (int)(r & 31u));
+        rpt.data   = s->data;
+        rpt.length = s->len;
+        BLE_Scanner_Event_Handler(&evt);
+    }
+    s_res.cycles       = bench_now() - t0;
+    s_res.memcpy_bytes = g_host_stats.memcpy_bytes - m0;
+    TPMS_Prefilter_Get_Stats(&s_res.pf);
+    host_set_uart_hook(NULL);
+    return s_res;
+}
+
+static void bench_print(const char* name, const bench_result_t* r, uint32_t reports)
+{
+    printf("  %-13s: %7.1f %s/report  memcpy %5.2f B/report  UART %6u frames"
+           "  pass %6u  rej len/sig/bind %u/%u/%u\n",
+           name,
+           (double)r->cycles / (double)reports,
+           BENCH_UNIT,
+           (double)r->memcpy_bytes / (double)reports,
+           (unsigned)r->frames,
+           (unsigned)r->pf.accepted,
+           (unsigned)r->pf.rej_len,
+           (unsigned)r->pf.rej_sig,
+           (unsigned)r->pf.rej_bind);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t reports      = BENCH_DEFAULT_REPORTS;
+    uint32_t tpms_reports = 0;
+    int      fail         = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--reports") == 0 && i + 1 < argc)
+        {
+            reports = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--reports N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (reports == 0u)
+    {
+        reports = 1u;
+    }
+
+    bench_build_sources();
+    s_seq = (uint16_t*)malloc(reports * sizeof(uint16_t));
+    if (s_seq == NULL)
+    {
+        return 2;
+    }
+    for (uint32_t r = 0; r < reports; r++)
+    {
+        s_seq[r] = (uint16_t)(bench_rand() % BENCH_SOURCES);
+        tpms_reports += s_src[s_seq[r]].is_tpms ? 1u : 0u;
+    }
+
+    printf("tpms_scan_bench (%u sources: %u background incl. %u foreign TPMS, %u bound; "
+           "%u reports, %u TPMS):\n",
+           (unsigned)BENCH_SOURCES, (unsigned)BENCH_BACKGROUND, (unsigned)BENCH_OTHER_CARS,
+           (unsigned)TPMS_SENSOR_MAX, (unsigned)reports, (unsigned)tpms_reports);
+
+    bench_result_t ub_off = bench_run(reports, false, false);
+    bench_print("unbound  off", &ub_off, reports);
+    bench_result_t ub_on = bench_run(reports, false, true);
+    bench_print("unbound  on", &ub_on, reports);
+    bench_result_t b_off = bench_run(reports, true, false);
+    bench_print("bound    off", &b_off, reports);
+    bench_result_t b_on = bench_run(reports, true, true);
+    bench_print("bound    on", &b_on, reports);
+    if (b_on.cycles > 0u && ub_on.cycles > 0u)
+    {
+        printf("  prefilter speedup: unbound %.1fx, bound %.1fx\n",
+               (double)ub_off.cycles / (double)ub_on.cycles,
+               (double)b_off.cycles / (double)b_on.cycles);
+    }
+
+    if (ub_on.frames != ub_off.frames || ub_on.hash != ub_off.hash || ub_off.frames != tpms_reports)
+    {
+        fprintf(stderr, "tpms_scan_bench: unbound output differs with prefilter on\n");
+        fail = 1;
+    }
+    if (b_on.foreign != 0u || b_on.frames != b_off.bound_frames || b_on.hash != b_off.bound_hash)
+    {
+        fprintf(stderr, "tpms_scan_bench: bound prefilter forwarded wrong sensors\n");
+        fail = 1;
+    }
+    if (ub_on.pf.accepted != tpms_reports || b_on.pf.accepted != b_on.frames)
+    {
+        fprintf(stderr, "tpms_scan_bench: non-TPMS reports passed the prefilter\n");
+        fail = 1;
+    }
+
+    free(s_seq);
+    printf("tpms_scan_bench: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
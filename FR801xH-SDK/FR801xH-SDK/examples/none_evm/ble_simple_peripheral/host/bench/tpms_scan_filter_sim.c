@@ -0,0 +1,556 @@
+/*********************************************************************
+ * @file tpms_scan_filter_sim.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 已绑定 TPMS 后的过滤扫描仿真：应用层每分钟收到多少条扫描报告
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 控制器模型（虚拟时钟，1 ms 分辨率）：
+ * - 扫描间隔/窗口取 gap_start_scan 的参数，广播事件落在窗口内才收到；
+ * - GEN_DISC（主动扫描）：可扫描设备再多一条 SCAN_RSP 报告；OBSERVER（被动）只有 ADV；
+ * - dup_filt_pol=1：一轮扫描内同一广播源的 ADV/SCAN_RSP 各只报一次（按地址去重，最坏情况）；
+ * - duration 到时、或固件调用 gap_stop_scan：送一个 GAP_EVT_SCAN_END，固件在里面重启扫描。
+ * 每条报告都走 BLE_Scanner_Event_Handler（= 板上 app_gap_evt_cb 里的调用），即“应用层回调”。
+ *
+ * 广播源：200 个背景设备（间隔 100~1000 ms，一半可扫描，其中 20 个是别的车的 TPMS）
+ * + 本车 2 个传感器（约每 4 s 唤醒连发 4 包，胎压每 23 s 变一次）。
+ *
+ * 三遍，各 SIM_END_MS：
+ * - unbound ：没有绑定，开放扫描（改造前的行为）；
+ * - bound   ：flash 预置本车 2 个传感器的绑定表，过滤扫描；
+ * - replace ：bound 基础上 2:00 调 TPMS_Replace_Start(0, 20 s)，窗口内必须回到开放扫描，
+ *             窗口结束（另一个轮位仍绑定）回到过滤扫描。
+ *
+ * 自检，任一不满足返回 1：
+ * - bound 的每分钟回调数不到 unbound 的一半；
+ * - bound 下本车传感器每个胎压值都送到了 MCU，且延迟不超过 一轮去重窗口 + 唤醒周期；
+ * - replace 的学习窗口内是开放扫描，窗口结束后回到过滤扫描。
+ *
+ * 用法：tpms_scan_filter_sim
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TPMS.h"
+#include "driver_flash.h"
+#include "flash_job.h"
+#include "flash_usage_config.h"
+#include "gap_api.h"
+#include "host_stubs.h"
+#include "kv_store.h"
+#include "scanner.h"
+
+#define SIM_END_MS         (5u * 60000u)
+#define SIM_MINUTES        (SIM_END_MS / 60000u)
+#define SIM_BACKGROUND     200u
+#define SIM_OTHER_CARS     20u
+#define SIM_SOURCES        (SIM_BACKGROUND + TPMS_SENSOR_MAX)
+#define SIM_WAKE_MS        4000u
+#define SIM_BURST_PKTS     4u
+#define SIM_PKT_GAP_MS     20u
+#define SIM_VALUE_MS       23000u /* 本车传感器胎压变化周期（与唤醒/去重窗口不成整数倍） */
+#define SIM_REPLACE_AT_MS  120000u
+#define SIM_REPLACE_WIN_MS 20000u
+#define SIM_DUP_WINDOW_MS  5000u /* 与 scanner.c 的 SCAN_TPMS_DUP_WINDOW_MS 默认值一致 */
+
+typedef struct
+{
+    uint8_t  mac[6];
+    uint8_t  adv[31];
+    uint8_t  adv_len;
+    uint8_t  rsp[31];
+    uint8_t  rsp_len;    /* 0 = 不可扫描 */
+    uint32_t interval;   /* 背景设备的广播间隔 */
+    uint32_t next_ms;
+    uint8_t  burst_left; /* 本车/别的车 TPMS：本次唤醒还剩几包 */
+    bool     tpms;
+    uint32_t rolling;
+
+    /* 本车传感器：当前胎压值何时开始广播、是否已到 MCU */
+    int      own;        /* 本车轮位，-1 = 不是 */
+    uint8_t  p_raw;
+    uint32_t p_since_ms;
+    bool     p_delivered;
+} sim_src_t;
+
+typedef struct
+{
+    uint32_t cb_total;
+    uint32_t cb_per_min[SIM_MINUTES];
+    uint32_t sessions;     /* gap_start_scan 次数 */
+    uint32_t values;       /* 本车传感器胎压值个数 */
+    uint32_t missed;       /* 没送到 MCU 就被下一个值覆盖的 */
+    uint32_t max_latency;  /* 胎压变化到 MCU 收到的最长延迟 */
+    bool     replace_open; /* 学习窗口中途是开放扫描 */
+    bool     replace_back; /* 学习窗口结束后回到过滤扫描 */
+} sim_result_t;
+
+static sim_src_t    s_src[SIM_SOURCES];
+static sim_result_t s_res;
+static uint32_t     s_seed;
+
+/* 控制器侧的扫描状态 */
+static bool             s_scan_on;
+static gap_scan_param_t s_scan;
+static uint32_t         s_scan_t0;
+static uint64_t         s_seen_starts;
+static uint64_t         s_seen_stops;
+static uint8_t          s_dup[SIM_SOURCES]; /* bit0 ADV、bit1 SCAN_RSP 已报 */
+
+static BLE_Central_Base_t s_scanner;
+
+static uint32_t sim_rand(void)
+{
+    s_seed = s_seed * 1103515245u + 12345u;
+    return s_seed >> 8;
+}
+
+static uint32_t sim_now(void)
+{
+    return host_time_now_ms();
+}
+
+/* ---- 广播源 ---- */
+static void sim_make_tpms(sim_src_t* s, uint32_t id, uint8_t p_raw)
+{
+    uint8_t* d = s->adv;
+
+    s->rolling++;
+    d[0] = 0x14u;
+    d[1] = 0xFFu;
+    d[2] = 0x4Du;
+    d[3] = 0x93u;
+    for (uint32_t k = 0; k < 4u; k++)
+    {
+        d[4u + k] = (uint8_t)(s->rolling >> (8u * k));
+        d[8u + k] = (uint8_t)(id >> (8u * k));
+    }
+    d[12] = p_raw;
+    d[13] = 25u;
+    d[14] = 180u;
+    memcpy(&d[15], s->mac, 6);
+    s->adv_len = 21u;
+    memcpy(s->rsp, s->adv, 21u); /* ADV 与 SCAN_RSP 内容相同 */
+    s->rsp_len = 21u;
+}
+
+static void sim_build_sources(void)
+{
+    static const uint8_t ibeacon[] = {0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15};
+
+    memset(s_src, 0, sizeof(s_src));
+    for (uint32_t i = 0; i < SIM_SOURCES; i++)
+    {
+        sim_src_t* s = &s_src[i];
+        for (uint32_t k = 0; k < 6u; k++)
+        {
+            s->mac[k] = (uint8_t)sim_rand();
+        }
+        s->own = -1;
+        if (i >= SIM_BACKGROUND || i < SIM_OTHER_CARS)
+        {
+            s->tpms    = true;
+            s->next_ms = sim_rand() % SIM_WAKE_MS;
+            s->own     = (i >= SIM_BACKGROUND) ? (int)(i - SIM_BACKGROUND) : -1;
+            s->p_raw   = 70u;
+            continue;
+        }
+        s->interval = 100u + sim_rand() % 901u;
+        s->next_ms  = sim_rand() % s->interval;
+        memcpy(s->adv, ibeacon, sizeof(ibeacon));
+        for (uint32_t k = sizeof(ibeacon); k < 30u; k++)
+        {
+            s->adv[k] = (uint8_t)sim_rand();
+        }
+        s->adv_len = 30u;
+        if (i & 1u)
+        {
+            s->rsp[0]  = 0x07u;
+            s->rsp[1]  = 0x09u;
+            memcpy(&s->rsp[2], "Tag-", 4u);
+            s->rsp[6]  = (uint8_t)('0' + i % 10u);
+            s->rsp[7]  = (uint8_t)('A' + i % 26u);
+            s->rsp_len = 8u;
+        }
+    }
+}
+
+static uint32_t sim_own_id(int wheel)
+{
+    return 0x11223344u + (uint32_t)wheel;
+}
+
+/* 按 TPMS.c 的 tpms_bind_store_t 布局把绑定表写进旧扇区（TPMS_Init 迁移进 kv_store） */
+static uint16_t sim_crc16(const uint8_t* p, uint32_t n)
+{
+    uint16_t crc = 0xFFFFu;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        crc ^= (uint16_t)p[i] << 8;
+        for (uint8_t b = 0; b < 8u; b++)
+        {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void sim_preload_bindings(void)
+{
+    struct
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t size;
+        struct
+        {
+            uint8_t  valid;
+            uint8_t  rsv0[3];
+            uint32_t sensor_id;
+            uint8_t  mac_le[6];
+            uint8_t  rsv1[2];
+        } entry[TPMS_SENSOR_MAX];
+        uint16_t crc16;
+        uint16_t rsv2;
+    } st;
+
+    memset(&st, 0, sizeof(st));
+    st.magic   = 0x534D5054u;
+    st.version = 1u;
+    st.size    = (uint16_t)sizeof(st);
+    for (uint32_t i = 0; i < TPMS_SENSOR_MAX; i++)
+    {
+        st.entry[i].valid     = 1u;
+        st.entry[i].sensor_id = sim_own_id((int)i);
+        memcpy(st.entry[i].mac_le, s_src[SIM_BACKGROUND + i].mac, 6);
+    }
+    st.crc16 = sim_crc16((const uint8_t*)&st, (uint32_t)(sizeof(st) - 4u));
+    flash_erase(TPMS_BINDING_INFO_SAVE_ADDR, 0x1000u);
+    flash_write(TPMS_BINDING_INFO_SAVE_ADDR, sizeof(st), (uint8_t*)&st);
+}
+
+/* ---- MCU 侧：本车传感器的胎压值何时送到 ---- */
+static void sim_uart_hook(uint16_t sync, uint16_t feature, uint16_t id, const uint8_t* data,
+                          uint16_t len)
+{
+    (void)sync;
+    (void)feature;
+    (void)id;
+    if (len < 7u)
+    {
+        return;
+    }
+    uint32_t sid = ((uint32_t)data[1] << 24) | ((uint32_t)data[2] << 16) |
+                   ((uint32_t)data[3] << 8) | data[4];
+    uint8_t  p_raw = (uint8_t)((((uint16_t)data[5] << 8) | data[6]) / 314u);
+
+    for (uint32_t i = SIM_BACKGROUND; i < SIM_SOURCES; i++)
+    {
+        sim_src_t* s = &s_src[i];
+        if (sim_own_id(s->own) != sid || s->p_delivered || s->p_raw != p_raw)
+        {
+            continue;
+        }
+        s->p_delivered = true;
+        if (sim_now() - s->p_since_ms > s_res.max_latency)
+        {
+            s_res.max_latency = sim_now() - s->p_since_ms;
+        }
+    }
+}
+
+/* ---- 控制器 ---- */
+static void sim_deliver(gap_event_t* evt)
+{
+    BLE_Scanner_Event_Handler(evt);
+}
+
+/* 固件调过 gap_start_scan / gap_stop_scan：更新控制器状态，停扫要回一个 SCAN_END */
+static void sim_ctrl_sync(void)
+{
+    for (;;)
+    {
+        if (g_host_stats.scan_stops != s_seen_stops)
+        {
+            gap_event_t evt;
+
+            s_seen_stops = g_host_stats.scan_stops;
+            s_scan_on    = false;
+            memset(&evt, 0, sizeof(evt));
+            evt.type = GAP_EVT_SCAN_END;
+            sim_deliver(&evt);
+            continue;
+        }
+        if (g_host_stats.scan_starts != s_seen_starts)
+        {
+            s_seen_starts = g_host_stats.scan_starts;
+            s_scan        = *(const gap_scan_param_t*)host_gap_last_scan();
+            s_scan_on     = true;
+            s_scan_t0     = sim_now();
+            memset(s_dup, 0, sizeof(s_dup));
+            s_res.sessions++;
+            continue;
+        }
+        break;
+    }
+}
+
+static void sim_advance_to(uint32_t t)
+{
+    for (;;)
+    {
+        /* 一轮扫描到时：控制器自己结束，送 SCAN_END */
+        if (s_scan_on && s_scan.duration != 0u && s_scan_t0 + s_scan.duration * 10u <= t)
+        {
+            gap_event_t evt;
+            uint32_t    end = s_scan_t0 + s_scan.duration * 10u;
+
+            if (end > sim_now())
+            {
+                host_time_advance(end - sim_now());
+                sim_ctrl_sync();
+            }
+            s_scan_on = false;
+            memset(&evt, 0, sizeof(evt));
+            evt.type = GAP_EVT_SCAN_END;
+            sim_deliver(&evt);
+            sim_ctrl_sync();
+            continue;
+        }
+        break;
+    }
+    if (t > sim_now())
+    {
+        host_time_advance(t - sim_now());
+        sim_ctrl_sync();
+    }
+}
+
+static bool sim_in_window(uint32_t t)
+{
+    uint32_t intv = (uint32_t)s_scan.scan_intv * 5u / 8u;
+    uint32_t win  = (uint32_t)s_scan.scan_window * 5u / 8u;
+
+    return s_scan_on && intv != 0u && ((t - s_scan_t0) % intv) < win;
+}
+
+static void sim_report(uint32_t idx, bool rsp, uint32_t t0)
+{
+    sim_src_t*           s = &s_src[idx];
+    gap_evt_adv_report_t rpt;
+    gap_event_t          evt;
+    uint8_t              bit = rsp ? 2u : 1u;
+
+    if (s_scan.dup_filt_pol && (s_dup[idx] & bit))
+    {
+        return;
+    }
+    s_dup[idx] |= bit;
+
+    memset(&rpt, 0, sizeof(rpt));
+    memcpy(rpt.src_addr.addr.addr, s->mac, 6);
+    rpt.rssi   = (int8_t)(s->own >= 0 ? -55 : -80);
+    rpt.data   = rsp ? s->rsp : s->adv;
+    rpt.length = rsp ? s->rsp_len : s->adv_len;
+    memset(&evt, 0, sizeof(evt));
+    evt.type          = GAP_EVT_ADV_REPORT;
+    evt.param.adv_rpt = &rpt;
+
+    s_res.cb_total++;
+    s_res.cb_per_min[(sim_now() - t0) / 60000u]++;
+    sim_deliver(&evt);
+    sim_ctrl_sync();
+}
+
+/* 一个广播事件：落在扫描窗口里才收到；主动扫描再要一次 SCAN_RSP */
+static void sim_adv_event(uint32_t idx, uint32_t t0)
+{
+    sim_src_t* s = &s_src[idx];
+
+    if (!sim_in_window(sim_now()))
+    {
+        return;
+    }
+    sim_report(idx, false, t0);
+    if (s->rsp_len != 0u && s_scan.scan_mode == GAP_SCAN_MODE_GEN_DISC && s_scan_on)
+    {
+        sim_report(idx, true, t0);
+    }
+}
+
+static void sim_tpms_wakeup(uint32_t idx, uint32_t rel)
+{
+    sim_src_t* s = &s_src[idx];
+
+    if (s->own >= 0)
+    {
+        uint8_t p = (uint8_t)(70u + (rel / SIM_VALUE_MS) % 8u);
+        if (p != s->p_raw || s_res.values == 0u || s->p_since_ms == 0u)
+        {
+            if (s->p_since_ms != 0u && !s->p_delivered)
+            {
+                s_res.missed++;
+            }
+            s->p_raw       = p;
+            s->p_since_ms  = sim_now();
+            s->p_delivered = false;
+            s_res.values++;
+        }
+        sim_make_tpms(s, sim_own_id(s->own), s->p_raw);
+    }
+    else
+    {
+        sim_make_tpms(s, 0xA0000000u + idx, (uint8_t)(60u + idx % 20u));
+    }
+    s->burst_left = SIM_BURST_PKTS;
+}
+
+static bool sim_is_filtered(void)
+{
+    return s_scan_on && s_scan.dup_filt_pol != 0u;
+}
+
+static sim_result_t sim_run(bool bound, bool replace)
+{
+    memset(&s_res, 0, sizeof(s_res));
+    s_seed    = 1u;
+    s_scan_on = false;
+    sim_build_sources();
+
+    host_stubs_reset();
+    host_flash_reset();
+    if (bound)
+    {
+        sim_preload_bindings();
+    }
+    FlashJob_Init(); /* 重新上电：flash 已换成新的，清掉旧作业再挂载 */
+    KV_Init();
+    TPMS_Init();
+    host_set_uart_hook(sim_uart_hook);
+    s_seen_starts = g_host_stats.scan_starts;
+    s_seen_stops  = g_host_stats.scan_stops;
+
+    BLE_Scanner_Create(&s_scanner);
+    s_scanner.ops.scan_start();
+    sim_ctrl_sync();
+
+    uint32_t t0          = sim_now();
+    bool     replaced    = false;
+    bool     checked_win = false;
+    for (;;)
+    {
+        uint32_t next = 0u;
+        for (uint32_t i = 1; i < SIM_SOURCES; i++)
+        {
+            if (s_src[i].next_ms < s_src[next].next_ms)
+            {
+                next = i;
+            }
+        }
+        uint32_t rel = s_src[next].next_ms;
+        if (rel >= SIM_END_MS)
+        {
+            break;
+        }
+        if (replace && !replaced && rel >= SIM_REPLACE_AT_MS)
+        {
+            sim_advance_to(t0 + SIM_REPLACE_AT_MS);
+            TPMS_Replace_Start(0u, SIM_REPLACE_WIN_MS);
+            sim_ctrl_sync();
+            replaced = true;
+        }
+        if (replace && replaced && !checked_win && rel >= SIM_REPLACE_AT_MS + SIM_REPLACE_WIN_MS / 2u)
+        {
+            sim_advance_to(t0 + SIM_REPLACE_AT_MS + SIM_REPLACE_WIN_MS / 2u);
+            s_res.replace_open = s_scan_on && !sim_is_filtered() &&
+                                 s_scan.scan_mode == GAP_SCAN_MODE_GEN_DISC && s_scan.duration == 0u;
+            checked_win        = true;
+        }
+        sim_advance_to(t0 + rel);
+
+        sim_src_t* s = &s_src[next];
+        if (!s->tpms)
+        {
+            sim_adv_event(next, t0);
+            s->next_ms += s->interval + sim_rand() % 10u; /* advDelay 0~10 ms */
+            continue;
+        }
+        if (s->burst_left == 0u)
+        {
+            sim_tpms_wakeup(next, rel);
+        }
+        sim_adv_event(next, t0);
+        s->burst_left--;
+        /* 唤醒周期带 0~50 ms 抖动（传感器 RC 时钟） */
+        s->next_ms += (s->burst_left != 0u)
+                          ? SIM_PKT_GAP_MS
+                          : SIM_WAKE_MS - (SIM_BURST_PKTS - 1u) * SIM_PKT_GAP_MS + sim_rand() % 51u;
+    }
+    sim_advance_to(t0 + SIM_END_MS);
+    s_res.replace_back = sim_is_filtered();
+
+    host_set_uart_hook(NULL);
+    return s_res;
+}
+
+static void sim_print(const char* name, const sim_result_t* r)
+{
+    printf("  %-8s: %7.0f callbacks/min  %4u scan starts  own values %u, missed %u, max latency %5u ms\n",
+           name,
+           (double)r->cb_total / (double)SIM_MINUTES,
+           (unsigned)r->sessions,
+           (unsigned)r->values,
+           (unsigned)r->missed,
+           (unsigned)r->max_latency);
+}
+
+int main(void)
+{
+    printf("tpms_scan_filter_sim (%u min, %u background advertisers incl. %u foreign TPMS, "
+           "%u bound sensors):\n",
+           (unsigned)SIM_MINUTES, (unsigned)SIM_BACKGROUND, (unsigned)SIM_OTHER_CARS,
+           (unsigned)TPMS_SENSOR_MAX);
+
+    sim_result_t unbound = sim_run(false, false);
+    sim_print("unbound", &unbound);
+    sim_result_t bound = sim_run(true, false);
+    sim_print("bound", &bound);
+    sim_result_t replace = sim_run(true, true);
+    sim_print("replace", &replace);
+
+    printf("  replace per minute:");
+    for (uint32_t m = 0; m < SIM_MINUTES; m++)
+    {
+        printf(" %u", (unsigned)replace.cb_per_min[m]);
+    }
+    printf("  (learning window %u-%u s)\n", (unsigned)(SIM_REPLACE_AT_MS / 1000u),
+           (unsigned)((SIM_REPLACE_AT_MS + SIM_REPLACE_WIN_MS) / 1000u));
+    if (bound.cb_total > 0u)
+    {
+        printf("  bound vs unbound: %.1fx fewer app-layer callbacks\n",
+               (double)unbound.cb_total / (double)bound.cb_total);
+    }
+
+    int fail = 0;
+    if (bound.cb_total * 2u > unbound.cb_total)
+    {
+        fprintf(stderr, "tpms_scan_filter_sim: filtered scan did not halve callbacks\n");
+        fail = 1;
+    }
+    if (bound.missed != 0u || bound.max_latency > SIM_DUP_WINDOW_MS + SIM_WAKE_MS + 50u)
+    {
+        fprintf(stderr, "tpms_scan_filter_sim: bound sensor values lost or late\n");
+        fail = 1;
+    }
+    if (!replace.replace_open || !replace.replace_back)
+    {
+        fprintf(stderr, "tpms_scan_filter_sim: learning window did not switch scan mode\n");
+        fail = 1;
+    }
+    printf("tpms_scan_filter_sim: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
@@ -0,0 +1,437 @@
+/*********************************************************************
+ * @file uart_rx_bench.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief UART 接收路径微基准：逐字节回调 vs FIFO 块搬运 + 字节环 + 块解析
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 合成字节流（模拟 MCU 侧 TPMS 转发 + 车况上报）：
+ * - --frames 条合法帧，data 长度 0..40 随机，sync/feature/id 随机；
+ * - 每 50 帧插一行 AT 文本（TPMS SHOW），每 97 帧插一条 end 错误的坏帧，
+ *   每 131 帧插一段非 0xFE 开头的噪声 + 换行。
+ *
+ * 对比两种喂法（解析器代码相同，只差调用粒度）：
+ * - per-byte：每字节一次回调（等同旧的 uart0_read(&rx_byte, 1, cb)）；
+ * - block   ：中断模型每次搬 --chunk 字节（FIFO 触发水位）进字节环，
+ *             user_task 模型每 --drain-every 次中断排空一次。
+ * 另外再用 1..64 字节的随机切分喂一遍，检查跨调用状态保存；
+ * 最后让上层暂扣帧不归还，检查帧池耗尽被计数且不影响后续解析。
+ *
+ * 正确性：三种喂法交付的帧数/行数/坏帧数、帧内容哈希及描述符字段
+ * （crc_ok / data / data_len）必须与生成时一致，
+ * 否则返回 1（ctest 以此判定）；耗时只打印不判定。
+ *
+ * 用法：uart_rx_bench [--frames N] [--chunk N] [--drain-every N]
+ *********************************************************************/
+
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_timer.h"
+#include "uart_rx.h"
+
+#define BENCH_DEFAULT_FRAMES 20000u
+#define BENCH_DEFAULT_CHUNK  16u /* FCR_RX_TRIGGER_10：32 字节 FIFO 半满 */
+#define BENCH_DEFAULT_DRAIN  4u
+#define BENCH_RING_SIZE      512u /* 与 usart_device.c 的 UART_RX_RING_SIZE 一致 */
+#define BENCH_ROUNDS         5u
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t lines;
+    uint32_t bad;
+    uint64_t hash;
+} bench_result_t;
+
+static uint8_t*       s_stream     = NULL;
+static uint32_t       s_stream_len = 0u;
+static uint32_t       s_stream_cap = 0u;
+static bench_result_t s_expect;
+static bench_result_t s_got;
+
+static uint64_t bench_hash(uint64_t h, const uint8_t* p, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        h = (h ^ p[i]) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+static void bench_put(const uint8_t* p, uint32_t n)
+{
+    if (s_stream_len + n > s_stream_cap)
+    {
+        s_stream_cap = (s_stream_cap == 0u) ? 65536u : s_stream_cap * 2u;
+        while (s_stream_len + n > s_stream_cap)
+        {
+            s_stream_cap *= 2u;
+        }
+        s_stream = (uint8_t*)realloc(s_stream, s_stream_cap);
+        if (s_stream == NULL)
+        {
+            fprintf(stderr, "uart_rx_bench: out of memory\n");
+            exit(2);
+        }
+    }
+    memcpy(&s_stream[s_stream_len], p, n);
+    s_stream_len += n;
+}
+
+/* 组一帧；bad_end 时把 end 写错（解析器应整帧丢弃） */
+static void bench_put_frame(uint16_t data_len, int bad_end)
+{
+    uint8_t data[UART_RX_FRAME_MAX];
+    uint8_t f[UART_RX_FRAME_MAX];
+
+    for (uint16_t i = 0; i < data_len; i++)
+    {
+        data[i] = (uint8_t)rand(); /* 数据段里出现 0xFE / 0x0A 也不能打乱解析 */
+    }
+    uint16_t n = soc_mcu_encode((rand() & 1) ? SOC_MCU_SYNC_MCU_TO_SOC : SOC_MCU_SYNC_SOC_TO_MCU,
+                                (uint16_t)(0xFF01u + (uint16_t)(rand() % 4)),
+                                (uint16_t)rand(),
+                                data,
+                                data_len,
+                                f,
+                                (uint16_t)sizeof(f));
+    if (bad_end)
+    {
+        f[n - 1u] = 0x00u;
+    }
+
+    bench_put(f, n);
+    if (bad_end)
+    {
+        s_expect.bad++;
+    }
+    else
+    {
+        s_expect.frames++;
+        s_expect.hash = bench_hash(s_expect.hash, f, n);
+    }
+}
+
+static void bench_build_stream(uint32_t frames)
+{
+    static const char s_at[]    = "TPMS SHOW\r\n";
+    static const char s_noise[] = "\x55\xAA garbage \x7F\r\n";
+
+    srand(0x801u);
+    memset(&s_expect, 0, sizeof(s_expect));
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        bench_put_frame((uint16_t)(rand() % 41), 0);
+        if (i % 50u == 49u)
+        {
+            bench_put((const uint8_t*)s_at, sizeof(s_at) - 1u);
+            s_expect.lines++;
+        }
+        if (i % 97u == 96u)
+        {
+            bench_put_frame((uint16_t)(rand() % 41), 1);
+        }
+        if (i % 131u == 130u)
+        {
+            bench_put((const uint8_t*)s_noise, sizeof(s_noise) - 1u);
+            s_expect.lines++;
+        }
+    }
+}
+
+static uint32_t s_crc_bad = 0u;
+
+static bool bench_on_frame(const uart_rx_frame_t* f)
+{
+    s_got.hash = bench_hash(s_got.hash, f->frame, f->len);
+    if (!f->crc_ok || f->data != &f->frame[SOC_MCU_DATA_OFF] || SOC_MCU_FRAME_LEN(f->data_len) != f->len)
+    {
+        s_crc_bad++;
+    }
+    return false;
+}
+
+static void bench_on_line(char* line, uint16_t len)
+{
+    (void)line;
+    (void)len;
+}
+
+static void bench_begin(uart_rx_parser_t* p)
+{
+    memset(&s_got, 0, sizeof(s_got));
+    s_crc_bad = 0u;
+    uart_rx_parser_init(p, bench_on_frame, bench_on_line);
+}
+
+static void bench_end(const uart_rx_parser_t* p)
+{
+    s_got.frames = p->frames;
+    s_got.lines  = p->lines;
+    s_got.bad    = p->bad_frames;
+}
+
+/* 旧路径模型：每字节一次（不可内联的）回调 */
+typedef void (*bench_byte_cb_t)(uart_rx_parser_t* p, uint8_t b);
+
+static void __attribute__((noinline)) bench_byte_cb(uart_rx_parser_t* p, uint8_t b)
+{
+    uart_rx_parse(p, &b, 1u);
+}
+
+static void bench_feed_per_byte(uart_rx_parser_t* p)
+{
+    volatile bench_byte_cb_t cb = bench_byte_cb;
+    for (uint32_t i = 0; i < s_stream_len; i++)
+    {
+        cb(p, s_stream[i]);
+    }
+}
+
+/* 新路径模型：中断每次搬 chunk 字节进环，每 drain_every 次中断排空一次 */
+static uint32_t s_chunk         = BENCH_DEFAULT_CHUNK;
+static uint32_t s_drain_every   = BENCH_DEFAULT_DRAIN;
+static uint32_t s_isr_count     = 0u;
+static uint32_t s_drain_count   = 0u;
+static uint32_t s_ring_overflow = 0u;
+
+static void bench_feed_block(uart_rx_parser_t* p)
+{
+    static uint8_t s_ring_buf[BENCH_RING_SIZE];
+    uart_rx_ring_t ring;
+    uint32_t       pos = 0u;
+
+    uart_rx_ring_init(&ring, s_ring_buf, (uint16_t)sizeof(s_ring_buf));
+    s_isr_count   = 0u;
+    s_drain_count = 0u;
+    while (pos < s_stream_len)
+    {
+        /* ISR：FIFO 里的 chunk 字节按连续区间写入（可能跨环尾分两段） */
+        uint32_t fifo = s_stream_len - pos;
+        if (fifo > s_chunk)
+        {
+            fifo = s_chunk;
+        }
+        while (fifo > 0u)
+        {
+            uint16_t room;
+            uint8_t* dst = uart_rx_ring_write_span(&ring, &room);
+            if (room == 0u)
+            {
+                ring.overflow += fifo;
+                pos += fifo;
+                break;
+            }
+            uint16_t n = (fifo < room) ? (uint16_t)fifo : room;
+            memcpy(dst, &s_stream[pos], n);
+            uart_rx_ring_produce(&ring, n);
+            pos += n;
+            fifo -= n;
+        }
+        s_isr_count++;
+
+        /* user_task：收到 USER_EVT_UART_RX 后按块排空 */
+        if (s_isr_count % s_drain_every == 0u || pos >= s_stream_len)
+        {
+            uart_rx_drain(&ring, p);
+            s_drain_count++;
+        }
+    }
+    uart_rx_drain(&ring, p);
+    s_ring_overflow = ring.overflow;
+}
+
+/* 随机切分：检查任意块边界下状态都能正确跨调用保存 */
+static void bench_feed_random(uart_rx_parser_t* p)
+{
+    uint32_t pos = 0u;
+    srand(0x1234u);
+    while (pos < s_stream_len)
+    {
+        uint32_t n = 1u + (uint32_t)(rand() % 64);
+        if (n > s_stream_len - pos)
+        {
+            n = s_stream_len - pos;
+        }
+        uart_rx_parse(p, &s_stream[pos], (uint16_t)n);
+        pos += n;
+    }
+}
+
+/*
+ * 帧池耗尽：上层暂扣所有帧不归还，超出 UART_RX_FRAME_POOL 的帧必须
+ * 计入 pool_exhausted（且仍按长度吞掉，后续文本行不受影响）；归还后恢复交付。
+ */
+static const uart_rx_frame_t* s_held[UART_RX_FRAME_POOL];
+static uint32_t               s_held_cnt = 0u;
+
+static bool bench_on_frame_hold(const uart_rx_frame_t* f)
+{
+    if (s_held_cnt < UART_RX_FRAME_POOL)
+    {
+        s_held[s_held_cnt++] = f;
+    }
+    return true;
+}
+
+static int bench_pool_exhaustion(void)
+{
+    static uart_rx_parser_t s_parser;
+    static const char       s_at[] = "TPMS SHOW\r\n";
+    static const uint8_t    s_wheel[1] = {0x02u};
+    uint8_t                 f[UART_RX_FRAME_MAX];
+    uint32_t                extra = 3u;
+    uint16_t                n     = soc_mcu_encode(SOC_MCU_SYNC_MCU_TO_SOC, SOC_MCU_FEATURE_FF02,
+                                                   0x0117u, s_wheel, 1u, f, (uint16_t)sizeof(f));
+
+    s_held_cnt = 0u;
+    uart_rx_parser_init(&s_parser, bench_on_frame_hold, bench_on_line);
+    for (uint32_t i = 0; i < UART_RX_FRAME_POOL + extra; i++)
+    {
+        uart_rx_parse(&s_parser, f, n);
+    }
+    uart_rx_parse(&s_parser, (const uint8_t*)s_at, (uint16_t)(sizeof(s_at) - 1u));
+    int fail = (s_parser.frames != UART_RX_FRAME_POOL ||
+                s_parser.pool_exhausted != extra || s_parser.lines != 1u ||
+                s_held_cnt != UART_RX_FRAME_POOL || !s_held[0]->crc_ok ||
+                s_held[0]->id != 0x0117u || s_held[0]->data_len != 1u);
+
+    for (uint32_t i = 0; i < s_held_cnt; i++)
+    {
+        uart_rx_frame_release(s_held[i]);
+    }
+    s_held_cnt = 0u;
+    uart_rx_parse(&s_parser, f, n);
+    fail |= (s_parser.frames != UART_RX_FRAME_POOL + 1u);
+    if (fail)
+    {
+        fprintf(stderr, "uart_rx_bench: pool exhaustion frames=%u exhausted=%u lines=%u\n",
+                (unsigned)s_parser.frames,
+                (unsigned)s_parser.pool_exhausted,
+                (unsigned)s_parser.lines);
+    }
+    return fail;
+}
+
+typedef void (*bench_feed_fn)(uart_rx_parser_t* p);
+
+static int bench_cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int bench_check(const char* name)
+{
+    if (s_got.frames != s_expect.frames || s_got.lines != s_expect.lines ||
+        s_got.bad != s_expect.bad || s_got.hash != s_expect.hash || s_crc_bad != 0u)
+    {
+        fprintf(stderr,
+                "uart_rx_bench: %s mismatch frames=%u/%u lines=%u/%u bad=%u/%u "
+                "desc_bad=%u hash %s\n",
+                name,
+                (unsigned)s_got.frames, (unsigned)s_expect.frames,
+                (unsigned)s_got.lines, (unsigned)s_expect.lines,
+                (unsigned)s_got.bad, (unsigned)s_expect.bad,
+                (unsigned)s_crc_bad,
+                (s_got.hash == s_expect.hash) ? "ok" : "differs");
+        return 1;
+    }
+    return 0;
+}
+
+/* 返回整条字节流耗时的中位数（BENCH_ROUNDS 轮） */
+static uint64_t bench_run(bench_feed_fn fn, const char* name, int* fail)
+{
+    static uart_rx_parser_t s_parser;
+    uint64_t                samples[BENCH_ROUNDS];
+
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+    {
+        bench_begin(&s_parser);
+        uint64_t t0 = bench_now();
+        fn(&s_parser);
+        samples[r] = bench_now() - t0;
+        bench_end(&s_parser);
+        *fail |= bench_check(name);
+    }
+    qsort(samples, BENCH_ROUNDS, sizeof(uint64_t), bench_cmp_u64);
+    return samples[BENCH_ROUNDS / 2u];
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frames = BENCH_DEFAULT_FRAMES;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+        {
+            s_chunk = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--drain-every") == 0 && i + 1 < argc)
+        {
+            s_drain_every = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames N] [--chunk N] [--drain-every N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames == 0u || s_chunk == 0u || s_drain_every == 0u)
+    {
+        fprintf(stderr, "uart_rx_bench: arguments must be > 0\n");
+        return 2;
+    }
+
+    bench_build_stream(frames);
+
+    int      fail    = 0;
+    uint64_t t_byte  = bench_run(bench_feed_per_byte, "per-byte", &fail);
+    uint64_t t_block = bench_run(bench_feed_block, "block", &fail);
+    (void)bench_run(bench_feed_random, "random-split", &fail);
+    fail |= bench_pool_exhaustion();
+
+    /* 块模式下环不应溢出：每 drain_every*chunk 字节排空一次，远小于环大小 */
+    if (s_ring_overflow != 0u)
+    {
+        fprintf(stderr, "uart_rx_bench: ring overflow %u bytes\n", (unsigned)s_ring_overflow);
+        fail = 1;
+    }
+
+    double bytes = (double)s_stream_len;
+    printf("uart_rx stream: %u bytes, %u frames, %u lines, %u bad frames\n",
+           (unsigned)s_stream_len,
+           (unsigned)s_expect.frames,
+           (unsigned)s_expect.lines,
+           (unsigned)s_expect.bad);
+    printf("  per-byte callback : %7.2f %s/byte  (%u callbacks)\n",
+           (double)t_byte / bytes,
+           BENCH_UNIT,
+           (unsigned)s_stream_len);
+    printf("  block %2u B + ring : %7.2f %s/byte  (%u isr, %u drains)\n",
+           (unsigned)s_chunk,
+           (double)t_block / bytes,
+           BENCH_UNIT,
+           (unsigned)s_isr_count,
+           (unsigned)s_drain_count);
+    if (t_block != 0u)
+    {
+        printf("  speedup: %.2fx, interrupts: %.1fx fewer\n",
+               (double)t_byte / (double)t_block,
+               bytes / (double)s_isr_count);
+    }
+    printf("%s\n", fail ? "FAIL" : "OK");
+    free(s_stream);
+    return fail;
+}
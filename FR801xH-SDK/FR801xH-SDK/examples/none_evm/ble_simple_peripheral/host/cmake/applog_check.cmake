@@ -0,0 +1,30 @@
+# ---------------------------------------------------------------------
+# app_log 回环校验（ctest 调用：cmake -P）
+#   1) applog_roundtrip 写出二进制记录 + 期望文本
+#   2) applog_decode.py 用同一个可执行文件做 ELF 还原
+#   3) 逐字节比较
+# 变量：DEMO / PYTHON / DECODER / WORK_DIR
+# ---------------------------------------------------------------------
+set(BIN    ${WORK_DIR}/applog_roundtrip.bin)
+set(EXPECT ${WORK_DIR}/applog_roundtrip.expect.txt)
+set(GOT    ${WORK_DIR}/applog_roundtrip.got.txt)
+
+execute_process(COMMAND ${DEMO} ${BIN} ${EXPECT} RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "applog_roundtrip failed: ${rc}")
+endif()
+
+execute_process(COMMAND ${PYTHON} ${DECODER} --elf ${DEMO} --raw ${BIN}
+                OUTPUT_FILE ${GOT} RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "applog_decode.py failed: ${rc}")
+endif()
+
+file(READ ${EXPECT} expect_txt)
+file(READ ${GOT} got_txt)
+if(NOT expect_txt STREQUAL got_txt)
+    message(FATAL_ERROR "decoded log differs from expected\n"
+                        "--- expected (${EXPECT})\n${expect_txt}\n"
+                        "--- got (${GOT})\n${got_txt}")
+endif()
+message(STATUS "app_log roundtrip OK")
@@ -0,0 +1,23 @@
+/*********************************************************************
+ * @file driver_flash.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 主机构建用：替代 SDK driver_flash.h（原声明带 ram_code 段属性）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why 只保留固件里实际用到的接口；flash 由 host_stubs.c 用一块 RAM 模拟 NOR 行为。
+ *********************************************************************/
+
+#ifndef _DRIVER_FLASH_H
+#define _DRIVER_FLASH_H
+
+#include <stdint.h>
+
+void flash_write(uint32_t offset, uint32_t length, uint8_t* buffer);
+void flash_read(uint32_t offset, uint32_t length, uint8_t* buffer);
+void flash_erase(uint32_t offset, uint32_t size);
+uint8_t flash_page_erase(uint32_t offset);
+void flash_protect_enable(uint8_t wr_mode);
+void flash_protect_disable(uint8_t wr_mode);
+
+#endif // _DRIVER_FLASH_H
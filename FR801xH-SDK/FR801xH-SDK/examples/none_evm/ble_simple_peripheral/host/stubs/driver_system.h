@@ -0,0 +1,34 @@
+/*********************************************************************
+ * @file driver_system.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 主机构建用：替代 SDK driver_system.h（原文件依赖 driver_iomux.h / 寄存器定义）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why 只保留固件里实际用到的接口；毫秒时钟由 host_stubs.c 的虚拟时钟提供。
+ *      system_regs 只留 OTA（ota.c）切换 remap 用到的字段。
+ *********************************************************************/
+
+#ifndef _DRIVER_SYSTEM_H
+#define _DRIVER_SYSTEM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* 上电后的毫秒数，到 0x4FFFFFF 后回绕到 0（与 SDK 一致） */
+uint32_t system_get_curr_time(void);
+
+struct system_regs_t
+{
+    uint32_t remap_virtual_addr;
+    uint32_t remap_length; /* 非 0 = 正在运行镜像 B */
+    uint32_t remap_physical_addr;
+};
+
+extern volatile struct system_regs_t* const system_regs;
+
+void system_latency_enable(uint8_t conidx);
+void system_latency_disable(uint8_t conidx);
+void platform_reset_patch(uint32_t error);
+
+#endif // _DRIVER_SYSTEM_H
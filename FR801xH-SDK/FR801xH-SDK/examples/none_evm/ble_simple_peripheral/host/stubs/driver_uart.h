@@ -0,0 +1,25 @@
+/*********************************************************************
+ * @file driver_uart.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 主机构建用：替代 SDK driver_uart.h（原文件依赖 core_cm3.h）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why 只保留固件里实际用到的接口，地址常量与 SDK 保持一致。
+ *********************************************************************/
+
+#ifndef _DRIVER_UART_H_
+#define _DRIVER_UART_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UART0_BASE 0x50050000
+#define UART1_BASE 0x50058000
+#define UART0      UART0_BASE
+#define UART1      UART1_BASE
+
+void uart_putc_noint(uint32_t uart_addr, uint8_t c);
+void uart_putc_noint_no_wait(uint32_t uart_addr, uint8_t c);
+
+#endif // _DRIVER_UART_H_
@@ -0,0 +1,841 @@
+/*********************************************************************
+ * @file host_stubs.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 主机(Linux)构建用的 SDK 打桩实现
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "host_stubs.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "co_printf.h"
+#include "driver_flash.h"
+#include "driver_system.h"
+#include "driver_uart.h"
+#include "gap_api.h"
+#include "gatt_api.h"
+#include "jump_table.h"
+#include "ll.h"
+#include "os_task.h"
+#include "os_timer.h"
+#include "simple_gatt_service.h"
+#include "usart_device.h"
+
+host_stats_t g_host_stats;
+
+static host_ntf_hook_t  s_ntf_hook  = NULL;
+static host_uart_hook_t s_uart_hook = NULL;
+static uint32_t         s_uart_skip = 0u;
+static uint32_t         s_uart_fail = 0u;
+static bool             s_verbose   = false;
+static bool             s_log_fmt   = true;
+static uint32_t         s_conn_mask = 0u;
+static void (*s_idle_cb)(void)      = NULL;
+
+static gap_scan_param_t s_last_scan;
+static bool             s_scan_seen = false;
+
+/* ==================== memcpy/memmove 计数 ==================== */
+/*
+ * @why
+ * - “每帧搬运多少字节”是协议栈优化的核心指标，但又不想在业务代码里埋点。
+ * - 固件源码以 -fno-builtin-memcpy/-memmove 编译，链接时 --wrap 到这里，
+ *   即可在不改业务代码的前提下统计真实的拷贝量。
+ */
+void* __real_memcpy(void* dst, const void* src, size_t n);
+void* __real_memmove(void* dst, const void* src, size_t n);
+
+void* __wrap_memcpy(void* dst, const void* src, size_t n)
+{
+    g_host_stats.memcpy_calls++;
+    g_host_stats.memcpy_bytes += n;
+    return __real_memcpy(dst, src, n);
+}
+
+void* __wrap_memmove(void* dst, const void* src, size_t n)
+{
+    g_host_stats.memcpy_calls++;
+    g_host_stats.memcpy_bytes += n;
+    return __real_memmove(dst, src, n);
+}
+
+/* ==================== 控制接口 ==================== */
+void host_stubs_reset(void)
+{
+    memset(&g_host_stats, 0, sizeof(g_host_stats));
+    s_ntf_hook  = NULL;
+    s_uart_hook = NULL;
+    s_uart_skip = 0u;
+    s_uart_fail = 0u;
+    s_conn_mask = 0u;
+
+    const char* env = getenv("HOST_VERBOSE");
+    s_verbose       = (env != NULL && env[0] == '1');
+}
+
+void host_set_ntf_hook(host_ntf_hook_t hook)
+{
+    s_ntf_hook = hook;
+}
+
+void host_set_uart_hook(host_uart_hook_t hook)
+{
+    s_uart_hook = hook;
+}
+
+void host_set_uart_fail(uint32_t skip, uint32_t count)
+{
+    s_uart_skip = skip;
+    s_uart_fail = count;
+}
+
+void host_set_verbose(bool on)
+{
+    s_verbose = on;
+}
+
+void host_set_log_format(bool on)
+{
+    s_log_fmt = on;
+}
+
+void host_gap_set_connected(uint8_t conidx, bool connected)
+{
+    if (conidx >= 32u)
+    {
+        return;
+    }
+    if (connected)
+    {
+        s_conn_mask |= (1u << conidx);
+    }
+    else
+    {
+        s_conn_mask &= ~(1u << conidx);
+    }
+}
+
+/* ==================== co_printf ==================== */
+int co_printf(const char* format, ...)
+{
+    /* 板上 co_printf 会真实格式化，这里同样格式化，只是默认不输出 */
+    if (!s_log_fmt)
+    {
+        g_host_stats.log_calls++;
+        return 0;
+    }
+
+    char    buf[512];
+    va_list ap;
+    va_start(ap, format);
+    int n = vsnprintf(buf, sizeof(buf), format, ap);
+    va_end(ap);
+
+    g_host_stats.log_calls++;
+    if (n > 0)
+    {
+        g_host_stats.log_bytes += (uint64_t)n;
+        if (s_verbose)
+        {
+            fputs(buf, stdout);
+        }
+    }
+    return n;
+}
+
+int co_sprintf(char* out, const char* format, ...)
+{
+    va_list ap;
+    va_start(ap, format);
+    int n = vsprintf(out, format, ap);
+    va_end(ap);
+    return n;
+}
+
+/* ==================== gap ==================== */
+bool gap_get_connect_status(uint8_t conidx)
+{
+    if (conidx >= 32u)
+    {
+        return false;
+    }
+    return (s_conn_mask & (1u << conidx)) != 0u;
+}
+
+uint8_t gap_get_connect_num(void)
+{
+    uint8_t  n    = 0;
+    uint32_t mask = s_conn_mask;
+    while (mask != 0u)
+    {
+        n += (uint8_t)(mask & 1u);
+        mask >>= 1;
+    }
+    return n;
+}
+
+void gap_disconnect_req(uint8_t conidx)
+{
+    g_host_stats.disconnects++;
+    host_gap_set_connected(conidx, false);
+}
+
+void gap_bond_manager_delete_all(void)
+{
+}
+
+void gap_get_link_rssi(uint8_t conidx)
+{
+    (void)conidx;
+}
+
+void gap_start_scan(gap_scan_param_t* p_scan_param)
+{
+    g_host_stats.scan_starts++;
+    if (p_scan_param != NULL)
+    {
+        s_last_scan = *p_scan_param;
+        s_scan_seen = true;
+    }
+}
+
+void gap_stop_scan(void)
+{
+    g_host_stats.scan_stops++;
+}
+
+const void* host_gap_last_scan(void)
+{
+    return s_scan_seen ? &s_last_scan : NULL;
+}
+
+/* ==================== simple_gatt_service ==================== */
+void ntf_data(uint8_t con_idx, uint8_t att_idx, uint8_t* data, uint16_t len)
+{
+    g_host_stats.ntf_frames++;
+    g_host_stats.ntf_bytes += len;
+    if (s_ntf_hook != NULL)
+    {
+        s_ntf_hook(con_idx, att_idx, data, len);
+    }
+}
+
+bool sp_is_char1_ntf_enabled(uint8_t con_idx)
+{
+    return gap_get_connect_status(con_idx);
+}
+
+bool sp_is_char2_ntf_enabled(uint8_t con_idx)
+{
+    return gap_get_connect_status(con_idx);
+}
+
+/* ==================== usart_device ==================== */
+uint8_t SocMcu_Frame_Send(uint16_t       sync,
+                          uint16_t       feature,
+                          uint16_t       id,
+                          const uint8_t* data,
+                          uint16_t       data_len)
+{
+    if (s_uart_fail != 0u)
+    {
+        if (s_uart_skip == 0u)
+        {
+            s_uart_fail--;
+            return 0;
+        }
+        s_uart_skip--;
+    }
+    g_host_stats.uart_frames++;
+    g_host_stats.uart_bytes += data_len;
+    if (s_uart_hook != NULL)
+    {
+        s_uart_hook(sync, feature, id, data, data_len);
+    }
+    return 1;
+}
+
+/* ==================== flash（RAM 模拟 NOR） ==================== */
+/*
+ * @why
+ * - 绑定表/参数存储的正确性取决于“擦除是扇区级、写入只能清位”这两条 NOR 规则，
+ *   直接用 memcpy 模拟会掩盖没擦就写的 bug，所以写入按位与。
+ * - 越界访问直接 abort：板上越界会写坏别的分区，主机上要第一时间暴露。
+ * - 掉电注入按“字节/扇区”计数，仿真程序可以把掉电点从 0 扫到整个操作序列结束，
+ *   逐点检查 kv_store 重新挂载后的内容。
+ */
+static uint8_t  s_flash[HOST_FLASH_SIZE];
+static uint32_t s_flash_erase_cnt[HOST_FLASH_SIZE / HOST_FLASH_SECTOR_SIZE];
+static bool     s_flash_init = false;
+static bool     s_cut_armed  = false;
+static bool     s_cut_fired  = false;
+static uint32_t s_cut_budget = 0u;
+
+/* 耗时模型与中断停顿记账 */
+/* 默认值取常见 SPI NOR 手册的典型值量级：扇区擦除 45ms、页擦除 10ms、整页编程 0.7ms */
+#define HOST_FLASH_TIMING_DEFAULT {45000u, 10000u, 700u, 40u}
+
+static host_flash_timing_t  s_timing     = HOST_FLASH_TIMING_DEFAULT;
+static uint64_t             s_busy_us    = 0u;
+static uint64_t             s_span_start = 0u;
+static uint32_t             s_int_depth  = 0u;
+static uint32_t             s_blackout_max = 0u;
+static host_blackout_hook_t s_blackout_hook = NULL;
+
+static void host_flash_check(uint32_t offset, uint32_t length)
+{
+    if (offset > HOST_FLASH_SIZE || length > HOST_FLASH_SIZE - offset)
+    {
+        fprintf(stderr, "host_stubs: flash access out of range 0x%x+%u\n",
+                (unsigned)offset, (unsigned)length);
+        abort();
+    }
+    if (!s_flash_init)
+    {
+        host_flash_reset();
+    }
+}
+
+void host_flash_reset(void)
+{
+    memset(s_flash, 0xFF, sizeof(s_flash));
+    memset(s_flash_erase_cnt, 0, sizeof(s_flash_erase_cnt));
+    s_flash_init = true;
+}
+
+uint8_t* host_flash_mem(void)
+{
+    host_flash_check(0u, 0u);
+    return s_flash;
+}
+
+void host_flash_cut_arm(uint32_t units)
+{
+    s_cut_armed  = true;
+    s_cut_fired  = false;
+    s_cut_budget = units;
+}
+
+void host_flash_cut_disarm(void)
+{
+    s_cut_armed = false;
+    s_cut_fired = false;
+}
+
+bool host_flash_cut_fired(void)
+{
+    return s_cut_fired;
+}
+
+uint32_t host_flash_sector_erases(uint32_t addr)
+{
+    host_flash_check(addr, 0u);
+    return (addr < HOST_FLASH_SIZE) ? s_flash_erase_cnt[addr / HOST_FLASH_SECTOR_SIZE] : 0u;
+}
+
+void host_flash_set_timing(const host_flash_timing_t* t)
+{
+    host_flash_timing_t def = HOST_FLASH_TIMING_DEFAULT;
+    s_timing                = (t != NULL) ? *t : def;
+}
+
+void host_flash_get_timing(host_flash_timing_t* out)
+{
+    *out = s_timing;
+}
+
+uint64_t host_flash_busy_us(void)
+{
+    return s_busy_us;
+}
+
+void host_set_blackout_hook(host_blackout_hook_t hook)
+{
+    s_blackout_hook = hook;
+}
+
+uint32_t host_blackout_max_us(void)
+{
+    return s_blackout_max;
+}
+
+void host_blackout_reset(void)
+{
+    s_blackout_max = 0u;
+}
+
+static void host_blackout_note(uint64_t us)
+{
+    if (us == 0u)
+    {
+        return;
+    }
+    if (us > s_blackout_max)
+    {
+        s_blackout_max = (uint32_t)us;
+    }
+    if (s_blackout_hook != NULL)
+    {
+        s_blackout_hook((uint32_t)us);
+    }
+}
+
+static void host_flash_busy(uint32_t us)
+{
+    s_busy_us += us;
+    if (s_int_depth == 0u)
+    {
+        host_blackout_note(us); /* 开中断时的单次擦写自成一段 */
+    }
+}
+
+CPU_SR host_int_disable(void)
+{
+    if (s_int_depth == 0u)
+    {
+        s_span_start = s_busy_us;
+    }
+    return (CPU_SR)s_int_depth++;
+}
+
+void host_int_restore(CPU_SR sr)
+{
+    s_int_depth = sr;
+    if (s_int_depth == 0u)
+    {
+        host_blackout_note(s_busy_us - s_span_start);
+    }
+}
+
+/* 掉电注入记账：每写一个字节/擦一个扇区取一单位 */
+typedef enum
+{
+    HOST_CUT_OK = 0, /* 正常完成 */
+    HOST_CUT_TEAR,   /* 正好在这一单位掉电：只做一半 */
+    HOST_CUT_DEAD,   /* 已掉电：丢弃 */
+} host_cut_t;
+
+static host_cut_t host_flash_cut_take(void)
+{
+    if (!s_cut_armed)
+    {
+        return HOST_CUT_OK;
+    }
+    if (s_cut_fired)
+    {
+        return HOST_CUT_DEAD;
+    }
+    if (s_cut_budget == 0u)
+    {
+        s_cut_fired = true;
+        return HOST_CUT_TEAR;
+    }
+    s_cut_budget--;
+    return HOST_CUT_OK;
+}
+
+void flash_read(uint32_t offset, uint32_t length, uint8_t* buffer)
+{
+    host_flash_check(offset, length);
+    g_host_stats.flash_reads++;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        buffer[i] = s_flash[offset + i];
+    }
+}
+
+void flash_write(uint32_t offset, uint32_t length, uint8_t* buffer)
+{
+    host_flash_check(offset, length);
+    g_host_stats.flash_writes++;
+    g_host_stats.flash_bytes += length;
+
+    /* 按 256B 页拆段计时：跨页的一次写入是多条页编程命令 */
+    uint32_t busy = 0u;
+    for (uint32_t a = offset; a < offset + length;)
+    {
+        uint32_t seg = 0x100u - (a & 0xFFu);
+        if (seg > offset + length - a)
+        {
+            seg = offset + length - a;
+        }
+        busy += s_timing.prog_setup_us +
+                (s_timing.page_prog_us - s_timing.prog_setup_us) * seg / 0x100u;
+        a += seg;
+    }
+    host_flash_busy(busy);
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        host_cut_t cut = host_flash_cut_take();
+        if (cut != HOST_CUT_OK)
+        {
+            if (cut == HOST_CUT_TEAR)
+            {
+                s_flash[offset + i] &= (uint8_t)(buffer[i] | 0x0Fu); /* 撕裂字节 */
+            }
+            return;
+        }
+        s_flash[offset + i] &= buffer[i];
+    }
+}
+
+void flash_erase(uint32_t offset, uint32_t size)
+{
+    /* 与 SDK 一致：按 4 KB 扇区擦，起始地址向下对齐 */
+    uint32_t start = offset & ~(HOST_FLASH_SECTOR_SIZE - 1u);
+    uint32_t end   = offset + size;
+
+    host_flash_check(start, end - start);
+    for (uint32_t a = start; a < end; a += HOST_FLASH_SECTOR_SIZE)
+    {
+        uint32_t n = HOST_FLASH_SIZE - a;
+        if (n > HOST_FLASH_SECTOR_SIZE)
+        {
+            n = HOST_FLASH_SECTOR_SIZE;
+        }
+        host_flash_busy(s_timing.sector_erase_us);
+        host_cut_t cut = host_flash_cut_take();
+        if (cut != HOST_CUT_OK)
+        {
+            if (cut == HOST_CUT_TEAR)
+            {
+                memset(&s_flash[a], 0xFF, n / 2u); /* 擦到一半掉电 */
+            }
+            return;
+        }
+        memset(&s_flash[a], 0xFF, n);
+        s_flash_erase_cnt[a / HOST_FLASH_SECTOR_SIZE]++;
+        g_host_stats.flash_erases++;
+    }
+}
+
+uint8_t flash_page_erase(uint32_t offset)
+{
+    uint32_t start = offset & ~0xFFu;
+
+    host_flash_check(start, 0x100u);
+    host_flash_busy(s_timing.page_erase_us);
+    /* 掉电注入按擦除计一单位；磨损仍记在所在扇区上（页擦除不计入 flash_erases） */
+    host_cut_t cut = host_flash_cut_take();
+    if (cut != HOST_CUT_OK)
+    {
+        if (cut == HOST_CUT_TEAR)
+        {
+            memset(&s_flash[start], 0xFF, 0x80u);
+        }
+        return 0;
+    }
+    memset(&s_flash[start], 0xFF, 0x100u);
+    s_flash_erase_cnt[start / HOST_FLASH_SECTOR_SIZE]++;
+    return 0;
+}
+
+void flash_protect_enable(uint8_t wr_mode)
+{
+    (void)wr_mode;
+}
+
+void flash_protect_disable(uint8_t wr_mode)
+{
+    (void)wr_mode;
+}
+
+/* ==================== OTA 平台桩 ==================== */
+/*
+ * @why ota.c（SDK 的 OTA profile）直接从 components 编译，只把它碰到的
+ *      寄存器/boot/GATT 接口换成这里的桩，收包、擦写、CRC 校验走原代码。
+ */
+struct jump_table_t                   __jump_table;
+static struct system_regs_t           s_system_regs;
+volatile struct system_regs_t* const  system_regs = &s_system_regs;
+static host_ota_rsp_hook_t            s_ota_rsp_hook = NULL;
+static uint16_t                       s_mtu          = 23u;
+static uint32_t                       s_resets       = 0u;
+
+void host_set_ota_rsp_hook(host_ota_rsp_hook_t hook)
+{
+    s_ota_rsp_hook = hook;
+}
+
+void host_set_mtu(uint16_t mtu)
+{
+    s_mtu = mtu;
+}
+
+void host_set_running_bank_b(bool bank_b)
+{
+    struct jump_table_t jt;
+    flash_read(0u, sizeof(jt), (uint8_t*)&jt);
+    s_system_regs.remap_virtual_addr = bank_b ? 0x01000000u : 0u;
+    s_system_regs.remap_length       = bank_b ? jt.image_size : 0u;
+}
+
+uint32_t host_reset_count(void)
+{
+    return s_resets;
+}
+
+void* ke_malloc(uint32_t size, uint8_t type)
+{
+    (void)type;
+    return malloc(size);
+}
+
+void ke_free(void* mem_ptr)
+{
+    free(mem_ptr);
+}
+
+void ota_gatt_report_notify(uint8_t conidx, uint8_t* p_data, uint16_t len)
+{
+    g_host_stats.ntf_frames++;
+    g_host_stats.ntf_bytes += len;
+    if (s_ota_rsp_hook != NULL)
+    {
+        s_ota_rsp_hook(conidx, p_data, len);
+    }
+}
+
+uint16_t gatt_get_mtu(uint8_t conidx)
+{
+    (void)conidx;
+    return s_mtu;
+}
+
+void gatt_mtu_exchange_req(uint8_t conidx)
+{
+    (void)conidx;
+}
+
+void system_latency_enable(uint8_t conidx)
+{
+    (void)conidx;
+}
+
+void system_latency_disable(uint8_t conidx)
+{
+    (void)conidx;
+}
+
+void platform_reset_patch(uint32_t error)
+{
+    (void)error;
+    s_resets++;
+}
+
+void wdt_feed(void)
+{
+}
+
+void uart_finish_transfers(uint32_t uart_addr)
+{
+    (void)uart_addr;
+}
+
+void enable_cache(uint8_t invalid_ram)
+{
+    (void)invalid_ram;
+}
+
+void disable_cache(void)
+{
+}
+
+uint8_t app_boot_get_storage_type(void)
+{
+    return 1u;
+}
+
+void app_boot_load_data(uint8_t* dest, uint32_t src, uint32_t len)
+{
+    flash_read(src, len, dest);
+}
+
+void app_boot_save_data(uint32_t dest, uint8_t* src, uint32_t len)
+{
+    flash_write(dest, len, src);
+}
+
+/* ==================== UART1 日志口 / 空闲循环 ==================== */
+void uart_putc_noint(uint32_t uart_addr, uint8_t c)
+{
+    (void)uart_addr;
+    (void)c;
+    g_host_stats.log_bytes++;
+}
+
+void uart_putc_noint_no_wait(uint32_t uart_addr, uint8_t c)
+{
+    uart_putc_noint(uart_addr, c);
+}
+
+void os_user_loop_event_set(void (*callback)(void))
+{
+    s_idle_cb = callback;
+}
+
+void os_user_loop_event_clear(void)
+{
+    s_idle_cb = NULL;
+}
+
+void host_run_idle(void)
+{
+    /* 与板上 while(1) 一致：回调自己决定何时 clear；这里加上限防止死循环 */
+    for (uint32_t i = 0; i < 100000u && s_idle_cb != NULL; i++)
+    {
+        s_idle_cb();
+    }
+}
+
+/* ==================== os_timer（虚拟时钟） ==================== */
+/*
+ * @why
+ * - 板上 os_timer 由系统节拍驱动；主机上改为“显式推进的虚拟时间”，
+ *   这样超时/重传/周期任务的仿真结果可复现，不受主机调度抖动影响。
+ */
+#define HOST_TIMER_MAX 64
+
+typedef struct
+{
+    os_timer_t* t;
+    uint32_t    expire_ms;
+    bool        active;
+} host_timer_slot_t;
+
+static host_timer_slot_t s_timers[HOST_TIMER_MAX];
+static uint32_t          s_now_ms = 0u;
+
+static host_timer_slot_t* host_timer_find(os_timer_t* t, bool create)
+{
+    host_timer_slot_t* free_slot = NULL;
+    for (uint32_t i = 0; i < HOST_TIMER_MAX; i++)
+    {
+        if (s_timers[i].t == t)
+        {
+            return &s_timers[i];
+        }
+        if (s_timers[i].t == NULL && free_slot == NULL)
+        {
+            free_slot = &s_timers[i];
+        }
+    }
+    if (create && free_slot != NULL)
+    {
+        free_slot->t      = t;
+        free_slot->active = false;
+    }
+    return create ? free_slot : NULL;
+}
+
+void os_timer_init(os_timer_t* ptimer, os_timer_func_t pfunction, void* parg)
+{
+    if (ptimer == NULL)
+    {
+        return;
+    }
+    ptimer->timer_next   = NULL;
+    ptimer->timer_period = 0u;
+    ptimer->timer_func   = pfunction;
+    ptimer->timer_arg    = parg;
+    ptimer->timer_id     = TIM_ID_NOT_USE;
+
+    host_timer_slot_t* slot = host_timer_find(ptimer, true);
+    if (slot == NULL)
+    {
+        fprintf(stderr, "host_stubs: os_timer slots exhausted\n");
+        abort();
+    }
+    slot->active = false;
+}
+
+void os_timer_destroy(os_timer_t* ptimer)
+{
+    host_timer_slot_t* slot = host_timer_find(ptimer, false);
+    if (slot != NULL)
+    {
+        slot->t      = NULL;
+        slot->active = false;
+    }
+}
+
+void os_timer_start(os_timer_t* ptimer, uint32_t ms, bool repeat_flag)
+{
+    host_timer_slot_t* slot = host_timer_find(ptimer, false);
+    if (slot == NULL)
+    {
+        return;
+    }
+    g_host_stats.timer_starts++;
+    ptimer->timer_period = repeat_flag ? ms : 0u;
+    slot->expire_ms      = s_now_ms + ms;
+    slot->active         = true;
+}
+
+void os_timer_stop(os_timer_t* ptimer)
+{
+    host_timer_slot_t* slot = host_timer_find(ptimer, false);
+    if (slot != NULL)
+    {
+        slot->active = false;
+    }
+}
+
+uint32_t host_time_now_ms(void)
+{
+    return s_now_ms;
+}
+
+uint32_t system_get_curr_time(void)
+{
+    return s_now_ms % 0x5000000u;
+}
+
+void host_time_advance(uint32_t ms)
+{
+    uint32_t target = s_now_ms + ms;
+
+    for (;;)
+    {
+        host_timer_slot_t* next = NULL;
+        for (uint32_t i = 0; i < HOST_TIMER_MAX; i++)
+        {
+            host_timer_slot_t* s = &s_timers[i];
+            if (s->t == NULL || !s->active || s->expire_ms > target)
+            {
+                continue;
+            }
+            if (next == NULL || s->expire_ms < next->expire_ms)
+            {
+                next = s;
+            }
+        }
+        if (next == NULL)
+        {
+            break;
+        }
+
+        os_timer_t* t = next->t;
+        s_now_ms      = next->expire_ms;
+        if (t->timer_period != 0u)
+        {
+            next->expire_ms += t->timer_period;
+        }
+        else
+        {
+            next->active = false;
+        }
+        if (t->timer_func != NULL)
+        {
+            t->timer_func(t->timer_arg);
+        }
+    }
+
+    s_now_ms = target;
+}
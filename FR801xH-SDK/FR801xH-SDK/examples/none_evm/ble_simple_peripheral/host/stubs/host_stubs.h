@@ -0,0 +1,169 @@
+/*********************************************************************
+ * @file host_stubs.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 主机(Linux)构建用的 SDK 打桩层：gap/gatt/os_timer/co_printf/UART/flash
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 协议栈(protocol/en_de_algo/phone_reply/protocol_fe/fd/ble_function)
+ *   本身不依赖寄存器，只依赖少量 SDK 接口；把这些接口在主机上打桩后，
+ *   就能不烧板直接测每帧成本，回归问题在上车前暴露。
+ * - 桩函数只做“计数 + 可选抓包”，不模拟协议栈行为，避免桩本身成为测量噪声。
+ *********************************************************************/
+
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 桩层统计（所有计数只增不减，调用方自行做差分）
+ */
+typedef struct
+{
+    uint64_t memcpy_calls;  /**< memcpy/memmove 调用次数 */
+    uint64_t memcpy_bytes;  /**< memcpy/memmove 搬运字节数 */
+    uint64_t ntf_frames;    /**< ntf_data 次数（GATT Notify） */
+    uint64_t ntf_bytes;     /**< ntf_data 字节数 */
+    uint64_t uart_frames;   /**< SocMcu_Frame_Send 次数 */
+    uint64_t uart_bytes;    /**< SocMcu_Frame_Send 数据段字节数 */
+    uint64_t log_calls;     /**< co_printf 次数 */
+    uint64_t log_bytes;     /**< co_printf 格式化字节 + UART1 日志口输出字节 */
+    uint64_t disconnects;   /**< gap_disconnect_req 次数 */
+    uint64_t timer_starts;  /**< os_timer_start 次数 */
+    uint64_t flash_reads;   /**< flash_read 次数 */
+    uint64_t flash_writes;  /**< flash_write 次数 */
+    uint64_t flash_bytes;   /**< flash_write 字节数 */
+    uint64_t flash_erases;  /**< flash_erase 覆盖的 4 KB 扇区数 */
+    uint64_t scan_starts;   /**< gap_start_scan 次数 */
+    uint64_t scan_stops;    /**< gap_stop_scan 次数 */
+} host_stats_t;
+
+extern host_stats_t g_host_stats;
+
+/* Notify / UART 抓包回调：基准/仿真程序用它校验回包内容 */
+typedef void (*host_ntf_hook_t)(uint8_t        conidx,
+                                uint8_t        att_idx,
+                                const uint8_t* data,
+                                uint16_t       len);
+typedef void (*host_uart_hook_t)(uint16_t       sync,
+                                 uint16_t       feature,
+                                 uint16_t       id,
+                                 const uint8_t* data,
+                                 uint16_t       len);
+
+void host_stubs_reset(void);
+void host_set_ntf_hook(host_ntf_hook_t hook);
+void host_set_uart_hook(host_uart_hook_t hook);
+
+/**
+ * @brief SocMcu_Frame_Send 故障注入：再成功 skip 次后，接下来 count 次返回 0（串口忙/发送失败）
+ * @note host_stubs_reset() 清除
+ */
+void host_set_uart_fail(uint32_t skip, uint32_t count);
+
+/**
+ * @brief co_printf 输出开关
+ * @note 默认只格式化不输出（保留格式化的 CPU 成本，和板上一致）；
+ *       环境变量 HOST_VERBOSE=1 时打印到 stdout，便于对照板上日志。
+ */
+void host_set_verbose(bool on);
+
+/**
+ * @brief co_printf 是否格式化（默认 true）
+ * @note 测峰值栈时关闭：主机 vsnprintf 的栈开销与板上无关，会淹没被测代码。
+ *       host_stubs_reset() 不改变该开关。
+ */
+void host_set_log_format(bool on);
+
+/* 链路状态：按 bit 表示 conidx 是否已连接 */
+void host_gap_set_connected(uint8_t conidx, bool connected);
+
+/**
+ * @brief 虚拟时钟：os_timer 不会自己走，由仿真程序推进
+ * @param ms 推进毫秒数；到期的定时器按到期顺序在当前线程回调
+ */
+void     host_time_advance(uint32_t ms);
+uint32_t host_time_now_ms(void);
+
+/**
+ * @brief 模拟 flash（NOR 语义：擦除置 0xFF，写入只能把 1 写成 0）
+ * @note 容量 HOST_FLASH_SIZE，覆盖 4M 配置下的整个地址空间；
+ *       host_stubs_reset() 不清 flash（模拟掉电重启后内容还在），
+ *       需要空片时调用 host_flash_reset()。
+ */
+#define HOST_FLASH_SIZE        0x80000u
+#define HOST_FLASH_SECTOR_SIZE 0x1000u
+
+void     host_flash_reset(void);
+uint8_t* host_flash_mem(void);
+
+/**
+ * @brief 掉电注入：再写 units 个字节 / 擦 units 个扇区（合计）后“掉电”
+ * @note 掉电发生在哪次操作中间，那次操作就只做一半：
+ *       写入停在当前字节，该字节只写进高 4 位；擦除只擦掉扇区前半。
+ *       之后所有写/擦都被丢弃（读照常），直到 host_flash_cut_disarm()，
+ *       仿真程序再按“重新上电”重新挂载被测模块。
+ */
+void host_flash_cut_arm(uint32_t units);
+void host_flash_cut_disarm(void);
+bool host_flash_cut_fired(void);
+
+/* addr 所在扇区自 host_flash_reset() 以来被擦除的次数（磨损分布） */
+uint32_t host_flash_sector_erases(uint32_t addr);
+
+/**
+ * @brief flash 耗时模型（微秒）：每次擦/写按模型累加“忙时间”
+ * @note 编程按页拆段：每段 prog_setup_us + (page_prog_us - prog_setup_us) * 段长 / 256。
+ *       板上擦写期间取指停顿、中断挂起，所以：
+ *       - 开中断时的一次擦/写 = 一段中断停顿；
+ *       - 关中断期间（GLOBAL_INT_DISABLE..RESTORE）累计的忙时间合成一段停顿。
+ *       每段停顿报给 host_set_blackout_hook 注册的回调，并更新最大值。
+ */
+typedef struct
+{
+    uint32_t sector_erase_us; /* 4KB 扇区擦除 */
+    uint32_t page_erase_us;   /* 256B 页擦除（flash_page_erase） */
+    uint32_t page_prog_us;    /* 整页 256B 编程 */
+    uint32_t prog_setup_us;   /* 每段编程的固定开销 */
+} host_flash_timing_t;
+
+typedef void (*host_blackout_hook_t)(uint32_t us);
+
+/* NULL = 恢复默认（SPI NOR 手册典型值量级） */
+void     host_flash_set_timing(const host_flash_timing_t* t);
+void     host_flash_get_timing(host_flash_timing_t* out);
+uint64_t host_flash_busy_us(void);
+void     host_set_blackout_hook(host_blackout_hook_t hook);
+uint32_t host_blackout_max_us(void);
+void     host_blackout_reset(void);
+
+/**
+ * @brief 最近一次 gap_start_scan 的参数；从未开扫返回 NULL
+ * @note 返回 const void* 免得本头文件依赖 gap_api.h，调用方自行转 gap_scan_param_t
+ */
+const void* host_gap_last_scan(void);
+
+/**
+ * @brief OTA 相关平台桩（ota.c 主机编译用）
+ * - 镜像 A 的 jump table 在模拟 flash 的 0 地址（ota.c 以 OTA_IMAGE_BASE_ADDR 访问）；
+ * - ota_gatt_report_notify 的回包交给 host_set_ota_rsp_hook 注册的回调；
+ * - platform_reset_patch 只计数并返回，仿真程序据此判断“已重启”。
+ */
+typedef void (*host_ota_rsp_hook_t)(uint8_t conidx, const uint8_t* data, uint16_t len);
+
+void     host_set_ota_rsp_hook(host_ota_rsp_hook_t hook);
+void     host_set_mtu(uint16_t mtu);
+void     host_set_running_bank_b(bool bank_b);
+uint32_t host_reset_count(void);
+
+/**
+ * @brief 运行 os 空闲循环（os_user_loop_event_set 注册的回调），直到回调自行摘除
+ * @note 二进制日志在这里刷出，输出字节计入 log_bytes。
+ */
+void host_run_idle(void);
+
+#endif // HOST_STUBS_H
@@ -0,0 +1,33 @@
+/*********************************************************************
+ * @file ll.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 主机构建用：替代 SDK platform/include/ll.h（该文件只允许 __arm__）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 主机仿真是单线程，没有中断，开关中断不改变执行顺序；
+ * - 但要记账：关中断期间累计的 flash 忙时间就是这段中断被挡住的时间，
+ *   host_stubs.c 据此统计最坏中断停顿（见 host_stubs.h 的 host_blackout_*）。
+ * - 与 SDK 一样在宏里定义局部变量 cpu_sr，同一作用域重复使用会编译报错。
+ *********************************************************************/
+
+#ifndef LL_H_
+#define LL_H_
+
+#include <stdint.h>
+
+typedef unsigned int CPU_SR;
+
+/* 返回进入前的嵌套深度，恢复时原样交回 */
+CPU_SR host_int_disable(void);
+void   host_int_restore(CPU_SR sr);
+
+#define GLOBAL_INT_DISABLE()         \
+    CPU_SR cpu_sr;                   \
+    {                                \
+        cpu_sr = host_int_disable(); \
+    }
+#define GLOBAL_INT_RESTORE() host_int_restore(cpu_sr)
+
+#endif // LL_H_
@@ -0,0 +1,156 @@
+/*********************************************************************
+ * @file applog_roundtrip.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief app_log 二进制记录 -> applog_decode.py 回环校验
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 本程序写两份文件：
+ * - OUT_BIN：经 app_log 环形缓冲刷出的原始字节（等同于板上 UART1 抓包）；
+ * - OUT_TXT：同样的参数用 snprintf 直接格式化出的期望文本。
+ * ctest 再用解码器把 OUT_BIN 还原，逐行与 OUT_TXT 比较（见 cmake/applog_check.cmake）。
+ *
+ * 用法：applog_roundtrip OUT_BIN OUT_TXT
+ *********************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define APP_LOG_LEVEL LOG_LEVEL_DEBUG
+#include "app_log.h"
+
+static FILE* s_bin = NULL;
+static FILE* s_txt = NULL;
+
+static void rt_sink(const uint8_t* data, uint32_t len)
+{
+    fwrite(data, 1, len, s_bin);
+}
+
+/* 期望文本：与解码器 --raw 输出一致（每条一行，去掉行尾空白） */
+static void rt_expect(const char* text)
+{
+    size_t n = strlen(text);
+    while (n > 0u && (text[n - 1u] == ' ' || text[n - 1u] == '\r' ||
+                      text[n - 1u] == '\n'))
+    {
+        n--;
+    }
+    fprintf(s_txt, "%.*s\n", (int)n, text);
+}
+
+static void rt_expect_hex(const char* title, const uint8_t* data, uint16_t len)
+{
+    char     line[256];
+    int      pos  = snprintf(line, sizeof(line), "%s", title);
+    uint16_t keep = (len > APP_LOG_HEX_MAX) ? (uint16_t)APP_LOG_HEX_MAX : len;
+
+    if (len == 0u)
+    {
+        snprintf(line + pos, sizeof(line) - (size_t)pos, " <empty>");
+    }
+    else
+    {
+        for (uint16_t i = 0; i < keep; i++)
+        {
+            pos += snprintf(line + pos, sizeof(line) - (size_t)pos, " %02X", data[i]);
+        }
+        if (len > keep)
+        {
+            snprintf(line + pos, sizeof(line) - (size_t)pos, " ...(+%u)", (unsigned)(len - keep));
+        }
+    }
+    rt_expect(line);
+}
+
+int main(int argc, char** argv)
+{
+    char line[256];
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s OUT_BIN OUT_TXT\n", argv[0]);
+        return 2;
+    }
+    s_bin = fopen(argv[1], "wb");
+    s_txt = fopen(argv[2], "w");
+    if (s_bin == NULL || s_txt == NULL)
+    {
+        fprintf(stderr, "applog_roundtrip: cannot open output\n");
+        return 2;
+    }
+    app_log_set_sink(rt_sink);
+
+    /* 1) 各种参数个数 / 格式 */
+    APP_LOGI("Protocol: Parse Success! Cmd: 0x%04X seq=%d\r\n", 0x01FE, 7);
+    rt_expect("Protocol: Parse Success! Cmd: 0x01FE seq=7");
+
+    APP_LOGE("no args\r\n");
+    rt_expect("no args");
+
+    APP_LOGW("neg=%d u=%u x=%08x %%\r\n", -12, 4000000000u, 0xBEEFu);
+    snprintf(line, sizeof(line), "neg=%d u=%u x=%08x %%", -12, 4000000000u, 0xBEEFu);
+    rt_expect(line);
+
+    APP_LOGD("[MCU_UART] feature=0x%04X id=0x%04X (%s) len=%u ",
+             0xFFFFu, 0x6101u, "CMD_BLE_RSSI_READ", 3u);
+    rt_expect("[MCU_UART] feature=0xFFFF id=0x6101 (CMD_BLE_RSSI_READ) len=3");
+
+    APP_LOGI("%u %u %u %u %u %u %u %u\r\n", 1, 2, 3, 4, 5, 6, 7, 8);
+    rt_expect("1 2 3 4 5 6 7 8");
+
+    APP_LOGI("char=%c end\r\n", 'Z');
+    rt_expect("char=Z end");
+
+    /* 2) HEX：空、短、超长截断 */
+    static const uint8_t s_time6[6] = {0x26, 0x01, 0x06, 0x17, 0x14, 0x21};
+    APP_LOGI_HEX("    time_bcd:", s_time6, 6u);
+    rt_expect_hex("    time_bcd:", s_time6, 6u);
+
+    APP_LOGD_HEX("    payload:", NULL, 0u);
+    rt_expect_hex("    payload:", NULL, 0u);
+
+    uint8_t big[48];
+    for (uint16_t i = 0; i < sizeof(big); i++)
+    {
+        big[i] = (uint8_t)(i * 7u);
+    }
+    APP_LOGD_HEX("Protocol: TX frame:", big, sizeof(big));
+    rt_expect_hex("Protocol: TX frame:", big, sizeof(big));
+    app_log_flush();
+
+    /* 3) 缓冲写满：丢新保旧，刷空后补一条丢弃计数 */
+    uint32_t written0 = app_log_written();
+    uint32_t dropped0 = app_log_dropped();
+    for (uint32_t i = 0; i < 200u; i++)
+    {
+        APP_LOGI("burst %u of %u\r\n", i, 200u);
+    }
+    uint32_t kept = app_log_written() - written0;
+    uint32_t lost = app_log_dropped() - dropped0;
+    for (uint32_t i = 0; i < kept; i++)
+    {
+        snprintf(line, sizeof(line), "burst %u of %u", (unsigned)i, 200u);
+        rt_expect(line);
+    }
+    app_log_flush();
+
+    APP_LOGI("after burst\r\n");
+    snprintf(line, sizeof(line), "<%u record(s) dropped: ring full>", (unsigned)lost);
+    rt_expect(line);
+    rt_expect("after burst");
+    app_log_flush();
+
+    fclose(s_bin);
+    fclose(s_txt);
+
+    if (kept == 0u || lost == 0u || kept + lost != 200u)
+    {
+        fprintf(stderr, "applog_roundtrip: unexpected ring accounting kept=%u lost=%u\n",
+                (unsigned)kept, (unsigned)lost);
+        return 1;
+    }
+    printf("applog_roundtrip: %u records kept, %u dropped\n", (unsigned)kept, (unsigned)lost);
+    return 0;
+}
@@ -0,0 +1,176 @@
+/*********************************************************************
+ * @file conn_ctx_test.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 连接上下文 + 组帧块池：APP_MAX_CONN 个连接轮流收发，组帧块只按池大小占用
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 流程（固件库按 APP_MAX_CONN=8 编译）：
+ * - 8 个连接依次 Conn_Open，逐个 Protocol_Send_Unicast、Protocol_Tx_Begin/Commit，
+ *   再整体 Protocol_Send_Broadcast；
+ * - Notify 桩里核对每帧的连接号、命令字、长度与 BCC；
+ * - 每次发送结束组帧块必须已归还，就地组帧那条路径不得有 payload 拷贝；
+ * - 全部断开后块池必须清空。
+ * 任一项不满足返回 1；组帧缓冲常驻 RAM（旧的按连接数 vs 现在的按池大小）、
+ * 每帧 memcpy 字节数只打印。
+ *
+ * 用法：conn_ctx_test [--rounds N]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "conn_ctx.h"
+#include "host_stubs.h"
+#include "protocol.h"
+
+#define TEST_CMD         0x13FDu
+#define TEST_PAYLOAD_LEN 20u
+
+static uint32_t s_frames[APP_MAX_CONN];
+static uint32_t s_errors;
+
+static void test_ntf_hook(uint8_t conidx, uint8_t att_idx, const uint8_t* data, uint16_t len)
+{
+    uint8_t bcc = 0;
+
+    (void)att_idx;
+    if (conidx >= APP_MAX_CONN || len < 10u || data[2] != len)
+    {
+        s_errors++;
+        return;
+    }
+    for (uint16_t i = 0; i < (uint16_t)(len - 3u); i++)
+    {
+        bcc ^= data[i];
+    }
+    if (data[0] != 0x55u || data[1] != 0x55u || data[len - 3u] != bcc ||
+        data[len - 2u] != 0xAAu || data[len - 1u] != 0xAAu ||
+        (((uint16_t)data[5] << 8) | data[6]) != TEST_CMD ||
+        len != TEST_PAYLOAD_LEN + 10u)
+    {
+        s_errors++;
+        return;
+    }
+    s_frames[conidx]++;
+}
+
+static bool test_expect(bool cond, const char* what)
+{
+    if (!cond)
+    {
+        fprintf(stderr, "conn_ctx_test: %s\n", what);
+        s_errors++;
+    }
+    return cond;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t rounds = 100u;
+    uint8_t  payload[TEST_PAYLOAD_LEN];
+    uint8_t  peak = 0u;
+    uint64_t copy_bytes = 0u;
+    uint64_t inplace_bytes = 0u;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+        {
+            rounds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--rounds N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint8_t i = 0; i < TEST_PAYLOAD_LEN; i++)
+    {
+        payload[i] = (uint8_t)(i * 7u + 1u);
+    }
+
+    host_stubs_reset();
+    host_set_ntf_hook(test_ntf_hook);
+    Conn_Init();
+    Protocol_Init();
+    for (uint8_t c = 0; c < APP_MAX_CONN; c++)
+    {
+        host_gap_set_connected(c, true);
+        Conn_Open(c);
+        Protocol_Auth_Clear(c);
+    }
+
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        for (uint8_t c = 0; c < APP_MAX_CONN; c++)
+        {
+            uint64_t m0 = g_host_stats.memcpy_bytes;
+            test_expect(Protocol_Send_Unicast(c, TEST_CMD, payload, TEST_PAYLOAD_LEN) == 0,
+                        "unicast failed");
+            copy_bytes += g_host_stats.memcpy_bytes - m0;
+            test_expect(Conn_TxInUse() == 0u, "block not returned after unicast");
+
+            m0            = g_host_stats.memcpy_bytes;
+            uint8_t* data = Protocol_Tx_Begin();
+            if (test_expect(data != NULL, "tx begin failed"))
+            {
+                if (Conn_TxInUse() > peak)
+                {
+                    peak = Conn_TxInUse();
+                }
+                for (uint8_t i = 0; i < TEST_PAYLOAD_LEN; i++)
+                {
+                    data[i] = payload[i];
+                }
+                test_expect(Protocol_Tx_Commit(c, TEST_CMD, data, TEST_PAYLOAD_LEN, true) == 0,
+                            "tx commit failed");
+            }
+            inplace_bytes += g_host_stats.memcpy_bytes - m0;
+            test_expect(Conn_TxInUse() == 0u, "block not returned after commit");
+        }
+        test_expect(Protocol_Send_Broadcast(TEST_CMD, payload, TEST_PAYLOAD_LEN, false) == 0,
+                    "broadcast failed");
+    }
+    test_expect(peak <= APP_TX_POOL_BLOCKS, "pool over-allocated");
+    test_expect(inplace_bytes + (uint64_t)TEST_PAYLOAD_LEN * rounds * APP_MAX_CONN <= copy_bytes,
+                "in-place path still copies the payload");
+    for (uint8_t c = 0; c < APP_MAX_CONN; c++)
+    {
+        test_expect(s_frames[c] == 3u * rounds, "frame count mismatch");
+    }
+
+    /* 写到一半放弃：块要能还回去 */
+    uint8_t* abandoned = Protocol_Tx_Begin();
+    Protocol_Tx_Abort(abandoned);
+    test_expect(Conn_TxInUse() == 0u, "block not returned after abort");
+
+    for (uint8_t c = 0; c < APP_MAX_CONN; c++)
+    {
+        Conn_Close(c);
+        Protocol_Auth_Clear(c);
+        host_gap_set_connected(c, false);
+    }
+    test_expect(Conn_TxInUse() == 0u, "pool not released on disconnect");
+    test_expect(Protocol_Send_Unicast(0, TEST_CMD, payload, TEST_PAYLOAD_LEN) != 0,
+                "send on closed link succeeded");
+    host_set_ntf_hook(NULL);
+
+    printf("conn_ctx_test (%u links, pool %u blocks, %u rounds):\n",
+           (unsigned)APP_MAX_CONN, (unsigned)APP_TX_POOL_BLOCKS, (unsigned)rounds);
+    printf("  TX blocks resident: %u B (per-link frame+enc would be %u B), peak leased %u\n",
+           (unsigned)(sizeof(conn_tx_blk_t) * APP_TX_POOL_BLOCKS),
+           (unsigned)((PROTOCOL_MAX_LEN + 10u + PROTOCOL_MAX_LEN) * APP_MAX_CONN),
+           (unsigned)peak);
+    printf("  memcpy per %u-byte notify: copy path %.1f B, in-place path %.1f B\n",
+           (unsigned)TEST_PAYLOAD_LEN,
+           (double)copy_bytes / (double)(rounds * APP_MAX_CONN),
+           (double)inplace_bytes / (double)(rounds * APP_MAX_CONN));
+    printf("  app_conn_t: %u B x %u\n", (unsigned)sizeof(app_conn_t), (unsigned)APP_MAX_CONN);
+    printf("conn_ctx_test: %s\n", s_errors ? "FAIL" : "OK");
+    return s_errors ? 1 : 0;
+}
@@ -0,0 +1,379 @@
+/*********************************************************************
+ * @file ota_lz_fuzz.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief ota_lz.c（设备端流式解码）的 fuzz 目标：编解码回环 + 损坏数据不越界
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 解码器跑在 BLE 回调里，输入完全来自手机，坏数据只能报 OTA_LZ_ERROR，不能写出窗口、
+ * 不能让页回调越过 raw_length（越过就会写到镜像区外面）。每个输入检查：
+ * - 页回调按 0、256、512... 连续交付，每次不超过一页，offset + len <= raw_length；
+ * - 返回 DONE 时正好交付了 raw_length 字节；ERROR / DONE 之后再喂数据只能是 ERROR；
+ * - 窗口按 2^window_bits 精确 malloc，配合 -fsanitize=address,undefined 兜住越界。
+ *
+ * main() 是自带的随机/变异驱动：
+ * - 回环：随机 / 低熵 / 长串重复 / 复制前文的数据，0~20000 字节，窗口 8~12 位，
+ *   ota_lz_encode 压缩后按任意切分解码，必须逐字节一致，且恰好在最后一个字节上 DONE；
+ * - 变异：合法压缩流翻位 / 截断 / 插入 / 删除，或 raw_length 给错；
+ * - 纯随机字节当压缩流。
+ * 定义 OTA_LZ_FUZZ_LIBFUZZER 后去掉 main，可直接用 clang -fsanitize=fuzzer 链接。
+ *
+ * 用法：ota_lz_fuzz [--iters N] [--seed S] [FILE...]
+ *       （FILE 格式：1 字节窗口位数 + 2 字节小端 raw_length + 压缩流）
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ota_lz.h"
+#include "ota_lz_enc.h"
+
+#define FUZZ_DEFAULT_ITERS 3000u
+#define FUZZ_MAX_RAW       20000u
+#define FUZZ_MAX_INPUT     (OTA_LZ_ENC_BOUND(FUZZ_MAX_RAW) + 64u)
+
+#define FUZZ_CHECK(cond)                                                         \
+    do                                                                           \
+    {                                                                            \
+        if (!(cond))                                                             \
+        {                                                                        \
+            fprintf(stderr, "ota_lz_fuzz: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            abort();                                                             \
+        }                                                                        \
+    } while (0)
+
+static uint8_t  s_raw[FUZZ_MAX_RAW];
+static uint8_t  s_comp[FUZZ_MAX_INPUT];
+static uint8_t  s_out[FUZZ_MAX_RAW];
+static uint32_t s_raw_length;
+static uint32_t s_delivered;
+
+/* xorshift32：数据、切分与变异都从它来，同一 seed 可复现 */
+static uint32_t fuzz_rand(uint32_t* s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+static void fuzz_page(const uint8_t* page, uint32_t offset, uint32_t len)
+{
+    FUZZ_CHECK(offset == s_delivered);
+    FUZZ_CHECK(len > 0u && len <= OTA_LZ_PAGE);
+    FUZZ_CHECK(offset + len <= s_raw_length);
+    /* 只有最后一次可以不足一页 */
+    FUZZ_CHECK(len == OTA_LZ_PAGE || offset + len == s_raw_length);
+    memcpy(&s_out[offset], page, len);
+    s_delivered += len;
+}
+
+/*
+ * 按 seed 派生的随机切分把 in 喂给解码器，检查上面列的不变量。
+ * @return 最后一次 ota_lz_decode 的结果；*done_at 为返回 DONE 时已喂入的字节数
+ */
+static uint8_t fuzz_decode(const uint8_t* in, uint32_t n, uint8_t bits, uint32_t raw_length, uint32_t seed,
+                           uint32_t* done_at)
+{
+    struct ota_lz_t lz;
+    uint8_t*        win = (uint8_t*)malloc(1u << bits);
+    uint32_t        rng = seed | 1u;
+    uint8_t         rc  = (raw_length == 0u) ? OTA_LZ_DONE : OTA_LZ_OK;
+    uint32_t        off = 0u;
+
+    FUZZ_CHECK(win != NULL);
+    s_raw_length = raw_length;
+    s_delivered  = 0u;
+    *done_at     = 0u;
+    ota_lz_init(&lz, win, bits, raw_length, fuzz_page);
+
+    while (off < n)
+    {
+        uint32_t r     = fuzz_rand(&rng);
+        uint32_t chunk = ((r & 3u) == 0u) ? 1u : 1u + (r >> 8) % 300u;
+        if (chunk > n - off)
+        {
+            chunk = n - off;
+        }
+        uint8_t prev = rc;
+        rc           = ota_lz_decode(&lz, &in[off], chunk);
+        if (prev != OTA_LZ_OK)
+        {
+            FUZZ_CHECK(rc == OTA_LZ_ERROR); /* 结束或出错后不再接受输入 */
+        }
+        off += chunk;
+        if (rc == OTA_LZ_DONE && *done_at == 0u)
+        {
+            *done_at = off;
+        }
+    }
+    if (rc == OTA_LZ_DONE)
+    {
+        FUZZ_CHECK(s_delivered == raw_length);
+    }
+    else
+    {
+        FUZZ_CHECK(s_delivered <= raw_length);
+    }
+    free(win);
+    return rc;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    uint32_t done_at;
+
+    if (size < 3u)
+    {
+        return 0;
+    }
+    uint8_t  bits       = (uint8_t)(OTA_LZ_BITS_MIN + data[0] % (OTA_LZ_BITS_MAX - OTA_LZ_BITS_MIN + 1u));
+    uint32_t raw_length = ((uint32_t)data[1] | ((uint32_t)data[2] << 8)) % (FUZZ_MAX_RAW + 1u);
+    fuzz_decode(&data[3], (uint32_t)(size - 3u), bits, raw_length, (uint32_t)size * 2654435761u, &done_at);
+    return 0;
+}
+
+#ifndef OTA_LZ_FUZZ_LIBFUZZER
+
+/* 像固件的数据：随机字节、少数几个值、长串重复、复制前文（带小改动） */
+static uint32_t fuzz_gen_raw(uint32_t* rng)
+{
+    uint32_t r = fuzz_rand(rng);
+    uint32_t n = ((r & 7u) == 0u) ? (r >> 8) % 16u : (r >> 8) % (FUZZ_MAX_RAW + 1u);
+    uint32_t i = 0u;
+
+    while (i < n)
+    {
+        uint32_t k   = fuzz_rand(rng);
+        uint32_t run = 1u + (k >> 8) % 600u;
+        if (run > n - i)
+        {
+            run = n - i;
+        }
+        switch (k & 3u)
+        {
+            case 0: /* 随机 */
+                for (uint32_t j = 0; j < run; j++)
+                {
+                    s_raw[i + j] = (uint8_t)fuzz_rand(rng);
+                }
+                break;
+            case 1: /* 低熵 */
+                for (uint32_t j = 0; j < run; j++)
+                {
+                    s_raw[i + j] = (uint8_t)(fuzz_rand(rng) & 0x03u) * 0x41u;
+                }
+                break;
+            case 2: /* 同一字节（0xFF 填充、0 填充） */
+                memset(&s_raw[i], (k & 0x100u) ? 0xFF : (int)(k >> 24), run);
+                break;
+            default: /* 复制前文，距离可能超过窗口 */
+                if (i == 0u)
+                {
+                    s_raw[i] = (uint8_t)k;
+                    run      = 1u;
+                    break;
+                }
+                {
+                    uint32_t src = (fuzz_rand(rng) % i);
+                    for (uint32_t j = 0; j < run; j++)
+                    {
+                        s_raw[i + j] = s_raw[src + j]; /* 源可与目的重叠，逐字节拷 */
+                    }
+                    if (k & 0x200u)
+                    {
+                        s_raw[i + run / 2u] ^= 0x5Au;
+                    }
+                }
+                break;
+        }
+        i += run;
+    }
+    return n;
+}
+
+static uint8_t fuzz_bits(uint32_t* rng)
+{
+    return (uint8_t)(OTA_LZ_BITS_MIN + fuzz_rand(rng) % (OTA_LZ_BITS_MAX - OTA_LZ_BITS_MIN + 1u));
+}
+
+/* 合法压缩流：任意切分下必须逐字节还原，并且恰好在最后一个字节 DONE */
+static void fuzz_roundtrip(uint32_t* rng)
+{
+    uint32_t n    = fuzz_gen_raw(rng);
+    uint8_t  bits = fuzz_bits(rng);
+    uint32_t m    = ota_lz_encode(s_raw, n, bits, s_comp);
+    uint32_t done_at;
+
+    FUZZ_CHECK(m <= OTA_LZ_ENC_BOUND(n));
+    FUZZ_CHECK((m == 0u) == (n == 0u));
+    memset(s_out, 0xA5, n);
+    FUZZ_CHECK(fuzz_decode(s_comp, m, bits, n, fuzz_rand(rng), &done_at) == OTA_LZ_DONE);
+    FUZZ_CHECK(done_at == m);
+    FUZZ_CHECK(memcmp(s_out, s_raw, n) == 0);
+
+    /* 少一个字节必须还没结束 */
+    if (m > 0u)
+    {
+        FUZZ_CHECK(fuzz_decode(s_comp, m - 1u, bits, n, fuzz_rand(rng), &done_at) == OTA_LZ_OK);
+    }
+}
+
+/* 合法压缩流做翻位 / 截断 / 插入 / 删除，或者 raw_length、窗口位数给错 */
+static void fuzz_mutate(uint32_t* rng)
+{
+    uint32_t n    = fuzz_gen_raw(rng);
+    uint8_t  bits = fuzz_bits(rng);
+    uint32_t m    = ota_lz_encode(s_raw, n, bits, s_comp);
+    uint32_t done_at;
+
+    uint32_t k = fuzz_rand(rng) % 6u;
+    for (uint32_t i = 0; i < k && m > 0u; i++)
+    {
+        uint32_t r   = fuzz_rand(rng);
+        uint32_t pos = (r >> 3) % m;
+        switch (r & 3u)
+        {
+            case 0: /* 翻位 */
+                s_comp[pos] ^= (uint8_t)(1u << ((r >> 16) & 7u));
+                break;
+            case 1: /* 截断 */
+                m = pos + 1u;
+                break;
+            case 2: /* 删除一个字节 */
+                memmove(&s_comp[pos], &s_comp[pos + 1u], m - pos - 1u);
+                m--;
+                break;
+            default: /* 插入一个字节 */
+                if (m < FUZZ_MAX_INPUT)
+                {
+                    memmove(&s_comp[pos + 1u], &s_comp[pos], m - pos);
+                    s_comp[pos] = (uint8_t)(r >> 16);
+                    m++;
+                }
+                break;
+        }
+    }
+
+    uint32_t r = fuzz_rand(rng);
+    if ((r & 7u) == 0u)
+    {
+        n = (r >> 8) % (FUZZ_MAX_RAW + 1u);
+    }
+    else if ((r & 7u) == 1u)
+    {
+        bits = fuzz_bits(rng);
+    }
+    fuzz_decode(s_comp, m, bits, n, fuzz_rand(rng), &done_at);
+}
+
+/* 纯随机字节当压缩流 */
+static void fuzz_garbage(uint32_t* rng)
+{
+    uint32_t m = fuzz_rand(rng) % 2048u;
+    uint32_t done_at;
+
+    for (uint32_t i = 0; i < m; i++)
+    {
+        s_comp[i] = (uint8_t)fuzz_rand(rng);
+    }
+    fuzz_decode(s_comp, m, fuzz_bits(rng), fuzz_rand(rng) % (FUZZ_MAX_RAW + 1u), fuzz_rand(rng), &done_at);
+}
+
+/* 解码器边界：第一个匹配就往回引用、匹配超出 raw_length、DONE 后多一个字节 */
+static void fuzz_decoder_limits(void)
+{
+    uint32_t done_at;
+
+    /* 标志 0x01：第一项就是匹配，距离 1 但前面什么都没有 */
+    static const uint8_t s_back[] = {0x01, 0x00, 0x00};
+    FUZZ_CHECK(fuzz_decode(s_back, sizeof(s_back), 8u, 16u, 1u, &done_at) == OTA_LZ_ERROR);
+
+    /* 1 个字面字节 + 长度 3 的匹配，但 raw_length 只有 3 */
+    static const uint8_t s_long[] = {0x02, 0x41, 0x00, 0x00};
+    FUZZ_CHECK(fuzz_decode(s_long, sizeof(s_long), 8u, 3u, 1u, &done_at) == OTA_LZ_ERROR);
+    FUZZ_CHECK(fuzz_decode(s_long, sizeof(s_long), 8u, 4u, 1u, &done_at) == OTA_LZ_DONE);
+    FUZZ_CHECK(memcmp(s_out, "AAAA", 4u) == 0);
+
+    /* 正好结束后多一个字节 */
+    static const uint8_t s_tail[] = {0x00, 0x41, 0x42};
+    FUZZ_CHECK(fuzz_decode(s_tail, 2u, 8u, 1u, 1u, &done_at) == OTA_LZ_DONE);
+    FUZZ_CHECK(fuzz_decode(s_tail, sizeof(s_tail), 8u, 1u, 1u, &done_at) == OTA_LZ_ERROR);
+}
+
+static int fuzz_replay(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "ota_lz_fuzz: cannot open %s\n", path);
+        return 1;
+    }
+    size_t n = fread(s_comp, 1, sizeof(s_comp), f);
+    fclose(f);
+    LLVMFuzzerTestOneInput(s_comp, n);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t iters = FUZZ_DEFAULT_ITERS;
+    uint32_t seed  = 0x1234567u;
+    int      files = 0;
+    int      fail  = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc)
+        {
+            iters = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "usage: %s [--iters N] [--seed S] [FILE...]\n", argv[0]);
+            return 2;
+        }
+        else
+        {
+            fail |= fuzz_replay(argv[i]);
+            files++;
+        }
+    }
+    if (files > 0)
+    {
+        return fail;
+    }
+
+    uint32_t rng = seed ? seed : 1u;
+    fuzz_decoder_limits();
+    for (uint32_t it = 0; it < iters; it++)
+    {
+        switch (it % 4u)
+        {
+            case 0:
+            case 1:
+                fuzz_roundtrip(&rng);
+                break;
+            case 2:
+                fuzz_mutate(&rng);
+                break;
+            default:
+                fuzz_garbage(&rng);
+                break;
+        }
+    }
+    printf("ota_lz_fuzz: %u iterations, seed 0x%08X: ok\n", (unsigned)iters, (unsigned)seed);
+    return 0;
+}
+
+#endif /* OTA_LZ_FUZZ_LIBFUZZER */
@@ -0,0 +1,810 @@
+/*********************************************************************
+ * @file ota_stream_test.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief OTA 吞吐：原“一包一回”流程 vs 写命令流式 + 滑动确认窗口，模拟链路上的有效 KB/s
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * SDK ota.c 原样编译，手机端与链路在这里模拟：
+ * - 连接事件按 --ci-ms 等间隔发生，每个事件手机最多发 --ppce 个写命令；
+ *   设备收到的包在事件后依次交给 app_otas_recv_data，回包/确认在下一个事件发出；
+ * - 设备擦写 flash 的时间按 host_stubs 的耗时模型记账，擦写期间的连接事件算错过
+ *   （CPU 停顿，链路层这一轮没有收发）；
+ * - --loss 为写命令/确认通知在应用层被丢的百分比（主机缓冲满等），只作用于流式；
+ *   原流程每条命令都等回包才发下一条，按无丢包计（对原流程有利）。
+ *
+ * 原流程：GET_STR_BASE、每 4KB 一条 PAGE_ERASE、WRITE_DATA（一包一回）、REBOOT。
+ * 流式：STREAM_START 拿窗口，然后在窗口内连续推 STREAM_DATA；收到确认后滑动窗口，
+ *       位图里缺的包（序号比已收到的最高序号小、且在更早的事件发出）立刻重发；
+ *       连续 SIM_RTO_CE 个事件没有确认时重发最早未确认的包（窗口为 0 时发下一包探测）；
+ *       全部确认后发 REBOOT（带 CRC32）。设备预擦新镜像区时窗口为 0，擦完补发确认开窗。
+ *
+ * 压缩流式（--lz BITS，0 关闭）：镜像用 ota_lz_encode 压缩，STREAM_START_LZ 后按流式同样的
+ *       窗口推压缩数据，设备边收边解；KB/s 按解压后的镜像计。解码的 CPU 时间不计
+ *       （约 14 cycles/B，整个镜像几十毫秒，相对几秒的传输可忽略）。
+ *       另跑一遍声明的 raw_length 少一个字节的坏流：设备必须回错误确认、不提交首页。
+ * --firmware 用真实固件（.axf / .bin）代替伪随机镜像，版本号改成高于运行镜像。
+ * 差分流式（--delta GROW，需要 --firmware）：A 区放这版固件当运行镜像，新镜像用发版模型
+ *       （ota_delta_enc.h，改 4 个函数、其中一个长 GROW 字节）生成，STREAM_START_DELTA 后推补丁；
+ *       手机每条确认都按里面的窗口发包，设备复制没做完时窗口收小。连接事件之间推进虚拟时钟，
+ *       差分泵定时器在包间隙里接着重建，它擦写 flash 的时间同样占住 CPU。
+ *       补丁推完时复制还没做完，手机紧跟着发的 REBOOT 会回 BUSY（busy 列），隔 SIM_BUSY_CE 个事件重发。
+ *       另跑一遍 A 区中间改一个字节的：设备必须在补丁头处回错误确认、不提交首页；
+ *       再跑一遍最后一包后紧跟 REBOOT 的：设备必须回 BUSY，重发后照常提交。
+ *
+ * 自检，任一不满足返回 1：各流程写进 B 区的镜像逐字节一致、回包全部成功、
+ * 各重启一次；无丢包时流式吞吐不低于原流程的 2 倍，真实固件压缩流式快于非压缩流式，
+ * 差分快于压缩；坏流、底不对的补丁不提交。
+ *
+ * 用法：ota_stream_test [--image KB] [--firmware PATH] [--lz BITS] [--delta GROW] [--mtu N]
+ *                       [--ci-ms N] [--ppce N] [--loss PCT] [--seed S]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver_flash.h"
+#include "host_stubs.h"
+#include "jump_table.h"
+#include "ota.h"
+#include "ota_delta_enc.h"
+#include "ota_lz.h"
+#include "ota_lz_enc.h"
+
+#define SIM_IMAGE_SIZE 0x30000u /* 镜像 A 大小 = 镜像 B 起始地址 */
+#define SIM_PKT_MAX    600u
+#define SIM_NTF_MAX    64u
+#define SIM_CE_LIMIT   2000000u
+#define SIM_RTO_CE     8u /* 连续多少个有效连接事件没有确认就超时重发 */
+#define SIM_BUSY_CE    2u /* REBOOT 回 BUSY 后隔多少个连接事件重发 */
+#define SIM_MAX_FUNCS  4096u
+
+#ifndef OTA_LZ_WINDOW_BITS
+#define OTA_LZ_WINDOW_BITS 11
+#endif
+
+/* ota.c 里的 CRC32（OTA_CRC_CHECK 打开时对外可见） */
+uint32_t Crc32CalByByte(int crc, uint8_t* ptr, int len);
+
+typedef struct
+{
+    uint8_t  data[32];
+    uint16_t len;
+} sim_ntf_t;
+
+typedef struct
+{
+    uint64_t us;      /* 从第一条命令到 REBOOT 处理完 */
+    uint32_t ce;      /* 有效连接事件数 */
+    uint32_t missed;  /* 擦写期间错过的连接事件 */
+    uint32_t pkts;    /* 手机发出的包（含重发） */
+    uint32_t retx;    /* 重发 */
+    uint32_t lost;    /* 被丢的包/确认 */
+    uint32_t ntf;     /* 设备回包/确认条数 */
+    uint32_t bad;     /* 失败回包 */
+    uint32_t busy;    /* REBOOT 回 BUSY（差分复制没做完）的次数 */
+} sim_result_t;
+
+static uint32_t  s_ci_us = 30000u;
+static uint32_t  s_ppce  = 4u;
+static uint32_t  s_loss  = 0u; /* 百分比 */
+static uint32_t  s_rng   = 1u;
+static uint16_t  s_mtu   = 247u;
+static uint8_t   s_image[SIM_IMAGE_SIZE];
+static uint8_t   s_comp[OTA_LZ_ENC_BOUND(SIM_IMAGE_SIZE)];
+static uint32_t  s_comp_len = 0u;
+static uint8_t   s_base[SIM_IMAGE_SIZE]; /* 差分：A 区的运行镜像 */
+static uint32_t  s_base_len = 0u;
+static uint8_t   s_patch[OTA_DELTA_ENC_BOUND(SIM_IMAGE_SIZE)];
+static uint32_t  s_patch_len = 0u;
+static sim_ntf_t s_ntf[SIM_NTF_MAX];
+static uint32_t  s_ntf_n = 0u;
+static uint64_t  s_busy_until;
+static uint64_t  s_now;
+static uint32_t  s_time0_ms; /* 本轮开始时的虚拟时钟 */
+static bool      s_eager;    /* 手机推完最后一包不等确认，同一个事件里紧跟着发 REBOOT（要求无丢包） */
+
+static uint32_t sim_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return (s_rng >> 16) & 0x7FFFu;
+}
+
+static bool sim_drop(void)
+{
+    return s_loss != 0u && (sim_rand() % 100u) < s_loss;
+}
+
+static void sim_rsp_hook(uint8_t conidx, const uint8_t* data, uint16_t len)
+{
+    (void)conidx;
+    if (s_ntf_n < SIM_NTF_MAX)
+    {
+        sim_ntf_t* n = &s_ntf[s_ntf_n++];
+        n->len       = (len > sizeof(n->data)) ? (uint16_t)sizeof(n->data) : len;
+        memcpy(n->data, data, n->len);
+    }
+}
+
+/* 设备处理一包：从当前事件（或上一段擦写结束）开始，按 flash 耗时占住 CPU */
+static void sim_device_rx(uint8_t* pkt, uint16_t len)
+{
+    uint64_t t0 = host_flash_busy_us();
+    app_otas_recv_data(0u, pkt, len);
+    if (s_busy_until < s_now)
+    {
+        s_busy_until = s_now;
+    }
+    s_busy_until += host_flash_busy_us() - t0;
+}
+
+/*
+ * 推进到下一个能收发的连接事件，把设备攒下的回包取出来
+ * @return 取出的回包条数（拷到 out）
+ */
+static uint32_t sim_next_ce(uint32_t* ce, sim_result_t* r, sim_ntf_t* out)
+{
+    do
+    {
+        uint64_t prev = s_now;
+        (*ce)++;
+        s_now = (uint64_t)(*ce) * s_ci_us;
+
+        /* 设备定时器（差分泵）走到这个事件；回调里的擦写从上一个事件（或上一段擦写结束）算起 */
+        uint64_t t0 = host_flash_busy_us();
+        host_time_advance(s_time0_ms + (uint32_t)(s_now / 1000u) - host_time_now_ms());
+        if (host_flash_busy_us() != t0)
+        {
+            if (s_busy_until < prev)
+            {
+                s_busy_until = prev;
+            }
+            s_busy_until += host_flash_busy_us() - t0;
+        }
+        if (s_now < s_busy_until)
+        {
+            r->missed++;
+        }
+    } while (s_now < s_busy_until);
+    r->ce++;
+
+    uint32_t n = s_ntf_n;
+    memcpy(out, s_ntf, n * sizeof(sim_ntf_t));
+    s_ntf_n = 0u;
+    r->ntf += n;
+    return n;
+}
+
+/* 新镜像：开头是 jump table（版本号高于运行镜像，ota.c 不改写），后面伪随机或真实固件 */
+static bool sim_make_image(const char* firmware, uint32_t* image_bytes)
+{
+    uint32_t version = 2u;
+
+    if (firmware != NULL)
+    {
+        uint32_t n;
+        uint8_t* fw = fw_image_load(firmware, &n);
+        if (fw == NULL || n <= 256u || n > SIM_IMAGE_SIZE)
+        {
+            fprintf(stderr, "%s: cannot read firmware image (or larger than a bank)\n", firmware);
+            free(fw);
+            return false;
+        }
+        memcpy(s_image, fw, n);
+        free(fw);
+        *image_bytes = n;
+    }
+    else
+    {
+        struct jump_table_t jt;
+        uint32_t            seed = 5u;
+        for (uint32_t i = 0; i < *image_bytes; i++)
+        {
+            seed       = seed * 1103515245u + 12345u;
+            s_image[i] = (uint8_t)(seed >> 16);
+        }
+        memset(&jt, 0, sizeof(jt));
+        jt.image_size = SIM_IMAGE_SIZE;
+        memcpy(s_image, &jt, sizeof(jt));
+    }
+    memcpy(&s_image[offsetof(struct jump_table_t, firmware_version)], &version, sizeof(version));
+    return true;
+}
+
+static void sim_setup(void)
+{
+    struct jump_table_t jt;
+
+    host_flash_reset();
+    host_set_ota_rsp_hook(sim_rsp_hook);
+    host_set_mtu(s_mtu);
+    s_ntf_n      = 0u;
+    s_busy_until = 0u;
+    s_now        = 0u;
+    s_time0_ms   = host_time_now_ms();
+
+    /* 正在运行的镜像 A：jump table 在 flash 0 地址（差分时整个旧镜像，jump table 已改好） */
+    memset(&jt, 0, sizeof(jt));
+    jt.image_size       = SIM_IMAGE_SIZE;
+    jt.firmware_version = 1u;
+    if (s_base_len != 0u)
+        flash_write(0u, s_base_len, s_base);
+    else
+        flash_write(0u, sizeof(jt), (uint8_t*)&jt);
+
+    ota_deinit(0u);
+    ota_init(0u);
+}
+
+static uint16_t sim_reboot_pkt(uint8_t* pkt, uint32_t image_bytes)
+{
+    struct app_ota_cmd_hdr_t* h         = (struct app_ota_cmd_hdr_t*)pkt;
+    h->opcode                           = OTA_CMD_REBOOT;
+    h->length                           = sizeof(struct firmware_check);
+    h->cmd.fir_crc_data.firmware_length = image_bytes;
+    h->cmd.fir_crc_data.CRC32_data      = Crc32CalByByte(0, &s_image[256], (int)image_bytes - 256);
+    return (uint16_t)(3u + sizeof(struct firmware_check));
+}
+
+static bool sim_check(const char* name, uint32_t image_bytes, uint32_t resets0, const sim_result_t* r)
+{
+    bool ok = true;
+
+    if (memcmp(host_flash_mem() + SIM_IMAGE_SIZE, s_image, image_bytes) != 0)
+    {
+        printf("  %s: bank B differs from image\n", name);
+        ok = false;
+    }
+    if (r->bad != 0u || host_reset_count() - resets0 != 1u)
+    {
+        printf("  %s: %u failed responses, %u resets\n", name, (unsigned)r->bad,
+               (unsigned)(host_reset_count() - resets0));
+        ok = false;
+    }
+    return ok;
+}
+
+/* ==================== 原流程：一包一回 ==================== */
+
+static bool sim_legacy(uint32_t image_bytes, sim_result_t* r)
+{
+    static uint8_t pkt[SIM_PKT_MAX];
+    sim_ntf_t      rx[SIM_NTF_MAX];
+    uint32_t       resets0 = host_reset_count();
+    uint32_t       ce      = 0u;
+    uint32_t       step    = 0u; /* 0 GET_STR_BASE, 1 PAGE_ERASE..., 2 WRITE_DATA..., 3 REBOOT */
+    uint32_t       off     = 0u;
+    bool           waiting = false;
+    uint16_t       chunk   = (uint16_t)(s_mtu - 3u - 3u - sizeof(struct write_data_cmd));
+
+    sim_setup();
+    memset(r, 0, sizeof(*r));
+
+    while (ce < SIM_CE_LIMIT)
+    {
+        uint32_t n = sim_next_ce(&ce, r, rx);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            if (rx[i].data[0] != OTA_RSP_SUCCESS)
+            {
+                r->bad++;
+            }
+            waiting = false;
+        }
+        if (waiting)
+        {
+            continue;
+        }
+
+        struct app_ota_cmd_hdr_t* h = (struct app_ota_cmd_hdr_t*)pkt;
+        uint16_t                  len;
+        memset(pkt, 0, 16u);
+        if (step == 0u)
+        {
+            h->opcode = OTA_CMD_GET_STR_BASE;
+            len       = 3u;
+            step      = 1u;
+        }
+        else if (step == 1u)
+        {
+            h->opcode                      = OTA_CMD_PAGE_ERASE;
+            h->length                      = sizeof(struct page_erase_cmd);
+            h->cmd.page_erase.base_address = SIM_IMAGE_SIZE + off;
+            len                            = 3u + sizeof(struct page_erase_cmd);
+            off += 0x1000u;
+            if (off >= image_bytes)
+            {
+                step = 2u;
+                off  = 0u;
+            }
+        }
+        else if (step == 2u)
+        {
+            uint16_t m = (uint16_t)((image_bytes - off < chunk) ? image_bytes - off : chunk);
+            h->opcode                      = OTA_CMD_WRITE_DATA;
+            h->length                      = (uint16_t)(sizeof(struct write_data_cmd) + m);
+            h->cmd.write_data.base_address = SIM_IMAGE_SIZE + off;
+            h->cmd.write_data.length       = m;
+            memcpy(&pkt[3u + sizeof(struct write_data_cmd)], &s_image[off], m);
+            len = (uint16_t)(3u + sizeof(struct write_data_cmd) + m);
+            off += m;
+            if (off >= image_bytes)
+            {
+                step = 3u;
+            }
+        }
+        else
+        {
+            len = sim_reboot_pkt(pkt, image_bytes);
+            r->pkts++;
+            sim_device_rx(pkt, len);
+            break;
+        }
+        r->pkts++;
+        sim_device_rx(pkt, len);
+        waiting = true;
+    }
+    r->us = s_busy_until;
+    return sim_check("legacy", image_bytes, resets0, r);
+}
+
+/* ==================== 流式：写命令 + 滑动确认窗口 ==================== */
+
+/*
+ * delta 时推 s_patch（STREAM_START_DELTA）；否则 lz_bits 为 0 时推原镜像，
+ * 不为 0 时推 s_comp，STREAM_START_LZ 里声明解压后 lz_raw 字节。
+ * 收到失败确认时像手机一样放弃传输，直接发 REBOOT（设备不提交，旧镜像照常启动）。
+ */
+static bool sim_stream(const char* name, uint32_t image_bytes, bool delta, uint8_t lz_bits, uint32_t lz_raw,
+                       sim_result_t* r)
+{
+    const uint8_t*  data     = delta ? s_patch : (lz_bits != 0u) ? s_comp : s_image;
+    uint32_t        data_len = delta ? s_patch_len : (lz_bits != 0u) ? s_comp_len : image_bytes;
+    static uint8_t  pkt[SIM_PKT_MAX];
+    static uint32_t tx_ce[0x10000];
+    static uint8_t  need[0x10000];
+    sim_ntf_t       rx[SIM_NTF_MAX];
+    uint32_t        resets0 = host_reset_count();
+    uint32_t        ce      = 0u;
+    uint16_t        hdr     = (uint16_t)(3u + sizeof(struct stream_data_cmd));
+    uint16_t        seg     = (uint16_t)(s_mtu - 3u - hdr);
+    uint32_t        total   = (data_len + seg - 1u) / seg;
+    uint32_t        base = 0u, nxt = 0u, window = 0u, last_ack = 0u;
+    bool            started = false;
+
+    sim_setup();
+    memset(r, 0, sizeof(*r));
+    memset(need, 0, sizeof(need));
+
+    /* STREAM_START / STREAM_START_LZ / STREAM_START_DELTA 是写请求，必达 */
+    {
+        struct app_ota_cmd_hdr_t* h = (struct app_ota_cmd_hdr_t*)pkt;
+        memset(pkt, 0, 32u);
+        if (delta)
+        {
+            h->opcode                        = OTA_CMD_STREAM_START_DELTA;
+            h->length                        = sizeof(struct stream_start_cmd);
+            h->cmd.stream_start.base_address = SIM_IMAGE_SIZE;
+            h->cmd.stream_start.length       = data_len;
+            h->cmd.stream_start.seg          = seg;
+        }
+        else if (lz_bits != 0u)
+        {
+            h->opcode                           = OTA_CMD_STREAM_START_LZ;
+            h->length                           = sizeof(struct stream_start_lz_cmd);
+            h->cmd.stream_start_lz.base_address = SIM_IMAGE_SIZE;
+            h->cmd.stream_start_lz.length       = data_len;
+            h->cmd.stream_start_lz.seg          = seg;
+            h->cmd.stream_start_lz.raw_length   = lz_raw;
+            h->cmd.stream_start_lz.window_bits  = lz_bits;
+        }
+        else
+        {
+            h->opcode                        = OTA_CMD_STREAM_START;
+            h->length                        = sizeof(struct stream_start_cmd);
+            h->cmd.stream_start.base_address = SIM_IMAGE_SIZE;
+            h->cmd.stream_start.length       = data_len;
+            h->cmd.stream_start.seg          = seg;
+        }
+        r->pkts++;
+        sim_device_rx(pkt, (uint16_t)(3u + h->length));
+    }
+
+    while (ce < SIM_CE_LIMIT && base < total && r->bad == 0u)
+    {
+        uint32_t n = sim_next_ce(&ce, r, rx);
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            struct app_ota_rsp_hdr_t* rsp = (struct app_ota_rsp_hdr_t*)rx[i].data;
+            if (rsp->result != OTA_RSP_SUCCESS)
+            {
+                r->bad++;
+                continue;
+            }
+            if (rsp->org_opcode == OTA_CMD_STREAM_START || rsp->org_opcode == OTA_CMD_STREAM_START_LZ ||
+                rsp->org_opcode == OTA_CMD_STREAM_START_DELTA)
+            {
+                window  = rsp->rsp.stream_ack.window;
+                started = true;
+                continue;
+            }
+            if (sim_drop())
+            {
+                r->lost++;
+                continue;
+            }
+
+            /* 累计确认 + 位图：比最高已收序号早、且在上一轮之前发出的缺包马上重发 */
+            uint32_t next   = rsp->rsp.stream_ack.next_seq;
+            uint32_t bitmap = rsp->rsp.stream_ack.bitmap;
+            window          = rsp->rsp.stream_ack.window;
+            if (next > base)
+            {
+                base = next;
+            }
+            if (next == base && bitmap != 0u)
+            {
+                uint32_t high = next + 1u + (31u - (uint32_t)__builtin_clz(bitmap));
+                for (uint32_t s = base; s < high && s < nxt; s++)
+                {
+                    bool got = (s != next) && ((bitmap >> (s - next - 1u)) & 1u);
+                    if (!got && tx_ce[s] < r->ce)
+                    {
+                        need[s] = 1u;
+                    }
+                }
+            }
+            last_ack = r->ce;
+        }
+        if (!started)
+        {
+            continue;
+        }
+
+        /* 超时：重发最早未确认的包，设备回的确认里会带上位图 */
+        if (nxt > base && r->ce - last_ack > SIM_RTO_CE)
+        {
+            need[base] = 1u;
+            last_ack   = r->ce;
+        }
+        /* 窗口为 0（设备还在预擦新镜像区）时开窗的确认丢了就等不到：超时后照发下一包探一下 */
+        else if (nxt == base && window == 0u && r->ce - last_ack > SIM_RTO_CE)
+        {
+            window   = 1u;
+            last_ack = r->ce;
+        }
+
+        uint32_t budget = s_ppce;
+        for (uint32_t s = base; s < nxt && budget != 0u; s++)
+        {
+            if (need[s] == 0u)
+            {
+                continue;
+            }
+            need[s] = 0u;
+            r->retx++;
+            budget--;
+            tx_ce[s] = r->ce;
+            r->pkts++;
+            if (sim_drop())
+            {
+                r->lost++;
+                continue;
+            }
+            uint32_t off = s * seg;
+            uint16_t m   = (uint16_t)((data_len - off < seg) ? data_len - off : seg);
+            struct app_ota_cmd_hdr_t* h = (struct app_ota_cmd_hdr_t*)pkt;
+            h->opcode                   = OTA_CMD_STREAM_DATA;
+            h->length                   = m;
+            h->cmd.stream_data.seq      = (uint16_t)s;
+            memcpy(&pkt[hdr], &data[off], m);
+            sim_device_rx(pkt, (uint16_t)(hdr + m));
+        }
+        while (budget != 0u && nxt < total && nxt < base + window)
+        {
+            uint32_t off = nxt * seg;
+            uint16_t m   = (uint16_t)((data_len - off < seg) ? data_len - off : seg);
+            tx_ce[nxt]   = r->ce;
+            r->pkts++;
+            budget--;
+            if (sim_drop())
+            {
+                r->lost++;
+                nxt++;
+                continue;
+            }
+            struct app_ota_cmd_hdr_t* h = (struct app_ota_cmd_hdr_t*)pkt;
+            h->opcode                   = OTA_CMD_STREAM_DATA;
+            h->length                   = m;
+            h->cmd.stream_data.seq      = (uint16_t)nxt;
+            memcpy(&pkt[hdr], &data[off], m);
+            sim_device_rx(pkt, (uint16_t)(hdr + m));
+            nxt++;
+        }
+        if (s_eager && nxt == total)
+        {
+            base = total;
+        }
+    }
+    if (base < total && r->bad == 0u)
+    {
+        printf("  %s: stalled at packet %u of %u\n", name, (unsigned)base, (unsigned)total);
+        return false;
+    }
+
+    /*
+     * 全部确认（或放弃）：同一个事件里紧跟着发 REBOOT（写请求，必达）。
+     * 差分复制没做完时设备回 BUSY，隔 SIM_BUSY_CE 个事件再发
+     */
+    for (;;)
+    {
+        uint32_t resets = host_reset_count();
+        r->pkts++;
+        sim_device_rx(pkt, sim_reboot_pkt(pkt, image_bytes));
+        if (host_reset_count() != resets || ce >= SIM_CE_LIMIT)
+        {
+            break;
+        }
+        r->busy++;
+        for (uint32_t i = 0; i < SIM_BUSY_CE; i++)
+        {
+            sim_next_ce(&ce, r, rx);
+        }
+    }
+    r->us = s_busy_until;
+    if (r->bad != 0u)
+    {
+        printf("  %s: aborted after an error response at packet %u of %u\n", name, (unsigned)base,
+               (unsigned)total);
+        return false;
+    }
+    return sim_check(name, image_bytes, resets0, r);
+}
+
+/* 坏的压缩流：设备必须回错误确认，REBOOT 时不提交首页（B 区首页仍是擦除态），照常重启一次 */
+static bool sim_stream_lz_bad(uint32_t image_bytes, uint8_t lz_bits)
+{
+    sim_result_t r;
+    uint32_t     resets0 = host_reset_count();
+
+    if (sim_stream("lz-bad", image_bytes, false, lz_bits, image_bytes - 1u, &r) || r.bad == 0u)
+    {
+        printf("  lz-bad: corrupt stream was not rejected\n");
+        return false;
+    }
+    if (memcmp(host_flash_mem() + SIM_IMAGE_SIZE, s_image, 256u) == 0 ||
+        host_reset_count() - resets0 != 1u)
+    {
+        printf("  lz-bad: corrupt image committed (or %u resets)\n",
+               (unsigned)(host_reset_count() - resets0));
+        return false;
+    }
+    return true;
+}
+
+/* 运行区不是补丁的底（A 区中间改一个字节）：补丁头一收齐就回错误确认，不提交首页 */
+static bool sim_stream_delta_bad(uint32_t image_bytes)
+{
+    sim_result_t r;
+    uint32_t     resets0 = host_reset_count();
+    bool         ok      = true;
+
+    s_base[s_base_len / 2u] ^= 0x5Au;
+    if (sim_stream("delta-bad", image_bytes, true, 0u, 0u, &r) || r.bad == 0u)
+    {
+        printf("  delta-bad: patch against a different base image was not rejected\n");
+        ok = false;
+    }
+    else if (memcmp(host_flash_mem() + SIM_IMAGE_SIZE, s_image, 256u) == 0 ||
+             host_reset_count() - resets0 != 1u)
+    {
+        printf("  delta-bad: image committed (or %u resets)\n", (unsigned)(host_reset_count() - resets0));
+        ok = false;
+    }
+    s_base[s_base_len / 2u] ^= 0x5Au;
+    return ok;
+}
+
+/*
+ * 最后一包后面紧跟 REBOOT：复制还没做完，设备必须回 BUSY 而不是在写回调里等，手机重发后照常提交。
+ * 新镜像用运行镜像只改版本号，补丁末尾是一个 100 多 KB 的复制，REBOOT 到达时一定没做完
+ */
+static bool sim_stream_delta_eager(void)
+{
+    static uint8_t img[SIM_IMAGE_SIZE];
+    static uint8_t patch[OTA_DELTA_ENC_BOUND(SIM_IMAGE_SIZE)];
+    uint32_t       patch_len = s_patch_len;
+    uint32_t       loss      = s_loss;
+    uint32_t       version   = 2u;
+    sim_result_t   r;
+    bool           ok;
+
+    memcpy(img, s_image, sizeof(img));
+    memcpy(patch, s_patch, patch_len);
+    memcpy(s_image, s_base, s_base_len);
+    memcpy(&s_image[offsetof(struct jump_table_t, firmware_version)], &version, sizeof(version));
+    s_patch_len = ota_delta_encode(s_base, s_base_len, s_image, s_base_len, s_patch, NULL);
+
+    s_loss  = 0u;
+    s_eager = true;
+    ok      = sim_stream("delta-eager", s_base_len, true, 0u, 0u, &r);
+    s_eager = false;
+    s_loss  = loss;
+    if (ok && r.busy == 0u)
+    {
+        printf("  delta-eager: REBOOT during the rebuild was not answered with BUSY\n");
+        ok = false;
+    }
+
+    memcpy(s_image, img, sizeof(img));
+    memcpy(s_patch, patch, patch_len);
+    s_patch_len = patch_len;
+    return ok;
+}
+
+/* 差分：A 区放 firmware（jump table 改成模拟的镜像区大小、版本 1），新镜像 = 发版模型 */
+static bool sim_make_delta(const char* firmware, uint32_t grow, uint32_t* image_bytes)
+{
+    uint32_t   size = SIM_IMAGE_SIZE, version = 1u, base = 0u;
+    fw_func_t* fns  = (fw_func_t*)malloc(sizeof(fw_func_t) * SIM_MAX_FUNCS);
+    uint32_t   nfns = (fns != NULL) ? fw_image_funcs(firmware, "BleFunc_", fns, SIM_MAX_FUNCS, &base) : 0u;
+
+    if (nfns == 0u || *image_bytes + ((grow + 3u) & ~3u) > SIM_IMAGE_SIZE)
+    {
+        fprintf(stderr, "%s: no BleFunc_* symbols (or the release does not fit a bank)\n", firmware);
+        free(fns);
+        return false;
+    }
+    s_base_len = *image_bytes;
+    memcpy(s_base, s_image, s_base_len);
+    memcpy(&s_base[offsetof(struct jump_table_t, image_size)], &size, sizeof(size));
+    memcpy(&s_base[offsetof(struct jump_table_t, firmware_version)], &version, sizeof(version));
+    *image_bytes = fw_synth_release(s_base, s_base_len, base, fns, nfns, 4u, grow, 7u, s_image);
+    /* 发版模型按板上的 jump table 布局改版本号，主机上编译的 ota.c 看的是主机布局 */
+    version = 2u;
+    memcpy(&s_image[offsetof(struct jump_table_t, firmware_version)], &version, sizeof(version));
+    s_patch_len  = ota_delta_encode(s_base, s_base_len, s_image, *image_bytes, s_patch, NULL);
+    free(fns);
+    return s_patch_len != 0u;
+}
+
+/* ==================== 输出 ==================== */
+
+static void sim_print(const char* name, uint32_t image_bytes, const sim_result_t* r)
+{
+    double s = (double)r->us / 1e6;
+    printf("  %-7s %8.2f %8.2f %7u %7u %6u %6u %6u %6u %5u\n", name, s,
+           (double)image_bytes / 1024.0 / s, (unsigned)r->ce, (unsigned)r->missed,
+           (unsigned)r->pkts, (unsigned)r->retx, (unsigned)r->lost, (unsigned)r->ntf, (unsigned)r->busy);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t     image    = 128u;
+    uint32_t     mtu      = 247u;
+    uint32_t     lz_bits  = OTA_LZ_WINDOW_BITS;
+    int32_t      grow     = -1;
+    const char*  firmware = NULL;
+    sim_result_t legacy, stream, lz, delta;
+    bool         ok = true;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        uint32_t v = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        if (strcmp(argv[i], "--image") == 0)
+            image = v;
+        else if (strcmp(argv[i], "--mtu") == 0)
+            mtu = v;
+        else if (strcmp(argv[i], "--ci-ms") == 0)
+            s_ci_us = v * 1000u;
+        else if (strcmp(argv[i], "--ppce") == 0)
+            s_ppce = v;
+        else if (strcmp(argv[i], "--loss") == 0)
+            s_loss = v;
+        else if (strcmp(argv[i], "--seed") == 0)
+            s_rng = v;
+        else if (strcmp(argv[i], "--lz") == 0)
+            lz_bits = v;
+        else if (strcmp(argv[i], "--delta") == 0)
+            grow = (int32_t)v;
+        else if (strcmp(argv[i], "--firmware") == 0)
+            firmware = argv[i + 1];
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (image < 1u || image * 1024u > SIM_IMAGE_SIZE || mtu < 23u || mtu > 512u || s_ci_us == 0u ||
+        s_ppce == 0u || s_loss >= 100u || (lz_bits != 0u && (lz_bits < OTA_LZ_BITS_MIN || lz_bits > OTA_LZ_WINDOW_BITS)) ||
+        (grow >= 0 && firmware == NULL))
+    {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+    s_mtu = (uint16_t)mtu;
+    host_stubs_reset();
+
+    uint32_t bytes = image * 1024u;
+    if (!sim_make_image(firmware, &bytes) || (grow >= 0 && !sim_make_delta(firmware, (uint32_t)grow, &bytes)))
+    {
+        return 2;
+    }
+    if (lz_bits != 0u)
+    {
+        s_comp_len = ota_lz_encode(s_image, bytes, (uint8_t)lz_bits, s_comp);
+    }
+
+    printf("ota_stream_test: %u byte %s image, MTU %u, CI %u ms, %u packets/CE, loss %u%%\n",
+           (unsigned)bytes, (firmware != NULL) ? "firmware" : "random", (unsigned)mtu,
+           (unsigned)(s_ci_us / 1000u), (unsigned)s_ppce, (unsigned)s_loss);
+    if (lz_bits != 0u)
+    {
+        printf("  lz: %u-byte window, %u -> %u bytes (%.1f%%)\n", 1u << lz_bits, (unsigned)bytes,
+               (unsigned)s_comp_len, 100.0 * s_comp_len / bytes);
+    }
+    if (grow >= 0)
+    {
+        printf("  delta: release grows %u bytes, %u -> %u bytes (%.1f%%)\n", (unsigned)grow, (unsigned)bytes,
+               (unsigned)s_patch_len, 100.0 * s_patch_len / bytes);
+    }
+    ok = sim_legacy(bytes, &legacy) && ok;
+    ok = sim_stream("stream", bytes, false, 0u, 0u, &stream) && ok;
+    if (lz_bits != 0u)
+    {
+        ok = sim_stream("lz", bytes, false, (uint8_t)lz_bits, bytes, &lz) && ok;
+        ok = sim_stream_lz_bad(bytes, (uint8_t)lz_bits) && ok;
+    }
+    if (grow >= 0)
+    {
+        ok = sim_stream("delta", bytes, true, 0u, 0u, &delta) && ok;
+        ok = sim_stream_delta_bad(bytes) && ok;
+        ok = sim_stream_delta_eager() && ok;
+    }
+
+    printf("  mode      time s     KB/s      CE  missed   pkts   retx   lost    ntf  busy\n");
+    sim_print("legacy", bytes, &legacy);
+    sim_print("stream", bytes, &stream);
+    if (lz_bits != 0u)
+    {
+        sim_print("lz", bytes, &lz);
+    }
+    if (grow >= 0)
+    {
+        sim_print("delta", bytes, &delta);
+    }
+    printf("  speedup %.1fx", (double)legacy.us / (double)stream.us);
+    if (lz_bits != 0u)
+    {
+        printf(", lz %.1fx (%.2fx over stream)", (double)legacy.us / (double)lz.us, (double)stream.us / (double)lz.us);
+    }
+    if (grow >= 0)
+    {
+        printf(", delta %.1fx", (double)legacy.us / (double)delta.us);
+    }
+    printf("\n");
+
+    if (s_loss == 0u && stream.us * 2u > legacy.us)
+    {
+        printf("  stream is less than 2x faster than legacy\n");
+        ok = false;
+    }
+    if (s_loss == 0u && lz_bits != 0u && firmware != NULL && lz.us >= stream.us)
+    {
+        printf("  lz is not faster than stream on real firmware\n");
+        ok = false;
+    }
+    if (s_loss == 0u && grow >= 0 && (delta.us >= stream.us || (lz_bits != 0u && delta.us >= lz.us)))
+    {
+        printf("  delta is not faster than stream / lz\n");
+        ok = false;
+    }
+    host_set_ota_rsp_hook(NULL);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,424 @@
+/*********************************************************************
+ * @file param_sync_replay.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 参数同步回放：MCU 0x0208 上报序列 -> 0x64FD/0x67FD 空口字节数 + App 侧一致性
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 流程（每种模式各跑一遍，语料相同）：
+ * - --conns 个连接用 AES 帧走完整 0x01FE 鉴权（真实 ble_function 路径）；
+ * - 按 --seed 生成 --updates 次 MCU 0x0208 上报：约 40% 无变化（周期重报）、
+ *   45% 改 1 个字段、10% 改 RGB 三元组、5% 大批量（切模式，改 20 个字段）；
+ *   每 --reauth 次让最后一个连接重新鉴权一次（验证首次同步走全量）；
+ * - Notify 桩里解密 0x64FD/0x67FD，套到每个连接的“App 镜像”上。
+ *
+ * 正确性：每次上报后所有连接的 App 镜像必须等于 MCU 最新参数；增量模式下
+ * App 回 0x6702 拒绝后该连接必须退回 0x64FD。任何一项不满足返回 1。
+ * 字节数/AES 分组数只打印不判定。
+ *
+ * 用法：param_sync_replay [--updates N] [--seed S] [--conns K] [--reauth N]
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "en_de_algo.h"
+#include "host_stubs.h"
+#include "param_sync.h"
+#include "protocol.h"
+#include "protocol_cmd.h"
+#include "rssi_check.h"
+
+#define REPLAY_FIELDS       34u
+#define REPLAY_MCU_LEN      43u /* 0x0208 数据段：34 个字段 + 保留字节 */
+#define REPLAY_FRAME_MAX    256u
+#define REPLAY_CONN_MAX     3u
+#define REPLAY_DEFAULT_N    5000u
+#define REPLAY_DEFAULT_SEED 0x5EEDu
+
+/* 与 protocol.c 的 s_default_aes_key 一致（App 侧同一把 Key） */
+static const uint8_t s_aes_key[16] = {'Q', 'S', 'D', 'f', 'a', 'g', 'Q', '1',
+                                      '4', '1', 'G', 'S', '6', 'J', 'F', '8'};
+
+typedef struct
+{
+    uint8_t val[REPLAY_FIELDS];
+    bool    synced; /* 收到过完整 0x64FD */
+} replay_app_t;
+
+typedef struct
+{
+    uint64_t frames_full;
+    uint64_t frames_delta;
+    uint64_t air_bytes;  /* 0x64FD/0x67FD 整帧字节（含帧头帧尾） */
+    uint64_t aes_blocks; /* 加密分组数 */
+    uint32_t errors;
+} replay_stats_t;
+
+static replay_app_t   s_app[REPLAY_CONN_MAX];
+static replay_stats_t s_stats;
+static uint8_t        s_mcu[REPLAY_FIELDS];
+static uint32_t       s_rng;
+
+static uint32_t replay_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return (s_rng >> 8) & 0xFFFFFFu;
+}
+
+/* ==================== App -> 设备帧 ==================== */
+static uint16_t replay_build_frame(uint8_t        seq,
+                                   uint16_t       cmd,
+                                   const uint8_t* plain,
+                                   uint16_t       plain_len,
+                                   uint8_t*       out)
+{
+    uint8_t        body[REPLAY_FRAME_MAX];
+    uint16_t       body_len;
+    Algo_Context_t ctx;
+
+    memcpy(body, plain, plain_len);
+    Algo_Bind(&ctx, ALGO_TYPE_AES_CBC);
+    Algo_SetKeyIV(&ctx, s_aes_key, NULL);
+    body_len = (uint16_t)Algo_Padding(body, plain_len, 16u);
+    Algo_Encrypt(&ctx, body, body_len, body);
+
+    uint16_t i = 0;
+    out[i++]   = 0x55;
+    out[i++]   = 0x55;
+    out[i++]   = (uint8_t)(body_len + 10u);
+    out[i++]   = CRYPTO_TYPE_AES128;
+    out[i++]   = seq;
+    out[i++]   = (uint8_t)(cmd >> 8);
+    out[i++]   = (uint8_t)(cmd & 0xFFu);
+    memcpy(&out[i], body, body_len);
+    i = (uint16_t)(i + body_len);
+
+    uint8_t bcc = 0;
+    for (uint16_t k = 0; k < i; k++)
+    {
+        bcc ^= out[k];
+    }
+    out[i++] = bcc;
+    out[i++] = 0xAA;
+    out[i++] = 0xAA;
+    return i;
+}
+
+static void replay_app_send(uint8_t conidx, uint16_t cmd, const uint8_t* plain, uint16_t len)
+{
+    static uint8_t seq = 0;
+    uint8_t        frame[REPLAY_FRAME_MAX];
+    uint16_t       n = replay_build_frame(++seq, cmd, plain, len, frame);
+
+    Protocol_Handle_Data(conidx, frame, n);
+    host_run_idle();
+}
+
+static void replay_auth(uint8_t conidx)
+{
+    static const uint8_t s_time6[6] = {0x1A, 0x01, 0x06, 0x11, 0x0E, 0x15};
+    uint8_t              connect[39];
+
+    Protocol_Auth_Clear(conidx);
+    memset(&s_app[conidx], 0, sizeof(s_app[conidx]));
+
+    memcpy(&connect[0], s_time6, 6);
+    memcpy(&connect[6], "6F35E30C05DBE6D747EB938DF71863D1", 32);
+    connect[38] = 0x01; /* mobileSystem: android */
+    replay_app_send(conidx, connect_ID, connect, sizeof(connect));
+    if (!Protocol_Auth_IsOk(conidx))
+    {
+        fprintf(stderr, "param_sync_replay: conidx %u auth failed\n", (unsigned)conidx);
+        s_stats.errors++;
+    }
+}
+
+/* ==================== 设备 -> App：解密并套到镜像上 ==================== */
+static void replay_ntf_hook(uint8_t conidx, uint8_t att_idx, const uint8_t* data, uint16_t len)
+{
+    (void)att_idx;
+    if (len < 10u || conidx >= REPLAY_CONN_MAX)
+    {
+        return;
+    }
+
+    uint16_t cmd = (uint16_t)(((uint16_t)data[5] << 8) | data[6]);
+    if (cmd != paramter_synchronize && cmd != paramter_synchronize_delta)
+    {
+        return;
+    }
+
+    uint8_t        plain[REPLAY_FRAME_MAX];
+    uint16_t       cipher_len = (uint16_t)(len - 10u);
+    Algo_Context_t ctx;
+    replay_app_t*  app = &s_app[conidx];
+
+    s_stats.air_bytes += len;
+    s_stats.aes_blocks += cipher_len / 16u;
+    if (data[3] != CRYPTO_TYPE_AES128 || cipher_len == 0u || (cipher_len % 16u) != 0u)
+    {
+        s_stats.errors++;
+        return;
+    }
+    Algo_Bind(&ctx, ALGO_TYPE_AES_CBC);
+    Algo_SetKeyIV(&ctx, s_aes_key, NULL);
+    Algo_Decrypt(&ctx, &data[7], cipher_len, plain);
+
+    uint8_t pad = plain[cipher_len - 1u];
+    if (pad == 0u || pad > 16u)
+    {
+        s_stats.errors++;
+        return;
+    }
+    uint16_t plain_len = (uint16_t)(cipher_len - pad);
+
+    if (cmd == paramter_synchronize)
+    {
+        s_stats.frames_full++;
+        if (plain_len != REPLAY_FIELDS)
+        {
+            s_stats.errors++;
+            return;
+        }
+        memcpy(app->val, plain, REPLAY_FIELDS);
+        app->synced = true;
+        return;
+    }
+
+    /* 0x67FD：version + count + {index, value}*count，必须叠在全量快照之上 */
+    s_stats.frames_delta++;
+    if (!app->synced || plain_len < 2u || plain_len != (uint16_t)(2u + 2u * plain[1]))
+    {
+        s_stats.errors++;
+        return;
+    }
+    for (uint16_t k = 2u; k < plain_len; k += 2u)
+    {
+        if (plain[k] >= REPLAY_FIELDS)
+        {
+            s_stats.errors++;
+            return;
+        }
+        app->val[plain[k]] = plain[k + 1u];
+    }
+}
+
+/* ==================== MCU 0x0208 语料 ==================== */
+static void replay_mcu_step(void)
+{
+    uint32_t r = replay_rand() % 100u;
+
+    if (r < 40u)
+    {
+        /* 周期重报，没有变化 */
+    }
+    else if (r < 85u)
+    {
+        s_mcu[replay_rand() % REPLAY_FIELDS] = (uint8_t)replay_rand();
+    }
+    else if (r < 95u)
+    {
+        /* RGB 三元组（常亮/呼吸/跑马灯各占连续 3 个字段，起始下标 11/14/17） */
+        uint32_t base = 11u + 3u * (replay_rand() % 3u);
+        for (uint32_t k = 0; k < 3u; k++)
+        {
+            s_mcu[base + k] = (uint8_t)replay_rand();
+        }
+    }
+    else
+    {
+        for (uint32_t k = 0; k < 20u; k++)
+        {
+            s_mcu[(k * 7u + replay_rand()) % REPLAY_FIELDS] ^= 0x5Au;
+        }
+    }
+
+    uint8_t  payload[REPLAY_MCU_LEN + 2u];
+    uint16_t off = 0u;
+    memset(payload, 0, sizeof(payload));
+    /* 偶尔带 2 字节前缀（ParamSync_Update64FD 兼容的另一种长度） */
+    if ((replay_rand() & 7u) == 0u)
+    {
+        off = 2u;
+    }
+    memcpy(&payload[off], s_mcu, REPLAY_FIELDS);
+    ParamSync_OnMcuSync64FD(payload, (uint16_t)(REPLAY_MCU_LEN + off));
+}
+
+static void replay_check(uint8_t conns, uint32_t step)
+{
+    for (uint8_t c = 0; c < conns; c++)
+    {
+        if (!s_app[c].synced || memcmp(s_app[c].val, s_mcu, REPLAY_FIELDS) != 0)
+        {
+            if (s_stats.errors < 5u)
+            {
+                fprintf(stderr, "param_sync_replay: conidx %u out of sync at update %u\n",
+                        (unsigned)c, (unsigned)step);
+            }
+            s_stats.errors++;
+        }
+    }
+}
+
+static void replay_session(uint8_t conns)
+{
+    host_stubs_reset();
+    host_set_ntf_hook(replay_ntf_hook);
+    Protocol_Init();
+    RSSI_Check_Init();
+    for (uint8_t c = 0; c < conns; c++)
+    {
+        static const uint8_t peer[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+        host_gap_set_connected(c, true);
+        Protocol_Auth_Clear(c); /* 上一轮的鉴权状态不能带进来 */
+        RSSI_Check_Enable(c, NULL);
+        RSSI_Check_Set_Peer_Addr(c, peer);
+    }
+}
+
+static replay_stats_t replay_run(bool delta, uint32_t updates, uint32_t seed, uint8_t conns,
+                                 uint32_t reauth)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_rng = seed;
+    for (uint32_t k = 0; k < REPLAY_FIELDS; k++)
+    {
+        s_mcu[k] = (uint8_t)replay_rand();
+    }
+
+    replay_session(conns);
+    ParamSync_SetDeltaMode(delta);
+    /* MCU 上电先报一次，连接鉴权后立即拿到全量 */
+    replay_mcu_step();
+    for (uint8_t c = 0; c < conns; c++)
+    {
+        replay_auth(c);
+    }
+    replay_check(conns, 0u);
+
+    /* 只统计稳态推送，鉴权阶段的快照不计入 */
+    replay_stats_t base = s_stats;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.errors = base.errors;
+
+    for (uint32_t i = 1; i <= updates; i++)
+    {
+        if (reauth > 0u && (i % reauth) == 0u)
+        {
+            replay_auth((uint8_t)(conns - 1u));
+        }
+        replay_mcu_step();
+        replay_check(conns, i);
+    }
+    return s_stats;
+}
+
+/* App 回 0x6702 rc!=0：该连接立即收到全量，之后只收 0x64FD */
+static uint32_t replay_reject_check(uint8_t conns)
+{
+    static const uint8_t s_reject[1] = {0x01};
+    uint8_t              c           = (uint8_t)(conns - 1u);
+    uint32_t             errors      = 0u;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    replay_app_send(c, 0x6702u, s_reject, sizeof(s_reject));
+    if (s_stats.frames_full != 1u)
+    {
+        errors++;
+    }
+    s_mcu[3] ^= 0x01u;
+    memset(&s_stats, 0, sizeof(s_stats));
+    ParamSync_OnMcuSync64FD(s_mcu, REPLAY_MCU_LEN);
+    /* 其他连接仍是增量，被拒绝的连接是全量 */
+    if (s_stats.frames_full != 1u || s_stats.frames_delta != (uint64_t)(conns - 1u))
+    {
+        errors++;
+    }
+    replay_check(conns, 0u);
+    errors += s_stats.errors;
+    if (errors != 0u)
+    {
+        fprintf(stderr, "param_sync_replay: 0x6702 fallback check failed\n");
+    }
+    return errors;
+}
+
+static void replay_print(const char* name, const replay_stats_t* s, uint32_t updates)
+{
+    printf("  %-6s: %6llu x 0x64FD %6llu x 0x67FD  %8llu B on air  %7llu AES blocks"
+           "  %6.1f B/update\n",
+           name,
+           (unsigned long long)s->frames_full,
+           (unsigned long long)s->frames_delta,
+           (unsigned long long)s->air_bytes,
+           (unsigned long long)s->aes_blocks,
+           (double)s->air_bytes / (double)updates);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t updates = REPLAY_DEFAULT_N;
+    uint32_t seed    = REPLAY_DEFAULT_SEED;
+    uint32_t conns   = 2u;
+    uint32_t reauth  = 1000u;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--updates") == 0 && i + 1 < argc)
+        {
+            updates = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--conns") == 0 && i + 1 < argc)
+        {
+            conns = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--reauth") == 0 && i + 1 < argc)
+        {
+            reauth = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr,
+                    "usage: %s [--updates N] [--seed S] [--conns K] [--reauth N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (updates == 0u)
+    {
+        updates = 1u;
+    }
+    if (conns == 0u || conns > REPLAY_CONN_MAX)
+    {
+        conns = 2u;
+    }
+
+    printf("param_sync_replay (%u updates, %u conns, seed 0x%X, reauth every %u):\n",
+           (unsigned)updates, (unsigned)conns, (unsigned)seed, (unsigned)reauth);
+
+    replay_stats_t full  = replay_run(false, updates, seed, (uint8_t)conns, reauth);
+    replay_print("full", &full, updates);
+    replay_stats_t delta = replay_run(true, updates, seed, (uint8_t)conns, reauth);
+    replay_print("delta", &delta, updates);
+    uint32_t reject = replay_reject_check((uint8_t)conns);
+
+    if (delta.air_bytes > 0u && delta.aes_blocks > 0u)
+    {
+        printf("  delta vs full: %.2fx fewer bytes, %.2fx fewer AES blocks\n",
+               (double)full.air_bytes / (double)delta.air_bytes,
+               (double)full.aes_blocks / (double)delta.aes_blocks);
+    }
+
+    int fail = (full.errors != 0u || delta.errors != 0u || reject != 0u);
+    printf("param_sync_replay: %s\n", fail ? "FAIL" : "OK");
+    return fail;
+}
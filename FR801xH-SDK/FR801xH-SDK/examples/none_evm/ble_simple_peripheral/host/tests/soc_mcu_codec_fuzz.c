@@ -0,0 +1,526 @@
+/*********************************************************************
+ * @file soc_mcu_codec_fuzz.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief soc_mcu_codec.h 的 fuzz 目标：流式解码 vs 朴素参考解析器差分 + 编解码回环
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 每个输入做三件事：
+ * 1) 整段交给朴素参考解析器（一次看完整缓冲、按字节下标直接判断），得到期望事件序列；
+ * 2) 按输入派生的随机切分（1..N 字节）喂给 soc_mcu_dec_feed，attach / 不 attach 各一遍，
+ *    事件序列（类型 + feature/id/data/crc_ok）必须与 1) 完全一致；
+ * 3) 每个交付的帧再用 soc_mcu_encode 重新编码，crc_ok 时必须与原始字节逐字节相同。
+ * 任何不一致直接 abort()，配合 -fsanitize=address,undefined 兜住越界。
+ *
+ * 本机没有 clang，main() 是自带的随机/变异驱动：
+ * - 合法帧拼接（编码 -> 任意切分解码，必须一帧不差）；
+ * - 合法帧 + 翻位 / 截断 / 插入 / 纯随机垃圾。
+ * 定义 SOC_MCU_FUZZ_LIBFUZZER 后去掉 main，可直接用 clang -fsanitize=fuzzer 链接。
+ *
+ * 用法：soc_mcu_codec_fuzz [--iters N] [--seed S] [FILE...]
+ *       （给出 FILE 时只回放这些输入，用于复现）
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "soc_mcu_codec.h"
+
+#define FUZZ_DEFAULT_ITERS 20000u
+#define FUZZ_MAX_INPUT     4096u
+#define FUZZ_MAX_EVENTS    (FUZZ_MAX_INPUT + 1u)
+
+typedef struct
+{
+    uint8_t  ev; /**< soc_mcu_dec_ev_t（不含 NEED_MORE / HDR_OK） */
+    uint8_t  sync;
+    bool     crc_ok;
+    uint16_t feature;
+    uint16_t id;
+    uint16_t data_len;
+    uint32_t off; /**< 帧在输入中的起始偏移（只对 FRAME 有效） */
+} fuzz_event_t;
+
+static fuzz_event_t s_ref[FUZZ_MAX_EVENTS];
+static fuzz_event_t s_got[FUZZ_MAX_EVENTS];
+
+#define FUZZ_CHECK(cond)                                                              \
+    do                                                                                \
+    {                                                                                 \
+        if (!(cond))                                                                  \
+        {                                                                             \
+            fprintf(stderr, "soc_mcu_codec_fuzz: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            abort();                                                                  \
+        }                                                                             \
+    } while (0)
+
+/* xorshift32：切分与变异都从它来，同一 seed 可复现 */
+static uint32_t fuzz_rand(uint32_t* s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+static uint16_t fuzz_be16(const uint8_t* p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+/* ==================== 朴素参考解析器 ==================== */
+
+/*
+ * 语义与解码器约定一致，但完全不做流式：
+ * - 非 head 字节跳过；
+ * - sync 非法：计 ERR_SYNC，若该字节本身是 head 则从它重新开始；
+ * - len 非法：计 ERR_LEN，丢掉 head..len 这 4 个字节；
+ * - 按长度取满后 end 不对：计 ERR_END，整帧丢掉（不回退重找 head）；
+ * - 输入末尾不完整的帧不产生事件。
+ */
+static uint32_t fuzz_reference(const uint8_t* in, uint32_t n, fuzz_event_t* ev)
+{
+    uint32_t cnt = 0u;
+    uint32_t i   = 0u;
+
+    while (i < n)
+    {
+        if (in[i] != SOC_MCU_FRAME_HEAD)
+        {
+            i++;
+            continue;
+        }
+        if (i + 1u >= n)
+        {
+            break;
+        }
+        uint8_t sync = in[i + 1u];
+        if (sync != SOC_MCU_SYNC_SOC_TO_MCU && sync != SOC_MCU_SYNC_MCU_TO_SOC)
+        {
+            memset(&ev[cnt], 0, sizeof(ev[cnt]));
+            ev[cnt++].ev = SOC_MCU_DEC_ERR_SYNC;
+            i            = (sync == SOC_MCU_FRAME_HEAD) ? (i + 1u) : (i + 2u);
+            continue;
+        }
+        if (i + 3u >= n)
+        {
+            break;
+        }
+        uint16_t len_field = fuzz_be16(&in[i + 2u]);
+        if (len_field < 4u || len_field > SOC_MCU_FRAME_MAX_LEN - SOC_MCU_DATA_OFF - SOC_MCU_TAIL_LEN + 4u)
+        {
+            memset(&ev[cnt], 0, sizeof(ev[cnt]));
+            ev[cnt++].ev = SOC_MCU_DEC_ERR_LEN;
+            i += 4u;
+            continue;
+        }
+        uint32_t data_len = (uint32_t)len_field - 4u;
+        uint32_t total    = 8u + data_len + SOC_MCU_CRC_LEN + 2u;
+        if (i + total > n)
+        {
+            break;
+        }
+
+        const uint8_t* f   = &in[i];
+        const uint8_t* chk = &f[8u + data_len];
+        memset(&ev[cnt], 0, sizeof(ev[cnt]));
+        if (chk[SOC_MCU_CRC_LEN] != 0x0Au || chk[SOC_MCU_CRC_LEN + 1u] != 0x0Du)
+        {
+            ev[cnt++].ev = SOC_MCU_DEC_ERR_END;
+            i += total;
+            continue;
+        }
+
+        /* 校验也按定义逐位重算，不复用 codec 的查表实现 */
+#if SOC_MCU_USE_CRC16
+        uint16_t crc = 0xFFFFu;
+        for (uint32_t k = 4u; k < 8u + data_len; k++)
+        {
+            crc ^= (uint16_t)((uint16_t)f[k] << 8);
+            for (int b = 0; b < 8; b++)
+            {
+                crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+            }
+        }
+        bool crc_ok = (crc == fuzz_be16(chk));
+#else
+        uint8_t sum = 0u;
+        for (uint32_t k = 4u; k < 8u + data_len + 1u; k++)
+        {
+            sum = (uint8_t)(sum + f[k]);
+        }
+        bool crc_ok = (sum == 0u);
+#endif
+        ev[cnt].ev       = SOC_MCU_DEC_FRAME;
+        ev[cnt].sync     = sync;
+        ev[cnt].crc_ok   = crc_ok;
+        ev[cnt].feature  = fuzz_be16(&f[4]);
+        ev[cnt].id       = fuzz_be16(&f[6]);
+        ev[cnt].data_len = (uint16_t)data_len;
+        ev[cnt].off      = i;
+        cnt++;
+        i += total;
+    }
+    return cnt;
+}
+
+/* ==================== 被测：流式解码 ==================== */
+
+static uint32_t fuzz_stream(const uint8_t* in, uint32_t n, uint32_t seed, bool attach, fuzz_event_t* ev)
+{
+    static uint8_t  buf[SOC_MCU_FRAME_MAX_LEN];
+    soc_mcu_dec_t   dec;
+    soc_mcu_frame_t fr;
+    uint32_t        cnt = 0u;
+    uint32_t        pos = 0u;
+    uint32_t        start = 0u; /* 当前帧 head 的偏移 */
+    uint32_t        rng = seed | 1u;
+
+    memset(&dec, 0, sizeof(dec));
+    soc_mcu_dec_reset(&dec);
+    while (pos < n)
+    {
+        /* 切分：多数小块（模拟 FIFO 水位），偶尔整块 */
+        uint32_t r     = fuzz_rand(&rng);
+        uint32_t chunk = ((r & 7u) == 0u) ? (n - pos) : (1u + (r >> 8) % 24u);
+        if (chunk > n - pos)
+        {
+            chunk = n - pos;
+        }
+
+        const uint8_t* p   = &in[pos];
+        uint16_t       len = (uint16_t)chunk;
+        while (len > 0u)
+        {
+            soc_mcu_dec_ev_t e;
+            bool             was_idle = !soc_mcu_dec_busy(&dec);
+            uint16_t         used     = soc_mcu_dec_feed(&dec, p, len, &e, &fr);
+
+            FUZZ_CHECK(used > 0u && used <= len);
+            if (was_idle && soc_mcu_dec_busy(&dec))
+            {
+                /* 本次从 IDLE 进入帧：head 是本段里最后一个被消耗的 head 之前的位置 */
+                const uint8_t* h = (const uint8_t*)memchr(p, SOC_MCU_FRAME_HEAD, used);
+                FUZZ_CHECK(h != NULL);
+                start = (uint32_t)(h - in);
+            }
+            switch (e)
+            {
+                case SOC_MCU_DEC_NEED_MORE:
+                    FUZZ_CHECK(used == len);
+                    break;
+                case SOC_MCU_DEC_HDR_OK:
+                    FUZZ_CHECK(soc_mcu_dec_busy(&dec));
+                    if (attach)
+                    {
+                        soc_mcu_dec_attach(&dec, buf);
+                    }
+                    break;
+                case SOC_MCU_DEC_FRAME:
+                    FUZZ_CHECK(cnt < FUZZ_MAX_EVENTS);
+                    FUZZ_CHECK(!soc_mcu_dec_busy(&dec));
+                    FUZZ_CHECK(fr.len == SOC_MCU_FRAME_LEN(fr.data_len));
+                    FUZZ_CHECK((fr.frame != NULL) == attach);
+                    if (attach)
+                    {
+                        /* 缓冲里的整帧必须与输入原样一致 */
+                        FUZZ_CHECK(fr.data == fr.frame + SOC_MCU_DATA_OFF);
+                        FUZZ_CHECK(start + fr.len <= n);
+                        FUZZ_CHECK(memcmp(fr.frame, &in[start], fr.len) == 0);
+                    }
+                    memset(&ev[cnt], 0, sizeof(ev[cnt]));
+                    ev[cnt].ev       = SOC_MCU_DEC_FRAME;
+                    ev[cnt].sync     = fr.sync;
+                    ev[cnt].crc_ok   = fr.crc_ok;
+                    ev[cnt].feature  = fr.feature;
+                    ev[cnt].id       = fr.id;
+                    ev[cnt].data_len = fr.data_len;
+                    ev[cnt].off      = start;
+                    cnt++;
+                    break;
+                default:
+                    FUZZ_CHECK(cnt < FUZZ_MAX_EVENTS);
+                    memset(&ev[cnt], 0, sizeof(ev[cnt]));
+                    ev[cnt++].ev = (uint8_t)e;
+                    if (e == SOC_MCU_DEC_ERR_SYNC && soc_mcu_dec_busy(&dec))
+                    {
+                        /* sync 字节本身是 head，解码器已从它重新开始 */
+                        start = (uint32_t)(&p[used - 1u] - in);
+                    }
+                    break;
+            }
+            p  += used;
+            len = (uint16_t)(len - used);
+        }
+        pos += chunk;
+    }
+    return cnt;
+}
+
+/* 交付的帧用编码器重编一次：crc_ok 时必须逐字节相同 */
+static void fuzz_reencode(const uint8_t* in, const fuzz_event_t* e)
+{
+    uint8_t  out[SOC_MCU_FRAME_MAX_LEN];
+    uint16_t n = soc_mcu_encode(e->sync, e->feature, e->id, &in[e->off + SOC_MCU_DATA_OFF],
+                                e->data_len, out, (uint16_t)sizeof(out));
+
+    FUZZ_CHECK(n == SOC_MCU_FRAME_LEN(e->data_len));
+    if (e->crc_ok)
+    {
+        FUZZ_CHECK(memcmp(out, &in[e->off], n) == 0);
+    }
+    else
+    {
+        FUZZ_CHECK(memcmp(out, &in[e->off], SOC_MCU_DATA_OFF + e->data_len) == 0);
+        FUZZ_CHECK(memcmp(&out[SOC_MCU_DATA_OFF + e->data_len],
+                          &in[e->off + SOC_MCU_DATA_OFF + e->data_len], SOC_MCU_CRC_LEN) != 0);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (size > FUZZ_MAX_INPUT)
+    {
+        size = FUZZ_MAX_INPUT;
+    }
+    uint32_t n    = (uint32_t)size;
+    uint32_t seed = 0x9E3779B9u ^ n;
+    for (uint32_t i = 0; i < n && i < 16u; i++)
+    {
+        seed = seed * 31u + data[i];
+    }
+
+    uint32_t n_ref = fuzz_reference(data, n, s_ref);
+    for (int attach = 0; attach < 2; attach++)
+    {
+        uint32_t n_got = fuzz_stream(data, n, seed + (uint32_t)attach, attach != 0, s_got);
+        FUZZ_CHECK(n_got == n_ref);
+        for (uint32_t i = 0; i < n_ref; i++)
+        {
+            FUZZ_CHECK(memcmp(&s_got[i], &s_ref[i], sizeof(s_ref[i])) == 0);
+        }
+    }
+    for (uint32_t i = 0; i < n_ref; i++)
+    {
+        if (s_ref[i].ev == SOC_MCU_DEC_FRAME)
+        {
+            fuzz_reencode(data, &s_ref[i]);
+        }
+    }
+    return 0;
+}
+
+#ifndef SOC_MCU_FUZZ_LIBFUZZER
+
+/* ==================== 自带驱动 ==================== */
+
+static uint8_t s_input[FUZZ_MAX_INPUT];
+
+/* 追加一帧随机合法帧，返回写入长度（空间不足返回 0） */
+static uint32_t fuzz_gen_frame(uint32_t* rng, uint8_t* out, uint32_t room)
+{
+    uint8_t  data[SOC_MCU_DATA_MAX];
+    uint32_t r        = fuzz_rand(rng);
+    uint16_t data_len = (uint16_t)(((r & 3u) == 0u) ? (r >> 8) % (SOC_MCU_DATA_MAX + 1u) : (r >> 8) % 41u);
+
+    for (uint16_t i = 0; i < data_len; i++)
+    {
+        data[i] = (uint8_t)fuzz_rand(rng);
+    }
+    r = fuzz_rand(rng);
+    return soc_mcu_encode((r & 1u) ? SOC_MCU_SYNC_SOC_TO_MCU : SOC_MCU_SYNC_MCU_TO_SOC,
+                          (uint16_t)(r >> 1), (uint16_t)fuzz_rand(rng), data, data_len, out,
+                          (uint16_t)((room > 0xFFFFu) ? 0xFFFFu : room));
+}
+
+/* 全是合法帧：任意切分下必须一帧不差地解出来 */
+static void fuzz_roundtrip(uint32_t* rng)
+{
+    uint32_t n      = 0u;
+    uint32_t frames = 0u;
+    for (;;)
+    {
+        uint32_t w = fuzz_gen_frame(rng, &s_input[n], FUZZ_MAX_INPUT - n);
+        if (w == 0u || frames >= 32u)
+        {
+            break;
+        }
+        n += w;
+        frames++;
+    }
+
+    LLVMFuzzerTestOneInput(s_input, n);
+    uint32_t cnt = fuzz_reference(s_input, n, s_ref);
+    FUZZ_CHECK(cnt == frames);
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        FUZZ_CHECK(s_ref[i].ev == SOC_MCU_DEC_FRAME && s_ref[i].crc_ok);
+    }
+}
+
+/* 合法帧 + 噪声，再做翻位 / 截断 / 插入 */
+static void fuzz_mutate(uint32_t* rng)
+{
+    uint32_t n = 0u;
+    uint32_t k = 1u + fuzz_rand(rng) % 12u;
+
+    for (uint32_t f = 0; f < k && n < FUZZ_MAX_INPUT; f++)
+    {
+        uint32_t r = fuzz_rand(rng);
+        if ((r & 3u) == 0u)
+        {
+            /* 噪声，刻意多放 head/sync/end 字节 */
+            static const uint8_t s_magic[] = {0xFE, 0xAB, 0xBA, 0x0A, 0x0D, 0x00, 0xFF};
+            uint32_t             g         = 1u + (r >> 4) % 16u;
+            for (uint32_t i = 0; i < g && n < FUZZ_MAX_INPUT; i++)
+            {
+                uint32_t b  = fuzz_rand(rng);
+                s_input[n++] = (b & 1u) ? s_magic[(b >> 1) % sizeof(s_magic)] : (uint8_t)(b >> 8);
+            }
+        }
+        else
+        {
+            n += fuzz_gen_frame(rng, &s_input[n], FUZZ_MAX_INPUT - n);
+        }
+    }
+
+    uint32_t m = fuzz_rand(rng) % 6u;
+    for (uint32_t i = 0; i < m && n > 0u; i++)
+    {
+        uint32_t r   = fuzz_rand(rng);
+        uint32_t pos = (r >> 3) % n;
+        switch (r & 3u)
+        {
+            case 0: /* 翻位 */
+                s_input[pos] ^= (uint8_t)(1u << ((r >> 16) & 7u));
+                break;
+            case 1: /* 截断 */
+                n = pos + 1u;
+                break;
+            case 2: /* 删除一个字节 */
+                memmove(&s_input[pos], &s_input[pos + 1u], n - pos - 1u);
+                n--;
+                break;
+            default: /* 插入一个字节 */
+                if (n < FUZZ_MAX_INPUT)
+                {
+                    memmove(&s_input[pos + 1u], &s_input[pos], n - pos);
+                    s_input[pos] = (uint8_t)(r >> 16);
+                    n++;
+                }
+                break;
+        }
+    }
+    LLVMFuzzerTestOneInput(s_input, n);
+}
+
+/* 纯随机字节 */
+static void fuzz_garbage(uint32_t* rng)
+{
+    uint32_t n = fuzz_rand(rng) % 512u;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        s_input[i] = (uint8_t)fuzz_rand(rng);
+    }
+    LLVMFuzzerTestOneInput(s_input, n);
+}
+
+/* 编码器边界：超长、容量不足、data 为空 */
+static void fuzz_encoder_limits(void)
+{
+    uint8_t out[SOC_MCU_FRAME_MAX_LEN];
+    uint8_t data[SOC_MCU_DATA_MAX + 1u];
+
+    memset(data, 0x5A, sizeof(data));
+    FUZZ_CHECK(soc_mcu_encode(SOC_MCU_SYNC_SOC_TO_MCU, 1u, 2u, data, SOC_MCU_DATA_MAX, out,
+                              sizeof(out)) == SOC_MCU_FRAME_MAX_LEN);
+    FUZZ_CHECK(soc_mcu_encode(SOC_MCU_SYNC_SOC_TO_MCU, 1u, 2u, data, SOC_MCU_DATA_MAX + 1u, out,
+                              sizeof(out)) == 0u);
+    FUZZ_CHECK(soc_mcu_encode(SOC_MCU_SYNC_SOC_TO_MCU, 1u, 2u, data, 10u, out,
+                              SOC_MCU_FRAME_LEN(10u) - 1u) == 0u);
+    FUZZ_CHECK(soc_mcu_encode(SOC_MCU_SYNC_SOC_TO_MCU, 1u, 2u, NULL, 1u, out, sizeof(out)) == 0u);
+    FUZZ_CHECK(soc_mcu_encode(SOC_MCU_SYNC_SOC_TO_MCU, 1u, 2u, NULL, 0u, out, sizeof(out)) ==
+               SOC_MCU_FRAME_LEN(0u));
+
+#if SOC_MCU_USE_CRC16
+    /* CRC16-CCITT/FALSE 标准校验值 */
+    FUZZ_CHECK(soc_mcu_checksum((const uint8_t*)"123456789", 9u) == 0x29B1u);
+#endif
+}
+
+static int fuzz_replay(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "soc_mcu_codec_fuzz: cannot open %s\n", path);
+        return 1;
+    }
+    size_t n = fread(s_input, 1, sizeof(s_input), f);
+    fclose(f);
+    LLVMFuzzerTestOneInput(s_input, n);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t iters  = FUZZ_DEFAULT_ITERS;
+    uint32_t seed   = 0x1234567u;
+    int      files  = 0;
+    int      fail   = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc)
+        {
+            iters = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "usage: %s [--iters N] [--seed S] [FILE...]\n", argv[0]);
+            return 2;
+        }
+        else
+        {
+            fail |= fuzz_replay(argv[i]);
+            files++;
+        }
+    }
+    if (files > 0)
+    {
+        return fail;
+    }
+
+    uint32_t rng = seed ? seed : 1u;
+    fuzz_encoder_limits();
+    for (uint32_t it = 0; it < iters; it++)
+    {
+        switch (it % 4u)
+        {
+            case 0:
+                fuzz_roundtrip(&rng);
+                break;
+            case 3:
+                fuzz_garbage(&rng);
+                break;
+            default:
+                fuzz_mutate(&rng);
+                break;
+        }
+    }
+    printf("soc_mcu_codec_fuzz (%s): %u iterations, seed 0x%08X: OK\n",
+           SOC_MCU_USE_CRC16 ? "crc16" : "sum8", (unsigned)iters, (unsigned)seed);
+    return 0;
+}
+
+#endif // SOC_MCU_FUZZ_LIBFUZZER
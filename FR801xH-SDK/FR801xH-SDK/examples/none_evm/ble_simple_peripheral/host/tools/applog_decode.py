@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+app_log 二进制日志解码器
+
+固件里 APP_LOGx 只把“格式串地址 + 32bit 参数”写进 RAM 环形缓冲，空闲时从
+UART1 输出（见 code/app_log.h 的记录格式说明）。本工具用同一次编译产出的
+ELF（Keil .axf / GCC .elf / 主机可执行文件）把地址还原成格式串，再按 printf
+规则格式化成文本。
+
+输入可以是：
+- UART1 抓包的原始字节（与普通 co_printf 文本混在一起也可以，文本原样输出）；
+- 调试器导出的 s_ring 内存（按魔术字重新同步，seq 断档会提示）。
+
+用法：
+    applog_decode.py --elf build/ble_simple_peripheral.axf capture.bin
+    applog_decode.py --elf app.elf --raw -        # 从 stdin 读，不加前缀
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+APP_LOG_MAGIC = 0xB1
+APP_LOG_NARGS_HEX = 0x0F
+APP_LOG_MAX_ARGS = 8
+APP_LOG_HEX_MAX = 32
+
+LEVEL_TAG = {1: "E", 2: "W", 3: "I", 4: "D"}
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+
+class ElfImage(object):
+    """只实现按虚拟地址读只读数据，够解码格式串和常量字符串即可"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        d = self.data
+        if d[:4] != b"\x7fELF":
+            raise ValueError("%s: not an ELF file" % path)
+        is64 = d[4] == 2
+        endian = "<" if d[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(endian + "Q", d, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", d, 0x3A)
+            fmt = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", d, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", d, 0x2E)
+            fmt = endian + "IIIIIIIIII"
+        self.sections = []
+        for i in range(shnum):
+            (_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size,
+             _link, _info, _align, _entsize) = struct.unpack_from(
+                 fmt, d, shoff + i * shentsize)
+            if sh_type == SHT_NOBITS or not (sh_flags & SHF_ALLOC):
+                continue
+            if sh_addr == 0 or sh_size == 0:
+                continue
+            self.sections.append((sh_addr, sh_size, sh_offset))
+
+    def contains(self, addr):
+        for base, size, _off in self.sections:
+            if base <= addr < base + size:
+                return True
+        return False
+
+    def cstr(self, addr):
+        for base, size, off in self.sections:
+            if base <= addr < base + size:
+                start = off + (addr - base)
+                end = self.data.find(b"\0", start, off + size)
+                if end < 0:
+                    end = off + size
+                return self.data[start:end].decode("utf-8", "replace")
+        return None
+
+
+_CONV = re.compile(
+    r"%([-+ #0]*)(\d+)?(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+def c_format(elf, fmt, args):
+    """按 C printf 规则格式化；参数均为 32bit 无符号整数"""
+    out = []
+    pos = 0
+    argi = 0
+    for m in _CONV.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, prec, _len, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        v = args[argi] if argi < len(args) else 0
+        argi += 1
+        spec = "%" + flags + (width or "") + ("." + prec if prec else "")
+        if conv in "di":
+            if v & 0x80000000:
+                v -= 0x100000000
+            out.append((spec + "d") % v)
+        elif conv in "ouxX":
+            out.append((spec + conv) % v)
+        elif conv == "c":
+            out.append((spec + "c") % chr(v & 0xFF))
+        elif conv == "p":
+            out.append("0x%08x" % v)
+        else:  # 's'
+            s = elf.cstr(v) if v else "(null)"
+            if s is None:
+                s = "<str@0x%08X>" % v
+            out.append((spec + "s") % s)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode(elf, data, raw, out):
+    i = 0
+    n = len(data)
+    text = bytearray()
+    last_seq = None
+
+    def flush_text():
+        if text:
+            out.write(text.decode("utf-8", "replace"))
+            del text[:]
+
+    def emit(level, seq, body):
+        nonlocal last_seq
+        flush_text()
+        if not raw and last_seq is not None and seq != ((last_seq + 1) & 0xFF):
+            out.write("<gap: %d record(s) lost>\n" % ((seq - last_seq - 1) & 0xFF))
+        last_seq = seq
+        body = body.rstrip(" \r\n")
+        if raw:
+            out.write(body + "\n")
+        else:
+            out.write("[%3u] %s: %s\n" % (seq, LEVEL_TAG.get(level, "?"), body))
+
+    while i < n:
+        b = data[i]
+        if b != APP_LOG_MAGIC or i + 7 > n:
+            text.append(b)
+            i += 1
+            continue
+        hdr = data[i + 1]
+        level = hdr >> 4
+        nargs = hdr & 0x0F
+        seq = data[i + 2]
+        fmt_addr, = struct.unpack_from("<I", data, i + 3)
+        valid = level in LEVEL_TAG and (
+            nargs <= APP_LOG_MAX_ARGS or nargs == APP_LOG_NARGS_HEX)
+        if valid and fmt_addr != 0 and not elf.contains(fmt_addr):
+            valid = False
+
+        if valid and nargs == APP_LOG_NARGS_HEX:
+            if i + 8 > n:
+                valid = False
+            else:
+                rec_len = data[i + 7]
+                keep = min(rec_len, APP_LOG_HEX_MAX)
+                if i + 8 + keep > n:
+                    valid = False
+        elif valid:
+            if i + 7 + 4 * nargs > n:
+                valid = False
+
+        if not valid:
+            text.append(b)
+            i += 1
+            continue
+
+        if nargs == APP_LOG_NARGS_HEX:
+            title = elf.cstr(fmt_addr) or ""
+            blob = data[i + 8:i + 8 + keep]
+            if rec_len == 0:
+                body = title + " <empty>"
+            else:
+                body = title + " " + " ".join("%02X" % x for x in blob)
+                if rec_len > keep:
+                    body += " ...(+%d)" % (rec_len - keep)
+            i += 8 + keep
+        else:
+            args = list(struct.unpack_from("<%dI" % nargs, data, i + 7))
+            if fmt_addr == 0:
+                body = "<%u record(s) dropped: ring full>" % args[0]
+            else:
+                body = c_format(elf, elf.cstr(fmt_addr), args)
+            i += 7 + 4 * nargs
+        emit(level, seq, body)
+
+    flush_text()
+
+
+def main():
+    ap = argparse.ArgumentParser(description="decode app_log binary records")
+    ap.add_argument("--elf", required=True,
+                    help="firmware image that produced the log (.axf/.elf)")
+    ap.add_argument("--raw", action="store_true",
+                    help="no [seq] level prefix, no gap markers")
+    ap.add_argument("input", help="captured bytes, '-' for stdin")
+    a = ap.parse_args()
+
+    elf = ElfImage(a.elf)
+    if a.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(a.input, "rb") as f:
+            data = f.read()
+    decode(elf, data, a.raw, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,415 @@
+/*********************************************************************
+ * @file ota_delta_enc.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 差分 OTA 补丁生成实现：旧镜像哈希链找复制源，优先续接上次复制；发版模型
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "ota_delta_enc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ota_delta.h"
+
+#define DELTA_HASH_BITS 16u
+#define DELTA_CHAIN_MAX 128u
+#define DELTA_MIN_MATCH 8u  /* 任意位置复制的最短长度 */
+#define DELTA_MIN_CONT  4u  /* 续接位置（修正量为 0）复制的最短长度 */
+#define DELTA_MIN_GAIN  3u  /* 复制比插入至少省这么多字节才用 */
+#define DELTA_LONG      64u /* 续接位置匹配到这么长就不再查哈希链 */
+
+static uint32_t delta_hash(const uint8_t* p)
+{
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    return (v * 2654435761u) >> (32u - DELTA_HASH_BITS);
+}
+
+static uint32_t delta_var_len(uint32_t v)
+{
+    uint32_t n = 1u;
+    while (v >= 0x80u)
+    {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static uint32_t delta_put_var(uint8_t* out, uint32_t v)
+{
+    uint32_t n = 0u;
+    while (v >= 0x80u)
+    {
+        out[n++] = (uint8_t)(v | 0x80u);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static uint32_t delta_zigzag(uint32_t d)
+{
+    return (d << 1) ^ (0u - (d >> 31));
+}
+
+static void delta_put32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t delta_match(const uint8_t* old, uint32_t old_len, uint32_t src, const uint8_t* img, uint32_t n,
+                            uint32_t pos)
+{
+    uint32_t l = 0u;
+    while (src + l < old_len && pos + l < n && old[src + l] == img[pos + l])
+    {
+        l++;
+    }
+    return l;
+}
+
+/* 复制操作本身的字节数（操作头 + 源修正量） */
+static uint32_t delta_copy_cost(uint32_t len, uint32_t src, uint32_t pred)
+{
+    return delta_var_len((len << 1) | 1u) + delta_var_len(delta_zigzag(src - pred));
+}
+
+uint32_t ota_delta_encode(const uint8_t* old, uint32_t old_len, const uint8_t* img, uint32_t new_len, uint8_t* out,
+                          ota_delta_stats_t* stats)
+{
+    ota_delta_stats_t st;
+    int32_t*          head = (int32_t*)malloc(sizeof(int32_t) << DELTA_HASH_BITS);
+    int32_t*          prev = (int32_t*)malloc(sizeof(int32_t) * (old_len + 1u));
+    uint32_t          o    = OTA_DELTA_HDR_LEN;
+
+    if (head == NULL || prev == NULL)
+    {
+        free(head);
+        free(prev);
+        return 0u;
+    }
+    memset(&st, 0, sizeof(st));
+    memset(head, 0xFF, sizeof(int32_t) << DELTA_HASH_BITS);
+    /* 旧镜像首页（jump table）不能当复制源；倒序插入让链头是最靠前的位置 */
+    for (uint32_t i = old_len; i-- > OTA_DELTA_PAGE;)
+    {
+        if (i + 4u <= old_len)
+        {
+            uint32_t h = delta_hash(&old[i]);
+            prev[i]    = head[h];
+            head[h]    = (int32_t)i;
+        }
+    }
+
+    delta_put32(&out[0], OTA_DELTA_MAGIC);
+    delta_put32(&out[4], new_len);
+    delta_put32(&out[8], old_len);
+    delta_put32(&out[12], ota_delta_crc32(0u, old + OTA_DELTA_PAGE, old_len - OTA_DELTA_PAGE));
+    delta_put32(&out[16], ota_delta_crc32(0u, img, new_len));
+
+    uint32_t pos  = 0u;
+    uint32_t lit  = 0u; /* 待输出插入的起点 */
+    uint32_t pred = 0u; /* 与设备端相同的预测源 */
+    while (pos < new_len)
+    {
+        uint32_t cont     = pred + (pos - lit);
+        uint32_t best_len = 0u, best_src = 0u, best_gain = 0u;
+
+        if (cont >= OTA_DELTA_PAGE && cont < old_len)
+        {
+            uint32_t l = delta_match(old, old_len, cont, img, new_len, pos);
+            if (l >= DELTA_MIN_CONT && l > delta_copy_cost(l, cont, cont))
+            {
+                best_len  = l;
+                best_src  = cont;
+                best_gain = l - delta_copy_cost(l, cont, cont);
+            }
+        }
+        if (best_len < DELTA_LONG && pos + 4u <= new_len)
+        {
+            int32_t c = head[delta_hash(&img[pos])];
+            for (uint32_t depth = 0; c >= 0 && depth < DELTA_CHAIN_MAX; depth++, c = prev[c])
+            {
+                uint32_t l = delta_match(old, old_len, (uint32_t)c, img, new_len, pos);
+                if (l < DELTA_MIN_MATCH)
+                {
+                    continue;
+                }
+                uint32_t cost = delta_copy_cost(l, (uint32_t)c, cont);
+                if (l > cost && l - cost > best_gain)
+                {
+                    best_len  = l;
+                    best_src  = (uint32_t)c;
+                    best_gain = l - cost;
+                }
+            }
+        }
+
+        if (best_gain < DELTA_MIN_GAIN)
+        {
+            pos++;
+            continue;
+        }
+        if (pos > lit)
+        {
+            o += delta_put_var(&out[o], (pos - lit) << 1);
+            memcpy(&out[o], &img[lit], pos - lit);
+            o += pos - lit;
+            st.inserts++;
+            st.insert_bytes += pos - lit;
+        }
+        o += delta_put_var(&out[o], (best_len << 1) | 1u);
+        o += delta_put_var(&out[o], delta_zigzag(best_src - cont));
+        st.copies++;
+        st.copy_bytes += best_len;
+        pred = best_src + best_len;
+        pos += best_len;
+        lit = pos;
+    }
+    if (pos > lit)
+    {
+        o += delta_put_var(&out[o], (pos - lit) << 1);
+        memcpy(&out[o], &img[lit], pos - lit);
+        o += pos - lit;
+        st.inserts++;
+        st.insert_bytes += pos - lit;
+    }
+
+    free(head);
+    free(prev);
+    if (stats != NULL)
+    {
+        *stats = st;
+    }
+    return o;
+}
+
+/* ==================== 发版模型 ==================== */
+
+#define FW_JT_VERSION_OFFSET 24u /* offsetof(struct jump_table_t, firmware_version) */
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void wr16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static int fw_func_cmp(const void* a, const void* b)
+{
+    uint32_t x = ((const fw_func_t*)a)->offset;
+    uint32_t y = ((const fw_func_t*)b)->offset;
+    return (x > y) - (x < y);
+}
+
+uint32_t fw_image_funcs(const char* path, const char* prefix, fw_func_t* out, uint32_t max, uint32_t* load_base)
+{
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        return 0u;
+    }
+    fseek(fp, 0, SEEK_END);
+    long sz = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t* f = (sz > 52) ? (uint8_t*)malloc((size_t)sz) : NULL;
+    if (f == NULL || fread(f, 1, (size_t)sz, fp) != (size_t)sz || memcmp(f, "\x7f" "ELF", 4) != 0 || f[4] != 1u)
+    {
+        fclose(fp);
+        free(f);
+        return 0u;
+    }
+    fclose(fp);
+
+    uint32_t fsize = (uint32_t)sz;
+    uint32_t base  = 0xFFFFFFFFu;
+    uint32_t phoff = rd32(&f[28]), shoff = rd32(&f[32]);
+    uint16_t phent = rd16(&f[42]), phnum = rd16(&f[44]);
+    uint16_t shent = rd16(&f[46]), shnum = rd16(&f[48]);
+    for (uint16_t i = 0; i < phnum; i++)
+    {
+        uint32_t ph = phoff + (uint32_t)i * phent;
+        if (ph + 32u <= fsize && rd32(&f[ph]) == 1u && rd32(&f[ph + 16u]) != 0u && rd32(&f[ph + 12u]) < base)
+        {
+            base = rd32(&f[ph + 12u]);
+        }
+    }
+
+    uint32_t n = 0u;
+    for (uint16_t i = 0; i < shnum; i++)
+    {
+        uint32_t sh = shoff + (uint32_t)i * shent;
+        if (sh + 40u > fsize || rd32(&f[sh + 4u]) != 2u) /* SHT_SYMTAB */
+        {
+            continue;
+        }
+        uint32_t sym = rd32(&f[sh + 16u]), size = rd32(&f[sh + 20u]), link = rd32(&f[sh + 24u]);
+        uint32_t str_sh = shoff + link * shent;
+        if (str_sh + 40u > fsize || sym + size > fsize)
+        {
+            break;
+        }
+        uint32_t str = rd32(&f[str_sh + 16u]), str_size = rd32(&f[str_sh + 20u]);
+        for (uint32_t s = sym; s + 16u <= sym + size && n < max; s += 16u)
+        {
+            uint32_t name = rd32(&f[s]), value = rd32(&f[s + 4u]), fsz = rd32(&f[s + 8u]);
+            if ((f[s + 12u] & 0x0Fu) != 2u || fsz == 0u || name >= str_size || str + name >= fsize ||
+                strncmp((const char*)&f[str + name], prefix, strlen(prefix)) != 0 || (value & ~1u) < base)
+            {
+                continue;
+            }
+            out[n].offset = (value & ~1u) - base;
+            out[n].size   = fsz;
+            n++;
+        }
+        break;
+    }
+    free(f);
+
+    /* 同一个函数可能有局部 / 全局两条符号 */
+    qsort(out, n, sizeof(out[0]), fw_func_cmp);
+    uint32_t m = 0u;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (m == 0u || out[i].offset != out[m - 1u].offset)
+        {
+            out[m++] = out[i];
+        }
+    }
+    if (load_base != NULL)
+    {
+        *load_base = base;
+    }
+    return m;
+}
+
+static uint32_t fw_rand(uint32_t* s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+/* Thumb-2 BL（T1）：偏移 = S:I1:I2:imm10:imm11:0，I1 = !(J1^S)，I2 = !(J2^S） */
+static int32_t fw_bl_decode(uint16_t hw1, uint16_t hw2)
+{
+    uint32_t s   = (hw1 >> 10) & 1u;
+    uint32_t i1  = 1u ^ (((hw2 >> 13) & 1u) ^ s);
+    uint32_t i2  = 1u ^ (((hw2 >> 11) & 1u) ^ s);
+    uint32_t imm = (s << 24) | (i1 << 23) | (i2 << 22) | ((uint32_t)(hw1 & 0x3FFu) << 12) | ((uint32_t)(hw2 & 0x7FFu) << 1);
+    return (int32_t)(imm << 7) >> 7;
+}
+
+static void fw_bl_encode(int32_t off, uint16_t* hw1, uint16_t* hw2)
+{
+    uint32_t imm = (uint32_t)off;
+    uint32_t s   = (imm >> 24) & 1u;
+    uint32_t j1  = (1u ^ ((imm >> 23) & 1u)) ^ s;
+    uint32_t j2  = (1u ^ ((imm >> 22) & 1u)) ^ s;
+    *hw1 = (uint16_t)(0xF000u | (s << 10) | ((imm >> 12) & 0x3FFu));
+    *hw2 = (uint16_t)((*hw2 & 0xD000u) | (j1 << 13) | (j2 << 11) | ((imm >> 1) & 0x7FFu));
+}
+
+uint32_t fw_synth_release(const uint8_t* old, uint32_t old_len, uint32_t load_base, const fw_func_t* funcs,
+                          uint32_t nfuncs, uint32_t edits, uint32_t grow, uint32_t seed, uint8_t* out)
+{
+    uint32_t rng = seed | 1u;
+    uint32_t ins = old_len;
+
+    grow = (grow + 3u) & ~3u;
+    if (nfuncs == 0u)
+    {
+        grow = 0u;
+        edits = 0u;
+    }
+    if (grow != 0u)
+    {
+        const fw_func_t* f = &funcs[fw_rand(&rng) % nfuncs];
+        ins                = (f->offset + f->size + 3u) & ~3u;
+        if (ins > old_len)
+        {
+            ins = old_len;
+        }
+    }
+#define FW_MAP(o) (((o) < ins) ? (o) : (o) + grow)
+
+    memcpy(out, old, ins);
+    for (uint32_t i = 0; i < grow; i++)
+    {
+        out[ins + i] = (uint8_t)fw_rand(&rng); /* 新增代码：不指望在旧镜像里找到 */
+    }
+    memcpy(&out[ins + grow], &old[ins], old_len - ins);
+
+    if (grow != 0u)
+    {
+        /* 指向插入点之后的绝对地址（文字池、函数指针表、jump table） */
+        for (uint32_t o = 0; o + 4u <= old_len; o += 4u)
+        {
+            uint32_t v = rd32(&old[o]);
+            if (v >= load_base + ins && v < load_base + old_len)
+            {
+                v += grow;
+                memcpy(&out[FW_MAP(o)], &v, 4u);
+            }
+        }
+        /* 跨过插入点的 BL */
+        for (uint32_t p = 0; p + 4u <= old_len; p += 2u)
+        {
+            uint16_t hw1 = rd16(&old[p]), hw2 = rd16(&old[p + 2u]);
+            if ((hw1 & 0xF800u) != 0xF000u || (hw2 & 0xD000u) != 0xD000u)
+            {
+                continue;
+            }
+            int64_t t = (int64_t)p + 4 + fw_bl_decode(hw1, hw2);
+            if (t >= 0 && t < (int64_t)old_len)
+            {
+                int32_t off = (int32_t)FW_MAP((uint32_t)t) - (int32_t)FW_MAP(p) - 4;
+                fw_bl_encode(off, &hw1, &hw2);
+                wr16(&out[FW_MAP(p)], hw1);
+                wr16(&out[FW_MAP(p) + 2u], hw2);
+            }
+            p += 2u;
+        }
+    }
+
+    /* 改几个函数：每个 1~4 处、每处一条 16 位指令 */
+    for (uint32_t k = 0; k < edits; k++)
+    {
+        const fw_func_t* f = &funcs[fw_rand(&rng) % nfuncs];
+        uint32_t         m = 1u + fw_rand(&rng) % 4u;
+        for (uint32_t j = 0; j < m && f->size >= 2u; j++)
+        {
+            uint32_t o = (f->offset + fw_rand(&rng) % f->size) & ~1u;
+            if (o + 2u <= old_len)
+            {
+                wr16(&out[FW_MAP(o)], (uint16_t)fw_rand(&rng));
+            }
+        }
+    }
+#undef FW_MAP
+
+    if (old_len >= FW_JT_VERSION_OFFSET + 4u)
+    {
+        uint32_t v = rd32(&old[FW_JT_VERSION_OFFSET]) + 1u;
+        memcpy(&out[FW_JT_VERSION_OFFSET], &v, 4u);
+    }
+    return old_len + grow;
+}
@@ -0,0 +1,80 @@
+/*********************************************************************
+ * @file ota_delta_enc.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 差分 OTA 补丁生成（主机侧，格式见 components/ble/profiles/ble_ota/ota_delta.h）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * ota_diff 生成补丁文件、ota_delta_sim 校验重建 / 统计传输量、ota_stream_test 端到端传输共用。
+ * 另带一个“发版模型”：在真实固件上改几个函数、让其中一个变长，
+ * 按链接器的做法平移后面的代码并修正绝对地址和 BL 偏移，没有两版真实固件时用来评估。
+ *********************************************************************/
+
+#ifndef OTA_DELTA_ENC_H
+#define OTA_DELTA_ENC_H
+
+#include <stdint.h>
+
+/*
+ * ota_diff 输出文件：头 + 补丁，全部小端。
+ * 手机 App 读头填 OTA_CMD_STREAM_START_DELTA（length = patch_length），补丁按 STREAM_DATA
+ * 分包发送，最后 REBOOT 带 new_length 和 new_crc（与原流程的 CRC 算法、范围相同）；
+ * 设备还在重建时 REBOOT 回 OTA_RSP_BUSY，隔一会儿重发。
+ * 补丁自带的头里还有旧镜像长度和 CRC，设备收到后先核对运行区。
+ */
+#define OTA_DELTA_FILE_MAGIC 0x3146444Fu /* "ODF1" */
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t new_length;   /* 重建后镜像长度 */
+    uint32_t new_crc;      /* Crc32CalByByte(0, 新镜像+256, new_length-256) */
+    uint32_t patch_length; /* 后面补丁的长度 */
+} ota_delta_file_hdr_t;
+
+/* 最坏情况（全是插入）的补丁长度 */
+#define OTA_DELTA_ENC_BOUND(n) (20u + (n) + (n) / 8u + 16u)
+
+typedef struct
+{
+    uint32_t copies;
+    uint32_t copy_bytes;
+    uint32_t inserts;
+    uint32_t insert_bytes;
+} ota_delta_stats_t;
+
+/**
+ * @brief 生成补丁（含 20 字节头，新旧镜像 CRC 用 ota_delta_crc32 算好填进去）
+ * @param out 至少 OTA_DELTA_ENC_BOUND(new_len) 字节
+ * @param stats 可为 NULL
+ * @return 补丁长度，失败（内存不足）返回 0
+ */
+uint32_t ota_delta_encode(const uint8_t* old, uint32_t old_len, const uint8_t* img, uint32_t new_len, uint8_t* out,
+                          ota_delta_stats_t* stats);
+
+/* ==================== 发版模型 ==================== */
+
+typedef struct
+{
+    uint32_t offset; /* 相对镜像起始（加载地址）的偏移，已去掉 Thumb 位 */
+    uint32_t size;
+} fw_func_t;
+
+/**
+ * @brief 从 ELF 符号表取名字以 prefix 开头的函数（按偏移排序）
+ * @param load_base 输出镜像加载地址（与 fw_image_load 拼出的镜像对应）
+ * @return 函数个数（最多 max 个），不是 ELF 时返回 0
+ */
+uint32_t fw_image_funcs(const char* path, const char* prefix, fw_func_t* out, uint32_t max, uint32_t* load_base);
+
+/**
+ * @brief 模拟一次发版：在 funcs 里挑 edits 个函数各改几处字节，再让其中一个函数增长 grow 字节
+ *        （插在它末尾，grow 按 4 对齐），后面的代码整体后移，镜像内的绝对地址（4 字节对齐的字）
+ *        和跨过插入点的 Thumb-2 BL 偏移随之修正；jump table 版本号 +1
+ * @param out 至少 old_len + grow + 4 字节
+ * @return 新镜像长度
+ */
+uint32_t fw_synth_release(const uint8_t* old, uint32_t old_len, uint32_t load_base, const fw_func_t* funcs,
+                          uint32_t nfuncs, uint32_t edits, uint32_t grow, uint32_t seed, uint8_t* out);
+
+#endif // OTA_DELTA_ENC_H
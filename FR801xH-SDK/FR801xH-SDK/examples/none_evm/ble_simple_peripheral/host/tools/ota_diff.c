@@ -0,0 +1,116 @@
+/*********************************************************************
+ * @file ota_diff.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 差分 OTA 补丁生成工具：旧固件 + 新固件 -> 头 + 补丁（.odf）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 旧固件必须是设备当前运行区里的那一版（设备按补丁头里的长度和 CRC 核对，不符拒绝）。
+ * 输入 Keil .axf / GCC .elf 或原始 .bin，与 ota_pack 相同；输出文件头见 ota_delta_enc.h。
+ * 生成后立即用设备同一份重建器（ota_delta.c）以旧镜像为底重建一遍，
+ * 与新镜像逐字节比较，不一致不写文件。
+ *
+ * 用法：ota_diff old.axf new.axf out.odf
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ota_delta.h"
+#include "ota_delta_enc.h"
+#include "ota_lz_enc.h"
+
+/* ota.c 里的 CRC32（REBOOT 校验用的同一个算法） */
+uint32_t Crc32CalByByte(int crc, uint8_t* ptr, int len);
+
+static const uint8_t* s_old;
+static uint8_t*       s_check;
+
+static void diff_read(uint8_t* dst, uint32_t old_offset, uint32_t len)
+{
+    memcpy(dst, &s_old[old_offset], len);
+}
+
+static void diff_page(const uint8_t* page, uint32_t offset, uint32_t len)
+{
+    memcpy(&s_check[offset], page, len);
+}
+
+static bool diff_write(const char* path, const void* a, uint32_t na, const void* b, uint32_t nb)
+{
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    bool ok = fwrite(a, 1, na, fp) == na && fwrite(b, 1, nb, fp) == nb;
+    return (fclose(fp) == 0) && ok;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        fprintf(stderr, "usage: ota_diff old.axf new.axf out.odf\n");
+        return 2;
+    }
+
+    uint32_t old_len, new_len;
+    uint8_t* old = fw_image_load(argv[1], &old_len);
+    uint8_t* img = fw_image_load(argv[2], &new_len);
+    if (old == NULL || old_len <= 256u || img == NULL || new_len <= 256u)
+    {
+        fprintf(stderr, "cannot read firmware images\n");
+        return 1;
+    }
+
+    uint8_t* patch = (uint8_t*)malloc(OTA_DELTA_ENC_BOUND(new_len));
+    uint8_t* page  = (uint8_t*)malloc(OTA_DELTA_PAGE);
+    s_check        = (uint8_t*)malloc(new_len);
+    if (patch == NULL || page == NULL || s_check == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    ota_delta_stats_t st;
+    uint32_t          m = ota_delta_encode(old, old_len, img, new_len, patch, &st);
+
+    /* 用设备重建器回放一遍 */
+    struct ota_delta_t d;
+    uint32_t           used = 0u;
+    s_old                   = old;
+    ota_delta_init(&d, page, diff_read, diff_page, NULL);
+    while (m != 0u && ota_delta_state(&d) != OTA_DELTA_ERROR && (used < m || ota_delta_state(&d) == OTA_DELTA_COPYING))
+    {
+        ota_delta_copy(&d, 0xFFFFFFFFu);
+        used += ota_delta_feed(&d, patch + used, m - used);
+    }
+    if (ota_delta_state(&d) != OTA_DELTA_DONE || memcmp(s_check, img, new_len) != 0)
+    {
+        fprintf(stderr, "%s: round trip failed\n", argv[2]);
+        return 1;
+    }
+
+    ota_delta_file_hdr_t h;
+    h.magic        = OTA_DELTA_FILE_MAGIC;
+    h.new_length   = new_len;
+    h.new_crc      = Crc32CalByByte(0, img + 256, (int)(new_len - 256u));
+    h.patch_length = m;
+    if (!diff_write(argv[3], &h, sizeof(h), patch, m))
+    {
+        fprintf(stderr, "write failed\n");
+        return 1;
+    }
+    printf("%s -> %s: %u -> %u bytes (%.1f%%), %u copies (%u B), %u inserts (%u B), crc 0x%08X\n", argv[1],
+           argv[2], (unsigned)new_len, (unsigned)m, 100.0 * m / new_len, (unsigned)st.copies,
+           (unsigned)st.copy_bytes, (unsigned)st.inserts, (unsigned)st.insert_bytes, (unsigned)h.new_crc);
+    free(old);
+    free(img);
+    free(patch);
+    free(page);
+    free(s_check);
+    return 0;
+}
@@ -0,0 +1,273 @@
+/*********************************************************************
+ * @file ota_lz_enc.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief OTA 压缩镜像编码实现：哈希链找匹配 + 一步惰性匹配
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "ota_lz_enc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ota_lz.h"
+
+#define LZ_HASH_BITS  15u
+#define LZ_CHAIN_MAX  256u
+#define LZ_EXT_MAX    255u
+
+typedef struct
+{
+    const uint8_t* in;
+    uint32_t       n;
+    uint32_t       window;
+    uint32_t       len_field_max;
+    uint32_t       len_max;
+    int32_t*       head;
+    int32_t*       prev;
+} lz_enc_t;
+
+static uint32_t lz_hash(const uint8_t* p)
+{
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (v * 2654435761u) >> (32u - LZ_HASH_BITS);
+}
+
+static void lz_insert(lz_enc_t* e, uint32_t pos)
+{
+    if (pos + OTA_LZ_MIN_MATCH <= e->n)
+    {
+        uint32_t h   = lz_hash(&e->in[pos]);
+        e->prev[pos] = e->head[h];
+        e->head[h]   = (int32_t)pos;
+    }
+}
+
+/* pos 处最长匹配（pos 本身尚未插入哈希链） */
+static uint32_t lz_find(const lz_enc_t* e, uint32_t pos, uint32_t* dist)
+{
+    uint32_t best = 0u;
+
+    if (pos + OTA_LZ_MIN_MATCH > e->n)
+    {
+        return 0u;
+    }
+    uint32_t limit = e->n - pos;
+    if (limit > e->len_max)
+    {
+        limit = e->len_max;
+    }
+
+    int32_t cand = e->head[lz_hash(&e->in[pos])];
+    for (uint32_t depth = 0; cand >= 0 && depth < LZ_CHAIN_MAX; depth++)
+    {
+        uint32_t d = pos - (uint32_t)cand;
+        if (d > e->window)
+        {
+            break;
+        }
+        const uint8_t* a = &e->in[cand];
+        const uint8_t* b = &e->in[pos];
+        if (a[best] == b[best])
+        {
+            uint32_t l = 0u;
+            while (l < limit && a[l] == b[l])
+            {
+                l++;
+            }
+            if (l > best)
+            {
+                best  = l;
+                *dist = d;
+                if (l == limit)
+                {
+                    break;
+                }
+            }
+        }
+        cand = e->prev[cand];
+    }
+    return (best >= OTA_LZ_MIN_MATCH) ? best : 0u;
+}
+
+uint32_t ota_lz_encode(const uint8_t* in, uint32_t n, uint8_t window_bits, uint8_t* out)
+{
+    lz_enc_t e;
+    uint32_t o        = 0u;
+    uint32_t flag_pos = 0u;
+    uint32_t nitems   = 8u; /* 当前标志字节已用的项数，8 = 需要新开一个 */
+
+    e.in            = in;
+    e.n             = n;
+    e.window        = 1u << window_bits;
+    e.len_field_max = (1u << (16u - window_bits)) - 1u;
+    e.len_max       = OTA_LZ_MIN_MATCH + e.len_field_max + LZ_EXT_MAX;
+    e.head          = (int32_t*)malloc(sizeof(int32_t) << LZ_HASH_BITS);
+    e.prev          = (int32_t*)malloc(sizeof(int32_t) * (n + 1u));
+    if (e.head == NULL || e.prev == NULL)
+    {
+        free(e.head);
+        free(e.prev);
+        return 0u;
+    }
+    memset(e.head, 0xFF, sizeof(int32_t) << LZ_HASH_BITS);
+
+    uint32_t pos = 0u;
+    while (pos < n)
+    {
+        uint32_t dist = 0u;
+        uint32_t len  = lz_find(&e, pos, &dist);
+
+        /* 惰性匹配：下一字节起的匹配更长，就先出一个字面字节 */
+        if (len != 0u && len < e.len_max)
+        {
+            uint32_t d2 = 0u;
+            lz_insert(&e, pos);
+            uint32_t l2 = lz_find(&e, pos + 1u, &d2);
+            if (l2 > len + 1u)
+            {
+                len = 0u;
+            }
+            e.head[lz_hash(&in[pos])] = e.prev[pos]; /* 撤销，下面统一插入 */
+        }
+
+        if (nitems == 8u)
+        {
+            flag_pos      = o++;
+            out[flag_pos] = 0u;
+            nitems        = 0u;
+        }
+        if (len == 0u)
+        {
+            out[o++] = in[pos];
+            lz_insert(&e, pos);
+            pos++;
+        }
+        else
+        {
+            uint32_t lf = len - OTA_LZ_MIN_MATCH;
+            uint32_t tok;
+            out[flag_pos] |= (uint8_t)(1u << nitems);
+            tok      = (dist - 1u) | ((lf < e.len_field_max ? lf : e.len_field_max) << window_bits);
+            out[o++] = (uint8_t)tok;
+            out[o++] = (uint8_t)(tok >> 8);
+            if (lf >= e.len_field_max)
+            {
+                out[o++] = (uint8_t)(lf - e.len_field_max);
+            }
+            for (uint32_t i = 0; i < len; i++)
+            {
+                lz_insert(&e, pos + i);
+            }
+            pos += len;
+        }
+        nitems++;
+    }
+
+    free(e.head);
+    free(e.prev);
+    return o;
+}
+
+/* ==================== 固件镜像读入 ==================== */
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* ELF32 小端：PT_LOAD 段的文件内容按物理（加载）地址拼接，段间空隙填 0xFF（flash 擦除态） */
+static uint8_t* fw_image_from_elf(const uint8_t* f, uint32_t fsize, uint32_t* len)
+{
+    if (fsize < 52u || f[4] != 1u || f[5] != 1u)
+    {
+        return NULL;
+    }
+    uint32_t phoff = rd32(&f[28]);
+    uint16_t phent = rd16(&f[42]);
+    uint16_t phnum = rd16(&f[44]);
+    uint32_t lo = 0xFFFFFFFFu, hi = 0u;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        uint8_t* img = NULL;
+        if (pass == 1)
+        {
+            if (hi <= lo)
+            {
+                return NULL;
+            }
+            img = (uint8_t*)malloc(hi - lo);
+            if (img == NULL)
+            {
+                return NULL;
+            }
+            memset(img, 0xFF, hi - lo);
+        }
+        for (uint16_t i = 0; i < phnum; i++)
+        {
+            const uint8_t* ph = &f[phoff + (uint32_t)i * phent];
+            if ((uint32_t)(ph - f) + 32u > fsize || rd32(&ph[0]) != 1u || rd32(&ph[16]) == 0u)
+            {
+                continue;
+            }
+            uint32_t off = rd32(&ph[4]), paddr = rd32(&ph[12]), filesz = rd32(&ph[16]);
+            if (off + filesz > fsize)
+            {
+                free(img);
+                return NULL;
+            }
+            if (pass == 0)
+            {
+                lo = (paddr < lo) ? paddr : lo;
+                hi = (paddr + filesz > hi) ? paddr + filesz : hi;
+            }
+            else
+            {
+                memcpy(&img[paddr - lo], &f[off], filesz);
+            }
+        }
+        if (pass == 1)
+        {
+            *len = hi - lo;
+            return img;
+        }
+    }
+    return NULL;
+}
+
+uint8_t* fw_image_load(const char* path, uint32_t* len)
+{
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    long sz = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t* f = (sz > 0) ? (uint8_t*)malloc((size_t)sz) : NULL;
+    if (f == NULL || fread(f, 1, (size_t)sz, fp) != (size_t)sz)
+    {
+        fclose(fp);
+        free(f);
+        return NULL;
+    }
+    fclose(fp);
+
+    if (sz >= 4 && memcmp(f, "\x7f" "ELF", 4) == 0)
+    {
+        uint8_t* img = fw_image_from_elf(f, (uint32_t)sz, len);
+        free(f);
+        return img;
+    }
+    *len = (uint32_t)sz;
+    return f;
+}
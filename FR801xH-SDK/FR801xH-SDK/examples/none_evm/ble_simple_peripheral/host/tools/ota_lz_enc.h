@@ -0,0 +1,51 @@
+/*********************************************************************
+ * @file ota_lz_enc.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief OTA 压缩镜像编码（主机侧，格式见 components/ble/profiles/ble_ota/ota_lz.h）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * ota_pack 打包、ota_lz_bench 测压缩率/解码速度、ota_stream_test 端到端传输共用。
+ *********************************************************************/
+
+#ifndef OTA_LZ_ENC_H
+#define OTA_LZ_ENC_H
+
+#include <stdint.h>
+
+/*
+ * ota_pack 输出文件：头 + 压缩数据，全部小端。
+ * 手机 App 读头填 OTA_CMD_STREAM_START_LZ，压缩数据按 STREAM_DATA 分包发送，
+ * 最后 REBOOT 带 raw_length 和 raw_crc（与原流程的 CRC 算法、范围相同）。
+ */
+#define OTA_LZ_FILE_MAGIC 0x315A4C4Fu /* "OLZ1" */
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t raw_length;  /* 解压后镜像长度 */
+    uint32_t raw_crc;     /* Crc32CalByByte(0, 镜像+256, raw_length-256) */
+    uint32_t comp_length; /* 后面压缩数据的长度 */
+    uint8_t  window_bits;
+    uint8_t  reserved[3];
+} ota_lz_file_hdr_t;
+
+/* 最坏情况（全是字面字节）的输出长度 */
+#define OTA_LZ_ENC_BOUND(n) ((n) + (n) / 8u + 1u)
+
+/**
+ * @brief 压缩
+ * @param window_bits OTA_LZ_BITS_MIN ~ OTA_LZ_BITS_MAX，越大压得越好、设备窗口越大
+ * @param out 至少 OTA_LZ_ENC_BOUND(n) 字节
+ * @return 压缩后长度
+ */
+uint32_t ota_lz_encode(const uint8_t* in, uint32_t n, uint8_t window_bits, uint8_t* out);
+
+/**
+ * @brief 读固件：ELF（Keil .axf / GCC .elf）取可加载段按加载地址拼成 flash 镜像，
+ *        其它文件按原始 .bin 读入
+ * @return malloc 的镜像，失败返回 NULL
+ */
+uint8_t* fw_image_load(const char* path, uint32_t* len);
+
+#endif // OTA_LZ_ENC_H
@@ -0,0 +1,123 @@
+/*********************************************************************
+ * @file ota_pack.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief OTA 压缩镜像打包工具：固件 -> 头 + LZ 压缩数据（.olz）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 输入 Keil .axf / GCC .elf（取可加载段拼成 flash 镜像，与 fromelf --bin 一致）
+ * 或原始 .bin；输出文件头见 ota_lz_enc.h。打包后立即用设备同一份解码器
+ * （ota_lz.c）解一遍，与原镜像逐字节比较，不一致不写文件。
+ *
+ * 用法：ota_pack [--bits N] [--bin raw.bin] firmware.axf out.olz
+ *   --bits  窗口位数（8~12，默认与设备 OTA_LZ_WINDOW_BITS 相同），设备按这个分配窗口
+ *   --bin   顺带输出解压后的原始镜像（手机走原流程或核对用）
+ *********************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ota_lz.h"
+#include "ota_lz_enc.h"
+
+#ifndef OTA_LZ_WINDOW_BITS
+#define OTA_LZ_WINDOW_BITS 11
+#endif
+
+/* ota.c 里的 CRC32（REBOOT 校验用的同一个算法） */
+uint32_t Crc32CalByByte(int crc, uint8_t* ptr, int len);
+
+static uint8_t* s_check;
+
+static void pack_page(const uint8_t* page, uint32_t offset, uint32_t len)
+{
+    memcpy(&s_check[offset], page, len);
+}
+
+static bool pack_write(const char* path, const void* a, uint32_t na, const void* b, uint32_t nb)
+{
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    bool ok = fwrite(a, 1, na, fp) == na && (nb == 0u || fwrite(b, 1, nb, fp) == nb);
+    return (fclose(fp) == 0) && ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t    bits = OTA_LZ_WINDOW_BITS;
+    const char* bin  = NULL;
+    const char* in   = NULL;
+    const char* out  = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bits") == 0 && i + 1 < argc)
+            bits = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--bin") == 0 && i + 1 < argc)
+            bin = argv[++i];
+        else if (in == NULL)
+            in = argv[i];
+        else if (out == NULL)
+            out = argv[i];
+        else
+            in = NULL, i = argc;
+    }
+    if (in == NULL || out == NULL || bits < OTA_LZ_BITS_MIN || bits > OTA_LZ_BITS_MAX)
+    {
+        fprintf(stderr, "usage: ota_pack [--bits 8..12] [--bin raw.bin] firmware.axf out.olz\n");
+        return 2;
+    }
+
+    uint32_t n;
+    uint8_t* img = fw_image_load(in, &n);
+    if (img == NULL || n <= 256u)
+    {
+        fprintf(stderr, "%s: cannot read firmware image\n", in);
+        return 1;
+    }
+
+    uint8_t* comp = (uint8_t*)malloc(OTA_LZ_ENC_BOUND(n));
+    uint8_t* win  = (uint8_t*)malloc(1u << bits);
+    s_check       = (uint8_t*)malloc(n);
+    if (comp == NULL || win == NULL || s_check == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    uint32_t m = ota_lz_encode(img, n, (uint8_t)bits, comp);
+
+    /* 用设备解码器回读一遍 */
+    struct ota_lz_t lz;
+    ota_lz_init(&lz, win, (uint8_t)bits, n, pack_page);
+    if (ota_lz_decode(&lz, comp, m) != OTA_LZ_DONE || memcmp(s_check, img, n) != 0)
+    {
+        fprintf(stderr, "%s: round trip failed\n", in);
+        return 1;
+    }
+
+    ota_lz_file_hdr_t h;
+    memset(&h, 0, sizeof(h));
+    h.magic       = OTA_LZ_FILE_MAGIC;
+    h.raw_length  = n;
+    h.raw_crc     = Crc32CalByByte(0, img + 256, (int)(n - 256u));
+    h.comp_length = m;
+    h.window_bits = (uint8_t)bits;
+    if (!pack_write(out, &h, sizeof(h), comp, m) || (bin != NULL && !pack_write(bin, img, n, NULL, 0u)))
+    {
+        fprintf(stderr, "write failed\n");
+        return 1;
+    }
+    printf("%s: %u -> %u bytes (%.1f%%), window %u B, crc 0x%08X\n", in, (unsigned)n, (unsigned)m,
+           100.0 * m / n, 1u << bits, (unsigned)h.raw_crc);
+    free(img);
+    free(comp);
+    free(win);
+    free(s_check);
+    return 0;
+}
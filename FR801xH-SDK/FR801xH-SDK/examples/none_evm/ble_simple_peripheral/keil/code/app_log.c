@@ -0,0 +1,235 @@
+/*********************************************************************
+ * @file app_log.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 二进制延迟日志：RAM 环形缓冲 + 空闲循环输出
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "app_log.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "driver_uart.h"
+#include "idle_hook.h"
+#include "ll.h"
+
+#define APP_LOG_RING_MASK (APP_LOG_RING_SIZE - 1u)
+
+#if (APP_LOG_RING_SIZE & APP_LOG_RING_MASK) != 0u
+#error "APP_LOG_RING_SIZE must be a power of 2"
+#endif
+
+/* 单次空闲回调最多输出多少字节：避免长时间占住空闲循环，影响休眠判断 */
+#ifndef APP_LOG_DRAIN_BUDGET
+#define APP_LOG_DRAIN_BUDGET 64u
+#endif
+
+/*
+ * head/tail 为自由递增的 16bit 下标，用 (head - tail) 表示已用长度。
+ * 为什么不用 uint32：环形缓冲不会超过 64KB，16bit 在 M3 上读写同样是原子的。
+ */
+static uint8_t  s_ring[APP_LOG_RING_SIZE];
+static uint16_t s_head    = 0u;
+static uint16_t s_tail    = 0u;
+static uint8_t  s_seq     = 0u;
+static uint32_t s_written = 0u;
+static uint32_t s_dropped = 0u;
+static uint32_t s_dropped_reported = 0u;
+
+static void app_log_uart_sink(const uint8_t* data, uint32_t len);
+static app_log_sink_t s_sink = app_log_uart_sink;
+
+static void app_log_uart_sink(const uint8_t* data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uart_putc_noint(UART1, data[i]);
+    }
+}
+
+/* 缓冲已空时返回 false，由 idle_hook 摘掉空闲事件，允许系统进入休眠 */
+static bool app_log_idle(void)
+{
+    return app_log_drain(APP_LOG_DRAIN_BUDGET) != 0u;
+}
+
+/* 调用方已关中断 */
+static inline uint16_t app_log_free(void)
+{
+    return (uint16_t)(APP_LOG_RING_SIZE - (uint16_t)(s_head - s_tail));
+}
+
+static inline void app_log_put(uint8_t b)
+{
+    s_ring[s_head & APP_LOG_RING_MASK] = b;
+    s_head++;
+}
+
+static inline void app_log_put_u32(uint32_t v)
+{
+    app_log_put((uint8_t)v);
+    app_log_put((uint8_t)(v >> 8));
+    app_log_put((uint8_t)(v >> 16));
+    app_log_put((uint8_t)(v >> 24));
+}
+
+static inline void app_log_put_head(uint8_t level, uint8_t nargs, uint32_t fmt)
+{
+    app_log_put(APP_LOG_MAGIC);
+    app_log_put((uint8_t)((level << 4) | (nargs & 0x0Fu)));
+    app_log_put(s_seq++);
+    app_log_put_u32(fmt);
+}
+
+/* 上次有丢弃且当前空间足够时，先补一条丢弃计数记录（调用方已关中断） */
+static inline void app_log_report_dropped(void)
+{
+    if (s_dropped != s_dropped_reported && app_log_free() >= 11u)
+    {
+        app_log_put_head(LOG_LEVEL_WARNING, 1u, 0u);
+        app_log_put_u32(s_dropped - s_dropped_reported);
+        s_dropped_reported = s_dropped;
+    }
+}
+
+static inline void app_log_arm_idle(void)
+{
+    IdleHook_Arm(IDLE_HOOK_LOG, app_log_idle);
+}
+
+void app_log_write(uint8_t level, const char* fmt, uint8_t nargs, ...)
+{
+    uint32_t args[APP_LOG_MAX_ARGS];
+    va_list  ap;
+
+    if (nargs > APP_LOG_MAX_ARGS)
+    {
+        nargs = APP_LOG_MAX_ARGS;
+    }
+    va_start(ap, nargs);
+    for (uint8_t i = 0; i < nargs; i++)
+    {
+        args[i] = va_arg(ap, uint32_t);
+    }
+    va_end(ap);
+
+    uint16_t need = (uint16_t)(7u + 4u * nargs);
+
+    GLOBAL_INT_DISABLE();
+    app_log_report_dropped();
+    if (app_log_free() < need)
+    {
+        /* 缓冲满：丢新保旧，下次有空间时补一条丢弃计数 */
+        s_dropped++;
+    }
+    else
+    {
+        app_log_put_head(level, nargs, (uint32_t)(uintptr_t)fmt);
+        for (uint8_t i = 0; i < nargs; i++)
+        {
+            app_log_put_u32(args[i]);
+        }
+        s_written++;
+    }
+    app_log_arm_idle();
+    GLOBAL_INT_RESTORE();
+}
+
+void app_log_hex(uint8_t level, const char* title, const uint8_t* data, uint16_t len)
+{
+    uint16_t keep = (len > APP_LOG_HEX_MAX) ? (uint16_t)APP_LOG_HEX_MAX : len;
+    uint16_t need = (uint16_t)(8u + keep);
+    uint8_t  rec_len = (uint8_t)(len > 0xFFu ? 0xFFu : len);
+
+    if (data == NULL)
+    {
+        keep    = 0u;
+        need    = 8u;
+        rec_len = 0u;
+    }
+
+    GLOBAL_INT_DISABLE();
+    app_log_report_dropped();
+    if (app_log_free() < need)
+    {
+        s_dropped++;
+    }
+    else
+    {
+        app_log_put_head(level, APP_LOG_NARGS_HEX, (uint32_t)(uintptr_t)title);
+        app_log_put(rec_len);
+        for (uint16_t i = 0; i < keep; i++)
+        {
+            app_log_put(data[i]);
+        }
+        s_written++;
+    }
+    app_log_arm_idle();
+    GLOBAL_INT_RESTORE();
+}
+
+uint32_t app_log_drain(uint32_t budget)
+{
+    uint8_t  chunk[APP_LOG_DRAIN_BUDGET];
+    uint32_t total = 0u;
+
+    while (total < budget)
+    {
+        uint32_t n = budget - total;
+        if (n > sizeof(chunk))
+        {
+            n = sizeof(chunk);
+        }
+
+        /* 只在搬运下标时关中断，真正的 UART 输出在开中断状态下进行 */
+        GLOBAL_INT_DISABLE();
+        uint16_t used = (uint16_t)(s_head - s_tail);
+        if (n > used)
+        {
+            n = used;
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            chunk[i] = s_ring[(uint16_t)(s_tail + i) & APP_LOG_RING_MASK];
+        }
+        s_tail = (uint16_t)(s_tail + n);
+        GLOBAL_INT_RESTORE();
+
+        if (n == 0u)
+        {
+            break;
+        }
+        if (s_sink != NULL)
+        {
+            s_sink(chunk, n);
+        }
+        total += n;
+    }
+    return total;
+}
+
+void app_log_flush(void)
+{
+    while (app_log_drain(APP_LOG_DRAIN_BUDGET) != 0u)
+    {
+    }
+}
+
+void app_log_set_sink(app_log_sink_t sink)
+{
+    s_sink = sink;
+}
+
+uint32_t app_log_written(void)
+{
+    return s_written;
+}
+
+uint32_t app_log_dropped(void)
+{
+    return s_dropped;
+}
@@ -0,0 +1,212 @@
+/*********************************************************************
+ * @file app_log.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 分级日志层（在 co_log.h 之上扩展）：按模块编译期裁剪 + 二进制延迟日志
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 协议热路径（Protocol_Parse / proto_send_frame / BleFunc_*）每帧几十条
+ *   co_printf，115200 波特率下同步打印本身就是毫秒级，淹没了命令处理时间。
+ * - 这里把“记录”和“输出”拆开：
+ *   1) 编译期：每个模块在 include 前定义 APP_LOG_LEVEL，低于该级别的调用
+ *      连同格式串一起被预处理掉，不占 Flash、不占 CPU；
+ *   2) 运行期（APP_LOG_BINARY=1）：只写一条紧凑二进制记录
+ *      （格式串地址 + 参数）到 RAM 环形缓冲，由 os 空闲循环慢慢刷到 UART1；
+ *      主机侧 host/tools/applog_decode.py 结合 ELF(.axf/.elf) 还原成文本。
+ *
+ * 用法（与 co_log.h 的 LOG_LEVEL_MODULE 约定一致）：
+ *   #define APP_LOG_LEVEL LOG_LEVEL_INFO
+ *   #include "app_log.h"
+ *   APP_LOGI("conn=%u cmd=0x%04X\r\n", conidx, cmd);
+ *   APP_LOGD_HEX("payload:", buf, len);
+ *
+ * 二进制模式限制：
+ * - 参数一律按 32bit 保存，最多 APP_LOG_MAX_ARGS 个，不支持浮点；
+ * - %s 只能指向常量字符串（Flash 中的字面量/表），解码器按地址到 ELF 里取；
+ *   运行期拼出来的字符串请改用 APP_LOGx_HEX。
+ *********************************************************************/
+
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+#include <stdint.h>
+
+#include "co_log.h"
+
+/* co_log.h 只到 INFO，这里补一个 DEBUG（逐字节 dump 之类） */
+#define LOG_LEVEL_DEBUG 4
+
+/* 全局总开关：0 时所有 APP_LOGx 都编译为空 */
+#ifndef APP_LOG_ENABLE
+#define APP_LOG_ENABLE 1
+#endif
+
+/*
+ * 输出方式：
+ * - 1：二进制记录写 RAM 环形缓冲，空闲时输出（默认，热路径只有几十个周期）
+ * - 0：直接 co_printf（没有解码器、临时对照旧日志时用）
+ */
+#ifndef APP_LOG_BINARY
+#define APP_LOG_BINARY 1
+#endif
+
+/* 模块级别：模块未定义时默认 INFO */
+#ifndef APP_LOG_LEVEL
+#define APP_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+/* 环形缓冲大小（字节，必须是 2 的幂） */
+#ifndef APP_LOG_RING_SIZE
+#define APP_LOG_RING_SIZE 1024u
+#endif
+
+#define APP_LOG_MAX_ARGS 8u  /**< 单条记录最多参数个数 */
+#define APP_LOG_HEX_MAX  32u /**< 单条 HEX 记录最多保存字节数（超出截断） */
+
+/*
+ * 记录格式（小端，逐字节写入，便于 UART 抓包/内存 dump 后直接解析）：
+ *   [0]    APP_LOG_MAGIC
+ *   [1]    bit7..4 = level，bit3..0 = 参数个数；0xF 表示 HEX 记录
+ *   [2]    seq（每条 +1，解码器据此发现丢包）
+ *   [3..6] 格式串地址（format-id）
+ *   普通记录：nargs x uint32 参数
+ *   HEX 记录：[7]=原始长度，[8..]=min(len, APP_LOG_HEX_MAX) 字节
+ * 格式串地址为 0 表示“丢弃计数”记录，参数 0 为丢弃条数。
+ */
+#define APP_LOG_MAGIC     0xB1u
+#define APP_LOG_NARGS_HEX 0x0Fu
+
+/* ==================== 运行期接口 ==================== */
+
+/**
+ * @brief 写一条二进制记录（由 APP_LOGx 宏调用，不要直接用）
+ * @param nargs 后续变参个数，每个都是 uint32_t
+ */
+void app_log_write(uint8_t level, const char* fmt, uint8_t nargs, ...);
+
+/**
+ * @brief 写一条 HEX 记录（由 APP_LOGx_HEX 宏调用）
+ */
+void app_log_hex(uint8_t level, const char* title, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief 从环形缓冲取出最多 budget 字节送到输出口
+ * @return 实际输出字节数
+ * @note 默认在 os 空闲循环里调用（有数据时自动挂上，清空后自动摘除以便休眠）。
+ */
+uint32_t app_log_drain(uint32_t budget);
+
+/**
+ * @brief 一次性刷空（断言/复位前、主机仿真每帧结束时调用）
+ */
+void app_log_flush(void);
+
+/**
+ * @brief 输出口（默认逐字节写 UART1，与 co_printf 同一个口）
+ */
+typedef void (*app_log_sink_t)(const uint8_t* data, uint32_t len);
+void app_log_set_sink(app_log_sink_t sink);
+
+/* 已写入 / 因缓冲满丢弃的记录数（调试观测用） */
+uint32_t app_log_written(void);
+uint32_t app_log_dropped(void);
+
+/* ==================== 记录宏 ==================== */
+
+/* 参数个数（0..8），依赖 GNU ", ##__VA_ARGS__"（armcc --gnu / gcc 均支持） */
+#define APP_LOG_NARGS(...) \
+    APP_LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define APP_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+#define APP_LOG_CAT(a, b)  APP_LOG_CAT_(a, b)
+#define APP_LOG_CAT_(a, b) a##b
+
+/* 每个参数统一转成 uint32_t，保证 va_arg 两端类型一致（主机 64bit 指针也安全） */
+#define APP_LOG_U32(x) ((uint32_t)(uintptr_t)(x))
+
+#define APP_LOG_BIN_0(l, f) app_log_write((l), (f), 0u)
+#define APP_LOG_BIN_1(l, f, a) app_log_write((l), (f), 1u, APP_LOG_U32(a))
+#define APP_LOG_BIN_2(l, f, a, b) \
+    app_log_write((l), (f), 2u, APP_LOG_U32(a), APP_LOG_U32(b))
+#define APP_LOG_BIN_3(l, f, a, b, c) \
+    app_log_write((l), (f), 3u, APP_LOG_U32(a), APP_LOG_U32(b), APP_LOG_U32(c))
+#define APP_LOG_BIN_4(l, f, a, b, c, d)  \
+    app_log_write((l), (f), 4u, APP_LOG_U32(a), APP_LOG_U32(b), \
+                  APP_LOG_U32(c), APP_LOG_U32(d))
+#define APP_LOG_BIN_5(l, f, a, b, c, d, e)                      \
+    app_log_write((l), (f), 5u, APP_LOG_U32(a), APP_LOG_U32(b), \
+                  APP_LOG_U32(c), APP_LOG_U32(d), APP_LOG_U32(e))
+#define APP_LOG_BIN_6(l, f, a, b, c, d, e, g)                           \
+    app_log_write((l), (f), 6u, APP_LOG_U32(a), APP_LOG_U32(b),         \
+                  APP_LOG_U32(c), APP_LOG_U32(d), APP_LOG_U32(e),       \
+                  APP_LOG_U32(g))
+#define APP_LOG_BIN_7(l, f, a, b, c, d, e, g, h)                        \
+    app_log_write((l), (f), 7u, APP_LOG_U32(a), APP_LOG_U32(b),         \
+                  APP_LOG_U32(c), APP_LOG_U32(d), APP_LOG_U32(e),       \
+                  APP_LOG_U32(g), APP_LOG_U32(h))
+#define APP_LOG_BIN_8(l, f, a, b, c, d, e, g, h, i)                     \
+    app_log_write((l), (f), 8u, APP_LOG_U32(a), APP_LOG_U32(b),         \
+                  APP_LOG_U32(c), APP_LOG_U32(d), APP_LOG_U32(e),       \
+                  APP_LOG_U32(g), APP_LOG_U32(h), APP_LOG_U32(i))
+
+#if APP_LOG_BINARY
+#define APP_LOG_EMIT(lvl, fmt, ...)                                \
+    APP_LOG_CAT(APP_LOG_BIN_, APP_LOG_NARGS(__VA_ARGS__))          \
+    ((lvl), (fmt), ##__VA_ARGS__)
+#define APP_LOG_EMIT_HEX(lvl, title, buf, len) \
+    app_log_hex((lvl), (title), (const uint8_t*)(buf), (uint16_t)(len))
+#else
+#define APP_LOG_EMIT(lvl, fmt, ...) co_printf((fmt), ##__VA_ARGS__)
+#define APP_LOG_EMIT_HEX(lvl, title, buf, len)                   \
+    do                                                           \
+    {                                                            \
+        const uint8_t* _p = (const uint8_t*)(buf);               \
+        co_printf("%s", (title));                                \
+        for (uint16_t _i = 0; _i < (uint16_t)(len); _i++)        \
+        {                                                        \
+            co_printf(" %02X", _p[_i]);                          \
+        }                                                        \
+        co_printf("\r\n");                                       \
+    } while (0)
+#endif
+
+/* 按级别展开：低于模块级别的调用在预处理阶段就被删掉 */
+#define APP_LOG_NOP(...) \
+    do                   \
+    {                    \
+    } while (0)
+
+#if APP_LOG_ENABLE && (APP_LOG_LEVEL >= LOG_LEVEL_ERROR)
+#define APP_LOGE(...)       APP_LOG_EMIT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define APP_LOGE_HEX(t, b, n) APP_LOG_EMIT_HEX(LOG_LEVEL_ERROR, t, b, n)
+#else
+#define APP_LOGE(...)       APP_LOG_NOP()
+#define APP_LOGE_HEX(t, b, n) APP_LOG_NOP()
+#endif
+
+#if APP_LOG_ENABLE && (APP_LOG_LEVEL >= LOG_LEVEL_WARNING)
+#define APP_LOGW(...)       APP_LOG_EMIT(LOG_LEVEL_WARNING, __VA_ARGS__)
+#define APP_LOGW_HEX(t, b, n) APP_LOG_EMIT_HEX(LOG_LEVEL_WARNING, t, b, n)
+#else
+#define APP_LOGW(...)       APP_LOG_NOP()
+#define APP_LOGW_HEX(t, b, n) APP_LOG_NOP()
+#endif
+
+#if APP_LOG_ENABLE && (APP_LOG_LEVEL >= LOG_LEVEL_INFO)
+#define APP_LOGI(...)       APP_LOG_EMIT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define APP_LOGI_HEX(t, b, n) APP_LOG_EMIT_HEX(LOG_LEVEL_INFO, t, b, n)
+#else
+#define APP_LOGI(...)       APP_LOG_NOP()
+#define APP_LOGI_HEX(t, b, n) APP_LOG_NOP()
+#endif
+
+#if APP_LOG_ENABLE && (APP_LOG_LEVEL >= LOG_LEVEL_DEBUG)
+#define APP_LOGD(...)       APP_LOG_EMIT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define APP_LOGD_HEX(t, b, n) APP_LOG_EMIT_HEX(LOG_LEVEL_DEBUG, t, b, n)
+#else
+#define APP_LOGD(...)       APP_LOG_NOP()
+#define APP_LOGD_HEX(t, b, n) APP_LOG_NOP()
+#endif
+
+#endif // APP_LOG_H
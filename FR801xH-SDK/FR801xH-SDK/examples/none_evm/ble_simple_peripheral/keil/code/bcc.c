@@ -0,0 +1,109 @@
+/*********************************************************************
+ * @file bcc.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 协议帧 BCC 按字计算
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "bcc.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* 按字读写 uint8_t 缓冲：GCC 下声明可别名，避免 -O2 的严格别名优化出错 */
+#if defined(__GNUC__)
+typedef uint32_t __attribute__((__may_alias__)) bcc_word_t;
+#else
+typedef uint32_t bcc_word_t;
+#endif
+
+#define BCC_WORD_MASK ((uintptr_t)(sizeof(bcc_word_t) - 1u))
+
+/* 32 位异或累计折叠成 8 位 */
+static uint8_t bcc_fold(uint32_t w)
+{
+    w ^= w >> 16;
+    w ^= w >> 8;
+    return (uint8_t)w;
+}
+
+uint8_t Bcc_Xor(uint8_t acc, const uint8_t* buf, uint16_t len)
+{
+    uint32_t w = 0;
+
+    if (buf == NULL)
+    {
+        return acc;
+    }
+
+    /* 头部逐字节走到 4 字节对齐 */
+    while (len > 0u && ((uintptr_t)buf & BCC_WORD_MASK) != 0u)
+    {
+        acc ^= *buf++;
+        len--;
+    }
+
+    const bcc_word_t* p = (const bcc_word_t*)(const void*)buf;
+    for (; len >= 8u; len = (uint16_t)(len - 8u))
+    {
+        w ^= p[0] ^ p[1];
+        p += 2;
+    }
+    if (len >= 4u)
+    {
+        w ^= *p++;
+        len = (uint16_t)(len - 4u);
+    }
+
+    buf = (const uint8_t*)(const void*)p;
+    while (len > 0u)
+    {
+        acc ^= *buf++;
+        len--;
+    }
+    return (uint8_t)(acc ^ bcc_fold(w));
+}
+
+uint8_t Bcc_CopyXor(uint8_t acc, uint8_t* dst, const uint8_t* src, uint16_t len)
+{
+    uint32_t w = 0;
+
+    if (dst == NULL || src == NULL)
+    {
+        return acc;
+    }
+
+    /* 两边错位时只能按字节拷：交给 memcpy，再按字补算 */
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & BCC_WORD_MASK) != 0u)
+    {
+        memcpy(dst, src, len);
+        return Bcc_Xor(acc, dst, len);
+    }
+
+    while (len > 0u && ((uintptr_t)src & BCC_WORD_MASK) != 0u)
+    {
+        acc ^= *src;
+        *dst++ = *src++;
+        len--;
+    }
+
+    const bcc_word_t* s = (const bcc_word_t*)(const void*)src;
+    bcc_word_t*       d = (bcc_word_t*)(void*)dst;
+    for (; len >= 4u; len = (uint16_t)(len - 4u))
+    {
+        uint32_t v = *s++;
+        *d++       = v;
+        w ^= v;
+    }
+
+    src = (const uint8_t*)(const void*)s;
+    dst = (uint8_t*)(void*)d;
+    while (len > 0u)
+    {
+        acc ^= *src;
+        *dst++ = *src++;
+        len--;
+    }
+    return (uint8_t)(acc ^ bcc_fold(w));
+}
@@ -18,22 +18,23 @@
 #include "simple_gatt_service.h"
 #include "ble_simple_peripheral.h"
 #include "protocol.h"
+#include "conn_ctx.h"
 #include "scanner.h"
 #include "TPMS.h"
+#include "flash_job.h"
+#include "kv_store.h"
 #include "rssi_check.h"
+#include "rssi_report.h"
 #include "ble_function.h"
 
 #include "sys_utils.h"
 #include "flash_usage_config.h"
 
-/* 允许同时连接的手机数量（中心设备数量） */
-#define SP_MAX_CONN_NUM 3
+/* 允许同时连接的手机数量（中心设备数量）：统一由 conn_ctx.h 的 APP_MAX_CONN 决定 */
+#define SP_MAX_CONN_NUM APP_MAX_CONN
 
 /* 1: 使用固定名称 Wi-Box_79B736 (测试用); 0: 使用动态名称 Moto_MAC */
 #define USE_TEST_FIXED_NAME 1
-
-/* 记录每条链路是否已完成加密（Bond 后重连通常会自动加密） */
-static uint8_t g_link_encrypted[SP_MAX_CONN_NUM] = {0};
 /*
  * MACROS (�궨��)
  */
@@ -156,35 +157,11 @@ static BLE_Central_Base_t g_ble_scanner;
  * @why
  * - 你反馈“MCU 一条 RSSI 都没收到”，根因很可能是：RSSI 实际上报走 GAP_EVT_LINK_RSSI，
  *   但应用层此前仅打印，没有把 RSSI 喂给 RSSI_Check_Update()，导致 NEAR 判定与下发逻辑不触发。
- * - 同时为了满足“RSSI 一直发送”，这里用定时器周期性调用 gap_get_link_rssi() 触发事件上报。
+ * - RSSI 采样节奏交给 RSSI_Checker 按距离状态调度（过渡带 100 ms，稳定 NEAR/LOST 3 s），
+ *   到点回调这里发 gap_get_link_rssi()，结果经 GAP_EVT_LINK_RSSI 喂回滤波器。
  */
-#define RSSI_REQ_PERIOD_MS 500
-static os_timer_t g_rssi_req_timer;
-static uint8_t    g_link_connected[SP_MAX_CONN_NUM] = {0};
-
-static void sp_rssi_req_timer_func(void* arg) {
-    (void)arg;
-    for (uint8_t i = 0; i < SP_MAX_CONN_NUM; i++) {
-        if (g_link_connected[i]) {
-            gap_get_link_rssi(i);
-        }
-    }
-}
-
-static void sp_rssi_req_timer_update(void) {
-    uint8_t any = 0;
-    for (uint8_t i = 0; i < SP_MAX_CONN_NUM; i++) {
-        if (g_link_connected[i]) {
-            any = 1;
-            break;
-        }
-    }
-
-    if (any) {
-        os_timer_start(&g_rssi_req_timer, RSSI_REQ_PERIOD_MS, 1);
-    } else {
-        os_timer_stop(&g_rssi_req_timer);
-    }
+static void sp_rssi_sample_req(uint8_t conidx) {
+    gap_get_link_rssi(conidx);
 }
 
 /* 当前是否还有空位继续广播，允许多个中心设备接入 */
@@ -261,9 +238,7 @@ void app_gap_evt_cb(gap_event_t* p_event) {
              * - 首次连接会触发手机弹出配对（Bond）
              * - 已配对设备重连会更快进入加密态（无感解锁的前提）
              */
-        if (p_event->param.slave_connect.conidx < SP_MAX_CONN_NUM) {
-            g_link_encrypted[p_event->param.slave_connect.conidx] = 0;
-        }
+        Conn_Open(p_event->param.slave_connect.conidx);
         co_printf("sec_req[%d] -> gap_security_req()\r\n",
                   p_event->param.slave_connect.conidx);
         gap_security_req(p_event->param.slave_connect.conidx);
@@ -271,19 +246,16 @@ void app_gap_evt_cb(gap_event_t* p_event) {
         /* 新连接先清理鉴权状态，等待 APP 发送 Token */
         Protocol_Auth_Clear(p_event->param.slave_connect.conidx);
 
-        /* 启用 RSSI 滤波（事件驱动：RSSI 由 gap_rssi_ind 喂入） */
+        /* 启用 RSSI 滤波（样本经 GAP_EVT_LINK_RSSI 喂入，采样节奏见下方调度） */
         RSSI_Check_Enable(p_event->param.slave_connect.conidx, NULL);
+        RSSI_Report_Reset(p_event->param.slave_connect.conidx);
 
         /* 缓存对端 MAC，便于 RSSI 回调里打印 RSSI+MAC */
         RSSI_Check_Set_Peer_Addr(p_event->param.slave_connect.conidx,
                                  p_event->param.slave_connect.peer_addr.addr);
-        gap_get_link_rssi(p_event->param.slave_connect.conidx);
 
-        /* 标记连接有效，并开启 RSSI 轮询请求（保证持续产生 GAP_EVT_LINK_RSSI） */
-        if (p_event->param.slave_connect.conidx < SP_MAX_CONN_NUM) {
-            g_link_connected[p_event->param.slave_connect.conidx] = 1;
-            sp_rssi_req_timer_update();
-        }
+        /* 开启该连接的 RSSI 采样调度（保证持续产生 GAP_EVT_LINK_RSSI） */
+        RSSI_Check_Enable_Sampling(p_event->param.slave_connect.conidx, sp_rssi_sample_req);
 
         /* 还未达上限则继续广播，允许其它手机继续连接 */
         sp_try_continue_adv();
@@ -295,23 +267,17 @@ void app_gap_evt_cb(gap_event_t* p_event) {
                   p_event->param.disconnect.reason);
         os_timer_stop(&update_param_timer);
 
-        if (p_event->param.disconnect.conidx < SP_MAX_CONN_NUM) {
-            g_link_encrypted[p_event->param.disconnect.conidx] = 0;
-        }
+        /* 连接上下文归零并归还组帧缓冲 */
+        Conn_Close(p_event->param.disconnect.conidx);
 
         /* 断链清理鉴权状态 */
         Protocol_Auth_Clear(p_event->param.disconnect.conidx);
 
         /* 断开后关闭该连接的 RSSI 跟踪 */
         RSSI_Check_Disable(p_event->param.disconnect.conidx);
+        RSSI_Report_Reset(p_event->param.disconnect.conidx);
         RSSI_Check_Clear_Peer_Addr(p_event->param.disconnect.conidx);
 
-        /* 清理连接标记，并在无连接时停止 RSSI 轮询请求 */
-        if (p_event->param.disconnect.conidx < SP_MAX_CONN_NUM) {
-            g_link_connected[p_event->param.disconnect.conidx] = 0;
-            sp_rssi_req_timer_update();
-        }
-
         sp_try_continue_adv();
     } break;
 
@@ -348,7 +314,7 @@ void app_gap_evt_cb(gap_event_t* p_event) {
              */
         RSSI_Check_Update(p_event->conidx, p_event->param.link_rssi);
 
-        /* 你要求：采集到 RSSI 就发 MCU（不做阈值处理） */
+        /* 每个样本都交给上报策略，由它决定何时发 MCU（见 rssi_report.h） */
         BleFunc_RSSI_RawInd(p_event->conidx, p_event->param.link_rssi);
         break;
 
@@ -357,8 +323,8 @@ void app_gap_evt_cb(gap_event_t* p_event) {
                   p_event->param.slave_encrypt_conidx);
         os_timer_start(&update_param_timer, 4000, 0);
 
-        if (p_event->param.slave_encrypt_conidx < SP_MAX_CONN_NUM) {
-            g_link_encrypted[p_event->param.slave_encrypt_conidx] = 1;
+        if (Conn_Get(p_event->param.slave_encrypt_conidx) != NULL) {
+            Conn_Get(p_event->param.slave_encrypt_conidx)->encrypted = 1;
         }
 
         co_printf("enc_state[%d]=1\r\n", p_event->param.slave_encrypt_conidx);
@@ -420,10 +386,6 @@ void simple_peripheral_init(void) {
 
     os_timer_init(&update_param_timer, param_timer_func, NULL);
 
-    /* RSSI 轮询请求定时器：用于周期性触发 gap_get_link_rssi() */
-    os_timer_init(&g_rssi_req_timer, sp_rssi_req_timer_func, NULL);
-    memset(g_link_connected, 0, sizeof(g_link_connected));
-
 #if 0 //security encryption
     gap_security_param_t param =
     {
@@ -471,16 +433,25 @@ void simple_peripheral_init(void) {
 
     gap_set_cb_func(app_gap_evt_cb);
 
-    /* RSSI 过滤模块初始化 + 使能底层实时 RSSI 上报 */
+    /*
+     * RSSI 过滤模块初始化；关闭底层实时 RSSI 上报（每个连接事件一次 gap_rssi_ind），
+     * 样本只来自 RSSI_Checker 调度的 gap_get_link_rssi()，采样率随距离状态自适应
+     */
+    Conn_Init();
     RSSI_Check_Init();
-    gap_set_link_rssi_report(true);
+    RSSI_Report_Init();
+    gap_set_link_rssi_report(false);
     /*
          * @why
          * - 你要求“采集到 RSSI 就发 MCU”，因此不再使用距离状态(NEAR/FAR/LOST)门禁逻辑。
-         * - GAP_EVT_LINK_RSSI 里已经每次都调用 BleFunc_RSSI_RawInd() 下发 MCU。
+         * - GAP_EVT_LINK_RSSI 里每个样本都调用 BleFunc_RSSI_RawInd()，由 rssi_report 决定何时下发 MCU。
          */
     RSSI_Check_Set_DistanceChangeCb(NULL);
 
+    /* 挂载键值存储（扫描日志建索引），TPMS 绑定表从这里读；下一扇区的预擦除排进 flash_job */
+    FlashJob_Init();
+    KV_Init();
+
     /* 初始化 TPMS：仅保留绑定加载/学习与 Flash 存储 */
     TPMS_Init();
 
@@ -503,4 +474,7 @@ void simple_peripheral_init(void) {
 
     // Initialize Protocol
     Protocol_Init();
+
+    /* 0x01FE 鉴权 Token 开机算好，重连解锁时不再现算 MD5 */
+    BleFunc_Auth_SetKey(NULL, 0u);
 }
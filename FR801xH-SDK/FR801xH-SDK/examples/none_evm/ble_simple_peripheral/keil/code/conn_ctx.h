@@ -0,0 +1,114 @@
+/*********************************************************************
+ * @file conn_ctx.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 连接上下文：按 conidx 的链路/协议状态集中在一处，连接数由一个宏决定
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 以前 RSSI_MAX_CONN / PROTOCOL_MAX_CONN / SP_MAX_CONN_NUM / BLEFUNC_MAX_CONN /
+ *   PARAM_SYNC_CONN_NUM 以及 simple_gatt_service 里各写一遍 3，每个模块再各开一组
+ *   [3] 静态数组；想支持一家 6~8 部手机得改七八处，还容易漏。
+ * - 现在只改 APP_MAX_CONN，上面这些宏都默认跟它走；协议层原来散在 protocol.c 的
+ *   鉴权/流水号/加密会话/ACK 状态、链路加密标志、近场锁存都归到 app_conn_t。
+ * - 组帧缓冲不再按连接常驻：发送时从 APP_TX_POOL_BLOCKS 块的定长块池里租一块，
+ *   数据段前预留 7 字节帧头、原地加密、后面接 BCC/帧尾，发完就还（ACK 模式下
+ *   待确认帧扣住自己那块直到确认/放弃）。以前每连接一份“帧 250 B + 密文 240 B”，
+ *   现在不开 ACK 时整机只有 2 x 250 B，和连接数无关。
+ * - RSSI_Checker / rssi_report / param_sync 的每连接状态是各自模块私有的小结构，
+ *   仍留在模块里，但数组长度同样取 APP_MAX_CONN。
+ *********************************************************************/
+
+#ifndef CONN_CTX_H
+#define CONN_CTX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "en_de_algo.h"
+#include "os_timer.h"
+#include "protocol.h"
+
+/* 允许同时连接的手机数量（中心设备数量）：全工程唯一的连接数配置 */
+#ifndef APP_MAX_CONN
+#define APP_MAX_CONN 3
+#endif
+
+/* 组帧块：Header(7) + 数据段(≤PROTOCOL_MAX_LEN，含加密填充) + BCC(1) + Footer(2) */
+#define CONN_TX_BLK_SIZE (PROTOCOL_MAX_LEN + 10)
+
+/*
+ * 组帧块数：发送路径是串行的，一块在用、一块留给发送途中回调里再发一帧；
+ * ACK 模式下每个连接还可能扣着一块待确认帧。
+ */
+#ifndef APP_TX_POOL_BLOCKS
+#if PROTOCOL_USE_ACK
+#define APP_TX_POOL_BLOCKS (APP_MAX_CONN + 2)
+#else
+#define APP_TX_POOL_BLOCKS 2
+#endif
+#endif
+
+typedef struct
+{
+    uint8_t buf[CONN_TX_BLK_SIZE]; /* 必须是第一个成员：数据段指针减 7 即块地址 */
+} conn_tx_blk_t;
+
+/* 协议层每连接状态（protocol.c 独占） */
+typedef struct
+{
+    uint8_t        authed;
+    uint8_t        last_rx_att_idx; /* 最后一次收包的特征值（回包跟随通道） */
+    uint8_t        last_rx_seq;     /* 最后一次收包流水号（同步应答回显），0xFF=无 */
+    uint8_t        last_rx_crypto;  /* 最后一次收包加密类型（回包同样加密） */
+    Algo_Context_t crypto;          /* 加解密会话（轮密钥只展开一次） */
+#if PROTOCOL_USE_ACK
+    bool           in_flight;
+    bool           critical;
+    uint8_t        seq;
+    uint16_t       cmd;
+    uint8_t        retry;
+    uint16_t       len;
+    conn_tx_blk_t* retx; /* 待确认帧所在的组帧块（确认/放弃/断开时归还） */
+    os_timer_t     ack_timer;
+#endif
+} app_conn_proto_t;
+
+typedef struct
+{
+    bool    in_use;            /* GAP 已连接（Conn_Open ~ Conn_Close） */
+    uint8_t encrypted;         /* 链路已完成加密（Bond 后重连通常会自动加密） */
+    uint8_t rssi_near_latched; /* ble_function：本次连接已上报过 NEAR 确认 */
+
+    app_conn_proto_t proto;
+} app_conn_t;
+
+/**
+ * @brief 上电初始化：清空所有连接上下文与缓冲池
+ */
+void Conn_Init(void);
+
+/**
+ * @brief 取连接上下文；conidx 越界返回 NULL
+ */
+app_conn_t* Conn_Get(uint8_t conidx);
+
+/**
+ * @brief GAP 连接建立 / 断开（断开时归还该连接扣着的组帧块）
+ */
+void Conn_Open(uint8_t conidx);
+void Conn_Close(uint8_t conidx);
+
+/**
+ * @brief 从块池租一块组帧块（与连接无关，用完 Conn_TxFree）
+ * @return NULL=池空
+ */
+conn_tx_blk_t* Conn_TxAlloc(void);
+void           Conn_TxFree(conn_tx_blk_t* blk);
+
+/**
+ * @brief 当前在租的块数（调试/仿真用）
+ */
+uint8_t Conn_TxInUse(void);
+
+#endif // CONN_CTX_H
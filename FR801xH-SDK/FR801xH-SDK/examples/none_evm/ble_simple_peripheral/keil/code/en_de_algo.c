@@ -236,6 +236,87 @@ static void DecryptBlock(const AesKey_t* ctx, uint8_t* buf) {
 
 #endif /* #if 0 legacy AES */
 
+/* ==================== 会话轮密钥缓存 (Key Schedule Cache) ==================== */
+
+/*
+ * 一份 Key 对应的加密/解密轮密钥。
+ * - enc：AES_set_key 的结果；dec：enc 再做一次 AES_convert_key。
+ * - refs 为 0 时不清空内容：同一 Key 重新打开会话（断线重连）可直接复用，
+ *   只有被别的 Key 占用时才重新扩展。
+ */
+typedef struct Algo_KeySched_s {
+    uint8_t key[ALGO_AES_BLOCK_SIZE];
+    uint8_t refs;
+    bool    valid;
+    AES_CTX enc;
+    AES_CTX dec;
+} Algo_KeySched_t;
+
+static Algo_KeySched_t s_key_sched[ALGO_KEYSCHED_NUM];
+
+static Algo_KeySched_t* algo_sched_acquire(const uint8_t* key) {
+    static const uint8_t zero_iv[ALGO_AES_BLOCK_SIZE] = {0};
+
+    /* 1) 已展开过同一 Key：直接加引用 */
+    for (uint32_t i = 0; i < ALGO_KEYSCHED_NUM; i++) {
+        Algo_KeySched_t* ks = &s_key_sched[i];
+        if (ks->valid && memcmp(ks->key, key, ALGO_AES_BLOCK_SIZE) == 0) {
+            ks->refs++;
+            return ks;
+        }
+    }
+
+    /* 2) 找一个没人用的槽重新展开；池满返回 NULL（调用方回退为每次现算） */
+    for (uint32_t i = 0; i < ALGO_KEYSCHED_NUM; i++) {
+        Algo_KeySched_t* ks = &s_key_sched[i];
+        if (ks->refs != 0u) {
+            continue;
+        }
+        memcpy(ks->key, key, ALGO_AES_BLOCK_SIZE);
+        AES_set_key(&ks->enc, key, zero_iv, AES_MODE_128);
+        ks->dec = ks->enc;
+        AES_convert_key(&ks->dec);
+        ks->refs  = 1u;
+        ks->valid = true;
+        return ks;
+    }
+    return NULL;
+}
+
+static void algo_sched_release(Algo_KeySched_t* ks) {
+    if (ks != NULL && ks->refs > 0u) {
+        ks->refs--;
+    }
+}
+
+#if ALGO_AES_USE_ECB
+/*
+ * 单块 ECB：直接调 AES_encrypt/AES_decrypt（SDK 的块函数按大端字处理），
+ * 省掉 AES_cbc_* 里 IV 异或与两次 16B memcpy。支持 in == out 原地处理。
+ */
+static void algo_aes_ecb_block(const AES_CTX* aes,
+                               bool           encrypt,
+                               const uint8_t* in,
+                               uint8_t*       out) {
+    uint32_t w[4];
+    for (uint32_t i = 0; i < 4u; i++) {
+        w[i] = ((uint32_t)in[4u * i] << 24) | ((uint32_t)in[4u * i + 1u] << 16) |
+               ((uint32_t)in[4u * i + 2u] << 8) | (uint32_t)in[4u * i + 3u];
+    }
+    if (encrypt) {
+        AES_encrypt(aes, w);
+    } else {
+        AES_decrypt(aes, w);
+    }
+    for (uint32_t i = 0; i < 4u; i++) {
+        out[4u * i]      = (uint8_t)(w[i] >> 24);
+        out[4u * i + 1u] = (uint8_t)(w[i] >> 16);
+        out[4u * i + 2u] = (uint8_t)(w[i] >> 8);
+        out[4u * i + 3u] = (uint8_t)w[i];
+    }
+}
+#endif
+
 static bool ops_aes_encrypt(Algo_Context_t* ctx,
                             const uint8_t*  in,
                             uint32_t        len,
@@ -248,6 +329,14 @@ static bool ops_aes_encrypt(Algo_Context_t* ctx,
     }
 
 #if ALGO_AES_USE_ECB
+    if (ctx->sched != NULL) {
+        /* 会话路径：轮密钥已预展开，逐块直接加密 */
+        for (uint32_t offset = 0; offset < len; offset += ALGO_AES_BLOCK_SIZE) {
+            algo_aes_ecb_block(&ctx->sched->enc, true, &in[offset], &out[offset]);
+        }
+        return true;
+    }
+
     /*
      * ECB：通过“每个 16B 块都用 IV=0 单独做一次 CBC 加密”来实现。
      * 为什么这样做：SDK 提供的是 AES_cbc_encrypt，而 ECB 只需要 AES_ENC(C_i)。
@@ -266,6 +355,13 @@ static bool ops_aes_encrypt(Algo_Context_t* ctx,
     }
     return true;
 #else
+    if (ctx->sched != NULL) {
+        /* 会话路径：共享轮密钥，IV 每次按本会话重新装载 */
+        memcpy(ctx->sched->enc.iv, ctx->iv, ALGO_AES_BLOCK_SIZE);
+        AES_cbc_encrypt(&ctx->sched->enc, in, out, (int)len);
+        return true;
+    }
+
     /* CBC：直接调用 SDK CBC（IV 使用 ctx->iv） */
     AES_CTX aes;
     AES_set_key(&aes, ctx->key, ctx->iv, AES_MODE_128);
@@ -286,6 +382,14 @@ static bool ops_aes_decrypt(Algo_Context_t* ctx,
     }
 
 #if ALGO_AES_USE_ECB
+    if (ctx->sched != NULL) {
+        /* 会话路径：解密轮密钥（已 AES_convert_key）预先算好，逐块直接解密 */
+        for (uint32_t offset = 0; offset < len; offset += ALGO_AES_BLOCK_SIZE) {
+            algo_aes_ecb_block(&ctx->sched->dec, false, &in[offset], &out[offset]);
+        }
+        return true;
+    }
+
     /*
      * ECB：通过“每个 16B 块都用 IV=0 单独做一次 CBC 解密”来实现。
      * 为什么：对单块而言，CBC 解密 P = AES_DEC(C) XOR IV；当 IV=0 时等价 ECB。
@@ -305,6 +409,12 @@ static bool ops_aes_decrypt(Algo_Context_t* ctx,
     }
     return true;
 #else
+    if (ctx->sched != NULL) {
+        memcpy(ctx->sched->dec.iv, ctx->iv, ALGO_AES_BLOCK_SIZE);
+        AES_cbc_decrypt(&ctx->sched->dec, in, out, (int)len);
+        return true;
+    }
+
     /* CBC：直接调用 SDK CBC（IV 使用 ctx->iv） */
     AES_CTX aes;
     AES_set_key(&aes, ctx->key, ctx->iv, AES_MODE_128);
@@ -327,7 +437,8 @@ bool Algo_Bind(Algo_Context_t* ctx, algo_type_t type) {
     if (ctx == NULL)
         return false;
 
-    ctx->type = type;
+    ctx->type  = type;
+    ctx->sched = NULL; /* 临时上下文：不持有会话轮密钥 */
 
     switch (type) {
     case ALGO_TYPE_NONE: ctx->ops = &s_ops_none; break;
@@ -363,6 +474,11 @@ void Algo_SetKeyIV(Algo_Context_t* ctx, const uint8_t* key, const uint8_t* iv) {
     }
 
     if (key != NULL) {
+        /* Key 变了，旧的预展开轮密钥不再对应：释放，由 Algo_Session_Open 重新获取 */
+        if (ctx->sched != NULL) {
+            algo_sched_release(ctx->sched);
+            ctx->sched = NULL;
+        }
         memset(ctx->key, 0, ALGO_MAX_KEY_LEN);
         if (key_len > 0) {
             memcpy(ctx->key, key, key_len);
@@ -375,6 +491,43 @@ void Algo_SetKeyIV(Algo_Context_t* ctx, const uint8_t* key, const uint8_t* iv) {
     }
 }
 
+bool Algo_Session_Open(Algo_Context_t* ctx,
+                       algo_type_t     type,
+                       const uint8_t*  key,
+                       const uint8_t*  iv) {
+    static const uint8_t zero_iv[ALGO_MAX_IV_LEN] = {0};
+
+    if (ctx == NULL) {
+        return false;
+    }
+
+    /* 会话对象要求零初始化（静态分配）或已 Close，这里先释放旧引用 */
+    Algo_Session_Close(ctx);
+
+    if (!Algo_Bind(ctx, type)) {
+        ctx->ops = NULL;
+        return false;
+    }
+    Algo_SetKeyIV(ctx, key, (iv != NULL) ? iv : zero_iv);
+
+    if (type == ALGO_TYPE_AES_CBC && key != NULL) {
+        ctx->sched = algo_sched_acquire(ctx->key);
+    }
+    return true;
+}
+
+void Algo_Session_Close(Algo_Context_t* ctx) {
+    if (ctx == NULL) {
+        return;
+    }
+    if (ctx->sched != NULL) {
+        algo_sched_release(ctx->sched);
+        ctx->sched = NULL;
+    }
+    ctx->ops = NULL;
+    memset(ctx->key, 0, ALGO_MAX_KEY_LEN);
+}
+
 uint32_t Algo_Padding(uint8_t* buf, uint32_t data_len, uint8_t block_size) {
     if (block_size == 0)
         return data_len;
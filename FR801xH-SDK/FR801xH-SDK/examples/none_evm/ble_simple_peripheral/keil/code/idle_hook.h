@@ -0,0 +1,36 @@
+/*********************************************************************
+ * @file idle_hook.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief os 空闲循环分发：多个模块共用 os_user_loop_event_set 的唯一回调槽
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - SDK 只有一个空闲循环回调槽，谁后调用 os_user_loop_event_set 谁生效，
+ *   谁调用 os_user_loop_event_clear 就把别人的也摘掉。
+ *   app_log 的日志输出已经占了它，flash 后台作业也要在空闲时跑。
+ * - 这里占住这个槽，按位记录哪些模块有活；全部做完才 clear，系统才能休眠。
+ *********************************************************************/
+
+#ifndef IDLE_HOOK_H
+#define IDLE_HOOK_H
+
+#include <stdbool.h>
+
+typedef enum
+{
+    IDLE_HOOK_LOG = 0, /* app_log 二进制日志输出 */
+    IDLE_HOOK_FLASH,   /* flash_job 擦写作业 */
+    IDLE_HOOK_NUM,
+} idle_hook_slot_t;
+
+/* 返回 true：还有活，下一轮空闲继续调；false：做完了，等下次 IdleHook_Arm */
+typedef bool (*idle_hook_fn_t)(void);
+
+/**
+ * @brief 登记/唤醒一个空闲任务
+ * @note 可在中断里调用；已登记时直接返回。
+ */
+void IdleHook_Arm(idle_hook_slot_t slot, idle_hook_fn_t fn);
+
+#endif // IDLE_HOOK_H
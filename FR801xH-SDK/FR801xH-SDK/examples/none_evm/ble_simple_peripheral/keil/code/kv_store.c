@@ -0,0 +1,511 @@
+/*********************************************************************
+ * @file kv_store.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 日志式键值存储实现（基于 flash_op_* 读/写/擦）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * 扇区布局（KV_STORE_BASE_ADDR 起 KV_STORE_SECTORS 个 4KB 扇区）：
+ *   [seq(4) magic(4)] [记录] [记录] ... [0xFF...]
+ * 记录（4 字节对齐）：
+ *   key(2) len(2) crc16(2) commit(1) rsv(1) data(len)
+ *   - crc16 覆盖 key/len/data；len=0 表示删除；
+ *   - 头和数据一次写入（commit 留 0xFF），再单独把 commit 写成 0x00。
+ * 挂载：取 magic 有效且 seq 最大的扇区，从头扫到第一条全 0xFF 的记录头。
+ *   commit 不是 0x00 或 CRC 不对的记录丢弃；len 不可信（写头时掉电）时
+ *   把扇区剩余部分当作已用，下一次写入触发 GC。
+ * GC：擦下一个扇区 -> 逐条搬有效记录 -> 写 seq -> 最后写 magic。
+ *   magic 写完之前掉电，旧扇区仍是序号最大的有效扇区。
+ * 预擦除（KV_STORE_BG_ERASE）：下一个扇区里只有已经搬走的旧数据，挂载后和每次 GC 后
+ *   就交给 flash_job 在空闲时擦掉；GC 时它已经是空的，写回调里不再有扇区擦除。
+ *   预擦除的扇区没有 magic，擦到一半掉电也不会被挂载成活动扇区。
+ *********************************************************************/
+
+#include "kv_store.h"
+#include "driver_flash.h"
+#include "flash_job.h"
+#include "flash_op.h"
+#include "flash_usage_config.h"
+#include <stddef.h>
+#include <string.h>
+
+#define KV_SECTOR_SIZE  0x1000u
+#define KV_MAGIC        0x3153564Bu /* 'KVS1' little-end */
+#define KV_SECTOR_HDR   8u
+#define KV_REC_HDR      8u
+#define KV_COMMIT_DONE  0x00u
+#define KV_KEY_ERASED   0xFFFFu
+#define KV_REC_SIZE(n)  ((uint16_t)(((KV_REC_HDR + (n)) + 3u) & ~3u))
+#define KV_SECTOR_ADDR(i) (KV_STORE_BASE_ADDR + (uint32_t)(i) * KV_SECTOR_SIZE)
+#define KV_NEXT(i)        ((uint8_t)(((i) + 1u) % KV_STORE_SECTORS))
+
+/* 1：下一个扇区交给 flash_job 在空闲时预擦除；0：GC 时在调用方里同步擦（旧行为） */
+#ifndef KV_STORE_BG_ERASE
+#define KV_STORE_BG_ERASE 1
+#endif
+
+#if KV_STORE_SECTORS < 2
+#error "KV_STORE_SECTORS must be at least 2"
+#endif
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t magic;
+} kv_sector_hdr_t;
+
+typedef struct
+{
+    uint16_t key;
+    uint16_t len;
+    uint16_t crc;
+    uint8_t  commit;
+    uint8_t  rsv;
+} kv_rec_hdr_t;
+
+typedef struct
+{
+    uint16_t key;
+    uint16_t len;
+    uint16_t off; /* 记录在活动扇区内的偏移 */
+} kv_index_t;
+
+static kv_index_t s_index[KV_STORE_MAX_KEYS];
+static uint8_t    s_index_cnt = 0;
+static uint8_t    s_active    = 0;
+static uint32_t   s_seq       = 0;
+static uint32_t   s_wp        = 0; /* 活动扇区写指针 */
+static bool       s_ready     = false;
+static KV_Stats   s_stats;
+#if KV_STORE_BG_ERASE
+static bool s_spare_ready = false; /* 下一个扇区已擦好 */
+static bool s_spare_busy  = false; /* 预擦除作业还在队列里 */
+#endif
+
+/* 记录组装/GC 搬运共用缓冲（不放栈上） */
+static uint8_t s_buf[KV_REC_HDR + KV_VALUE_MAX];
+
+/* CRC16/CCITT-FALSE，可分段累计 */
+static uint16_t kv_crc16(uint16_t crc, const uint8_t* data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t b = 0; b < 8u; b++)
+        {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t kv_rec_crc(const kv_rec_hdr_t* hdr, const uint8_t* data)
+{
+    uint16_t crc = kv_crc16(0xFFFFu, (const uint8_t*)hdr, 4u); /* key + len */
+    return kv_crc16(crc, data, hdr->len);
+}
+
+static void kv_flash_unlock(void)
+{
+#ifdef FLASH_PROTECT
+    flash_protect_disable(1);
+#endif
+}
+
+static void kv_flash_lock(void)
+{
+#ifdef FLASH_PROTECT
+    flash_protect_enable(1);
+#endif
+}
+
+static void kv_prog(uint32_t addr, const void* data, uint32_t len)
+{
+    flash_op_write_direct(addr, (uint8_t*)data, len);
+    s_stats.prog_bytes += len;
+}
+
+static void kv_erase(uint8_t sector)
+{
+    flash_op_erase_sector(KV_SECTOR_ADDR(sector));
+    s_stats.erases++;
+}
+
+#if KV_STORE_BG_ERASE
+static void kv_spare_erased(void* arg)
+{
+    (void)arg;
+    s_spare_busy  = false;
+    s_spare_ready = true;
+    s_stats.erases++;
+}
+
+static void kv_spare_prepare(void)
+{
+    s_spare_ready = false;
+    s_spare_busy  = FlashJob_Erase(KV_SECTOR_ADDR(KV_NEXT(s_active)), KV_SECTOR_SIZE,
+                                   kv_spare_erased, NULL);
+}
+
+/* 挂载时下一个扇区可能是 GC 前的旧扇区，也可能是 GC 做到一半的残留 */
+static bool kv_sector_blank(uint8_t sector)
+{
+    for (uint32_t off = 0; off < KV_SECTOR_SIZE; off += sizeof(s_buf))
+    {
+        uint32_t n = KV_SECTOR_SIZE - off;
+        if (n > sizeof(s_buf))
+        {
+            n = sizeof(s_buf);
+        }
+        flash_op_read(KV_SECTOR_ADDR(sector) + off, s_buf, n);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            if (s_buf[i] != 0xFFu)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+/* ============ RAM 索引 ============ */
+
+static int kv_index_find(uint16_t key)
+{
+    for (int i = 0; i < s_index_cnt; i++)
+    {
+        if (s_index[i].key == key)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* len=0 表示删除；新键而索引已满时返回 false */
+static bool kv_index_set(uint16_t key, uint16_t off, uint16_t len)
+{
+    int i = kv_index_find(key);
+    if (len == 0u)
+    {
+        if (i >= 0)
+        {
+            s_index[i] = s_index[--s_index_cnt];
+        }
+        return true;
+    }
+    if (i < 0)
+    {
+        if (s_index_cnt >= KV_STORE_MAX_KEYS)
+        {
+            return false;
+        }
+        i = s_index_cnt++;
+    }
+    s_index[i].key = key;
+    s_index[i].off = off;
+    s_index[i].len = len;
+    return true;
+}
+
+static uint16_t kv_live_bytes(void)
+{
+    uint16_t live = 0;
+    for (int i = 0; i < s_index_cnt; i++)
+    {
+        live = (uint16_t)(live + KV_REC_SIZE(s_index[i].len));
+    }
+    return live;
+}
+
+/* ============ 扇区操作 ============ */
+
+/* 在活动扇区写指针处追加一条记录并更新索引；调用方保证放得下 */
+static void kv_append(uint16_t key, const uint8_t* data, uint16_t len)
+{
+    kv_rec_hdr_t hdr;
+    uint32_t     addr = KV_SECTOR_ADDR(s_active) + s_wp;
+
+    hdr.key    = key;
+    hdr.len    = len;
+    hdr.crc    = kv_rec_crc(&hdr, data);
+    hdr.commit = 0xFFu;
+    hdr.rsv    = 0xFFu;
+
+    memcpy(s_buf, &hdr, KV_REC_HDR);
+    if (len > 0u && data != &s_buf[KV_REC_HDR])
+    {
+        memcpy(&s_buf[KV_REC_HDR], data, len);
+    }
+    kv_prog(addr, s_buf, KV_REC_HDR + len);
+
+    hdr.commit = KV_COMMIT_DONE;
+    kv_prog(addr + (uint32_t)offsetof(kv_rec_hdr_t, commit), &hdr.commit, 1u);
+
+    kv_index_set(key, (uint16_t)s_wp, len);
+    s_wp += KV_REC_SIZE(len);
+}
+
+/* 扫描活动扇区：重建索引并定位写指针 */
+static void kv_scan(void)
+{
+    uint32_t base = KV_SECTOR_ADDR(s_active);
+    uint32_t off  = KV_SECTOR_HDR;
+
+    s_index_cnt = 0;
+    while (off + KV_REC_HDR <= KV_SECTOR_SIZE)
+    {
+        kv_rec_hdr_t hdr;
+        flash_op_read(base + off, (uint8_t*)&hdr, KV_REC_HDR);
+
+        if (hdr.key == KV_KEY_ERASED && hdr.len == 0xFFFFu && hdr.crc == 0xFFFFu &&
+            hdr.commit == 0xFFu && hdr.rsv == 0xFFu)
+        {
+            break; /* 日志尾 */
+        }
+        if (hdr.len > KV_VALUE_MAX || off + KV_REC_SIZE(hdr.len) > KV_SECTOR_SIZE)
+        {
+            /* 写记录头时掉电：长度不可信，剩余空间不再使用 */
+            s_stats.torn++;
+            off = KV_SECTOR_SIZE;
+            break;
+        }
+        bool ok = (hdr.commit == KV_COMMIT_DONE);
+        if (ok)
+        {
+            flash_op_read(base + off + KV_REC_HDR, s_buf, hdr.len);
+            ok = (kv_rec_crc(&hdr, s_buf) == hdr.crc);
+        }
+        if (ok)
+        {
+            kv_index_set(hdr.key, (uint16_t)off, hdr.len);
+        }
+        else
+        {
+            s_stats.torn++;
+        }
+        off += KV_REC_SIZE(hdr.len);
+    }
+    s_wp = off;
+}
+
+static void kv_write_sector_hdr(uint8_t sector, uint32_t seq)
+{
+    uint32_t magic = KV_MAGIC;
+    uint32_t addr  = KV_SECTOR_ADDR(sector);
+
+    /* 先序号后 magic：magic 有效即序号完整 */
+    kv_prog(addr + (uint32_t)offsetof(kv_sector_hdr_t, seq), &seq, 4u);
+    kv_prog(addr + (uint32_t)offsetof(kv_sector_hdr_t, magic), &magic, 4u);
+}
+
+/* 把有效记录搬到下一个扇区并切换过去 */
+static void kv_gc(void)
+{
+    uint8_t  from = s_active;
+    uint8_t  to   = KV_NEXT(s_active);
+    uint32_t src  = KV_SECTOR_ADDR(from);
+
+#if KV_STORE_BG_ERASE
+    if (s_spare_busy)
+    {
+        /* 预擦除还没轮到：就地做完（flash_job 每块结束会重新上写保护） */
+        FlashJob_Flush();
+        kv_flash_unlock();
+    }
+    if (!s_spare_ready)
+    {
+        kv_erase(to);
+    }
+    s_spare_ready = false;
+#else
+    kv_erase(to);
+#endif
+    s_active = to;
+    s_wp     = KV_SECTOR_HDR;
+    for (int i = 0; i < s_index_cnt; i++)
+    {
+        uint16_t len = s_index[i].len;
+        flash_op_read(src + s_index[i].off + KV_REC_HDR, &s_buf[KV_REC_HDR], len);
+        kv_append(s_index[i].key, &s_buf[KV_REC_HDR], len);
+    }
+    s_seq++;
+    kv_write_sector_hdr(to, s_seq);
+    s_stats.gc_runs++;
+#if KV_STORE_BG_ERASE
+    kv_spare_prepare();
+#endif
+}
+
+/*
+ * 保证活动扇区还能再写 need 字节。
+ * 被覆盖的旧值也要搬：新记录写完之前掉电，这个键还得读得到旧值。
+ */
+static bool kv_reserve(uint16_t need)
+{
+    if (s_wp + need <= KV_SECTOR_SIZE)
+    {
+        return true;
+    }
+    if (KV_SECTOR_HDR + kv_live_bytes() + need > KV_SECTOR_SIZE)
+    {
+        return false;
+    }
+    kv_gc();
+    return true;
+}
+
+/* ============ 对外接口 ============ */
+
+void KV_Init(void)
+{
+    int      best     = -1;
+    uint32_t best_seq = 0;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    for (uint8_t i = 0; i < KV_STORE_SECTORS; i++)
+    {
+        kv_sector_hdr_t hdr;
+        flash_op_read(KV_SECTOR_ADDR(i), (uint8_t*)&hdr, sizeof(hdr));
+        if (hdr.magic == KV_MAGIC && hdr.seq != 0xFFFFFFFFu && (best < 0 || hdr.seq > best_seq))
+        {
+            best     = i;
+            best_seq = hdr.seq;
+        }
+    }
+
+    if (best < 0)
+    {
+        /* 空片/全部损坏：从 0 号扇区开始 */
+        kv_flash_unlock();
+        kv_erase(0);
+        kv_write_sector_hdr(0, 1u);
+        kv_flash_lock();
+        best     = 0;
+        best_seq = 1u;
+    }
+
+    s_active = (uint8_t)best;
+    s_seq    = best_seq;
+    kv_scan();
+    s_ready = true;
+
+#if KV_STORE_BG_ERASE
+    s_spare_busy = false;
+    if (kv_sector_blank(KV_NEXT(s_active)))
+    {
+        s_spare_ready = true;
+    }
+    else
+    {
+        kv_spare_prepare();
+    }
+#endif
+}
+
+bool KV_Put(uint16_t key, const void* data, uint16_t len)
+{
+    if (data == NULL || len == 0u || len > KV_VALUE_MAX || key == KV_KEY_ERASED)
+    {
+        return false;
+    }
+    if (!s_ready)
+    {
+        KV_Init();
+    }
+
+    int i = kv_index_find(key);
+    if (i >= 0)
+    {
+        if (s_index[i].len == len)
+        {
+            flash_op_read(KV_SECTOR_ADDR(s_active) + s_index[i].off + KV_REC_HDR, s_buf, len);
+            if (memcmp(s_buf, data, len) == 0)
+            {
+                s_stats.unchanged++;
+                return true;
+            }
+        }
+    }
+    else if (s_index_cnt >= KV_STORE_MAX_KEYS)
+    {
+        return false;
+    }
+
+    kv_flash_unlock();
+    bool ok = kv_reserve(KV_REC_SIZE(len));
+    if (ok)
+    {
+        kv_append(key, (const uint8_t*)data, len);
+        s_stats.puts++;
+        s_stats.put_bytes += len;
+    }
+    kv_flash_lock();
+    return ok;
+}
+
+uint16_t KV_Get(uint16_t key, void* buf, uint16_t cap)
+{
+    if (!s_ready)
+    {
+        KV_Init();
+    }
+
+    int i = kv_index_find(key);
+    if (i < 0)
+    {
+        return 0;
+    }
+    uint16_t len = s_index[i].len;
+    if (buf != NULL && cap > 0u)
+    {
+        flash_op_read(KV_SECTOR_ADDR(s_active) + s_index[i].off + KV_REC_HDR, (uint8_t*)buf,
+                      len < cap ? len : cap);
+    }
+    return len;
+}
+
+bool KV_Del(uint16_t key)
+{
+    if (!s_ready)
+    {
+        KV_Init();
+    }
+
+    int i = kv_index_find(key);
+    if (i < 0)
+    {
+        return true;
+    }
+
+    kv_flash_unlock();
+    if (s_wp + KV_REC_SIZE(0u) > KV_SECTOR_SIZE)
+    {
+        /* 放不下删除标记：先从索引去掉，GC 不再搬它即可 */
+        kv_index_set(key, 0u, 0u);
+        kv_gc();
+    }
+    else
+    {
+        kv_append(key, NULL, 0u);
+    }
+    s_stats.puts++;
+    kv_flash_lock();
+    return true;
+}
+
+void KV_GetStats(KV_Stats* out)
+{
+    if (out == NULL)
+    {
+        return;
+    }
+    *out        = s_stats;
+    out->seq    = s_seq;
+    out->used   = (uint16_t)s_wp;
+    out->live   = (uint16_t)(KV_SECTOR_HDR + kv_live_bytes());
+    out->keys   = s_index_cnt;
+    out->active = s_active;
+}
@@ -0,0 +1,87 @@
+/*********************************************************************
+ * @file kv_store.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 日志式键值存储：多扇区轮换、追加写、CRC 校验、RAM 索引查找
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 以前每项持久化数据独占一个 4KB 扇区，每改一次就整扇区擦除重写
+ *   （tpms_bind_store_save / flash_op_save_tpms_info），几十字节的改动换一次擦除；
+ *   再加 TBOX 密钥、NFC 钥匙表、0x64FD 设置就要各占一个扇区。
+ * - 现在所有项共用 KV_STORE_SECTORS 个扇区：改动只在活动扇区末尾追加一条记录，
+ *   写满才把有效记录搬到下一个扇区（GC），擦除次数按扇区轮流摊开。
+ * - 记录先写头和数据、最后单独写提交字节；扇区头先写序号、最后写 magic。
+ *   任何时刻掉电，重新挂载后每个键要么是旧值要么是新值。
+ * - 挂载时扫一遍活动扇区建 RAM 索引（键 -> 偏移），之后 KV_Get 只读一次 flash。
+ *
+ * @note 非线程安全：只在 os 任务上下文调用，不要在中断里调。
+ *********************************************************************/
+
+#ifndef KV_STORE_H
+#define KV_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* 键分配（0xFFFF 保留给擦除态） */
+#define KV_KEY_TPMS_BIND  0x0101u /* TPMS 绑定表（TPMS.c tpms_bind_store_t） */
+#define KV_KEY_TBOX_KEY   0x0201u /* 预留：TBOX 密钥 */
+#define KV_KEY_NFC_KEYS   0x0202u /* 预留：NFC 钥匙表 */
+#define KV_KEY_PARAM_64FD 0x0301u /* 预留：0x64FD 设置 */
+
+/* 同时存在的键个数上限（RAM 索引长度） */
+#ifndef KV_STORE_MAX_KEYS
+#define KV_STORE_MAX_KEYS 16
+#endif
+
+/* 单个值的最大长度 */
+#ifndef KV_VALUE_MAX
+#define KV_VALUE_MAX 240u
+#endif
+
+typedef struct
+{
+    uint32_t puts;       /* 真正落盘的 KV_Put/KV_Del 次数 */
+    uint32_t unchanged;  /* 内容与已存值相同而跳过的 KV_Put 次数 */
+    uint32_t put_bytes;  /* 落盘的 KV_Put 交来的数据字节（写放大的分母） */
+    uint32_t prog_bytes; /* 实际写入 flash 的字节：记录头、对齐、GC 搬运都算 */
+    uint32_t erases;     /* 擦除扇区数 */
+    uint32_t gc_runs;    /* GC 次数 */
+    uint32_t torn;       /* 挂载时丢弃的未提交/校验失败记录 */
+    uint32_t seq;        /* 活动扇区序号（每次 GC 加一） */
+    uint16_t used;       /* 活动扇区已用字节（含扇区头） */
+    uint16_t live;       /* 其中有效记录占用字节 */
+    uint8_t  keys;       /* 当前键个数 */
+    uint8_t  active;     /* 活动扇区下标 */
+} KV_Stats;
+
+/**
+ * @brief 挂载：找序号最大的有效扇区并扫描建立索引；没有有效扇区则格式化
+ * @note 其他接口第一次调用时会自动挂载；上电时显式调用一次，把扫描耗时放在初始化阶段。
+ */
+void KV_Init(void);
+
+/**
+ * @brief 写入/覆盖一个键
+ * @param len 1..KV_VALUE_MAX
+ * @return false：参数非法、索引已满或有效数据装不下一个扇区
+ * @note 与已存值逐字节相同时不写 flash，直接返回 true。
+ */
+bool KV_Put(uint16_t key, const void* data, uint16_t len);
+
+/**
+ * @brief 读取一个键
+ * @param cap 缓冲区长度，值比它长时只拷贝前 cap 字节
+ * @return 值的实际长度；0 = 不存在
+ */
+uint16_t KV_Get(uint16_t key, void* buf, uint16_t cap);
+
+/**
+ * @brief 删除一个键（不存在也返回 true）
+ */
+bool KV_Del(uint16_t key);
+
+void KV_GetStats(KV_Stats* out);
+
+#endif // KV_STORE_H
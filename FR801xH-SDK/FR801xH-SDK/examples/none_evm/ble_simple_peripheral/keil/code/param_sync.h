@@ -39,9 +39,32 @@ void ParamSync_NotifyChange(uint8_t intelligentSwitch1_vehicleStatus, uint16_t s
  */
 void ParamSync_OnAppReply(uint8_t conidx, uint16_t cmd, const uint8_t *payload, uint8_t len);
 
-/* 6.10 MCU -> SOC full payload (0x0208) */
+/**
+ * @brief 6.10 MCU -> SOC ȫϱ0x0208
+ * @details
+ * - 뻺ֶαȽϣֻѱ仯ֶμǵѼȨӵλ
+ * - ӻûյʱ 0x64FD ȫģʽʱֻ֮ 0x67FD ÿηȫ
+ * - ûֶα仯ʱκ֡
+ */
 void ParamSync_OnMcuSync64FD(const uint8_t *data, uint16_t len);
 
+/*
+ * 0x67FD ͬ豸 -> ֻ APPЭĵδ壬չ
+ *   payload = version(1) + count(1) + count * {fieldIndex(1), value(1)}
+ *   fieldIndex Ϊֶ 0x64FD payload е±꣬version Ϊ洢İ汾ţб仯 +1
+ * APP  0x6702ResultCode 0 ʱ˻ֻ 0x64FD ȫͬ
+ * Ĭ 0ȫ 0x64FD ȫÿб仯飩ԭ APP  0x67FD
+ * ᶪһο֮и£APP ֺ֧ 1  ParamSync_SetDeltaMode(true)
+ */
+#ifndef PARAM_SYNC_DELTA_ENABLE
+#define PARAM_SYNC_DELTA_ENABLE 0
+#endif
+
+/**
+ * @brief л/ȫģʽĬ PARAM_SYNC_DELTA_ENABLE
+ */
+void ParamSync_SetDeltaMode(bool enable);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,6 +10,7 @@
  */
 #include "phone_reply.h"
 
+#include "bcc.h"
 #include "protocol.h"
 #include "protocol_cmd.h"
 #include "rssi_check.h"
@@ -36,18 +37,6 @@
 #define PHONE_REPLY_CAR_SEARCH_VOLUME  0x02u
 #endif
 
-static uint8_t phone_reply_xor_bcc(const uint8_t *buf, uint16_t len)
-{
-	uint8_t bcc = 0;
-	if (buf == NULL || len == 0) {
-		return 0;
-	}
-	for (uint16_t i = 0; i < len; i++) {
-		bcc ^= buf[i];
-	}
-	return bcc;
-}
-
 bool PhoneReply_BuildFrame(uint16_t cmd,
 						   uint8_t seq,
 						   const uint8_t *payload,
@@ -97,16 +86,17 @@ bool PhoneReply_BuildFrameEx(uint16_t cmd,
 	out_frame[5] = (uint8_t)(cmd >> 8);
 	out_frame[6] = (uint8_t)(cmd & 0xFF);
 
-	if (payload_len > 0) {
-		if (payload == NULL) {
-			return false;
-		}
-		memcpy(&out_frame[7], payload, payload_len);
+	if (payload_len > 0 && payload == NULL) {
+		return false;
 	}
 
-	/* BCC：XOR，从 Header 到 Data（不包含 BCC/Footer） */
-	const uint16_t bcc_len = (uint16_t)(7u + payload_len);
-	out_frame[7 + payload_len] = phone_reply_xor_bcc(out_frame, bcc_len);
+	/*
+	 * BCC：XOR，从 Header 到 Data（不包含 BCC/Footer）。
+	 * 0x55^0x55 抵消，帧头只剩 5 个字节；Data 在拷贝的同一遍里累计，不再回扫整帧。
+	 */
+	uint8_t bcc = (uint8_t)(out_frame[2] ^ out_frame[3] ^ out_frame[4] ^ out_frame[5] ^ out_frame[6]);
+	bcc = Bcc_CopyXor(bcc, &out_frame[7], payload, payload_len);
+	out_frame[7 + payload_len] = bcc;
 
 	out_frame[8 + payload_len] = 0xAA;
 	out_frame[9 + payload_len] = 0xAA;
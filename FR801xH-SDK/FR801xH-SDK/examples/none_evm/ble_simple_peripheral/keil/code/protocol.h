@@ -8,6 +8,8 @@
 #define PROTOCOL_USE_ACK 0
 
 // 协议常量定义
+#define PROTOCOL_MAX_LEN        240 /* payload 最大长度，确保总长度 fits uint8_t length 字段 */
+#define PROTOCOL_TX_HDR_LEN     7   /* Header(2)+Length+Crypto+Seq+Cmd(2)，就地组帧时预留在数据段前 */
 #define PROTOCOL_HEADER_MAGIC   0x5555
 #define PROTOCOL_FOOTER_MAGIC   0xAAAA
 
@@ -124,6 +126,20 @@ int Protocol_Send_Unicast(uint8_t conidx, uint16_t cmd, const uint8_t *payload,
  */
 int Protocol_Send_Unicast_Async(uint8_t conidx, uint16_t cmd, const uint8_t *payload, uint16_t len);
 
+/**
+ * @brief 就地组帧发送（调用方直接把明文写进组帧块，省掉一次拷贝）
+ * @details
+ * - Protocol_Tx_Begin 租一块组帧块，返回数据段起点（前面已留好 7 字节帧头），
+ *   可写 PROTOCOL_MAX_LEN 字节；加密时要给 PKCS7 填充留位，明文不超过 PROTOCOL_MAX_LEN-16。
+ * - Protocol_Tx_Commit 原地加密、组帧、单播发出，无论成败都会归还块；
+ *   async=false 同 Protocol_Send_Unicast（回显请求流水号），true 同 _Async（新流水号）。
+ * - 写到一半不发了用 Protocol_Tx_Abort 归还。
+ * @return Begin: NULL=块池空；Commit: 同 Protocol_Send_Unicast
+ */
+uint8_t *Protocol_Tx_Begin(void);
+int      Protocol_Tx_Commit(uint8_t conidx, uint16_t cmd, uint8_t *data, uint16_t len, bool async);
+void     Protocol_Tx_Abort(uint8_t *data);
+
 /*
  * 若 payload 是编译期已知大小的数组，可用此宏自动计算 len：
  *  Protocol_Send_Broadcast_ARRAY(cmd, array, critical);
@@ -37,6 +37,7 @@
 #define set_intelligent_switch  0x63FD//设置智能开关
 #define paramter_synchronize    0x64FD//参数同步(每次蓝牙连接上了都要同步一次)
 #define paramter_synchronize_change 0x66FD//参数同步变化(参数变化后立即同步)
+#define paramter_synchronize_delta  0x67FD//参数增量同步(只推变化的字段，本工程扩展)
 #define set_default_mode        0x65FD//设置默认模式
 #define set_vichle_gurd_mode    0x09FD//设置车辆防盗
 #define set_auto_return_mode    0x0aFD//设置自动归位
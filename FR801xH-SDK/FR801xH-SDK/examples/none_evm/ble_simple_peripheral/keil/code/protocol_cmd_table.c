@@ -0,0 +1,91 @@
+/*********************************************************************
+ * @file protocol_cmd_table.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 手机 FE/FD 命令描述符查找 + BLE->MCU 映射规则解释
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "protocol_cmd_table.h"
+#include "protocol_fe.h"
+#include "protocol_fd.h"
+
+const protocol_cmd_desc_t* Protocol_Cmd_Find(uint16_t cmd)
+{
+    switch (cmd & 0xFFu)
+    {
+        case 0xFEu:
+            return Protocol_FE_Find(cmd);
+        case 0xFDu:
+            return Protocol_FD_Find(cmd);
+        default:
+            return NULL;
+    }
+}
+
+static uint16_t protocol_mcu_pick(const uint16_t* ids, uint8_t n_ids, uint16_t dflt, uint16_t key)
+{
+    return (key < n_ids) ? ids[key] : dflt;
+}
+
+uint16_t Protocol_Cmd_MapMcuId(const protocol_mcu_map_t* m,
+                               const uint8_t*            payload,
+                               uint16_t                  payload_len)
+{
+    uint16_t pos;
+
+    if (m == NULL)
+    {
+        return 0u;
+    }
+
+    switch (m->key)
+    {
+        case PROTOCOL_MCU_KEY_NONE:
+            return m->dflt;
+        case PROTOCOL_MCU_KEY_LEN:
+            if (payload_len < m->off)
+            {
+                return m->short_id;
+            }
+            return protocol_mcu_pick(m->ids, m->n_ids, m->dflt, (uint16_t)(payload_len - m->off));
+        case PROTOCOL_MCU_KEY_BYTE:
+            if (payload == NULL || payload_len <= m->off)
+            {
+                return m->short_id;
+            }
+            pos = m->off;
+            break;
+        case PROTOCOL_MCU_KEY_TIME6_OPT:
+            if (payload == NULL || payload_len == 0u)
+            {
+                return m->short_id;
+            }
+            pos = (payload_len >= 7u) ? 6u : 0u;
+            break;
+        case PROTOCOL_MCU_KEY_TIME6_LAST:
+            if (payload == NULL || payload_len == 0u)
+            {
+                return m->short_id;
+            }
+            pos = (payload_len >= 7u) ? 6u : (uint16_t)(payload_len - 1u);
+            break;
+        default:
+            return 0u;
+    }
+
+    /* controlType 二级分派：key 后面还有一个字节才看 */
+    if (m->n_sub > 0u && payload_len >= (uint16_t)(pos + 2u))
+    {
+        uint8_t type = payload[pos + 1u];
+        for (uint8_t i = 0u; i < m->n_sub; i++)
+        {
+            const protocol_mcu_sub_t* s = &m->sub[i];
+            if (s->type == type)
+            {
+                return protocol_mcu_pick(s->ids, s->n_ids, s->dflt, payload[pos]);
+            }
+        }
+    }
+    return protocol_mcu_pick(m->ids, m->n_ids, m->dflt, payload[pos]);
+}
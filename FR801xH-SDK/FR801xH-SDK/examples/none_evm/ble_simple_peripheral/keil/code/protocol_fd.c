@@ -1,57 +1,202 @@
 #include "protocol_fd.h"
 #include "protocol_cmd.h"
+#include "protocol_cmd_table.h"
 #include "ble_function.h"
-#include "co_printf.h"
-
-typedef void (*fd_cmd_handler_t)(uint16_t cmd, const uint8_t* payload, uint8_t len);
-
-typedef struct
-{
-    uint16_t         cmd;
-    fd_cmd_handler_t handler;
-} fd_cmd_entry_t;
-
-static const fd_cmd_entry_t s_fd_cmd_table[] = {
-    {assistive_trolley, BleFunc_FD_AssistiveTrolley},
-    {delayed_headlight, BleFunc_FD_DelayedHeadlight},
-    {set_charging_power, BleFunc_FD_SetChargingPower},
-    {set_p_gear_mode, BleFunc_FD_SetPGearMode},
-    {set_chord_horn_mode, BleFunc_FD_SetChordHornMode},
-    {set_RGB_light_mode, BleFunc_FD_SetRgbLightMode},
-    {set_auxiliary_parking, BleFunc_FD_SetAuxiliaryParking},
-    {set_intelligent_switch, BleFunc_FD_SetIntelligentSwitch},
-    {paramter_synchronize, BleFunc_FD_ParamSynchronize},
-    {paramter_synchronize_change, BleFunc_FD_ParamSynchronizeChange},
-    {set_default_mode, BleFunc_FD_SetDefaultMode},
-    {set_vichle_gurd_mode, BleFunc_FD_SetVichleGurdMode},
-    {set_auto_return_mode, BleFunc_FD_SetAutoReturnMode},
-    {set_EBS_switch, BleFunc_FD_SetEbsSwitch},
-    {set_E_SAVE_mode, BleFunc_FD_SetESaveMode},
-    {set_DYN_mode, BleFunc_FD_SetDynMode},
-    {set_sport_mode, BleFunc_FD_SetSportMode},
-    {set_lost_mode, BleFunc_FD_SetLostMode},
-    {set_TCS_switch, BleFunc_FD_SetTcsSwitch},
-    {set_side_stand, BleFunc_FD_SetSideStand},
-    {set_battery_parameter, BleFunc_FD_SetBatteryParameter},
-    {set_updata_APP, BleFunc_FD_SetUpdataApp},
-    {set_HDC_mode, BleFunc_FD_SetHdcMode},
-    {set_HHC_mode, BleFunc_FD_SetHhcMode},
-    {set_start_ability, BleFunc_FD_SetStartAbility},
-    {set_sport_power_speed, BleFunc_FD_SetSportPowerSpeed},
-    {set_ECO_mode, BleFunc_FD_SetEcoMode},
-    {set_radar_switch, BleFunc_FD_SetRadarSwitch},
+#include "usart_cmd.h"
+#include "app_log.h"
+
+#include <stddef.h>
+
+/* ---- BLE -> MCU 命令号映射（payload = Time6 + control...，control: 0 关 / 1 开 / 2 默认 / 3 时间） ---- */
+
+static const uint16_t s_fd_ids_trolley[] = {CMD_Assistive_trolley_mode_off,
+                                            CMD_Assistive_trolley_mode_on,
+                                            CMD_Assistive_trolley_mode_default};
+static const protocol_mcu_map_t s_fd_map_trolley =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_trolley, 0u, 0u);
+
+static const uint16_t s_fd_ids_headlight[] = {CMD_Delayed_headlight_off,
+                                              CMD_Delayed_headlight_on,
+                                              CMD_Delayed_headlight_default,
+                                              CMD_Delayed_headlight_time_set};
+static const protocol_mcu_map_t s_fd_map_headlight =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_headlight, 0u, 0u);
+
+static const protocol_mcu_map_t s_fd_map_charging_power = PROTOCOL_MCU_FIXED(CMD_Charging_power_set);
+
+static const uint16_t s_fd_ids_p_gear[] = {CMD_AUTO_P_GEAR_off,
+                                           CMD_AUTO_P_GEAR_on,
+                                           CMD_AUTO_P_GEAR_default,
+                                           CMD_AUTO_P_GEAR_time_set};
+static const protocol_mcu_map_t s_fd_map_p_gear =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_p_gear, 0u, 0u);
+
+/*
+ * 和弦喇叭（0x06FD）不在这里映射：BLE payload = Time6 + soundSource + volume，
+ * MCU 侧是 type_set(0x59) / volume_set(0x60) 两条命令，由
+ * BleFunc_FD_SetChordHornMode() 拆成两步下发。
+ */
+
+static const protocol_mcu_map_t s_fd_map_rgb_mode =
+    PROTOCOL_MCU_FIXED(CMD_Three_shooting_lamp_mode_set);
+
+static const uint16_t s_fd_ids_reversing[] = {CMD_Assistive_reversing_gear_off,
+                                              CMD_Assistive_reversing_gear_on,
+                                              CMD_Assistive_reversing_gear_default};
+static const protocol_mcu_map_t s_fd_map_reversing =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_reversing, 0u, 0u);
+
+/*
+ * 6.9 智能开关：payload = [Time6 +] control(1) + controlType(1)。
+ * 先按 controlType 识别充电显示器 / 三色氛围灯，其他类型（或没有 controlType）
+ * 按动力回收开关映射。
+ */
+static const uint16_t s_fd_ids_power_recover[] = {CMD_POWER_RECOVER_OFF, CMD_POWER_RECOVER_ON};
+static const uint16_t s_fd_ids_charge_display[] = {CMD_CHARGE_DISPLAY_OFF, CMD_CHARGE_DISPLAY_ON};
+static const uint16_t s_fd_ids_lamp[] = {CMD_Three_shooting_lamp_off,
+                                         CMD_Three_shooting_lamp_on,
+                                         CMD_Three_shooting_lamp_default};
+static const protocol_mcu_sub_t s_fd_sub_switch[] = {
+    {0x04u, (uint8_t)PROTOCOL_ARRAY_SIZE(s_fd_ids_charge_display), CMD_CHARGE_DISPLAY_OFF,
+     s_fd_ids_charge_display},
+    {0x0Au, (uint8_t)PROTOCOL_ARRAY_SIZE(s_fd_ids_lamp), 0u, s_fd_ids_lamp},
 };
+static const protocol_mcu_map_t s_fd_map_switch = PROTOCOL_MCU_TABLE_SUB(
+    PROTOCOL_MCU_KEY_TIME6_OPT, 6u, s_fd_ids_power_recover, 0u, 0u, s_fd_sub_switch);
+
+/* 6.13 车辆防盗告警：MCU 侧复用油车设防命令 0x31 */
+static const protocol_mcu_map_t s_fd_map_guard = PROTOCOL_MCU_FIXED(CMD_OIL_VEHICLE_PREVENTION);
+
+static const uint16_t s_fd_ids_auto_return[] = {CMD_Automatic_steering_reset_off,
+                                                CMD_Automatic_steering_reset_on,
+                                                CMD_Automatic_steering_reset_default};
+static const protocol_mcu_map_t s_fd_map_auto_return =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_auto_return, 0u, 0u);
+
+/* EBS：开关/类型在 data 段透传 */
+static const protocol_mcu_map_t s_fd_map_ebs = PROTOCOL_MCU_FIXED(CMD_EBS_switch_on);
+
+/* 低/中/高速档：control 在 payload[0]（不带 Time6） */
+static const uint16_t s_fd_ids_low_gear[] = {CMD_Low_speed_gear_off,
+                                             CMD_Low_speed_gear_on,
+                                             CMD_Low_speed_gear_default};
+static const protocol_mcu_map_t s_fd_map_low_gear =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 0u, s_fd_ids_low_gear, 0u, 0u);
+
+static const uint16_t s_fd_ids_mid_gear[] = {CMD_Medium_speed_gear_off,
+                                             CMD_Medium_speed_gear_on,
+                                             CMD_Medium_speed_gear_default};
+static const protocol_mcu_map_t s_fd_map_mid_gear =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 0u, s_fd_ids_mid_gear, 0u, 0u);
+
+static const uint16_t s_fd_ids_high_gear[] = {CMD_High_speed_gear_off,
+                                              CMD_High_speed_gear_on,
+                                              CMD_High_speed_gear_default};
+static const protocol_mcu_map_t s_fd_map_high_gear =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 0u, s_fd_ids_high_gear, 0u, 0u);
+
+/* 以下开关：control==0x01 开，其他值关 */
+static const uint16_t s_fd_ids_lost[] = {CMD_Lost_mode_off, CMD_Lost_mode_on};
+static const protocol_mcu_map_t s_fd_map_lost =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_lost, CMD_Lost_mode_off, 0u);
+
+static const uint16_t s_fd_ids_tcs[] = {CMD_TCS_switch_off, CMD_TCS_switch_on};
+static const protocol_mcu_map_t s_fd_map_tcs =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_tcs, CMD_TCS_switch_off, 0u);
+
+static const uint16_t s_fd_ids_side_stand[] = {CMD_Side_stand_switch_off, CMD_Side_stand_switch_on};
+static const protocol_mcu_map_t s_fd_map_side_stand = PROTOCOL_MCU_TABLE(
+    PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_side_stand, CMD_Side_stand_switch_off, 0u);
+
+/* 电池类型与容量：先按 type_set 下发，data 段透传 */
+static const protocol_mcu_map_t s_fd_map_battery = PROTOCOL_MCU_FIXED(CMD_Battery_type_set);
+
+static const uint16_t s_fd_ids_hdc[] = {CMD_HDC_switch_off, CMD_HDC_switch_on};
+static const protocol_mcu_map_t s_fd_map_hdc =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_hdc, CMD_HDC_switch_off, 0u);
+
+static const uint16_t s_fd_ids_hhc[] = {CMD_HHC_switch_off, CMD_HHC_switch_on};
+static const protocol_mcu_map_t s_fd_map_hhc =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fd_ids_hhc, CMD_HHC_switch_off, 0u);
+
+/* ---- FD 命令表：cmd / 处理函数 / MCU 映射（新命令只加一行） ---- */
+#define PROTOCOL_FD_CMD_LIST(X)                                                                \
+    X(assistive_trolley,           BleFunc_FD_AssistiveTrolley,         &s_fd_map_trolley)        \
+    X(delayed_headlight,           BleFunc_FD_DelayedHeadlight,         &s_fd_map_headlight)      \
+    X(set_charging_power,          BleFunc_FD_SetChargingPower,         &s_fd_map_charging_power) \
+    X(set_p_gear_mode,             BleFunc_FD_SetPGearMode,             &s_fd_map_p_gear)         \
+    X(set_chord_horn_mode,         BleFunc_FD_SetChordHornMode,         NULL)                     \
+    X(set_RGB_light_mode,          BleFunc_FD_SetRgbLightMode,          &s_fd_map_rgb_mode)       \
+    X(set_auxiliary_parking,       BleFunc_FD_SetAuxiliaryParking,      &s_fd_map_reversing)      \
+    X(set_intelligent_switch,      BleFunc_FD_SetIntelligentSwitch,     &s_fd_map_switch)         \
+    X(paramter_synchronize,        BleFunc_FD_ParamSynchronize,         NULL)                     \
+    X(paramter_synchronize_change, BleFunc_FD_ParamSynchronizeChange,   NULL)                     \
+    X(set_default_mode,            BleFunc_FD_SetDefaultMode,           NULL)                     \
+    X(set_vichle_gurd_mode,        BleFunc_FD_SetVichleGurdMode,        &s_fd_map_guard)          \
+    X(set_auto_return_mode,        BleFunc_FD_SetAutoReturnMode,        &s_fd_map_auto_return)    \
+    X(set_EBS_switch,              BleFunc_FD_SetEbsSwitch,             &s_fd_map_ebs)            \
+    X(set_E_SAVE_mode,             BleFunc_FD_SetESaveMode,             &s_fd_map_low_gear)       \
+    X(set_DYN_mode,                BleFunc_FD_SetDynMode,               &s_fd_map_mid_gear)       \
+    X(set_sport_mode,              BleFunc_FD_SetSportMode,             &s_fd_map_high_gear)      \
+    X(set_lost_mode,               BleFunc_FD_SetLostMode,              &s_fd_map_lost)           \
+    X(set_TCS_switch,              BleFunc_FD_SetTcsSwitch,             &s_fd_map_tcs)            \
+    X(set_side_stand,              BleFunc_FD_SetSideStand,             &s_fd_map_side_stand)     \
+    X(set_battery_parameter,       BleFunc_FD_SetBatteryParameter,      &s_fd_map_battery)        \
+    X(set_updata_APP,              BleFunc_FD_SetUpdataApp,             NULL)                     \
+    X(set_HDC_mode,                BleFunc_FD_SetHdcMode,               &s_fd_map_hdc)            \
+    X(set_HHC_mode,                BleFunc_FD_SetHhcMode,               &s_fd_map_hhc)            \
+    X(set_start_ability,           BleFunc_FD_SetStartAbility,          NULL)                     \
+    X(set_sport_power_speed,       BleFunc_FD_SetSportPowerSpeed,       NULL)                     \
+    X(set_ECO_mode,                BleFunc_FD_SetEcoMode,               NULL)                     \
+    X(set_radar_switch,            BleFunc_FD_SetRadarSwitch,           NULL)
+
+enum {
+    PROTOCOL_FD_CMD_LIST(PROTOCOL_CMD_POS)
+    PROTOCOL_FD_CMD_COUNT
+};
+
+/* 编译期校验：低字节必须是 FD（否则这里除零） */
+#define PROTOCOL_FD_TYPE_CHECK(cmd, handler, mcu) \
+    PROTOCOL_FD_CHECK_##cmd = 1 / ((((cmd) & 0xFFu) == 0xFDu) ? 1 : 0),
+enum {
+    PROTOCOL_FD_CMD_LIST(PROTOCOL_FD_TYPE_CHECK)
+};
+
+/* 编译期校验：高字节重复 = 重复 case 标签（不会被调用） */
+static inline void protocol_fd_dup_check(uint8_t hi) {
+    switch (hi) {
+        PROTOCOL_FD_CMD_LIST(PROTOCOL_CMD_CASE)
+        break;
+    default:
+        break;
+    }
+}
+
+static const protocol_cmd_desc_t s_fd_cmd_table[PROTOCOL_FD_CMD_COUNT] = {
+    PROTOCOL_FD_CMD_LIST(PROTOCOL_CMD_DESC)
+};
+
+/* 命令号高字节 -> 表内位置 + 1（0 = 未定义） */
+static const uint8_t s_fd_cmd_index[256] = {
+    PROTOCOL_FD_CMD_LIST(PROTOCOL_CMD_INDEX)
+};
+
+const protocol_cmd_desc_t* Protocol_FD_Find(uint16_t cmd) {
+    uint8_t pos = s_fd_cmd_index[(cmd >> 8) & 0xFFu];
+
+    if (pos == 0u || (cmd & 0xFFu) != 0xFDu) {
+        return NULL;
+    }
+    return &s_fd_cmd_table[pos - 1u];
+}
 
 void Protocol_Process_FD(uint16_t cmd, uint8_t* payload, uint8_t len) {
-    co_printf("Protocol: Processing FD Cmd 0x%04X\r\n", cmd);
+    const protocol_cmd_desc_t* d = Protocol_FD_Find(cmd);
 
-    for (uint32_t i = 0; i < (uint32_t)(sizeof(s_fd_cmd_table) / sizeof(s_fd_cmd_table[0])); i++) {
-        if (s_fd_cmd_table[i].cmd != cmd) {
-            continue;
-        }
-        s_fd_cmd_table[i].handler(cmd, (const uint8_t*)payload, len);
+    if (d == NULL) {
+        APP_LOGW("  -> Unknown FD Cmd: 0x%04X\r\n", cmd);
         return;
     }
-
-    co_printf("  -> Unknown FD Cmd: 0x%04X\r\n", cmd);
+    APP_LOGD("Protocol: Processing FD Cmd 0x%04X\r\n", cmd);
+    d->handler(cmd, (const uint8_t*)payload, len);
 }
@@ -1,58 +1,144 @@
 #include "protocol_fe.h"
 #include "protocol_cmd.h"
+#include "protocol_cmd_table.h"
 #include "ble_function.h"
-#include "co_printf.h"
+#include "usart_cmd.h"
+#include "app_log.h"
 
 #include <stddef.h>
 
-typedef void (*fe_cmd_handler_t)(uint16_t cmd, const uint8_t* payload, uint8_t len);
+/* ---- BLE -> MCU 命令号映射（payload = Time6 + control...） ---- */
 
-typedef struct
+/* control==0x00 撤防，其他值设防 */
+static const uint16_t s_fe_ids_prevention[] = {CMD_OIL_VEHICLE_UNPREVENTION};
+static const protocol_mcu_map_t s_fe_map_prevention = PROTOCOL_MCU_TABLE(
+    PROTOCOL_MCU_KEY_BYTE, 6u, s_fe_ids_prevention, CMD_OIL_VEHICLE_PREVENTION, 0u);
+
+/* 蓝牙感应解锁开关：没有 Time6 时取最后一个字节，空 payload 按关闭 */
+static const uint16_t s_fe_ids_rssi_lock[] = {CMD_BLE_RSSI_LOCK_OFF, CMD_BLE_RSSI_LOCK_ON};
+static const protocol_mcu_map_t s_fe_map_rssi_lock =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_TIME6_LAST, 6u, s_fe_ids_rssi_lock,
+                       CMD_BLE_RSSI_LOCK_OFF, CMD_BLE_RSSI_LOCK_OFF);
+
+static const protocol_mcu_map_t s_fe_map_rssi_range = PROTOCOL_MCU_FIXED(CMD_BLE_RSSI_RANGE_SET);
+
+/* 电车寻车没有单独的 MCU 命令，沿用油车寻车（0x32），payload 透传由 MCU 决定动作 */
+static const protocol_mcu_map_t s_fe_map_find = PROTOCOL_MCU_FIXED(CMD_OIL_VEHICLE_FIND_STATUS);
+
+static const protocol_mcu_map_t s_fe_map_add_nfc    = PROTOCOL_MCU_FIXED(CMD_ADD_NFC_KEY);
+static const protocol_mcu_map_t s_fe_map_delete_nfc = PROTOCOL_MCU_FIXED(CMD_DELETE_NFC_KEY);
+
+static const uint16_t s_fe_ids_trunk[] = {CMD_OIL_VEHICLE_UNLOCK_TRUNK};
+static const protocol_mcu_map_t s_fe_map_trunk = PROTOCOL_MCU_TABLE(
+    PROTOCOL_MCU_KEY_BYTE, 6u, s_fe_ids_trunk, CMD_OIL_VEHICLE_LOCK_TRUNK, 0u);
+
+static const protocol_mcu_map_t s_fe_map_nfc_switch = PROTOCOL_MCU_FIXED(CMD_NFC_SWITCH);
+
+static const uint16_t s_fe_ids_seat[] = {CMD_VEHICLE_UNLOCK_SEAT};
+static const protocol_mcu_map_t s_fe_map_seat = PROTOCOL_MCU_TABLE(
+    PROTOCOL_MCU_KEY_BYTE, 6u, s_fe_ids_seat, CMD_VEHICLE_LOCK_SEAT, 0u);
+
+static const protocol_mcu_map_t s_fe_map_mute = PROTOCOL_MCU_FIXED(CMD_VEHICLE_MUTE_SETTING);
+
+static const uint16_t s_fe_ids_mid_box[] = {CMD_VEHICLE_UNLOCK_MIDDLE_BOX};
+static const protocol_mcu_map_t s_fe_map_mid_box = PROTOCOL_MCU_TABLE(
+    PROTOCOL_MCU_KEY_BYTE, 6u, s_fe_ids_mid_box, CMD_VEHICLE_LOCK_MIDDLE_BOX, 0u);
+
+static const uint16_t s_fe_ids_emergency[] = {CMD_VEHICLE_EMERGENCY_MODE_UNLOCK,
+                                              CMD_VEHICLE_EMERGENCY_MODE_LOCK};
+static const protocol_mcu_map_t s_fe_map_emergency =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_BYTE, 6u, s_fe_ids_emergency,
+                       CMD_VEHICLE_EMERGENCY_MODE_UNLOCK, 0u);
+
+/* len==6 获取 MAC；len==7 单控开锁 */
+static const uint16_t s_fe_ids_phone_mac[] = {CMD_BLE_MAC_READ, CMD_SINGLE_CONTROL_UNLOCK};
+static const protocol_mcu_map_t s_fe_map_phone_mac =
+    PROTOCOL_MCU_TABLE(PROTOCOL_MCU_KEY_LEN, 6u, s_fe_ids_phone_mac, 0u, 0u);
+
+static const uint16_t s_fe_ids_charge_display[] = {CMD_CHARGE_DISPLAY_OFF, CMD_CHARGE_DISPLAY_ON};
+static const protocol_mcu_map_t s_fe_map_charge_display = PROTOCOL_MCU_TABLE(
+    PROTOCOL_MCU_KEY_BYTE, 6u, s_fe_ids_charge_display, CMD_CHARGE_DISPLAY_OFF, 0u);
+
+/* ---- FE 命令表：cmd / 处理函数 / MCU 映射（新命令只加一行） ---- */
+#define PROTOCOL_FE_CMD_LIST(X)                                                    \
+    X(connect_ID,            BleFunc_FE_Connect,         NULL)                     \
+    X(defences_ID,           BleFunc_FE_Defences,        &s_fe_map_prevention)     \
+    X(anti_theft_ID,         BleFunc_FE_AntiTheft,       &s_fe_map_rssi_lock)      \
+    X(phone_message_ID,      BleFunc_FE_PhoneMessage,    NULL)                     \
+    X(riss_strength_ID,      BleFunc_FE_RssiStrength,    &s_fe_map_rssi_range)     \
+    X(car_search_ID,         BleFunc_FE_CarSearch,       &s_fe_map_find)           \
+    X(factory_settings_ID,   BleFunc_FE_FactorySettings, NULL)                     \
+    X(ble_unpair_ID,         BleFunc_FE_BleUnpair,       NULL)                     \
+    X(add_nfc_ID,            BleFunc_FE_AddNfc,          &s_fe_map_add_nfc)        \
+    X(delete_nfc_ID,         BleFunc_FE_DeleteNfc,       &s_fe_map_delete_nfc)     \
+    X(search_nfc_ID,         BleFunc_FE_SearchNfc,       NULL)                     \
+    X(oil_defence_ID,        BleFunc_FE_OilDefence,      &s_fe_map_prevention)     \
+    X(oil_car_search_ID,     BleFunc_FE_OilCarSearch,    &s_fe_map_find)           \
+    X(set_boot_lock_ID,      BleFunc_FE_SetBootLock,     &s_fe_map_trunk)          \
+    X(set_nfc_ID,            BleFunc_FE_SetNfc,          &s_fe_map_nfc_switch)     \
+    X(set_seat_lock_ID,      BleFunc_FE_SetSeatLock,     &s_fe_map_seat)           \
+    X(set_car_mute_ID,       BleFunc_FE_SetCarMute,      &s_fe_map_mute)           \
+    X(set_mid_box_lock_ID,   BleFunc_FE_SetMidBoxLock,   &s_fe_map_mid_box)        \
+    X(set_emergency_mode_ID, BleFunc_FE_SetEmergencyMode, &s_fe_map_emergency)     \
+    X(get_phone_mac_ID,      BleFunc_FE_GetPhoneMac,     &s_fe_map_phone_mac)      \
+    X(set_unlock_mode_ID,    BleFunc_FE_SetUnlockMode,   NULL)                     \
+    X(charge_display_ID,     BleFunc_FE_ChargeDisplay,   &s_fe_map_charge_display)
+
+enum
 {
-    uint16_t cmd;
-    fe_cmd_handler_t handler;
-} fe_cmd_entry_t;
-
-static const fe_cmd_entry_t s_fe_cmd_table[] = {
-    { connect_ID,            BleFunc_FE_Connect },
-    { defences_ID,           BleFunc_FE_Defences },
-    { anti_theft_ID,         BleFunc_FE_AntiTheft },
-    { phone_message_ID,      BleFunc_FE_PhoneMessage },
-    { riss_strength_ID,      BleFunc_FE_RssiStrength },
-    { car_search_ID,         BleFunc_FE_CarSearch },
-    { factory_settings_ID,   BleFunc_FE_FactorySettings },
-    { ble_unpair_ID,         BleFunc_FE_BleUnpair },
-    { add_nfc_ID,            BleFunc_FE_AddNfc },
-    { delete_nfc_ID,         BleFunc_FE_DeleteNfc },
-    { search_nfc_ID,         BleFunc_FE_SearchNfc },
-    { oil_defence_ID,        BleFunc_FE_OilDefence },
-    { oil_car_search_ID,     BleFunc_FE_OilCarSearch },
-    { set_boot_lock_ID,      BleFunc_FE_SetBootLock },
-    { set_nfc_ID,            BleFunc_FE_SetNfc },
-    { set_seat_lock_ID,      BleFunc_FE_SetSeatLock },
-    { set_car_mute_ID,       BleFunc_FE_SetCarMute },
-    { set_mid_box_lock_ID,   BleFunc_FE_SetMidBoxLock },
-    { set_emergency_mode_ID, BleFunc_FE_SetEmergencyMode },
-    { get_phone_mac_ID,      BleFunc_FE_GetPhoneMac },
-    { set_unlock_mode_ID,    BleFunc_FE_SetUnlockMode },
-    { charge_display_ID,     BleFunc_FE_ChargeDisplay },
+    PROTOCOL_FE_CMD_LIST(PROTOCOL_CMD_POS)
+    PROTOCOL_FE_CMD_COUNT
 };
 
-void Protocol_Process_FE(uint16_t cmd, uint8_t* payload, uint8_t len)
+/* 编译期校验：低字节必须是 FE（否则这里除零） */
+#define PROTOCOL_FE_TYPE_CHECK(cmd, handler, mcu) \
+    PROTOCOL_FE_CHECK_##cmd = 1 / ((((cmd) & 0xFFu) == 0xFEu) ? 1 : 0),
+enum
+{
+    PROTOCOL_FE_CMD_LIST(PROTOCOL_FE_TYPE_CHECK)
+};
+
+/* 编译期校验：高字节重复 = 重复 case 标签（不会被调用） */
+static inline void protocol_fe_dup_check(uint8_t hi)
 {
-    co_printf("Protocol: Processing FE Cmd 0x%04X\r\n", cmd);
+    switch (hi)
+    {
+        PROTOCOL_FE_CMD_LIST(PROTOCOL_CMD_CASE)
+        break;
+        default:
+            break;
+    }
+}
 
-    for (uint32_t i = 0; i < (uint32_t)(sizeof(s_fe_cmd_table) / sizeof(s_fe_cmd_table[0])); i++)
+static const protocol_cmd_desc_t s_fe_cmd_table[PROTOCOL_FE_CMD_COUNT] = {
+    PROTOCOL_FE_CMD_LIST(PROTOCOL_CMD_DESC)
+};
+
+/* 命令号高字节 -> 表内位置 + 1（0 = 未定义） */
+static const uint8_t s_fe_cmd_index[256] = {
+    PROTOCOL_FE_CMD_LIST(PROTOCOL_CMD_INDEX)
+};
+
+const protocol_cmd_desc_t* Protocol_FE_Find(uint16_t cmd)
+{
+    uint8_t pos = s_fe_cmd_index[(cmd >> 8) & 0xFFu];
+
+    if (pos == 0u || (cmd & 0xFFu) != 0xFEu)
     {
-        if (s_fe_cmd_table[i].cmd != cmd)
-        {
-            continue;
-        }
+        return NULL;
+    }
+    return &s_fe_cmd_table[pos - 1u];
+}
+
+void Protocol_Process_FE(uint16_t cmd, uint8_t* payload, uint8_t len)
+{
+    const protocol_cmd_desc_t* d = Protocol_FE_Find(cmd);
 
-        // handler 在表里保证非空
-        s_fe_cmd_table[i].handler(cmd, (const uint8_t*)payload, len);
+    if (d == NULL)
+    {
+        APP_LOGW("  -> Unknown FE Cmd: 0x%04X\r\n", cmd);
         return;
     }
-
-    co_printf("  -> Unknown FE Cmd: 0x%04X\r\n", cmd);
+    APP_LOGD("Protocol: Processing FE Cmd 0x%04X\r\n", cmd);
+    d->handler(cmd, (const uint8_t*)payload, len);
 }
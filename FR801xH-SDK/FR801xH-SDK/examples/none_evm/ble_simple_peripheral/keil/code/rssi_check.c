@@ -6,6 +6,9 @@
  * - 3 点平均：消除突发抖动
  * - EMA：平滑趋势，alpha=0.3 兼顾响应速度与平滑性
  * - 滞回：避免阈值边界频繁切换
+ *
+ * 采样：RSSI_Check_Enable_Sampling 后由本模块按距离状态调度采样周期
+ * （过渡带/移动中快采，稳定 NEAR/LOST 慢采），见 rssi_schedule_update()。
  */
 
 #include "rssi_check.h"
@@ -34,33 +37,42 @@ static bool    RSSI_Checker_IsNear_Impl(RSSI_Checker* self, uint8_t conidx);
 static bool    RSSI_Checker_IsLost_Impl(RSSI_Checker* self, uint8_t conidx);
 static void    RSSI_Checker_Reset_Impl(RSSI_Checker* self, uint8_t conidx);
 
+/* 滤波输出限幅到 int8 范围（上报给 MCU 的是 1 字节） */
+static int16_t rssi_filter_clamp(int16_t v)
+{
+    if (v > 127)
+    {
+        return 127;
+    }
+    if (v < -127)
+    {
+        return -127;
+    }
+    return v;
+}
+
 /**
  * @brief 3 点平均 + EMA 滤波
  * @param ctx RSSI 上下文
  * @param raw 原始 RSSI 值
  * @return 滤波后的 RSSI
  */
-static int8_t rssi_filter_3avg_ema(RSSI_ConnCtx* ctx, int8_t raw)
+static int16_t rssi_filter_3avg_ema(RSSI_ConnCtx* ctx, int8_t raw)
 {
-    if (!ctx)
-    {
-        return raw;
-    }
-
     /* 3 点平均 */
-    ctx->s3_buf[ctx->s3_idx] = raw;
-    ctx->s3_idx              = (ctx->s3_idx + 1) % 3;
-    if (ctx->s3_cnt < 3)
+    ctx->flt.avg3.buf[ctx->flt.avg3.idx] = raw;
+    ctx->flt.avg3.idx                    = (ctx->flt.avg3.idx + 1) % 3;
+    if (ctx->flt.avg3.cnt < 3)
     {
-        ctx->s3_cnt++;
+        ctx->flt.avg3.cnt++;
     }
 
     int16_t sum = 0;
-    for (uint8_t i = 0; i < ctx->s3_cnt; i++)
+    for (uint8_t i = 0; i < ctx->flt.avg3.cnt; i++)
     {
-        sum += ctx->s3_buf[i];
+        sum += ctx->flt.avg3.buf[i];
     }
-    int8_t avg3 = (int8_t)(sum / ctx->s3_cnt);
+    int8_t avg3 = (int8_t)(sum / ctx->flt.avg3.cnt);
 
     /* EMA：ema = ema + alpha * (x - ema)，alpha=0.3 */
     if (!ctx->ema_inited)
@@ -74,17 +86,144 @@ static int8_t rssi_filter_3avg_ema(RSSI_ConnCtx* ctx, int8_t raw)
         ctx->ema     = ctx->ema + (diff * 3) / 10; /* alpha=0.3 */
     }
 
-    /* 限幅 */
-    if (ctx->ema > 127)
+    ctx->ema = rssi_filter_clamp(ctx->ema);
+    return ctx->ema;
+}
+
+static void rssi_filter_3avg_ema_reset(RSSI_ConnCtx* ctx)
+{
+    ctx->flt.avg3.cnt = 0;
+    ctx->flt.avg3.idx = 0;
+}
+
+/* MEDIAN / TRIMMED 共用：样本入窗，返回按升序排好的窗口副本 */
+static uint8_t rssi_filter_win_sorted(RSSI_ConnCtx* ctx, int8_t raw, int8_t* out)
+{
+    ctx->flt.win.buf[ctx->flt.win.idx] = raw;
+    ctx->flt.win.idx = (uint8_t)((ctx->flt.win.idx + 1u) % RSSI_FILTER_WIN);
+    if (ctx->flt.win.cnt < RSSI_FILTER_WIN)
     {
-        ctx->ema = 127;
+        ctx->flt.win.cnt++;
     }
-    else if (ctx->ema < -127)
+
+    /* 窗口只有几个数：插入排序就够了 */
+    uint8_t n = ctx->flt.win.cnt;
+    for (uint8_t i = 0; i < n; i++)
     {
-        ctx->ema = -127;
+        int8_t  v = ctx->flt.win.buf[i];
+        uint8_t j = i;
+        while (j > 0 && out[j - 1] > v)
+        {
+            out[j] = out[j - 1];
+            j--;
+        }
+        out[j] = v;
     }
+    return n;
+}
 
-    return (int8_t)ctx->ema;
+static void rssi_filter_win_reset(RSSI_ConnCtx* ctx)
+{
+    ctx->flt.win.cnt = 0;
+    ctx->flt.win.idx = 0;
+}
+
+/**
+ * @brief 中位数滤波：单个深衰落/毛刺样本不会推动输出
+ */
+static int16_t rssi_filter_median(RSSI_ConnCtx* ctx, int8_t raw)
+{
+    int8_t  sorted[RSSI_FILTER_WIN];
+    uint8_t n = rssi_filter_win_sorted(ctx, raw, sorted);
+
+    /* 偶数个样本（窗口未满）取中间两个的平均 */
+    if ((n & 1u) != 0u)
+    {
+        ctx->ema = sorted[n / 2u];
+    }
+    else
+    {
+        ctx->ema = (int16_t)(((int16_t)sorted[n / 2u - 1u] + sorted[n / 2u]) / 2);
+    }
+    ctx->ema_inited = true;
+    return ctx->ema;
+}
+
+/**
+ * @brief 截尾平均：去掉窗口里的最大、最小值后取平均（不足 3 个样本时直接平均）
+ */
+static int16_t rssi_filter_trimmed(RSSI_ConnCtx* ctx, int8_t raw)
+{
+    int8_t  sorted[RSSI_FILTER_WIN];
+    uint8_t n     = rssi_filter_win_sorted(ctx, raw, sorted);
+    uint8_t first = (n >= 3u) ? 1u : 0u;
+    uint8_t last  = (n >= 3u) ? (uint8_t)(n - 1u) : n;
+    int16_t sum   = 0;
+
+    for (uint8_t i = first; i < last; i++)
+    {
+        sum += sorted[i];
+    }
+    ctx->ema        = (int16_t)(sum / (int16_t)(last - first));
+    ctx->ema_inited = true;
+    return ctx->ema;
+}
+
+/**
+ * @brief 1 维卡尔曼（随机游走模型），Q8 定点
+ *
+ * @why
+ * - 增益 K 随估计方差自适应：刚连上/刚跳变时 K 大、收敛快，稳定后 K 小、抖动小，
+ *   正好对应“走近时要快、站着不动时别来回跳”。
+ * - K 用 Q12：K(<=4096) * 残差(<=255*256) 不会溢出 int32。
+ */
+static int16_t rssi_filter_kalman(RSSI_ConnCtx* ctx, int8_t raw)
+{
+    const RSSI_Config* cfg  = &ctx->owner->cfg;
+    int32_t            z_q8 = (int32_t)raw * 256;
+
+    if (!ctx->ema_inited)
+    {
+        ctx->flt.kf.x_q8 = z_q8;
+        ctx->flt.kf.p_q8 = cfg->kf_r_q8;
+        ctx->ema_inited  = true;
+    }
+    else
+    {
+        int32_t p     = ctx->flt.kf.p_q8 + cfg->kf_q_q8;
+        int32_t k_q12 = (p * 4096) / (p + (int32_t)cfg->kf_r_q8 + 1);
+
+        ctx->flt.kf.x_q8 += (k_q12 * (z_q8 - ctx->flt.kf.x_q8)) / 4096;
+        ctx->flt.kf.p_q8 = ((4096 - k_q12) * p) / 4096;
+    }
+
+    /* 四舍五入回 dBm */
+    int32_t x = ctx->flt.kf.x_q8;
+    ctx->ema  = rssi_filter_clamp((int16_t)((x >= 0) ? ((x + 128) / 256) : -((-x + 128) / 256)));
+    return ctx->ema;
+}
+
+static void rssi_filter_kalman_reset(RSSI_ConnCtx* ctx)
+{
+    ctx->flt.kf.x_q8 = 0;
+    ctx->flt.kf.p_q8 = 0;
+}
+
+static const RSSI_FilterOps s_rssi_filters[RSSI_FILTER_NUM] = {
+    [RSSI_FILTER_3AVG_EMA] = {"3avg+ema", rssi_filter_3avg_ema_reset, rssi_filter_3avg_ema},
+    [RSSI_FILTER_MEDIAN]   = {"median", rssi_filter_win_reset, rssi_filter_median},
+    [RSSI_FILTER_KALMAN]   = {"kalman", rssi_filter_kalman_reset, rssi_filter_kalman},
+    [RSSI_FILTER_TRIMMED]  = {"trimmed", rssi_filter_win_reset, rssi_filter_trimmed},
+};
+
+/**
+ * @brief 清空一个连接的滤波状态（输出回到初值，下一个样本重新收敛）
+ */
+static void rssi_filter_reset(RSSI_ConnCtx* ctx)
+{
+    ctx->ema_inited = false;
+    ctx->ema        = -70;
+    ctx->owner->filter->Reset(ctx);
 }
 
 /**
@@ -145,7 +284,54 @@ static void rssi_hysteresis_update(RSSI_ConnCtx* ctx)
 }
 
 /**
- * @brief 定时器回调：定期读取 RSSI 并滤波/判定
+ * @brief 按最新滤波值选下一次采样周期，周期变化时重排定时器
+ * @param ctx RSSI 上下文（仅 sampler 非空时调用）
+ */
+static void rssi_schedule_update(RSSI_ConnCtx* ctx)
+{
+    RSSI_Checker* self   = ctx->owner;
+    int16_t       val    = ctx->ema;
+    int16_t       diff   = (int16_t)(val - ctx->prev_ema);
+    uint16_t      period = self->cfg.normal_period_ms;
+
+    ctx->prev_ema = val;
+    if (diff < 0)
+    {
+        diff = (int16_t)-diff;
+    }
+
+    bool in_band =
+        (val >= (int16_t)self->cfg.far_threshold - (int16_t)self->cfg.hysteresis) &&
+        (val <= (int16_t)self->cfg.near_threshold + (int16_t)self->cfg.hysteresis);
+
+    if (in_band || diff >= (int16_t)self->cfg.motion_db)
+    {
+        ctx->settle_cnt = 0;
+        period          = self->cfg.fast_period_ms;
+    }
+    else
+    {
+        if (ctx->settle_cnt < 0xFFu)
+        {
+            ctx->settle_cnt++;
+        }
+        if (ctx->settle_cnt >= self->cfg.settle_samples &&
+            (ctx->distance == RSSI_DIST_NEAR || ctx->distance == RSSI_DIST_LOST))
+        {
+            period = self->cfg.slow_period_ms;
+        }
+    }
+
+    if (period != ctx->sample_period_ms)
+    {
+        ctx->sample_period_ms = period;
+        os_timer_start(&ctx->timer, period, 1);
+        ctx->timer_started = true;
+    }
+}
+
+/**
+ * @brief 定时器回调：定期读取 RSSI 并滤波/判定，或向 GAP 请求一个样本
  * @param arg 连接索引（uint8_t 转 void*）
  */
 static void rssi_timer_handler(void* arg)
@@ -153,7 +339,16 @@ static void rssi_timer_handler(void* arg)
     RSSI_ConnCtx* ctx = (RSSI_ConnCtx*)arg;
     if (ctx == NULL || ctx->owner == NULL)
         return;
-    if (!ctx->active || ctx->getter == NULL)
+    if (!ctx->active)
+        return;
+
+    /* 异步采样：只发请求，样本经 GAP_EVT_LINK_RSSI -> RSSI_Check_Update 回来 */
+    if (ctx->sampler != NULL)
+    {
+        ctx->sampler(ctx->conidx);
+        return;
+    }
+    if (ctx->getter == NULL)
         return;
 
     uint8_t conidx = ctx->conidx;
@@ -194,6 +389,16 @@ void RSSI_Checker_Construct(RSSI_Checker* self)
     self->cfg.hysteresis     = 3;
     self->cfg.period_ms      = 1000;
 
+    self->cfg.fast_period_ms   = 100;
+    self->cfg.normal_period_ms = 500;
+    self->cfg.slow_period_ms   = 3000;
+    self->cfg.motion_db        = 4;
+    self->cfg.settle_samples   = 10;
+
+    self->cfg.kf_q_q8 = 128;  /* 0.5 dB^2/样本：允许人走动带来的漂移 */
+    self->cfg.kf_r_q8 = 4096; /* 16 dB^2：BLE RSSI 单点抖动约 +-4 dB */
+    self->filter      = &s_rssi_filters[RSSI_FILTER_DEFAULT];
+
     for (uint8_t i = 0; i < RSSI_MAX_CONN; i++)
     {
         self->conn[i].owner    = self;
@@ -236,11 +441,12 @@ static void RSSI_Checker_Init_Impl(RSSI_Checker* self)
         ctx->active       = false;
         ctx->conidx       = i;
         ctx->getter       = NULL;
-        ctx->s3_cnt       = 0;
-        ctx->s3_idx       = 0;
-        ctx->ema_inited   = false;
-        ctx->ema          = -70;
+        rssi_filter_reset(ctx);
         ctx->distance     = RSSI_DIST_LOST;
+        ctx->sampler          = NULL;
+        ctx->sample_period_ms = 0;
+        ctx->settle_cnt       = 0;
+        ctx->prev_ema         = ctx->ema;
 
         memset(ctx->peer_addr, 0, sizeof(ctx->peer_addr));
         ctx->peer_addr_valid = false;
@@ -286,12 +492,14 @@ static void RSSI_Checker_Enable_Impl(RSSI_Checker* self,
     ctx->active       = true;
     ctx->conidx       = conidx;
     ctx->getter       = getter;
-    ctx->s3_cnt       = 0;
-    ctx->s3_idx       = 0;
-    ctx->ema_inited   = false;
-    ctx->ema          = -70;
+    rssi_filter_reset(ctx);
     ctx->distance     = RSSI_DIST_LOST;
 
+    ctx->sampler          = NULL;
+    ctx->sample_period_ms = 0;
+    ctx->settle_cnt       = 0;
+    ctx->prev_ema         = ctx->ema;
+
     /* getter 为空：采用 GAP 上报/事件喂入 RSSI，不启用轮询定时器 */
     if (getter == NULL)
     {
@@ -332,7 +540,12 @@ __attribute__((section("ram_code"))) void gap_rssi_ind(int8_t  rssi,
      * @why
      * - 文档强调该 RAM 回调里不要做复杂工作。
      * - 这里仅“喂入”到统一入口，滤波/滞回/回调/打印都在 RSSI_Check_Update() 内完成。
+     * - 已由调度采样的连接不再吃实时上报：否则采样率跟着连接间隔走，调度就失去意义。
      */
+    if (RSSI_Get_Default()->conn[conidx].sampler != NULL)
+    {
+        return;
+    }
     RSSI_Check_Update(conidx, rssi);
 }
 
@@ -389,6 +602,50 @@ void RSSI_Check_Enable(uint8_t conidx, rssi_getter_t getter)
     self->m.Enable(self, conidx, getter);
 }
 
+void RSSI_Check_Enable_Sampling(uint8_t conidx, rssi_sample_req_t req)
+{
+    if (conidx >= RSSI_MAX_CONN)
+    {
+        return;
+    }
+    RSSI_Checker* self = RSSI_Get_Default();
+    RSSI_ConnCtx* ctx  = &self->conn[conidx];
+
+    if (ctx->timer_started)
+    {
+        os_timer_stop(&ctx->timer);
+        ctx->timer_started = false;
+    }
+    ctx->sampler          = req;
+    ctx->sample_period_ms = 0;
+    ctx->settle_cnt       = 0;
+    if (req == NULL || !ctx->active)
+    {
+        return;
+    }
+
+    if (!ctx->timer_inited)
+    {
+        os_timer_init(&ctx->timer, rssi_timer_handler, ctx);
+        ctx->timer_inited = true;
+    }
+    /* 刚连上还没有样本：先按快速周期拿到第一批值 */
+    ctx->sample_period_ms = self->cfg.fast_period_ms;
+    os_timer_start(&ctx->timer, ctx->sample_period_ms, 1);
+    ctx->timer_started = true;
+    req(conidx);
+}
+
+uint16_t RSSI_Check_Get_Sample_Period(uint8_t conidx)
+{
+    if (conidx >= RSSI_MAX_CONN)
+    {
+        return 0;
+    }
+    RSSI_ConnCtx* ctx = &RSSI_Get_Default()->conn[conidx];
+    return (ctx->sampler != NULL) ? ctx->sample_period_ms : 0;
+}
+
 /**
  * @brief 禁用指定连接的 RSSI 跟踪
  * @param conidx 连接索引
@@ -407,8 +664,10 @@ static void RSSI_Checker_Disable_Impl(RSSI_Checker* self, uint8_t conidx)
         ctx->timer_started = false;
     }
 
-    ctx->active = false;
-    ctx->getter = NULL;
+    ctx->active           = false;
+    ctx->getter           = NULL;
+    ctx->sampler          = NULL;
+    ctx->sample_period_ms = 0;
 }
 
 void RSSI_Check_Disable(uint8_t conidx)
@@ -436,8 +695,12 @@ RSSI_Checker_Update_Impl(RSSI_Checker* self, uint8_t conidx, int8_t rssi)
     /* 记录变化前的状态：用于边沿触发（NEAR/FAR/LOST） */
     uint8_t prev_distance = (uint8_t)ctx->distance;
 
-    (void)rssi_filter_3avg_ema(ctx, rssi);
+    (void)self->filter->Step(ctx, rssi);
     rssi_hysteresis_update(ctx);
+    if (ctx->sampler != NULL)
+    {
+        rssi_schedule_update(ctx);
+    }
 
     /* 状态变化通知（业务层可选注册） */
     uint8_t new_distance = (uint8_t)ctx->distance;
@@ -575,10 +838,7 @@ static void RSSI_Checker_Reset_Impl(RSSI_Checker* self, uint8_t conidx)
     if (conidx >= RSSI_MAX_CONN)
         return;
     RSSI_ConnCtx* ctx = &self->conn[conidx];
-    ctx->s3_cnt       = 0;
-    ctx->s3_idx       = 0;
-    ctx->ema_inited   = false;
-    ctx->ema          = -70;
+    rssi_filter_reset(ctx);
     ctx->distance     = RSSI_DIST_LOST;
 }
 
@@ -587,3 +847,31 @@ void RSSI_Check_Reset(uint8_t conidx)
     RSSI_Checker* self = RSSI_Get_Default();
     self->m.Reset(self, conidx);
 }
+
+const RSSI_FilterOps* RSSI_Filter_Get_Ops(uint8_t id)
+{
+    return (id < RSSI_FILTER_NUM) ? &s_rssi_filters[id] : NULL;
+}
+
+bool RSSI_Check_Set_Filter(uint8_t id)
+{
+    if (id >= RSSI_FILTER_NUM)
+    {
+        return false;
+    }
+    RSSI_Checker* self = RSSI_Get_Default();
+    self->filter       = &s_rssi_filters[id];
+
+    /* 各策略的私有状态共用一块内存，换策略必须清掉；距离状态保留，避免误报一次 LOST */
+    for (uint8_t i = 0; i < RSSI_MAX_CONN; i++)
+    {
+        rssi_filter_reset(&self->conn[i]);
+    }
+    return true;
+}
+
+uint8_t RSSI_Check_Get_Filter(void)
+{
+    RSSI_Checker* self = RSSI_Get_Default();
+    return (uint8_t)(self->filter - s_rssi_filters);
+}
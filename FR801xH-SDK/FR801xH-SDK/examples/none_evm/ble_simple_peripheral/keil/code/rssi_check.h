@@ -10,10 +10,11 @@
 #include <stdbool.h>
 
 #include "os_timer.h"
+#include "conn_ctx.h"
 
-/* 最大连接数：如需调整，建议在编译选项或公共头文件中先定义 */
+/* 最大连接数：默认跟随 APP_MAX_CONN（conn_ctx.h） */
 #ifndef RSSI_MAX_CONN
-#define RSSI_MAX_CONN 3
+#define RSSI_MAX_CONN APP_MAX_CONN
 #endif
 
 /*
@@ -31,6 +32,17 @@
  */
 typedef int8_t (*rssi_getter_t)(uint8_t conidx);
 
+/**
+ * @brief RSSI 采样请求回调（平台抽象接口）
+ *
+ * @why
+ * - 板上 RSSI 是异步的：gap_get_link_rssi() 发请求，结果由 GAP_EVT_LINK_RSSI 回来，
+ *   不能像 rssi_getter_t 那样同步取值。
+ * - 采样节奏由 RSSI_Checker 按距离状态自己排（见 RSSI_Config 的 *_period_ms），
+ *   到点只调用这个回调“要一个样本”，结果照常经 RSSI_Check_Update 喂回来。
+ */
+typedef void (*rssi_sample_req_t)(uint8_t conidx);
+
 /**
  * @brief RSSI 距离状态变化回调
  *
@@ -63,6 +75,31 @@ typedef void (*rssi_distance_change_cb_t)(uint8_t conidx,
                                           int16_t filtered_rssi,
                                           int8_t  raw_rssi);
 
+/*
+ * 滤波策略（RSSI_Check_Set_Filter 运行时切换，RSSI_FILTER_DEFAULT 编译期默认）：
+ * - 3AVG_EMA：3 点平均 + EMA(alpha=0.3)，原有实现；
+ * - MEDIAN   ：最近 RSSI_FILTER_WIN 个样本取中位数，专治单点深衰落/毛刺；
+ * - KALMAN   ：1 维随机游走卡尔曼，Q8 定点，噪声参数见 RSSI_Config.kf_*；
+ * - TRIMMED  ：最近 RSSI_FILTER_WIN 个样本去掉最大最小后取平均。
+ * 全部整数/定点实现；host/bench/rssi_filter_eval 回放带真值的轨迹对比各策略。
+ */
+typedef enum {
+    RSSI_FILTER_3AVG_EMA = 0,
+    RSSI_FILTER_MEDIAN   = 1,
+    RSSI_FILTER_KALMAN   = 2,
+    RSSI_FILTER_TRIMMED  = 3,
+    RSSI_FILTER_NUM
+} rssi_filter_id_t;
+
+#ifndef RSSI_FILTER_DEFAULT
+#define RSSI_FILTER_DEFAULT RSSI_FILTER_3AVG_EMA
+#endif
+
+/* 中位数/截尾平均的窗口长度（奇数） */
+#ifndef RSSI_FILTER_WIN
+#define RSSI_FILTER_WIN 5
+#endif
+
 typedef enum {
     RSSI_DIST_LOST = 0,
     RSSI_DIST_FAR  = 1,
@@ -79,15 +116,34 @@ typedef struct {
     uint8_t       conidx;
     rssi_getter_t getter;
 
-    /* 3 点平均 */
-    int8_t  s3_buf[3];
-    uint8_t s3_cnt;
-    uint8_t s3_idx;
-
-    /* EMA（整数实现） */
+    /* 滤波器私有状态：同一时刻只有一种策略在用，共用一块内存 */
+    union {
+        struct {
+            int8_t  buf[3];
+            uint8_t cnt;
+            uint8_t idx;
+        } avg3; /* 3AVG_EMA 的 3 点平均 */
+        struct {
+            int8_t  buf[RSSI_FILTER_WIN];
+            uint8_t cnt;
+            uint8_t idx;
+        } win; /* MEDIAN / TRIMMED 的滑动窗口 */
+        struct {
+            int32_t x_q8; /* 估计值（dBm，Q8） */
+            int32_t p_q8; /* 估计方差（dB^2，Q8） */
+        } kf;
+    } flt;
+
+    /* 滤波输出（历史原因叫 ema，任何策略都写这里）；ema_inited=已有输出 */
     int16_t ema;
     bool    ema_inited;
 
+    /* 自适应采样：sampler 非空时由本模块按 sample_period_ms 定时请求样本 */
+    rssi_sample_req_t sampler;
+    uint16_t          sample_period_ms;
+    uint8_t           settle_cnt; /* 连续“不在过渡带且没在移动”的样本数（饱和） */
+    int16_t           prev_ema;
+
     rssi_distance_t distance;
 
     /* 对端 MAC（用于打印 RSSI+MAC） */
@@ -107,8 +163,33 @@ typedef struct {
     int8_t   lost_threshold;
     uint8_t  hysteresis;
     uint16_t period_ms;
+
+    /*
+     * 自适应采样（RSSI_Check_Enable_Sampling）：
+     * - 滤波值落在 FAR<->NEAR 过渡带 [far-hys, near+hys]，或相邻两次滤波值变化
+     *   >= motion_db（人在走动）：fast_period_ms，解锁判定最快；
+     * - 稳定 NEAR / 稳定 LOST（连续 settle_samples 个样本不在过渡带且没在移动）：
+     *   slow_period_ms，手机放在座垫上/人早走了时不再白白占空口和 CPU；
+     * - 其余：normal_period_ms。
+     */
+    uint16_t fast_period_ms;
+    uint16_t normal_period_ms;
+    uint16_t slow_period_ms;
+    uint8_t  motion_db;
+    uint8_t  settle_samples;
+
+    /* KALMAN：过程噪声 Q / 观测噪声 R（dB^2，Q8）；R/Q 越大越平滑、越慢 */
+    uint16_t kf_q_q8;
+    uint16_t kf_r_q8;
 } RSSI_Config;
 
+/* 滤波策略表项：Reset 清私有状态，Step 喂一个原始值、把结果写进 ctx->ema 并返回 */
+typedef struct {
+    const char* name;
+    void (*Reset)(RSSI_ConnCtx* ctx);
+    int16_t (*Step)(RSSI_ConnCtx* ctx, int8_t raw);
+} RSSI_FilterOps;
+
 typedef struct {
     void (*Init)(struct RSSI_Checker* self);
     void (*Enable)(struct RSSI_Checker* self, uint8_t conidx, rssi_getter_t getter);
@@ -122,8 +203,9 @@ typedef struct {
 } RSSI_Methods;
 
 typedef struct RSSI_Checker {
-    RSSI_Methods m;
-    RSSI_Config  cfg;
+    RSSI_Methods          m;
+    RSSI_Config           cfg;
+    const RSSI_FilterOps* filter;
     RSSI_ConnCtx conn[RSSI_MAX_CONN];
 } RSSI_Checker;
 
@@ -149,6 +231,19 @@ void RSSI_Check_Init(void);
  */
 void RSSI_Check_Enable(uint8_t conidx, rssi_getter_t getter);
 
+/**
+ * @brief 由本模块按距离状态调度该连接的 RSSI 采样（需先 RSSI_Check_Enable）
+ * @param conidx 连接索引
+ * @param req    采样请求回调（板上为 gap_get_link_rssi），NULL 表示停止调度
+ * @note 调度启用后，gap_rssi_ind 的实时上报不再喂入该连接，采样率只由调度决定。
+ */
+void RSSI_Check_Enable_Sampling(uint8_t conidx, rssi_sample_req_t req);
+
+/**
+ * @brief 当前采样周期（ms），未启用调度时为 0
+ */
+uint16_t RSSI_Check_Get_Sample_Period(uint8_t conidx);
+
 /**
  * @brief 禁用指定连接的 RSSI 跟踪
  * @param conidx 连接索引
@@ -196,6 +291,23 @@ bool RSSI_Check_Is_Lost(uint8_t conidx);
  */
 void RSSI_Check_Reset(uint8_t conidx);
 
+/**
+ * @brief 切换滤波策略（所有连接的滤波状态清零，从下一个样本重新收敛）
+ * @param id rssi_filter_id_t
+ * @return false=id 无效，策略不变
+ */
+bool RSSI_Check_Set_Filter(uint8_t id);
+
+/**
+ * @brief 当前滤波策略 id
+ */
+uint8_t RSSI_Check_Get_Filter(void);
+
+/**
+ * @brief 按 id 取策略表项（评估工具/日志用），id 无效返回 NULL
+ */
+const RSSI_FilterOps* RSSI_Filter_Get_Ops(uint8_t id);
+
 /**
  * @brief 设置指定连接的对端 MAC 地址（连接建立时调用）
  * @param conidx 连接索引
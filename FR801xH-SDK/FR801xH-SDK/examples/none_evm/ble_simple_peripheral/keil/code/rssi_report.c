@@ -0,0 +1,268 @@
+/*********************************************************************
+ * @file rssi_report.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief RSSI -> MCU 上报策略实现
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "rssi_report.h"
+#include "rssi_check.h"
+#include "usart_cmd.h"
+#include "usart_device.h"
+#include "driver_system.h"
+#include "os_timer.h"
+#include "app_log.h"
+
+#include <string.h>
+
+/* system_get_curr_time() 到 0x4FFFFFF 后回绕到 0 */
+#define RSSI_REPORT_TIME_WRAP (0x5000000u)
+
+typedef struct
+{
+    uint8_t  active;     /* 本次连接收到过样本 */
+    uint8_t  sent;       /* 本次连接上报过 */
+    uint8_t  due;        /* 已到期，等最小间隔放行 */
+    uint8_t  stable_cnt; /* 距离状态连续不变的样本数（饱和） */
+    uint8_t  cur_dist;
+    int8_t   cur_rssi;
+    uint8_t  last_dist;  /* 上次上报时的距离状态 */
+    int8_t   last_rssi;  /* 上次上报的滤波值 */
+    uint32_t last_ms;    /* 上次上报时刻 */
+} rssi_report_link_t;
+
+static RSSI_ReportCfg     s_cfg;
+static RSSI_ReportStats   s_stats;
+static rssi_report_link_t s_link[RSSI_MAX_CONN];
+static uint32_t           s_last_frame_ms;
+static uint8_t            s_frame_sent;
+static uint8_t            s_timer_inited;
+static uint8_t            s_timer_armed;
+static os_timer_t         s_flush_timer;
+
+static uint32_t rssi_report_elapsed(uint32_t now, uint32_t then)
+{
+    return (now >= then) ? (now - then) : (now + RSSI_REPORT_TIME_WRAP - then);
+}
+
+static uint8_t rssi_report_put(uint8_t conidx, uint8_t* out)
+{
+    rssi_report_link_t* l = &s_link[conidx];
+
+    out[0] = (uint8_t)l->cur_rssi;
+    memset(&out[1], 0, 6);
+    (void)RSSI_Check_Get_Peer_Addr(conidx, &out[1]);
+    return RSSI_REPORT_REC_LEN;
+}
+
+static void rssi_report_mark_sent(uint8_t conidx, uint32_t now)
+{
+    rssi_report_link_t* l = &s_link[conidx];
+
+    l->due       = 0u;
+    l->sent      = 1u;
+    l->last_rssi = l->cur_rssi;
+    l->last_dist = l->cur_dist;
+    l->last_ms   = now;
+}
+
+static void rssi_report_send(const uint8_t* payload, uint16_t len, uint8_t records, uint32_t now)
+{
+    (void)SocMcu_Frame_Send(SOC_MCU_SYNC_SOC_TO_MCU,
+                            SOC_MCU_FEATURE_FF01,
+                            (uint16_t)RSSI_REPORT_CMD,
+                            payload,
+                            len);
+    s_stats.frames++;
+    s_stats.records += records;
+    s_last_frame_ms = now;
+    s_frame_sent    = 1u;
+}
+
+/* 把所有到期连接发出去（合帧或逐条） */
+static void rssi_report_flush_due(uint32_t now)
+{
+    uint8_t  payload[RSSI_MAX_CONN * RSSI_REPORT_REC_LEN];
+    uint16_t len     = 0u;
+    uint8_t  records = 0u;
+
+    for (uint8_t i = 0; i < RSSI_MAX_CONN; i++)
+    {
+        if (!s_link[i].due)
+        {
+            continue;
+        }
+        if (s_cfg.batch)
+        {
+            len = (uint16_t)(len + rssi_report_put(i, &payload[len]));
+            records++;
+        }
+        else
+        {
+            rssi_report_send(payload, rssi_report_put(i, payload), 1u, now);
+        }
+        rssi_report_mark_sent(i, now);
+    }
+    if (records > 0u)
+    {
+        rssi_report_send(payload, len, records, now);
+    }
+}
+
+static void rssi_report_timer_func(void* arg)
+{
+    (void)arg;
+    s_timer_armed = 0u;
+    s_stats.deferred++;
+    rssi_report_flush_due(system_get_curr_time());
+}
+
+/*
+ * 发送到期连接：force（距离状态变化）时立即发；
+ * 否则最小间隔没到就挂一个单次定时器，到点把这段时间里到期的连接一起发。
+ */
+static void rssi_report_try_flush(uint32_t now, bool force)
+{
+    if (!force && s_frame_sent)
+    {
+        uint32_t gap = rssi_report_elapsed(now, s_last_frame_ms);
+        if (gap < s_cfg.min_interval_ms)
+        {
+            if (!s_timer_armed)
+            {
+                os_timer_start(&s_flush_timer, s_cfg.min_interval_ms - gap, 0);
+                s_timer_armed = 1u;
+            }
+            return;
+        }
+    }
+    if (s_timer_armed)
+    {
+        os_timer_stop(&s_flush_timer);
+        s_timer_armed = 0u;
+    }
+    rssi_report_flush_due(now);
+}
+
+void RSSI_Report_Init(void)
+{
+    s_cfg.enable             = 1u;
+    s_cfg.batch              = 1u;
+    s_cfg.deadband_db        = 4u;
+    s_cfg.stable_samples     = 10u;
+    s_cfg.min_interval_ms    = 1000u;
+    s_cfg.max_interval_ms    = 5000u;
+    s_cfg.stable_interval_ms = 30000u;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(s_link, 0, sizeof(s_link));
+    s_frame_sent = 0u;
+
+    if (!s_timer_inited)
+    {
+        os_timer_init(&s_flush_timer, rssi_report_timer_func, NULL);
+        s_timer_inited = 1u;
+    }
+    else if (s_timer_armed)
+    {
+        os_timer_stop(&s_flush_timer);
+    }
+    s_timer_armed = 0u;
+}
+
+void RSSI_Report_SetConfig(const RSSI_ReportCfg* cfg)
+{
+    if (cfg != NULL)
+    {
+        s_cfg = *cfg;
+    }
+}
+
+void RSSI_Report_GetConfig(RSSI_ReportCfg* out)
+{
+    if (out != NULL)
+    {
+        *out = s_cfg;
+    }
+}
+
+void RSSI_Report_GetStats(RSSI_ReportStats* out)
+{
+    if (out != NULL)
+    {
+        *out = s_stats;
+    }
+}
+
+void RSSI_Report_Reset(uint8_t conidx)
+{
+    if (conidx < RSSI_MAX_CONN)
+    {
+        memset(&s_link[conidx], 0, sizeof(s_link[conidx]));
+    }
+}
+
+void RSSI_Report_OnSample(uint8_t conidx, int8_t filtered_rssi, uint8_t distance)
+{
+    if (conidx >= RSSI_MAX_CONN)
+    {
+        return;
+    }
+
+    rssi_report_link_t* l   = &s_link[conidx];
+    uint32_t            now = system_get_curr_time();
+
+    s_stats.samples++;
+    if (l->active && l->cur_dist == distance)
+    {
+        if (l->stable_cnt < 0xFFu)
+        {
+            l->stable_cnt++;
+        }
+    }
+    else
+    {
+        l->stable_cnt = 0u;
+    }
+    l->active   = 1u;
+    l->cur_dist = distance;
+    l->cur_rssi = filtered_rssi;
+
+    if (!s_cfg.enable)
+    {
+        l->due = 1u;
+        rssi_report_flush_due(now);
+        return;
+    }
+
+    /* 首个样本 / 距离状态变化：立即发（顺带把其它已到期连接一起带走） */
+    if (!l->sent || distance != l->last_dist)
+    {
+        l->due = 1u;
+        rssi_report_try_flush(now, true);
+        return;
+    }
+
+    bool     stable = (l->stable_cnt >= s_cfg.stable_samples);
+    uint32_t hb     = stable ? s_cfg.stable_interval_ms : s_cfg.max_interval_ms;
+    int16_t  diff   = (int16_t)filtered_rssi - (int16_t)l->last_rssi;
+
+    if (diff < 0)
+    {
+        diff = (int16_t)-diff;
+    }
+    if (rssi_report_elapsed(now, l->last_ms) >= hb ||
+        (!stable && diff > (int16_t)s_cfg.deadband_db))
+    {
+        l->due = 1u;
+    }
+    if (l->due)
+    {
+        APP_LOGD("[RSSI_RPT] link=%u flt=%d dist=%u due\r\n",
+                 (unsigned)conidx,
+                 (int)filtered_rssi,
+                 (unsigned)distance);
+        rssi_report_try_flush(now, false);
+    }
+}
@@ -0,0 +1,74 @@
+/*********************************************************************
+ * @file rssi_report.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief RSSI -> MCU 上报策略：死区 + 最小/最大间隔 + 多连接合帧 + 稳定抑制
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 以前每个 GAP_EVT_LINK_RSSI（500 ms/连接）都发一帧 FF01/0x0118，
+ *   手机静止放在座垫上一小时，MCU 也要收七千多帧几乎不变的数。
+ * - 这里把“要不要发”集中成一个策略：
+ *   1) 距离状态（LOST/FAR/NEAR）变化：立即发，不受最小间隔限制（无感解锁靠它）；
+ *   2) 滤波值相对上次上报变化超过 deadband：在最小间隔允许时发；
+ *   3) 心跳：超过 max_interval 没报过就报一次；距离状态连续 stable_samples
+ *      个样本不变后只保留（更长的）stable_interval 心跳，忽略 deadband；
+ *   4) 同一时刻到期的连接合成一帧：payload = N x {rssi(1), mac(6)}，
+ *      单连接时与旧格式完全一致。
+ * - enable=0 退回旧行为（每个样本一帧），便于对照。
+ *********************************************************************/
+
+#ifndef RSSI_REPORT_H
+#define RSSI_REPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* FF01 通道上报给 MCU 的命令号（payload 每条记录 = 滤波 RSSI + 对端 MAC） */
+#ifndef RSSI_REPORT_CMD
+#define RSSI_REPORT_CMD (0x0118u)
+#endif
+
+#define RSSI_REPORT_REC_LEN (7u)
+
+typedef struct
+{
+    uint8_t  enable;             /**< 0：每个样本都发一帧（旧行为） */
+    uint8_t  batch;              /**< 1：同时到期的连接合成一帧 */
+    uint8_t  deadband_db;        /**< 滤波值变化超过该值才算“有变化” */
+    uint8_t  stable_samples;     /**< 距离状态连续多少个样本不变算稳定 */
+    uint16_t min_interval_ms;    /**< 两帧最小间隔（距离状态变化不受限） */
+    uint16_t max_interval_ms;    /**< 非稳定连接的心跳间隔 */
+    uint16_t stable_interval_ms; /**< 稳定连接的心跳间隔 */
+} RSSI_ReportCfg;
+
+typedef struct
+{
+    uint32_t samples;    /**< 喂入的样本数 */
+    uint32_t frames;     /**< 发给 MCU 的帧数 */
+    uint32_t records;    /**< 帧内记录数（合帧后 records >= frames） */
+    uint32_t deferred;   /**< 被最小间隔推迟、由定时器补发的次数 */
+} RSSI_ReportStats;
+
+/**
+ * @brief 初始化（默认策略 + 清空各连接状态）
+ */
+void RSSI_Report_Init(void);
+
+void RSSI_Report_SetConfig(const RSSI_ReportCfg* cfg);
+void RSSI_Report_GetConfig(RSSI_ReportCfg* out);
+void RSSI_Report_GetStats(RSSI_ReportStats* out);
+
+/**
+ * @brief 连接建立/断开时清掉该连接的上报状态（下一个样本必报）
+ */
+void RSSI_Report_Reset(uint8_t conidx);
+
+/**
+ * @brief 喂入一个已滤波的样本（RSSI_Check_Update 之后调用）
+ * @param filtered_rssi 滤波值（dBm）
+ * @param distance      rssi_distance_t
+ */
+void RSSI_Report_OnSample(uint8_t conidx, int8_t filtered_rssi, uint8_t distance);
+
+#endif // RSSI_REPORT_H
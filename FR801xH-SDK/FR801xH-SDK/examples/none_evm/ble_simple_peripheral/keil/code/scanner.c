@@ -10,6 +10,52 @@
 #include "TPMS.h" // TPMS 广播解析
 #include <string.h>
 
+/* 日志开关：0=静音，1=打开 */
+#ifndef SCAN_LOG_ENABLE
+#define SCAN_LOG_ENABLE 0
+#endif
+
+#if SCAN_LOG_ENABLE
+#define SCAN_LOG(...) co_printf(__VA_ARGS__)
+#else
+#define SCAN_LOG(...)                                                          \
+    do                                                                         \
+    {                                                                          \
+    } while (0)
+#endif
+
+/*
+ * 扫描前置过滤开关：1=每条报告先过 TPMS_Prefilter，不像 TPMS 的在拷贝缓存之前就丢掉；
+ * 0=旧行为（每条都拷贝并交给 TPMS_Feed_Adv 完整解析）。
+ */
+#ifndef SCAN_TPMS_PREFILTER
+#define SCAN_TPMS_PREFILTER 1
+#endif
+
+/*
+ * 已绑定 TPMS 后的过滤扫描（TPMS_Scan_Filter_Allowed() 为真时）：
+ * - 控制器去重（dup_filt_pol=1）：同一广播源一轮扫描只上报一次；
+ * - 每轮扫描只持续 SCAN_TPMS_DUP_WINDOW_MS，到时 GAP_EVT_SCAN_END 里重启，
+ *   控制器的去重表随之清空，本车传感器的新数据最迟晚一轮被看到；
+ * - SCAN_TPMS_FILTER_PASSIVE=1 时改被动扫描：TPMS 数据在 ADV 里，不再发 SCAN_REQ，
+ *   也不再收每个可扫描设备的 SCAN_RSP。
+ * gap_scan_param_t 没有扫描白名单策略字段，按 MAC/sensor_id 的筛选仍由 TPMS_Prefilter 做。
+ * 未绑定或 TPMS_Replace_Start 学习窗口内回到原来的开放扫描。
+ */
+#ifndef SCAN_TPMS_FILTERED
+#define SCAN_TPMS_FILTERED 1
+#endif
+
+#ifndef SCAN_TPMS_DUP_WINDOW_MS
+#define SCAN_TPMS_DUP_WINDOW_MS 5000u
+#endif
+
+#ifndef SCAN_TPMS_FILTER_PASSIVE
+#define SCAN_TPMS_FILTER_PASSIVE 1
+#endif
+
+#if SCAN_LOG_ENABLE
+/* 只给日志用：日志关闭时不再对每条报告走一遍名字查找 */
 static bool scanner_adv_name_is_tpms(const uint8_t* data, uint8_t len)
 {
     if (data == NULL || len == 0u)
@@ -42,25 +88,14 @@ static bool scanner_adv_name_is_tpms(const uint8_t* data, uint8_t len)
     }
     return false;
 }
-
-/* 日志开关：0=静音，1=打开 */
-#ifndef SCAN_LOG_ENABLE
-#define SCAN_LOG_ENABLE 0
-#endif
-
-#if SCAN_LOG_ENABLE
-#define SCAN_LOG(...) co_printf(__VA_ARGS__)
-#else
-#define SCAN_LOG(...)                                                          \
-    do                                                                         \
-    {                                                                          \
-    } while (0)
 #endif
 
 /* ============ 内部状态管理 ============ */
 static BLE_Central_Base_t* g_scanner_instance = NULL; // 全局实例指针
 static uint8_t             g_adv_data_cache[31];      // 广播数据缓存
-static uint8_t             g_adv_data_len = 0;
+static uint8_t             g_adv_data_len  = 0;
+static bool                g_scanning      = false; // 已调用 gap_start_scan，尚未收到 SCAN_END
+static bool                g_scan_filtered = false; // 当前这轮扫描是否是过滤扫描
 
 /* ============ 私有函数声明 ============ */
 static void scanner_gap_event_handler(gap_event_t* p_event);
@@ -80,13 +115,28 @@ static void scanner_start_scan(void)
     }
 
     gap_scan_param_t scan_param;
-    scan_param.scan_mode   = GAP_SCAN_MODE_GEN_DISC; // 通用发现模式
-    scan_param.scan_intv   = 160; // 扫描间隔 160*0.625ms = 100ms
-    scan_param.scan_window = 32;  // 扫描窗口 32*0.625ms = 20ms
-    scan_param.duration    = 0;   // 0 = 持续扫描（直到调用 gap_stop_scan）
+    memset(&scan_param, 0, sizeof(scan_param));
+    scan_param.scan_mode    = GAP_SCAN_MODE_GEN_DISC; // 通用发现模式
+    scan_param.dup_filt_pol = 0;
+    scan_param.scan_intv    = 160; // 扫描间隔 160*0.625ms = 100ms
+    scan_param.scan_window  = 32;  // 扫描窗口 32*0.625ms = 20ms
+    scan_param.duration     = 0;   // 0 = 持续扫描（直到调用 gap_stop_scan）
+
+#if SCAN_TPMS_FILTERED
+    g_scan_filtered = TPMS_Scan_Filter_Allowed();
+    if (g_scan_filtered)
+    {
+#if SCAN_TPMS_FILTER_PASSIVE
+        scan_param.scan_mode = GAP_SCAN_MODE_OBSERVER;
+#endif
+        scan_param.dup_filt_pol = 1;
+        scan_param.duration     = (uint16_t)(SCAN_TPMS_DUP_WINDOW_MS / 10u); // 单位 10ms
+    }
+#endif
 
+    g_scanning = true;
     gap_start_scan(&scan_param);
-    SCAN_LOG("[Scanner] Scan started (continuous).\r\n");
+    SCAN_LOG("[Scanner] Scan started (%s).\r\n", g_scan_filtered ? "filtered" : "continuous");
 }
 
 /**
@@ -94,6 +144,7 @@ static void scanner_start_scan(void)
  */
 static void scanner_stop_scan(void)
 {
+    g_scanning = false;
     gap_stop_scan();
     SCAN_LOG("[Scanner] Scan stopped.\r\n");
 }
@@ -153,6 +204,19 @@ static uint8_t* scanner_get_adv_data(uint8_t* data)
     return g_adv_data_cache;
 }
 
+/**
+ * @brief TPMS 绑定/学习状态变化：模式要变时停扫，由 GAP_EVT_SCAN_END 按新模式重启
+ */
+static void scanner_tpms_mode_cb(bool filtered)
+{
+    if (g_scanner_instance == NULL || !g_scanning || filtered == g_scan_filtered)
+    {
+        return;
+    }
+    SCAN_LOG("[Scanner] TPMS scan mode -> %s\r\n", filtered ? "filtered" : "open");
+    gap_stop_scan();
+}
+
 /* ============ GAP 事件回调处理 ============ */
 
 /**
@@ -176,7 +240,15 @@ static void scanner_gap_event_handler(gap_event_t* p_event)
             break;
         }
 
-        // 更新状态
+#if SCAN_TPMS_PREFILTER
+        // 快速拒绝：长度/签名/绑定表不符的直接丢，不拷贝、不解析（计数见 TPMS_Prefilter_Get_Stats）
+        if (!TPMS_Prefilter(adv->src_addr.addr.addr, adv->data, adv->length))
+        {
+            break;
+        }
+#endif
+
+        // 更新状态（开启前置过滤时只记录放行的报告）
         g_scanner_instance->scaned = 1;
         memcpy(g_scanner_instance->scan_mac, adv->src_addr.addr.addr, 6);
         g_scanner_instance->rssi = adv->rssi;
@@ -192,6 +264,7 @@ static void scanner_gap_event_handler(gap_event_t* p_event)
             g_adv_data_len = 0;
         }
 
+#if SCAN_LOG_ENABLE
         if (scanner_adv_name_is_tpms(g_adv_data_cache, g_adv_data_len))
         {
             SCAN_LOG("[TPMS_SCAN] name=TPMSS mac=%02X:%02X:%02X:%02X:%02X:%02X "
@@ -205,6 +278,7 @@ static void scanner_gap_event_handler(gap_event_t* p_event)
                      (int)adv->rssi,
                      (unsigned)adv->length);
         }
+#endif
 
         // 将广播数据交给 TPMS 模块解析（不打印 MAC/RSSI）
         TPMS_Feed_Adv(adv->src_addr.addr.addr,
@@ -214,11 +288,12 @@ static void scanner_gap_event_handler(gap_event_t* p_event)
         break;
     }
 
-    case GAP_EVT_SCAN_END: // 扫描结束（异常或外部 stop）
+    case GAP_EVT_SCAN_END: // 扫描结束（异常、外部 stop、过滤扫描一轮到时）
     {
         SCAN_LOG("[Scanner] Scan ended. Restarting...\r\n");
         g_scanner_instance->scaned = 0;
-        // 保护性重启，确保持续扫描
+        g_scanning                 = false;
+        // 保护性重启，确保持续扫描；过滤扫描在这里清空控制器去重表、按当前绑定状态选模式
         scanner_start_scan();
         break;
     }
@@ -255,6 +330,7 @@ void BLE_Scanner_Create(BLE_Central_Base_t* device)
 
     // 设置全局实例
     g_scanner_instance = device;
+    TPMS_Set_Scan_Mode_Cb(scanner_tpms_mode_cb);
 
     co_printf("[Scanner] Instance created successfully.\r\n");
 }
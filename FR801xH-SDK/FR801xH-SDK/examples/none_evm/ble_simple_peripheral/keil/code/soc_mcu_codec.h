@@ -0,0 +1,447 @@
+/*********************************************************************
+ * @file soc_mcu_codec.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief SOC<->MCU UART 帧编解码（header-only）：编码器 + 流式解码器 + 校验
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - 帧格式以前实现了三遍：发送 SocMcu_Frame_Build、接收中断里的逐字节状态机、
+ *   user_task 的 handle_uart_frame 再校验一遍；累加校验 BinComplementCheckSum
+ *   也在两个 .c 里各抄一份。三份实现各自有边界差异（状态机还有跳转错误）。
+ * - 这里收敛成一份：全部 static inline，ARM（armcc/gcc）和主机 Linux 同一份源码，
+ *   主机侧有 fuzz（host/tests/soc_mcu_codec_fuzz.c）和吞吐基准
+ *   （host/bench/soc_mcu_codec_bench.c）兜底。
+ *
+ * 帧格式（多字节字段一律大端）：
+ *   head(1)=0xFE  sync(1)=0xAB/0xBA  len(2)  feature(2)  id(2)  data(n)  chk(m)  end(2)=0A 0D
+ *   len = feature(2) + id(2) + n；chk 覆盖 feature+id+data。
+ *
+ * 校验方式由 SOC_MCU_USE_CRC16（usart_cmd.h）选择：
+ * - 0：1 字节累加和取补（与 MCU 现有固件一致，默认）；
+ * - 1：2 字节 CRC16-CCITT/FALSE（poly 0x1021，init 0xFFFF，大端），查表实现，
+ *      参数与 doc/通用蓝牙协议.md 第 2 节一致。
+ *
+ * 流式解码器用法（数据可以任意切分）：
+ *   soc_mcu_dec_reset(&dec);
+ *   while (len) {
+ *       n = soc_mcu_dec_feed(&dec, p, len, &ev, &frame);  p += n; len -= n;
+ *       if (ev == SOC_MCU_DEC_HDR_OK)  soc_mcu_dec_attach(&dec, buf);  // 可选：保存整帧
+ *       if (ev == SOC_MCU_DEC_FRAME)   ... frame.feature / frame.id / frame.data ...
+ *   }
+ * 不 attach 时解码器照样校验（帧字段、校验和、end 都在解码器内部留存），
+ * 只是 frame.frame / frame.data 为 NULL，可用于“无缓冲可用时按长度吞帧”。
+ *********************************************************************/
+
+#ifndef SOC_MCU_CODEC_H
+#define SOC_MCU_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "usart_cmd.h"
+
+/* ==================== 帧布局 ==================== */
+
+#define SOC_MCU_HDR_LEN   4u /**< head + sync + len */
+#define SOC_MCU_DATA_OFF  8u /**< 数据段在帧内的偏移 */
+#define SOC_MCU_END_LEN   2u
+#define SOC_MCU_TAIL_LEN  (SOC_MCU_CRC_LEN + SOC_MCU_END_LEN)
+#define SOC_MCU_FRAME_OVERHEAD (SOC_MCU_DATA_OFF + SOC_MCU_TAIL_LEN)
+#define SOC_MCU_DATA_MAX  (SOC_MCU_FRAME_MAX_LEN - SOC_MCU_FRAME_OVERHEAD)
+
+/* 帧总长 = len 字段 + head/sync/len(4) + chk + end */
+#define SOC_MCU_FRAME_LEN(data_len) ((uint16_t)(SOC_MCU_FRAME_OVERHEAD + (data_len)))
+
+/* ==================== 校验 ==================== */
+
+/* 校验中间状态：累加和只用低 8 位，CRC16 用满 16 位 */
+typedef uint16_t soc_mcu_cs_t;
+
+#if SOC_MCU_USE_CRC16
+
+/* CRC16-CCITT/FALSE 查表（只有真正调用 CRC 的编译单元会保留这张表） */
+static const uint16_t s_soc_mcu_crc16_tab[256] = {
+    0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+    0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu,
+    0x1231u, 0x0210u, 0x3273u, 0x2252u, 0x52B5u, 0x4294u, 0x72F7u, 0x62D6u,
+    0x9339u, 0x8318u, 0xB37Bu, 0xA35Au, 0xD3BDu, 0xC39Cu, 0xF3FFu, 0xE3DEu,
+    0x2462u, 0x3443u, 0x0420u, 0x1401u, 0x64E6u, 0x74C7u, 0x44A4u, 0x5485u,
+    0xA56Au, 0xB54Bu, 0x8528u, 0x9509u, 0xE5EEu, 0xF5CFu, 0xC5ACu, 0xD58Du,
+    0x3653u, 0x2672u, 0x1611u, 0x0630u, 0x76D7u, 0x66F6u, 0x5695u, 0x46B4u,
+    0xB75Bu, 0xA77Au, 0x9719u, 0x8738u, 0xF7DFu, 0xE7FEu, 0xD79Du, 0xC7BCu,
+    0x48C4u, 0x58E5u, 0x6886u, 0x78A7u, 0x0840u, 0x1861u, 0x2802u, 0x3823u,
+    0xC9CCu, 0xD9EDu, 0xE98Eu, 0xF9AFu, 0x8948u, 0x9969u, 0xA90Au, 0xB92Bu,
+    0x5AF5u, 0x4AD4u, 0x7AB7u, 0x6A96u, 0x1A71u, 0x0A50u, 0x3A33u, 0x2A12u,
+    0xDBFDu, 0xCBDCu, 0xFBBFu, 0xEB9Eu, 0x9B79u, 0x8B58u, 0xBB3Bu, 0xAB1Au,
+    0x6CA6u, 0x7C87u, 0x4CE4u, 0x5CC5u, 0x2C22u, 0x3C03u, 0x0C60u, 0x1C41u,
+    0xEDAEu, 0xFD8Fu, 0xCDECu, 0xDDCDu, 0xAD2Au, 0xBD0Bu, 0x8D68u, 0x9D49u,
+    0x7E97u, 0x6EB6u, 0x5ED5u, 0x4EF4u, 0x3E13u, 0x2E32u, 0x1E51u, 0x0E70u,
+    0xFF9Fu, 0xEFBEu, 0xDFDDu, 0xCFFCu, 0xBF1Bu, 0xAF3Au, 0x9F59u, 0x8F78u,
+    0x9188u, 0x81A9u, 0xB1CAu, 0xA1EBu, 0xD10Cu, 0xC12Du, 0xF14Eu, 0xE16Fu,
+    0x1080u, 0x00A1u, 0x30C2u, 0x20E3u, 0x5004u, 0x4025u, 0x7046u, 0x6067u,
+    0x83B9u, 0x9398u, 0xA3FBu, 0xB3DAu, 0xC33Du, 0xD31Cu, 0xE37Fu, 0xF35Eu,
+    0x02B1u, 0x1290u, 0x22F3u, 0x32D2u, 0x4235u, 0x5214u, 0x6277u, 0x7256u,
+    0xB5EAu, 0xA5CBu, 0x95A8u, 0x8589u, 0xF56Eu, 0xE54Fu, 0xD52Cu, 0xC50Du,
+    0x34E2u, 0x24C3u, 0x14A0u, 0x0481u, 0x7466u, 0x6447u, 0x5424u, 0x4405u,
+    0xA7DBu, 0xB7FAu, 0x8799u, 0x97B8u, 0xE75Fu, 0xF77Eu, 0xC71Du, 0xD73Cu,
+    0x26D3u, 0x36F2u, 0x0691u, 0x16B0u, 0x6657u, 0x7676u, 0x4615u, 0x5634u,
+    0xD94Cu, 0xC96Du, 0xF90Eu, 0xE92Fu, 0x99C8u, 0x89E9u, 0xB98Au, 0xA9ABu,
+    0x5844u, 0x4865u, 0x7806u, 0x6827u, 0x18C0u, 0x08E1u, 0x3882u, 0x28A3u,
+    0xCB7Du, 0xDB5Cu, 0xEB3Fu, 0xFB1Eu, 0x8BF9u, 0x9BD8u, 0xABBBu, 0xBB9Au,
+    0x4A75u, 0x5A54u, 0x6A37u, 0x7A16u, 0x0AF1u, 0x1AD0u, 0x2AB3u, 0x3A92u,
+    0xFD2Eu, 0xED0Fu, 0xDD6Cu, 0xCD4Du, 0xBDAAu, 0xAD8Bu, 0x9DE8u, 0x8DC9u,
+    0x7C26u, 0x6C07u, 0x5C64u, 0x4C45u, 0x3CA2u, 0x2C83u, 0x1CE0u, 0x0CC1u,
+    0xEF1Fu, 0xFF3Eu, 0xCF5Du, 0xDF7Cu, 0xAF9Bu, 0xBFBAu, 0x8FD9u, 0x9FF8u,
+    0x6E17u, 0x7E36u, 0x4E55u, 0x5E74u, 0x2E93u, 0x3EB2u, 0x0ED1u, 0x1EF0u,
+};
+
+static inline soc_mcu_cs_t soc_mcu_cs_init(void)
+{
+    return 0xFFFFu;
+}
+
+static inline soc_mcu_cs_t soc_mcu_cs_update(soc_mcu_cs_t cs, const uint8_t* p, uint16_t n)
+{
+    uint16_t crc = cs;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        crc = (uint16_t)((crc << 8) ^ s_soc_mcu_crc16_tab[(uint8_t)((crc >> 8) ^ p[i])]);
+    }
+    return crc;
+}
+
+static inline uint16_t soc_mcu_cs_final(soc_mcu_cs_t cs)
+{
+    return cs;
+}
+
+static inline void soc_mcu_cs_put(uint8_t* out, uint16_t v)
+{
+    out[0] = (uint8_t)(v >> 8);
+    out[1] = (uint8_t)v;
+}
+
+static inline uint16_t soc_mcu_cs_get(const uint8_t* in)
+{
+    return (uint16_t)(((uint16_t)in[0] << 8) | in[1]);
+}
+
+#else
+
+static inline soc_mcu_cs_t soc_mcu_cs_init(void)
+{
+    return 0u;
+}
+
+static inline soc_mcu_cs_t soc_mcu_cs_update(soc_mcu_cs_t cs, const uint8_t* p, uint16_t n)
+{
+    uint8_t sum = (uint8_t)cs;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        sum = (uint8_t)(sum + p[i]);
+    }
+    return sum;
+}
+
+/* 累加和取补：整帧 feature..chk 逐字节相加为 0 */
+static inline uint16_t soc_mcu_cs_final(soc_mcu_cs_t cs)
+{
+    return (uint8_t)(~(uint8_t)cs + 1u);
+}
+
+static inline void soc_mcu_cs_put(uint8_t* out, uint16_t v)
+{
+    out[0] = (uint8_t)v;
+}
+
+static inline uint16_t soc_mcu_cs_get(const uint8_t* in)
+{
+    return in[0];
+}
+
+#endif
+
+/* 一次性计算（编码、整帧校验用） */
+static inline uint16_t soc_mcu_checksum(const uint8_t* p, uint16_t n)
+{
+    return soc_mcu_cs_final(soc_mcu_cs_update(soc_mcu_cs_init(), p, n));
+}
+
+static inline bool soc_mcu_sync_ok(uint8_t b)
+{
+    return b == (uint8_t)(SOC_MCU_SYNC_SOC_TO_MCU & 0xFFu) ||
+           b == (uint8_t)(SOC_MCU_SYNC_MCU_TO_SOC & 0xFFu);
+}
+
+/* ==================== 编码 ==================== */
+
+/**
+ * @brief 编码一帧到 out
+ * @return 帧总长；out 容量不足 / data_len 超限 / data 为空但 data_len>0 时返回 0
+ */
+static inline uint16_t soc_mcu_encode(uint16_t       sync,
+                                      uint16_t       feature,
+                                      uint16_t       id,
+                                      const uint8_t* data,
+                                      uint16_t       data_len,
+                                      uint8_t*       out,
+                                      uint16_t       out_cap)
+{
+    if (out == NULL || data_len > SOC_MCU_DATA_MAX || (data_len > 0u && data == NULL))
+    {
+        return 0u;
+    }
+    const uint16_t total = SOC_MCU_FRAME_LEN(data_len);
+    if (out_cap < total)
+    {
+        return 0u;
+    }
+
+    const uint16_t len_field = (uint16_t)(4u + data_len);
+    out[0] = SOC_MCU_FRAME_HEAD;
+    out[1] = (uint8_t)(sync & 0xFFu);
+    out[2] = (uint8_t)(len_field >> 8);
+    out[3] = (uint8_t)len_field;
+    out[4] = (uint8_t)(feature >> 8);
+    out[5] = (uint8_t)feature;
+    out[6] = (uint8_t)(id >> 8);
+    out[7] = (uint8_t)id;
+    if (data_len > 0u)
+    {
+        memcpy(&out[SOC_MCU_DATA_OFF], data, data_len);
+    }
+
+    uint8_t* tail = &out[SOC_MCU_DATA_OFF + data_len];
+    soc_mcu_cs_put(tail, soc_mcu_checksum(&out[SOC_MCU_HDR_LEN], len_field));
+    tail[SOC_MCU_CRC_LEN + 0u] = SOC_MCU_FRAME_END0;
+    tail[SOC_MCU_CRC_LEN + 1u] = SOC_MCU_FRAME_END1;
+    return total;
+}
+
+/* ==================== 流式解码 ==================== */
+
+/* 解码出的帧（描述符）：字段已解析好，上层不需要再看原始字节 */
+typedef struct
+{
+    const uint8_t* frame;    /**< 完整帧 head..end（未 attach 时为 NULL） */
+    const uint8_t* data;     /**< 数据段（未 attach 时为 NULL） */
+    uint16_t       len;      /**< 帧总长 */
+    uint16_t       data_len; /**< 数据段长度 */
+    uint16_t       feature;
+    uint16_t       id;
+    uint8_t        sync;
+    bool           crc_ok;
+} soc_mcu_frame_t;
+
+typedef enum
+{
+    SOC_MCU_DEC_NEED_MORE = 0, /**< 输入已吃完，帧未结束 */
+    SOC_MCU_DEC_HDR_OK,        /**< 帧头合法、总长已知，此时可 attach 帧缓冲 */
+    SOC_MCU_DEC_FRAME,         /**< 完整帧（end 正确），*out 已填好；crc_ok 单独给出 */
+    SOC_MCU_DEC_ERR_SYNC,      /**< sync 非法（若该字节是 head，解码器已从它重新开始） */
+    SOC_MCU_DEC_ERR_LEN,       /**< len 非法（<4 或超出 SOC_MCU_FRAME_MAX_LEN） */
+    SOC_MCU_DEC_ERR_END,       /**< 按长度收满后 end 不是 0A 0D */
+} soc_mcu_dec_ev_t;
+
+enum
+{
+    SOC_MCU_DEC_ST_IDLE = 0, /**< 找 head（跳过其他字节） */
+    SOC_MCU_DEC_ST_HDR,      /**< head/sync/len */
+    SOC_MCU_DEC_ST_BODY,     /**< feature/id/data/chk/end */
+};
+
+typedef struct
+{
+    uint8_t      st;
+    uint8_t      hdr[SOC_MCU_HDR_LEN];
+    uint8_t      fid[4];                 /**< feature + id（未 attach 时留存） */
+    uint8_t      tail[SOC_MCU_TAIL_LEN]; /**< chk + end（未 attach 时留存） */
+    uint16_t     idx;                    /**< 本帧已收字节数 */
+    uint16_t     total;                  /**< 帧总长（HDR_OK 之后有效） */
+    uint16_t     cs_end;                 /**< 校验覆盖区结束偏移（= 4 + len） */
+    soc_mcu_cs_t cs;                     /**< 边收边算的校验中间值 */
+    uint8_t*     buf;                    /**< attach 的整帧缓冲，可为 NULL */
+    uint32_t     skipped;                /**< IDLE 时跳过的非 head 字节数 */
+} soc_mcu_dec_t;
+
+static inline void soc_mcu_dec_reset(soc_mcu_dec_t* d)
+{
+    d->st    = SOC_MCU_DEC_ST_IDLE;
+    d->idx   = 0u;
+    d->total = 0u;
+    d->buf   = NULL;
+}
+
+/* 解码器是否正处在一帧中间（用于上层区分“帧模式/空闲”） */
+static inline bool soc_mcu_dec_busy(const soc_mcu_dec_t* d)
+{
+    return d->st != SOC_MCU_DEC_ST_IDLE;
+}
+
+/**
+ * @brief 指定整帧缓冲（只能在 SOC_MCU_DEC_HDR_OK 之后、继续 feed 之前调用）
+ * @param buf 至少 SOC_MCU_FRAME_MAX_LEN 字节；帧头会先补拷进去
+ */
+static inline void soc_mcu_dec_attach(soc_mcu_dec_t* d, uint8_t* buf)
+{
+    d->buf = buf;
+    if (buf != NULL)
+    {
+        memcpy(buf, d->hdr, SOC_MCU_HDR_LEN);
+    }
+}
+
+static inline uint16_t soc_mcu_dec_hdr(soc_mcu_dec_t* d, uint8_t b, soc_mcu_dec_ev_t* ev)
+{
+    if (d->idx == 1u && !soc_mcu_sync_ok(b))
+    {
+        *ev = SOC_MCU_DEC_ERR_SYNC;
+        soc_mcu_dec_reset(d);
+        if (b == SOC_MCU_FRAME_HEAD)
+        {
+            d->hdr[0] = b;
+            d->idx    = 1u;
+            d->st     = SOC_MCU_DEC_ST_HDR;
+        }
+        return 1u;
+    }
+
+    d->hdr[d->idx++] = b;
+    if (d->idx < SOC_MCU_HDR_LEN)
+    {
+        return 1u;
+    }
+
+    uint16_t len_field = (uint16_t)(((uint16_t)d->hdr[2] << 8) | d->hdr[3]);
+    if (len_field < 4u || len_field > (uint16_t)(SOC_MCU_DATA_MAX + 4u))
+    {
+        *ev = SOC_MCU_DEC_ERR_LEN;
+        soc_mcu_dec_reset(d);
+        return 1u;
+    }
+    d->total  = SOC_MCU_FRAME_LEN(len_field - 4u);
+    d->cs_end = (uint16_t)(SOC_MCU_HDR_LEN + len_field);
+    d->cs     = soc_mcu_cs_init();
+    d->st     = SOC_MCU_DEC_ST_BODY;
+    *ev       = SOC_MCU_DEC_HDR_OK;
+    return 1u;
+}
+
+static inline void soc_mcu_dec_done(soc_mcu_dec_t* d, soc_mcu_dec_ev_t* ev, soc_mcu_frame_t* out)
+{
+    /* attach 了缓冲就直接从帧里取 feature/id/chk/end，否则用解码器留存的副本 */
+    const uint8_t* fid  = (d->buf != NULL) ? &d->buf[SOC_MCU_HDR_LEN] : d->fid;
+    const uint8_t* tail = (d->buf != NULL) ? &d->buf[d->cs_end] : d->tail;
+    const uint8_t* end  = &tail[SOC_MCU_CRC_LEN];
+
+    if (end[0] != SOC_MCU_FRAME_END0 || end[1] != SOC_MCU_FRAME_END1)
+    {
+        *ev = SOC_MCU_DEC_ERR_END;
+    }
+    else
+    {
+        *ev = SOC_MCU_DEC_FRAME;
+        if (out != NULL)
+        {
+            out->frame    = d->buf;
+            out->data     = (d->buf != NULL) ? &d->buf[SOC_MCU_DATA_OFF] : NULL;
+            out->len      = d->total;
+            out->data_len = (uint16_t)(d->cs_end - SOC_MCU_DATA_OFF);
+            out->feature  = (uint16_t)(((uint16_t)fid[0] << 8) | fid[1]);
+            out->id       = (uint16_t)(((uint16_t)fid[2] << 8) | fid[3]);
+            out->sync     = d->hdr[1];
+            out->crc_ok   = (soc_mcu_cs_final(d->cs) == soc_mcu_cs_get(tail));
+        }
+    }
+    soc_mcu_dec_reset(d);
+}
+
+/* 帧体：整块拷贝 + 边收边算校验；没有 attach 缓冲时才单独留存 feature/id 与 chk/end */
+static inline uint16_t soc_mcu_dec_body(soc_mcu_dec_t*    d,
+                                        const uint8_t*    in,
+                                        uint16_t          len,
+                                        soc_mcu_dec_ev_t* ev,
+                                        soc_mcu_frame_t*  out)
+{
+    uint16_t need = (uint16_t)(d->total - d->idx);
+    uint16_t take = (len < need) ? len : need;
+    uint16_t lo   = d->idx;
+    uint16_t hi   = (uint16_t)(lo + take);
+
+    if (d->buf != NULL)
+    {
+        memcpy(&d->buf[lo], in, take);
+    }
+    else
+    {
+        for (uint16_t i = lo; i < hi && i < SOC_MCU_DATA_OFF; i++)
+        {
+            d->fid[i - SOC_MCU_HDR_LEN] = in[i - lo];
+        }
+        for (uint16_t i = (lo > d->cs_end) ? lo : d->cs_end; i < hi; i++)
+        {
+            d->tail[i - d->cs_end] = in[i - lo];
+        }
+    }
+    if (lo < d->cs_end)
+    {
+        uint16_t cs_hi = (hi < d->cs_end) ? hi : d->cs_end;
+        d->cs          = soc_mcu_cs_update(d->cs, in, (uint16_t)(cs_hi - lo));
+    }
+
+    d->idx = hi;
+    if (d->idx == d->total)
+    {
+        soc_mcu_dec_done(d, ev, out);
+    }
+    return take;
+}
+
+/**
+ * @brief 喂一段字节，遇到事件（帧头合法/整帧/错误）或输入吃完即返回
+ * @param ev  输出：本次返回时的事件
+ * @param out 输出：SOC_MCU_DEC_FRAME 时的帧描述（可为 NULL）
+ * @return 本次消耗的字节数（调用方据此前移输入指针后继续 feed）
+ */
+static inline uint16_t soc_mcu_dec_feed(soc_mcu_dec_t*    d,
+                                        const uint8_t*    in,
+                                        uint16_t          len,
+                                        soc_mcu_dec_ev_t* ev,
+                                        soc_mcu_frame_t*  out)
+{
+    uint16_t used = 0u;
+
+    *ev = SOC_MCU_DEC_NEED_MORE;
+    while (used < len && *ev == SOC_MCU_DEC_NEED_MORE)
+    {
+        if (d->st == SOC_MCU_DEC_ST_IDLE)
+        {
+            const uint8_t* h =
+                (const uint8_t*)memchr(&in[used], SOC_MCU_FRAME_HEAD, (size_t)(len - used));
+            if (h == NULL)
+            {
+                d->skipped += (uint32_t)(len - used);
+                return len;
+            }
+            d->skipped += (uint32_t)(h - &in[used]);
+            used       = (uint16_t)(h - in + 1);
+            d->hdr[0]  = SOC_MCU_FRAME_HEAD;
+            d->idx     = 1u;
+            d->st      = SOC_MCU_DEC_ST_HDR;
+        }
+        else if (d->st == SOC_MCU_DEC_ST_HDR)
+        {
+            used = (uint16_t)(used + soc_mcu_dec_hdr(d, in[used], ev));
+        }
+        else
+        {
+            used = (uint16_t)(used + soc_mcu_dec_body(d, &in[used], (uint16_t)(len - used), ev, out));
+        }
+    }
+    return used;
+}
+
+#endif // SOC_MCU_CODEC_H
@@ -0,0 +1,247 @@
+/*********************************************************************
+ * @file uart_rx.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief SOC<->MCU UART 接收：SPSC 字节环 + 帧池 + 块解析器
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include "uart_rx.h"
+
+#include <stddef.h>
+#include <string.h>
+
+enum
+{
+    UART_RX_ST_LINE = 0, /**< 空闲 / 文本行累积（idx==0 时遇 0xFE 进入帧模式） */
+    UART_RX_ST_FRAME,    /**< 帧交给 soc_mcu_dec，帧体整块拷进帧池槽位 */
+};
+
+/* ==================== SPSC 字节环 ==================== */
+
+bool uart_rx_ring_init(uart_rx_ring_t* r, uint8_t* buf, uint16_t size)
+{
+    if (r == NULL || buf == NULL || size == 0u || size > 32768u ||
+        (size & (uint16_t)(size - 1u)) != 0u)
+    {
+        return false;
+    }
+    r->buf      = buf;
+    r->mask     = (uint16_t)(size - 1u);
+    r->head     = 0u;
+    r->tail     = 0u;
+    r->overflow = 0u;
+    return true;
+}
+
+uint8_t* uart_rx_ring_write_span(uart_rx_ring_t* r, uint16_t* room)
+{
+    uint16_t head  = r->head;
+    uint16_t size  = (uint16_t)(r->mask + 1u);
+    uint16_t space = (uint16_t)(size - (uint16_t)(head - r->tail));
+    uint16_t off   = (uint16_t)(head & r->mask);
+    uint16_t end   = (uint16_t)(size - off);
+
+    *room = (space < end) ? space : end;
+    return &r->buf[off];
+}
+
+void uart_rx_ring_produce(uart_rx_ring_t* r, uint16_t n)
+{
+    UART_RX_BARRIER();
+    r->head = (uint16_t)(r->head + n);
+}
+
+const uint8_t* uart_rx_ring_read_span(uart_rx_ring_t* r, uint16_t* len)
+{
+    uint16_t tail = r->tail;
+    uint16_t used = (uint16_t)(r->head - tail);
+    uint16_t off  = (uint16_t)(tail & r->mask);
+    uint16_t end  = (uint16_t)(r->mask + 1u - off);
+
+    UART_RX_BARRIER();
+    *len = (used < end) ? used : end;
+    return &r->buf[off];
+}
+
+void uart_rx_ring_consume(uart_rx_ring_t* r, uint16_t n)
+{
+    UART_RX_BARRIER();
+    r->tail = (uint16_t)(r->tail + n);
+}
+
+/* ==================== 帧池 + 块解析器 ==================== */
+
+static inline void uart_rx_reset(uart_rx_parser_t* p)
+{
+    p->st  = UART_RX_ST_LINE;
+    p->idx = 0u;
+    p->cur = NULL;
+    soc_mcu_dec_reset(&p->dec);
+}
+
+void uart_rx_parser_init(uart_rx_parser_t*  p,
+                         uart_rx_frame_cb_t on_frame,
+                         uart_rx_line_cb_t  on_line)
+{
+    memset(p, 0, sizeof(*p));
+    p->on_frame = on_frame;
+    p->on_line  = on_line;
+    uart_rx_reset(p);
+}
+
+void uart_rx_frame_release(const uart_rx_frame_t* f)
+{
+    if (f != NULL)
+    {
+        ((uart_rx_slot_t*)(uintptr_t)f)->in_use = 0u;
+    }
+}
+
+static uart_rx_slot_t* uart_rx_slot_alloc(uart_rx_parser_t* p)
+{
+    for (uint8_t i = 0; i < UART_RX_FRAME_POOL; i++)
+    {
+        if (p->pool[i].in_use == 0u)
+        {
+            p->pool[i].in_use = 1u;
+            return &p->pool[i];
+        }
+    }
+    return NULL;
+}
+
+/* 文本行：一次 memchr 找 \n，找到或缓冲满就整行交付 */
+static uint16_t uart_rx_parse_line(uart_rx_parser_t* p, const uint8_t* data, uint16_t len)
+{
+    uint16_t       room = (uint16_t)(UART_RX_LINE_MAX - 1u - p->idx);
+    uint16_t       take = (len < room) ? len : room;
+    const uint8_t* nl   = (const uint8_t*)memchr(data, '\n', take);
+
+    if (nl != NULL)
+    {
+        take = (uint16_t)(nl - data + 1);
+    }
+    memcpy(&p->line[p->idx], data, take);
+    p->idx = (uint16_t)(p->idx + take);
+
+    if (nl != NULL || p->idx >= UART_RX_LINE_MAX - 1u)
+    {
+        p->line[p->idx] = '\0';
+        p->lines++;
+        if (p->on_line != NULL)
+        {
+            p->on_line(p->line, p->idx);
+        }
+        p->idx = 0u;
+    }
+    return take;
+}
+
+/* 帧模式：解码器每报一个事件就在这里处理（分配槽位 / 交付 / 计错） */
+static uint16_t uart_rx_parse_frame(uart_rx_parser_t* p, const uint8_t* data, uint16_t len)
+{
+    soc_mcu_dec_ev_t ev;
+    soc_mcu_frame_t  scratch;
+    soc_mcu_frame_t* out  = (p->cur != NULL) ? &p->cur->desc : &scratch;
+    uint16_t         used = soc_mcu_dec_feed(&p->dec, data, len, &ev, out);
+
+    switch (ev)
+    {
+        case SOC_MCU_DEC_HDR_OK:
+            /* 没有空闲槽位：本帧照常按长度吞掉（保持同步），只计数不交付 */
+            p->cur = uart_rx_slot_alloc(p);
+            if (p->cur == NULL)
+            {
+                p->pool_exhausted++;
+            }
+            else
+            {
+                soc_mcu_dec_attach(&p->dec, p->cur->buf);
+            }
+            break;
+        case SOC_MCU_DEC_FRAME:
+            if (p->cur != NULL)
+            {
+                p->frames++;
+                if (p->on_frame == NULL || !p->on_frame(&p->cur->desc))
+                {
+                    p->cur->in_use = 0u;
+                }
+            }
+            p->cur = NULL;
+            break;
+        case SOC_MCU_DEC_ERR_SYNC:
+        case SOC_MCU_DEC_ERR_LEN:
+        case SOC_MCU_DEC_ERR_END:
+            p->bad_frames++;
+            if (p->cur != NULL)
+            {
+                p->cur->in_use = 0u;
+                p->cur         = NULL;
+            }
+            break;
+        default:
+            break;
+    }
+
+    /* 帧结束（或 sync 错且当前字节不是新 head）后回到行/空闲模式 */
+    if (!soc_mcu_dec_busy(&p->dec))
+    {
+        p->st = UART_RX_ST_LINE;
+    }
+    return used;
+}
+
+void uart_rx_parse(uart_rx_parser_t* p, const uint8_t* data, uint16_t len)
+{
+    while (len > 0u)
+    {
+        uint16_t used;
+
+        if (p->st == UART_RX_ST_LINE)
+        {
+            /* 自动识别：行首 0xFE 走二进制帧，其他按文本行 */
+            if (p->idx == 0u && data[0] == SOC_MCU_FRAME_HEAD)
+            {
+                p->st = UART_RX_ST_FRAME;
+                used  = uart_rx_parse_frame(p, data, len);
+            }
+            else
+            {
+                used = uart_rx_parse_line(p, data, len);
+            }
+        }
+        else
+        {
+            used = uart_rx_parse_frame(p, data, len);
+        }
+        data += used;
+        len   = (uint16_t)(len - used);
+    }
+}
+
+uint16_t uart_rx_drain(uart_rx_ring_t* r, uart_rx_parser_t* p)
+{
+    uint16_t total = 0u;
+    uint16_t limit = (uint16_t)(r->mask + 1u);
+
+    /* 最多处理一整环：中断持续写入时也不会在这里一直转 */
+    while (total < limit)
+    {
+        uint16_t       n;
+        const uint8_t* span = uart_rx_ring_read_span(r, &n);
+        if (n == 0u)
+        {
+            break;
+        }
+        if (n > (uint16_t)(limit - total))
+        {
+            n = (uint16_t)(limit - total);
+        }
+        uart_rx_parse(p, span, n);
+        uart_rx_ring_consume(r, n);
+        total = (uint16_t)(total + n);
+    }
+    return total;
+}
@@ -3,11 +3,13 @@
 
 #include <stdint.h>
 
+#include "uart_rx.h"
+
 /**
  * @brief 构建 SOC↔MCU UART 二进制帧
  * @param sync    同步字（0xABAB 下发 / 0xBABA 回包）
  * @param feature 通道字段（0xFF01~0xFF04）
- * @param id      命令 ID（2 字节，小端编码进帧）
+ * @param id      命令 ID（2 字节，大端编码进帧，见 soc_mcu_codec.h）
  * @param data    数据段指针（可为 NULL，当 data_len=0）
  * @param data_len 数据段长度
  * @param out     输出缓冲区
@@ -57,6 +59,15 @@ typedef struct UART_Comm_Base_s {
 void UART_Device_Create(UART_Comm_Base_t *device, uint32_t port, uint32_t baud);
 void UART_Task_Init(void);
 
+/**
+ * @brief 把 UART0 接收环里的数据交给块解析器（user_task 收到 USER_EVT_UART_RX 时调用）
+ * @return 本次处理的字节数
+ */
+uint16_t UART_Rx_Drain(uart_rx_parser_t *parser);
+
+/* 接收环满丢弃的字节数（调试观测用） */
+uint32_t UART_Rx_Overflow(void);
+
 // 全局设备实例声明
 extern UART_Comm_Base_t g_uart1_dev;
 
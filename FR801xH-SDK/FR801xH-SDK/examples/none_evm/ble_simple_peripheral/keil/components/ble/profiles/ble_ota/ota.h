@@ -25,6 +25,10 @@ typedef enum
     OTA_CMD_READ_MEM,
     OTA_CMD_REBOOT,
     OTA_CMD_NULL,
+    OTA_CMD_STREAM_START,   //start write-without-response streaming
+    OTA_CMD_STREAM_DATA,    //streamed data packet, no response; acked by stream_ack_rsp notifications
+    OTA_CMD_STREAM_START_LZ,    //start streaming a compressed image (ota_lz.h), decoded on the fly
+    OTA_CMD_STREAM_START_DELTA, //start streaming a patch (ota_delta.h) against the running image, stream_start_cmd
 }ota_cmd_t;
 
 typedef enum 
@@ -32,6 +36,7 @@ typedef enum
     OTA_RSP_SUCCESS,
     OTA_RSP_ERROR,
     OTA_RSP_UNKNOWN_CMD,
+    OTA_RSP_BUSY,           //REBOOT while a delta stream is still rebuilding; nothing committed, retry later
 }ota_rsp_t;
 
 typedef enum 
@@ -89,6 +94,19 @@ __PACKED struct read_data_rsp
     uint16_t length;
 }GCC_PACKED;
 
+/*
+ * stream ack: next_seq is the first packet not received yet (all below it are received),
+ * bit i of bitmap = packet next_seq+1+i received. window = packets the client may have
+ * in flight starting at next_seq; 0 while the device erases the new image area (an ack
+ * opens it; if that ack is lost, resend packet next_seq after a timeout to probe).
+ */
+__PACKED struct stream_ack_rsp
+{
+    uint16_t next_seq;
+    uint16_t window;
+    uint32_t bitmap;
+}GCC_PACKED;
+
 __PACKED struct app_ota_rsp_hdr_t
 {
     uint8_t result;
@@ -104,6 +122,7 @@ __PACKED struct app_ota_rsp_hdr_t
         struct read_mem_rsp read_mem;
         struct write_data_rsp write_data;
         struct read_data_rsp read_data;
+        struct stream_ack_rsp stream_ack;
     }GCC_PACKED rsp;
 }GCC_PACKED;
 
@@ -136,6 +155,32 @@ __PACKED struct read_data_cmd
     uint16_t length;
 }GCC_PACKED;
 
+/* base_address must be the storage base, packet seq carries bytes [seq*seg, seq*seg+seg) */
+__PACKED struct stream_start_cmd
+{
+    uint32_t base_address;
+    uint32_t length;
+    uint16_t seg;
+}GCC_PACKED;
+
+/* length/seg describe the compressed data, raw_length the decoded image; window_bits from the .olz header */
+__PACKED struct stream_start_lz_cmd
+{
+    uint32_t base_address;
+    uint32_t length;
+    uint16_t seg;
+    uint32_t raw_length;
+    uint8_t window_bits;
+}GCC_PACKED;
+
+/* STREAM_START_DELTA reuses stream_start_cmd: length/seg describe the patch, the rest is in the patch header */
+
+/* followed by the payload, length in the command header = payload length */
+__PACKED struct stream_data_cmd
+{
+    uint16_t seq;
+}GCC_PACKED;
+
 #ifdef OTA_CRC_CHECK
 __PACKED struct firmware_check
 {
@@ -155,6 +200,9 @@ __PACKED struct app_ota_cmd_hdr_t
         struct read_mem_cmd read_mem;
         struct write_data_cmd write_data;
         struct read_data_cmd read_data;
+        struct stream_start_cmd stream_start;
+        struct stream_start_lz_cmd stream_start_lz;
+        struct stream_data_cmd stream_data;
 #ifdef OTA_CRC_CHECK		
         struct firmware_check fir_crc_data;
 #endif		
@@ -0,0 +1,216 @@
+/*********************************************************************
+ * @file ota_delta.c
+ * @author Fanzx (1456925916@qq.com)
+ * @brief 差分 OTA 的流式重建实现
+ * @version 0.1
+ * @date 2026-10-16
+ *********************************************************************/
+
+#include <string.h>
+
+#include "ota_delta.h"
+
+enum
+{
+    DELTA_ST_HDR,       //收 OTA_DELTA_HDR_LEN（20）字节头
+    DELTA_ST_OP,        //收操作头（变长整数）
+    DELTA_ST_SRC,       //收复制源修正量（变长整数）
+    DELTA_ST_INSERT,    //插入的字节
+    DELTA_ST_COPY,      //复制进行中
+    DELTA_ST_DONE,
+    DELTA_ST_ERROR,
+};
+
+/* 半字节表：256 项的表要 1KB flash；只在开头核对一遍旧镜像、输出时算一遍新镜像，慢一点无所谓 */
+static const uint32_t delta_crc_nib[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+uint32_t ota_delta_crc32(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    crc = ~crc;
+    while(len--)
+    {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ delta_crc_nib[crc & 0x0F];
+        crc = (crc >> 4) ^ delta_crc_nib[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static void delta_flush(struct ota_delta_t *d, uint32_t offset, uint32_t len)
+{
+    d->crc = ota_delta_crc32(d->crc, d->page, len);
+    d->page_fn(d->page, offset, len);
+}
+
+/* 输出推进 n 字节：满一页交出去，满新镜像长度把最后半页交出去并核对 CRC */
+static void delta_advance(struct ota_delta_t *d, uint32_t n)
+{
+    d->out_pos += n;
+    if((d->out_pos & (OTA_DELTA_PAGE - 1)) == 0)
+        delta_flush(d, d->out_pos - OTA_DELTA_PAGE, OTA_DELTA_PAGE);
+    if(d->out_pos == d->hdr.new_length)
+    {
+        uint32_t offset = d->out_pos & ~(uint32_t)(OTA_DELTA_PAGE - 1);
+        if(offset != d->out_pos)
+            delta_flush(d, offset, d->out_pos - offset);
+        d->state = (d->crc == d->hdr.new_crc) ? DELTA_ST_DONE : DELTA_ST_ERROR;
+    }
+    else if(d->len == 0)
+        d->state = DELTA_ST_OP;
+}
+
+static uint32_t delta_rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* 变长整数收一个字节，收完返回 1；超过 32 位算损坏 */
+static uint8_t delta_var(struct ota_delta_t *d, uint8_t b)
+{
+    if(d->var_shift > 28 || (d->var_shift == 28 && (b & 0x70)))
+    {
+        d->state = DELTA_ST_ERROR;
+        return 0;
+    }
+    d->var |= (uint32_t)(b & 0x7F) << d->var_shift;
+    d->var_shift += 7;
+    return (b & 0x80) == 0;
+}
+
+static void delta_hdr_done(struct ota_delta_t *d, const uint8_t *raw)
+{
+    d->hdr.magic = delta_rd32(&raw[0]);
+    d->hdr.new_length = delta_rd32(&raw[4]);
+    d->hdr.old_length = delta_rd32(&raw[8]);
+    d->hdr.old_crc = delta_rd32(&raw[12]);
+    d->hdr.new_crc = delta_rd32(&raw[16]);
+    // 首页要整页输出（jump table），旧镜像首页之外也得有东西可复制
+    if(d->hdr.magic != OTA_DELTA_MAGIC || d->hdr.new_length <= OTA_DELTA_PAGE
+       || d->hdr.old_length <= OTA_DELTA_PAGE
+       || (d->check_fn != NULL && d->check_fn(&d->hdr) == 0))
+    {
+        d->state = DELTA_ST_ERROR;
+        return;
+    }
+    d->state = DELTA_ST_OP;
+}
+
+void ota_delta_init(struct ota_delta_t *d, uint8_t *page, ota_delta_read_fn read_fn,
+                    ota_delta_page_fn page_fn, ota_delta_check_fn check_fn)
+{
+    memset(d, 0, sizeof(*d));
+    d->page = page;
+    d->read_fn = read_fn;
+    d->page_fn = page_fn;
+    d->check_fn = check_fn;
+    d->state = DELTA_ST_HDR;
+}
+
+uint32_t ota_delta_feed(struct ota_delta_t *d, const uint8_t *in, uint32_t len)
+{
+    uint32_t used = 0;
+
+    while(used < len)
+    {
+        switch(d->state)
+        {
+            case DELTA_ST_HDR:
+                // 头先攒在页缓冲里（此时还没有输出）
+                d->page[d->var++] = in[used++];
+                if(d->var == OTA_DELTA_HDR_LEN)
+                {
+                    d->var = 0;
+                    delta_hdr_done(d, d->page);
+                }
+                break;
+            case DELTA_ST_OP:
+                if(delta_var(d, in[used++]))
+                {
+                    d->len = d->var >> 1;
+                    d->op = d->var & 1;
+                    d->var = 0;
+                    d->var_shift = 0;
+                    if(d->len == 0 || d->len > d->hdr.new_length - d->out_pos)
+                        d->state = DELTA_ST_ERROR;
+                    else
+                        d->state = d->op ? DELTA_ST_SRC : DELTA_ST_INSERT;
+                }
+                break;
+            case DELTA_ST_SRC:
+                if(delta_var(d, in[used++]))
+                {
+                    // zigzag：0,1,2,3... -> 0,-1,1,-2...
+                    d->src += (d->var >> 1) ^ (0u - (d->var & 1));
+                    d->var = 0;
+                    d->var_shift = 0;
+                    if(d->src < OTA_DELTA_PAGE || d->src > d->hdr.old_length
+                       || d->len > d->hdr.old_length - d->src)
+                        d->state = DELTA_ST_ERROR;
+                    else
+                        d->state = DELTA_ST_COPY;
+                }
+                break;
+            case DELTA_ST_INSERT:
+            {
+                uint32_t fill = d->out_pos & (OTA_DELTA_PAGE - 1);
+                uint32_t n = len - used;
+                if(n > d->len)
+                    n = d->len;
+                if(n > OTA_DELTA_PAGE - fill)
+                    n = OTA_DELTA_PAGE - fill;
+                memcpy(&d->page[fill], &in[used], n);
+                used += n;
+                d->len -= n;
+                d->src += n;
+                delta_advance(d, n);
+                break;
+            }
+            case DELTA_ST_COPY:
+                return used;
+            default:
+                // 结束后还有输入也算损坏
+                d->state = DELTA_ST_ERROR;
+                return used;
+        }
+        if(d->state == DELTA_ST_ERROR || d->state == DELTA_ST_COPY)
+            return used;
+    }
+    return used;
+}
+
+void ota_delta_copy(struct ota_delta_t *d, uint32_t budget)
+{
+    while(d->state == DELTA_ST_COPY && budget > 0)
+    {
+        uint32_t fill = d->out_pos & (OTA_DELTA_PAGE - 1);
+        uint32_t n = d->len;
+        if(n > budget)
+            n = budget;
+        if(n > OTA_DELTA_PAGE - fill)
+            n = OTA_DELTA_PAGE - fill;
+        d->read_fn(&d->page[fill], d->src, n);
+        d->src += n;
+        d->len -= n;
+        budget -= n;
+        delta_advance(d, n);
+    }
+}
+
+uint8_t ota_delta_state(const struct ota_delta_t *d)
+{
+    switch(d->state)
+    {
+        case DELTA_ST_COPY:
+            return OTA_DELTA_COPYING;
+        case DELTA_ST_DONE:
+            return OTA_DELTA_DONE;
+        case DELTA_ST_ERROR:
+            return OTA_DELTA_ERROR;
+        default:
+            return OTA_DELTA_NEED_INPUT;
+    }
+}
@@ -0,0 +1,69 @@
+/*********************************************************************
+ * @file ota_lz.h
+ * @author Fanzx (1456925916@qq.com)
+ * @brief OTA 压缩镜像的流式解码（LZSS，小窗口）
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @why
+ * - BLE 上 OTA 只有几 KB/s，传输时间和镜像大小成正比；固件里大量重复的指令序列、
+ *   字符串和 0 填充，LZ 压缩后能少传三四成。
+ * - 解码按包喂入、随到随解，不需要整包缓存：历史窗口就是一块 2^window_bits 字节的
+ *   环形缓冲，解出的数据每满 256 字节（flash 页）回调一次，由调用方直接编程到
+ *   非运行镜像区，窗口本身兼做页暂存区。
+ *
+ * 格式（主机打包工具 host/tools/ota_pack 生成）：
+ * - 每 8 项前面一个标志字节，低位先用：0 = 字面字节，1 = 匹配；
+ * - 匹配 2 字节小端 token：低 window_bits 位 = 距离-1，高位 = 长度-OTA_LZ_MIN_MATCH；
+ *   长度字段全 1 时后面再跟 1 字节追加长度（0~255）；
+ * - 没有结束标记，解出 raw_length 字节即结束，最后一组标志字节多余的位忽略。
+ *********************************************************************/
+
+#ifndef OTA_LZ_H
+#define OTA_LZ_H
+
+#include <stdint.h>
+
+#define OTA_LZ_MIN_MATCH   3
+#define OTA_LZ_PAGE        256
+#define OTA_LZ_BITS_MIN    8    //窗口至少一页
+#define OTA_LZ_BITS_MAX    12
+
+enum
+{
+    OTA_LZ_OK,      //还要更多输入
+    OTA_LZ_DONE,    //已解出 raw_length 字节，最后半页也已回调
+    OTA_LZ_ERROR,   //数据损坏：距离越界、超长或结束后还有输入
+};
+
+/* 解出一页（最后一次可能不足一页）；page 指向窗口内部，回调返回后即可能被覆盖 */
+typedef void (*ota_lz_page_fn)(const uint8_t *page, uint32_t offset, uint32_t len);
+
+struct ota_lz_t
+{
+    uint8_t *window;
+    ota_lz_page_fn page_fn;
+    uint32_t raw_length;
+    uint32_t out_pos;       //已解出的字节数
+    uint16_t mask;          //窗口大小-1
+    uint16_t flags;         //当前标志字节，最高有效位之上放一个哨兵位
+    uint16_t tok;           //拼到一半的匹配 token / 匹配长度
+    uint16_t dist;
+    uint8_t window_bits;
+    uint8_t state;
+};
+
+/**
+ * @brief 开始一次解码
+ * @param window 2^window_bits 字节，解码期间由解码器独占
+ */
+void ota_lz_init(struct ota_lz_t *lz, uint8_t *window, uint8_t window_bits,
+                 uint32_t raw_length, ota_lz_page_fn page_fn);
+
+/**
+ * @brief 喂入一段压缩数据（可以在任意字节处切开）
+ * @return OTA_LZ_OK / OTA_LZ_DONE / OTA_LZ_ERROR；出错后不再接受输入
+ */
+uint8_t ota_lz_decode(struct ota_lz_t *lz, const uint8_t *in, uint32_t len);
+
+#endif // OTA_LZ_H
@@ -18,6 +18,7 @@
 
 #include "simple_gatt_service.h"
 #include "protocol.h"
+#include "conn_ctx.h"
 
 /*
  * MACROS (�궨��)
@@ -73,7 +74,7 @@ uint8_t sp_svc_id = 0;
 static uint8_t hid_svc_id = 0;
 
 /* 支持多连接：每个连接独立的通知使能状态 */
-#define SP_MAX_CONN_NUM 3
+#define SP_MAX_CONN_NUM APP_MAX_CONN
 static uint8_t ntf_char1_enable[SP_MAX_CONN_NUM] = {0};
 static uint8_t ntf_char2_enable[SP_MAX_CONN_NUM] = {0};
 